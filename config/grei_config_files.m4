@@ -16,6 +16,7 @@ AC_DEFUN([GREI_CONFIG_FILES],[
     orcm/test/mca/evgen/Makefile
     orcm/test/mca/evgen/saeg/Makefile
     orcm/test/mca/sensor/Makefile
+    orcm/test/mca/sensor/base/Makefile
     orcm/test/mca/sensor/ipmi/Makefile
     orcm/test/mca/analytics/Makefile
     orcm/test/mca/analytics/window/Makefile
@@ -23,5 +24,21 @@ AC_DEFUN([GREI_CONFIG_FILES],[
     orcm/test/mca/analytics/aggregate/Makefile
     orcm/test/mca/analytics/cott/Makefile
     orcm/test/mca/sensor/snmp/Makefile
+    orcm/test/mca/sensor/procfs/Makefile
+    orcm/test/mca/sensor/componentpower/Makefile
+    orcm/test/mca/db/Makefile
+    orcm/test/mca/db/base/Makefile
+    orcm/test/mca/scd/Makefile
+    orcm/test/mca/scd/base/Makefile
+    orcm/test/mca/cfgi/Makefile
+    orcm/test/mca/cfgi/base/Makefile
+    orcm/test/mca/cfgi/file30/Makefile
+    orcm/test/mca/pwrmgmt/Makefile
+    orcm/test/mca/pwrmgmt/uniformfreq/Makefile
+    orcm/test/mca/diag/Makefile
+    orcm/test/mca/diag/memtest/Makefile
+    orcm/test/dss/Makefile
+    orcm/test/util/Makefile
+    orcm/test/orted/Makefile
     ])
 ])
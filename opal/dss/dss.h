@@ -202,6 +202,46 @@ typedef int (*opal_dss_unpack_fn_t)(opal_buffer_t *buffer, void *dest,
                                     int32_t *max_num_values,
                                     opal_data_type_t type);
 
+/**
+ * Borrowed-view unpack functions
+ *
+ * These unpack a single packed string, byte object or nested buffer
+ * without copying it - the result points directly into the memory of
+ * the buffer being unpacked, and is only valid for as long as that
+ * buffer is neither released nor packed into. The item must have been
+ * packed as a single value (i.e., with a count of one).
+ *
+ * unpack_string_view returns the NUL-terminated string (NULL for a
+ * packed NULL string) and, if len is not NULL, its length excluding
+ * the terminator.
+ *
+ * unpack_bytes_view fills in the size and bytes of the caller's byte
+ * object. The bytes must not be freed.
+ *
+ * unpack_buffer_view loads the nested buffer into a caller-provided
+ * buffer object, releasing anything it held. The view can be unpacked
+ * (and viewed into) like any other buffer; packing into it first
+ * copies its contents out of the parent. It must still be released
+ * with OBJ_RELEASE/OBJ_DESTRUCT, which leaves the parent's memory alone.
+ *
+ * @code
+ * opal_buffer_t view;
+ * const char *name;
+ *
+ * OBJ_CONSTRUCT(&view, opal_buffer_t);
+ * status_code = opal_dss.unpack_buffer_view(buffer, &view);
+ * status_code = opal_dss.unpack_string_view(&view, &name, NULL);
+ * OBJ_DESTRUCT(&view);
+ * @endcode
+ */
+typedef int (*opal_dss_unpack_string_view_fn_t)(opal_buffer_t *buffer,
+                                                const char **str,
+                                                int32_t *len);
+typedef int (*opal_dss_unpack_bytes_view_fn_t)(opal_buffer_t *buffer,
+                                               opal_byte_object_t *bo);
+typedef int (*opal_dss_unpack_buffer_view_fn_t)(opal_buffer_t *buffer,
+                                                opal_buffer_t *view);
+
 /**
  * Get the type and number of values of the next item in the buffer.
  *
@@ -492,6 +532,9 @@ struct opal_dss_t {
     opal_dss_lookup_data_type_fn_t  lookup_data_type;
     opal_dss_dump_data_types_fn_t   dump_data_types;
     opal_dss_dump_fn_t              dump;
+    opal_dss_unpack_string_view_fn_t unpack_string_view;
+    opal_dss_unpack_bytes_view_fn_t unpack_bytes_view;
+    opal_dss_unpack_buffer_view_fn_t unpack_buffer_view;
 };
 typedef struct opal_dss_t opal_dss_t;
 
@@ -208,6 +208,15 @@ extern int opal_dss_initial_size;
 extern int opal_dss_threshold_size;
 extern opal_pointer_array_t opal_dss_types;
 extern opal_data_type_t opal_dss_num_reg_types;
+OPAL_DECLSPEC extern opal_dss_float_encoding_t opal_dss_float_encoding;
+
+/*
+ * Binary float and double values are each preceded by this byte. A
+ * text value starts with the big-endian length of its string, whose
+ * first byte is zero for anything "%f" prints, so the receiver can
+ * tell the two apart whatever its own opal_dss_float_encoding says
+ */
+#define OPAL_DSS_FLOAT_MARK 0x01
 
 /*
  * Implementations of API functions
@@ -240,6 +249,11 @@ int opal_dss_load(opal_buffer_t *buffer, void *payload, int32_t bytes_used);
 
 int opal_dss_copy_payload(opal_buffer_t *dest, opal_buffer_t *src);
 
+int opal_dss_unpack_string_view(opal_buffer_t *buffer, const char **str,
+                                int32_t *len);
+int opal_dss_unpack_bytes_view(opal_buffer_t *buffer, opal_byte_object_t *bo);
+int opal_dss_unpack_buffer_view(opal_buffer_t *buffer, opal_buffer_t *view);
+
 int opal_dss_register(opal_dss_pack_fn_t pack_fn,
                       opal_dss_unpack_fn_t unpack_fn,
                       opal_dss_copy_fn_t copy_fn,
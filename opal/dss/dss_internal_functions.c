@@ -56,7 +56,19 @@ char* opal_dss_buffer_extend(opal_buffer_t *buffer, size_t bytes_to_add)
         }
     }
 
-    if (NULL != buffer->base_ptr) {
+    if (NULL != buffer->base_ptr && buffer->borrowed) {
+        /* a view into another buffer - take our own copy before growing */
+        char *owned;
+        pack_offset = ((char*) buffer->pack_ptr) - ((char*) buffer->base_ptr);
+        unpack_offset = ((char*) buffer->unpack_ptr) -
+            ((char*) buffer->base_ptr);
+        if (NULL == (owned = (char*)malloc(to_alloc))) {
+            return NULL;
+        }
+        memcpy(owned, buffer->base_ptr, buffer->bytes_used);
+        buffer->base_ptr = owned;
+        buffer->borrowed = false;
+    } else if (NULL != buffer->base_ptr) {
         pack_offset = ((char*) buffer->pack_ptr) - ((char*) buffer->base_ptr);
         unpack_offset = ((char*) buffer->unpack_ptr) -
             ((char*) buffer->base_ptr);
@@ -49,8 +49,17 @@ int opal_dss_unload(opal_buffer_t *buffer, void **payload,
         return OPAL_SUCCESS;
     }
 
-    /* okay, we have something to provide - pass it back */
-    *payload = buffer->base_ptr;
+    /* okay, we have something to provide - pass it back. The caller
+     * owns the payload, so a view has to hand over a copy */
+    if (buffer->borrowed) {
+        if (NULL == (*payload = malloc(buffer->bytes_used))) {
+            return OPAL_ERR_OUT_OF_RESOURCE;
+        }
+        memcpy(*payload, buffer->base_ptr, buffer->bytes_used);
+        buffer->borrowed = false;
+    } else {
+        *payload = buffer->base_ptr;
+    }
     *bytes_used = buffer->bytes_used;
 
     /* dereference everything in buffer */
@@ -73,9 +82,10 @@ int opal_dss_load(opal_buffer_t *buffer, void *payload,
     }
 
     /* check if buffer already has payload - free it if so */
-    if (NULL != buffer->base_ptr) {
+    if (NULL != buffer->base_ptr && !buffer->borrowed) {
         free(buffer->base_ptr);
     }
+    buffer->borrowed = false;
 
     /* if it's a NULL payload, just set things and return */
     if (NULL == payload) {
@@ -39,6 +39,7 @@ int opal_dss_threshold_size = -1;
 opal_pointer_array_t opal_dss_types = {{0}};
 opal_data_type_t opal_dss_num_reg_types = {0};
 opal_dss_buffer_type_t default_buf_type = OPAL_DSS_BUFFER_NON_DESC;
+opal_dss_float_encoding_t opal_dss_float_encoding = OPAL_DSS_FLOAT_BINARY;
 
 /* variable group id */
 static int opal_dss_group_id = -1;
@@ -49,6 +50,12 @@ mca_base_var_enum_value_t buffer_type_values[] = {
     {0, NULL}
 };
 
+mca_base_var_enum_value_t float_encoding_values[] = {
+    {OPAL_DSS_FLOAT_BINARY, "binary"},
+    {OPAL_DSS_FLOAT_TEXT, "text"},
+    {0, NULL}
+};
+
 opal_dss_t opal_dss = {
     opal_dss_pack,
     opal_dss_unpack,
@@ -63,7 +70,10 @@ opal_dss_t opal_dss = {
     opal_dss_register,
     opal_dss_lookup_data_type,
     opal_dss_dump_data_types,
-    opal_dss_dump
+    opal_dss_dump,
+    opal_dss_unpack_string_view,
+    opal_dss_unpack_bytes_view,
+    opal_dss_unpack_buffer_view
 };
 
 /**
@@ -105,11 +115,12 @@ static void opal_buffer_construct (opal_buffer_t* buffer)
 
     buffer->base_ptr = buffer->pack_ptr = buffer->unpack_ptr = NULL;
     buffer->bytes_allocated = buffer->bytes_used = 0;
+    buffer->borrowed = false;
 }
 
 static void opal_buffer_destruct (opal_buffer_t* buffer)
 {
-    if (NULL != buffer->base_ptr) {
+    if (NULL != buffer->base_ptr && !buffer->borrowed) {
         free (buffer->base_ptr);
     }
 }
@@ -269,6 +280,25 @@ int opal_dss_register_vars (void)
         return ret;
     }
 
+    /* how float and double values go on the wire */
+    opal_dss_float_encoding = OPAL_DSS_FLOAT_BINARY;
+    ret = mca_base_var_enum_create ("float encodings", float_encoding_values, &new_enum);
+    if (OPAL_SUCCESS != ret) {
+        return ret;
+    }
+
+    ret = mca_base_var_register ("opal", "dss", NULL, "float_encoding",
+                                 "Set the wire encoding of float and double values sent by this "
+                                 "process (0=binary, 1=text as sent by older releases). Either "
+                                 "is accepted on receipt",
+                                 MCA_BASE_VAR_TYPE_INT, new_enum, 0, MCA_BASE_VAR_FLAG_SETTABLE,
+                                 OPAL_INFO_LVL_8, MCA_BASE_VAR_SCOPE_LOCAL,
+                                 &opal_dss_float_encoding);
+    OBJ_RELEASE(new_enum);
+    if (0 > ret) {
+        return ret;
+    }
+
     /* setup the initial size of the buffer. */
     opal_dss_initial_size = OPAL_DSS_DEFAULT_INITIAL_SIZE;
     ret = mca_base_var_register ("opal", "dss", NULL, "buffer_initial_size", NULL,
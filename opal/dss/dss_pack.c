@@ -337,16 +337,41 @@ int opal_dss_pack_float(opal_buffer_t *buffer, const void *src,
     int32_t i;
     float *ssrc = (float*)src;
     char *convert;
-
-    for (i = 0; i < num_vals; ++i) {
-        asprintf(&convert, "%f", ssrc[i]);
-        if (OPAL_SUCCESS != (ret = opal_dss_pack_string(buffer, &convert, 1, OPAL_STRING))) {
+    char *dst;
+    size_t bytes_packed = num_vals * (1 + sizeof(float));
+    uint32_t tmp;
+
+    if (OPAL_DSS_FLOAT_TEXT == opal_dss_float_encoding) {
+        for (i = 0; i < num_vals; ++i) {
+            asprintf(&convert, "%f", ssrc[i]);
+            if (OPAL_SUCCESS != (ret = opal_dss_pack_string(buffer, &convert, 1, OPAL_STRING))) {
+                free(convert);
+                return ret;
+            }
             free(convert);
-            return ret;
         }
-        free(convert);
+        return OPAL_SUCCESS;
+    }
+
+    OPAL_OUTPUT( ( opal_dss_verbose, "opal_dss_pack_float * %d\n", num_vals ) );
+    /* check to see if buffer needs extending */
+    if (NULL == (dst = opal_dss_buffer_extend(buffer, bytes_packed))) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
     }
 
+    /* each value is marked so the receiver knows the encoding
+     * without sharing our setting, then its bit pattern follows
+     * in network byte order */
+    for (i = 0; i < num_vals; ++i) {
+        *dst++ = OPAL_DSS_FLOAT_MARK;
+        memcpy(&tmp, &ssrc[i], sizeof(tmp));
+        tmp = htonl(tmp);
+        memcpy(dst, &tmp, sizeof(tmp));
+        dst += sizeof(tmp);
+    }
+    buffer->pack_ptr += bytes_packed;
+    buffer->bytes_used += bytes_packed;
+
     return OPAL_SUCCESS;
 }
 
@@ -358,16 +383,38 @@ int opal_dss_pack_double(opal_buffer_t *buffer, const void *src,
     int32_t i;
     double *ssrc = (double*)src;
     char *convert;
-
-    for (i = 0; i < num_vals; ++i) {
-        asprintf(&convert, "%f", ssrc[i]);
-        if (OPAL_SUCCESS != (ret = opal_dss_pack_string(buffer, &convert, 1, OPAL_STRING))) {
+    char *dst;
+    size_t bytes_packed = num_vals * (1 + sizeof(double));
+    uint64_t tmp;
+
+    if (OPAL_DSS_FLOAT_TEXT == opal_dss_float_encoding) {
+        for (i = 0; i < num_vals; ++i) {
+            asprintf(&convert, "%f", ssrc[i]);
+            if (OPAL_SUCCESS != (ret = opal_dss_pack_string(buffer, &convert, 1, OPAL_STRING))) {
+                free(convert);
+                return ret;
+            }
             free(convert);
-            return ret;
         }
-        free(convert);
+        return OPAL_SUCCESS;
+    }
+
+    OPAL_OUTPUT( ( opal_dss_verbose, "opal_dss_pack_double * %d\n", num_vals ) );
+    /* check to see if buffer needs extending */
+    if (NULL == (dst = opal_dss_buffer_extend(buffer, bytes_packed))) {
+        return OPAL_ERR_OUT_OF_RESOURCE;
     }
 
+    for (i = 0; i < num_vals; ++i) {
+        *dst++ = OPAL_DSS_FLOAT_MARK;
+        memcpy(&tmp, &ssrc[i], sizeof(tmp));
+        tmp = hton64(tmp);
+        memcpy(dst, &tmp, sizeof(tmp));
+        dst += sizeof(tmp);
+    }
+    buffer->pack_ptr += bytes_packed;
+    buffer->bytes_used += bytes_packed;
+
     return OPAL_SUCCESS;
 }
 
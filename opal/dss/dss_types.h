@@ -361,6 +361,17 @@ typedef enum opal_dss_buffer_type_t opal_dss_buffer_type_t;
 #define OPAL_DSS_BUFFER_TYPE_HTON(h);
 #define OPAL_DSS_BUFFER_TYPE_NTOH(h);
 
+/**
+ * wire encoding of OPAL_FLOAT and OPAL_DOUBLE values a process sends.
+ * Each value is marked, so either encoding can be read by any process
+ */
+enum opal_dss_float_encoding_t {
+    OPAL_DSS_FLOAT_BINARY = 0x00,   /* marked IEEE-754 in network byte order */
+    OPAL_DSS_FLOAT_TEXT   = 0x01    /* "%f" strings, as older releases sent them */
+};
+
+typedef enum opal_dss_float_encoding_t opal_dss_float_encoding_t;
+
 /**
  * Structure for holding a buffer to be used with the RML or OOB
  * subsystems.
@@ -384,6 +395,9 @@ struct opal_buffer_t {
     /** Number of bytes used by the buffer (i.e., amount of data --
         including overhead -- packed in the buffer) */
     size_t bytes_used;
+    /** True if base_ptr points into another buffer's memory (see
+        opal_dss.unpack_buffer_view) and is not ours to free */
+    bool borrowed;
 };
 /**
  * Convenience typedef
@@ -405,22 +405,15 @@ int opal_dss_unpack_string(opal_buffer_t *buffer, void *dest,
     return OPAL_SUCCESS;
 }
 
-int opal_dss_unpack_float(opal_buffer_t *buffer, void *dest,
-                          int32_t *num_vals, opal_data_type_t type)
+static int opal_dss_unpack_float_text(opal_buffer_t *buffer, float *desttmp,
+                                      int32_t num_vals)
 {
     int32_t i, n;
-    float *desttmp = (float*) dest, tmp;
+    float tmp;
     int ret;
     char *convert;
 
-   OPAL_OUTPUT( ( opal_dss_verbose, "opal_dss_unpack_float * %d\n", (int)*num_vals ) );
-    /* check to see if there's enough data in buffer */
-    if (opal_dss_too_small(buffer, (*num_vals)*sizeof(float))) {
-        return OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER;
-    }
-
-    /* unpack the data */
-    for (i = 0; i < (*num_vals); ++i) {
+    for (i = 0; i < num_vals; ++i) {
         n=1;
         if (OPAL_SUCCESS != (ret = opal_dss_unpack_string(buffer, &convert, &n, OPAL_STRING))) {
             return ret;
@@ -436,22 +429,46 @@ int opal_dss_unpack_float(opal_buffer_t *buffer, void *dest,
     return OPAL_SUCCESS;
 }
 
-int opal_dss_unpack_double(opal_buffer_t *buffer, void *dest,
-                           int32_t *num_vals, opal_data_type_t type)
+int opal_dss_unpack_float(opal_buffer_t *buffer, void *dest,
+                          int32_t *num_vals, opal_data_type_t type)
 {
-    int32_t i, n;
-    double *desttmp = (double*) dest, tmp;
+    float *desttmp = (float*) dest;
+    int32_t i;
+    uint32_t tmp;
     int ret;
-    char *convert;
 
-   OPAL_OUTPUT( ( opal_dss_verbose, "opal_dss_unpack_double * %d\n", (int)*num_vals ) );
-    /* check to see if there's enough data in buffer */
-    if (opal_dss_too_small(buffer, (*num_vals)*sizeof(double))) {
+   OPAL_OUTPUT( ( opal_dss_verbose, "opal_dss_unpack_float * %d\n", (int)*num_vals ) );
+    /* check to see if there's enough data in buffer - a text value
+     * never takes less room than a binary one */
+    if (opal_dss_too_small(buffer, (*num_vals) * (1 + sizeof(float)))) {
         return OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER;
     }
 
     /* unpack the data */
     for (i = 0; i < (*num_vals); ++i) {
+        if (OPAL_DSS_FLOAT_MARK != *buffer->unpack_ptr) {
+            if (OPAL_SUCCESS != (ret = opal_dss_unpack_float_text(buffer, &desttmp[i], 1))) {
+                return ret;
+            }
+            continue;
+        }
+        memcpy(&tmp, buffer->unpack_ptr + 1, sizeof(tmp));
+        tmp = ntohl(tmp);
+        memcpy(&desttmp[i], &tmp, sizeof(tmp));
+        buffer->unpack_ptr += 1 + sizeof(tmp);
+    }
+    return OPAL_SUCCESS;
+}
+
+static int opal_dss_unpack_double_text(opal_buffer_t *buffer, double *desttmp,
+                                       int32_t num_vals)
+{
+    int32_t i, n;
+    double tmp;
+    int ret;
+    char *convert;
+
+    for (i = 0; i < num_vals; ++i) {
         n=1;
         if (OPAL_SUCCESS != (ret = opal_dss_unpack_string(buffer, &convert, &n, OPAL_STRING))) {
             return ret;
@@ -467,6 +484,37 @@ int opal_dss_unpack_double(opal_buffer_t *buffer, void *dest,
     return OPAL_SUCCESS;
 }
 
+int opal_dss_unpack_double(opal_buffer_t *buffer, void *dest,
+                           int32_t *num_vals, opal_data_type_t type)
+{
+    double *desttmp = (double*) dest;
+    int32_t i;
+    uint64_t tmp;
+    int ret;
+
+   OPAL_OUTPUT( ( opal_dss_verbose, "opal_dss_unpack_double * %d\n", (int)*num_vals ) );
+    /* check to see if there's enough data in buffer - a text value
+     * never takes less room than a binary one */
+    if (opal_dss_too_small(buffer, (*num_vals) * (1 + sizeof(double)))) {
+        return OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER;
+    }
+
+    /* unpack the data */
+    for (i = 0; i < (*num_vals); ++i) {
+        if (OPAL_DSS_FLOAT_MARK != *buffer->unpack_ptr) {
+            if (OPAL_SUCCESS != (ret = opal_dss_unpack_double_text(buffer, &desttmp[i], 1))) {
+                return ret;
+            }
+            continue;
+        }
+        memcpy(&tmp, buffer->unpack_ptr + 1, sizeof(tmp));
+        tmp = ntoh64(tmp);
+        memcpy(&desttmp[i], &tmp, sizeof(tmp));
+        buffer->unpack_ptr += 1 + sizeof(tmp);
+    }
+    return OPAL_SUCCESS;
+}
+
 int opal_dss_unpack_timeval(opal_buffer_t *buffer, void *dest,
                             int32_t *num_vals, opal_data_type_t type)
 {
@@ -1518,3 +1566,141 @@ int opal_dss_unpack_vpid(opal_buffer_t *buffer, void *dest,
 
     return ret;
 }
+
+/*
+ * BORROWED VIEWS
+ *
+ * Read the framing opal_dss_unpack would consume for a single value of
+ * the given type, leaving the buffer at the start of the value itself
+ */
+static int opal_dss_unpack_view_header(opal_buffer_t *buffer, opal_data_type_t type)
+{
+    int rc;
+    int32_t num, n=1;
+    opal_data_type_t local_type;
+
+    if (OPAL_DSS_BUFFER_FULLY_DESC == buffer->type) {
+        if (OPAL_SUCCESS != (rc = opal_dss_get_data_type(buffer, &local_type))) {
+            return rc;
+        }
+        if (OPAL_INT32 != local_type) {
+            return OPAL_ERR_UNPACK_FAILURE;
+        }
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss_unpack_int32(buffer, &num, &n, OPAL_INT32))) {
+        return rc;
+    }
+    /* a view covers exactly one value */
+    if (1 != num) {
+        return OPAL_ERR_UNPACK_INADEQUATE_SPACE;
+    }
+    if (OPAL_DSS_BUFFER_FULLY_DESC == buffer->type) {
+        if (OPAL_SUCCESS != (rc = opal_dss_get_data_type(buffer, &local_type))) {
+            return rc;
+        }
+        if (type != local_type) {
+            opal_output(0, "OPAL dss:unpack: got type %d when expecting type %d", local_type, type);
+            return OPAL_ERR_PACK_MISMATCH;
+        }
+    }
+    return OPAL_SUCCESS;
+}
+
+int opal_dss_unpack_string_view(opal_buffer_t *buffer, const char **str,
+                                int32_t *len)
+{
+    int ret;
+    int32_t slen, n=1;
+
+    if (NULL == buffer || NULL == str) {
+        return OPAL_ERR_BAD_PARAM;
+    }
+    if (OPAL_SUCCESS != (ret = opal_dss_unpack_view_header(buffer, OPAL_STRING))) {
+        return ret;
+    }
+    if (OPAL_SUCCESS != (ret = opal_dss_unpack_int32(buffer, &slen, &n, OPAL_INT32))) {
+        return ret;
+    }
+    if (0 == slen) {   /* zero-length string - a packed NULL */
+        *str = NULL;
+        if (NULL != len) {
+            *len = 0;
+        }
+        return OPAL_SUCCESS;
+    }
+    /* the packed length includes the terminator, which must be there
+     * for the view to be usable as a C string */
+    if (0 > slen || opal_dss_too_small(buffer, slen)) {
+        return OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER;
+    }
+    if ('\0' != buffer->unpack_ptr[slen-1]) {
+        return OPAL_ERR_UNPACK_FAILURE;
+    }
+    *str = buffer->unpack_ptr;
+    if (NULL != len) {
+        *len = slen - 1;
+    }
+    buffer->unpack_ptr += slen;
+    return OPAL_SUCCESS;
+}
+
+int opal_dss_unpack_bytes_view(opal_buffer_t *buffer, opal_byte_object_t *bo)
+{
+    int ret;
+    int32_t size, n=1;
+
+    if (NULL == buffer || NULL == bo) {
+        return OPAL_ERR_BAD_PARAM;
+    }
+    if (OPAL_SUCCESS != (ret = opal_dss_unpack_view_header(buffer, OPAL_BYTE_OBJECT))) {
+        return ret;
+    }
+    if (OPAL_SUCCESS != (ret = opal_dss_unpack_int32(buffer, &size, &n, OPAL_INT32))) {
+        return ret;
+    }
+    if (0 > size || opal_dss_too_small(buffer, size)) {
+        return OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER;
+    }
+    bo->size = size;
+    bo->bytes = (0 == size) ? NULL : (uint8_t*)buffer->unpack_ptr;
+    buffer->unpack_ptr += size;
+    return OPAL_SUCCESS;
+}
+
+int opal_dss_unpack_buffer_view(opal_buffer_t *buffer, opal_buffer_t *view)
+{
+    int ret;
+    int32_t n=1;
+    size_t nbytes;
+
+    if (NULL == buffer || NULL == view || buffer == view) {
+        return OPAL_ERR_BAD_PARAM;
+    }
+    if (OPAL_SUCCESS != (ret = opal_dss_unpack_view_header(buffer, OPAL_BUFFER))) {
+        return ret;
+    }
+    if (OPAL_SUCCESS != (ret = opal_dss_unpack_sizet(buffer, &nbytes, &n, OPAL_SIZE))) {
+        return ret;
+    }
+    if (opal_dss_too_small(buffer, nbytes)) {
+        return OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER;
+    }
+
+    /* drop whatever the view held before */
+    if (NULL != view->base_ptr && !view->borrowed) {
+        free(view->base_ptr);
+    }
+    if (0 < nbytes) {
+        view->base_ptr = buffer->unpack_ptr;
+        view->borrowed = true;
+    } else {
+        view->base_ptr = NULL;
+        view->borrowed = false;
+    }
+    view->pack_ptr = view->base_ptr + nbytes;
+    view->unpack_ptr = view->base_ptr;
+    view->bytes_allocated = nbytes;
+    view->bytes_used = nbytes;
+    buffer->unpack_ptr += nbytes;
+    return OPAL_SUCCESS;
+}
@@ -40,6 +40,7 @@
 static int opal_pstat_base_unsupported_init(void);
 static int opal_pstat_base_unsupported_query(pid_t pid, opal_pstats_t *stats, opal_node_stats_t *nstats);
 static int opal_pstat_base_unsupported_finalize(void);
+static int opal_pstat_base_unsupported_query_batch(pid_t *pids, int npids, opal_pstats_t **stats);
 
 /*
  * Globals
@@ -48,7 +49,8 @@ opal_pstat_base_component_t *opal_pstat_base_component = NULL;
 opal_pstat_base_module_t opal_pstat = {
     opal_pstat_base_unsupported_init,
     opal_pstat_base_unsupported_query,
-    opal_pstat_base_unsupported_finalize
+    opal_pstat_base_unsupported_finalize,
+    opal_pstat_base_unsupported_query_batch
 };
 
 /* Use default register/open/close functions */
@@ -86,3 +88,8 @@ static int opal_pstat_base_unsupported_finalize(void)
 {
     return OPAL_ERR_NOT_SUPPORTED;
 }
+
+static int opal_pstat_base_unsupported_query_batch(pid_t *pids, int npids, opal_pstats_t **stats)
+{
+    return OPAL_ERR_NOT_SUPPORTED;
+}
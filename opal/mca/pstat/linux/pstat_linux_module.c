@@ -41,6 +41,8 @@
 
 #include <sys/param.h>  /* for HZ to convert jiffies to actual time */
 
+#include "opal/class/opal_hash_table.h"
+#include "opal/class/opal_list.h"
 #include "opal/dss/dss_types.h"
 #include "opal/util/argv.h"
 #include "opal/util/printf.h"
@@ -55,6 +57,8 @@ static int query(pid_t pid,
                  opal_pstats_t *stats,
                  opal_node_stats_t *nstats);
 static int linux_module_fini(void);
+static int query_batch(pid_t *pids, int npids,
+                       opal_pstats_t **stats);
 
 /*
  * Linux pstat module
@@ -63,19 +67,63 @@ const opal_pstat_base_module_t opal_pstat_linux_module = {
     /* Initialization function */
     linux_module_init,
     query,
-    linux_module_fini
+    linux_module_fini,
+    query_batch
 };
 
 #define OPAL_STAT_MAX_LENGTH   1024
 
 /* Local functions */
 static char *local_getline(FILE *fp);
+static char *buffer_getline(char **cursor);
 static char *local_stripper(char *data);
 static void local_getfields(char *data, char ***fields);
 
 /* Local data */
 static char input[OPAL_STAT_MAX_LENGTH];
 
+/* The node-wide files are read every sample, so keep them open and
+ * re-read them from the start rather than reopening each time
+ */
+static int loadavg_fd = -1;
+static int meminfo_fd = -1;
+
+/* Descriptors held open for each process in a batch query. A pid
+ * that is reused after its process exits is caught because reads
+ * through the old descriptor fail once the original task is gone
+ */
+typedef struct {
+    opal_list_item_t super;
+    pid_t pid;
+    int stat_fd;
+    int status_fd;
+    uint64_t pass;
+} pstat_linux_proc_t;
+static void proc_con(pstat_linux_proc_t *p)
+{
+    p->pid = 0;
+    p->stat_fd = -1;
+    p->status_fd = -1;
+    p->pass = 0;
+}
+static void proc_des(pstat_linux_proc_t *p)
+{
+    if (0 <= p->stat_fd) {
+        close(p->stat_fd);
+    }
+    if (0 <= p->status_fd) {
+        close(p->status_fd);
+    }
+}
+static OBJ_CLASS_INSTANCE(pstat_linux_proc_t,
+                          opal_list_item_t,
+                          proc_con, proc_des);
+
+static bool batch_init = false;
+static opal_list_t batch_procs;
+static opal_hash_table_t batch_index;
+static uint64_t batch_pass = 0;
+
 static int linux_module_init(void)
 {
     return OPAL_SUCCESS;
@@ -83,9 +131,68 @@ static int linux_module_init(void)
 
 static int linux_module_fini(void)
 {
+    opal_list_item_t *item;
+
+    if (batch_init) {
+        while (NULL != (item = opal_list_remove_first(&batch_procs))) {
+            OBJ_RELEASE(item);
+        }
+        OBJ_DESTRUCT(&batch_procs);
+        OBJ_DESTRUCT(&batch_index);
+        batch_init = false;
+    }
+    if (0 <= loadavg_fd) {
+        close(loadavg_fd);
+        loadavg_fd = -1;
+    }
+    if (0 <= meminfo_fd) {
+        close(meminfo_fd);
+        meminfo_fd = -1;
+    }
     return OPAL_SUCCESS;
 }
 
+/* read a /proc file from the start into data, returning its length */
+static int read_whole(int fd, char *data, size_t size)
+{
+    ssize_t len;
+
+    len = pread(fd, data, size-1, 0);
+    if (len < 0) {
+        return -1;
+    }
+    data[len] = '\0';
+    return (int)len;
+}
+
+/* read a /proc file that is not kept open */
+static int read_file(const char *path, char *data, size_t size)
+{
+    int fd, len;
+
+    if (0 > (fd = open(path, O_RDONLY))) {
+        return -1;
+    }
+    len = read_whole(fd, data, size);
+    close(fd);
+    return len;
+}
+
+/* read a node-wide file through a descriptor we keep open */
+static int read_cached(int *fd, const char *path, char *data, size_t size)
+{
+    int len;
+
+    if (0 > *fd && 0 > (*fd = open(path, O_RDONLY))) {
+        return -1;
+    }
+    if (0 > (len = read_whole(*fd, data, size))) {
+        close(*fd);
+        *fd = -1;
+    }
+    return len;
+}
+
 static char *next_field(char *ptr, int barrier)
 {
     int i=0;
@@ -121,17 +228,142 @@ static float convert_value(char *value)
     return fval;
 }
 
+/* parse the single line of /proc/<pid>/stat as per proc(5) */
+static int parse_stat(char *data, int len, opal_pstats_t *stats)
+{
+    char *ptr, *eptr;
+    int i, itime;
+    double dtime;
+
+    /* the stat file consists of a single line in a carefully formatted
+     * form. Parse it field by field as per proc(3) to get the ones we want
+     */
+
+    /* the cmd is surrounded by parentheses - find the start */
+    if (NULL == (ptr = strchr(data, '('))) {
+        /* no cmd => something wrong with data, return error */
+        return OPAL_ERR_BAD_PARAM;
+    }
+    /* step over the paren */
+    ptr++;
+
+    /* find the ending paren */
+    if (NULL == (eptr = strchr(ptr, ')'))) {
+        /* no end to cmd => something wrong with data, return error */
+        return OPAL_ERR_BAD_PARAM;
+    }
+
+    /* save the cmd name, up to the limit of the array */
+    i = 0;
+    while (ptr < eptr && i < OPAL_PSTAT_MAX_STRING_LEN) {
+        stats->cmd[i++] = *ptr++;
+    }
+
+    /* move to the next field in the data */
+    ptr = next_field(eptr, len);
+
+    /* next is the process state - a single character */
+    stats->state[0] = *ptr;
+    /* move to next field */
+    ptr = next_field(ptr, len);
+
+    /* skip fields until we get to the times */
+    ptr = next_field(ptr, len); /* ppid */
+    ptr = next_field(ptr, len); /* pgrp */
+    ptr = next_field(ptr, len); /* session */
+    ptr = next_field(ptr, len); /* tty_nr */
+    ptr = next_field(ptr, len); /* tpgid */
+    ptr = next_field(ptr, len); /* flags */
+    ptr = next_field(ptr, len); /* minflt */
+    ptr = next_field(ptr, len); /* cminflt */
+    ptr = next_field(ptr, len); /* majflt */
+    ptr = next_field(ptr, len); /* cmajflt */
+
+    /* grab the process time usage fields */
+    itime = strtoul(ptr, &ptr, 10);    /* utime */
+    itime += strtoul(ptr, &ptr, 10);   /* add the stime */
+    /* convert to time in seconds */
+    dtime = (double)itime / (double)HZ;
+    stats->time.tv_sec = (int)dtime;
+    stats->time.tv_usec = (int)(1000000.0 * (dtime - stats->time.tv_sec));
+    /* move to next field */
+    ptr = next_field(ptr, len);
+
+    /* skip fields until we get to priority */
+    ptr = next_field(ptr, len); /* cutime */
+    ptr = next_field(ptr, len); /* cstime */
+
+    /* save the priority */
+    stats->priority = strtol(ptr, &ptr, 10);
+    /* move to next field */
+    ptr = next_field(ptr, len);
+
+    /* skip nice */
+    ptr = next_field(ptr, len);
+
+    /* get number of threads */
+    stats->num_threads = strtoul(ptr, &ptr, 10);
+    /* move to next field */
+    ptr = next_field(ptr, len);
+
+    /* skip fields until we get to processor id */
+    ptr = next_field(ptr, len);  /* itrealvalue */
+    ptr = next_field(ptr, len);  /* starttime */
+    ptr = next_field(ptr, len);  /* vsize */
+    ptr = next_field(ptr, len);  /* rss */
+    ptr = next_field(ptr, len);  /* rss limit */
+    ptr = next_field(ptr, len);  /* startcode */
+    ptr = next_field(ptr, len);  /* endcode */
+    ptr = next_field(ptr, len);  /* startstack */
+    ptr = next_field(ptr, len);  /* kstkesp */
+    ptr = next_field(ptr, len);  /* kstkeip */
+    ptr = next_field(ptr, len);  /* signal */
+    ptr = next_field(ptr, len);  /* blocked */
+    ptr = next_field(ptr, len);  /* sigignore */
+    ptr = next_field(ptr, len);  /* sigcatch */
+    ptr = next_field(ptr, len);  /* wchan */
+    ptr = next_field(ptr, len);  /* nswap */
+    ptr = next_field(ptr, len);  /* cnswap */
+    ptr = next_field(ptr, len);  /* exit_signal */
+
+    /* finally - get the processor */
+    stats->processor = strtol(ptr, NULL, 10);
+
+    /* that's all we care about from this data - ignore the rest */
+    return OPAL_SUCCESS;
+}
+
+/* pick the memory sizes out of /proc/<pid>/status */
+static void parse_status(char *data, opal_pstats_t *stats)
+{
+    char *cursor, *dptr, *value;
+
+    cursor = data;
+    while (NULL != (dptr = buffer_getline(&cursor))) {
+        if (NULL == (value = local_stripper(dptr))) {
+            /* cannot process */
+            continue;
+        }
+        /* look for VmPeak */
+        if (0 == strncmp(dptr, "VmPeak", strlen("VmPeak"))) {
+            stats->peak_vsize = convert_value(value);
+        } else if (0 == strncmp(dptr, "VmSize", strlen("VmSize"))) {
+            stats->vsize = convert_value(value);
+        } else if (0 == strncmp(dptr, "VmRSS", strlen("VmRSS"))) {
+            stats->rss = convert_value(value);
+        }
+    }
+}
+
 static int query(pid_t pid,
                  opal_pstats_t *stats,
                  opal_node_stats_t *nstats)
 {
     char data[4096];
-    int fd;
+    char path[64];
     size_t numchars;
-    char *ptr, *eptr;
-    int i;
-    int len, itime;
-    double dtime;
+    char *ptr, *eptr, *cursor;
+    int len, rc;
     FILE *fp;
     char *dptr, *value;
     char **fields;
@@ -155,12 +387,15 @@ static int query(pid_t pid,
 
     if (NULL != stats) {
         /* create the stat filename for this proc */
-        numchars = snprintf(data, sizeof(data), "/proc/%d/stat", pid);
-        if (numchars >= sizeof(data)) {
+        numchars = snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+        if (numchars >= sizeof(path)) {
             return OPAL_ERR_VALUE_OUT_OF_BOUNDS;
         }
 
-        if (0 > (fd = open(data, O_RDONLY))) {
+        /* absorb all of the file's contents in one gulp - we'll process
+         * it once it is in memory for speed
+         */
+        if (0 > (len = read_file(path, data, sizeof(data)))) {
             /* can't access this file - most likely, this means we
              * aren't really on a supported system, or the proc no
              * longer exists. Just return an error
@@ -168,185 +403,49 @@ static int query(pid_t pid,
             return OPAL_ERR_FILE_OPEN_FAILURE;
         }
 
-        /* absorb all of the file's contents in one gulp - we'll process
-         * it once it is in memory for speed
-         */
-        memset(data, 0, sizeof(data));
-        len = read(fd, data, sizeof(data)-1);
-        if (len < 0) {
-            /* This shouldn't happen! */
-            close(fd);
-            return OPAL_ERR_FILE_OPEN_FAILURE;
-        }
-        close(fd);
-
-        /* remove newline at end */
-        data[len] = '\0';
-
-        /* the stat file consists of a single line in a carefully formatted
-         * form. Parse it field by field as per proc(3) to get the ones we want
-         */
-
         /* we don't need to read the pid from the file - we already know it! */
         stats->pid = pid;
 
-        /* the cmd is surrounded by parentheses - find the start */
-        if (NULL == (ptr = strchr(data, '('))) {
-            /* no cmd => something wrong with data, return error */
-            return OPAL_ERR_BAD_PARAM;
-        }
-        /* step over the paren */
-        ptr++;
-
-        /* find the ending paren */
-        if (NULL == (eptr = strchr(ptr, ')'))) {
-            /* no end to cmd => something wrong with data, return error */
-            return OPAL_ERR_BAD_PARAM;
+        if (OPAL_SUCCESS != (rc = parse_stat(data, len, stats))) {
+            return rc;
         }
 
-        /* save the cmd name, up to the limit of the array */
-        i = 0;
-        while (ptr < eptr && i < OPAL_PSTAT_MAX_STRING_LEN) {
-            stats->cmd[i++] = *ptr++;
-        }
-
-        /* move to the next field in the data */
-        ptr = next_field(eptr, len);
-
-        /* next is the process state - a single character */
-        stats->state[0] = *ptr;
-        /* move to next field */
-        ptr = next_field(ptr, len);
-
-        /* skip fields until we get to the times */
-        ptr = next_field(ptr, len); /* ppid */
-        ptr = next_field(ptr, len); /* pgrp */
-        ptr = next_field(ptr, len); /* session */
-        ptr = next_field(ptr, len); /* tty_nr */
-        ptr = next_field(ptr, len); /* tpgid */
-        ptr = next_field(ptr, len); /* flags */
-        ptr = next_field(ptr, len); /* minflt */
-        ptr = next_field(ptr, len); /* cminflt */
-        ptr = next_field(ptr, len); /* majflt */
-        ptr = next_field(ptr, len); /* cmajflt */
-
-        /* grab the process time usage fields */
-        itime = strtoul(ptr, &ptr, 10);    /* utime */
-        itime += strtoul(ptr, &ptr, 10);   /* add the stime */
-        /* convert to time in seconds */
-        dtime = (double)itime / (double)HZ;
-        stats->time.tv_sec = (int)dtime;
-        stats->time.tv_usec = (int)(1000000.0 * (dtime - stats->time.tv_sec));
-        /* move to next field */
-        ptr = next_field(ptr, len);
-
-        /* skip fields until we get to priority */
-        ptr = next_field(ptr, len); /* cutime */
-        ptr = next_field(ptr, len); /* cstime */
-
-        /* save the priority */
-        stats->priority = strtol(ptr, &ptr, 10);
-        /* move to next field */
-        ptr = next_field(ptr, len);
-
-        /* skip nice */
-        ptr = next_field(ptr, len);
-
-        /* get number of threads */
-        stats->num_threads = strtoul(ptr, &ptr, 10);
-        /* move to next field */
-        ptr = next_field(ptr, len);
-
-        /* skip fields until we get to processor id */
-        ptr = next_field(ptr, len);  /* itrealvalue */
-        ptr = next_field(ptr, len);  /* starttime */
-        ptr = next_field(ptr, len);  /* vsize */
-        ptr = next_field(ptr, len);  /* rss */
-        ptr = next_field(ptr, len);  /* rss limit */
-        ptr = next_field(ptr, len);  /* startcode */
-        ptr = next_field(ptr, len);  /* endcode */
-        ptr = next_field(ptr, len);  /* startstack */
-        ptr = next_field(ptr, len);  /* kstkesp */
-        ptr = next_field(ptr, len);  /* kstkeip */
-        ptr = next_field(ptr, len);  /* signal */
-        ptr = next_field(ptr, len);  /* blocked */
-        ptr = next_field(ptr, len);  /* sigignore */
-        ptr = next_field(ptr, len);  /* sigcatch */
-        ptr = next_field(ptr, len);  /* wchan */
-        ptr = next_field(ptr, len);  /* nswap */
-        ptr = next_field(ptr, len);  /* cnswap */
-        ptr = next_field(ptr, len);  /* exit_signal */
-
-        /* finally - get the processor */
-        stats->processor = strtol(ptr, NULL, 10);
-
-        /* that's all we care about from this data - ignore the rest */
-
         /* now create the status filename for this proc */
-        memset(data, 0, sizeof(data));
-        numchars = snprintf(data, sizeof(data), "/proc/%d/status", pid);
-        if (numchars >= sizeof(data)) {
+        numchars = snprintf(path, sizeof(path), "/proc/%d/status", pid);
+        if (numchars >= sizeof(path)) {
             return OPAL_ERR_VALUE_OUT_OF_BOUNDS;
         }
 
-        if (NULL == (fp = fopen(data, "r"))) {
+        if (0 > read_file(path, data, sizeof(data))) {
             /* ignore this */
             return OPAL_SUCCESS;
         }
-
-        /* parse it according to proc(3) */
-        while (NULL != (dptr = local_getline(fp))) {
-            if (NULL == (value = local_stripper(dptr))) {
-                /* cannot process */
-                continue;
-            }
-            /* look for VmPeak */
-            if (0 == strncmp(dptr, "VmPeak", strlen("VmPeak"))) {
-                stats->peak_vsize = convert_value(value);
-            } else if (0 == strncmp(dptr, "VmSize", strlen("VmSize"))) {
-                stats->vsize = convert_value(value);
-            } else if (0 == strncmp(dptr, "VmRSS", strlen("VmRSS"))) {
-                stats->rss = convert_value(value);
-            }
-        }
-        fclose(fp);
+        parse_status(data, stats);
     }
 
     if (NULL != nstats) {
         /* get the loadavg data */
-        if (0 > (fd = open("/proc/loadavg", O_RDONLY))) {
+        if (0 > read_cached(&loadavg_fd, "/proc/loadavg", data, sizeof(data))) {
             /* not an error if we don't find this one as it
              * isn't critical
              */
             goto diskstats;
         }
 
-        /* absorb all of the file's contents in one gulp - we'll process
-         * it once it is in memory for speed
-         */
-        memset(data, 0, sizeof(data));
-        len = read(fd, data, sizeof(data)-1);
-        close(fd);
-        if (len < 0) {
-            goto diskstats;
-        }
-
-        /* remove newline at end */
-        data[len] = '\0';
-
         /* we only care about the first three numbers */
         nstats->la = strtof(data, &ptr);
         nstats->la5 = strtof(ptr, &eptr);
         nstats->la15 = strtof(eptr, NULL);
 
-        /* see if we can open the meminfo file */
-        if (NULL == (fp = fopen("/proc/meminfo", "r"))) {
+        /* see if we can read the meminfo file */
+        if (0 > read_cached(&meminfo_fd, "/proc/meminfo", data, sizeof(data))) {
             /* ignore this */
             goto diskstats;
         }
 
-        /* read the file one line at a time */
-        while (NULL != (dptr = local_getline(fp))) {
+        /* step through it one line at a time */
+        cursor = data;
+        while (NULL != (dptr = buffer_getline(&cursor))) {
             if (NULL == (value = local_stripper(dptr))) {
                 /* cannot process */
                 continue;
@@ -369,7 +468,6 @@ static int query(pid_t pid,
                 nstats->mapped = convert_value(value);
             }
         }
-        fclose(fp);
 
     diskstats:
         /* look for the diskstats file */
@@ -458,6 +556,92 @@ static int query(pid_t pid,
     return OPAL_SUCCESS;
 }
 
+static pstat_linux_proc_t* open_proc(pid_t pid)
+{
+    pstat_linux_proc_t *proc;
+    char path[64];
+
+    proc = OBJ_NEW(pstat_linux_proc_t);
+    proc->pid = pid;
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    if (0 > (proc->stat_fd = open(path, O_RDONLY))) {
+        OBJ_RELEASE(proc);
+        return NULL;
+    }
+    /* the memory sizes are a nicety - carry on without them */
+    snprintf(path, sizeof(path), "/proc/%d/status", pid);
+    proc->status_fd = open(path, O_RDONLY);
+
+    opal_hash_table_set_value_uint32(&batch_index, (uint32_t)pid, proc);
+    opal_list_append(&batch_procs, &proc->super);
+    return proc;
+}
+
+static void close_proc(pstat_linux_proc_t *proc)
+{
+    opal_hash_table_remove_value_uint32(&batch_index, (uint32_t)proc->pid);
+    opal_list_remove_item(&batch_procs, &proc->super);
+    OBJ_RELEASE(proc);
+}
+
+/* Sample a whole set of processes, holding their /proc files open
+ * across calls so that a sample costs two preads per process rather
+ * than two open/read/close cycles plus stdio setup. Only one caller
+ * should use this, as the held descriptors track its pid set.
+ */
+static int query_batch(pid_t *pids, int npids,
+                       opal_pstats_t **stats)
+{
+    char data[4096];
+    pstat_linux_proc_t *proc, *next;
+    struct timeval now;
+    void *ptr;
+    int i, len;
+
+    if (!batch_init) {
+        OBJ_CONSTRUCT(&batch_procs, opal_list_t);
+        OBJ_CONSTRUCT(&batch_index, opal_hash_table_t);
+        opal_hash_table_init(&batch_index, 128);
+        batch_init = true;
+    }
+    ++batch_pass;
+
+    /* one timestamp serves the whole batch */
+    gettimeofday(&now, NULL);
+
+    for (i=0; i < npids; i++) {
+        stats[i]->pid = 0;
+        if (OPAL_SUCCESS == opal_hash_table_get_value_uint32(&batch_index, (uint32_t)pids[i], &ptr)) {
+            proc = (pstat_linux_proc_t*)ptr;
+        } else if (NULL == (proc = open_proc(pids[i]))) {
+            /* the process has most likely exited */
+            continue;
+        }
+        proc->pass = batch_pass;
+
+        if (0 >= (len = read_whole(proc->stat_fd, data, sizeof(data))) ||
+            OPAL_SUCCESS != parse_stat(data, len, stats[i])) {
+            /* gone - drop the descriptors so a reused pid is reopened */
+            close_proc(proc);
+            continue;
+        }
+        if (0 <= proc->status_fd && 0 < read_whole(proc->status_fd, data, sizeof(data))) {
+            parse_status(data, stats[i]);
+        }
+        stats[i]->pid = pids[i];
+        stats[i]->sample_time = now;
+    }
+
+    /* release whatever was not asked about this time */
+    OPAL_LIST_FOREACH_SAFE(proc, next, &batch_procs, pstat_linux_proc_t) {
+        if (batch_pass != proc->pass) {
+            close_proc(proc);
+        }
+    }
+
+    return OPAL_SUCCESS;
+}
+
 static char *local_getline(FILE *fp)
 {
     char *ret, *ptr;
@@ -476,6 +660,28 @@ static char *local_getline(FILE *fp)
     return NULL;
 }
 
+/* step through an in-memory copy of a file one line at a time */
+static char *buffer_getline(char **cursor)
+{
+    char *line, *eol;
+
+    if ('\0' == **cursor) {
+        return NULL;
+    }
+    line = *cursor;
+    if (NULL != (eol = strchr(line, '\n'))) {
+        *eol = '\0';
+        *cursor = eol + 1;
+    } else {
+        *cursor = line + strlen(line);
+    }
+    /* strip leading white space */
+    while ('\0' != *line && !isalnum(*line)) {
+        line++;
+    }
+    return line;
+}
+
 static char *local_stripper(char *data)
 {
     char *ptr, *end, *enddata;
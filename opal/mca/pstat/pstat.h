@@ -45,6 +45,17 @@ typedef int (*opal_pstat_base_module_query_fn_t)(pid_t pid,
                                                  opal_pstats_t *stats,
                                                  opal_node_stats_t *nstats);
 
+/**
+ * Query a set of processes in one pass. The caller provides one
+ * constructed stats object per pid. Entries for processes that could
+ * not be read are left with their pid field at zero. Modules may hold
+ * per-process state open between calls, so the same caller should
+ * pass the same set of pids each time; state for pids absent from a
+ * call is released.
+ */
+typedef int (*opal_pstat_base_module_query_batch_fn_t)(pid_t *pids, int npids,
+                                                       opal_pstats_t **stats);
+
 typedef int (*opal_pstat_base_module_fini_fn_t)(void);
 
 /**
@@ -70,6 +81,7 @@ struct opal_pstat_base_module_1_0_0_t {
     opal_pstat_base_module_init_fn_t    init;
     opal_pstat_base_module_query_fn_t   query;
     opal_pstat_base_module_fini_fn_t    finalize;
+    opal_pstat_base_module_query_batch_fn_t query_batch;
 };
 
 /**
@@ -40,6 +40,8 @@ static int query(pid_t pid,
                  opal_pstats_t *stats,
                  opal_node_stats_t *nstats);
 static int fini(void);
+static int query_batch(pid_t *pids, int npids,
+                       opal_pstats_t **stats);
 
 /*
  * Test pstat module
@@ -47,7 +49,8 @@ static int fini(void);
 const opal_pstat_base_module_t opal_pstat_test_module = {
     init,
     query,
-    fini
+    fini,
+    query_batch
 };
 
 static int init(void)
@@ -122,3 +125,14 @@ static int query(pid_t pid,
 
     return OPAL_SUCCESS;
 }
+
+static int query_batch(pid_t *pids, int npids,
+                       opal_pstats_t **stats)
+{
+    int i;
+
+    for (i=0; i < npids; i++) {
+        query(pids[i], stats[i], NULL);
+    }
+    return OPAL_SUCCESS;
+}
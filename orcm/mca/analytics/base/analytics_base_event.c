@@ -9,6 +9,7 @@
 
 #include "orcm/mca/analytics/base/analytics_private.h"
 #include "orcm/util/utils.h"
+#include "orcm/util/value_batch.h"
 #include "orcm/runtime/orcm_globals.h"
 #include "orcm/mca/evgen/evgen.h"
 
@@ -19,12 +20,22 @@ typedef struct {
     unsigned int cat_int;
 } orcm_analytics_event_cat_types_t;
 
+/* build the value in the event's batch when it has one */
+static orcm_value_t *event_load_value(orcm_ras_event_t *analytics_event_data, char *key,
+                                      void *data, opal_data_type_t type, char *units)
+{
+    if (NULL != analytics_event_data->batch) {
+        return orcm_value_batch_load(analytics_event_data->batch, key, data, type, units);
+    }
+    return orcm_util_load_orcm_value(key, data, type, units);
+}
+
 int orcm_analytics_base_event_set_reporter(orcm_ras_event_t *analytics_event_data, char *key,
                                            void *data, opal_data_type_t type, char *units)
 {
     orcm_value_t *analytics_orcm_value = NULL;
 
-    analytics_orcm_value = orcm_util_load_orcm_value(key, data, type, units);
+    analytics_orcm_value = event_load_value(analytics_event_data, key, data, type, units);
     if (NULL == analytics_orcm_value) {
         return ORCM_ERR_OUT_OF_RESOURCE;
     }
@@ -38,7 +49,7 @@ int orcm_analytics_base_event_set_description(orcm_ras_event_t *analytics_event_
 {
     orcm_value_t *analytics_orcm_value = NULL;
 
-    analytics_orcm_value = orcm_util_load_orcm_value(key, data, type, units);
+    analytics_orcm_value = event_load_value(analytics_event_data, key, data, type, units);
     if (NULL == analytics_orcm_value) {
         return ORCM_ERR_OUT_OF_RESOURCE;
     }
@@ -81,12 +92,23 @@ orcm_ras_event_t* orcm_analytics_base_event_create(orcm_analytics_value_t *analy
 
     if (NULL != analytics_event_data) {
 
-        if (ORCM_SUCCESS != orcm_util_copy_list_items(analytics_data->key, &(analytics_event_data->reporter))) {
+        /* the copies all go into one batch, freed with the event */
+        analytics_event_data->batch = OBJ_NEW(orcm_value_batch_t);
+        if (NULL == analytics_event_data->batch) {
+            OBJ_RELEASE(analytics_event_data);
+            return NULL;
+        }
+
+        if (ORCM_SUCCESS != orcm_value_batch_copy_list(analytics_event_data->batch,
+                                                       analytics_data->key,
+                                                       &(analytics_event_data->reporter))) {
             OBJ_RELEASE(analytics_event_data);
             return NULL;
         }
 
-        if (ORCM_SUCCESS != orcm_util_copy_list_items(analytics_data->compute_data, &(analytics_event_data->data))) {
+        if (ORCM_SUCCESS != orcm_value_batch_copy_list(analytics_event_data->batch,
+                                                       analytics_data->compute_data,
+                                                       &(analytics_event_data->data))) {
             OBJ_RELEASE(analytics_event_data);
             return NULL;
         }
@@ -95,8 +117,9 @@ orcm_ras_event_t* orcm_analytics_base_event_create(orcm_analytics_value_t *analy
 
         /*Don't copy the timestamp again */
         if (!(analytics_event_data->timestamp > 0 && analytics_data->non_compute_data->opal_list_length == 1)) {
-            if (ORCM_SUCCESS != orcm_util_copy_list_items(analytics_data->non_compute_data,
-                                                          &(analytics_event_data->description))) {
+            if (ORCM_SUCCESS != orcm_value_batch_copy_list(analytics_event_data->batch,
+                                                           analytics_data->non_compute_data,
+                                                           &(analytics_event_data->description))) {
                 OBJ_RELEASE(analytics_event_data);
                 return NULL;
             }
@@ -64,6 +64,22 @@ static int orcm_analytics_base_register(mca_base_register_flag_t flags)
                                 MCA_BASE_VAR_SCOPE_READONLY,
                                 &orcm_analytics_base.store_event_data);
 
+    orcm_analytics_base.recent_window = 300;
+    (void)mca_base_var_register("orcm", "analytics", "base", "recent_window",
+                                "Seconds of sensor samples each aggregator keeps in memory "
+                                "for latest-value queries (0 = disabled)",
+                                MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                OPAL_INFO_LVL_9,
+                                MCA_BASE_VAR_SCOPE_READONLY,
+                                &orcm_analytics_base.recent_window);
+    orcm_analytics_base.recent_max_samples = 64;
+    (void)mca_base_var_register("orcm", "analytics", "base", "recent_max_samples",
+                                "Maximum number of in-memory samples kept per host and sensor",
+                                MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                OPAL_INFO_LVL_9,
+                                MCA_BASE_VAR_SCOPE_READONLY,
+                                &orcm_analytics_base.recent_max_samples);
+
     return ORCM_SUCCESS;
 
 }
@@ -110,6 +126,7 @@ static int orcm_analytics_base_close(void)
         orcm_analytics_stop_wokflow(wf);
     }
     orcm_analytics_base_comm_stop();
+    orcm_analytics_base_recent_finalize();
 
     /* Destroy the base objects */
     OPAL_LIST_DESTRUCT(&orcm_analytics_base.workflows);
@@ -140,6 +157,11 @@ static int orcm_analytics_base_open(mca_base_open_flag_t flags)
         return rc;
     }
 
+    if (ORCM_SUCCESS != (rc = orcm_analytics_base_recent_init())) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+
     return rc;
 }
 
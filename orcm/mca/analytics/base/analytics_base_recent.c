@@ -0,0 +1,512 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Recent-sample cache. Aggregators keep the last few minutes of every
+ * (host, sensor) series they log so "latest value" queries can be
+ * answered from memory instead of the database. Each series is a small
+ * ring of timestamps and values held in two flat arrays that grow on
+ * demand up to recent_max_samples.
+ *
+ * Samples are stored from orcm_analytics_base_send_data(), which on an
+ * aggregator runs from the heartbeat receive, and queries arrive over
+ * RML - both in the RML progress thread, so no locking is needed.
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#include <fnmatch.h>
+#include <time.h>
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "opal/class/opal_hash_table.h"
+#include "opal/dss/dss.h"
+#include "opal/util/argv.h"
+#include "opal/util/output.h"
+
+#include "orte/mca/errmgr/errmgr.h"
+#include "orte/mca/rml/rml.h"
+#include "orte/util/name_fns.h"
+
+#include "orcm/runtime/orcm_globals.h"
+#include "orcm/util/utils.h"
+#include "orcm/mca/analytics/base/base.h"
+#include "orcm/mca/analytics/base/analytics_private.h"
+
+#define RECENT_INITIAL_SAMPLES 8
+#define RECENT_HASH_SIZE 1024
+
+typedef struct {
+    opal_object_t super;
+    char *name;
+    char *units;
+    bool integral;
+    /* ring of samples, oldest at head */
+    time_t *times;
+    double *values;
+    int32_t capacity;
+    int32_t head;
+    int32_t count;
+} recent_series_t;
+static void rscon(recent_series_t *p)
+{
+    p->name = NULL;
+    p->units = NULL;
+    p->integral = false;
+    p->times = NULL;
+    p->values = NULL;
+    p->capacity = 0;
+    p->head = 0;
+    p->count = 0;
+}
+static void rsdes(recent_series_t *p)
+{
+    SAFEFREE(p->name);
+    SAFEFREE(p->units);
+    SAFEFREE(p->times);
+    SAFEFREE(p->values);
+}
+static OBJ_CLASS_INSTANCE(recent_series_t,
+                          opal_object_t,
+                          rscon, rsdes);
+
+typedef struct {
+    opal_object_t super;
+    char *hostname;
+    opal_hash_table_t series;
+} recent_host_t;
+static void rhcon(recent_host_t *p)
+{
+    p->hostname = NULL;
+    OBJ_CONSTRUCT(&p->series, opal_hash_table_t);
+    opal_hash_table_init(&p->series, 64);
+}
+static void rhdes(recent_host_t *p)
+{
+    char *key = NULL;
+    size_t key_size = 0;
+    recent_series_t *value = NULL;
+    void *in_member = NULL;
+    void *out_member = NULL;
+
+    while (OPAL_SUCCESS == opal_hash_table_get_next_key_ptr(&p->series, (void**)&key,
+                                         &key_size, (void**)&value, in_member, &out_member)) {
+        OBJ_RELEASE(value);
+        in_member = out_member;
+        out_member = NULL;
+    }
+    OBJ_DESTRUCT(&p->series);
+    SAFEFREE(p->hostname);
+}
+static OBJ_CLASS_INSTANCE(recent_host_t,
+                          opal_object_t,
+                          rhcon, rhdes);
+
+static opal_hash_table_t recent_hosts;
+static bool recent_constructed = false;
+static bool recent_active = false;
+static bool recent_recv_issued = false;
+
+static bool recent_to_double(opal_value_t *kv, double *value, bool *integral)
+{
+    *integral = true;
+    switch (kv->type) {
+    case OPAL_INT:      *value = (double)kv->data.integer;  break;
+    case OPAL_INT8:     *value = (double)kv->data.int8;     break;
+    case OPAL_INT16:    *value = (double)kv->data.int16;    break;
+    case OPAL_INT32:    *value = (double)kv->data.int32;    break;
+    case OPAL_INT64:    *value = (double)kv->data.int64;    break;
+    case OPAL_UINT:     *value = (double)kv->data.uint;     break;
+    case OPAL_UINT8:    *value = (double)kv->data.uint8;    break;
+    case OPAL_UINT16:   *value = (double)kv->data.uint16;   break;
+    case OPAL_UINT32:   *value = (double)kv->data.uint32;   break;
+    case OPAL_UINT64:   *value = (double)kv->data.uint64;   break;
+    case OPAL_SIZE:     *value = (double)kv->data.size;     break;
+    case OPAL_FLOAT:
+        *value = (double)kv->data.fval;
+        *integral = false;
+        break;
+    case OPAL_DOUBLE:
+        *value = kv->data.dval;
+        *integral = false;
+        break;
+    default:
+        /* strings and the like are not cached */
+        return false;
+    }
+    return true;
+}
+
+/* drop everything that fell out of the window */
+static void recent_expire(recent_series_t *rs, time_t now)
+{
+    time_t oldest = now - orcm_analytics_base.recent_window;
+
+    while (0 < rs->count && rs->times[rs->head] < oldest) {
+        rs->head = (rs->head + 1) % rs->capacity;
+        rs->count--;
+    }
+}
+
+static int recent_grow(recent_series_t *rs)
+{
+    int32_t capacity, i, idx;
+    time_t *times;
+    double *values;
+
+    capacity = (0 == rs->capacity) ? RECENT_INITIAL_SAMPLES : 2 * rs->capacity;
+    if (capacity > orcm_analytics_base.recent_max_samples) {
+        capacity = orcm_analytics_base.recent_max_samples;
+    }
+    times = (time_t*)malloc(capacity * sizeof(time_t));
+    values = (double*)malloc(capacity * sizeof(double));
+    if (NULL == times || NULL == values) {
+        SAFEFREE(times);
+        SAFEFREE(values);
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    /* unroll the ring so the oldest sample is at index 0 */
+    for (i = 0; i < rs->count; i++) {
+        idx = (rs->head + i) % rs->capacity;
+        times[i] = rs->times[idx];
+        values[i] = rs->values[idx];
+    }
+    SAFEFREE(rs->times);
+    SAFEFREE(rs->values);
+    rs->times = times;
+    rs->values = values;
+    rs->capacity = capacity;
+    rs->head = 0;
+    return ORCM_SUCCESS;
+}
+
+static void recent_append(recent_series_t *rs, time_t when, double value)
+{
+    recent_expire(rs, when);
+    if (rs->count == rs->capacity &&
+        rs->capacity < orcm_analytics_base.recent_max_samples) {
+        if (ORCM_SUCCESS != recent_grow(rs)) {
+            return;
+        }
+    }
+    if (rs->count == rs->capacity) {
+        /* full - overwrite the oldest */
+        rs->times[rs->head] = when;
+        rs->values[rs->head] = value;
+        rs->head = (rs->head + 1) % rs->capacity;
+    } else {
+        int32_t idx = (rs->head + rs->count) % rs->capacity;
+        rs->times[idx] = when;
+        rs->values[idx] = value;
+        rs->count++;
+    }
+}
+
+static recent_host_t* recent_get_host(const char *hostname, bool create)
+{
+    recent_host_t *rh = NULL;
+
+    if (OPAL_SUCCESS == opal_hash_table_get_value_ptr(&recent_hosts, hostname,
+                                                      strlen(hostname), (void**)&rh)) {
+        return rh;
+    }
+    if (!create) {
+        return NULL;
+    }
+    rh = OBJ_NEW(recent_host_t);
+    rh->hostname = strdup(hostname);
+    opal_hash_table_set_value_ptr(&recent_hosts, hostname, strlen(hostname), rh);
+    return rh;
+}
+
+static recent_series_t* recent_get_series(recent_host_t *rh, const char *group,
+                                          orcm_value_t *item, bool integral)
+{
+    recent_series_t *rs = NULL;
+    char *name = NULL;
+
+    if (0 > asprintf(&name, "%s_%s", group, item->value.key)) {
+        return NULL;
+    }
+    if (OPAL_SUCCESS == opal_hash_table_get_value_ptr(&rh->series, name,
+                                                      strlen(name), (void**)&rs)) {
+        free(name);
+        return rs;
+    }
+    rs = OBJ_NEW(recent_series_t);
+    rs->name = name;
+    rs->units = (NULL == item->units) ? NULL : strdup(item->units);
+    rs->integral = integral;
+    opal_hash_table_set_value_ptr(&rh->series, name, strlen(name), rs);
+    return rs;
+}
+
+void orcm_analytics_base_recent_store(orcm_analytics_value_t *data)
+{
+    orcm_value_t *item;
+    recent_host_t *rh;
+    recent_series_t *rs;
+    char *hostname = NULL, *group = NULL;
+    uint64_t sample_time = 0;
+    double value;
+    bool integral;
+
+    if (!recent_active || NULL == data || NULL == data->key || NULL == data->compute_data) {
+        return;
+    }
+
+    OPAL_LIST_FOREACH(item, data->key, orcm_value_t) {
+        if (NULL == item->value.key || OPAL_STRING != item->value.type) {
+            continue;
+        }
+        if (0 == strcmp(item->value.key, "hostname")) {
+            hostname = item->value.data.string;
+        } else if (0 == strcmp(item->value.key, "data_group")) {
+            group = item->value.data.string;
+        }
+    }
+    if (NULL == hostname || NULL == group) {
+        return;
+    }
+    if (NULL == data->non_compute_data ||
+        ORCM_SUCCESS != orcm_analytics_base_get_sample_time(data->non_compute_data,
+                                                            &sample_time)) {
+        sample_time = (uint64_t)time(NULL);
+    }
+
+    rh = NULL;
+    OPAL_LIST_FOREACH(item, data->compute_data, orcm_value_t) {
+        if (NULL == item->value.key ||
+            !recent_to_double(&item->value, &value, &integral)) {
+            continue;
+        }
+        if (NULL == rh && NULL == (rh = recent_get_host(hostname, true))) {
+            return;
+        }
+        if (NULL != (rs = recent_get_series(rh, group, item, integral))) {
+            recent_append(rs, (time_t)sample_time, value);
+        }
+    }
+}
+
+static int recent_add_row(opal_list_t *results, const char *hostname,
+                          recent_series_t *rs, int32_t idx)
+{
+    opal_value_t *row;
+    char tbuf[32];
+    struct tm tm;
+    int ret;
+
+    localtime_r(&rs->times[idx], &tm);
+    strftime(tbuf, sizeof(tbuf), "%Y-%m-%d %H:%M:%S", &tm);
+    row = OBJ_NEW(opal_value_t);
+    row->type = OPAL_STRING;
+    if (rs->integral) {
+        ret = asprintf(&row->data.string, "%s,%s,%s,%lld,%s", hostname, rs->name, tbuf,
+                       (long long)rs->values[idx], (NULL == rs->units) ? "" : rs->units);
+    } else {
+        ret = asprintf(&row->data.string, "%s,%s,%s,%f,%s", hostname, rs->name, tbuf,
+                       rs->values[idx], (NULL == rs->units) ? "" : rs->units);
+    }
+    if (0 > ret) {
+        row->data.string = NULL;
+        OBJ_RELEASE(row);
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    opal_list_append(results, &row->super);
+    return ORCM_SUCCESS;
+}
+
+static void recent_query_host(recent_host_t *rh, const char *sensor,
+                              int32_t seconds, time_t now, opal_list_t *results)
+{
+    char *key = NULL;
+    size_t key_size = 0;
+    recent_series_t *rs = NULL;
+    void *in_member = NULL;
+    void *out_member = NULL;
+    int32_t i, idx;
+
+    while (OPAL_SUCCESS == opal_hash_table_get_next_key_ptr(&rh->series, (void**)&key,
+                                         &key_size, (void**)&rs, in_member, &out_member)) {
+        in_member = out_member;
+        out_member = NULL;
+        if (NULL != sensor && 0 != fnmatch(sensor, rs->name, 0)) {
+            continue;
+        }
+        recent_expire(rs, now);
+        if (0 == rs->count) {
+            continue;
+        }
+        if (0 == seconds) {
+            /* just the latest value */
+            recent_add_row(results, rh->hostname, rs,
+                           (rs->head + rs->count - 1) % rs->capacity);
+            continue;
+        }
+        for (i = 0; i < rs->count; i++) {
+            idx = (rs->head + i) % rs->capacity;
+            if (rs->times[idx] >= now - seconds) {
+                recent_add_row(results, rh->hostname, rs, idx);
+            }
+        }
+    }
+}
+
+int orcm_analytics_base_recent_query(char **hosts, const char *sensor,
+                                     int32_t seconds, opal_list_t *results)
+{
+    recent_host_t *rh = NULL;
+    char *key = NULL;
+    size_t key_size = 0;
+    void *in_member = NULL;
+    void *out_member = NULL;
+    time_t now = time(NULL);
+    int i;
+
+    if (!recent_active) {
+        return ORCM_ERR_NOT_AVAILABLE;
+    }
+    if (NULL != sensor && 0 == strcmp(sensor, "*")) {
+        sensor = NULL;
+    }
+
+    if (NULL == hosts) {
+        while (OPAL_SUCCESS == opal_hash_table_get_next_key_ptr(&recent_hosts, (void**)&key,
+                                             &key_size, (void**)&rh, in_member, &out_member)) {
+            recent_query_host(rh, sensor, seconds, now, results);
+            in_member = out_member;
+            out_member = NULL;
+        }
+        return ORCM_SUCCESS;
+    }
+    for (i = 0; NULL != hosts[i]; i++) {
+        if (NULL != (rh = recent_get_host(hosts[i], false))) {
+            recent_query_host(rh, sensor, seconds, now, results);
+        }
+    }
+    return ORCM_SUCCESS;
+}
+
+/* request: uint32 id, string sensor, int32 seconds, int32 nhosts, hosts
+ * reply:   uint32 id, int status, uint32 nrows, rows */
+static void recent_recv(int status, orte_process_name_t* sender,
+                        opal_buffer_t* buffer, orte_rml_tag_t tag,
+                        void* cbdata)
+{
+    opal_buffer_t *ans;
+    opal_list_t results;
+    opal_value_t *row;
+    uint32_t id, nrows;
+    int32_t seconds, nhosts, i;
+    const char *sensor = NULL, *host;
+    char **hosts = NULL;
+    int cnt = 1, rc;
+
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &id, &cnt, OPAL_UINT32)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(buffer, &sensor, NULL)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &seconds, &cnt, OPAL_INT32)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &nhosts, &cnt, OPAL_INT32))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+    for (i = 0; i < nhosts; i++) {
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(buffer, &host, NULL))) {
+            ORTE_ERROR_LOG(rc);
+            opal_argv_free(hosts);
+            return;
+        }
+        opal_argv_append_nosize(&hosts, host);
+    }
+
+    OBJ_CONSTRUCT(&results, opal_list_t);
+    status = orcm_analytics_base_recent_query(hosts, sensor, seconds, &results);
+    nrows = (uint32_t)opal_list_get_size(&results);
+
+    OPAL_OUTPUT_VERBOSE((5, orcm_analytics_base_framework.framework_output,
+                         "%s analytics:base:recent returning %u rows to %s",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), nrows,
+                         ORTE_NAME_PRINT(sender)));
+
+    ans = OBJ_NEW(opal_buffer_t);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &id, 1, OPAL_UINT32)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(ans, &status, 1, OPAL_INT)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(ans, &nrows, 1, OPAL_UINT32))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(ans);
+        goto cleanup;
+    }
+    OPAL_LIST_FOREACH(row, &results, opal_value_t) {
+        if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &row->data.string, 1, OPAL_STRING))) {
+            ORTE_ERROR_LOG(rc);
+            OBJ_RELEASE(ans);
+            goto cleanup;
+        }
+    }
+    if (ORTE_SUCCESS != (rc = orte_rml.send_buffer_nb(sender, ans,
+                                                      ORCM_RML_TAG_RECENT_SAMPLES,
+                                                      orte_rml_send_callback, NULL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(ans);
+    }
+
+cleanup:
+    OPAL_LIST_DESTRUCT(&results);
+    opal_argv_free(hosts);
+}
+
+int orcm_analytics_base_recent_init(void)
+{
+    OBJ_CONSTRUCT(&recent_hosts, opal_hash_table_t);
+    opal_hash_table_init(&recent_hosts, RECENT_HASH_SIZE);
+    recent_constructed = true;
+
+    /* only aggregators see the samples */
+    if (!ORCM_PROC_IS_AGGREGATOR || 0 >= orcm_analytics_base.recent_window ||
+        0 >= orcm_analytics_base.recent_max_samples) {
+        return ORCM_SUCCESS;
+    }
+
+    orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD, ORCM_RML_TAG_RECENT_SAMPLES,
+                            ORTE_RML_PERSISTENT, recent_recv, NULL);
+    recent_recv_issued = true;
+    recent_active = true;
+
+    return ORCM_SUCCESS;
+}
+
+void orcm_analytics_base_recent_finalize(void)
+{
+    recent_host_t *rh = NULL;
+    char *key = NULL;
+    size_t key_size = 0;
+    void *in_member = NULL;
+    void *out_member = NULL;
+
+    if (recent_recv_issued) {
+        orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_RECENT_SAMPLES);
+        recent_recv_issued = false;
+    }
+    recent_active = false;
+
+    if (!recent_constructed) {
+        return;
+    }
+    while (OPAL_SUCCESS == opal_hash_table_get_next_key_ptr(&recent_hosts, (void**)&key,
+                                         &key_size, (void**)&rh, in_member, &out_member)) {
+        OBJ_RELEASE(rh);
+        in_member = out_member;
+        out_member = NULL;
+    }
+    OBJ_DESTRUCT(&recent_hosts);
+    recent_constructed = false;
+}
@@ -24,6 +24,7 @@
 #include "orte/util/name_fns.h"
 
 #include "orcm/runtime/orcm_globals.h"
+#include "orcm/util/fanout.h"
 
 #include "orcm/mca/analytics/base/base.h"
 #include "orcm/mca/analytics/base/analytics_private.h"
@@ -38,6 +39,7 @@ static orcm_analytics_cmd_flag_t orcm_analytics_base_recv_unpack_command(opal_bu
                                                                     int count);
 static void orcm_analytics_base_recv_send_answer(orte_process_name_t* sender,
                                                  opal_buffer_t *ans, int rc);
+static int analytics_base_fanout(opal_buffer_t *buffer, opal_buffer_t *ans);
 
 int orcm_analytics_base_comm_start(void)
 {
@@ -54,6 +56,7 @@ int orcm_analytics_base_comm_start(void)
                             ORTE_RML_PERSISTENT,
                             orcm_analytics_base_recv,
                             NULL);
+    orcm_fanout_register(ORCM_RML_TAG_ANALYTICS, analytics_base_fanout);
     recv_issued = true;
     return ORCM_SUCCESS;
 }
@@ -70,6 +73,7 @@ int orcm_analytics_base_comm_stop(void)
                          ORTE_NAME_PRINT(ORTE_PROC_MY_NAME)));
 
     orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_ANALYTICS);
+    orcm_fanout_register(ORCM_RML_TAG_ANALYTICS, NULL);
     recv_issued = false;
     return ORCM_SUCCESS;
 }
@@ -137,24 +141,13 @@ static void orcm_analytics_base_recv_send_answer(orte_process_name_t* sender,
     return;
 }
 
-/* process incoming messages in order of receipt */
-static void orcm_analytics_base_recv(int status, orte_process_name_t* sender,
-                                     opal_buffer_t* buffer, orte_rml_tag_t tag,
-                                     void* cbdata)
+/* run one command, packing any data it returns */
+static int analytics_base_command(opal_buffer_t *buffer, opal_buffer_t *ans)
 {
-    int ret;
+    int ret = ORCM_ERROR;
     int id;
-    opal_buffer_t *ans = NULL;
     orcm_analytics_cmd_flag_t command;
 
-
-    OPAL_OUTPUT_VERBOSE((5, orcm_analytics_base_framework.framework_output,
-                         "%s analytics:base:receive processing msg from %s",
-                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
-                         ORTE_NAME_PRINT(sender)));
-
-    ans = OBJ_NEW(opal_buffer_t);
-
     command = orcm_analytics_base_recv_unpack_command(buffer, ANALYTICS_COUNT_DEFAULT);
 
     switch (command) {
@@ -176,12 +169,40 @@ static void orcm_analytics_base_recv(int status, orte_process_name_t* sender,
             break;
         default:
             OPAL_OUTPUT_VERBOSE((5, orcm_analytics_base_framework.framework_output,
-                                 "%s analytics:base:receive got unknown command from %s",
-                                 ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
-                                 ORTE_NAME_PRINT(sender)));
+                                 "%s analytics:base:receive got unknown command",
+                                 ORTE_NAME_PRINT(ORTE_PROC_MY_NAME)));
             ret = ORCM_ERR_BAD_PARAM;
             break;
     }
+    return ret;
+}
+
+/* same answer as over RML, the status goes last */
+static int analytics_base_fanout(opal_buffer_t *buffer, opal_buffer_t *ans)
+{
+    int ret;
+
+    ret = analytics_base_command(buffer, ans);
+    return orcm_analytics_base_recv_pack_int(ans, &ret, ANALYTICS_COUNT_DEFAULT);
+}
+
+/* process incoming messages in order of receipt */
+static void orcm_analytics_base_recv(int status, orte_process_name_t* sender,
+                                     opal_buffer_t* buffer, orte_rml_tag_t tag,
+                                     void* cbdata)
+{
+    int ret;
+    opal_buffer_t *ans = NULL;
+
+
+    OPAL_OUTPUT_VERBOSE((5, orcm_analytics_base_framework.framework_output,
+                         "%s analytics:base:receive processing msg from %s",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                         ORTE_NAME_PRINT(sender)));
+
+    ans = OBJ_NEW(opal_buffer_t);
+
+    ret = analytics_base_command(buffer, ans);
 
     orcm_analytics_base_recv_send_answer(sender, ans, ret);
     return;
@@ -425,6 +425,9 @@ void orcm_analytics_base_send_data(orcm_analytics_value_t *data)
     orcm_workflow_t *wf = NULL;
     orcm_ras_event_t *analytics_event_data = NULL;
 
+    /* remember the latest samples for in-memory queries */
+    orcm_analytics_base_recent_store(data);
+
     if (true == orcm_analytics_base.store_raw_data) {
         analytics_event_data = orcm_analytics_base_event_create(data, ORCM_RAS_EVENT_SENSOR, ORCM_RAS_SEVERITY_INFO);
         if (NULL != analytics_event_data) {
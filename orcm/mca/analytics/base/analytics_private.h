@@ -88,6 +88,17 @@ uint64_t orcm_analytics_base_timeval_to_uint64(struct timeval time);
 /* function to get the time in uint64_t for a list of coming data samples */
 int orcm_analytics_base_get_sample_time(opal_list_t *list, uint64_t *sample_time);
 
+/* recent-sample cache used to answer latest-value queries without the database */
+ORCM_DECLSPEC int orcm_analytics_base_recent_init(void);
+ORCM_DECLSPEC void orcm_analytics_base_recent_finalize(void);
+ORCM_DECLSPEC void orcm_analytics_base_recent_store(orcm_analytics_value_t *data);
+/* append one "host,sensor,time,value,units" string per matching sample to
+ * results. hosts may be NULL for all hosts, sensor is a glob on
+ * "<data_group>_<item>" (NULL for all) and seconds == 0 asks for the
+ * latest sample only */
+ORCM_DECLSPEC int orcm_analytics_base_recent_query(char **hosts, const char *sensor,
+                                                   int32_t seconds, opal_list_t *results);
+
 #define ANALYTICS_COUNT_DEFAULT 1
 #define MAX_ALLOWED_ATTRIBUTES_PER_WORKFLOW_STEP 2
 
@@ -96,6 +107,10 @@ typedef struct {
     opal_list_t workflows;
     bool store_raw_data;
     bool store_event_data;
+    /* seconds of samples kept in memory on aggregators */
+    int recent_window;
+    /* bound on samples kept per (host, sensor) */
+    int recent_max_samples;
 } orcm_analytics_base_t;
 ORCM_DECLSPEC extern orcm_analytics_base_t orcm_analytics_base;
 
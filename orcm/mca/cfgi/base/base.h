@@ -48,6 +48,27 @@ typedef struct {
 } orcm_cfgi_base_active_t;
 OBJ_CLASS_DECLARATION(orcm_cfgi_base_active_t);
 
+/* where a node sits in the configured topology, as recorded
+ * in the directory built from orcm_clusters */
+typedef struct {
+    opal_object_t super;
+    char *hostname;
+    orcm_node_t *node;
+    orcm_cluster_t *cluster;
+    orcm_row_t *row;        // NULL for a cluster controller
+    orcm_rack_t *rack;      // NULL for cluster and row controllers
+    int cluster_index;
+    int row_index;          // -1 if not within a row
+    int rack_index;         // -1 if not within a rack
+    /* nearest controller above this node, or the scheduler */
+    orte_process_name_t aggregator;
+    /* internal bookkeeping */
+    uint64_t daemon_key;
+    bool indexed_daemon;
+    uint32_t generation;
+} orcm_cfgi_base_dir_entry_t;
+ORCM_DECLSPEC OBJ_CLASS_DECLARATION(orcm_cfgi_base_dir_entry_t);
+
 /*
  * MCA framework
  */
@@ -73,6 +94,14 @@ ORCM_DECLSPEC int orcm_cfgi_base_identify_emulator_targets(opal_list_t *targets)
 ORCM_DECLSPEC int orcm_cfgi_base_get_proc_hostname(orte_process_name_t *proc, char **hostname);
 ORCM_DECLSPEC int orcm_cfgi_base_get_hostname_proc(char *hostname, orte_process_name_t *proc);
 
+/* topology directory - hashed lookups in place of walking the
+ * cluster lists. Update it whenever orcm_clusters changes; only
+ * entries for added, moved or removed nodes are touched */
+ORCM_DECLSPEC int orcm_cfgi_base_directory_update(void);
+ORCM_DECLSPEC void orcm_cfgi_base_directory_clear(void);
+ORCM_DECLSPEC orcm_cfgi_base_dir_entry_t* orcm_cfgi_base_directory_find_hostname(const char *hostname);
+ORCM_DECLSPEC orcm_cfgi_base_dir_entry_t* orcm_cfgi_base_directory_find_daemon(orte_process_name_t *proc);
+
 /* datatype support */
 ORCM_DECLSPEC int orcm_pack_node(opal_buffer_t *buffer, const void *src,
                                  int32_t num_vals, opal_data_type_t type);
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orcm_config.h"
+#include "orcm/types.h"
+#include "orcm/constants.h"
+
+#include <string.h>
+
+#include "opal_stdint.h"
+#include "opal/class/opal_hash_table.h"
+#include "opal/util/output.h"
+
+#include "orte/mca/errmgr/errmgr.h"
+#include "orte/util/name_fns.h"
+
+#include "orcm/runtime/orcm_globals.h"
+#include "orcm/mca/cfgi/base/base.h"
+
+/* Index of every named node in orcm_clusters, keyed by hostname and
+ * by daemon name. The entries point into the cluster lists - they do
+ * not own the nodes - so the directory must be updated whenever those
+ * lists change and cleared before they are released.
+ */
+typedef struct {
+    bool constructed;
+    bool built;
+    /* bumped on every update - entries not seen by the
+     * latest walk no longer exist and are swept */
+    uint32_t generation;
+    opal_hash_table_t by_name;
+    opal_hash_table_t by_daemon;
+} cfgi_directory_t;
+
+static cfgi_directory_t directory = {false, false, 0};
+
+static void dir_con(orcm_cfgi_base_dir_entry_t *p)
+{
+    p->hostname = NULL;
+    p->node = NULL;
+    p->cluster = NULL;
+    p->row = NULL;
+    p->rack = NULL;
+    p->cluster_index = -1;
+    p->row_index = -1;
+    p->rack_index = -1;
+    p->aggregator = *ORTE_NAME_INVALID;
+    p->daemon_key = 0;
+    p->indexed_daemon = false;
+    p->generation = 0;
+}
+static void dir_des(orcm_cfgi_base_dir_entry_t *p)
+{
+    if (NULL != p->hostname) {
+        free(p->hostname);
+    }
+}
+OBJ_CLASS_INSTANCE(orcm_cfgi_base_dir_entry_t,
+                   opal_object_t,
+                   dir_con, dir_des);
+
+static uint64_t daemon_key(orte_process_name_t *proc)
+{
+    return ((uint64_t)proc->jobid << 32) | (uint64_t)proc->vpid;
+}
+
+static bool is_defined(orcm_node_t *node)
+{
+    return (NULL != node->name && ORTE_VPID_INVALID != node->daemon.vpid);
+}
+
+static void setup(void)
+{
+    if (directory.constructed) {
+        return;
+    }
+    OBJ_CONSTRUCT(&directory.by_name, opal_hash_table_t);
+    opal_hash_table_init(&directory.by_name, 1024);
+    OBJ_CONSTRUCT(&directory.by_daemon, opal_hash_table_t);
+    opal_hash_table_init(&directory.by_daemon, 1024);
+    directory.constructed = true;
+}
+
+static void unindex_daemon(orcm_cfgi_base_dir_entry_t *entry)
+{
+    void *found;
+
+    if (!entry->indexed_daemon) {
+        return;
+    }
+    /* only drop the key if it still belongs to us */
+    if (OPAL_SUCCESS == opal_hash_table_get_value_uint64(&directory.by_daemon,
+                                                         entry->daemon_key, &found) &&
+        found == (void*)entry) {
+        opal_hash_table_remove_value_uint64(&directory.by_daemon, entry->daemon_key);
+    }
+    entry->indexed_daemon = false;
+}
+
+static void add_node(orcm_node_t *node, orcm_cluster_t *cluster,
+                     orcm_row_t *row, orcm_rack_t *rack,
+                     int cluster_index, int row_index, int rack_index,
+                     orte_process_name_t *aggregator)
+{
+    orcm_cfgi_base_dir_entry_t *entry = NULL;
+    size_t len;
+    void *found;
+
+    if (NULL == node->name) {
+        return;
+    }
+    len = strlen(node->name);
+    if (OPAL_SUCCESS == opal_hash_table_get_value_ptr(&directory.by_name, node->name,
+                                                      len, (void**)&entry)) {
+        if (entry->generation == directory.generation && entry->node != node) {
+            /* duplicate hostname - the first one in the
+             * configuration wins, as it always has */
+            return;
+        }
+    } else {
+        entry = OBJ_NEW(orcm_cfgi_base_dir_entry_t);
+        /* keep our own copy - the node may be gone by the time
+         * a later update sweeps this entry */
+        entry->hostname = strdup(node->name);
+        if (OPAL_SUCCESS != opal_hash_table_set_value_ptr(&directory.by_name, entry->hostname,
+                                                          len, entry)) {
+            ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
+            OBJ_RELEASE(entry);
+            return;
+        }
+    }
+
+    if (entry->node != node || !entry->indexed_daemon ||
+        entry->daemon_key != daemon_key(&node->daemon)) {
+        unindex_daemon(entry);
+    }
+    entry->node = node;
+    entry->cluster = cluster;
+    entry->row = row;
+    entry->rack = rack;
+    entry->cluster_index = cluster_index;
+    entry->row_index = row_index;
+    entry->rack_index = rack_index;
+    entry->aggregator = *aggregator;
+    entry->generation = directory.generation;
+
+    if (!entry->indexed_daemon && ORTE_VPID_INVALID != node->daemon.vpid) {
+        entry->daemon_key = daemon_key(&node->daemon);
+        if (OPAL_SUCCESS != opal_hash_table_get_value_uint64(&directory.by_daemon,
+                                                             entry->daemon_key, &found)) {
+            opal_hash_table_set_value_uint64(&directory.by_daemon, entry->daemon_key, entry);
+            entry->indexed_daemon = true;
+        }
+    }
+}
+
+/* drop every entry the latest walk did not visit */
+static void sweep(void)
+{
+    orcm_cfgi_base_dir_entry_t *entry, **stale;
+    void *key, *node;
+    size_t keylen, i, nstale;
+    int rc;
+
+    /* can't remove while iterating - collect them first */
+    stale = (orcm_cfgi_base_dir_entry_t**)malloc(opal_hash_table_get_size(&directory.by_name) *
+                                                 sizeof(orcm_cfgi_base_dir_entry_t*));
+    if (NULL == stale) {
+        return;
+    }
+    nstale = 0;
+    rc = opal_hash_table_get_first_key_ptr(&directory.by_name, &key, &keylen,
+                                           (void**)&entry, &node);
+    while (OPAL_SUCCESS == rc) {
+        if (entry->generation != directory.generation) {
+            stale[nstale++] = entry;
+        }
+        rc = opal_hash_table_get_next_key_ptr(&directory.by_name, &key, &keylen,
+                                              (void**)&entry, node, &node);
+    }
+    for (i = 0; i < nstale; i++) {
+        unindex_daemon(stale[i]);
+        opal_hash_table_remove_value_ptr(&directory.by_name, stale[i]->hostname,
+                                         strlen(stale[i]->hostname));
+        OBJ_RELEASE(stale[i]);
+    }
+    free(stale);
+}
+
+int orcm_cfgi_base_directory_update(void)
+{
+    orcm_cluster_t *cluster;
+    orcm_row_t *row;
+    orcm_rack_t *rack;
+    orcm_node_t *node;
+    orcm_scheduler_t *scheduler;
+    orte_process_name_t top, cluster_agg, row_agg, rack_agg;
+    int c, r, k;
+
+    setup();
+    if (NULL == orcm_clusters) {
+        return ORCM_SUCCESS;
+    }
+    directory.generation++;
+
+    /* nodes with no controller above them report to the scheduler */
+    top = *ORTE_NAME_INVALID;
+    if (NULL != orcm_schedulers && 0 < opal_list_get_size(orcm_schedulers)) {
+        scheduler = (orcm_scheduler_t*)opal_list_get_first(orcm_schedulers);
+        top = scheduler->controller.daemon;
+    }
+
+    c = 0;
+    OPAL_LIST_FOREACH(cluster, orcm_clusters, orcm_cluster_t) {
+        add_node(&cluster->controller, cluster, NULL, NULL, c, -1, -1, &top);
+        cluster_agg = is_defined(&cluster->controller) ? cluster->controller.daemon : top;
+        r = 0;
+        OPAL_LIST_FOREACH(row, &cluster->rows, orcm_row_t) {
+            add_node(&row->controller, cluster, row, NULL, c, r, -1, &cluster_agg);
+            row_agg = is_defined(&row->controller) ? row->controller.daemon : cluster_agg;
+            k = 0;
+            OPAL_LIST_FOREACH(rack, &row->racks, orcm_rack_t) {
+                add_node(&rack->controller, cluster, row, rack, c, r, k, &row_agg);
+                rack_agg = is_defined(&rack->controller) ? rack->controller.daemon : row_agg;
+                OPAL_LIST_FOREACH(node, &rack->nodes, orcm_node_t) {
+                    add_node(node, cluster, row, rack, c, r, k, &rack_agg);
+                }
+                k++;
+            }
+            r++;
+        }
+        c++;
+    }
+    sweep();
+    directory.built = true;
+
+    opal_output_verbose(5, orcm_cfgi_base_framework.framework_output,
+                        "%s cfgi:base directory holds %d nodes",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                        (int)opal_hash_table_get_size(&directory.by_name));
+    return ORCM_SUCCESS;
+}
+
+void orcm_cfgi_base_directory_clear(void)
+{
+    orcm_cfgi_base_dir_entry_t *entry;
+    void *key, *node;
+    size_t keylen;
+    int rc;
+
+    if (!directory.constructed) {
+        return;
+    }
+    rc = opal_hash_table_get_first_key_ptr(&directory.by_name, &key, &keylen,
+                                           (void**)&entry, &node);
+    while (OPAL_SUCCESS == rc) {
+        OBJ_RELEASE(entry);
+        rc = opal_hash_table_get_next_key_ptr(&directory.by_name, &key, &keylen,
+                                              (void**)&entry, node, &node);
+    }
+    OBJ_DESTRUCT(&directory.by_name);
+    OBJ_DESTRUCT(&directory.by_daemon);
+    directory.constructed = false;
+    directory.built = false;
+}
+
+orcm_cfgi_base_dir_entry_t* orcm_cfgi_base_directory_find_hostname(const char *hostname)
+{
+    orcm_cfgi_base_dir_entry_t *entry;
+
+    if (NULL == hostname) {
+        return NULL;
+    }
+    if (!directory.built) {
+        orcm_cfgi_base_directory_update();
+    }
+    if (OPAL_SUCCESS != opal_hash_table_get_value_ptr(&directory.by_name, hostname,
+                                                      strlen(hostname), (void**)&entry)) {
+        return NULL;
+    }
+    return entry;
+}
+
+orcm_cfgi_base_dir_entry_t* orcm_cfgi_base_directory_find_daemon(orte_process_name_t *proc)
+{
+    orcm_cfgi_base_dir_entry_t *entry;
+
+    if (NULL == proc || ORTE_VPID_INVALID == proc->vpid) {
+        return NULL;
+    }
+    if (!directory.built) {
+        orcm_cfgi_base_directory_update();
+    }
+    if (OPAL_SUCCESS != opal_hash_table_get_value_uint64(&directory.by_daemon,
+                                                         daemon_key(proc), (void**)&entry)) {
+        return NULL;
+    }
+    return entry;
+}
@@ -88,6 +88,7 @@ static int orcm_cfgi_base_close(void)
         }
     }
     OPAL_LIST_DESTRUCT(&orcm_cfgi_base.actives);
+    orcm_cfgi_base_directory_clear();
 
     return mca_base_framework_components_close(&orcm_cfgi_base_framework, NULL);
 }
@@ -84,93 +84,36 @@ int orcm_cfgi_base_define_sys(opal_list_t *config,
         ORTE_ERROR_LOG(ORCM_ERR_BAD_PARAM);
         return ORCM_ERR_BAD_PARAM;
     }
+
+    /* index the system we just defined */
+    if (ORCM_SUCCESS != (rc = orcm_cfgi_base_directory_update())) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
     return ORCM_SUCCESS;
 }
 
 /* given orte_process_name_t *proc, set hostname from config */
 int orcm_cfgi_base_get_proc_hostname(orte_process_name_t *proc, char **hostname)
 {
-    orcm_cluster_t *cluster;
-    orcm_row_t *row;
-    orcm_rack_t *rack;
-    orcm_node_t *node;
-
-    OPAL_LIST_FOREACH(cluster, orcm_clusters, orcm_cluster_t) {
-        node = &cluster->controller;
-        if (OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL, &node->daemon, proc)) {
-            *hostname = strdup(node->name);
-            return ORCM_SUCCESS;
-        }
+    orcm_cfgi_base_dir_entry_t *entry;
 
-        OPAL_LIST_FOREACH(row, &cluster->rows, orcm_row_t) {
-            node = &row->controller;
-            if (OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL, &node->daemon, proc)) {
-                *hostname = strdup(node->name);
-                return ORCM_SUCCESS;
-            }
-
-            OPAL_LIST_FOREACH(rack, &row->racks, orcm_rack_t) {
-                node = &rack->controller;
-                if (OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL, &node->daemon, proc)) {
-                    *hostname = strdup(node->name);
-                    return ORCM_SUCCESS;
-                }
-
-                OPAL_LIST_FOREACH(node, &rack->nodes, orcm_node_t) {
-                    if (OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL, &node->daemon, proc)) {
-                        *hostname = strdup(node->name);
-                        return ORCM_SUCCESS;
-                    }
-                }
-            }
-        }
+    if (NULL == (entry = orcm_cfgi_base_directory_find_daemon(proc))) {
+        return ORCM_ERR_NOT_FOUND;
     }
-
-    return ORCM_ERR_NOT_FOUND;
+    *hostname = strdup(entry->node->name);
+    return ORCM_SUCCESS;
 }
 
 /* given hostname, set orte_process_name_t proc from config */
 int orcm_cfgi_base_get_hostname_proc(char *hostname, orte_process_name_t *proc)
 {
-    orcm_cluster_t *cluster;
-    orcm_row_t *row;
-    orcm_rack_t *rack;
-    orcm_node_t *node;
-
-    OPAL_LIST_FOREACH(cluster, orcm_clusters, orcm_cluster_t) {
-        node = &cluster->controller;
-        if ((NULL != node->name) && (0 == strcmp(node->name, hostname))) {
-            proc->vpid = node->daemon.vpid;
-            proc->jobid = node->daemon.jobid;
-            return ORCM_SUCCESS;
-        }
+    orcm_cfgi_base_dir_entry_t *entry;
 
-        OPAL_LIST_FOREACH(row, &cluster->rows, orcm_row_t) {
-            node = &row->controller;
-            if ((NULL != node->name) && (0 == strcmp(node->name, hostname))) {
-                proc->vpid = node->daemon.vpid;
-                proc->jobid = node->daemon.jobid;
-                return ORCM_SUCCESS;
-            }
-
-            OPAL_LIST_FOREACH(rack, &row->racks, orcm_rack_t) {
-                node = &rack->controller;
-                if ((NULL != node->name) && (0 == strcmp(node->name, hostname))) {
-                    proc->vpid = node->daemon.vpid;
-                    proc->jobid = node->daemon.jobid;
-                    return ORCM_SUCCESS;
-                }
-
-                OPAL_LIST_FOREACH(node, &rack->nodes, orcm_node_t) {
-                    if ((NULL != node->name) && (0 == strcmp(node->name, hostname))) {
-                        proc->vpid = node->daemon.vpid;
-                        proc->jobid = node->daemon.jobid;
-                        return ORCM_SUCCESS;
-                    }
-                }
-            }
-        }
+    if (NULL == (entry = orcm_cfgi_base_directory_find_hostname(hostname))) {
+        return ORCM_ERR_NOT_FOUND;
     }
-
-    return ORCM_ERR_NOT_FOUND;
+    proc->vpid = entry->node->daemon.vpid;
+    proc->jobid = entry->node->daemon.jobid;
+    return ORCM_SUCCESS;
 }
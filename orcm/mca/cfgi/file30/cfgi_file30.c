@@ -37,6 +37,7 @@
 #endif
 
 #include "opal/runtime/opal.h"
+#include "opal/class/opal_hash_table.h"
 #include "opal/util/if.h"
 #include "opal/util/net.h"
 #include "opal/util/opal_environ.h"
@@ -189,6 +190,8 @@ static int xml_tree_create(xml_tree_t * io_tree);
 static int xml_tree_alloc_items(xml_tree_t * io_tree);
 static int xml_tree_alloc_hierarchy(xml_tree_t * io_tree);
 static int xml_tree_alloc_hier_row_lengths(xml_tree_t * io_tree);
+static unsigned long xml_tree_capacity(unsigned long in_sz_array,
+                                       unsigned long in_block_size);
 static int xml_tree_grow(unsigned long in_data_size,unsigned long in_block_size,
                          unsigned long in_sz_array, void * *io_array);
 
@@ -242,7 +245,7 @@ static int check_controller_on_node_junction( xml_tree_t * in_tree );
 /*This also check if node junction are the only leaf junctions. */
 static int check_hierarchy_integrity( xml_tree_t * in_tree );
 
-static int lex_xml(char * in_filename, xml_tree_t * io_xtree);
+static int lex_xml(const orcm_cfgi_file30_map_t * in_map, xml_tree_t * io_xtree);
 
 static int check_lex_tags_valid(xml_tree_t * in_xtree);
 static int check_lex_open_close_tags_matching(xml_tree_t * in_xtree);
@@ -296,6 +299,142 @@ static int check_duplicate_singletons(xml_tree_t * in_xtree);
 
 void replace_ampersand(char** io_name_to_modify, char * in_parent_name);
 
+/* the site file as init found it - read_config takes it from here
+ * so the file is only mapped and hashed once per load */
+static orcm_cfgi_file30_map_t site_image;
+static bool site_loaded = false;
+static uint64_t site_hash = 0;
+static bool site_hashed = false;
+
+static int site_image_load(void)
+{
+    int rc;
+
+    if (site_loaded) {
+        return ORCM_SUCCESS;
+    }
+    if (ORCM_SUCCESS == (rc = orcm_cfgi_file30_map(orcm_cfgi_base.config_file, &site_image))) {
+        site_loaded = true;
+        site_hashed = false;
+    }
+    return rc;
+}
+
+static uint64_t site_image_hash(void)
+{
+    if (!site_hashed) {
+        site_hash = orcm_cfgi_file30_hash(&site_image);
+        site_hashed = true;
+    }
+    return site_hash;
+}
+
+/* the compiled configuration init loaded and checked for that
+ * same file - read_config hands it on rather than load it twice */
+static opal_list_t *site_compiled = NULL;
+
+static void site_image_release(void)
+{
+    if (site_loaded) {
+        orcm_cfgi_file30_unmap(&site_image);
+        site_loaded = false;
+        site_hashed = false;
+    }
+    if (NULL != site_compiled) {
+        OPAL_LIST_RELEASE(site_compiled);
+        site_compiled = NULL;
+    }
+}
+
+static int is_known_tag(const char * in_tagtext);
+
+/* Check one item of a compiled configuration, and those below it,
+ * for the shape parse_config gives them: named after a known tag or
+ * junction type, a junction or controller carrying its name.
+ */
+static int check_compiled_item(const orcm_cfgi_xml_parser_t * in_xml)
+{
+    const orcm_cfgi_xml_parser_t * sub = NULL;
+    const char * t = in_xml->name;
+    bool named = false;
+
+    if (NULL == t || '\0' == t[0] || 0 == strcasecmp(t, TXconfig)) {
+        return ORCM_ERR_BAD_PARAM;
+    }
+    if (0 == strcasecmp(t, FDcluster) || 0 == strcasecmp(t, FDrow) ||
+        0 == strcasecmp(t, FDrack) || 0 == strcasecmp(t, FDnode) ||
+        0 == strcasecmp(t, TXcontrol)) {
+        named = true;
+    } else if (!is_known_tag(t)) {
+        return ORCM_ERR_BAD_PARAM;
+    }
+    if (named && (NULL == in_xml->value || NULL == in_xml->value[0])) {
+        return ORCM_ERR_BAD_PARAM;
+    }
+    OPAL_LIST_FOREACH(sub, &in_xml->subvals, orcm_cfgi_xml_parser_t) {
+        if (ORCM_SUCCESS != check_compiled_item(sub)) {
+            return ORCM_ERR_BAD_PARAM;
+        }
+    }
+    return ORCM_SUCCESS;
+}
+
+/* A compiled configuration holds the one RECORD configuration, with
+ * a single cluster on top of it.
+ */
+static int check_compiled_config(opal_list_t * in_config)
+{
+    const orcm_cfgi_xml_parser_t * config = NULL;
+    const orcm_cfgi_xml_parser_t * sub = NULL;
+    unsigned long clusters = 0;
+
+    if (1 != opal_list_get_size(in_config)) {
+        return ORCM_ERR_BAD_PARAM;
+    }
+    config = (orcm_cfgi_xml_parser_t*)opal_list_get_first(in_config);
+    if (NULL == config->name || 0 != strcasecmp(config->name, TXconfig) ||
+        NULL != config->value) {
+        return ORCM_ERR_BAD_PARAM;
+    }
+    OPAL_LIST_FOREACH(sub, &config->subvals, orcm_cfgi_xml_parser_t) {
+        if (ORCM_SUCCESS != check_compiled_item(sub)) {
+            return ORCM_ERR_BAD_PARAM;
+        }
+        if (0 == strcasecmp(sub->name, FDcluster)) {
+            ++clusters;
+        }
+    }
+    if (1 != clusters) {
+        return ORCM_ERR_BAD_PARAM;
+    }
+    return ORCM_SUCCESS;
+}
+
+/* Append the compiled image of the site file to io_config. It only
+ * stands in for the XML when it unpacks cleanly and still has the
+ * shape of a configuration - anything else counts as stale.
+ */
+static int compiled_load(opal_list_t * io_config)
+{
+    opal_list_t items;
+
+    int erri = ORCM_SUCCESS;
+    OBJ_CONSTRUCT(&items, opal_list_t);
+    erri = orcm_cfgi_file30_cache_load(site_image_hash(), site_image.size, &items);
+    if (ORCM_SUCCESS == erri) {
+        erri = check_compiled_config(&items);
+        if (ORCM_SUCCESS != erri) {
+            opal_output_verbose(V_LO, orcm_cfgi_base_framework.framework_output,
+                                "IGNORING A MALFORMED COMPILED CFGI IMAGE");
+        }
+    }
+    if (ORCM_SUCCESS == erri) {
+        opal_list_join(io_config, opal_list_get_end(io_config), &items);
+    }
+    OPAL_LIST_DESTRUCT(&items);
+    return erri;
+}
+
 static int file30_init(void)
 {
     xml_tree_t xml_syntax;
@@ -319,7 +458,31 @@ static int file30_init(void)
             break;
         }
 
-        erri = lex_xml(orcm_cfgi_base.config_file, &xml_syntax);
+        erri = site_image_load();
+        if (ORCM_SUCCESS != erri) {
+            break;
+        }
+
+        /* Only a version 3 file is ever compiled, so a fresh image
+         * that loads and checks out spares us lexing the whole file
+         * just to find the version. Keep it for read_config.
+         */
+        if (mca_cfgi_file30_component.use_cache && !orcm_cfgi_base.validate) {
+            if (NULL == site_compiled) {
+                site_compiled = OBJ_NEW(opal_list_t);
+                if (NULL != site_compiled &&
+                    ORCM_SUCCESS != compiled_load(site_compiled)) {
+                    OPAL_LIST_RELEASE(site_compiled);
+                    site_compiled = NULL;
+                }
+            }
+            if (NULL != site_compiled) {
+                version_found = 1;
+                break;
+            }
+        }
+
+        erri = lex_xml(&site_image, &xml_syntax);
 
         if (ORCM_SUCCESS != erri) {
             opal_output(orcm_cfgi_base_framework.framework_output,
@@ -374,6 +537,7 @@ static int file30_init(void)
     xml_tree_destroy(&xml_syntax);
 
     if (ORCM_SUCCESS != erri) {
+        site_image_release();
         return ORCM_ERR_TAKE_NEXT_OPTION;
     }
 
@@ -382,6 +546,7 @@ static int file30_init(void)
 
 static void file30_finalize(void)
 {
+    site_image_release();
 }
 
 static int parse_config(xml_tree_t * io_xtree, opal_list_t *io_config);
@@ -390,27 +555,43 @@ static bool check_me(orcm_config_t *config, char *node,
 
 static int read_config(opal_list_t *config)
 {
-    FILE * fp=NULL;
-
     orcm_cfgi_xml_parser_t *xml; //An iterator, owns nothing.
 
     xml_tree_t xml_syntax;
 
     int erri = ORCM_SUCCESS;
 
-    /*Check if the file exist*/     /*TODO: Use something more robust than fopen */
-    fp = fopen(orcm_cfgi_base.config_file, "r");
-    if (NULL == fp) {
+    /*Check if the file exist*/
+    erri = site_image_load();
+    if (ORCM_SUCCESS != erri) {
         orte_show_help("help-orcm-cfgi.txt", "site-file-not-found",
                        true, orcm_cfgi_base.config_file);
         return ORCM_ERR_SILENT;
     }
-    if (0 != fclose(fp)) {
-        opal_output(orcm_cfgi_base_framework.framework_output,
-                    "FAIL to PROPERLY CLOSE THE CFGI XML FILE");
-        return ORCM_ERR_SILENT;
-    } else {
-        fp = NULL;
+
+    /* An unchanged file was already lexed, validated and parsed by
+     * whoever compiled its image - take the result directly.
+     * A validation request always goes through the XML.
+     */
+    if (mca_cfgi_file30_component.use_cache && !orcm_cfgi_base.validate) {
+        if (NULL != site_compiled) {
+            opal_list_join(config, opal_list_get_end(config), site_compiled);
+            erri = ORCM_SUCCESS;
+        } else {
+            erri = compiled_load(config);
+        }
+        if (ORCM_SUCCESS == erri) {
+            opal_output_verbose(V_LO, orcm_cfgi_base_framework.framework_output,
+                                "LOADED THE COMPILED CFGI IMAGE");
+            site_image_release();
+            if (V_HIGHER < opal_output_get_verbosity(orcm_cfgi_base_framework.framework_output)) {
+                OPAL_LIST_FOREACH(xml, config, orcm_cfgi_xml_parser_t) {
+                    orcm_util_print_xml(xml, NULL);
+                }
+            }
+            return ORCM_SUCCESS;
+        }
+        erri = ORCM_SUCCESS;
     }
 
     while (ORCM_SUCCESS == erri) {
@@ -419,7 +600,7 @@ static int read_config(opal_list_t *config)
             break;
         }
 
-        erri = lex_xml(orcm_cfgi_base.config_file, &xml_syntax);
+        erri = lex_xml(&site_image, &xml_syntax);
         if (ORCM_SUCCESS != erri) {
             opal_output(orcm_cfgi_base_framework.framework_output,
                         "FAILED TO XML LEX THE FILE");
@@ -478,10 +659,16 @@ static int read_config(opal_list_t *config)
             }
         }
 
+        if (mca_cfgi_file30_component.use_cache) {
+            orcm_cfgi_file30_cache_store(site_image_hash(), site_image.size, config);
+        }
+
         break;
     }
 
     xml_tree_destroy(&xml_syntax);
+    /* a later read picks up any change to the file */
+    site_image_release();
 
     if (ORCM_SUCCESS != erri) {
         return ORCM_ERR_SILENT;
@@ -1995,91 +2182,78 @@ static int is_forbidden(char c){
     return 0;
 }
 
-    /* This function takes the XML text found in in_filename
-     * lex the file thereby creating an array of lexicographic items.
-     * These items are c-strings and are stored in
-     *      io_xtree->sz_items and
-     *      io_xtree.items
-     * Both of which are owned by io_xtree
+/* Record the end of the item started at *io_item_start: terminate it
+ * in io_text and push its offset, growing the offsets geometrically.
+ */
+static int lex_end_item(char * io_text, unsigned long * io_length,
+                        unsigned long * io_item_start,
+                        unsigned long ** io_starts, unsigned long * io_sz_starts,
+                        unsigned long * io_cap_starts)
+{
+    unsigned long * t = NULL;
+
+    if (*io_sz_starts == *io_cap_starts) {
+        *io_cap_starts = (0 == *io_cap_starts) ? xtBLOCK_SIZE : 2 * (*io_cap_starts);
+        t = (unsigned long *) realloc(*io_starts, *io_cap_starts * sizeof(unsigned long));
+        if (NULL == t) {
+            return ORCM_ERR_OUT_OF_RESOURCE;
+        }
+        *io_starts = t;
+    }
+    io_text[(*io_length)++] = '\0';
+    (*io_starts)[(*io_sz_starts)++] = *io_item_start;
+    *io_item_start = *io_length;
+    return ORCM_SUCCESS;
+}
+
+    /* This function takes the XML text image in in_map and, in a single
+     * pass over it, lex it thereby creating an array of lexicographic items.
+     * These items are c-strings and are returned, NULL-terminated, in
+     *      o_items, with their count in o_sz_items.
+     * Both the array and the strings are owned by the caller.
      * NOTE:
      *  =All data field are preprended by '\t'.
      *  =All closing marker are prepended with '/'.
      */
-static int lex_xml( char * in_filename, xml_tree_t * io_xtree)
+int orcm_cfgi_file30_lex(const orcm_cfgi_file30_map_t * in_map,
+                         char *** o_items, unsigned long * o_sz_items)
 {
-    FILE * fin =NULL;
-    unsigned long fsize; /*The number of bytes in the in_filename file*/
     const unsigned long min_file_size = 32; /*TODO: update this number*/
-    char * tx = NULL; /*Contains all the text before transfer. Owned. */
-
-    char * p=NULL, *q=NULL; /*Utility pointers */
-
     const int some_added_extra=32;
-    unsigned long i=0,j=0,k=0;
-    int ic=0;
+    const char * end = NULL; /*One past the last character of the image */
+    const char * s = NULL, *p = NULL, *q = NULL; /*Utility pointers */
+    char * tx = NULL; /*The lexed items, each '\0' terminated. Owned. */
+    unsigned long k = 0; /*Length of the text in tx */
+    unsigned long item_start = 0;
+    unsigned long * starts = NULL; /*Offset in tx of each item. Owned. */
+    unsigned long sz_starts = 0, cap_starts = 0;
+    unsigned long j = 0;
     char c=0;
-    unsigned long line_count=0;
-    unsigned long text_length=0;
 
     int came_from_data=-1; /* -1 -> Undecided
                             *  0 -> False
                             *  1 -> True
                             */
-    io_xtree->sz_items = 0;
-    io_xtree->items = NULL;
+    char ** items = NULL;
+    *o_items = NULL;
+    *o_sz_items = 0;
 
     int erri = ORCM_SUCCESS;
     while (ORCM_SUCCESS == erri){
-        /*----- Get the image of the file */
-        fin = fopen(in_filename, "r");
-        if (NULL == fin) {
-            erri = ORCM_ERR_NOT_FOUND;
-            break;
-        }
-
-        fseek(fin, 0L, SEEK_END);
-        fsize = ftell(fin);
-        fseek(fin, 0L, SEEK_SET);
-
-        if (fsize < min_file_size) {
+        if (NULL == in_map->data || in_map->size < min_file_size) {
             erri = ORCM_ERROR;
             break;
         }
+        end = in_map->data + in_map->size;
 
-        tx = (char*) calloc(fsize + some_added_extra, sizeof(char));
+        /* A short unquoted field grows by its '\t' and terminator, so
+         * twice the text is a safe bound on the room the items need */
+        tx = (char*) malloc(2 * in_map->size + some_added_extra);
         if (NULL == tx) {
             erri = ORCM_ERR_OUT_OF_RESOURCE;
             break;
         }
 
-        for (i=0; i < fsize; ++i) {
-            ic = fgetc(fin);
-            if (EOF == ic) {
-                /*It used to be--> erri=__LINE__; */
-                /*@1:Going From Window OS to Linux and back does funny things with
-                 *fsize and where one will encounter the EOF.  The EOF may
-                 *show up earlier.
-                 *IF EOF is found early, fsize will be corrected->See @1 marker.
-                 *TODO: FInd out why the EOF is not where fsize says it is.
-                 */
-                opal_output_verbose(V_LO, orcm_cfgi_base_framework.framework_output,
-                                    "WARNING: unexpected end-of-file encountered\n");
-                break;
-            }
-            if (ic > 255) {
-                erri = ORCM_ERROR;
-                break;
-            }
-            c=ic;
-            tx[i] = c;
-        }
-        if (ORCM_SUCCESS != erri) {
-            break;
-        }
-
-        fsize = i;        /* @1:Correcting fsize if needed. See comment above.*/
-        tx[fsize] = '\0';
-
         /*-----Chop things up
          *
          * 2 types of XML tags:
@@ -2089,70 +2263,54 @@ static int lex_xml( char * in_filename, xml_tree_t * io_xtree)
          * All whitespaces are to be thrwon away, except
          * those within the double-quoted in ctFIELD.
          *
-         *=The text will use '\n' as token delimiter.  In the final
-         * text, the delimiter will be '\0'.
+         *=Each item is '\0' terminated as soon as its end is seen.
          *=All data field will be preprended by '\t'.
-         *=After the final delimiter a '\0' is appended but not counted
-         * in the text length.
+         *=An unquoted data field still open at the end of the text
+         * is dropped.
          *=All closing marker will be prepended with '/'.
          */
-
-        line_count = 1;
-        k = (unsigned long)(-1);
-        for (i = 0; i < fsize; ++i) {
-            c = tx[i];
+        for (s = in_map->data; s < end; ++s) {
+            c = *s;
             if (is_whitespace(c)) {
-                if ('\n' == c ) {
-                    ++line_count;
-                }
                 continue;
             }
             if ('<' == c) {
                 if (1 == came_from_data) {
-                    tx[++k ]= '\n';
+                    erri = lex_end_item(tx, &k, &item_start,
+                                        &starts, &sz_starts, &cap_starts);
+                    if (ORCM_SUCCESS != erri) {
+                        break;
+                    }
                     came_from_data = 0;
                 }
-                p = strchr(tx+i, '>');
+                p = memchr(s, '>', end - s);
                 if (NULL == p) {
                     erri = ORCM_ERR_BAD_PARAM;
                     break;
                 }
-                if ('!' == tx[i+1] || '?' == tx[i+1]) {
+                if (s+1 < end && ('!' == s[1] || '?' == s[1])) {
                     /*In a directive */
                     /* A directive will end with one of the following:
                             ?>
                         or  -->
                      */
-                    if ('?' == *(p-1) || ('-' == *(p-1) && '-' == *(p-2))) {
-                        i += (p-(tx+i)); /*Ratchet up to the ending '>' */
-                        if (i >= fsize) {
-                            erri = ORCM_ERR_BAD_PARAM;
-                            break;
-                        }
-                    } else {
-                        /*Keep looking*/
-                        while (!('?' == *(p-1) || ('-' == *(p-1) && '-' == *(p-2)))) {
-                            ++p;
-                            p = strchr(p, '>');
-                            if (NULL == p) {
-                                /*Missing closing '>' */
-                                erri = ORCM_ERR_BAD_PARAM;
-                                break;
-                            }
-                        }
-                        if (ORCM_SUCCESS != erri) {
-                            break;
-                        }
-                        i += (p-(tx+i)); /*Ratchet up to the ending '>' */
-                        if (i >= fsize) {
+                    while (!('?' == *(p-1) || ('-' == *(p-1) && '-' == *(p-2)))) {
+                        ++p;
+                        p = memchr(p, '>', end - p);
+                        if (NULL == p) {
+                            /*Missing closing '>' */
                             erri = ORCM_ERR_BAD_PARAM;
                             break;
                         }
                     }
+                    if (ORCM_SUCCESS != erri) {
+                        break;
+                    }
+                    s = p; /*Ratchet up to the ending '>' */
                     continue;
                 } else {
                     /*In a marker*/
-                    for (q=tx+i; q< p; ++q) {
+                    for (q=s; q < p; ++q) {
                         if (is_forbidden(*q)) {
                             erri = ORCM_ERR_BAD_PARAM;
                             break;
@@ -2162,23 +2320,24 @@ static int lex_xml( char * in_filename, xml_tree_t * io_xtree)
                         break;
                     }
 
-                    for(q=tx+i+1; q < p; ++q) {
-                        ++k;
-                        tx[k] = *q;
+                    memcpy(tx+k, s+1, p-s-1);
+                    k += p-s-1;
+                    erri = lex_end_item(tx, &k, &item_start,
+                                        &starts, &sz_starts, &cap_starts);
+                    if (ORCM_SUCCESS != erri) {
+                        break;
                     }
-                    ++k;
-                    tx[k] = '\n';
-                    i += (p-(tx+i)); /*Ratchet up to the ending '>' */
+                    s = p; /*Ratchet up to the ending '>' */
                     continue;
                 }
             } else if ('"' == c) {
                 /*in a string*/
-                p = strchr(tx+i+1, '"');
+                p = memchr(s+1, '"', end - (s+1));
                 if (NULL == p) {
                     erri = ORCM_ERR_BAD_PARAM;
                     break;
                 }
-                for (q=tx+i; q < p; ++q) {
+                for (q=s; q < p; ++q) {
                     if (is_forbidden(*q)) {
                         erri = ORCM_ERR_BAD_PARAM;
                         break;
@@ -2188,74 +2347,63 @@ static int lex_xml( char * in_filename, xml_tree_t * io_xtree)
                     break;
                 }
 
-                tx[++k] = '\t'; /*Prepending*/
+                tx[k++] = '\t'; /*Prepending*/
 
-                for (q=tx+i+1; q < p; ++q) {
+                for (q=s+1; q < p; ++q) {
                     if ('\t' == *q) {
-                        tx[++k] = ' ';
+                        tx[k++] = ' ';
                     } else {
-                        tx[++k] = *q;
+                        tx[k++] = *q;
                     }
                 }
-                ++k;
-                tx[k] = '\n';
-                i += (p-(tx+i)); /*Ratchet up to the ending '"' */
+                erri = lex_end_item(tx, &k, &item_start,
+                                    &starts, &sz_starts, &cap_starts);
+                if (ORCM_SUCCESS != erri) {
+                    break;
+                }
+                s = p; /*Ratchet up to the ending '"' */
                 continue;
             } else {
                 /*This should only be un-quoted field item */
                 /*Yep, putting whitespace in a field item will mangled the text*/
                 if (1 != came_from_data) {
-                    tx[++k] = '\t';
+                    tx[k++] = '\t';
                 }
-                ++k;
-                tx[k] = c;
+                tx[k++] = c;
                 came_from_data = 1;
             }
 
-        } /*for(i=0; i<fsize; ++i) */
+        } /*for(s=in_map->data; s<end; ++s) */
         if (ORCM_SUCCESS != erri) {
             break;
         }
 
-        ++k;
-        tx[k] = '\0';
-        text_length = k;
-        k = 0;
-
-        /*Count the number of items found */
-        k=0;
-        for (i=0; i < text_length; ++i) {
-            if ('\n' == tx[i]) {
-                ++k;
-            }
-        }
-        if (0 == k) {
+        if (0 == sz_starts) {
             erri = ORCM_ERR_BAD_PARAM;
             break;
         }
-        io_xtree->sz_items = k;
 
         /*Set up the item array */
-        erri = xml_tree_alloc_items(io_xtree);
-        if (ORCM_SUCCESS != erri){
+        items = (char **) calloc(sz_starts + 1, sizeof(char*));
+        if (NULL == items) {
+            erri = ORCM_ERR_OUT_OF_RESOURCE;
             break;
         }
 
-        j=0;
-        k=0;
-        for (i=0; i<text_length; ++i) {
-            if ('\n' == tx[i]) {
-                tx[i ]= '\0';
-                io_xtree->items[j] = strdup( &tx[k] );
-                ++j;
-                k=i+1;
+        for (j=0; j < sz_starts; ++j) {
+            items[j] = strdup( &tx[starts[j]] );
+            if (NULL == items[j]) {
+                erri = ORCM_ERR_OUT_OF_RESOURCE;
+                break;
             }
         }
-        if (j != io_xtree->sz_items) {
-            erri = ORCM_ERR_BAD_PARAM;
+        if (ORCM_SUCCESS != erri) {
+            opal_argv_free(items);
             break;
         }
 
+        *o_items = items;
+        *o_sz_items = sz_starts;
         break;
     }
 
@@ -2263,14 +2411,43 @@ static int lex_xml( char * in_filename, xml_tree_t * io_xtree)
         free (tx);
         tx = NULL;
     }
-
-    if (NULL != fin){
-        fclose(fin);
-        fin=NULL;
+    if (NULL != starts) {
+        free (starts);
+        starts = NULL;
     }
     return erri;
 }
 
+/* Lex the site image into io_xtree->items, which the later passes
+ * expect to be laid out by xml_tree_alloc_items.
+ */
+static int lex_xml(const orcm_cfgi_file30_map_t * in_map, xml_tree_t * io_xtree)
+{
+    char ** items = NULL;
+    unsigned long sz_items = 0;
+
+    io_xtree->sz_items = 0;
+    io_xtree->items = NULL;
+
+    int erri = orcm_cfgi_file30_lex(in_map, &items, &sz_items);
+    if (ORCM_SUCCESS != erri) {
+        return erri;
+    }
+
+    io_xtree->sz_items = sz_items;
+    erri = xml_tree_alloc_items(io_xtree);
+    if (ORCM_SUCCESS != erri) {
+        io_xtree->sz_items = 0;
+        opal_argv_free(items);
+        return erri;
+    }
+    /* the strings move over, only the array is ours to free */
+    memcpy(io_xtree->items, items, sz_items * sizeof(char*));
+    free(items);
+
+    return ORCM_SUCCESS;
+}
+
 static bool is_regex(const char * in_cstring)
 {
     /*This is a very simple test.  Simple means that it does not check if
@@ -2961,6 +3138,8 @@ static int structure_lexed_items(unsigned long in_begin_offset,
     unsigned long * section_ends=NULL;
     unsigned long * section_parents=NULL;
     unsigned long * section_counts=NULL;
+    unsigned long * open_sections=NULL; /*Stack of the sections not yet closed*/
+    unsigned long sz_open=0;
 
     char * t=NULL;
     io_xtree->sz_hierarchy = 0;
@@ -3052,6 +3231,12 @@ static int structure_lexed_items(unsigned long in_begin_offset,
             break;
         }
 
+        open_sections = (unsigned long *) calloc(io_xtree->sz_hierarchy, sizeof(unsigned long));
+        if (NULL == open_sections) {
+            erri = ORCM_ERR_OUT_OF_RESOURCE;
+            break;
+        }
+
         /*Find the beginning and the end of each section, and their parent section */
 
         /*NOTE: Section_parents does not store indices in io_xtree->items.
@@ -3066,14 +3251,16 @@ static int structure_lexed_items(unsigned long in_begin_offset,
          *      the base section has no parents.
          */
 
-        /*TODO: Optimize the search for the first empty ending.
-         *      As it is, we are looking at a worst case O(N^2) parsing.
-         *      Using sections_ends as a stack would speed things up.
+        /*NOTE: The sections still open form a stack, its top being the
+         *      innermost one.  Non-sectional items belong to that top,
+         *      an ending tag closes it, and a new section is its child.
+         *      That keeps both passes below linear in the item count.
          */
 
         /*NOTE: This algorithm is done twice. Once now and once afterward.*/
         section_parents[0]=nota_index;
 
+        sz_open=0;
         sz_section=-1;
         for (i=in_begin_offset; i < in_end_offset; ++i) {
             t = io_xtree->items[i];
@@ -3086,61 +3273,40 @@ static int structure_lexed_items(unsigned long in_begin_offset,
                 }
             } else if (!is_sectional_item(t)) {
                 /*Not a sectional tag, not an ending tag and not a data field*/
-                if ((unsigned long)(-1) == sz_section) {
+                if (0 == sz_open) {
                     /*I did not expect that here. */
                     erri = ORCM_ERR_BAD_PARAM;
                     break;
                 }
-                long x;
-                for (x=sz_section; x >= 0; --x) {
-                    if (0 == section_ends[x]) {
-                        /*Found the first empty ending*/
-                        break;
-                    }
-                }
-                if (0==x && 0 != section_ends[0]) {
-                    /* No empty ending found ???*/
-                    erri = ORCM_ERR_BAD_PARAM;
-                    break;
-                }
-                ++section_counts[x];
+                ++section_counts[open_sections[sz_open-1]];
                 continue;
             }
 
             if ('/' == t[0]) { /*An ending tag of a section */
-                long x;
-                for (x=sz_section; x >= 0; --x) {
-                    if (0 == section_ends[x]) {
-                        /*Found the first empty ending*/
-                        break;
-                    }
-                }
-                if (0 == x && 0 != section_ends[0]) {
-                    /* No empty ending found ???*/
+                if (0 == sz_open) {
+                    /* No open section to close ???*/
                     erri = ORCM_ERR_BAD_PARAM;
                     break;
                 }
-                section_ends[x]=i;
+                --sz_open;
+                section_ends[open_sections[sz_open]]=i;
             } else { /*A beginning tag of a section */
                 ++sz_section;
+                if (sz_section >= io_xtree->sz_hierarchy) {
+                    erri = ORCM_ERR_BAD_PARAM;
+                    break;
+                }
                 section_starts[sz_section]=i;
                 section_ends[sz_section]=0;
                 if (0 != sz_section) {
-                    /*Find first empty ending */
-                    long x;
-                    for (x=sz_section-1;  x>= 0; --x) {
-                        if (0 == section_ends[x]) {
-                            /*Found the first available parent*/
-                            section_parents[sz_section] = x;
-                            break;
-                        }
-                    }
-                    if (0 == x && 0 != section_ends[0]) {
+                    if (0 == sz_open) {
                         /* No parent were found ???*/
                         erri = ORCM_ERR_BAD_PARAM;
                         break;
                     }
+                    section_parents[sz_section] = open_sections[sz_open-1];
                 }
+                open_sections[sz_open++] = sz_section;
             }
         }
         if (ORCM_SUCCESS != erri) {
@@ -3203,6 +3369,7 @@ static int structure_lexed_items(unsigned long in_begin_offset,
         /*No need to recalculate the section_parents.  Keep them for later*/
         /*section_counts & sections_ends are re-built*/
 
+        sz_open=0;
         sz_section=-1;
         for (i=in_begin_offset; i < in_end_offset; ++i) {
             t = io_xtree->items[i];
@@ -3215,45 +3382,19 @@ static int structure_lexed_items(unsigned long in_begin_offset,
                 }
             }else if (!is_sectional_item(t)) {
                 /*Not a sectional tag, not an ending tag and not a data field*/
-                if ((unsigned long)(-1) == sz_section) {
-                    /*I did not expect that here. */
-                    erri = ORCM_ERR_BAD_PARAM;
-                    break;
-                }
-                long x;
-                for (x=sz_section; x >= 0; --x) {
-                    if (0 == section_ends[x]) {
-                        /*Found the first empty ending*/
-                        break;
-                    }
-                }
-                if (0 == x && 0 != section_ends[0]) {
-                    /* No empty ending found ???*/
-                    erri = ORCM_ERR_BAD_PARAM;
-                    break;
-                }
+                unsigned long x = open_sections[sz_open-1];
                 io_xtree->hierarchy[x][section_counts[x]] = i;
                 ++section_counts[x];
                 continue;
             }
 
             if ('/' == t[0]) { /*An ending tag of a section */
-                long x;
-                for (x=sz_section; x >= 0; --x) {
-                    if (0 == section_ends[x]) {
-                        /*Found the first empty ending*/
-                        break;
-                    }
-                }
-                if (0 == x && 0!=section_ends[0]) {
-                    /* No empty ending found ???*/
-                    erri = ORCM_ERR_BAD_PARAM;
-                    break;
-                }
-                section_ends[x]=i;
+                --sz_open;
+                section_ends[open_sections[sz_open]]=i;
             } else { /*A beginning tag of a section */
                 ++sz_section;
                 section_ends[sz_section]=0;
+                open_sections[sz_open++] = sz_section;
             }
         }
         if (ORCM_SUCCESS != erri) {
@@ -3294,6 +3435,11 @@ static int structure_lexed_items(unsigned long in_begin_offset,
         section_counts=NULL;
         sz_section=0;
     }
+    if (NULL != open_sections) {
+        free(open_sections);
+        open_sections=NULL;
+        sz_open=0;
+    }
 
     return erri;
 }
@@ -3788,68 +3934,69 @@ static int remove_empty_items(xml_tree_t * io_xtree)
     return erri;
 }
 
+/* Only a few distinct tags are singletons, so the ones met in a row
+ * are kept in a short list: one pass per row instead of comparing
+ * each singleton with all the entries after it.
+ */
+#define SINGLETON_MAX 32
 static int check_duplicate_singletons(xml_tree_t * in_xtree)
 {
     unsigned long i=0, j=0, k=0;
-    long u=0, v=0;
-    char * t=NULL, *tt=NULL, *context=NULL;
+    long u=0;
+    char * t=NULL, *context=NULL;
+
+    const char * fields_seen[SINGLETON_MAX]; /*Singleton fields met in the row*/
+    const char * children_seen[SINGLETON_MAX]; /*Singleton sections met in the row*/
+    const char ** seen = NULL;
+    unsigned long sz_fields=0, sz_children=0;
+    unsigned long * sz_seen = NULL;
+    bool in_children = false;
 
     int erri = ORCM_SUCCESS;
     while (ORCM_SUCCESS == erri) {
         for (i=0; i < in_xtree->sz_hierarchy; ++i) {
             context = in_xtree->items[ in_xtree->hierarchy[i][0] ];
+            sz_fields = 0;
+            sz_children = 0;
+            in_children = false;
             for (j=0; j < in_xtree->hier_row_lengths[i]; ++j) {
                 u = in_xtree->hierarchy[i][j];
                 if (is_child(u)) {
                     /*=====  Sectional items */
-                    t = in_xtree->items[in_xtree->hierarchy[-u][0]];
-                    if (!is_singleton(t)) {
-                        continue;
-                    }
-                    for (k=j+1; k < in_xtree->hier_row_lengths[i]; ++k) {
-                        v = in_xtree->hierarchy[i][k];
-                        if (is_field(v)) {
-                            erri = ORCM_ERR_BAD_PARAM;
-                            opal_output(orcm_cfgi_base_framework.framework_output,
-                                        "ERROR: XML parser inconsistency found: %d", __LINE__);
-                            break;
-                        }
-                        tt = in_xtree->items[ in_xtree->hierarchy[child_to_offset(v)][0] ];
-                        if (0 == strcasecmp(t,tt)) {
-                            opal_output(orcm_cfgi_base_framework.framework_output,
-                                        "ERROR: More than one instance of the command \"%s\" was found in \"%s\"",tt,context);
-                            erri = ORCM_ERR_BAD_PARAM;
-                            break;
-                        }
-                    }
-                    if (ORCM_SUCCESS != erri) {
-                        break;
-                    }
-
+                    in_children = true;
+                    t = in_xtree->items[in_xtree->hierarchy[child_to_offset(u)][0]];
+                    seen = children_seen;
+                    sz_seen = &sz_children;
                 } else {
                     /*===== non-Sectional items */
-                    t = in_xtree->items[u];
-                    if (!is_singleton(t)) {
-                        continue;
-                    }
-                    for (k=j+1; k < in_xtree->hier_row_lengths[i]; ++k) {
-                        v = in_xtree->hierarchy[i][k];
-                        if (is_child(v)) {
-                            /*No need to check sectional items */
-                            break;
-                        }
-                        tt = in_xtree->items[v];
-                        if (0 == strcasecmp(t,tt)) {
-                            opal_output(orcm_cfgi_base_framework.framework_output,
-                                        "ERROR: More than one instance of the command \"%s\" was found in \"%s\"",tt,context);
-                            erri = ORCM_ERR_BAD_PARAM;
-                            break;
-                        }
+                    if (in_children) {
+                        /*A row lists its fields before its children*/
+                        erri = ORCM_ERR_BAD_PARAM;
+                        opal_output(orcm_cfgi_base_framework.framework_output,
+                                    "ERROR: XML parser inconsistency found: %d", __LINE__);
+                        break;
                     }
-                    if (ORCM_SUCCESS != erri) {
+                    t = in_xtree->items[u];
+                    seen = fields_seen;
+                    sz_seen = &sz_fields;
+                }
+                if (!is_singleton(t)) {
+                    continue;
+                }
+                for (k=0; k < *sz_seen; ++k) {
+                    if (0 == strcasecmp(t, seen[k])) {
                         break;
                     }
                 }
+                if (k < *sz_seen) {
+                    opal_output(orcm_cfgi_base_framework.framework_output,
+                                "ERROR: More than one instance of the command \"%s\" was found in \"%s\"",t,context);
+                    erri = ORCM_ERR_BAD_PARAM;
+                    break;
+                }
+                if (SINGLETON_MAX > *sz_seen) {
+                    seen[(*sz_seen)++] = t;
+                }
             }
             if (ORCM_SUCCESS != erri) {
                 break;
@@ -4008,11 +4155,17 @@ static int check_junctions_have_names(xml_tree_t * in_tree)
 
 static int check_parent_has_uniquely_named_children( xml_tree_t * in_tree )
 {
-    unsigned long i = 0, j = 0, k = 0;
-    long u = 0, v = 0, context = 0;
+    unsigned long i = 0, j = 0;
+    long u = 0, context = 0;
     char *t = NULL, *tt = NULL;
 
+    opal_hash_table_t seen; /*"parent/child" names met so far*/
+    char * key = NULL;
+    void * found = NULL;
+
     int erri = ORCM_SUCCESS;
+    OBJ_CONSTRUCT(&seen, opal_hash_table_t);
+    opal_hash_table_init(&seen, in_tree->sz_hierarchy);
     while (ORCM_SUCCESS == erri) {
         /*First find a parent junction*/
         for (i=0; i < in_tree->sz_hierarchy; ++i) {
@@ -4038,36 +4191,25 @@ static int check_parent_has_uniquely_named_children( xml_tree_t * in_tree )
                     continue;
                 }
 
-                const char * cA_name = get_field( TXname, child_to_offset(u), in_tree);
-                if ( NULL == cA_name) {
+                const char * c_name = get_field( TXname, child_to_offset(u), in_tree);
+                if ( NULL == c_name) {
                     /*Child without a name --> That should have been checked*/
                     erri = ORCM_ERR_BAD_PARAM;
                     break;
                 }
-                for (k=j+1; k<in_tree->hier_row_lengths[i]; ++k){
-                    /*Look at the other children, if any */
-                    v = in_tree->hierarchy[i][k];
-                    if (is_field(v)) {
-                        continue;
-                    }
-
-                    tt = in_tree->items[ in_tree->hierarchy[child_to_offset(v)][0] ];
-                    if ( 0 != strcasecmp(tt,TXjunction)) {
-                        continue;
-                    }
-                    const char * cB_name = get_field( TXname, child_to_offset(v), in_tree);
-                    if ( NULL == cB_name) {
-                        /*Child without a name --> That should have been checked*/
-                        erri = ORCM_ERR_BAD_PARAM;
-                        break;
-                    }
-                    if ( 0 == strcmp(cA_name, cB_name) ) {
-                        opal_output(orcm_cfgi_base_framework.framework_output,
-                                    "ERROR: Junction %lu has two children with the same name: %s", i, cB_name);
-                        erri = ORCM_ERR_BAD_PARAM;
-                        break;
-                    }
+                if (0 > asprintf(&key, "%lu/%s", i, c_name)) {
+                    erri = ORCM_ERR_OUT_OF_RESOURCE;
+                    break;
+                }
+                if (OPAL_SUCCESS == opal_hash_table_get_value_ptr(&seen, key, strlen(key), &found)) {
+                    opal_output(orcm_cfgi_base_framework.framework_output,
+                                "ERROR: Junction %lu has two children with the same name: %s", i, c_name);
+                    erri = ORCM_ERR_BAD_PARAM;
+                } else {
+                    opal_hash_table_set_value_ptr(&seen, key, strlen(key), (void*)c_name);
                 }
+                free(key);
+                key = NULL;
                 if (ORCM_SUCCESS != erri) {
                     break;
                 }
@@ -4087,6 +4229,7 @@ static int check_parent_has_uniquely_named_children( xml_tree_t * in_tree )
 
         break;
     }/*while(!erri)*/
+    OBJ_DESTRUCT(&seen);
     return erri;
 }
 
@@ -4212,15 +4355,16 @@ static int check_unique_scheduler( xml_tree_t * in_tree )
 
 static int check_unique_host_port_pair( xml_tree_t * in_tree )
 {
-    unsigned long i = 0, j = 0;
-    const char *t = NULL, *t2 = NULL;
-    unsigned long p1=0, p2=0;
+    unsigned long i = 0;
+    const char *t = NULL;
     long u = 0;
     const char ** allhosts = NULL; /*array pointing to all <host> and <shost> fields*/
                                    /*Its length is in_tree->sz_hierarchy */
     unsigned long * allports = NULL; /*array of port values*/
 
-    char * ampersand_found_in_t  = NULL;
+    opal_hash_table_t seen; /*"port:host" keys of the pairs met so far*/
+    char * key = NULL;
+    void * found = NULL;
 
     unsigned long port_value = 0;
     char * endptr = NULL;
@@ -4247,8 +4391,8 @@ static int check_unique_host_port_pair( xml_tree_t * in_tree )
          * 2) The fielded values for ports have been properly ranged.
          */
 
-        /* Not using a hash function yet, as I'm not too sure yet how to handle
-         * the ampersand @ hierarchical operator.
+        /* A pair holding the ampersand @ hierarchical operator may expand
+         * to different hosts, so a repeat of it is only a warning.
          */
 
         /* First get all <host> <port> pairs */
@@ -4287,46 +4431,41 @@ static int check_unique_host_port_pair( xml_tree_t * in_tree )
 
             allhosts[i] = host;
         }
+        if (ORCM_SUCCESS != erri) {
+            break;
+        }
 
         /*Make sure no duplicates are found */
+        OBJ_CONSTRUCT(&seen, opal_hash_table_t);
+        opal_hash_table_init(&seen, in_tree->sz_hierarchy);
         for (i=0; i < in_tree->sz_hierarchy; ++i) {
-            t  = allhosts[i];
-            p1 = allports[i];
+            t = allhosts[i];
             if (NULL == t) {
                 continue;
             }
+            if (0 > asprintf(&key, "%lu:%s", allports[i], t)) {
+                erri = ORCM_ERR_OUT_OF_RESOURCE;
+                break;
+            }
 
-            ampersand_found_in_t = NULL;
-            ampersand_found_in_t = strchr(t, '@');
-
-            for (j=i+1; j < in_tree->sz_hierarchy; ++j) {
-                t2 = allhosts[j];
-                p2 = allports[j];
-                if (NULL == t2) {
-                    continue;
-                }
-
-                if (p1 == p2) {
-                    if ( 0 == strcmp(t,t2) ) {
-                        if (NULL == ampersand_found_in_t) {
-                            opal_output(orcm_cfgi_base_framework.framework_output,
-                                 "ERROR: Duplicate (s)host-port pair found: "
-                                 "port=%lu\t(s)host=%s", p1, t);
-                            erri = ORCM_ERR_BAD_PARAM;
-                            /*Do not bail out as we want to get all possible errors. */
-                        } else {
-                            /* Possible duplicate because the @ character could
-                             * expand to different strings. So assign no error.
-                             */
-                            opal_output_verbose( V_LO, orcm_cfgi_base_framework.framework_output,
-                                 "WARNING: Possible duplicate (s)host-port pair found: port=%lu\t(s)host=%s",
-                                 p1, t
-                                 );
-                        }
-                    }
-                }
+            if (OPAL_SUCCESS != opal_hash_table_get_value_ptr(&seen, key, strlen(key), &found)) {
+                opal_hash_table_set_value_ptr(&seen, key, strlen(key), (void*)t);
+            } else if (NULL == strchr(t, '@')) {
+                opal_output(orcm_cfgi_base_framework.framework_output,
+                     "ERROR: Duplicate (s)host-port pair found: "
+                     "port=%lu\t(s)host=%s", allports[i], t);
+                erri = ORCM_ERR_BAD_PARAM;
+                /*Do not bail out as we want to get all possible errors. */
+            } else {
+                opal_output_verbose( V_LO, orcm_cfgi_base_framework.framework_output,
+                     "WARNING: Possible duplicate (s)host-port pair found: port=%lu\t(s)host=%s",
+                     allports[i], t
+                     );
             }
+            free(key);
+            key = NULL;
         }
+        OBJ_DESTRUCT(&seen);
         if (ORCM_SUCCESS != erri) {
             break;
         }
@@ -5286,8 +5425,7 @@ static int xml_tree_alloc_items(xml_tree_t * io_tree)
         return ORCM_ERROR;
     }
 
-    unsigned long sz = (io_tree->sz_items + xtBLOCK_SIZE-1) / xtBLOCK_SIZE;
-    sz *= xtBLOCK_SIZE;
+    unsigned long sz = xml_tree_capacity(io_tree->sz_items, xtBLOCK_SIZE);
 
     io_tree->items = NULL;
     io_tree->items = (char **) calloc(sz, sizeof(char*));
@@ -5306,8 +5444,7 @@ static int xml_tree_alloc_hier_row_lengths(xml_tree_t * io_tree)
         return ORCM_ERROR;
     }
 
-    unsigned long sz = (io_tree->sz_hierarchy + xtBLOCK_SIZE-1) / xtBLOCK_SIZE;
-    sz *= xtBLOCK_SIZE;
+    unsigned long sz = xml_tree_capacity(io_tree->sz_hierarchy, xtBLOCK_SIZE);
 
     io_tree->hier_row_lengths = NULL;
     io_tree->hier_row_lengths = (unsigned long*) calloc(sz, sizeof(unsigned long));
@@ -5326,8 +5463,7 @@ static int xml_tree_alloc_hierarchy(xml_tree_t * io_tree)
         return ORCM_ERROR;
     }
 
-    unsigned long sz = (io_tree->sz_hierarchy + xtBLOCK_SIZE-1) / xtBLOCK_SIZE;
-    sz *= xtBLOCK_SIZE;
+    unsigned long sz = xml_tree_capacity(io_tree->sz_hierarchy, xtBLOCK_SIZE);
 
     io_tree->hierarchy = NULL;
     io_tree->hierarchy = (long**) calloc(sz, sizeof(long*));
@@ -5380,11 +5516,22 @@ static void xml_tree_destroy(xml_tree_t * io_tree)
     return;
 }
 
+static unsigned long xml_tree_capacity(unsigned long in_sz_array,
+                                       unsigned long in_block_size)
+{
+    unsigned long sz = in_block_size;
+    while (sz < in_sz_array) {
+        sz *= 2;
+    }
+    return sz;
+}
+
 static int xml_tree_grow(unsigned long in_data_size,unsigned long in_block_size,
                          unsigned long in_sz_array, void * *io_array)
 {
-    if ( 0 ==  in_sz_array % in_block_size ) {
-        unsigned long sz = in_sz_array + in_block_size;
+    /* Capacities double, so appending n items copies O(n) in total */
+    if (NULL == *io_array || in_sz_array == xml_tree_capacity(in_sz_array, in_block_size)) {
+        unsigned long sz = xml_tree_capacity(in_sz_array + 1, in_block_size);
         void * t = NULL;
         t = (void *) calloc(sz, in_data_size);
         if (NULL == t) {
@@ -12,7 +12,43 @@
 
 #include "orcm/mca/cfgi/cfgi.h"
 
-ORCM_DECLSPEC extern orcm_cfgi_base_component_t mca_cfgi_file30_component;
+BEGIN_C_DECLS
+
+typedef struct {
+    orcm_cfgi_base_component_t super;
+    /* load the compiled config image when it matches the site file */
+    bool use_cache;
+    /* where the image lives - defaults to the var or session dir */
+    char *cache_file;
+} orcm_cfgi_file30_component_t;
+ORCM_DECLSPEC extern orcm_cfgi_file30_component_t mca_cfgi_file30_component;
 ORCM_DECLSPEC extern orcm_cfgi_base_module_t orcm_cfgi_file30_module;
 
+/* read-only image of the site file - mapped when possible */
+typedef struct {
+    char *data;
+    size_t size;
+    bool mapped;
+} orcm_cfgi_file30_map_t;
+
+ORCM_DECLSPEC int orcm_cfgi_file30_map(const char *filename, orcm_cfgi_file30_map_t *map);
+ORCM_DECLSPEC void orcm_cfgi_file30_unmap(orcm_cfgi_file30_map_t *map);
+ORCM_DECLSPEC uint64_t orcm_cfgi_file30_hash(const orcm_cfgi_file30_map_t *map);
+
+/* split the XML image into a NULL-terminated argv of items: tags,
+ * closing tags prefixed with '/' and data fields prefixed with '\t' */
+ORCM_DECLSPEC int orcm_cfgi_file30_lex(const orcm_cfgi_file30_map_t *map,
+                                       char ***items, unsigned long *nitems);
+
+/* compiled config cache: the parsed and validated configuration,
+ * keyed by the hash and size of the XML it was built from. A load
+ * that finds no image, a stale one or a damaged one returns
+ * ORCM_ERR_NOT_FOUND and leaves config alone */
+ORCM_DECLSPEC int orcm_cfgi_file30_cache_load(uint64_t hash, uint64_t size,
+                                              opal_list_t *config);
+ORCM_DECLSPEC void orcm_cfgi_file30_cache_store(uint64_t hash, uint64_t size,
+                                                opal_list_t *config);
+
+END_C_DECLS
+
 #endif /* CFGI_FILE30_H */
@@ -0,0 +1,422 @@
+/*
+ * Copyright (c) 2016      Intel, Inc.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif  /* HAVE_UNISTD_H */
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif  /* HAVE_STRING_H */
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "opal/dss/dss.h"
+#include "opal/mca/installdirs/installdirs.h"
+#include "opal/util/argv.h"
+#include "opal/util/basename.h"
+#include "opal/util/os_dirpath.h"
+#include "opal/util/output.h"
+
+#include "orte/util/proc_info.h"
+
+#include "orcm/mca/cfgi/base/base.h"
+#include "orcm/mca/cfgi/file30/cfgi_file30.h"
+
+/* bump whenever the layout of the image changes */
+#define CACHE_MAGIC     "ORCMCFG30"
+#define CACHE_VERSION   2
+
+/* the compiled tree is only a handful of levels deep -
+ * anything deeper did not come from cache_store */
+#define CACHE_MAX_DEPTH 32
+
+#define FNV64_OFFSET    0xcbf29ce484222325ULL
+#define FNV64_PRIME     0x100000001b3ULL
+
+int orcm_cfgi_file30_map(const char *filename, orcm_cfgi_file30_map_t *map)
+{
+    struct stat st;
+    ssize_t got;
+    size_t done;
+    int fd;
+
+    map->data = NULL;
+    map->size = 0;
+    map->mapped = false;
+
+    if (0 > (fd = open(filename, O_RDONLY))) {
+        return ORCM_ERR_NOT_FOUND;
+    }
+    if (0 != fstat(fd, &st)) {
+        close(fd);
+        return ORCM_ERR_FILE_READ_FAILURE;
+    }
+    map->size = st.st_size;
+    if (0 == map->size) {
+        close(fd);
+        return ORCM_SUCCESS;
+    }
+
+    map->data = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED != map->data) {
+        map->mapped = true;
+        close(fd);
+        return ORCM_SUCCESS;
+    }
+
+    /* not mappable - read it in instead */
+    if (NULL == (map->data = (char*)malloc(map->size))) {
+        close(fd);
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    for (done = 0; done < map->size; done += got) {
+        got = read(fd, map->data + done, map->size - done);
+        if (got < 0 && EINTR == errno) {
+            got = 0;
+            continue;
+        }
+        if (got <= 0) {
+            break;
+        }
+    }
+    map->size = done;
+    close(fd);
+    return ORCM_SUCCESS;
+}
+
+void orcm_cfgi_file30_unmap(orcm_cfgi_file30_map_t *map)
+{
+    if (NULL == map->data) {
+        return;
+    }
+    if (map->mapped) {
+        munmap(map->data, map->size);
+    } else {
+        free(map->data);
+    }
+    map->data = NULL;
+    map->size = 0;
+    map->mapped = false;
+}
+
+uint64_t orcm_cfgi_file30_hash(const orcm_cfgi_file30_map_t *map)
+{
+    uint64_t h = FNV64_OFFSET;
+    size_t i;
+
+    for (i = 0; i < map->size; i++) {
+        h ^= (unsigned char)map->data[i];
+        h *= FNV64_PRIME;
+    }
+    return h;
+}
+
+/* the site file's own directory is often shared or read-only, so by
+ * default the image goes in the install's var directory or, failing
+ * that, our session directory */
+static char* cache_path(void)
+{
+    char *dir = NULL, *name, *path = NULL;
+
+    if (NULL != mca_cfgi_file30_component.cache_file) {
+        return strdup(mca_cfgi_file30_component.cache_file);
+    }
+    if (NULL == orcm_cfgi_base.config_file) {
+        return NULL;
+    }
+    if (NULL != opal_install_dirs.localstatedir &&
+        0 > asprintf(&dir, "%s/orcm", opal_install_dirs.localstatedir)) {
+        dir = NULL;
+    }
+    if (NULL != dir &&
+        (OPAL_SUCCESS != opal_os_dirpath_create(dir, S_IRWXU | S_IRGRP | S_IXGRP |
+                                                     S_IROTH | S_IXOTH) ||
+         0 != access(dir, W_OK))) {
+        free(dir);
+        dir = NULL;
+    }
+    if (NULL == dir && NULL != orte_process_info.top_session_dir) {
+        dir = strdup(orte_process_info.top_session_dir);
+    }
+    if (NULL == dir) {
+        return NULL;
+    }
+    name = opal_basename(orcm_cfgi_base.config_file);
+    if (0 > asprintf(&path, "%s/%s.cache", dir, name)) {
+        path = NULL;
+    }
+    free(name);
+    free(dir);
+    return path;
+}
+
+/* bytes of the image still to be unpacked */
+static size_t image_left(opal_buffer_t *buf)
+{
+    return buf->bytes_used - (size_t)(buf->unpack_ptr - buf->base_ptr);
+}
+
+/* every counted element takes at least a byte of the image, so a
+ * count larger than what is left of it can only be damage */
+static bool count_fits(opal_buffer_t *buf, int32_t n)
+{
+    return (0 <= n && (size_t)n <= image_left(buf));
+}
+
+static int pack_xml(opal_buffer_t *buf, orcm_cfgi_xml_parser_t *x)
+{
+    orcm_cfgi_xml_parser_t *sub;
+    int32_t n;
+    int rc;
+
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(buf, &x->name, 1, OPAL_STRING))) {
+        return rc;
+    }
+    n = opal_argv_count(x->value);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(buf, &n, 1, OPAL_INT32))) {
+        return rc;
+    }
+    if (0 < n && OPAL_SUCCESS != (rc = opal_dss.pack(buf, x->value, n, OPAL_STRING))) {
+        return rc;
+    }
+    n = opal_list_get_size(&x->subvals);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(buf, &n, 1, OPAL_INT32))) {
+        return rc;
+    }
+    OPAL_LIST_FOREACH(sub, &x->subvals, orcm_cfgi_xml_parser_t) {
+        if (OPAL_SUCCESS != (rc = pack_xml(buf, sub))) {
+            return rc;
+        }
+    }
+    return OPAL_SUCCESS;
+}
+
+static int unpack_xml(opal_buffer_t *buf, opal_list_t *parent, int depth)
+{
+    orcm_cfgi_xml_parser_t *x;
+    int32_t n, i, cnt;
+    int rc;
+
+    if (CACHE_MAX_DEPTH < depth) {
+        return OPAL_ERR_UNPACK_FAILURE;
+    }
+    x = OBJ_NEW(orcm_cfgi_xml_parser_t);
+    opal_list_append(parent, &x->super);
+
+    cnt = 1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buf, &x->name, &cnt, OPAL_STRING))) {
+        return rc;
+    }
+    cnt = 1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buf, &n, &cnt, OPAL_INT32))) {
+        return rc;
+    }
+    if (!count_fits(buf, n)) {
+        return OPAL_ERR_UNPACK_FAILURE;
+    }
+    if (0 < n) {
+        /* argv arrays are NULL-terminated */
+        if (NULL == (x->value = (char**)calloc(n + 1, sizeof(char*)))) {
+            return OPAL_ERR_OUT_OF_RESOURCE;
+        }
+        cnt = n;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(buf, x->value, &cnt, OPAL_STRING))) {
+            return rc;
+        }
+    }
+    cnt = 1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buf, &n, &cnt, OPAL_INT32))) {
+        return rc;
+    }
+    if (!count_fits(buf, n)) {
+        return OPAL_ERR_UNPACK_FAILURE;
+    }
+    for (i = 0; i < n; i++) {
+        if (OPAL_SUCCESS != (rc = unpack_xml(buf, &x->subvals, depth + 1))) {
+            return rc;
+        }
+    }
+    return OPAL_SUCCESS;
+}
+
+/* map the image and check that it was compiled from the XML
+ * with this hash and size, and that the compiled configuration
+ * behind the header is intact. On success buf reads from the
+ * image, positioned at the start of that configuration */
+static int open_image(uint64_t hash, uint64_t size,
+                      orcm_cfgi_file30_map_t *image, opal_buffer_t *buf)
+{
+    char *path;
+    uint64_t cached_hash, cached_size, cached_sum;
+    orcm_cfgi_file30_map_t payload;
+    int32_t version, cnt;
+    size_t magic_len = sizeof(CACHE_MAGIC);
+    int rc;
+
+    if (NULL == (path = cache_path())) {
+        return ORCM_ERR_NOT_FOUND;
+    }
+    rc = orcm_cfgi_file30_map(path, image);
+    free(path);
+    if (ORCM_SUCCESS != rc) {
+        return ORCM_ERR_NOT_FOUND;
+    }
+    if (image->size <= magic_len || 0 != memcmp(image->data, CACHE_MAGIC, magic_len)) {
+        orcm_cfgi_file30_unmap(image);
+        return ORCM_ERR_NOT_FOUND;
+    }
+
+    /* the buffer only borrows the image - never let it free it */
+    OBJ_CONSTRUCT(buf, opal_buffer_t);
+    opal_dss.load(buf, image->data + magic_len, image->size - magic_len);
+    buf->borrowed = true;
+
+    cnt = 1;
+    if (OPAL_SUCCESS == opal_dss.unpack(buf, &version, &cnt, OPAL_INT32) &&
+        CACHE_VERSION == version &&
+        OPAL_SUCCESS == opal_dss.unpack(buf, &cached_size, &cnt, OPAL_UINT64) &&
+        cached_size == size &&
+        OPAL_SUCCESS == opal_dss.unpack(buf, &cached_hash, &cnt, OPAL_UINT64) &&
+        cached_hash == hash &&
+        OPAL_SUCCESS == opal_dss.unpack(buf, &cached_sum, &cnt, OPAL_UINT64)) {
+        /* a torn or scribbled-on image must not pass for the config */
+        payload.data = buf->unpack_ptr;
+        payload.size = image_left(buf);
+        payload.mapped = false;
+        if (cached_sum == orcm_cfgi_file30_hash(&payload)) {
+            return ORCM_SUCCESS;
+        }
+    }
+    OBJ_DESTRUCT(buf);
+    orcm_cfgi_file30_unmap(image);
+    return ORCM_ERR_NOT_FOUND;
+}
+
+int orcm_cfgi_file30_cache_load(uint64_t hash, uint64_t size, opal_list_t *config)
+{
+    orcm_cfgi_file30_map_t image;
+    opal_buffer_t buf;
+    opal_list_t items;
+    int32_t n, i, cnt;
+    int rc = ORCM_ERR_NOT_FOUND;
+
+    if (ORCM_SUCCESS != open_image(hash, size, &image, &buf)) {
+        return ORCM_ERR_NOT_FOUND;
+    }
+
+    OBJ_CONSTRUCT(&items, opal_list_t);
+    cnt = 1;
+    /* a damaged image is just a stale one */
+    if (OPAL_SUCCESS != opal_dss.unpack(&buf, &n, &cnt, OPAL_INT32) ||
+        !count_fits(&buf, n)) {
+        goto done;
+    }
+    for (i = 0; i < n; i++) {
+        if (OPAL_SUCCESS != unpack_xml(&buf, &items, 0)) {
+            goto done;
+        }
+    }
+    if (0 != image_left(&buf)) {
+        goto done;
+    }
+    opal_list_join(config, opal_list_get_end(config), &items);
+    rc = ORCM_SUCCESS;
+
+ done:
+    OPAL_LIST_DESTRUCT(&items);
+    OBJ_DESTRUCT(&buf);
+    orcm_cfgi_file30_unmap(&image);
+    return rc;
+}
+
+void orcm_cfgi_file30_cache_store(uint64_t hash, uint64_t size, opal_list_t *config)
+{
+    orcm_cfgi_xml_parser_t *x;
+    orcm_cfgi_file30_map_t payload;
+    opal_buffer_t head, body;
+    char *path, *tmp = NULL, *hbytes = NULL, *bbytes = NULL;
+    int32_t version = CACHE_VERSION, n;
+    int32_t nhbytes = 0, nbbytes = 0;
+    uint64_t sum;
+    FILE *fp = NULL;
+    bool ok;
+
+    if (NULL == (path = cache_path())) {
+        return;
+    }
+
+    OBJ_CONSTRUCT(&head, opal_buffer_t);
+    OBJ_CONSTRUCT(&body, opal_buffer_t);
+    n = opal_list_get_size(config);
+    ok = (OPAL_SUCCESS == opal_dss.pack(&body, &n, 1, OPAL_INT32));
+    if (ok) {
+        OPAL_LIST_FOREACH(x, config, orcm_cfgi_xml_parser_t) {
+            if (OPAL_SUCCESS != pack_xml(&body, x)) {
+                ok = false;
+                break;
+            }
+        }
+    }
+    if (ok) {
+        ok = (OPAL_SUCCESS == opal_dss.unload(&body, (void**)&bbytes, &nbbytes));
+    }
+    if (ok) {
+        payload.data = bbytes;
+        payload.size = nbbytes;
+        payload.mapped = false;
+        sum = orcm_cfgi_file30_hash(&payload);
+        ok = (OPAL_SUCCESS == opal_dss.pack(&head, &version, 1, OPAL_INT32) &&
+              OPAL_SUCCESS == opal_dss.pack(&head, &size, 1, OPAL_UINT64) &&
+              OPAL_SUCCESS == opal_dss.pack(&head, &hash, 1, OPAL_UINT64) &&
+              OPAL_SUCCESS == opal_dss.pack(&head, &sum, 1, OPAL_UINT64) &&
+              OPAL_SUCCESS == opal_dss.unload(&head, (void**)&hbytes, &nhbytes));
+    }
+
+    /* write a private copy and rename it into place so that a
+     * daemon starting alongside never sees a partial image */
+    if (ok && 0 < asprintf(&tmp, "%s.%lu", path, (unsigned long)getpid())) {
+        if (NULL != (fp = fopen(tmp, "w"))) {
+            ok = (1 == fwrite(CACHE_MAGIC, sizeof(CACHE_MAGIC), 1, fp) &&
+                  1 == fwrite(hbytes, nhbytes, 1, fp) &&
+                  (0 == nbbytes || 1 == fwrite(bbytes, nbbytes, 1, fp)));
+            ok = (0 == fclose(fp)) && ok;
+            if (ok && 0 != rename(tmp, path)) {
+                ok = false;
+            }
+            if (!ok) {
+                unlink(tmp);
+            }
+        } else {
+            ok = false;
+        }
+    }
+    opal_output_verbose(5, orcm_cfgi_base_framework.framework_output,
+                        "cfgi:file30 %s compiled configuration %s",
+                        ok ? "wrote" : "could not write", path);
+
+    if (NULL != tmp) {
+        free(tmp);
+    }
+    if (NULL != hbytes) {
+        free(hbytes);
+    }
+    if (NULL != bbytes) {
+        free(bbytes);
+    }
+    OBJ_DESTRUCT(&head);
+    OBJ_DESTRUCT(&body);
+    free(path);
+}
@@ -21,25 +21,28 @@
 static int component_open(void);
 static int component_close(void);
 static int component_query(mca_base_module_t **module, int *priority);
+static int component_register(void);
 
-orcm_cfgi_base_component_t mca_cfgi_file30_component = {
+orcm_cfgi_file30_component_t mca_cfgi_file30_component = {
     {
-        ORCM_CFGI_BASE_VERSION_1_0_0,
-        /* Component name and version */
-        .mca_component_name = "file30",
-        MCA_BASE_MAKE_VERSION(component, ORCM_MAJOR_VERSION, ORCM_MINOR_VERSION,
-                              ORCM_RELEASE_VERSION),
-        
-        /* Component open and close functions */
-        .mca_open_component = component_open,
-        .mca_close_component = component_close,
-        .mca_query_component = component_query,
-        NULL
-    },
-    .base_data = {
-        /* The component is checkpoint ready */
-        MCA_BASE_METADATA_PARAM_CHECKPOINT
-    },
+        {
+            ORCM_CFGI_BASE_VERSION_1_0_0,
+            /* Component name and version */
+            .mca_component_name = "file30",
+            MCA_BASE_MAKE_VERSION(component, ORCM_MAJOR_VERSION, ORCM_MINOR_VERSION,
+                                  ORCM_RELEASE_VERSION),
+
+            /* Component open and close functions */
+            .mca_open_component = component_open,
+            .mca_close_component = component_close,
+            .mca_query_component = component_query,
+            .mca_register_component_params = component_register
+        },
+        .base_data = {
+            /* The component is checkpoint ready */
+            MCA_BASE_METADATA_PARAM_CHECKPOINT
+        },
+    }
 };
 
 static int component_open(void)
@@ -59,3 +62,29 @@ static int component_query(mca_base_module_t **module, int *priority)
     *priority = 10;
     return ORCM_SUCCESS;
 }
+
+static int component_register(void)
+{
+    mca_base_component_t *c = &mca_cfgi_file30_component.super.base_version;
+
+    mca_cfgi_file30_component.use_cache = true;
+    (void) mca_base_component_var_register(c, "use_cache",
+                                           "Load the compiled configuration image instead of "
+                                           "parsing the site file when the file is unchanged",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_cfgi_file30_component.use_cache);
+
+    mca_cfgi_file30_component.cache_file = NULL;
+    (void) mca_base_component_var_register(c, "cache_file",
+                                           "Path of the compiled configuration image "
+                                           "[default: <config_file name>.cache in "
+                                           "<localstatedir>/orcm, or in the session "
+                                           "directory if that is not writable]",
+                                           MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_cfgi_file30_component.cache_file);
+    return ORCM_SUCCESS;
+}
@@ -43,8 +43,22 @@ typedef struct {
     opal_pointer_array_t handles;
     opal_event_base_t *ev_base;
     bool ev_base_active;
+    bool rollup;                /* maintain the summary tiers */
+    int raw_retention;          /* days of raw samples to keep, 0 = all */
+    int maintenance_interval;   /* seconds between retention passes */
 } orcm_db_base_t;
 
+/* A summary tier of the raw sensor samples: one row per host, data
+ * item and units for every period of the tier */
+typedef struct {
+    const char *name;           /* also the date_trunc() field */
+    const char *table;
+    uint32_t seconds;
+    int retention;              /* days of rows to keep, 0 = all */
+} orcm_db_rollup_tier_t;
+
+#define ORCM_DB_ROLLUP_NUM_TIERS 3
+
 typedef struct {
     opal_list_item_t super;
     orcm_db_base_component_t *component;
@@ -79,6 +93,7 @@ typedef struct {
 
     opal_list_t *kvs;
     const char *view_name;
+    orcm_db_aggregate_t *aggregate;
 } orcm_db_request_t;
 OBJ_CLASS_DECLARATION(orcm_db_request_t);
 
@@ -106,6 +121,7 @@ typedef struct {
 } orcm_db_item_t;
 
 ORCM_DECLSPEC extern orcm_db_base_t orcm_db_base;
+ORCM_DECLSPEC extern orcm_db_rollup_tier_t orcm_db_base_rollup_tiers[ORCM_DB_ROLLUP_NUM_TIERS];
 
 ORCM_DECLSPEC void orcm_db_base_open(char *name,
                                      opal_list_t *properties,
@@ -162,6 +178,13 @@ ORCM_DECLSPEC void orcm_db_base_fetch(int dbhandle,
                                       opal_list_t *kvs,
                                       orcm_db_callback_fn_t cbfunc,
                                       void *cbdata);
+ORCM_DECLSPEC void orcm_db_base_fetch_aggregate(int dbhandle,
+                                                const char *view,
+                                                opal_list_t *filters,
+                                                orcm_db_aggregate_t *aggregate,
+                                                opal_list_t *kvs,
+                                                orcm_db_callback_fn_t cbfunc,
+                                                void *cbdata);
 ORCM_DECLSPEC int orcm_db_base_get_num_rows(int dbhandle,
                                             int rshandle,
                                             int *num_rows);
@@ -176,6 +199,15 @@ ORCM_DECLSPEC void orcm_db_base_remove_data(int dbhandle,
                                             orcm_db_callback_fn_t cbfunc,
                                             void *cbdata);
 
+/* rollup tiers (SQL in PostgreSQL syntax) */
+ORCM_DECLSPEC char* orcm_db_base_rollup_table_ddl(const orcm_db_rollup_tier_t *tier);
+ORCM_DECLSPEC char* orcm_db_base_rollup_upsert(const char *rows);
+ORCM_DECLSPEC char* orcm_db_base_rollup_expire(const char *table, int retention);
+ORCM_DECLSPEC const orcm_db_rollup_tier_t* orcm_db_base_rollup_select(const char *view,
+                                                                      opal_list_t *filters,
+                                                                      orcm_db_aggregate_t *aggregate,
+                                                                      time_t now);
+
 ORCM_DECLSPEC int opal_value_to_orcm_db_item(const opal_value_t *kv,
                                              orcm_db_item_t *item);
 ORCM_DECLSPEC int orcm_util_find_items(const char *keys[],
@@ -187,5 +219,11 @@ ORCM_DECLSPEC int orcm_util_find_items(const char *keys[],
 END_C_DECLS
 
 char* build_query_from_view_name_and_filters(const char* view_name, opal_list_t* filters);
+char* build_aggregate_query_from_view_name_and_filters(const char* view_name,
+                                                       opal_list_t* filters,
+                                                       orcm_db_aggregate_t* aggregate);
+char* build_rollup_query_from_filters(const orcm_db_rollup_tier_t* tier,
+                                      opal_list_t* filters,
+                                      orcm_db_aggregate_t* aggregate);
 
 #endif
@@ -14,6 +14,7 @@
 #include "orcm/constants.h"
 
 #include "opal/mca/mca.h"
+#include "opal/util/argv.h"
 #include "opal/util/output.h"
 #include "opal/mca/base/base.h"
 #include "opal/dss/dss_types.h"
@@ -46,6 +47,7 @@ orcm_db_API_module_t orcm_db = {
     orcm_db_base_commit,
     orcm_db_base_rollback,
     orcm_db_base_fetch,
+    orcm_db_base_fetch_aggregate,
     orcm_db_base_get_num_rows,
     orcm_db_base_get_next_row,
     orcm_db_base_close_result_set,
@@ -57,6 +59,8 @@ static bool orcm_db_base_create_evbase;
 
 static int orcm_db_base_register(mca_base_register_flag_t flags)
 {
+    int var_id;
+
     orcm_db_base_create_evbase = true;
     mca_base_var_register("orcm", "db", "base", "create_evbase",
                           "Create a separate event base for processing db operations",
@@ -64,6 +68,55 @@ static int orcm_db_base_register(mca_base_register_flag_t flags)
                           OPAL_INFO_LVL_9,
                           MCA_BASE_VAR_SCOPE_READONLY,
                           &orcm_db_base_create_evbase);
+
+    orcm_db_base.rollup = false;
+    mca_base_var_register("orcm", "db", "base", "rollup",
+                          "Keep per-minute, per-hour and per-day summaries of the "
+                          "sensor samples and answer coarse aggregate queries from them",
+                          MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                          OPAL_INFO_LVL_9,
+                          MCA_BASE_VAR_SCOPE_READONLY,
+                          &orcm_db_base.rollup);
+
+    orcm_db_base.raw_retention = 0;
+    var_id = mca_base_var_register("orcm", "db", "base", "raw_retention",
+                                   "Days of raw sensor samples to keep when summarizing or "
+                                   "partitioning them (0 = keep all)",
+                                   MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                   OPAL_INFO_LVL_9,
+                                   MCA_BASE_VAR_SCOPE_READONLY,
+                                   &orcm_db_base.raw_retention);
+    (void) mca_base_var_register_synonym(var_id, "orcm", "db", "base", "rollup_raw_retention",
+                                         MCA_BASE_VAR_SYN_FLAG_DEPRECATED);
+
+    mca_base_var_register("orcm", "db", "base", "rollup_minute_retention",
+                          "Days of per-minute summaries to keep (0 = keep all)",
+                          MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                          OPAL_INFO_LVL_9,
+                          MCA_BASE_VAR_SCOPE_READONLY,
+                          &orcm_db_base_rollup_tiers[0].retention);
+    mca_base_var_register("orcm", "db", "base", "rollup_hour_retention",
+                          "Days of per-hour summaries to keep (0 = keep all)",
+                          MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                          OPAL_INFO_LVL_9,
+                          MCA_BASE_VAR_SCOPE_READONLY,
+                          &orcm_db_base_rollup_tiers[1].retention);
+    mca_base_var_register("orcm", "db", "base", "rollup_day_retention",
+                          "Days of per-day summaries to keep (0 = keep all)",
+                          MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                          OPAL_INFO_LVL_9,
+                          MCA_BASE_VAR_SCOPE_READONLY,
+                          &orcm_db_base_rollup_tiers[2].retention);
+
+    orcm_db_base.maintenance_interval = 3600;
+    var_id = mca_base_var_register("orcm", "db", "base", "maintenance_interval",
+                                   "Seconds between passes that age out raw samples and summaries",
+                                   MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                   OPAL_INFO_LVL_9,
+                                   MCA_BASE_VAR_SCOPE_READONLY,
+                                   &orcm_db_base.maintenance_interval);
+    (void) mca_base_var_register_synonym(var_id, "orcm", "db", "base", "rollup_maintenance",
+                                         MCA_BASE_VAR_SYN_FLAG_DEPRECATED);
     return ORCM_SUCCESS;
 }
 
@@ -148,6 +201,7 @@ static void req_con(orcm_db_request_t *p)
     p->component_index = NULL;
     p->test_result = NULL;
     p->view_name = NULL;
+    p->aggregate = NULL;
 
     p->kvs = NULL;
 }
@@ -171,3 +225,26 @@ static void filter_con(orcm_db_filter_t *p)
 OBJ_CLASS_INSTANCE(orcm_db_filter_t,
                    opal_value_t,
                    filter_con, NULL);
+
+static void aggregate_con(orcm_db_aggregate_t *p)
+{
+    p->columns = NULL;
+    p->group_by = NULL;
+    p->time_column = NULL;
+    p->interval = 0;
+    p->value_column = NULL;
+    p->function = ORCM_DB_AGG_AVG;
+    p->percentile = 0.5;
+}
+
+static void aggregate_des(orcm_db_aggregate_t *p)
+{
+    opal_argv_free(p->columns);
+    opal_argv_free(p->group_by);
+    free(p->time_column);
+    free(p->value_column);
+}
+
+OBJ_CLASS_INSTANCE(orcm_db_aggregate_t,
+                   opal_object_t,
+                   aggregate_con, aggregate_des);
@@ -0,0 +1,260 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Summary tiers of data_sample_raw. Every numeric sample that is stored
+ * is also folded into a per-minute, per-hour and per-day row holding the
+ * count, sum, minimum and maximum of the period, in the same transaction
+ * as the raw insert. Each table is aged out on its own schedule, and
+ * aggregate queries over long ranges are answered from the coarsest tier
+ * that still gives the requested resolution.
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <sys/time.h>
+
+#include "opal/class/opal_list.h"
+
+#include "orcm/mca/db/base/base.h"
+
+/* No need to include the entire header for one function. */
+extern int asprintf(char** new_str, const char* format,...);
+extern bool time_stamp_str_to_tv(char* stamp, struct timeval* time_value);
+
+#define ROLLUP_VIEW "data_sensors_view"
+#define ROLLUP_TIME_COLUMN "time_stamp"
+#define SECONDS_PER_DAY 86400
+
+/* finest first */
+orcm_db_rollup_tier_t orcm_db_base_rollup_tiers[ORCM_DB_ROLLUP_NUM_TIERS] = {
+    {"minute", "data_sample_rollup_minute", 60, 7},
+    {"hour", "data_sample_rollup_hour", 3600, 90},
+    {"day", "data_sample_rollup_day", SECONDS_PER_DAY, 0}
+};
+
+/* the view columns a tier can stand in for */
+static const char *rollup_columns[] = {
+    "hostname",
+    "data_item",
+    "units",
+    ROLLUP_TIME_COLUMN,
+    NULL
+};
+
+static bool is_rollup_column(const char *column)
+{
+    for (int i = 0; NULL != rollup_columns[i]; ++i) {
+        if (0 == strcmp(rollup_columns[i], column)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Index of the coarsest tier whose periods start at this time stamp, or
+ * -1 if none does. The tiers are cut with date_trunc on the stored wall
+ * clock, so the check is made on the wall clock fields as written. */
+static int coarsest_aligned_tier(const char *stamp)
+{
+    int hour, min, sec, day_sec, i;
+
+    if (3 != sscanf(stamp, "%*d-%*d-%*d %d:%d:%d", &hour, &min, &sec)) {
+        return -1;
+    }
+    if (19 < strlen(stamp) && '.' == stamp[19] &&
+        strspn(&stamp[20], "0") != strlen(&stamp[20])) {
+        return -1;
+    }
+    day_sec = hour * 3600 + min * 60 + sec;
+    for (i = ORCM_DB_ROLLUP_NUM_TIERS - 1; i >= 0; i--) {
+        if (0 == day_sec % orcm_db_base_rollup_tiers[i].seconds) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+char* orcm_db_base_rollup_table_ddl(const orcm_db_rollup_tier_t *tier)
+{
+    char *ddl = NULL;
+
+    if (NULL == tier) {
+        return NULL;
+    }
+    if (0 > asprintf(&ddl, "create table if not exists %s ("
+                     "hostname text not null, "
+                     "data_item text not null, "
+                     "units text not null, "
+                     "time_stamp timestamp not null, "
+                     "samples bigint not null, "
+                     "value_sum double precision not null, "
+                     "value_min double precision not null, "
+                     "value_max double precision not null, "
+                     "primary key (hostname, data_item, units, time_stamp));",
+                     tier->table)) {
+        return NULL;
+    }
+    return ddl;
+}
+
+static char* rollup_tier_insert(const orcm_db_rollup_tier_t *tier)
+{
+    char *insert = NULL;
+
+    if (0 > asprintf(&insert, "insert into %s as r "
+                     "(hostname, data_item, units, time_stamp, "
+                     "samples, value_sum, value_min, value_max) "
+                     "select hostname, data_item, coalesce(units, ''), "
+                     "date_trunc('%s', cast(time_stamp as timestamp)), count(*), "
+                     "sum(cast(value as double precision)), "
+                     "min(cast(value as double precision)), "
+                     "max(cast(value as double precision)) "
+                     "from samples group by 1, 2, 3, 4 "
+                     "on conflict (hostname, data_item, units, time_stamp) do update set "
+                     "samples = r.samples + excluded.samples, "
+                     "value_sum = r.value_sum + excluded.value_sum, "
+                     "value_min = least(r.value_min, excluded.value_min), "
+                     "value_max = greatest(r.value_max, excluded.value_max)",
+                     tier->table, tier->name)) {
+        return NULL;
+    }
+    return insert;
+}
+
+/* One statement folds a batch into every tier: the rows are given as a
+ * values list of (hostname, data_item, units, time_stamp, value) */
+char* orcm_db_base_rollup_upsert(const char *rows)
+{
+    char *query = NULL;
+    char *old_query;
+    char *insert;
+    int i, rc;
+
+    if (NULL == rows || '\0' == rows[0]) {
+        return NULL;
+    }
+    if (0 > asprintf(&query, "with samples(hostname, data_item, units, time_stamp, value) "
+                     "as (values %s)", rows)) {
+        return NULL;
+    }
+    for (i = 0; i < ORCM_DB_ROLLUP_NUM_TIERS; i++) {
+        if (NULL == (insert = rollup_tier_insert(&orcm_db_base_rollup_tiers[i]))) {
+            free(query);
+            return NULL;
+        }
+        old_query = query;
+        /* all but the last tier go in as data-modifying CTEs */
+        if (i < ORCM_DB_ROLLUP_NUM_TIERS - 1) {
+            rc = asprintf(&query, "%s, %s_rows as (%s)", old_query,
+                          orcm_db_base_rollup_tiers[i].name, insert);
+        } else {
+            rc = asprintf(&query, "%s %s;", old_query, insert);
+        }
+        free(old_query);
+        free(insert);
+        if (0 > rc) {
+            return NULL;
+        }
+    }
+    return query;
+}
+
+char* orcm_db_base_rollup_expire(const char *table, int retention)
+{
+    char *query = NULL;
+
+    if (NULL == table || 0 >= retention) {
+        return NULL;
+    }
+    if (0 > asprintf(&query, "delete from %s where time_stamp < "
+                     "localtimestamp - interval '%d days';", table, retention)) {
+        return NULL;
+    }
+    return query;
+}
+
+const orcm_db_rollup_tier_t* orcm_db_base_rollup_select(const char *view,
+                                                       opal_list_t *filters,
+                                                       orcm_db_aggregate_t *aggregate,
+                                                       time_t now)
+{
+    orcm_db_filter_t *filter;
+    struct timeval start, bound;
+    bool have_start = false;
+    const orcm_db_rollup_tier_t *tier;
+    int coarsest = ORCM_DB_ROLLUP_NUM_TIERS - 1;
+    int aligned, i;
+
+    if (!orcm_db_base.rollup || NULL == view || 0 != strcmp(view, ROLLUP_VIEW) ||
+        NULL == aggregate || NULL == aggregate->value_column ||
+        NULL == aggregate->time_column || 0 == aggregate->interval ||
+        0 != strcmp(aggregate->time_column, ROLLUP_TIME_COLUMN)) {
+        return NULL;
+    }
+    switch (aggregate->function) {
+    case ORCM_DB_AGG_MIN:
+    case ORCM_DB_AGG_MAX:
+    case ORCM_DB_AGG_AVG:
+        break;
+    default:
+        return NULL;
+    }
+    for (i = 0; NULL != aggregate->group_by && NULL != aggregate->group_by[i]; i++) {
+        if (!is_rollup_column(aggregate->group_by[i])) {
+            return NULL;
+        }
+    }
+
+    /* A bound on the value itself needs the raw samples. A tier row is
+     * matched on the start of its period, so it only answers a time range
+     * made of whole periods: [start, end) with both ends on a boundary.
+     * Anything else leaves partial periods at the edges. */
+    if (NULL != filters) {
+        OPAL_LIST_FOREACH(filter, filters, orcm_db_filter_t) {
+            if (NULL == filter->value.key || !is_rollup_column(filter->value.key)) {
+                return NULL;
+            }
+            if (0 != strcmp(filter->value.key, ROLLUP_TIME_COLUMN)) {
+                continue;
+            }
+            if ((GE != filter->op && LT != filter->op) ||
+                OPAL_STRING != filter->value.type ||
+                !time_stamp_str_to_tv(filter->value.data.string, &bound)) {
+                return NULL;
+            }
+            aligned = coarsest_aligned_tier(filter->value.data.string);
+            if (aligned < coarsest) {
+                coarsest = aligned;
+            }
+            if (GE == filter->op && (!have_start || bound.tv_sec < start.tv_sec)) {
+                start = bound;
+                have_start = true;
+            }
+        }
+    }
+
+    /* coarsest tier whose periods tile the buckets and the range, and
+     * which still holds the start of the range */
+    for (i = coarsest; i >= 0; i--) {
+        tier = &orcm_db_base_rollup_tiers[i];
+        if (0 != aggregate->interval % tier->seconds) {
+            continue;
+        }
+        if (0 == tier->retention ||
+            (have_start && now - start.tv_sec <= (time_t)tier->retention * SECONDS_PER_DAY)) {
+            return tier;
+        }
+    }
+    return NULL;
+}
@@ -601,7 +601,15 @@ static void process_fetch(int fd, short args, void *cbdata)
         goto callback_and_cleanup;
     }
 
-    if (NULL != hdl->module->fetch) {
+    if (NULL != req->aggregate) {
+        if (NULL != hdl->module->fetch_aggregate) {
+            rc = hdl->module->fetch_aggregate((struct orcm_db_base_module_t*)hdl->module,
+                                              req->view_name, req->input,
+                                              req->aggregate, req->output);
+        } else {
+            rc = ORCM_ERR_NOT_IMPLEMENTED;
+        }
+    } else if (NULL != hdl->module->fetch) {
         rc = hdl->module->fetch((struct orcm_db_base_module_t*)hdl->module,
                                 req->view_name, req->input, req->output);
     } else {
@@ -642,6 +650,31 @@ void orcm_db_base_fetch(int dbhandle,
     opal_event_active(&req->ev, OPAL_EV_WRITE, 1);
 }
 
+void orcm_db_base_fetch_aggregate(int dbhandle,
+                                  const char *view,
+                                  opal_list_t *filters,
+                                  orcm_db_aggregate_t *aggregate,
+                                  opal_list_t *kvs,
+                                  orcm_db_callback_fn_t cbfunc,
+                                  void *cbdata)
+{
+    orcm_db_request_t *req;
+
+    req = OBJ_NEW(orcm_db_request_t);
+    req->dbhandle = dbhandle;
+    req->input = filters;
+    req->output = kvs;
+    req->cbfunc = cbfunc;
+    req->cbdata = cbdata;
+    req->view_name = view;
+    req->aggregate = aggregate;
+    opal_event_set(orcm_db_base.ev_base, &req->ev, -1,
+                   OPAL_EV_WRITE,
+                   process_fetch, req);
+    opal_event_set_priority(&req->ev, OPAL_EV_SYS_HI_PRI);
+    opal_event_active(&req->ev, OPAL_EV_WRITE, 1);
+}
+
 int orcm_db_base_get_num_rows(int dbhandle, int rshandle, int *num_rows)
 {
     orcm_db_handle_t *hdl = (orcm_db_handle_t*)opal_pointer_array_get_item(&orcm_db_base.handles, dbhandle);
@@ -11,7 +11,15 @@
 
 #include "orcm/constants.h"
 
+#include "opal/util/argv.h"
+
 char* build_query_from_view_name_and_filters(const char* view_name, opal_list_t* filters);
+char* build_aggregate_query_from_view_name_and_filters(const char* view_name,
+                                                       opal_list_t* filters,
+                                                       orcm_db_aggregate_t* aggregate);
+char* build_rollup_query_from_filters(const orcm_db_rollup_tier_t* tier,
+                                      opal_list_t* filters,
+                                      orcm_db_aggregate_t* aggregate);
 char* get_opal_value_as_sql_string(opal_value_t *value);
 char* timeval_to_iso8601(struct timeval* tv);
 bool is_supported_opal_int_type(opal_data_type_t type);
@@ -249,6 +257,200 @@ char* build_query_from_view_name_and_filters(const char* view_name, opal_list_t*
     return query;
 }
 
+static char *aggregate_fn_strings[] = {
+    "min",
+    "max",
+    "avg",
+    "count",
+    NULL
+};
+
+/* Values are stored as text in the views, so only those that look like a
+ * number can take part in a numeric aggregate (PostgreSQL syntax) */
+#define NUMERIC_VALUE_PATTERN "'^[-+]?([0-9]+[.]?[0-9]*|[.][0-9]+)([eE][-+]?[0-9]+)?$'"
+
+static bool is_group_column(orcm_db_aggregate_t *aggregate, const char *column)
+{
+    for (int i = 0; NULL != aggregate->group_by && NULL != aggregate->group_by[i]; ++i) {
+        if (0 == strcmp(aggregate->group_by[i], column)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* The tiers keep a count, sum, minimum and maximum of the numeric samples
+ * per period. A count over the view also takes in the text samples and a
+ * percentile needs the samples themselves, so neither comes from a tier */
+static char* rollup_value_expression(orcm_db_aggregate_t *aggregate, const char *column)
+{
+    char *expr = NULL;
+    int rc;
+
+    switch (aggregate->function) {
+    case ORCM_DB_AGG_MIN:
+        rc = asprintf(&expr, "concat(min(value_min)) as %s", column);
+        break;
+    case ORCM_DB_AGG_MAX:
+        rc = asprintf(&expr, "concat(max(value_max)) as %s", column);
+        break;
+    case ORCM_DB_AGG_AVG:
+        rc = asprintf(&expr, "concat(sum(value_sum) / sum(samples)) as %s", column);
+        break;
+    default:
+        return NULL;
+    }
+    return (0 > rc) ? NULL : expr;
+}
+
+static char* aggregate_column_expression(orcm_db_aggregate_t *aggregate, const char *column,
+                                         bool rollup)
+{
+    char *expr = NULL;
+    int rc;
+
+    if (0 == strcmp(column, aggregate->value_column)) {
+        if (rollup) {
+            return rollup_value_expression(aggregate, column);
+        }
+        switch (aggregate->function) {
+        case ORCM_DB_AGG_COUNT:
+            rc = asprintf(&expr, "concat(count(%s)) as %s", column, column);
+            break;
+        case ORCM_DB_AGG_PERCENTILE:
+            rc = asprintf(&expr, "concat(percentile_cont(%f) within group "
+                          "(order by cast(%s as double precision))) as %s",
+                          aggregate->percentile, column, column);
+            break;
+        default:
+            rc = asprintf(&expr, "concat(%s(cast(%s as double precision))) as %s",
+                          aggregate_fn_strings[aggregate->function], column, column);
+            break;
+        }
+    } else if (NULL != aggregate->time_column && 0 == strcmp(column, aggregate->time_column)) {
+        if (0 < aggregate->interval) {
+            /* start of the bucket the sample falls in */
+            rc = asprintf(&expr, "concat(to_timestamp(floor(extract(epoch from "
+                          "cast(%s as timestamp)) / %u) * %u) at time zone 'UTC') as %s",
+                          column, aggregate->interval, aggregate->interval, column);
+        } else {
+            rc = asprintf(&expr, "concat(min(%s)) as %s", column, column);
+        }
+    } else if (is_group_column(aggregate, column)) {
+        rc = asprintf(&expr, "%s", column);
+    } else {
+        rc = asprintf(&expr, "cast('*' as text) as %s", column);
+    }
+    return (0 > rc) ? NULL : expr;
+}
+
+static bool append_to_query(char **query, const char *sep, const char *str)
+{
+    char *old_query = *query;
+    int rc = asprintf(query, "%s%s%s", old_query, sep, str);
+
+    free(old_query);
+    if (0 > rc) {
+        *query = NULL;
+        return false;
+    }
+    return true;
+}
+
+static char* build_aggregate_query(const char* view_name, opal_list_t* filters,
+                                   orcm_db_aggregate_t* aggregate, bool rollup)
+{
+    char *query = NULL;
+    char *expr = NULL;
+    char position[16];
+    orcm_db_filter_t *filter = NULL;
+    bool first_clause = true;
+    char **positions = NULL;
+    int num_columns;
+
+    if (NULL == view_name || 0 == strlen(view_name) || NULL == aggregate ||
+        NULL == aggregate->value_column || 0 == (num_columns = opal_argv_count(aggregate->columns)) ||
+        (ORCM_DB_AGG_PERCENTILE == aggregate->function &&
+         !(0.0 <= aggregate->percentile && 1.0 >= aggregate->percentile))) {
+        return NULL;
+    }
+
+    query = strdup("select ");
+    for (int i = 0; i < num_columns; ++i) {
+        if (NULL == (expr = aggregate_column_expression(aggregate, aggregate->columns[i],
+                                                        rollup)) ||
+            false == append_to_query(&query, (0 == i) ? "" : ", ", expr)) {
+            free(expr);
+            free(query);
+            return NULL;
+        }
+        free(expr);
+    }
+    if (false == append_to_query(&query, " from ", view_name)) {
+        return NULL;
+    }
+
+    if (NULL != filters) {
+        OPAL_LIST_FOREACH(filter, filters, orcm_db_filter_t) {
+            if (false == add_where_clauses(&query, filter, &first_clause)) {
+                free(query);
+                return NULL;
+            }
+        }
+    }
+    if (!rollup && ORCM_DB_AGG_COUNT != aggregate->function) {
+        if (false == append_to_query(&query, first_clause ? " where " : " and ",
+                                     aggregate->value_column) ||
+            false == append_to_query(&query, " ~ ", NUMERIC_VALUE_PATTERN)) {
+            return NULL;
+        }
+    }
+
+    /* group and order by output position so the expressions need not be repeated */
+    for (int i = 0; i < num_columns; ++i) {
+        bool bucketed = (NULL != aggregate->time_column && 0 < aggregate->interval &&
+                         0 == strcmp(aggregate->columns[i], aggregate->time_column));
+        if (bucketed || is_group_column(aggregate, aggregate->columns[i])) {
+            snprintf(position, sizeof(position), "%d", i + 1);
+            opal_argv_append_nosize(&positions, position);
+        }
+    }
+    if (NULL != positions) {
+        expr = opal_argv_join(positions, ',');
+        opal_argv_free(positions);
+        if (false == append_to_query(&query, " group by ", expr) ||
+            false == append_to_query(&query, " order by ", expr)) {
+            free(expr);
+            return NULL;
+        }
+        free(expr);
+    }
+
+    if (false == append_to_query(&query, "", ";")) {
+        return NULL;
+    }
+    return query;
+}
+
+char* build_aggregate_query_from_view_name_and_filters(const char* view_name,
+                                                       opal_list_t* filters,
+                                                       orcm_db_aggregate_t* aggregate)
+{
+    return build_aggregate_query(view_name, filters, aggregate, false);
+}
+
+/* Same result layout as the view query, read from a summary tier. The
+ * tier tables share the view's column names, so the filters apply as-is */
+char* build_rollup_query_from_filters(const orcm_db_rollup_tier_t* tier,
+                                      opal_list_t* filters,
+                                      orcm_db_aggregate_t* aggregate)
+{
+    if (NULL == tier || NULL == aggregate) {
+        return NULL;
+    }
+    return build_aggregate_query(tier->table, filters, aggregate, true);
+}
+
 bool is_supported_opal_int_type(opal_data_type_t type)
 {
     if(OPAL_BYTE == type || OPAL_BOOL == type || OPAL_SIZE == type || OPAL_PID == type ||
@@ -68,6 +68,33 @@ typedef struct {
 } orcm_db_filter_t;
 OBJ_CLASS_DECLARATION(orcm_db_filter_t);
 
+typedef enum {
+    ORCM_DB_AGG_MIN,
+    ORCM_DB_AGG_MAX,
+    ORCM_DB_AGG_AVG,
+    ORCM_DB_AGG_COUNT,
+    ORCM_DB_AGG_PERCENTILE
+} orcm_db_aggregate_fn_t;
+
+/*
+ * Describes how the rows selected by the filters of a fetch are to be
+ * reduced by the backend. The result has one row per group with the
+ * given columns in order: grouping columns are returned as-is, the
+ * time column holds the start of each time bucket, the value column
+ * holds the aggregate, and any other column is returned as "*".
+ */
+typedef struct {
+    opal_object_t super;
+    char **columns;                  /* output columns, in order */
+    char **group_by;                 /* subset of columns to group on */
+    char *time_column;               /* column bucketed by interval, or NULL */
+    uint32_t interval;               /* bucket width in seconds, 0 = one bucket */
+    char *value_column;              /* column the function is applied to */
+    orcm_db_aggregate_fn_t function;
+    double percentile;               /* 0.0-1.0, for ORCM_DB_AGG_PERCENTILE */
+} orcm_db_aggregate_t;
+OBJ_CLASS_DECLARATION(orcm_db_aggregate_t);
+
 /* callback function for async requests */
 typedef void (*orcm_db_callback_fn_t)(int dbhandle,
                                       int status,
@@ -268,6 +295,27 @@ typedef int (*orcm_db_base_module_fetch_fn_t)(struct orcm_db_base_module_t *imod
                                               opal_list_t *filters,
                                               opal_list_t *kvs);
 
+/*
+ * Retrieve aggregated data
+ *
+ * Same as fetch, except that the rows matching the filters are grouped
+ * and reduced by the backend as described by the aggregate, so only one
+ * row per group is returned in the result set. The aggregate must remain
+ * valid until the callback is invoked.
+ */
+typedef void (*orcm_db_base_API_fetch_aggregate_fn_t)(int dbhandle,
+                                                      const char* view,
+                                                      opal_list_t *filters,
+                                                      orcm_db_aggregate_t *aggregate,
+                                                      opal_list_t *kvs,
+                                                      orcm_db_callback_fn_t cbfunc,
+                                                      void *cbdata);
+typedef int (*orcm_db_base_module_fetch_aggregate_fn_t)(struct orcm_db_base_module_t *imod,
+                                                        const char* view,
+                                                        opal_list_t *filters,
+                                                        orcm_db_aggregate_t *aggregate,
+                                                        opal_list_t *kvs);
+
 /*
  * Get the number of rows returned in a result set (previously fetched from the
  * database).
@@ -332,6 +380,7 @@ struct orcm_db_base_module_t{
     orcm_db_base_module_commit_fn_t               commit;
     orcm_db_base_module_rollback_fn_t             rollback;
     orcm_db_base_module_fetch_fn_t                fetch;
+    orcm_db_base_module_fetch_aggregate_fn_t      fetch_aggregate;
     orcm_db_base_module_get_num_rows_fn_t         get_num_rows;
     orcm_db_base_module_get_next_row_fn_t         get_next_row;
     orcm_db_base_module_close_result_set_fn_t     close_result_set;
@@ -351,6 +400,7 @@ typedef struct {
     orcm_db_base_API_commit_fn_t               commit;
     orcm_db_base_API_rollback_fn_t             rollback;
     orcm_db_base_API_fetch_fn_t                fetch;
+    orcm_db_base_API_fetch_aggregate_fn_t      fetch_aggregate;
     orcm_db_base_API_get_num_rows_fn_t         get_num_rows;
     orcm_db_base_API_get_next_row_fn_t         get_next_row;
     orcm_db_base_API_close_result_set_fn_t     close_result_set;
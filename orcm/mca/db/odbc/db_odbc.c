@@ -78,6 +78,11 @@ static int odbc_fetch(struct orcm_db_base_module_t *imod,
                       const char* view,
                       opal_list_t *filters,
                       opal_list_t *output);
+static int odbc_fetch_aggregate(struct orcm_db_base_module_t *imod,
+                                const char* view,
+                                opal_list_t *filters,
+                                orcm_db_aggregate_t *aggregate,
+                                opal_list_t *output);
 static int odbc_get_num_rows(struct orcm_db_base_module_t *imod,
                              int rshandle,
                              int *num_rows);
@@ -122,6 +127,7 @@ mca_db_odbc_module_t mca_db_odbc_module = {
         odbc_commit,
         odbc_rollback,
         odbc_fetch,
+        odbc_fetch_aggregate,
         odbc_get_num_rows,
         odbc_get_next_row,
         odbc_close_result_set,
@@ -3856,6 +3862,44 @@ static bool tv_to_sql_timestamp(SQL_TIMESTAMP_STRUCT *sql_timestamp,
     opal_output(0, msg, ##__VA_ARGS__); \
     opal_output(0, "***********************************************");
 
+/* run a generated query and hand back a handle to its result set */
+static int odbc_fetch_query(mca_db_odbc_module_t *mod,
+                            const char *query,
+                            opal_list_t *kvs)
+{
+    SQLRETURN ret = SQL_SUCCESS;
+    SQLHSTMT stmt = SQL_NULL_HSTMT;
+    int handle = -1;
+    opal_value_t *result = NULL;
+
+    ret = SQLAllocHandle(SQL_HANDLE_STMT, mod->dbhandle, &stmt);
+    if (!(SQL_SUCCEEDED(ret))) {
+        ERR_MSG_FMT_FETCH("SQLAllocHandle returned %d for SQL_HANDLE_STMT handle creation (DB Handle=0x%016lx)!", ret, (size_t)mod->dbhandle);
+        return ORCM_ERROR;
+    }
+
+    ret = SQLExecDirect(stmt, (SQLCHAR *)query, SQL_NTS);
+    if (!(SQL_SUCCEEDED(ret))) {
+        ERR_MSG_FMT_FETCH("SQLExecDirect returned: %d", ret);
+        return ORCM_ERROR;
+    }
+
+    /* Add new results set handle */
+    handle = opal_pointer_array_add(mod->results_sets, (void*)stmt);
+    if(-1 == handle) {
+        ERR_MSG_FMT_FETCH("opal_pointer_array_add returned: %d", -1);
+        return ORCM_ERROR;
+    }
+
+    /* Create returned handle object */
+    result = OBJ_NEW(opal_value_t);
+    result->type = OPAL_INT;
+    result->data.integer = handle;
+    opal_list_append(kvs, (void*)result); /* takes ownership */
+
+    return ORCM_SUCCESS;
+}
+
 static int odbc_fetch(struct orcm_db_base_module_t *imod,
                       const char *view,
                       opal_list_t *filters,
@@ -3863,11 +3907,7 @@ static int odbc_fetch(struct orcm_db_base_module_t *imod,
 {
     mca_db_odbc_module_t *mod = (mca_db_odbc_module_t*)imod;
     int rc = ORCM_SUCCESS;
-    SQLRETURN ret = SQL_SUCCESS;
-    SQLHSTMT stmt = SQL_NULL_HSTMT;
     char *query = NULL;
-    int handle = -1;
-    opal_value_t *result = NULL;
 
 
     if(NULL == view || 0 == strlen(view)) {
@@ -3887,33 +3927,42 @@ static int odbc_fetch(struct orcm_db_base_module_t *imod,
         rc = ORCM_ERROR;
         goto cleanup_and_exit;
     }
-    ret = SQLAllocHandle(SQL_HANDLE_STMT, mod->dbhandle, &stmt);
-    if (!(SQL_SUCCEEDED(ret))) {
-        ERR_MSG_FMT_FETCH("SQLAllocHandle returned %d for SQL_HANDLE_STMT handle creation (DB Handle=0x%016lx)!", ret, (size_t)mod->dbhandle);
-        rc = ORCM_ERROR;
+    rc = odbc_fetch_query(mod, query, kvs);
+
+cleanup_and_exit:
+    free(query);
+    return rc;
+}
+
+static int odbc_fetch_aggregate(struct orcm_db_base_module_t *imod,
+                                const char *view,
+                                opal_list_t *filters,
+                                orcm_db_aggregate_t *aggregate,
+                                opal_list_t *kvs)
+{
+    mca_db_odbc_module_t *mod = (mca_db_odbc_module_t*)imod;
+    int rc = ORCM_SUCCESS;
+    char *query = NULL;
+
+    if(NULL == view || 0 == strlen(view)) {
+        ERR_MSG_FMT_FETCH("database view passed was empty of %s!", "NULL");
+        rc = ORCM_ERR_NOT_IMPLEMENTED;
         goto cleanup_and_exit;
     }
 
-    ret = SQLExecDirect(stmt, (SQLCHAR *)query, SQL_NTS);
-    if (!(SQL_SUCCEEDED(ret))) {
+    if(NULL == kvs) {
+        ERR_MSG_FMT_FETCH("Argument 'kvs' passed was NULL but was expected to be valid opal_list_t pointer: %d", 0);
         rc = ORCM_ERROR;
-        ERR_MSG_FMT_FETCH("SQLExecDirect returned: %d", ret);
         goto cleanup_and_exit;
     }
-
-    /* Add new results set handle */
-    handle = opal_pointer_array_add(mod->results_sets, (void*)stmt);
-    if(-1 == handle) {
-        rc = ORCM_ERROR;
-        ERR_MSG_FMT_FETCH("opal_pointer_array_add returned: %d", -1);
+    /* the grouping is done by the server so only one row per group comes back */
+    query = build_aggregate_query_from_view_name_and_filters(view, filters, aggregate);
+    if(NULL == query) {
+        ERR_MSG_FMT_FETCH("build_aggregate_query_from_view_name_and_filters returned: %s", "NULL");
+        rc = ORCM_ERR_BAD_PARAM;
         goto cleanup_and_exit;
     }
-
-    /* Create returned handle object */
-    result = OBJ_NEW(opal_value_t);
-    result->type = OPAL_INT;
-    result->data.integer = handle;
-    opal_list_append(kvs, (void*)result); /* takes ownership */
+    rc = odbc_fetch_query(mod, query, kvs);
 
 cleanup_and_exit:
     free(query);
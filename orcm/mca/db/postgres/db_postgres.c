@@ -27,6 +27,7 @@
 
 #include <sys/time.h>
 #include <time.h>
+#include <math.h>
 
 #include "opal_stdint.h"
 #include "opal/util/argv.h"
@@ -53,6 +54,8 @@
 #define ORCM_PG_MAX_LINE_LENGTH 4096
 #define STRING_MAX_LEN 1024
 #define TIMESTAMP_STR_LENGTH 40
+/* %f of DBL_MAX: 309 digits, sign, point and six decimals */
+#define REAL_STR_LENGTH 320
 
 extern bool is_supported_opal_int_type(opal_data_type_t type);
 extern bool tv_to_str_time_stamp(const struct timeval *time, char *tbuf,
@@ -88,6 +91,7 @@ static int postgres_rollback(struct orcm_db_base_module_t *imod);
 
 /* Internal helper functions */
 static void escape_string_apostrophe(char *str_src, char *str_dst);
+static const char *real_to_sql(double value, char *buf, size_t size);
 static int postgres_store_data_sample(mca_db_postgres_module_t *mod,
                                       opal_list_t *input,
                                       opal_list_t *ret);
@@ -108,11 +112,21 @@ static int postgres_store_event(mca_db_postgres_module_t *mod,
 static inline bool status_ok(PGresult *res);
 static inline bool is_fatal(PGresult *res);
 
+static void postgres_rollup_init(mca_db_postgres_module_t *mod);
+static int postgres_rollup_store(mca_db_postgres_module_t *mod, char **rows);
+static void postgres_maintain(mca_db_postgres_module_t *mod);
+
 static int postgres_fetch(struct orcm_db_base_module_t *imod,
                           const char *view,
                           opal_list_t *filters,
                           opal_list_t *output);
 
+static int postgres_fetch_aggregate(struct orcm_db_base_module_t *imod,
+                                    const char *view,
+                                    opal_list_t *filters,
+                                    orcm_db_aggregate_t *aggregate,
+                                    opal_list_t *output);
+
 static int postgres_get_num_rows(struct orcm_db_base_module_t *imod,
                                  int rshandle,
                                  int *num_rows);
@@ -136,6 +150,7 @@ mca_db_postgres_module_t mca_db_postgres_module = {
         postgres_commit,
         postgres_rollback,
         postgres_fetch,
+        postgres_fetch_aggregate,
         postgres_get_num_rows,
         postgres_get_next_row,
         postgres_close_result_set,
@@ -217,6 +232,14 @@ static int postgres_init(struct orcm_db_base_module_t *imod)
                         "db:postgres: Connection established to %s",
                         mod->dbname);
 
+    mod->last_maintenance = time(NULL);
+    if (orcm_db_base.rollup) {
+        postgres_rollup_init(mod);
+    }
+    if (mod->partition) {
+        orcm_db_postgres_partition_init(mod);
+    }
+
     return ORCM_SUCCESS;
 }
 
@@ -288,6 +311,17 @@ static int postgres_store(struct orcm_db_base_module_t *imod,
     return rc;
 }
 
+/* SQL literal for a real value - "nan" and "inf" from %f are not
+ * numbers to the server, so a non-finite sample goes in as NULL */
+static const char *real_to_sql(double value, char *buf, size_t size)
+{
+    if (!isfinite(value)) {
+        return "NULL";
+    }
+    snprintf(buf, size, "%f", value);
+    return buf;
+}
+
 static void escape_string_apostrophe(char *str_src, char *str_dst)
 {
     size_t i=0;
@@ -342,6 +376,7 @@ static int postgres_store_sample(struct orcm_db_base_module_t *imod,
     opal_value_t *hostname_item = NULL;
 
     char escaped_str[STRING_MAX_LEN];
+    char real_str[REAL_STR_LENGTH];
     char hostname[256];
     char time_stamp[TIMESTAMP_STR_LENGTH];
     char **data_item_parts=NULL;
@@ -483,14 +518,16 @@ static int postgres_store_sample(struct orcm_db_base_module_t *imod,
         case ORCM_DB_ITEM_REAL:
             if (NULL != units) {
                 asprintf(rows + i,
-                         "('%s','%s_%s','%s',NULL,%f,NULL,'%s',%d)",
+                         "('%s','%s_%s','%s',NULL,%s,NULL,'%s',%d)",
                          hostname, data_group, data_item, time_stamp,
-                         item.value.value_real, units, kv->type);
+                         real_to_sql(item.value.value_real, real_str,
+                                     sizeof(real_str)), units, kv->type);
             } else {
                 asprintf(rows + i,
-                         "('%s','%s_%s','%s',NULL,%f,NULL,NULL,%d)",
+                         "('%s','%s_%s','%s',NULL,%s,NULL,NULL,%d)",
                          hostname, data_group, data_item, time_stamp,
-                         item.value.value_real, kv->type);
+                         real_to_sql(item.value.value_real, real_str,
+                                     sizeof(real_str)), kv->type);
             }
             break;
         default: /* ORCM_DB_ITEM_INTEGER */
@@ -580,6 +617,7 @@ static int postgres_store_data_sample(mca_db_postgres_module_t *mod,
     opal_bitmap_t item_bm;
 
     char escaped_str[STRING_MAX_LEN];
+    char real_str[REAL_STR_LENGTH];
     char *hostname = NULL;
     char *data_group = NULL;
     char time_stamp[TIMESTAMP_STR_LENGTH];
@@ -590,6 +628,10 @@ static int postgres_store_data_sample(mca_db_postgres_module_t *mod,
 
     size_t num_items;
     char **rows = NULL;
+    char **rollup_rows = NULL;
+    char *rollup_row = NULL;
+    bool own_tran = false;
+    char *table = NULL;
     char *values = NULL;
     char *insert_stmt = NULL;
     size_t i, j;
@@ -685,9 +727,19 @@ static int postgres_store_data_sample(mca_db_postgres_module_t *mod,
         rows[i] = NULL;
     }
 
+    /* The partition is picked (and created if need be) before any
+     * transaction gets started */
+    table = orcm_db_postgres_partition_target(mod, time_stamp);
+    if (NULL == table) {
+        rc = ORCM_ERR_OUT_OF_RESOURCE;
+        ERR_MSG_STORE("Unable to allocate memory");
+        goto cleanup_and_exit;
+    }
+
     /* If we're not in auto commit mode, let's start a new transaction (if
-     * one hasn't already been started) */
-    if (!mod->tran_started && !mod->autocommit) {
+     * one hasn't already been started). The summaries have to go in along
+     * with the raw samples, so in auto commit mode they get one of their own */
+    if (!mod->tran_started && (!mod->autocommit || mod->rollup)) {
         res = PQexec(mod->conn, "begin");
         if (!status_ok(res)) {
             rc = ORCM_ERROR;
@@ -698,7 +750,11 @@ static int postgres_store_data_sample(mca_db_postgres_module_t *mod,
         }
         PQclear(res);
         res = NULL;
-        mod->tran_started = true;
+        if (mod->autocommit) {
+            own_tran = true;
+        } else {
+            mod->tran_started = true;
+        }
     }
 
     rc = add_event(mod, input, &item_bm, &event_id_once_added);
@@ -760,21 +816,36 @@ static int postgres_store_data_sample(mca_db_postgres_module_t *mod,
             }
             break;
         case ORCM_DB_ITEM_REAL:
+            /* a non-finite value has no place in a sum or extreme */
+            if (mod->rollup && isfinite(item.value.value_real)) {
+                asprintf(&rollup_row, "('%s','%s_%s','%s','%s',%f)",
+                         hostname, data_group, data_item,
+                         NULL != units ? units : "", time_stamp,
+                         item.value.value_real);
+            }
             if (NULL != units) {
                 asprintf(rows + j,
-                         "('%s','%s_%s','%s',NULL,%f,NULL,'%s',%d,%d,%lld)",
+                         "('%s','%s_%s','%s',NULL,%s,NULL,'%s',%d,%d,%lld)",
                          hostname, data_group, data_item, time_stamp,
-                         item.value.value_real, units, mv->value.type,
+                         real_to_sql(item.value.value_real, real_str,
+                                     sizeof(real_str)), units, mv->value.type,
                          mv->value.type, event_id_once_added);
             } else {
                 asprintf(rows + j,
-                         "('%s','%s_%s','%s',NULL,%f,NULL,NULL,%d,%d,%lld)",
+                         "('%s','%s_%s','%s',NULL,%s,NULL,NULL,%d,%d,%lld)",
                          hostname, data_group, data_item, time_stamp,
-                         item.value.value_real, mv->value.type,
+                         real_to_sql(item.value.value_real, real_str,
+                                     sizeof(real_str)), mv->value.type,
                          mv->value.type, event_id_once_added);
             }
             break;
         default: /* ORCM_DB_ITEM_INTEGER */
+            if (mod->rollup) {
+                asprintf(&rollup_row, "('%s','%s_%s','%s','%s',%lld)",
+                         hostname, data_group, data_item,
+                         NULL != units ? units : "", time_stamp,
+                         item.value.value_int);
+            }
             if (NULL != units) {
                 asprintf(rows + j,
                          "('%s','%s_%s','%s',%lld,NULL,NULL,'%s',%d,%d,%lld)",
@@ -789,6 +860,11 @@ static int postgres_store_data_sample(mca_db_postgres_module_t *mod,
                          event_id_once_added);
             }
         }
+        if (NULL != rollup_row) {
+            opal_argv_append_nosize(&rollup_rows, rollup_row);
+            free(rollup_row);
+            rollup_row = NULL;
+        }
         i++;
         j++;
     }
@@ -797,7 +873,7 @@ static int postgres_store_data_sample(mca_db_postgres_module_t *mod,
     opal_argv_free(rows);
     rows = NULL;
 
-    asprintf(&insert_stmt, "INSERT INTO data_sample_raw("
+    asprintf(&insert_stmt, "INSERT INTO %s("
                                 "hostname,"
                                 "data_item,"
                                 "time_stamp,"
@@ -808,7 +884,7 @@ static int postgres_store_data_sample(mca_db_postgres_module_t *mod,
                                 "data_type_id,"
                                 "app_value_type_id,"
                                 "event_id) "
-                           "VALUES %s", values);
+                           "VALUES %s", table, values);
     SAFEFREE(values);
 
     res = PQexec(mod->conn, insert_stmt);
@@ -821,17 +897,47 @@ static int postgres_store_data_sample(mca_db_postgres_module_t *mod,
     PQclear(res);
     res = NULL;
 
+    if (NULL != rollup_rows &&
+        ORCM_SUCCESS != (rc = postgres_rollup_store(mod, rollup_rows))) {
+        goto cleanup_and_exit;
+    }
+
+    if (own_tran) {
+        res = PQexec(mod->conn, "commit");
+        own_tran = false;
+        if (!status_ok(res)) {
+            rc = ORCM_ERROR;
+            ERR_MSG_FMT_STORE("Unable to commit transaction: %s",
+                              PQresultErrorMessage(res));
+            postgres_reconnect_if_needed(mod);
+            goto cleanup_and_exit;
+        }
+        PQclear(res);
+        res = NULL;
+    }
+
     opal_output_verbose(2, orcm_db_base_framework.framework_output,
                         "postgres_store_sample succeeded");
 
+    if (mod->autocommit) {
+        postgres_maintain(mod);
+    }
+
 cleanup_and_exit:
     if (NULL != res) {
         PQclear(res);
     }
+    if (own_tran) {
+        PQclear(PQexec(mod->conn, "rollback"));
+    }
     if (NULL != rows) {
         opal_argv_free(rows);
     }
+    if (NULL != rollup_rows) {
+        opal_argv_free(rollup_rows);
+    }
     SAFEFREE(insert_stmt);
+    SAFEFREE(table);
     OBJ_DESTRUCT(&item_bm);
     return rc;
 }
@@ -2252,6 +2358,8 @@ static int postgres_commit(struct orcm_db_base_module_t *imod)
 
     mod->tran_started = false;
 
+    postgres_maintain(mod);
+
     return ORCM_SUCCESS;
 }
 
@@ -2280,6 +2388,112 @@ static int postgres_rollback(struct orcm_db_base_module_t *imod)
     return ORCM_SUCCESS;
 }
 
+/* Summary tiers - see db_base_rollup.c. They are created on first use;
+ * if that fails the samples are still stored, just not summarized */
+static void postgres_rollup_init(mca_db_postgres_module_t *mod)
+{
+    PGresult *res;
+    char *ddl;
+    int i;
+
+    mod->rollup = true;
+    for (i = 0; i < ORCM_DB_ROLLUP_NUM_TIERS; i++) {
+        if (NULL == (ddl = orcm_db_base_rollup_table_ddl(&orcm_db_base_rollup_tiers[i]))) {
+            mod->rollup = false;
+            break;
+        }
+        res = PQexec(mod->conn, ddl);
+        free(ddl);
+        if (!status_ok(res)) {
+            opal_output(0, "db:postgres: Unable to create the %s summary table, "
+                        "samples will not be summarized: %s",
+                        orcm_db_base_rollup_tiers[i].name, PQresultErrorMessage(res));
+            PQclear(res);
+            mod->rollup = false;
+            break;
+        }
+        PQclear(res);
+    }
+}
+
+static int postgres_rollup_store(mca_db_postgres_module_t *mod, char **rows)
+{
+    PGresult *res;
+    char *values;
+    char *query;
+
+    values = opal_argv_join(rows, ',');
+    query = orcm_db_base_rollup_upsert(values);
+    SAFEFREE(values);
+    if (NULL == query) {
+        ERR_MSG_STORE("Unable to build the summary update");
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+
+    res = PQexec(mod->conn, query);
+    free(query);
+    if (!status_ok(res)) {
+        ERR_MSG_FMT_STORE("Unable to update the summaries: %s",
+                          PQresultErrorMessage(res));
+        PQclear(res);
+        postgres_reconnect_if_needed(mod);
+        return ORCM_ERROR;
+    }
+    PQclear(res);
+    return ORCM_SUCCESS;
+}
+
+static void postgres_rollup_expire(mca_db_postgres_module_t *mod,
+                                   const char *table, int retention)
+{
+    PGresult *res;
+    char *query;
+
+    if (NULL == (query = orcm_db_base_rollup_expire(table, retention))) {
+        return;
+    }
+    res = PQexec(mod->conn, query);
+    free(query);
+    if (!status_ok(res)) {
+        opal_output(0, "db:postgres: Unable to age out %s: %s",
+                    table, PQresultErrorMessage(res));
+        postgres_reconnect_if_needed(mod);
+    } else {
+        opal_output_verbose(5, orcm_db_base_framework.framework_output,
+                            "db:postgres: aged out %s rows of %s",
+                            PQcmdTuples(res), table);
+    }
+    PQclear(res);
+}
+
+/* Age out raw samples and summaries. Runs between transactions, at most
+ * once per maintenance period. Partitioned raw samples go a whole
+ * partition at a time instead of row by row */
+static void postgres_maintain(mca_db_postgres_module_t *mod)
+{
+    time_t now = time(NULL);
+    int i;
+
+    if ((!mod->rollup && !mod->partition) || mod->tran_started ||
+        now - mod->last_maintenance < orcm_db_base.maintenance_interval) {
+        return;
+    }
+    mod->last_maintenance = now;
+
+    if (mod->partition) {
+        orcm_db_postgres_partition_maintain(mod, orcm_db_base.raw_retention);
+        orcm_db_postgres_partition_report(mod);
+    } else {
+        postgres_rollup_expire(mod, "data_sample_raw", orcm_db_base.raw_retention);
+    }
+    if (mod->rollup) {
+        for (i = 0; i < ORCM_DB_ROLLUP_NUM_TIERS; i++) {
+            postgres_rollup_expire(mod, orcm_db_base_rollup_tiers[i].table,
+                                   orcm_db_base_rollup_tiers[i].retention);
+        }
+    }
+}
+
 static inline bool status_ok(PGresult *res)
 {
     ExecStatusType status = PQresultStatus(res);
@@ -2405,6 +2619,51 @@ static opal_data_type_t get_opal_type_from_postgres_type(Oid pg_type)
 #define NO_ROWS     (-1)
 #define NO_COLUMN   NO_ROWS
 
+/* run a generated query and hand back a handle to its result set */
+static int postgres_fetch_query(mca_db_postgres_module_t *mod,
+                                const char *query,
+                                opal_list_t *kvs)
+{
+    PGresult *results = NULL;
+    int handle = -1;
+    opal_value_t *result = NULL;
+
+    results = PQexec(mod->conn, query);
+    if(!status_ok(results)) {
+        ERR_MSG_FMT_FETCH("PQexec returned: %s", "NULL");
+        postgres_reconnect_if_needed(mod);
+        return ORCM_ERROR;
+    }
+
+    /* Add new results set handle */
+    handle = opal_pointer_array_add(mod->results_sets, (void*)results);
+    if(0 > handle) {
+        ERR_MSG_FMT_FETCH("opal_pointer_array_add returned: %d", handle);
+        return ORCM_ERROR;
+    }
+    mod->current_row = 0; /* Simulate 'get_next_row' functionality. */
+
+    /* Create returned handle object */
+    result = OBJ_NEW(opal_value_t);
+    result->type = OPAL_INT;
+    result->data.integer = handle;
+    opal_list_append(kvs, (void*)result); /* takes ownership */
+
+    return ORCM_SUCCESS;
+}
+
+/* What to select from for a view: the partition statistics aren't a real
+ * view, and reads of the samples are narrowed to the partitions in range */
+static char* postgres_fetch_source(mca_db_postgres_module_t *mod,
+                                   const char *view,
+                                   opal_list_t *filters)
+{
+    if (0 == strcmp(view, ORCM_DB_PG_PARTITION_STATS_VIEW)) {
+        return orcm_db_postgres_partition_stats_source();
+    }
+    return orcm_db_postgres_partition_source(mod, view, filters);
+}
+
 static int postgres_fetch(struct orcm_db_base_module_t *imod,
                          const char *view,
                          opal_list_t *filters,
@@ -2412,10 +2671,8 @@ static int postgres_fetch(struct orcm_db_base_module_t *imod,
 {
     mca_db_postgres_module_t *mod = (mca_db_postgres_module_t*)imod;
     int rc = ORCM_SUCCESS;
-    PGresult *results = NULL;
-    int handle = -1;
-    opal_value_t *result = NULL;
     char* query = NULL;
+    char* source = NULL;
 
     if(NULL == view || 0 == strlen(view)) {
         ERR_MSG_FMT_FETCH("database view passed was %s or empty!", "NULL");
@@ -2427,36 +2684,64 @@ static int postgres_fetch(struct orcm_db_base_module_t *imod,
         rc = ORCM_ERROR;
         goto cleanup_and_exit;
     }
-    query = build_query_from_view_name_and_filters(view, filters);
+    source = postgres_fetch_source(mod, view, filters);
+    query = build_query_from_view_name_and_filters(NULL != source ? source : view, filters);
     if(NULL == query) {
         ERR_MSG_FMT_FETCH("build_query_from_view_name_and_filters returned: %s", "NULL");
         rc = ORCM_ERROR;
         goto cleanup_and_exit;
     }
-    results = PQexec(mod->conn, query);
-    if(!status_ok(results)) {
-        ERR_MSG_FMT_FETCH("PQexec returned: %s", "NULL");
-        rc = ORCM_ERROR;
-        postgres_reconnect_if_needed(mod);
-        goto cleanup_and_exit;
+    rc = postgres_fetch_query(mod, query, kvs);
+
+cleanup_and_exit:
+    SAFEFREE(source);
+    SAFEFREE(query);
+    return rc;
+}
+
+static int postgres_fetch_aggregate(struct orcm_db_base_module_t *imod,
+                                    const char *view,
+                                    opal_list_t *filters,
+                                    orcm_db_aggregate_t *aggregate,
+                                    opal_list_t *kvs)
+{
+    mca_db_postgres_module_t *mod = (mca_db_postgres_module_t*)imod;
+    const orcm_db_rollup_tier_t *tier;
+    int rc = ORCM_SUCCESS;
+    char* query = NULL;
+    char* source = NULL;
+
+    if(NULL == view || 0 == strlen(view)) {
+        ERR_MSG_FMT_FETCH("database view passed was %s or empty!", "NULL");
+        return ORCM_ERR_NOT_IMPLEMENTED;
     }
 
-    /* Add new results set handle */
-    handle = opal_pointer_array_add(mod->results_sets, (void*)results);
-    if(0 > handle) {
+    if(NULL == kvs) {
+        ERR_MSG_FMT_FETCH("Argument 'kvs' passed was NULL but was expected to be valid opal_list_t pointer: %d", 0);
         rc = ORCM_ERROR;
-        ERR_MSG_FMT_FETCH("opal_pointer_array_add returned: %d", handle);
         goto cleanup_and_exit;
     }
-    mod->current_row = 0; /* Simulate 'get_next_row' functionality. */
-
-    /* Create returned handle object */
-    result = OBJ_NEW(opal_value_t);
-    result->type = OPAL_INT;
-    result->data.integer = handle;
-    opal_list_append(kvs, (void*)result); /* takes ownership */
+    /* the grouping is done by the server so only one row per group comes
+     * back, and coarse buckets are read from the summaries when possible */
+    if (mod->rollup &&
+        NULL != (tier = orcm_db_base_rollup_select(view, filters, aggregate, time(NULL)))) {
+        opal_output_verbose(5, orcm_db_base_framework.framework_output,
+                            "db:postgres: answering the aggregate from %s", tier->table);
+        query = build_rollup_query_from_filters(tier, filters, aggregate);
+    } else {
+        source = postgres_fetch_source(mod, view, filters);
+        query = build_aggregate_query_from_view_name_and_filters(NULL != source ? source : view,
+                                                                 filters, aggregate);
+    }
+    if(NULL == query) {
+        ERR_MSG_FMT_FETCH("build_aggregate_query_from_view_name_and_filters returned: %s", "NULL");
+        rc = ORCM_ERR_BAD_PARAM;
+        goto cleanup_and_exit;
+    }
+    rc = postgres_fetch_query(mod, query, kvs);
 
 cleanup_and_exit:
+    SAFEFREE(source);
     SAFEFREE(query);
     return rc;
 }
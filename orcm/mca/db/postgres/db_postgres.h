@@ -29,6 +29,16 @@ typedef enum {
     ORCM_DB_PG_STMT_NUM_STMTS
 } orcm_db_postgres_prepared_statement_t;
 
+/* span of one data_sample_raw partition */
+typedef enum {
+    ORCM_DB_PG_PARTITION_HOUR,
+    ORCM_DB_PG_PARTITION_DAY,
+    ORCM_DB_PG_PARTITION_MONTH
+} orcm_db_pg_partition_unit_t;
+
+/* pseudo-view listing the partitions with their row counts */
+#define ORCM_DB_PG_PARTITION_STATS_VIEW "data_sample_raw_partitions"
+
 typedef struct {
     orcm_db_base_module_t api;
     char *pguri;
@@ -42,9 +52,29 @@ typedef struct {
     bool prepared[ORCM_DB_PG_STMT_NUM_STMTS];
     opal_pointer_array_t *results_sets;
     int current_row;
+    bool rollup;
+    time_t last_maintenance;
+    bool partition;
+    orcm_db_pg_partition_unit_t partition_unit;
+    int partition_ahead;
+    time_t partition_first;     /* partitions in [first, end) are known to exist */
+    time_t partition_end;
+    time_t partition_late;      /* last partition before first tried for a late sample */
+    bool partition_late_ok;     /* ... and whether it exists */
 } mca_db_postgres_module_t;
 ORCM_MODULE_DECLSPEC extern mca_db_postgres_module_t mca_db_postgres_module;
 
+/* partition management - db_postgres_partition.c */
+int orcm_db_postgres_partition_init(mca_db_postgres_module_t *mod);
+char* orcm_db_postgres_partition_target(mca_db_postgres_module_t *mod,
+                                        const char *time_stamp);
+void orcm_db_postgres_partition_maintain(mca_db_postgres_module_t *mod, int retention);
+char* orcm_db_postgres_partition_source(mca_db_postgres_module_t *mod,
+                                        const char *view,
+                                        opal_list_t *filters);
+char* orcm_db_postgres_partition_stats_source(void);
+void orcm_db_postgres_partition_report(mca_db_postgres_module_t *mod);
+
 END_C_DECLS
 
 #endif /* ORCM_DB_POSTGRES_H */
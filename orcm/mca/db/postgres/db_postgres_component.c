@@ -16,8 +16,11 @@
 #include "orcm_config.h"
 #include "orcm/constants.h"
 
+#include <strings.h>
+
 #include "opal/mca/base/base.h"
 #include "opal/mca/base/mca_base_var.h"
+#include "opal/util/output.h"
 
 #include "orte/mca/errmgr/errmgr.h"
 
@@ -65,6 +68,9 @@ static char *pgtty;
 static char *dbname;
 static char *user;
 static bool autocommit;
+static bool partition;
+static char *partition_interval;
+static int partition_ahead;
 
 static int component_register(void) {
     mca_base_component_t *c = &mca_db_postgres_component.base_version;
@@ -123,6 +129,32 @@ static int component_register(void) {
                                           MCA_BASE_VAR_SCOPE_READONLY,
                                           &autocommit);
 
+    /* time-range partitioning of the raw samples */
+    partition = false;
+    (void)mca_base_component_var_register(c, "partition",
+                                          "Store the raw sensor samples in time-range "
+                                          "partitions of data_sample_raw",
+                                          MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                          OPAL_INFO_LVL_9,
+                                          MCA_BASE_VAR_SCOPE_READONLY,
+                                          &partition);
+
+    partition_interval = "day";
+    (void)mca_base_component_var_register(c, "partition_interval",
+                                          "Time span of one partition: hour, day or month",
+                                          MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                          OPAL_INFO_LVL_9,
+                                          MCA_BASE_VAR_SCOPE_READONLY,
+                                          &partition_interval);
+
+    partition_ahead = 2;
+    (void)mca_base_component_var_register(c, "partition_ahead",
+                                          "Number of partitions to create ahead of the current one",
+                                          MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                          OPAL_INFO_LVL_9,
+                                          MCA_BASE_VAR_SCOPE_READONLY,
+                                          &partition_ahead);
+
     return ORCM_SUCCESS;
 }
 
@@ -150,6 +182,19 @@ static orcm_db_base_module_t *component_create(opal_list_t *props)
     /* assume default value first, then check for provided properties */
     mod->autocommit = autocommit;
     mod->tran_started = false;
+    mod->partition = partition;
+    mod->partition_ahead = (0 > partition_ahead) ? 0 : partition_ahead;
+    if (NULL == partition_interval || 0 == strcasecmp(partition_interval, "day")) {
+        mod->partition_unit = ORCM_DB_PG_PARTITION_DAY;
+    } else if (0 == strcasecmp(partition_interval, "hour")) {
+        mod->partition_unit = ORCM_DB_PG_PARTITION_HOUR;
+    } else if (0 == strcasecmp(partition_interval, "month")) {
+        mod->partition_unit = ORCM_DB_PG_PARTITION_MONTH;
+    } else {
+        opal_output(0, "db:postgres: Unknown partition interval %s, using day",
+                    partition_interval);
+        mod->partition_unit = ORCM_DB_PG_PARTITION_DAY;
+    }
 
     /* if the props include db info, then use it */
     if (NULL != props) {
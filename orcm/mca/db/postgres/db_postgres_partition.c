@@ -0,0 +1,427 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Time-range partitions of data_sample_raw. Each partition is a child
+ * table inheriting from data_sample_raw with a CHECK constraint on its
+ * time range, named the same way as the partitions made by
+ * contrib/database/pg_partition_helper.py (data_sample_raw_<YYYYMMDD>_time_stamp
+ * for daily ones). Partitions are created ahead of time between
+ * transactions, samples are inserted straight into the one covering
+ * their time stamp, and retention drops whole partitions. Readers keep
+ * going through data_sample_raw, where the planner skips the partitions
+ * whose constraint rules them out.
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "opal/util/output.h"
+
+#include "orcm/mca/db/base/base.h"
+#include "db_postgres.h"
+
+/* No need to include the entire header for one function. */
+extern int asprintf(char** new_str, const char* format,...);
+
+#define PARTITION_PARENT "data_sample_raw"
+#define PARTITION_COLUMN "time_stamp"
+#define PARTITION_NAME_MAX 64
+
+/* strftime() mask of the partition names, one per unit */
+static const char *partition_masks[] = {
+    "%Y%m%d%H",
+    "%Y%m%d",
+    "%Y%m"
+};
+
+static bool query_ok(PGresult *res)
+{
+    ExecStatusType status = PQresultStatus(res);
+    return (PGRES_COMMAND_OK == status || PGRES_TUPLES_OK == status);
+}
+
+static bool exec_ok(mca_db_postgres_module_t *mod, const char *query)
+{
+    PGresult *res = PQexec(mod->conn, query);
+    bool ok = query_ok(res);
+
+    if (!ok) {
+        opal_output(0, "db:postgres: partition maintenance failed: %s",
+                    PQresultErrorMessage(res));
+    }
+    PQclear(res);
+    return ok;
+}
+
+/* start of the partition holding the given (local) time */
+static time_t partition_start(orcm_db_pg_partition_unit_t unit, time_t when)
+{
+    struct tm tm;
+
+    localtime_r(&when, &tm);
+    tm.tm_sec = 0;
+    tm.tm_min = 0;
+    if (ORCM_DB_PG_PARTITION_HOUR != unit) {
+        tm.tm_hour = 0;
+    }
+    if (ORCM_DB_PG_PARTITION_MONTH == unit) {
+        tm.tm_mday = 1;
+    }
+    tm.tm_isdst = -1;
+    return mktime(&tm);
+}
+
+static time_t partition_next(orcm_db_pg_partition_unit_t unit, time_t start)
+{
+    struct tm tm;
+
+    localtime_r(&start, &tm);
+    switch (unit) {
+    case ORCM_DB_PG_PARTITION_HOUR:
+        tm.tm_hour++;
+        break;
+    case ORCM_DB_PG_PARTITION_MONTH:
+        tm.tm_mon++;
+        break;
+    default:
+        tm.tm_mday++;
+        break;
+    }
+    tm.tm_isdst = -1;
+    return mktime(&tm);
+}
+
+static void partition_name(orcm_db_pg_partition_unit_t unit, time_t start,
+                           char *name, size_t size)
+{
+    char suffix[16];
+    struct tm tm;
+
+    localtime_r(&start, &tm);
+    strftime(suffix, sizeof(suffix), partition_masks[unit], &tm);
+    snprintf(name, size, "%s_%s_%s", PARTITION_PARENT, suffix, PARTITION_COLUMN);
+}
+
+/* inverse of partition_name(): false if the table isn't one of ours */
+static bool partition_name_to_start(orcm_db_pg_partition_unit_t unit, const char *name,
+                                    time_t *start)
+{
+    const char *suffix = name + strlen(PARTITION_PARENT) + 1;
+    /* %Y takes four digits, every other field two */
+    size_t digits = (ORCM_DB_PG_PARTITION_HOUR == unit) ? 10 :
+                    (ORCM_DB_PG_PARTITION_DAY == unit) ? 8 : 6;
+    struct tm tm;
+    char *end;
+
+    if (strlen(name) != strlen(PARTITION_PARENT) + 1 + digits + 1 + strlen(PARTITION_COLUMN) ||
+        0 != strncmp(name, PARTITION_PARENT "_", strlen(PARTITION_PARENT) + 1) ||
+        0 != strcmp(suffix + digits + 1, PARTITION_COLUMN)) {
+        return false;
+    }
+    memset(&tm, 0, sizeof(tm));
+    end = strptime(suffix, partition_masks[unit], &tm);
+    if (NULL == end || end != suffix + digits) {
+        return false;
+    }
+    if (ORCM_DB_PG_PARTITION_MONTH == unit) {
+        tm.tm_mday = 1;
+    }
+    tm.tm_isdst = -1;
+    *start = mktime(&tm);
+    return true;
+}
+
+/* The time stamps are local wall-clock times, and so are the partition
+ * bounds - let mktime() work out daylight saving time on its own */
+static bool time_stamp_parse(const char *time_stamp, time_t *when)
+{
+    struct tm tm;
+
+    memset(&tm, 0, sizeof(tm));
+    if (NULL == time_stamp || NULL == strptime(time_stamp, "%Y-%m-%d %H:%M:%S", &tm)) {
+        return false;
+    }
+    tm.tm_isdst = -1;
+    *when = mktime(&tm);
+    return true;
+}
+
+static void time_stamp_str(time_t when, char *buffer, size_t size)
+{
+    struct tm tm;
+
+    localtime_r(&when, &tm);
+    strftime(buffer, size, "%Y-%m-%d %H:%M:%S", &tm);
+}
+
+static bool partition_create(mca_db_postgres_module_t *mod, time_t start)
+{
+    char name[PARTITION_NAME_MAX];
+    char from[32], to[32];
+    char *ddl = NULL;
+    bool ok;
+
+    partition_name(mod->partition_unit, start, name, sizeof(name));
+    time_stamp_str(start, from, sizeof(from));
+    time_stamp_str(partition_next(mod->partition_unit, start), to, sizeof(to));
+    if (0 > asprintf(&ddl, "create table if not exists %s ("
+                     "check (" PARTITION_COLUMN " >= timestamp '%s' and "
+                     PARTITION_COLUMN " < timestamp '%s')) "
+                     "inherits (" PARTITION_PARENT "); "
+                     "create index if not exists index_%s on %s (" PARTITION_COLUMN ");",
+                     name, from, to, name, name)) {
+        return false;
+    }
+    ok = exec_ok(mod, ddl);
+    free(ddl);
+    return ok;
+}
+
+/* make sure the partitions from the one holding 'when' up to the
+ * configured number ahead of it all exist */
+static bool partition_create_ahead(mca_db_postgres_module_t *mod, time_t when)
+{
+    time_t start = partition_start(mod->partition_unit, when);
+    time_t first = start;
+    int i;
+
+    for (i = 0; i <= mod->partition_ahead; i++) {
+        if (!partition_create(mod, start)) {
+            return false;
+        }
+        start = partition_next(mod->partition_unit, start);
+    }
+    if (mod->partition_end <= first || first < mod->partition_first) {
+        mod->partition_first = first;
+    }
+    mod->partition_end = start;
+    return true;
+}
+
+int orcm_db_postgres_partition_init(mca_db_postgres_module_t *mod)
+{
+    mod->partition_first = 0;
+    mod->partition_end = 0;
+    mod->partition_late = 0;
+    mod->partition_late_ok = false;
+    if (!partition_create_ahead(mod, time(NULL))) {
+        opal_output(0, "db:postgres: Unable to create the %s partitions, "
+                    "samples will go to the table itself", PARTITION_PARENT);
+        mod->partition = false;
+        return ORCM_ERROR;
+    }
+    return ORCM_SUCCESS;
+}
+
+/* The table a batch of samples with the given time stamp goes into.
+ * Partitions are only created outside of a transaction, so that a
+ * rollback can't take one away behind our back; anything that has no
+ * partition yet goes to the parent table */
+char* orcm_db_postgres_partition_target(mca_db_postgres_module_t *mod,
+                                        const char *time_stamp)
+{
+    char name[PARTITION_NAME_MAX];
+    time_t when, start;
+
+    if (!mod->partition || !time_stamp_parse(time_stamp, &when)) {
+        return strdup(PARTITION_PARENT);
+    }
+    start = partition_start(mod->partition_unit, when);
+    if (start < mod->partition_first || start >= mod->partition_end) {
+        if (mod->tran_started) {
+            return strdup(PARTITION_PARENT);
+        }
+        if (start >= mod->partition_end) {
+            /* time moved on - roll the window of ready partitions forward */
+            if (!partition_create_ahead(mod, when)) {
+                return strdup(PARTITION_PARENT);
+            }
+        } else {
+            /* a late sample for an old partition - they come in runs
+             * from a lagging node, so the DDL is only tried once for each */
+            if (0 == mod->partition_late || start != mod->partition_late) {
+                mod->partition_late = start;
+                mod->partition_late_ok = partition_create(mod, start);
+            }
+            if (!mod->partition_late_ok) {
+                return strdup(PARTITION_PARENT);
+            }
+        }
+    }
+    partition_name(mod->partition_unit, start, name, sizeof(name));
+    return strdup(name);
+}
+
+static PGresult* partition_list(mca_db_postgres_module_t *mod)
+{
+    PGresult *res;
+
+    res = PQexec(mod->conn, "select c.relname from pg_inherits i "
+                 "join pg_class c on c.oid = i.inhrelid "
+                 "join pg_class p on p.oid = i.inhparent "
+                 "where p.relname = '" PARTITION_PARENT "' order by 1;");
+    if (!query_ok(res)) {
+        opal_output(0, "db:postgres: Unable to list the %s partitions: %s",
+                    PARTITION_PARENT, PQresultErrorMessage(res));
+        PQclear(res);
+        return NULL;
+    }
+    return res;
+}
+
+/* Keep the partitions ahead of time ready, then detach and drop every
+ * partition that ends before the retention cutoff. Detaching first takes
+ * the partition out of queries right away, and the drop then costs no
+ * more than removing its files */
+void orcm_db_postgres_partition_maintain(mca_db_postgres_module_t *mod, int retention)
+{
+    PGresult *res;
+    const char *name;
+    char *ddl;
+    time_t cutoff, start;
+    int i, dropped = 0;
+
+    if (!mod->partition) {
+        return;
+    }
+    (void)partition_create_ahead(mod, time(NULL));
+    /* the late partition may be dropped below, or worth another try */
+    mod->partition_late = 0;
+    if (0 >= retention || NULL == (res = partition_list(mod))) {
+        return;
+    }
+    cutoff = time(NULL) - (time_t)retention * 86400;
+    for (i = 0; i < PQntuples(res); i++) {
+        name = PQgetvalue(res, i, 0);
+        if (!partition_name_to_start(mod->partition_unit, name, &start) ||
+            partition_next(mod->partition_unit, start) > cutoff) {
+            continue;
+        }
+        ddl = NULL;
+        if (0 > asprintf(&ddl, "alter table %s no inherit " PARTITION_PARENT "; "
+                         "drop table %s;", name, name)) {
+            break;
+        }
+        if (exec_ok(mod, ddl)) {
+            dropped++;
+        }
+        free(ddl);
+    }
+    PQclear(res);
+    if (mod->partition_first < cutoff) {
+        mod->partition_first = partition_start(mod->partition_unit, cutoff);
+    }
+    opal_output_verbose(5, orcm_db_base_framework.framework_output,
+                        "db:postgres: dropped %d expired partitions of %s",
+                        dropped, PARTITION_PARENT);
+}
+
+/* Same columns as data_sensors_view, whose time_stamp is text and so of
+ * no use to the planner: the time filters are repeated on the timestamp
+ * itself, widened to whole partitions, so the ones outside the range are
+ * skipped. The view's own filters still give the exact result */
+char* orcm_db_postgres_partition_source(mca_db_postgres_module_t *mod,
+                                        const char *view,
+                                        opal_list_t *filters)
+{
+    orcm_db_filter_t *filter;
+    time_t when, lower = 0, upper = 0;
+    char from[32], to[32];
+    char *range = NULL;
+    char *source = NULL;
+    int rc;
+
+    if (!mod->partition || NULL == view || 0 != strcmp(view, "data_sensors_view") ||
+        NULL == filters) {
+        return NULL;
+    }
+    OPAL_LIST_FOREACH(filter, filters, orcm_db_filter_t) {
+        if (NULL == filter->value.key || 0 != strcmp(filter->value.key, PARTITION_COLUMN) ||
+            OPAL_STRING != filter->value.type ||
+            !time_stamp_parse(filter->value.data.string, &when)) {
+            continue;
+        }
+        if (GT == filter->op || GE == filter->op) {
+            lower = partition_start(mod->partition_unit, when);
+        } else if (LT == filter->op || LE == filter->op) {
+            upper = partition_next(mod->partition_unit,
+                                   partition_start(mod->partition_unit, when));
+        }
+    }
+    if (0 == lower && 0 == upper) {
+        return NULL;
+    }
+
+    time_stamp_str(lower, from, sizeof(from));
+    time_stamp_str(upper, to, sizeof(to));
+    if (0 != lower && 0 != upper) {
+        rc = asprintf(&range, PARTITION_COLUMN " >= timestamp '%s' and "
+                      PARTITION_COLUMN " < timestamp '%s'", from, to);
+    } else if (0 != lower) {
+        rc = asprintf(&range, PARTITION_COLUMN " >= timestamp '%s'", from);
+    } else {
+        rc = asprintf(&range, PARTITION_COLUMN " < timestamp '%s'", to);
+    }
+    if (0 > rc) {
+        return NULL;
+    }
+    rc = asprintf(&source, "(select hostname, data_item, concat(time_stamp) as time_stamp, "
+                  "concat(value_int, value_real, value_str) as value_str, units "
+                  "from " PARTITION_PARENT " where %s) as %s", range, view);
+    free(range);
+    return (0 > rc) ? NULL : source;
+}
+
+/* Row counts and sizes of every partition for capacity planning, as
+ * something that can be fetched like any view */
+char* orcm_db_postgres_partition_stats_source(void)
+{
+    return strdup("(select c.relname as partition, "
+                  "concat(coalesce(s.n_live_tup, cast(c.reltuples as bigint))) as row_count, "
+                  "concat(pg_total_relation_size(c.oid)) as total_bytes "
+                  "from pg_inherits i "
+                  "join pg_class c on c.oid = i.inhrelid "
+                  "join pg_class p on p.oid = i.inhparent "
+                  "left join pg_stat_user_tables s on s.relid = c.oid "
+                  "where p.relname = '" PARTITION_PARENT "') as "
+                  ORCM_DB_PG_PARTITION_STATS_VIEW);
+}
+
+void orcm_db_postgres_partition_report(mca_db_postgres_module_t *mod)
+{
+    PGresult *res;
+    char *query = NULL;
+    char *source;
+    int i;
+
+    if (!mod->partition || 5 > opal_output_get_verbosity(orcm_db_base_framework.framework_output) ||
+        NULL == (source = orcm_db_postgres_partition_stats_source())) {
+        return;
+    }
+    if (0 > asprintf(&query, "select * from %s order by 1;", source)) {
+        free(source);
+        return;
+    }
+    free(source);
+    res = PQexec(mod->conn, query);
+    free(query);
+    if (query_ok(res)) {
+        for (i = 0; i < PQntuples(res); i++) {
+            opal_output(0, "db:postgres: partition %s holds %s rows in %s bytes",
+                        PQgetvalue(res, i, 0), PQgetvalue(res, i, 1), PQgetvalue(res, i, 2));
+        }
+    }
+    PQclear(res);
+}
@@ -92,5 +92,73 @@ opal_list_t* orcm_diag_base_prepare_db_input(struct timeval start_time,
 
 void orcm_diag_base_db_cleanup(int db_handle, int status, opal_list_t *list,
                                opal_list_t *ret, void *cbdata);
+
+/*
+ * Parallel execution engine shared by the diagnostics
+ *
+ * The engine keeps one worker thread bound to each PU of the node. A
+ * run hands every worker the list of tests; tests that only need the
+ * cpus are run together, each worker starting at a different test,
+ * while tests marked exclusive (memory bandwidth) get the whole node
+ * to themselves one after another. When a run asks for memory, it is
+ * carved into one buffer per NUMA node and each worker first-touches
+ * its own slice so that all of its traffic stays local.
+ */
+typedef struct {
+    int id;
+    int nworkers;
+    /* logical index of the NUMA node the worker is bound to */
+    int numa_node;
+    /* this worker's slice of its NUMA node's buffer */
+    void *mem;
+    size_t mem_len;
+    /* filled in by the test for the engine to total up */
+    uint64_t bytes;
+    uint64_t flops;
+    int errors;
+} orcm_diag_engine_worker_t;
+
+/* run one test on one worker - anything other than ORCM_SUCCESS
+ * counts as a failure on that worker */
+typedef int (*orcm_diag_engine_fn_t)(orcm_diag_engine_worker_t *worker, void *arg);
+
+typedef struct {
+    const char *name;
+    orcm_diag_engine_fn_t fn;
+    void *arg;
+    /* needs the node to itself */
+    bool exclusive;
+    /* results */
+    int errors;
+    double seconds;
+    uint64_t bytes;
+    uint64_t flops;
+} orcm_diag_engine_test_t;
+
+#define ORCM_DIAG_ENGINE_GBPS(t)   \
+    ((0.0 < (t)->seconds) ? (double)(t)->bytes / (t)->seconds / 1.0e9 : 0.0)
+#define ORCM_DIAG_ENGINE_GFLOPS(t) \
+    ((0.0 < (t)->seconds) ? (double)(t)->flops / (t)->seconds / 1.0e9 : 0.0)
+
+/**
+ * Run a set of tests across the node
+ *
+ * @param[in,out] tests - the tests to run, results are filled in
+ * @param[in] ntests - number of tests
+ * @param[in,out] mem - bytes of memory to spread over the workers (NULL
+ *                      for none), set to the bytes actually tested
+ *
+ * @retval ORCM_SUCCESS all tests were run - check each test for errors
+ * @retval ORCM_ERR_OUT_OF_RESOURCE the workers could not be set up
+ * @retval ORCM_ERR_FAILED_TO_MAP memory could not be mapped for every worker
+ */
+ORCM_DECLSPEC int orcm_diag_engine_run(orcm_diag_engine_test_t *tests, int ntests,
+                                       size_t *mem);
+
+/* number of workers a run will use */
+ORCM_DECLSPEC int orcm_diag_engine_num_workers(void);
+
+/* stop the workers */
+ORCM_DECLSPEC void orcm_diag_engine_finalize(void);
 END_C_DECLS
 #endif
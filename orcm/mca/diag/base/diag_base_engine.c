@@ -0,0 +1,440 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#include <errno.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif  /* HAVE_UNISTD_H */
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif  /* HAVE_STRING_H */
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "opal/util/output.h"
+#include "opal/mca/hwloc/hwloc.h"
+#include "opal/mca/hwloc/base/base.h"
+
+#include "orte/mca/errmgr/errmgr.h"
+#include "orte/util/name_fns.h"
+
+#include "orcm/mca/diag/base/base.h"
+
+typedef struct {
+    orcm_diag_engine_worker_t w;
+    pthread_t thread;
+    /* generation of the last job this worker picked up */
+    unsigned int seen;
+} engine_worker_t;
+
+typedef struct {
+    bool started;
+    int nworkers;
+    int nnodes;
+    engine_worker_t *workers;
+    pthread_mutex_t lock;
+    pthread_cond_t go;
+    pthread_cond_t done;
+    unsigned int gen;
+    int pending;
+    bool stop;
+    /* the job being run */
+    orcm_diag_engine_test_t *tests;
+    int ntests;
+    struct timeval start;
+    /* one buffer per NUMA node */
+    void **node_mem;
+    size_t *node_len;
+} engine_t;
+
+static engine_t engine = {
+    .started = false,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .go = PTHREAD_COND_INITIALIZER,
+    .done = PTHREAD_COND_INITIALIZER
+};
+
+static double since(struct timeval *start)
+{
+    struct timeval now;
+
+    gettimeofday(&now, NULL);
+    return (double)(now.tv_sec - start->tv_sec) +
+           (double)(now.tv_usec - start->tv_usec) / 1.0e6;
+}
+
+/* bind the calling thread to its PU - first touch then places
+ * its memory on the local NUMA node */
+static void bind_worker(engine_worker_t *ew)
+{
+#if OPAL_HAVE_HWLOC
+    hwloc_obj_t pu;
+
+    if (NULL == opal_hwloc_topology ||
+        NULL == (pu = hwloc_get_obj_by_type(opal_hwloc_topology, HWLOC_OBJ_PU, ew->w.id))) {
+        return;
+    }
+    if (0 != hwloc_set_cpubind(opal_hwloc_topology, pu->cpuset, HWLOC_CPUBIND_THREAD)) {
+        opal_output_verbose(5, orcm_diag_base_framework.framework_output,
+                            "%s diag:engine: could not bind worker %d",
+                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), ew->w.id);
+    }
+#endif
+}
+
+static void touch(engine_worker_t *ew)
+{
+    size_t page = sysconf(_SC_PAGESIZE), off;
+    char *p = (char*)ew->w.mem;
+
+    for (off = 0; off < ew->w.mem_len; off += page) {
+        p[off] = 0;
+    }
+}
+
+/* run the current job on one worker - compatible tests are all run
+ * by every worker, each worker starting at a different one so that
+ * the tests overlap across the node */
+static void run_job(engine_worker_t *ew)
+{
+    orcm_diag_engine_test_t *t;
+    struct timeval start;
+    double secs;
+    int k, n, rc;
+
+    if (NULL == engine.tests) {
+        touch(ew);
+        return;
+    }
+    for (k = 0; k < engine.ntests; k++) {
+        n = (ew->w.id + k) % engine.ntests;
+        t = &engine.tests[n];
+        ew->w.bytes = 0;
+        ew->w.flops = 0;
+        ew->w.errors = 0;
+        gettimeofday(&start, NULL);
+        rc = t->fn(&ew->w, t->arg);
+        secs = since(&start);
+        if (ORCM_SUCCESS != rc && 0 == ew->w.errors) {
+            ew->w.errors = 1;
+        }
+        pthread_mutex_lock(&engine.lock);
+        t->errors += ew->w.errors;
+        t->bytes += ew->w.bytes;
+        t->flops += ew->w.flops;
+        if (secs > t->seconds) {
+            t->seconds = secs;
+        }
+        pthread_mutex_unlock(&engine.lock);
+    }
+}
+
+static void *worker_main(void *arg)
+{
+    engine_worker_t *ew = (engine_worker_t*)arg;
+
+    bind_worker(ew);
+
+    pthread_mutex_lock(&engine.lock);
+    while (1) {
+        while (!engine.stop && ew->seen == engine.gen) {
+            pthread_cond_wait(&engine.go, &engine.lock);
+        }
+        if (engine.stop) {
+            break;
+        }
+        ew->seen = engine.gen;
+        pthread_mutex_unlock(&engine.lock);
+
+        run_job(ew);
+
+        pthread_mutex_lock(&engine.lock);
+        if (0 == --engine.pending) {
+            pthread_cond_signal(&engine.done);
+        }
+    }
+    pthread_mutex_unlock(&engine.lock);
+    return NULL;
+}
+
+static int start_workers(void)
+{
+    int i;
+#if OPAL_HAVE_HWLOC
+    hwloc_obj_t pu, node;
+#endif
+
+    engine.nworkers = 0;
+    engine.nnodes = 1;
+#if OPAL_HAVE_HWLOC
+    if (NULL != opal_hwloc_topology || OPAL_SUCCESS == opal_hwloc_base_get_topology()) {
+        engine.nworkers = hwloc_get_nbobjs_by_type(opal_hwloc_topology, HWLOC_OBJ_PU);
+        if (1 > (engine.nnodes = hwloc_get_nbobjs_by_type(opal_hwloc_topology, HWLOC_OBJ_NODE))) {
+            engine.nnodes = 1;
+        }
+    }
+#endif
+    if (0 >= engine.nworkers) {
+        engine.nworkers = sysconf(_SC_NPROCESSORS_ONLN);
+        if (0 >= engine.nworkers) {
+            engine.nworkers = 1;
+        }
+    }
+
+    engine.workers = (engine_worker_t*)calloc(engine.nworkers, sizeof(engine_worker_t));
+    engine.node_mem = (void**)calloc(engine.nnodes, sizeof(void*));
+    engine.node_len = (size_t*)calloc(engine.nnodes, sizeof(size_t));
+    if (NULL == engine.workers || NULL == engine.node_mem || NULL == engine.node_len) {
+        free(engine.workers);
+        free(engine.node_mem);
+        free(engine.node_len);
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+
+    engine.gen = 0;
+    engine.stop = false;
+    for (i = 0; i < engine.nworkers; i++) {
+        engine.workers[i].w.id = i;
+        engine.workers[i].w.nworkers = engine.nworkers;
+        engine.workers[i].w.numa_node = 0;
+#if OPAL_HAVE_HWLOC
+        if (NULL != opal_hwloc_topology &&
+            NULL != (pu = hwloc_get_obj_by_type(opal_hwloc_topology, HWLOC_OBJ_PU, i)) &&
+            NULL != (node = hwloc_get_ancestor_obj_by_type(opal_hwloc_topology, HWLOC_OBJ_NODE, pu)) &&
+            (int)node->logical_index < engine.nnodes) {
+            engine.workers[i].w.numa_node = node->logical_index;
+        }
+#endif
+        if (0 != pthread_create(&engine.workers[i].thread, NULL, worker_main, &engine.workers[i])) {
+            /* run with what we have */
+            engine.nworkers = i;
+            break;
+        }
+    }
+    if (0 == engine.nworkers) {
+        free(engine.workers);
+        free(engine.node_mem);
+        free(engine.node_len);
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+
+    opal_output_verbose(5, orcm_diag_base_framework.framework_output,
+                        "%s diag:engine: started %d workers over %d NUMA nodes",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), engine.nworkers, engine.nnodes);
+    engine.started = true;
+    return ORCM_SUCCESS;
+}
+
+/* hand the current job to every worker and wait for it */
+static void dispatch(orcm_diag_engine_test_t *tests, int ntests)
+{
+    pthread_mutex_lock(&engine.lock);
+    engine.tests = tests;
+    engine.ntests = ntests;
+    engine.pending = engine.nworkers;
+    engine.gen++;
+    pthread_cond_broadcast(&engine.go);
+    while (0 < engine.pending) {
+        pthread_cond_wait(&engine.done, &engine.lock);
+    }
+    pthread_mutex_unlock(&engine.lock);
+}
+
+static void release_mem(void)
+{
+    int i;
+
+    for (i = 0; i < engine.nnodes; i++) {
+        if (NULL != engine.node_mem[i]) {
+            munmap(engine.node_mem[i], engine.node_len[i]);
+            engine.node_mem[i] = NULL;
+            engine.node_len[i] = 0;
+        }
+    }
+    for (i = 0; i < engine.nworkers; i++) {
+        engine.workers[i].w.mem = NULL;
+        engine.workers[i].w.mem_len = 0;
+    }
+}
+
+/* map each NUMA node's share of the memory and hand out page
+ * aligned slices - nothing is touched until the workers do it.
+ * On return mem holds the bytes actually handed out, which is less
+ * than asked for if a mapping had to back off */
+static int setup_mem(size_t *mem)
+{
+    size_t page = sysconf(_SC_PAGESIZE), slice, len;
+    int *count, *rank;
+    int i, n;
+    void *addr;
+
+    count = (int*)calloc(engine.nnodes, sizeof(int));
+    rank = (int*)calloc(engine.nnodes, sizeof(int));
+    if (NULL == count || NULL == rank) {
+        free(count);
+        free(rank);
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    for (i = 0; i < engine.nworkers; i++) {
+        count[engine.workers[i].w.numa_node]++;
+    }
+
+    slice = (*mem / engine.nworkers) & ~(page - 1);
+    for (n = 0; n < engine.nnodes; n++) {
+        if (0 == count[n] || 0 == slice) {
+            continue;
+        }
+        /* back off until the mapping fits */
+        len = slice * count[n];
+        while (MAP_FAILED == (addr = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0))) {
+            len -= (len / 16 + page - 1) & ~(page - 1);
+            if (len < page * count[n]) {
+                break;
+            }
+        }
+        if (MAP_FAILED == addr) {
+            /* its workers would have nothing to test */
+            release_mem();
+            free(count);
+            free(rank);
+            return ORCM_ERR_FAILED_TO_MAP;
+        }
+        engine.node_mem[n] = addr;
+        engine.node_len[n] = len;
+    }
+
+    *mem = 0;
+    for (i = 0; i < engine.nworkers; i++) {
+        n = engine.workers[i].w.numa_node;
+        if (NULL == engine.node_mem[n]) {
+            continue;
+        }
+        slice = (engine.node_len[n] / count[n]) & ~(page - 1);
+        engine.workers[i].w.mem = (char*)engine.node_mem[n] + slice * rank[n];
+        engine.workers[i].w.mem_len = slice;
+        *mem += slice;
+        rank[n]++;
+    }
+    free(count);
+    free(rank);
+    if (0 == *mem) {
+        release_mem();
+        return ORCM_ERR_FAILED_TO_MAP;
+    }
+
+    /* first touch from the bound workers */
+    dispatch(NULL, 0);
+    return ORCM_SUCCESS;
+}
+
+int orcm_diag_engine_num_workers(void)
+{
+    if (!engine.started && ORCM_SUCCESS != start_workers()) {
+        return 0;
+    }
+    return engine.nworkers;
+}
+
+int orcm_diag_engine_run(orcm_diag_engine_test_t *tests, int ntests, size_t *mem)
+{
+    orcm_diag_engine_test_t **batch;
+    int i, n, rc;
+
+    if (!engine.started && ORCM_SUCCESS != (rc = start_workers())) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+    if (NULL == (batch = (orcm_diag_engine_test_t**)calloc(ntests, sizeof(*batch)))) {
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+
+    for (i = 0; i < ntests; i++) {
+        tests[i].errors = 0;
+        tests[i].seconds = 0.0;
+        tests[i].bytes = 0;
+        tests[i].flops = 0;
+    }
+    if (NULL != mem && 0 < *mem && ORCM_SUCCESS != (rc = setup_mem(mem))) {
+        free(batch);
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+
+    /* everything that can share the node goes in one job */
+    for (i = 0, n = 0; i < ntests; i++) {
+        if (!tests[i].exclusive) {
+            batch[n++] = &tests[i];
+        }
+    }
+    if (0 < n) {
+        orcm_diag_engine_test_t *shared;
+
+        /* the workers walk a contiguous array of tests */
+        if (NULL == (shared = (orcm_diag_engine_test_t*)malloc(n * sizeof(*shared)))) {
+            release_mem();
+            free(batch);
+            return ORCM_ERR_OUT_OF_RESOURCE;
+        }
+        for (i = 0; i < n; i++) {
+            shared[i] = *batch[i];
+        }
+        dispatch(shared, n);
+        for (i = 0; i < n; i++) {
+            *batch[i] = shared[i];
+        }
+        free(shared);
+    }
+    /* then the ones that need it to themselves */
+    for (i = 0; i < ntests; i++) {
+        if (tests[i].exclusive) {
+            dispatch(&tests[i], 1);
+        }
+    }
+
+    for (i = 0; i < ntests; i++) {
+        opal_output_verbose(5, orcm_diag_base_framework.framework_output,
+                            "%s diag:engine: %s took %.3f s on %d workers, %.2f GB/s %.2f GFLOPS, %d errors",
+                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), tests[i].name,
+                            tests[i].seconds, engine.nworkers,
+                            ORCM_DIAG_ENGINE_GBPS(&tests[i]),
+                            ORCM_DIAG_ENGINE_GFLOPS(&tests[i]), tests[i].errors);
+    }
+
+    release_mem();
+    free(batch);
+    return ORCM_SUCCESS;
+}
+
+void orcm_diag_engine_finalize(void)
+{
+    int i;
+
+    if (!engine.started) {
+        return;
+    }
+    pthread_mutex_lock(&engine.lock);
+    engine.stop = true;
+    pthread_cond_broadcast(&engine.go);
+    pthread_mutex_unlock(&engine.lock);
+    for (i = 0; i < engine.nworkers; i++) {
+        pthread_join(engine.workers[i].thread, NULL);
+    }
+    release_mem();
+    free(engine.workers);
+    free(engine.node_mem);
+    free(engine.node_len);
+    engine.workers = NULL;
+    engine.started = false;
+}
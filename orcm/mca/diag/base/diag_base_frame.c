@@ -60,6 +60,9 @@ static int orcm_diag_base_close(void)
     /* stop the thread */
     opal_progress_thread_finalize("diag");
 
+    /* and the diag workers */
+    orcm_diag_engine_finalize();
+
     /* deconstruct the base objects */
     OPAL_LIST_DESTRUCT(&orcm_diag_base.modules);
 
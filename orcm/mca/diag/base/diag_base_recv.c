@@ -24,12 +24,14 @@
 
 #include "orcm/runtime/orcm_globals.h"
 #include "orcm/mca/diag/base/base.h"
+#include "orcm/util/fanout.h"
 
 static bool recv_issued=false;
 
 static void orcm_diag_base_recv(int status, orte_process_name_t* sender,
                                 opal_buffer_t* buffer, orte_rml_tag_t tag,
                                 void* cbdata);
+static int diag_base_fanout(opal_buffer_t *buffer, opal_buffer_t *ans);
 
 int orcm_diag_base_comm_start(void)
 {
@@ -46,6 +48,7 @@ int orcm_diag_base_comm_start(void)
                             ORTE_RML_PERSISTENT,
                             orcm_diag_base_recv,
                             NULL);
+    orcm_fanout_register(ORCM_RML_TAG_DIAG, diag_base_fanout);
     recv_issued = true;
 
     return ORCM_SUCCESS;
@@ -62,11 +65,94 @@ int orcm_diag_base_comm_stop(void)
                          ORTE_NAME_PRINT(ORTE_PROC_MY_NAME)));
 
     orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_DIAG);
+    orcm_fanout_register(ORCM_RML_TAG_DIAG, NULL);
     recv_issued = false;
 
     return ORCM_SUCCESS;
 }
 
+/* unpack the rest of a start command */
+static int diag_base_unpack_start(opal_buffer_t *buffer, orcm_diag_info_t **result)
+{
+    orcm_diag_info_t *info;
+    opal_value_t *options;
+    int rc, cnt, numopts, i;
+
+    /* start selected diagnostics */
+    info = OBJ_NEW(orcm_diag_info_t);
+
+    /* unpack the module name */
+    cnt = 1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &info->component,
+                                              &cnt, OPAL_STRING))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(info);
+        return rc;
+    }
+    /* unpack if sender wants diag results */
+    cnt = 1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &info->want_result,
+                                              &cnt, OPAL_BOOL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(info);
+        return rc;
+    }
+    /* unpack the number of options */
+    cnt = 1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &numopts,
+                                              &cnt, OPAL_INT))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(info);
+        return rc;
+    }
+    /* unpack options */
+    if (0 < numopts) {
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &options,
+                                                  &numopts, OPAL_VALUE))) {
+            ORTE_ERROR_LOG(rc);
+            OBJ_RELEASE(info);
+            return rc;
+        }
+        for (i = 0; i < numopts; i++) {
+            opal_list_append(&info->options, &options[i].super);
+        }
+    }
+    *result = info;
+    return ORCM_SUCCESS;
+}
+
+/* a start command fanned out from a tool. Results cannot follow
+ * the reply back up the tree, so only the immediate status is sent */
+static int diag_base_fanout(opal_buffer_t *buffer, opal_buffer_t *ans)
+{
+    orcm_diag_cmd_flag_t command;
+    orcm_diag_info_t *info;
+    int rc, cnt, response;
+
+    cnt = 1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &command,
+                                              &cnt, ORCM_DIAG_CMD_T))) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+    if (ORCM_DIAG_START_COMMAND != command) {
+        return ORCM_ERR_NOT_SUPPORTED;
+    }
+    if (ORCM_SUCCESS != (rc = diag_base_unpack_start(buffer, &info))) {
+        return rc;
+    }
+    response = ORCM_SUCCESS;
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &response, 1, OPAL_INT))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(info);
+        return rc;
+    }
+    info->want_result = false;
+    info->requester = NULL;
+    orcm_diag_base_activate(info);
+    return ORCM_SUCCESS;
+}
+
 /* process incoming messages in order of receipt */
 static void orcm_diag_base_recv(int status, orte_process_name_t *sender,
                                 opal_buffer_t *buffer, orte_rml_tag_t tag,
@@ -74,9 +160,8 @@ static void orcm_diag_base_recv(int status, orte_process_name_t *sender,
 {
     orcm_diag_cmd_flag_t command;
     orcm_diag_info_t *info;
-    int rc, response, cnt, numopts, i;
+    int rc, response, cnt;
     opal_buffer_t *ans = NULL;
-    opal_value_t *options;
     char *dname;
 
     OPAL_OUTPUT_VERBOSE((5, orcm_diag_base_framework.framework_output,
@@ -92,41 +177,9 @@ static void orcm_diag_base_recv(int status, orte_process_name_t *sender,
     }
 
     if (ORCM_DIAG_START_COMMAND == command) {
-        /* start selected diagnostics */
-        info = OBJ_NEW(orcm_diag_info_t);
-
-        /* unpack the module name */
-        cnt = 1;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &info->component,
-                                                  &cnt, OPAL_STRING))) {
-            ORTE_ERROR_LOG(rc);
-            return;
-        }
-        /* unpack if sender wants diag results */
-        cnt = 1;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &info->want_result,
-                                                  &cnt, OPAL_BOOL))) {
-            ORTE_ERROR_LOG(rc);
-            return;
-        }
-        /* unpack the number of options */
-        cnt = 1;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &numopts,
-                                                  &cnt, OPAL_INT))) {
-            ORTE_ERROR_LOG(rc);
+        if (ORCM_SUCCESS != diag_base_unpack_start(buffer, &info)) {
             return;
         }
-        /* unpack options */
-        if (0 < numopts) {
-            if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &options,
-                                                      &numopts, OPAL_VALUE))) {
-                ORTE_ERROR_LOG(rc);
-                return;
-            }
-            for (i = 0; i < numopts; i++) {
-                opal_list_append(&info->options, &options[i].super);
-            }
-        }
 
         if (!info->want_result) {
             /* send back the immediate success,
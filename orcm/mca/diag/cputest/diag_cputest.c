@@ -73,13 +73,30 @@ orcm_diag_base_module_t orcm_diag_cputest_module = {
  * Stress Test Timeout
  */
 #define CPU_STRESS_TIMEOUT    5
-#define BACKOFF_TIME          3000
 
+/* work per stress chunk - 8 accumulators, a multiply and an add each */
+#define CPU_STRESS_ITERS      (1 << 20)
+#define CPU_STRESS_FLOPS      (2 * 8 * (uint64_t)CPU_STRESS_ITERS)
 
-static int keep_cpu_busy(void);
-static int cpu_stress_test(int cpucnt, int timeout);
-static int cpu_fp_test(void);
-static int cpu_prime_gen_test(void);
+/* primes below 10^6 */
+#define CPU_PRIME_LIMIT       1000000
+#define CPU_PRIME_COUNT       78498
+
+static int cpu_stress_test(orcm_diag_engine_worker_t *w, void *arg);
+static int cpu_fp_test(orcm_diag_engine_worker_t *w, void *arg);
+static int cpu_prime_gen_test(orcm_diag_engine_worker_t *w, void *arg);
+
+/* all compute only, so the engine runs them side by side */
+static orcm_diag_engine_test_t cpu_tests[] = {
+    { "floating point", cpu_fp_test, NULL, false },
+    { "prime generation", cpu_prime_gen_test, NULL, false },
+    { "stress", cpu_stress_test, NULL, false }
+};
+static const int cpu_test_flags[] = {
+    DIAG_CPU_FP_TST,
+    DIAG_CPU_PRIME_TST,
+    DIAG_CPU_STRESS_TST
+};
 
 static int init(void)
 {
@@ -251,9 +268,9 @@ static int cputest_log(opal_buffer_t *buf)
 static void cputest_run(int sd, short args, void *cbdata)
 {
     orcm_diag_caddy_t *caddy = (orcm_diag_caddy_t*)cbdata;
-    int numprocs = 0;
-    int retval   = 0;
+    int ntests = sizeof(cpu_tests) / sizeof(cpu_tests[0]);
     int cpu_diag_ret = 0;
+    int i;
     orcm_diag_cmd_flag_t command = ORCM_DIAG_AGG_COMMAND;
     opal_buffer_t *data = NULL;
     struct timeval now;
@@ -278,36 +295,29 @@ static void cputest_run(int sd, short args, void *cbdata)
         /* return; */
     }
 
-    numprocs = get_nprocs();
-
-    retval = cpu_fp_test();
-    if ( retval ) {
-        cpu_diag_ret |= DIAG_CPU_FP_TST;
-        opal_output(0, "%s Diagnostic checking CPU floating point:  \t\t[ FAIL ]\n",
-                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME) );
-    } else {
-        opal_output(0, "%s Diagnostic checking CPU floating point:  \t\t[ PASS ]\n",
-                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME) );
-    }
+    gettimeofday(&start_time, NULL);
 
-    retval = cpu_prime_gen_test();
-    if ( retval ) {
-        cpu_diag_ret |= DIAG_CPU_PRIME_TST;
-        opal_output(0, "%s Diagnostic checking CPU prime generation:\t\t[ FAIL ]\n",
-                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME) );
+    if (ORCM_SUCCESS != orcm_diag_engine_run(cpu_tests, ntests, NULL)) {
+        /* could not run anything - nothing can be said to have passed */
+        cpu_diag_ret = DIAG_CPU_FP_TST | DIAG_CPU_PRIME_TST | DIAG_CPU_STRESS_TST;
     } else {
-        opal_output(0, "%s Diagnostic checking CPU prime generation:\t\t[ PASS ]\n",
-                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME) );
+        for (i = 0; i < ntests; i++) {
+            if (0 != cpu_tests[i].errors) {
+                cpu_diag_ret |= cpu_test_flags[i];
+            }
+        }
     }
-
-    retval = cpu_stress_test(numprocs, CPU_STRESS_TIMEOUT);
-    if ( retval ) {
-        cpu_diag_ret |= DIAG_CPU_STRESS_TST;
-        opal_output(0, "%s Diagnostic checking CPU stress:          \t\t[ FAIL ]\n",
-                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME) );
-    } else {
-        opal_output(0, "%s Diagnostic checking CPU stress:          \t\t[ PASS ]\n",
-                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME) );
+    for (i = 0; i < ntests; i++) {
+        if (0 < cpu_tests[i].flops) {
+            opal_output(0, "%s Diagnostic checking CPU %s: %.2f GFLOPS\t\t[ %s ]\n",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), cpu_tests[i].name,
+                        ORCM_DIAG_ENGINE_GFLOPS(&cpu_tests[i]),
+                        (cpu_diag_ret & cpu_test_flags[i]) ? "FAIL" : "PASS");
+        } else {
+            opal_output(0, "%s Diagnostic checking CPU %s:\t\t[ %s ]\n",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), cpu_tests[i].name,
+                        (cpu_diag_ret & cpu_test_flags[i]) ? "FAIL" : "PASS");
+        }
     }
 
     data = OBJ_NEW(opal_buffer_t);
@@ -329,7 +339,6 @@ static void cputest_run(int sd, short args, void *cbdata)
     free(compname);
 
     /* Pack start Time */
-    gettimeofday(&start_time, NULL);
     if (OPAL_SUCCESS != (rc = opal_dss.pack(data, &start_time, 1, OPAL_TIMEVAL))) {
         ORTE_ERROR_LOG(rc);
         OBJ_DESTRUCT(&data);
@@ -370,181 +379,52 @@ static void cputest_run(int sd, short args, void *cbdata)
     return;
 }
 
-static int keep_cpu_busy(void)
+/* one chunk of stress work - the same chunk must always give the
+ * same answer, anything else is a compute fault */
+static double cpu_stress_chunk(void)
 {
-    while (1) {
-        sqrt(rand());
-    }
+    static volatile double mul = 0.999999;
+    double a[8], x = mul, sum = 0.0;
+    int i, k;
 
-    return 0;
-}
-
-static int cpu_stress_test(int cpucnt, int timeout)
-{
-    pid_t pid     = 0;
-    int child_num = 0;
-    int fork_num  = 0;
-    int retval    = 0;
-    time_t start_time, stop_time, cur_time, run_time;
-
-    /* Record start time.  */
-    if ( -1 == (start_time = time(NULL)) ) {
-        opal_output_verbose(1, orcm_diag_base_framework.framework_output,
-                            "%s diag:cannot get system time",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
-        return ORCM_ERROR;
+    for (k = 0; k < 8; k++) {
+        a[k] = k + 1;
     }
-
-    fork_num = cpucnt;
-
-    /* Dispatch work processes to stress cpu  */
-    while ( fork_num ) {
-        long long backoff, tst_timeout = 0;
-
-        /* Calculate backoff sleep time to get good throughput */
-        backoff = fork_num * BACKOFF_TIME;
-
-        /* Check time out */
-        if ( timeout ) {
-            /* Get current time */
-            cur_time = time(NULL);
-
-            tst_timeout = timeout - (cur_time - start_time);
-
-            if ( tst_timeout <= 0 ) {
-                opal_output_verbose(5, orcm_diag_base_framework.framework_output,
-                            "%s diag:time used up before work dispatched",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
-            }
-        }
-
-        switch ( pid = fork() ) {
-        case -1:           /* error */
-            opal_output_verbose(1, orcm_diag_base_framework.framework_output,
-                            "%s diag:fork process failed - %s",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), strerror(errno));
-            return ORCM_ERR_SYS_LIMITS_CHILDREN;
-            break;
-        case 0:
-            alarm(timeout);
-            usleep(backoff);
-            exit( keep_cpu_busy() );
-            break;
-        default:           /* parent */
-            opal_output_verbose(5, orcm_diag_base_framework.framework_output,
-                            "%s diag:stress cpu work process %i [%i] forked",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), fork_num, pid);
-            child_num++;
-            break;
+    for (i = 0; i < CPU_STRESS_ITERS; i++) {
+        for (k = 0; k < 8; k++) {
+            a[k] = a[k] * x + 1.0e-6;
         }
-        fork_num--;
     }
+    for (k = 0; k < 8; k++) {
+        sum += a[k];
+    }
+    return sum;
+}
 
-    opal_output_verbose(5, orcm_diag_base_framework.framework_output,
-                   "%s diag:finish dispatch",
-                   ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
-
-    /* Wait for the child process exit */
-    while (child_num) {
-        int statval, ret;
-
-        if ((pid = wait(&statval)) > 0)
-        {
-            --child_num;
-
-            if ( WIFEXITED(statval) ) {
-                if ( 0 == (ret = WEXITSTATUS(statval)) ) {
-                    opal_output_verbose(5, orcm_diag_base_framework.framework_output,
-                            "%s diag:stress cpu child process %i returned successfully",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), pid);
-                } else {
-                    opal_output_verbose(1, orcm_diag_base_framework.framework_output,
-                            "%s diag:stress cpu child process %i returned error %i",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), pid, ret);
-
-                    retval++;
-                    opal_output_verbose(5, orcm_diag_base_framework.framework_output,
-                            "%s diag:stress cpu reap child process",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
-
-                    if ( SIG_ERR == signal(SIGUSR1, SIG_IGN) ) {
-                        opal_output_verbose(1, orcm_diag_base_framework.framework_output,
-                            "%s diag:stress cpu signal handler error : %s",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), strerror(errno) );
-                    }
-
-                    if ( -1 == kill(-1 * getpid(), SIGUSR1) ) {
-                        opal_output_verbose(1, orcm_diag_base_framework.framework_output,
-                            "%s diag:stress cpu kill process error : %s",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), strerror(errno) );
-                    }
-                }
-            } else if ( WIFSIGNALED(statval) ) {
-                if ( SIGALRM == (ret = WTERMSIG(statval)) ) {
-                    opal_output_verbose(5, orcm_diag_base_framework.framework_output,
-                            "%s diag:stress cpu child process %i signalled successfully",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), pid);
-                } else if ( SIGUSR1 == (ret = WTERMSIG (statval)) ) {
-                    opal_output_verbose(5, orcm_diag_base_framework.framework_output,
-                            "%s diag:stress cpu child process %i reaped",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), pid);
-                } else {
-                    opal_output_verbose(1, orcm_diag_base_framework.framework_output,
-                            "%s diag:stress cpu child process %i got signal %i",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), pid, ret);
-                    retval++;
-                    opal_output_verbose(5, orcm_diag_base_framework.framework_output,
-                            "%s diag:stress cpu reap child process",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
-
-                    if ( SIG_ERR == signal(SIGUSR1, SIG_IGN) ) {
-                        opal_output_verbose(1, orcm_diag_base_framework.framework_output,
-                            "%s diag:stress cpu signal handler error : %s",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), strerror(errno) );
-                    }
-
-                    if ( -1 == kill(-1 * getpid(), SIGUSR1) ) {
-                        opal_output_verbose(1, orcm_diag_base_framework.framework_output,
-                            "%s diag:stress cpu kill process error : %s",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), strerror(errno) );
-                    }
-                }
-            } else {
-                opal_output_verbose(1, orcm_diag_base_framework.framework_output,
-                        "%s diag:stress cpu child process %i exit abnormally",
-                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), pid);
-                retval++;
-            }
-        } else {
+static int cpu_stress_test(orcm_diag_engine_worker_t *w, void *arg)
+{
+    struct timeval start, now;
+    double ref, r;
+
+    gettimeofday(&start, NULL);
+    ref = cpu_stress_chunk();
+    w->flops += CPU_STRESS_FLOPS;
+    do {
+        r = cpu_stress_chunk();
+        w->flops += CPU_STRESS_FLOPS;
+        if (r != ref) {
             opal_output_verbose(1, orcm_diag_base_framework.framework_output,
-                    "%s diag:stress cpu wait for child process",
-                    ORTE_NAME_PRINT(ORTE_PROC_MY_NAME) );
-            break;
+                                "%s diag:stress cpu worker %d got %.17g expected %.17g",
+                                ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), w->id, r, ref);
+            w->errors++;
         }
-    }
-
-    opal_output_verbose(5, orcm_diag_base_framework.framework_output,
-                   "%s diag:finish waiting for child process",
-                   ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
-
-    /* Calculate runtime. */
-    stop_time = time(NULL);
-    run_time  = stop_time - start_time;
-
-    if ( retval ) {
-        opal_output_verbose(5, orcm_diag_base_framework.framework_output,
-                "%s diag:stress cpu failed - run completed in %lis",
-                ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), run_time );
-    } else {
-        opal_output_verbose(5, orcm_diag_base_framework.framework_output,
-                "%s diag:stress cpu successful run completed in %lis",
-                ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), run_time );
-    }
+        gettimeofday(&now, NULL);
+    } while (now.tv_sec - start.tv_sec < CPU_STRESS_TIMEOUT);
 
-    return retval;
+    return ORCM_SUCCESS;
 }
 
-static int cpu_fp_test(void)
+static int cpu_fp_test(orcm_diag_engine_worker_t *w, void *arg)
 {
     /* Tets the implementations of the double type corresponds to the IEEE-754 double precision and
        the long double type corresponds to x86 extended precision */
@@ -552,7 +432,6 @@ static int cpu_fp_test(void)
     volatile double y = 4294967288.0; /* 2^32 - 8 */
     double z, zl;
     long double xl, yl;
-    int retval = 0;
 
     xl = x;
     yl = y;
@@ -560,20 +439,39 @@ static int cpu_fp_test(void)
     zl = xl * yl;
     if ( z != zl ) {
         opal_output_verbose(5, orcm_diag_base_framework.framework_output,
-                "%s diag:cpu FPU cast to long double test failed",
-                ORTE_NAME_PRINT(ORTE_PROC_MY_NAME) );
-        retval++;
-    } else {
-        opal_output_verbose(5, orcm_diag_base_framework.framework_output,
-                "%s diag:cpu FPU cast to long double test pass",
-                ORTE_NAME_PRINT(ORTE_PROC_MY_NAME) );
+                "%s diag:cpu FPU cast to long double test failed on worker %d",
+                ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), w->id );
+        w->errors++;
     }
 
-    return retval;
+    return ORCM_SUCCESS;
 }
 
-static int cpu_prime_gen_test(void)
+static int cpu_prime_gen_test(orcm_diag_engine_worker_t *w, void *arg)
 {
+    char *composite;
+    int i, j, count = 0;
+
+    if (NULL == (composite = (char*)calloc(CPU_PRIME_LIMIT, 1))) {
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    for (i = 2; i < CPU_PRIME_LIMIT; i++) {
+        if (composite[i]) {
+            continue;
+        }
+        count++;
+        for (j = 2 * i; j < CPU_PRIME_LIMIT; j += i) {
+            composite[j] = 1;
+        }
+    }
+    free(composite);
+    w->bytes = CPU_PRIME_LIMIT;
+
+    if (CPU_PRIME_COUNT != count) {
+        opal_output_verbose(1, orcm_diag_base_framework.framework_output,
+                            "%s diag:cpu prime generation on worker %d found %d primes, expected %d",
+                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), w->id, count, CPU_PRIME_COUNT);
+        w->errors++;
+    }
     return ORCM_SUCCESS;
 }
-
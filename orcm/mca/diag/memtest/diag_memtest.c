@@ -46,11 +46,10 @@
 
 #include "orcm/mca/diag/base/base.h"
 #include "diag_memtest.h"
+#include "diag_memtest_patterns.h"
 
 #include "orcm/util/utils.h"
 
-#define	NPAGE_SIZE	(  4UL << 10)
-
 static int init(void);
 static void finalize(void);
 static int memtest_log(opal_buffer_t *buf);
@@ -66,8 +65,6 @@ orcm_diag_base_module_t orcm_diag_memtest_module = {
     memtest_run
 };
 
-static struct { unsigned int *addr; size_t size; long num; unsigned long length; } memcheck_t;
-
 static int init(void)
 {
     OPAL_OUTPUT_VERBOSE((5, orcm_diag_base_framework.framework_output,
@@ -85,88 +82,31 @@ static void finalize(void)
     return;
 }
 
-static void *memcheck_thread(void *arg) {
-
-    long pos = (long)arg;
-    unsigned int *myaddr;
-    size_t mysize, i;
-    unsigned int x, y, z, w, t;
-
-    myaddr = memcheck_t.addr + pos * memcheck_t.length;
-    mysize = memcheck_t.size - pos * memcheck_t.length;
-    if (mysize > memcheck_t.length) mysize = memcheck_t.length;
-
-    /* Xorshift random number generator. */
-
-    x = 123456789;
-    y = 362436069;
-    z = 521288629;
-    w =  88675123;
+static orcm_diag_engine_test_t patterns[] = {
+    { "random", pattern_random, NULL, true },
+    { "walking ones", pattern_walking_ones, NULL, true },
+    { "moving inversions", pattern_moving_inversions, NULL, true }
+};
 
-    for (i = 0; i < mysize; i++) {
+static void memcheck(size_t size) {
+    int i, n = sizeof(patterns) / sizeof(patterns[0]);
 
-        t = (x ^ (x << 11));
-        x = y;
-        y = z;
-        z = w;
-        w = (w ^ (w >> 19)) ^ (t ^ (t >> 8));
-    
-        myaddr[i] = w;
+    if (ORCM_SUCCESS != orcm_diag_engine_run(patterns, n, &size)) {
+        mem_diag_ret |= DIAG_MEM_NOTRUN;
+        return;
     }
-
-    x = 123456789;
-    y = 362436069;
-    z = 521288629;
-    w =  88675123;
-
-    for (i = 0; i < mysize; i++) {
-
-        t = (x ^ (x << 11));
-        x = y;
-        y = z;
-        z = w;
-        w = (w ^ (w >> 19)) ^ (t ^ (t >> 8));
-    
-        if (w != myaddr[i]) {
-            opal_output_verbose(1, orcm_diag_base_framework.framework_output,
-                            "%s memdiag: memory error on %p : it should be 0x%08x, but 0x%08x; diffs : 0x%08x",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), (void *)(myaddr + i), w, myaddr[i], w ^ myaddr[i]);
+    /* the engine may have had to settle for less than was free */
+    opal_output(0, "%s Diagnostic checking memory: %ld MB is used for test\n",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), (long)(size >> 20));
+    for (i = 0; i < n; i++) {
+        if (0 != patterns[i].errors) {
             mem_diag_ret |= DIAG_MEM_STRESS_TST;
         }
+        opal_output(0, "%s Diagnostic checking memory %s: %.2f GB/s\t\t[ %s ]\n",
+                    ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), patterns[i].name,
+                    ORCM_DIAG_ENGINE_GBPS(&patterns[i]),
+                    (0 != patterns[i].errors) ? "FAIL" : "PASS");
     }
-
-    return NULL;
-}
-
-static void memcheck(unsigned int *addr, size_t size) {
-
-    long i, numprocs;
-    pthread_t *threads;
-
-    numprocs = get_nprocs();
-
-    threads = (pthread_t *)malloc(numprocs * sizeof(pthread_t));
-
-    if (threads) {
-
-        memcheck_t.addr   = addr;
-        memcheck_t.size   = size;
-        memcheck_t.num    = numprocs;
-        memcheck_t.length = (size + numprocs - 1)/ numprocs;
-        memcheck_t.length = (memcheck_t.length + 15) & ~15;
-
-        for (i = 1; i < numprocs; i++) 
-            pthread_create(&threads[i], NULL, memcheck_thread, (void *)i);
-
-        memcheck_thread((void *)0);
-
-        for (i = 1; i < numprocs; i++) 
-            pthread_join(threads[i], NULL);
-
-        free(threads);
-
-    }
-
 }
 
 static int memtest_log(opal_buffer_t *buf)
@@ -245,9 +185,7 @@ static void memtest_run(int sd, short args, void *cbdata)
     orcm_diag_caddy_t *caddy = (orcm_diag_caddy_t*)cbdata;
     struct sysinfo info;
     struct rlimit org_limit, new_limit;
-    void *addr;
-    char *p;
-    size_t size, rest;
+    size_t size;
     orcm_diag_cmd_flag_t command = ORCM_DIAG_AGG_COMMAND;
     opal_buffer_t *data = NULL;
     struct timeval now;
@@ -314,44 +252,9 @@ static void memtest_run(int sd, short args, void *cbdata)
         goto sendresults;
     }
 
-    do {
-        /* Mapping */
-        addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
-    
-        if (addr == (void *)-1) {
-            size -= NPAGE_SIZE;
-        }
-      
-        if (size == 0) {
-            opal_output_verbose(1, orcm_diag_base_framework.framework_output,
-                            "%s memdiag: out of memory",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
-            rc = ORCM_ERR_FAILED_TO_MAP;
-            ORTE_ERROR_LOG(rc);
-            mem_diag_ret |= DIAG_MEM_NOTRUN; 
-            opal_output(0, "%s Diagnostic checking memory:\t\t\t[NOTRUN]\n",
-                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME) );
-            goto sendresults;
-        }
-
-    } while (addr == (void *)-1);
-
-    opal_output(0, "%s Diagnostic checking memory: %ld MB is used for test\n",
-                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), info.freeram >> 20);
-    p    = (char *)addr;
-    rest = size;
-
-    while ((long)rest > 0) {
-        /* do page fault */
-        *(double *)p = 0.;
-        p    += NPAGE_SIZE;
-        rest -= NPAGE_SIZE;
-    }
-
     mem_diag_ret = ORCM_SUCCESS;
-    memcheck((unsigned int *)addr, size / sizeof(int));
+    memcheck(size);
 
-    munmap(addr, size);
     /* Restore original ulimit for virtual address space */
     if ( 0 != setrlimit(RLIMIT_AS, &org_limit) ) {
         opal_output_verbose(1, orcm_diag_base_framework.framework_output,
@@ -361,7 +264,10 @@ static void memtest_run(int sd, short args, void *cbdata)
         ORTE_ERROR_LOG(rc);
     }
 
-    if ( ORCM_SUCCESS != mem_diag_ret ) {
+    if ( mem_diag_ret & DIAG_MEM_NOTRUN ) {
+        opal_output(0, "%s Diagnostic checking memory:\t\t\t[NOTRUN]\n",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME) );
+    } else if ( ORCM_SUCCESS != mem_diag_ret ) {
         opal_output(0, "%s Diagnostic checking memory:\t\t\t[ FAIL ]\n",
                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME) );
     } else {
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/**
+ * @file
+ *
+ * Memory test patterns run by the diag engine
+ *
+ * Each pattern fills the worker's slice and reads it back, counting
+ * the words that do not hold what was written. They only touch the
+ * memory they are handed, so they can be checked without a node to
+ * drain.
+ */
+#ifndef ORCM_DIAG_MEMTEST_PATTERNS_H
+#define ORCM_DIAG_MEMTEST_PATTERNS_H
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#include <stdint.h>
+
+#include "opal/util/output.h"
+#include "orte/util/name_fns.h"
+
+#include "orcm/mca/diag/base/base.h"
+
+static inline void report_error(uint64_t *addr, uint64_t expected, uint64_t actual)
+{
+    opal_output_verbose(1, orcm_diag_base_framework.framework_output,
+                        "%s memdiag: memory error on %p : it should be 0x%016lx, but 0x%016lx; diffs : 0x%016lx",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), (void *)addr,
+                        (unsigned long)expected, (unsigned long)actual,
+                        (unsigned long)(expected ^ actual));
+}
+
+/* fill with a xorshift stream and read it back */
+static inline int pattern_random(orcm_diag_engine_worker_t *w, void *arg)
+{
+    uint64_t *p = (uint64_t*)w->mem;
+    size_t i, n = w->mem_len / sizeof(uint64_t);
+    uint64_t x, seed = 88172645463325252ULL + w->id;
+
+    x = seed;
+    for (i = 0; i < n; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        p[i] = x;
+    }
+    x = seed;
+    for (i = 0; i < n; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        if (x != p[i]) {
+            report_error(&p[i], x, p[i]);
+            w->errors++;
+        }
+    }
+    w->bytes = 2 * n * sizeof(uint64_t);
+    return ORCM_SUCCESS;
+}
+
+/* walk a single set bit across the data bus - word i holds bit i mod
+ * 64, so every run of 64 words sets each bit position once and the
+ * whole region is covered in one fill and one check */
+static inline int pattern_walking_ones(orcm_diag_engine_worker_t *w, void *arg)
+{
+    uint64_t *p = (uint64_t*)w->mem;
+    size_t i, n = w->mem_len / sizeof(uint64_t);
+    uint64_t expect;
+
+    for (i = 0; i < n; i++) {
+        p[i] = 1ULL << (i & 63);
+    }
+    for (i = 0; i < n; i++) {
+        expect = 1ULL << (i & 63);
+        if (expect != p[i]) {
+            report_error(&p[i], expect, p[i]);
+            w->errors++;
+        }
+    }
+    w->bytes = 2 * n * sizeof(uint64_t);
+    return ORCM_SUCCESS;
+}
+
+/* fill with a pattern, then check and invert it walking up and
+ * check and restore it walking down, so every cell is seen to flip
+ * both ways in both address orders */
+static inline int pattern_moving_inversions(orcm_diag_engine_worker_t *w, void *arg)
+{
+    uint64_t *p = (uint64_t*)w->mem;
+    size_t i, n = w->mem_len / sizeof(uint64_t);
+    const uint64_t pat = 0x5555555555555555ULL;
+
+    for (i = 0; i < n; i++) {
+        p[i] = pat;
+    }
+    for (i = 0; i < n; i++) {
+        if (pat != p[i]) {
+            report_error(&p[i], pat, p[i]);
+            w->errors++;
+        }
+        p[i] = ~pat;
+    }
+    for (i = n; 0 < i; i--) {
+        if (~pat != p[i-1]) {
+            report_error(&p[i-1], ~pat, p[i-1]);
+            w->errors++;
+        }
+        p[i-1] = pat;
+    }
+    w->bytes = 5 * n * sizeof(uint64_t);
+    return ORCM_SUCCESS;
+}
+
+#endif
@@ -41,6 +41,9 @@ BEGIN_C_DECLS
 typedef struct {
     opal_list_t actives;
     int sensor_db_commit_rate;
+    /* live telemetry subscriptions */
+    int pubsub_max_queue;
+    char *pubsub_socket;
 } orcm_evgen_base_t;
 
 typedef struct {
@@ -63,5 +66,11 @@ ORCM_DECLSPEC const char* orcm_evgen_base_print_severity(int s);
 
 ORCM_DECLSPEC orte_notifier_severity_t orcm_evgen_base_convert_ras_severity_to_orte_notifier(int severity);
 
+/* live telemetry subscriptions - publish must be called
+ * from the evgen progress thread */
+ORCM_DECLSPEC int orcm_evgen_base_pubsub_init(void);
+ORCM_DECLSPEC void orcm_evgen_base_pubsub_finalize(void);
+ORCM_DECLSPEC void orcm_evgen_base_pubsub_publish(orcm_ras_event_t *ecd);
+
 END_C_DECLS
 #endif
@@ -30,6 +30,7 @@
 #include "orte/util/regex.h"
 
 #include "orcm/runtime/orcm_globals.h"
+#include "orcm/util/pubsub.h"
 #include "orcm/mca/cfgi/base/base.h"
 #include "orcm/mca/evgen/base/base.h"
 
@@ -50,6 +51,8 @@ opal_event_base_t *orcm_evgen_evbase = NULL;
 
 static int orcm_evgen_base_close(void)
 {
+    orcm_evgen_base_pubsub_finalize();
+
     if (NULL != orcm_evgen_evbase) {
         opal_progress_thread_finalize("evgen");
     }
@@ -88,6 +91,26 @@ static int orcm_evgen_base_open(mca_base_open_flag_t flags)
                                 MCA_BASE_VAR_SCOPE_READONLY,
                                 &orcm_evgen_base.sensor_db_commit_rate);
 
+    orcm_evgen_base.pubsub_max_queue = ORCM_PUBSUB_DEFAULT_MAX_QUEUE;
+    (void)mca_base_var_register("orcm", "evgen", "base", "pubsub_max_queue",
+                                "Maximum number of undelivered records held for each live subscriber before the oldest are dropped",
+                                MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                OPAL_INFO_LVL_9,
+                                MCA_BASE_VAR_SCOPE_READONLY,
+                                &orcm_evgen_base.pubsub_max_queue);
+
+    orcm_evgen_base.pubsub_socket = NULL;
+    (void)mca_base_var_register("orcm", "evgen", "base", "pubsub_socket",
+                                "Path of a local socket on which aggregators accept live subscriptions from external tools (default: none)",
+                                MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                OPAL_INFO_LVL_9,
+                                MCA_BASE_VAR_SCOPE_READONLY,
+                                &orcm_evgen_base.pubsub_socket);
+
+    if (ORCM_SUCCESS == rc) {
+        rc = orcm_evgen_base_pubsub_init();
+    }
+
     return rc;
 }
 
@@ -156,6 +179,7 @@ static void evcon(orcm_ras_event_t *p)
     p->severity = ORCM_RAS_SEVERITY_UNKNOWN;
     OBJ_CONSTRUCT(&p->description, opal_list_t);
     OBJ_CONSTRUCT(&p->data, opal_list_t);
+    p->batch = NULL;
     p->cbfunc = NULL;
     p->cbdata = NULL;
 }
@@ -164,6 +188,9 @@ static void evdes(orcm_ras_event_t *p)
     OPAL_LIST_DESTRUCT(&p->reporter);
     OPAL_LIST_DESTRUCT(&p->description);
     OPAL_LIST_DESTRUCT(&p->data);
+    if (NULL != p->batch) {
+        OBJ_RELEASE(p->batch);
+    }
 }
 OBJ_CLASS_INSTANCE(orcm_ras_event_t,
                    opal_object_t,
@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "opal/class/opal_list.h"
+#include "opal/dss/dss.h"
+#include "opal/util/output.h"
+
+#include "orte/mca/errmgr/errmgr.h"
+#include "orte/mca/rml/rml.h"
+#include "orte/runtime/orte_wait.h"
+#include "orte/util/name_fns.h"
+
+#include "orcm/runtime/orcm_globals.h"
+#include "orcm/util/utils.h"
+#include "orcm/util/pubsub.h"
+#include "orcm/mca/evgen/base/base.h"
+
+/* live subscriptions held by this aggregator - these are only
+ * touched from the evgen progress thread */
+static opal_list_t subscribers;
+static orcm_pubsub_listener_t *listener = NULL;
+static bool pubsub_active = false;
+static bool pubsub_initialized = false;
+static uint32_t next_local_id = 0;
+
+typedef struct {
+    opal_object_t super;
+    opal_event_t ev;
+    orte_process_name_t sender;
+    opal_buffer_t data;
+    volatile bool active;
+} evgen_pubsub_caddy_t;
+static void pcon(evgen_pubsub_caddy_t *p)
+{
+    OBJ_CONSTRUCT(&p->data, opal_buffer_t);
+    p->active = true;
+}
+static void pdes(evgen_pubsub_caddy_t *p)
+{
+    OBJ_DESTRUCT(&p->data);
+}
+static OBJ_CLASS_INSTANCE(evgen_pubsub_caddy_t,
+                          opal_object_t,
+                          pcon, pdes);
+
+static void pubsub_lost(orcm_pubsub_subscriber_t *sub)
+{
+    OPAL_OUTPUT_VERBOSE((5, orcm_evgen_base_framework.framework_output,
+                         "%s evgen:base:pubsub lost subscriber %u of %s",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), sub->id,
+                         ORTE_NAME_PRINT(&sub->peer)));
+
+    opal_list_remove_item(&subscribers, &sub->super);
+    OBJ_RELEASE(sub);
+}
+
+static void pubsub_accept(orcm_pubsub_subscriber_t *sub)
+{
+    sub->id = ++next_local_id;
+    opal_list_append(&subscribers, &sub->super);
+}
+
+static void pubsub_process(int fd, short args, void *cbdata)
+{
+    evgen_pubsub_caddy_t *caddy = (evgen_pubsub_caddy_t*)cbdata;
+    orcm_pubsub_cmd_flag_t command;
+    orcm_pubsub_subscriber_t *sub;
+    orcm_pubsub_filter_t *filter;
+    uint32_t id;
+    int cnt, rc;
+
+    cnt = 1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(&caddy->data, &command, &cnt, ORCM_PUBSUB_CMD_T)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(&caddy->data, &id, &cnt, OPAL_UINT32))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(caddy);
+        return;
+    }
+
+    /* a repeated subscription replaces the old one */
+    if (NULL != (sub = orcm_pubsub_subscriber_find(&subscribers, &caddy->sender, id))) {
+        orcm_pubsub_subscriber_close(sub);
+        opal_list_remove_item(&subscribers, &sub->super);
+        OBJ_RELEASE(sub);
+    }
+
+    switch (command) {
+    case ORCM_PUBSUB_SUBSCRIBE_COMMAND:
+        if (OPAL_SUCCESS != (rc = orcm_pubsub_filter_unpack(&caddy->data, &filter))) {
+            ORTE_ERROR_LOG(rc);
+            break;
+        }
+        sub = orcm_pubsub_subscriber_create(id, &caddy->sender, filter,
+                                            orcm_evgen_evbase,
+                                            orcm_evgen_base.pubsub_max_queue,
+                                            pubsub_lost);
+        opal_list_append(&subscribers, &sub->super);
+        OPAL_OUTPUT_VERBOSE((5, orcm_evgen_base_framework.framework_output,
+                             "%s evgen:base:pubsub subscriber %u added for %s",
+                             ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), id,
+                             ORTE_NAME_PRINT(&caddy->sender)));
+        break;
+
+    case ORCM_PUBSUB_UNSUBSCRIBE_COMMAND:
+        /* already removed above */
+        break;
+
+    default:
+        ORTE_ERROR_LOG(ORCM_ERR_BAD_PARAM);
+        break;
+    }
+    OBJ_RELEASE(caddy);
+}
+
+/* runs in the RML thread - move the request over to the evgen thread */
+static void pubsub_recv(int status, orte_process_name_t *sender,
+                        opal_buffer_t *buffer, orte_rml_tag_t tag,
+                        void *cbdata)
+{
+    evgen_pubsub_caddy_t *caddy;
+
+    caddy = OBJ_NEW(evgen_pubsub_caddy_t);
+    caddy->sender = *sender;
+    opal_dss.copy_payload(&caddy->data, buffer);
+    opal_event_set(orcm_evgen_evbase, &caddy->ev, -1, OPAL_EV_WRITE,
+                   pubsub_process, caddy);
+    opal_event_active(&caddy->ev, OPAL_EV_WRITE, 1);
+}
+
+static void add_value(orcm_pubsub_record_t *rec, orcm_value_t *item)
+{
+    orcm_value_t *val;
+    char *str;
+
+    if (NULL == (str = orcm_pubsub_value_to_string(&item->value))) {
+        return;
+    }
+    val = OBJ_NEW(orcm_value_t);
+    val->value.key = (NULL == item->value.key) ? NULL : strdup(item->value.key);
+    val->value.type = OPAL_STRING;
+    val->value.data.string = str;
+    val->units = (NULL == item->units) ? NULL : strdup(item->units);
+    opal_list_append(&rec->values, &val->value.super);
+}
+
+static orcm_pubsub_record_t* build_record(orcm_ras_event_t *ecd, uint8_t kind,
+                                          const char *host, const char *group)
+{
+    orcm_pubsub_record_t *rec;
+    orcm_value_t *item;
+
+    rec = OBJ_NEW(orcm_pubsub_record_t);
+    rec->kind = kind;
+    rec->host = (NULL == host) ? NULL : strdup(host);
+    rec->group = strdup(group);
+    rec->timestamp = ecd->timestamp;
+    rec->severity = strdup(orcm_evgen_base_print_severity(ecd->severity));
+
+    OPAL_LIST_FOREACH(item, &ecd->data, orcm_value_t) {
+        add_value(rec, item);
+    }
+    /* for events, the description carries the explanation */
+    if (ORCM_PUBSUB_KIND_EVENT == kind) {
+        OPAL_LIST_FOREACH(item, &ecd->description, orcm_value_t) {
+            if (NULL == item->value.key ||
+                0 == strcmp(item->value.key, "storage_type") ||
+                0 == strcmp(item->value.key, "ctime")) {
+                continue;
+            }
+            add_value(rec, item);
+        }
+    }
+    return rec;
+}
+
+void orcm_evgen_base_pubsub_publish(orcm_ras_event_t *ecd)
+{
+    orcm_pubsub_subscriber_t *sub, *next;
+    orcm_pubsub_record_t *rec = NULL;
+    opal_buffer_t *shared = NULL, *buf;
+    orcm_value_t *item;
+    const char *host = NULL, *group = NULL;
+    bool shared_failed = false;
+    uint8_t kind;
+
+    /* keep this cheap when nobody is watching */
+    if (!pubsub_active || 0 == opal_list_get_size(&subscribers)) {
+        return;
+    }
+
+    kind = (ORCM_RAS_EVENT_SENSOR == ecd->type) ? ORCM_PUBSUB_KIND_SAMPLE : ORCM_PUBSUB_KIND_EVENT;
+    OPAL_LIST_FOREACH(item, &ecd->reporter, orcm_value_t) {
+        if (NULL == item->value.key || OPAL_STRING != item->value.type) {
+            continue;
+        }
+        if (NULL == host && 0 == strcmp(item->value.key, "hostname")) {
+            host = item->value.data.string;
+        } else if (NULL == group && 0 == strcmp(item->value.key, "data_group")) {
+            group = item->value.data.string;
+        }
+    }
+    if (NULL == group) {
+        group = orcm_evgen_base_print_type(ecd->type);
+    }
+
+    OPAL_LIST_FOREACH_SAFE(sub, next, &subscribers, orcm_pubsub_subscriber_t) {
+        if (!orcm_pubsub_filter_match(sub->filter, kind, host, group)) {
+            continue;
+        }
+        if (NULL == rec) {
+            rec = build_record(ecd, kind, host, group);
+        }
+        if (NULL == sub->filter->metrics || ORCM_PUBSUB_KIND_SAMPLE != kind) {
+            /* pack once and share the buffer across subscribers - if
+             * that fails, the ones with their own metric filters may
+             * still get theirs */
+            if (NULL == shared && !shared_failed) {
+                shared = OBJ_NEW(opal_buffer_t);
+                if (ORCM_SUCCESS != orcm_pubsub_record_pack(shared, rec, NULL)) {
+                    OBJ_RELEASE(shared);
+                    shared_failed = true;
+                }
+            }
+            if (NULL != shared) {
+                orcm_pubsub_subscriber_enqueue(sub, shared, 1);
+            }
+        } else {
+            buf = OBJ_NEW(opal_buffer_t);
+            if (ORCM_SUCCESS == orcm_pubsub_record_pack(buf, rec, sub->filter)) {
+                orcm_pubsub_subscriber_enqueue(sub, buf, 1);
+            }
+            OBJ_RELEASE(buf);
+        }
+    }
+
+    SAFE_RELEASE(shared);
+    SAFE_RELEASE(rec);
+}
+
+int orcm_evgen_base_pubsub_init(void)
+{
+    OBJ_CONSTRUCT(&subscribers, opal_list_t);
+    pubsub_initialized = true;
+
+    /* samples and events only flow through aggregators */
+    if (!ORCM_PROC_IS_AGGREGATOR) {
+        return ORCM_SUCCESS;
+    }
+
+    orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD, ORCM_RML_TAG_PUBSUB,
+                            ORTE_RML_PERSISTENT, pubsub_recv, NULL);
+
+    if (NULL != orcm_evgen_base.pubsub_socket) {
+        listener = orcm_pubsub_listen(orcm_evgen_base.pubsub_socket, orcm_evgen_evbase,
+                                      orcm_evgen_base.pubsub_max_queue,
+                                      pubsub_accept, pubsub_lost);
+        if (NULL == listener) {
+            opal_output(0, "%s evgen:base:pubsub unable to listen on %s",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                        orcm_evgen_base.pubsub_socket);
+        }
+    }
+    pubsub_active = true;
+
+    return ORCM_SUCCESS;
+}
+
+static void pubsub_shutdown(int fd, short args, void *cbdata)
+{
+    evgen_pubsub_caddy_t *caddy = (evgen_pubsub_caddy_t*)cbdata;
+    orcm_pubsub_subscriber_t *sub;
+
+    pubsub_active = false;
+    SAFE_RELEASE(listener);
+    listener = NULL;
+    while (NULL != (sub = (orcm_pubsub_subscriber_t*)opal_list_remove_first(&subscribers))) {
+        orcm_pubsub_subscriber_close(sub);
+        OBJ_RELEASE(sub);
+    }
+    caddy->active = false;
+}
+
+void orcm_evgen_base_pubsub_finalize(void)
+{
+    evgen_pubsub_caddy_t *caddy;
+
+    /* the framework closes even when opening it failed early */
+    if (!pubsub_initialized) {
+        return;
+    }
+    if (pubsub_active) {
+        orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_PUBSUB);
+
+        /* the subscribers belong to the evgen thread, so
+         * tear them down there */
+        caddy = OBJ_NEW(evgen_pubsub_caddy_t);
+        opal_event_set(orcm_evgen_evbase, &caddy->ev, -1, OPAL_EV_WRITE,
+                       pubsub_shutdown, caddy);
+        opal_event_active(&caddy->ev, OPAL_EV_WRITE, 1);
+        ORTE_WAIT_FOR_COMPLETION(caddy->active);
+        OBJ_RELEASE(caddy);
+    }
+    OPAL_LIST_DESTRUCT(&subscribers);
+    pubsub_initialized = false;
+}
@@ -25,6 +25,7 @@
 #include <time.h>
 
 #include "orcm/mca/mca.h"
+#include "orcm/util/value_batch.h"
 
 BEGIN_C_DECLS
 
@@ -125,6 +126,10 @@ typedef struct {
      * or for a window of sensor values around that time */
     opal_list_t data;
 
+    /* if the values above were built in a batch, the
+     * batch that holds them - NULL otherwise */
+    orcm_value_batch_t *batch;
+
     /* the callback function, if once was given */
     orcm_ras_evgen_cbfunc_t cbfunc;
     void *cbdata;
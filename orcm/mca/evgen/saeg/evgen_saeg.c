@@ -42,6 +42,7 @@
 #include "orcm/mca/db/db.h"
 #include "orcm/runtime/orcm_globals.h"
 #include "orcm/util/utils.h"
+#include "orcm/util/value_batch.h"
 #include "orcm/mca/evgen/base/base.h"
 #include "orcm/mca/evgen/saeg/evgen_saeg.h"
 
@@ -173,19 +174,34 @@ static void saeg_finalize(void)
     return;
 }
 
+static orcm_value_t* saeg_load_value(orcm_ras_event_t *ecd, const char *key,
+                                     void *data, opal_data_type_t type)
+{
+    if (NULL != ecd->batch) {
+        return orcm_value_batch_load(ecd->batch, key, data, type, NULL);
+    }
+    return orcm_util_load_orcm_value(key, data, type, NULL);
+}
+
 static opal_list_t* saeg_convert_event_data_to_list(orcm_ras_event_t *ecd)
 {
     orcm_value_t *metric = NULL;
     struct timeval eventtime;
     opal_list_t *input_list = NULL;
 
-    input_list = OBJ_NEW(opal_list_t);
+    /* when the event was built in a batch, the list keeps that
+     * batch alive until the database is done with the values */
+    if (NULL != ecd->batch) {
+        input_list = orcm_value_batch_new_list(ecd->batch);
+    } else {
+        input_list = OBJ_NEW(opal_list_t);
+    }
     if (NULL == input_list) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
         return NULL;
     }
 
-    metric = orcm_util_load_orcm_value("type", (void *) orcm_evgen_base_print_type(ecd->type), OPAL_STRING, NULL);
+    metric = saeg_load_value(ecd, "type", (void *) orcm_evgen_base_print_type(ecd->type), OPAL_STRING);
     if (NULL == metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
         OBJ_RELEASE(input_list);
@@ -193,7 +209,7 @@ static opal_list_t* saeg_convert_event_data_to_list(orcm_ras_event_t *ecd)
     }
     opal_list_append(input_list, (opal_list_item_t *)metric);
 
-    metric = orcm_util_load_orcm_value("severity", (void *) orcm_evgen_base_print_severity(ecd->severity), OPAL_STRING, NULL);
+    metric = saeg_load_value(ecd, "severity", (void *) orcm_evgen_base_print_severity(ecd->severity), OPAL_STRING);
     if (NULL == metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
         OBJ_RELEASE(input_list);
@@ -204,7 +220,7 @@ static opal_list_t* saeg_convert_event_data_to_list(orcm_ras_event_t *ecd)
     eventtime.tv_sec = ecd->timestamp;
     eventtime.tv_usec = 0L;
 
-    metric = orcm_util_load_orcm_value("ctime", &eventtime, OPAL_TIMEVAL, NULL);
+    metric = saeg_load_value(ecd, "ctime", &eventtime, OPAL_TIMEVAL);
     if (NULL == metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
         OBJ_RELEASE(input_list);
@@ -297,6 +313,10 @@ static void saeg_generate_storage_events(orcm_ras_event_t *ecd)
     opal_list_t *input_list = NULL;
     orcm_value_t *list_item = NULL;
 
+    /* offer every sample and event to live subscribers before
+     * the lists are handed over to the database */
+    orcm_evgen_base_pubsub_publish(ecd);
+
     OPAL_LIST_FOREACH(list_item, &ecd->description, orcm_value_t) {
         if (NULL == list_item->value.key) {
             break;
@@ -307,7 +327,8 @@ static void saeg_generate_storage_events(orcm_ras_event_t *ecd)
                 saeg_generate_notifier_event(ecd);
                 break;
 
-            case ORCM_STORAGE_TYPE_PUBSUB: //Need implementation
+            case ORCM_STORAGE_TYPE_PUBSUB:
+                /* already pushed to live subscribers above */
                 break;
 
             default:
@@ -24,8 +24,12 @@
 #include <dirent.h>
 #endif  /* HAVE_DIRENT_H */
 #include <ctype.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/time.h>
 
 #include "opal/class/opal_list.h"
+#include "opal/class/opal_pointer_array.h"
 #include "opal/util/argv.h"
 #include "opal/util/opal_environ.h"
 #include "opal/util/os_path.h"
@@ -45,9 +49,14 @@
 static bool orcm_pwrmgmt_freq_initialized = false;
 
 typedef struct {
-    opal_list_item_t super;
+    opal_object_t super;
     int core;
     char *directory;
+    /* the cpufreq controls are held open for the life of the tracker
+     * so that changing a setting is a single pwrite */
+    int fd_governor;
+    int fd_max_freq;
+    int fd_min_freq;
     /* save the system settings so we can restore them when we die */
     char *system_governor;
     float system_max_freq;
@@ -66,6 +75,9 @@ typedef struct {
 static void ctr_con(pwrmgmt_freq_tracker_t *trk)
 {
     trk->directory = NULL;
+    trk->fd_governor = -1;
+    trk->fd_max_freq = -1;
+    trk->fd_min_freq = -1;
     trk->system_governor = NULL;
     trk->current_governor = NULL;
     OBJ_CONSTRUCT(&trk->governors, opal_list_t);
@@ -78,6 +90,15 @@ static void ctr_des(pwrmgmt_freq_tracker_t *trk)
     if (NULL != trk->directory) {
         free(trk->directory);
     }
+    if (0 <= trk->fd_governor) {
+        close(trk->fd_governor);
+    }
+    if (0 <= trk->fd_max_freq) {
+        close(trk->fd_max_freq);
+    }
+    if (0 <= trk->fd_min_freq) {
+        close(trk->fd_min_freq);
+    }
     if (NULL != trk->system_governor) {
         free(trk->system_governor);
     }
@@ -88,38 +109,88 @@ static void ctr_des(pwrmgmt_freq_tracker_t *trk)
     OPAL_LIST_DESTRUCT(&trk->frequencies);
 }
 OBJ_CLASS_INSTANCE(pwrmgmt_freq_tracker_t,
-                   opal_list_item_t,
+                   opal_object_t,
                    ctr_con, ctr_des);
 
-static char *orte_getline(FILE *fp)
+/* open a cpufreq control, falling back to read-only so that
+ * unprivileged daemons can still report the current settings */
+static int open_attr(int dirfd, const char *name)
 {
-    char *ret, *buff;
-    char input[1024];
-    int k;
+    int fd;
 
-    ret = fgets(input, 1024, fp);
-    if (NULL != ret) {
-        /* trim the end of the line */
-        for (k=strlen(input)-1; 0 < k && isspace(input[k]); k--) {
-            input[k] = '\0';
-        }
-        buff = strdup(input);
-        return buff;
+    if (0 > (fd = openat(dirfd, name, O_RDWR | O_CLOEXEC))) {
+        fd = openat(dirfd, name, O_RDONLY | O_CLOEXEC);
     }
-    
-    return NULL;
+    return fd;
+}
+
+/* read an attribute from the start and trim the trailing newline */
+static char *read_attr(int fd, char *buf, size_t len)
+{
+    ssize_t n;
+
+    if (0 > fd || 0 >= (n = pread(fd, buf, len - 1, 0))) {
+        return NULL;
+    }
+    buf[n] = '\0';
+    while (0 < n && isspace(buf[n-1])) {
+        buf[--n] = '\0';
+    }
+    return buf;
+}
+
+/* read an attribute that is only needed once */
+static char *read_attr_once(int dirfd, const char *name, char *buf, size_t len)
+{
+    int fd;
+    char *ret;
+
+    if (0 > (fd = openat(dirfd, name, O_RDONLY | O_CLOEXEC))) {
+        return NULL;
+    }
+    ret = read_attr(fd, buf, len);
+    close(fd);
+    return ret;
 }
 
-static opal_list_t tracking;
+static int write_attr(int fd, const char *val)
+{
+    size_t len = strlen(val);
+
+    if (0 > fd || (ssize_t)len != pwrite(fd, val, len, 0)) {
+        return ORCM_ERR_FILE_WRITE_FAILURE;
+    }
+    return ORCM_SUCCESS;
+}
+
+/* trackers indexed by core number */
+static opal_pointer_array_t tracking;
+static int num_tracked = 0;
+static orcm_pwrmgmt_freq_stats_t apply_stats;
+
+static pwrmgmt_freq_tracker_t *get_tracker(int cpu)
+{
+    if (0 > cpu || cpu >= opal_pointer_array_get_size(&tracking)) {
+        return NULL;
+    }
+    return (pwrmgmt_freq_tracker_t*)opal_pointer_array_get_item(&tracking, cpu);
+}
+
+#define FOREACH_TRACKER(trk, cpu, i)                                        \
+    for ((i) = (-1 == (cpu)) ? 0 : (cpu);                                   \
+         (i) < opal_pointer_array_get_size(&tracking) &&                    \
+             (-1 == (cpu) || (i) == (cpu));                                 \
+         (i)++)                                                             \
+        if (NULL != ((trk) = get_tracker(i)))
 
 int orcm_pwrmgmt_freq_init(void)
 {
     int k;
     int length;
+    int dirfd;
     DIR *cur_dirp = NULL;
     struct dirent *entry;
-    char *filename, *tmp, **vals;
-    FILE *fp;
+    char buf[4096], *tmp, **vals;
     pwrmgmt_freq_tracker_t *trk;
     opal_value_t *kv;
 
@@ -129,7 +200,10 @@ int orcm_pwrmgmt_freq_init(void)
     }
 
     /* always construct this so we don't segfault in finalize */
-    OBJ_CONSTRUCT(&tracking, opal_list_t);
+    OBJ_CONSTRUCT(&tracking, opal_pointer_array_t);
+    opal_pointer_array_init(&tracking, 16, INT_MAX, 16);
+    num_tracked = 0;
+    memset(&apply_stats, 0, sizeof(apply_stats));
 
     /*
      * Open up the base directory so we can get a listing
@@ -186,71 +260,41 @@ int orcm_pwrmgmt_freq_init(void)
             OBJ_RELEASE(trk);
             continue;
         }
-        
-        /* read/save the current settings */
-        if(NULL == (filename = opal_os_path(false, trk->directory, "scaling_governor", NULL))) { 
-            OBJ_RELEASE(trk);
-            continue;
-        if (NULL == (fp = fopen(filename, "rw"))) {
-            free(filename);
+        /* everything below is relative to the cpufreq directory */
+        if (0 > (dirfd = open(trk->directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC))) {
             OBJ_RELEASE(trk);
             continue;
         }
-        trk->system_governor = orte_getline(fp);
-        trk->current_governor = strdup(trk->system_governor);
-        fclose(fp);
-        free(filename);
 
-        if(NULL == (filename = opal_os_path(false, trk->directory, "scaling_max_freq", NULL))) {
+        /* open the controls and read/save the current settings */
+        trk->fd_governor = open_attr(dirfd, "scaling_governor");
+        trk->fd_max_freq = open_attr(dirfd, "scaling_max_freq");
+        trk->fd_min_freq = open_attr(dirfd, "scaling_min_freq");
+        if (NULL == read_attr(trk->fd_governor, buf, sizeof(buf))) {
+            close(dirfd);
             OBJ_RELEASE(trk);
             continue;
         }
-        if (NULL == (fp = fopen(filename, "rw"))) {
-            free(filename);
+        trk->system_governor = strdup(buf);
+        trk->current_governor = strdup(buf);
+        if (NULL == read_attr(trk->fd_max_freq, buf, sizeof(buf))) {
+            close(dirfd);
             OBJ_RELEASE(trk);
             continue;
         }
-        if(NULL !=(tmp = orte_getline(fp))) {
-            trk->system_max_freq = strtoul(tmp, NULL, 10) / 1000000.0;
-            trk->current_max_freq = trk->system_max_freq;
-            free(tmp);
-        }
-        fclose(fp);
-        free(filename);
-
-        if(NULL == (filename = opal_os_path(false, trk->directory, "scaling_min_freq", NULL))) {
+        trk->system_max_freq = strtoul(buf, NULL, 10) / 1000000.0;
+        trk->current_max_freq = trk->system_max_freq;
+        if (NULL == read_attr(trk->fd_min_freq, buf, sizeof(buf))) {
+            close(dirfd);
             OBJ_RELEASE(trk);
             continue;
         }
-        if (NULL == (fp = fopen(filename, "rw"))) {
-            free(filename);
-            OBJ_RELEASE(trk);
-            continue;
-        }
-        if(NULL != (tmp = orte_getline(fp))) {
-            trk->system_min_freq = strtoul(tmp, NULL, 10) / 1000000.0;
-            trk->current_min_freq = trk->system_min_freq;
-            free(tmp);
-        }
-        fclose(fp);
-        free(filename);
+        trk->system_min_freq = strtoul(buf, NULL, 10) / 1000000.0;
+        trk->current_min_freq = trk->system_min_freq;
 
         /* get the list of available governors */
-        if(NULL == (filename = opal_os_path(false, trk->directory, "scaling_available_governors", NULL))) {
-            OBJ_RELEASE(trk);
-            continue;
-        }
-        if (NULL == (fp = fopen(filename, "r"))) {
-            free(filename);
-            OBJ_RELEASE(trk);
-            continue;
-        }
-        tmp = orte_getline(fp);
-        fclose(fp);
-        free(filename);
-        if (NULL != tmp) {
+        if (NULL != (tmp = read_attr_once(dirfd, "scaling_available_governors", buf, sizeof(buf)))) {
             vals = opal_argv_split(tmp, ' ');
-            free(tmp);
             if(NULL != vals) {
                 for (k=0; NULL != vals[k]; k++) {
                     kv = OBJ_NEW(opal_value_t);
@@ -263,22 +307,8 @@ int orcm_pwrmgmt_freq_init(void)
         }
 
         /* get the list of available frequencies */
-        if(NULL == (filename = opal_os_path(false, trk->directory, "scaling_available_frequencies", NULL))) {
-            OBJ_RELEASE(trk);
-            continue;
-        }
-        }
-        if (NULL == (fp = fopen(filename, "r"))) {
-            free(filename);
-            OBJ_RELEASE(trk);
-            continue;
-        }
-        tmp = orte_getline(fp);
-        fclose(fp);
-        free(filename);
-        if (NULL != tmp) {
+        if (NULL != (tmp = read_attr_once(dirfd, "scaling_available_frequencies", buf, sizeof(buf)))) {
             vals = opal_argv_split(tmp, ' ');
-            free(tmp);
             if(NULL != vals) {
                 for (k=0; NULL != vals[k]; k++) {
                     kv = OBJ_NEW(opal_value_t);
@@ -291,34 +321,34 @@ int orcm_pwrmgmt_freq_init(void)
         }
 
         /* see if setspeed is supported */
-        if(NULL == (filename = opal_os_path(false, trk->directory, "scaling_setspeed", NULL))) {
-            OBJ_RELEASE(trk);
-            continue;
-        }
-        if (NULL != (fp = fopen(filename, "rw"))) {
+        if (0 == faccessat(dirfd, "scaling_setspeed", R_OK | W_OK, 0)) {
             trk->setspeed = true;
-            fclose(fp);
         }
-        free(filename);
+        close(dirfd);
 
-        /* add to our list */
-        opal_list_append(&tracking, &trk->super);
+        /* add to our table */
+        if (NULL != get_tracker(trk->core) ||
+            OPAL_SUCCESS != opal_pointer_array_set_item(&tracking, trk->core, trk)) {
+            OBJ_RELEASE(trk);
+            continue;
+        }
+        num_tracked++;
     }
     closedir(cur_dirp);
 
-    if (0 == opal_list_get_size(&tracking)) {
+    if (0 == num_tracked) {
         /* nothing to read */
         if (0 < opal_output_get_verbosity(orcm_pwrmgmt_base_framework.framework_output)) {
             orte_show_help("help-rtc-freq.txt", "no-cores-found",
                            true, orte_process_info.nodename);
         }
-        OPAL_LIST_DESTRUCT(&tracking);
+        OBJ_DESTRUCT(&tracking);
         return ORTE_ERROR;
     }
 
     /* report out the results, if requested */
     if (9 < opal_output_get_verbosity(orcm_pwrmgmt_base_framework.framework_output)) {
-        OPAL_LIST_FOREACH(trk, &tracking, pwrmgmt_freq_tracker_t) {
+        FOREACH_TRACKER(trk, -1, k) {
             opal_output(0, "%s\tCore: %d  Governor: %s MaxFreq: %f MinFreq: %f\n",
                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), trk->core,
                         trk->system_governor, trk->system_max_freq, trk->system_min_freq);
@@ -340,7 +370,17 @@ int orcm_pwrmgmt_freq_init(void)
 
 void orcm_pwrmgmt_freq_finalize(void)
 {
-    OPAL_LIST_DESTRUCT(&tracking);
+    int i;
+    pwrmgmt_freq_tracker_t *trk;
+
+    if (!orcm_pwrmgmt_freq_initialized) {
+        return;
+    }
+    FOREACH_TRACKER(trk, -1, i) {
+        OBJ_RELEASE(trk);
+    }
+    OBJ_DESTRUCT(&tracking);
+    num_tracked = 0;
 
     orcm_pwrmgmt_freq_initialized = false;
 
@@ -355,18 +395,16 @@ int orcm_pwrmgm_freq_get_num_cpus(void)
         }
     }
 
-    return opal_list_get_size(&tracking);
+    return num_tracked;
 }
 
 int orcm_pwrmgmt_freq_set_governor(int cpu, char* governor)
 {
-    char *tmp, **vals;
     pwrmgmt_freq_tracker_t *trk;
     opal_value_t *kv;
     bool allowed;
-    char *filename;
-    FILE *fp;
-    int count = 0;
+    char *val;
+    int i, rc;
 
     if(!orcm_pwrmgmt_freq_initialized) {
         if(ORCM_SUCCESS != orcm_pwrmgmt_freq_init()) {
@@ -374,19 +412,11 @@ int orcm_pwrmgmt_freq_set_governor(int cpu, char* governor)
         }
     }
 
-    /* loop thru all the cpus on this node */
-    OPAL_LIST_FOREACH(trk, &tracking, pwrmgmt_freq_tracker_t) {
-        if (cpu != trk->core && -1 != cpu) {
-            continue;
-        }
-    
-        if (-1 != cpu) {
-            count = cpu;
-        }
-
+    /* loop thru all the requested cpus on this node */
+    FOREACH_TRACKER(trk, cpu, i) {
         /* does the requested value match the current setting? */
         if (0 == strcmp(trk->current_governor, governor)) {
-            break;
+            continue;
         }
         /* is the specified governor among those allowed? */
         allowed = false;
@@ -397,129 +427,94 @@ int orcm_pwrmgmt_freq_set_governor(int cpu, char* governor)
             }
         }
         if (!allowed) {
-            vals = NULL;
-            OPAL_LIST_FOREACH(kv, &trk->governors, opal_value_t) {
-                opal_argv_append_nosize(&vals, kv->data.string);
-            }
-            tmp = opal_argv_join(vals, ',');
-            opal_argv_free(vals);
-            free(tmp);
-            
             return ORCM_ERR_NOT_SUPPORTED;
         }
         /* attempt to set the value */
-        if(NULL == (filename = opal_os_path(false, trk->directory, "scaling_governor", NULL))) {
-            return ORCM_ERR_FILE_WRITE_FAILURE;
-        }
-        if (NULL == (fp = fopen(filename, "w"))) {
-            free(filename);
-            return ORCM_ERR_FILE_WRITE_FAILURE;
-        }
         opal_output_verbose(2, orcm_pwrmgmt_base_framework.framework_output,
                             "%s Setting governor %s for cpu %d",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), governor, count);
-        fprintf(fp, "%s\n", governor);
-        fclose(fp);
-        free(filename);
+                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), governor, trk->core);
+        if (0 > asprintf(&val, "%s\n", governor)) {
+            return ORCM_ERR_OUT_OF_RESOURCE;
+        }
+        rc = write_attr(trk->fd_governor, val);
+        free(val);
+        if (ORCM_SUCCESS != rc) {
+            return rc;
+        }
         free(trk->current_governor);
         trk->current_governor = strdup(governor);
-        if(-1 != cpu) {
-            break;
-        }
-        count++;
     }
     return ORCM_SUCCESS;
 }
 
-int orcm_pwrmgmt_freq_set_min_freq(int cpu, float freq)
+static bool freq_allowed(pwrmgmt_freq_tracker_t *trk, float freq)
 {
-    char *tmp, **vals;
-    pwrmgmt_freq_tracker_t *trk;
     opal_value_t *kv;
-    bool allowed;
-    char *filename;
-    FILE *fp;
-    int count = 0;
 
-    if(!orcm_pwrmgmt_freq_initialized) {
-        if(ORCM_SUCCESS != orcm_pwrmgmt_freq_init()) {
-            return ORCM_ERR_NOT_INITIALIZED;
+    OPAL_LIST_FOREACH(kv, &trk->frequencies, opal_value_t) {
+        if (kv->data.fval == freq) {
+            return true;
         }
     }
+    return false;
+}
 
-    /* loop thru all the cpus on this node */
-    OPAL_LIST_FOREACH(trk, &tracking, pwrmgmt_freq_tracker_t) {
-        if (cpu != trk->core && -1 != cpu) {
-            continue;
-        }
+static int write_freq(pwrmgmt_freq_tracker_t *trk, bool max, float freq)
+{
+    char val[32];
+    int rc;
+
+    opal_output_verbose(2, orcm_pwrmgmt_base_framework.framework_output,
+                        "%s Setting %s freq controls to %ld for cpu %d",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), max ? "max" : "min",
+                        (unsigned long)(freq * 1000000.0), trk->core);
+    snprintf(val, sizeof(val), "%ld\n", (unsigned long)(freq * 1000000.0));
+    if (ORCM_SUCCESS != (rc = write_attr(max ? trk->fd_max_freq : trk->fd_min_freq, val))) {
+        /* not allowed - report the error */
+        orte_show_help("help-rtc-freq.txt", "permission-denied", true,
+                       max ? "max freq" : "min freq",
+                       orte_process_info.nodename, trk->directory);
+        return rc;
+    }
+    apply_stats.writes++;
+    if (max) {
+        trk->current_max_freq = freq;
+    } else {
+        trk->current_min_freq = freq;
+    }
+    return ORCM_SUCCESS;
+}
 
-        if (-1 != cpu) {
-            count = cpu;
-        }
+/* move one cpu to the given limits, writing only what changed and
+ * ordering the writes so that min never exceeds max on the way */
+static int apply_tracker(pwrmgmt_freq_tracker_t *trk, float min_freq, float max_freq)
+{
+    int rc;
+    bool set_min, set_max;
 
-        /* does the requested value match the current setting? */
-        if (trk->current_min_freq == freq) {
-            break;
-        }
-        /* is the specified frequency among those allowed? */
-        allowed = false;
-        OPAL_LIST_FOREACH(kv, &trk->frequencies, opal_value_t) {
-            if (kv->data.fval == freq) {
-                allowed = true;
-                break;
-            }
-        }
-        if (!allowed) {
-            vals = NULL;
-            OPAL_LIST_FOREACH(kv, &trk->frequencies, opal_value_t) {
-                asprintf(&tmp, "%f", kv->data.fval);
-                opal_argv_append_nosize(&vals, tmp);
-                free(tmp);
-            }
-            tmp = opal_argv_join(vals, ',');
-            opal_argv_free(vals);
-            free(tmp);
-                
-            return ORCM_ERR_NOT_SUPPORTED;
-        }
-        if(NULL == (filename = opal_os_path(false, trk->directory, "scaling_min_freq", NULL))) {
-            return ORCM_ERR_FILE_WRITE_FAILURE;
+    set_min = (0.0 < min_freq && trk->current_min_freq != min_freq);
+    set_max = (0.0 < max_freq && trk->current_max_freq != max_freq);
+    if (set_max && max_freq >= trk->current_min_freq) {
+        if (ORCM_SUCCESS != (rc = write_freq(trk, true, max_freq))) {
+            return rc;
         }
-        /* attempt to set the value */
-        if (NULL == (fp = fopen(filename, "w"))) {
-            /* not allowed - report the error */
-            orte_show_help("help-rtc-freq.txt", "permission-denied", true,
-                           "min freq", orte_process_info.nodename, filename);
-            free(filename);
-            return ORCM_ERR_FILE_WRITE_FAILURE;
-        }
-        opal_output_verbose(2, orcm_pwrmgmt_base_framework.framework_output,
-                            "%s Setting min freq controls to %ld for cpu %d",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
-                            (unsigned long)(freq * 1000000.0),
-                            count);
-        fprintf(fp, "%ld\n", (unsigned long)(freq * 1000000.0));
-        fclose(fp);
-        free(filename);
-        trk->current_min_freq = freq;
-        if (-1 != cpu) {
-            break;
-        }
-        count++;
+        set_max = false;
+    }
+    if (set_min && ORCM_SUCCESS != (rc = write_freq(trk, false, min_freq))) {
+        return rc;
+    }
+    if (set_max && ORCM_SUCCESS != (rc = write_freq(trk, true, max_freq))) {
+        return rc;
     }
     return ORCM_SUCCESS;
 }
 
-
-int orcm_pwrmgmt_freq_set_max_freq(int cpu, float freq)
+int orcm_pwrmgmt_freq_apply_plan(orcm_pwrmgmt_freq_plan_t *plan, int nentries)
 {
-    char *tmp, **vals;
     pwrmgmt_freq_tracker_t *trk;
-    opal_value_t *kv;
-    bool allowed;
-    char *filename;
-    FILE *fp;
-    int count = 0;
+    struct timeval start, stop;
+    uint64_t usec;
+    int n, i, rc;
 
     if(!orcm_pwrmgmt_freq_initialized) {
         if(ORCM_SUCCESS != orcm_pwrmgmt_freq_init()) {
@@ -527,69 +522,73 @@ int orcm_pwrmgmt_freq_set_max_freq(int cpu, float freq)
         }
     }
 
-    /* loop thru all the cpus on this node */
-    OPAL_LIST_FOREACH(trk, &tracking, pwrmgmt_freq_tracker_t) {
-        if (cpu != trk->core && -1 != cpu) {
-            continue;
-        }
-
-        if (-1 != cpu) {
-            count = cpu;
-        }
-
-        /* does the requested value match the current setting? */
-        if (trk->current_max_freq == freq) {
-            break;
-        }
-        /* is the specified frequency among those allowed? */
-        allowed = false;
-        OPAL_LIST_FOREACH(kv, &trk->frequencies, opal_value_t) {
-            if (kv->data.fval == freq) {
-                allowed = true;
-                break;
+    /* check the whole plan first so that a bad entry changes nothing */
+    for (n = 0; n < nentries; n++) {
+        if (-1 != plan[n].cpu && NULL == get_tracker(plan[n].cpu)) {
+            return ORCM_ERR_NOT_FOUND;
+        }
+        if (0.0 < plan[n].min_freq && 0.0 < plan[n].max_freq &&
+            plan[n].min_freq > plan[n].max_freq) {
+            return ORCM_ERR_BAD_PARAM;
+        }
+        FOREACH_TRACKER(trk, plan[n].cpu, i) {
+            if ((0.0 < plan[n].min_freq && trk->current_min_freq != plan[n].min_freq &&
+                 !freq_allowed(trk, plan[n].min_freq)) ||
+                (0.0 < plan[n].max_freq && trk->current_max_freq != plan[n].max_freq &&
+                 !freq_allowed(trk, plan[n].max_freq))) {
+                return ORCM_ERR_NOT_SUPPORTED;
             }
         }
-        if (!allowed) {
-            vals = NULL;
-            OPAL_LIST_FOREACH(kv, &trk->frequencies, opal_value_t) {
-                asprintf(&tmp, "%f", kv->data.fval);
-                opal_argv_append_nosize(&vals, tmp);
-                free(tmp);
+    }
+
+    gettimeofday(&start, NULL);
+    for (n = 0; n < nentries; n++) {
+        FOREACH_TRACKER(trk, plan[n].cpu, i) {
+            if (ORCM_SUCCESS != (rc = apply_tracker(trk, plan[n].min_freq, plan[n].max_freq))) {
+                return rc;
             }
-            tmp = opal_argv_join(vals, ',');
-            opal_argv_free(vals);
-            free(tmp);
-                
-            return ORCM_ERR_NOT_SUPPORTED;
         }
-        if(NULL == (filename = opal_os_path(false, trk->directory, "scaling_max_freq", NULL))) {
-            return ORCM_ERR_FILE_WRITE_FAILURE;
-        }
-        /* attempt to set the value */
-        if (NULL == (fp = fopen(filename, "w"))) {
-            /* not allowed - report the error */
-            orte_show_help("help-rtc-freq.txt", "permission-denied", true,
-                           "min freq", orte_process_info.nodename, filename);
-            free(filename);
-            return ORCM_ERR_FILE_WRITE_FAILURE;
-        }
-        opal_output_verbose(2, orcm_pwrmgmt_base_framework.framework_output,
-                            "%s Setting max freq controls to %ld for cpu %d",
-                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
-                            (unsigned long)(freq * 1000000.0),
-                            count);
-        fprintf(fp, "%ld\n", (unsigned long)(freq * 1000000.0));
-        fclose(fp);
-        free(filename);
-        trk->current_max_freq = freq;
-        if(-1 != cpu) {
-            break;
-        }
-        count++;
     }
+    gettimeofday(&stop, NULL);
+
+    usec = (stop.tv_sec - start.tv_sec) * 1000000 + (stop.tv_usec - start.tv_usec);
+    apply_stats.applies++;
+    apply_stats.last_usec = usec;
+    apply_stats.total_usec += usec;
+    if (usec > apply_stats.max_usec) {
+        apply_stats.max_usec = usec;
+    }
+    opal_output_verbose(5, orcm_pwrmgmt_base_framework.framework_output,
+                        "%s frequency plan of %d entries applied in %lu usec",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), nentries, (unsigned long)usec);
     return ORCM_SUCCESS;
 }
 
+void orcm_pwrmgmt_freq_get_stats(orcm_pwrmgmt_freq_stats_t *stats)
+{
+    *stats = apply_stats;
+}
+
+int orcm_pwrmgmt_freq_set_min_freq(int cpu, float freq)
+{
+    orcm_pwrmgmt_freq_plan_t plan;
+
+    plan.cpu = cpu;
+    plan.min_freq = freq;
+    plan.max_freq = 0.0;
+    return orcm_pwrmgmt_freq_apply_plan(&plan, 1);
+}
+
+int orcm_pwrmgmt_freq_set_max_freq(int cpu, float freq)
+{
+    orcm_pwrmgmt_freq_plan_t plan;
+
+    plan.cpu = cpu;
+    plan.min_freq = 0.0;
+    plan.max_freq = freq;
+    return orcm_pwrmgmt_freq_apply_plan(&plan, 1);
+}
+
 int orcm_pwrmgmt_freq_get_supported_governors(int cpu, opal_list_t** governors)
 {
     pwrmgmt_freq_tracker_t *trk;
@@ -600,17 +599,11 @@ int orcm_pwrmgmt_freq_get_supported_governors(int cpu, opal_list_t** governors)
         }
     }
 
-    /* loop thru all the cpus on this node */
-    OPAL_LIST_FOREACH(trk, &tracking, pwrmgmt_freq_tracker_t) {
-        if (cpu != trk->core) {
-            continue;
-        }
-       
-        *governors = &trk->governors; 
-        return ORCM_SUCCESS;
+    if (NULL == (trk = get_tracker(cpu))) {
+        return ORCM_ERR_NOT_FOUND;
     }
-    
-    return ORCM_ERR_NOT_FOUND;
+    *governors = &trk->governors; 
+    return ORCM_SUCCESS;
 }
 
 int orcm_pwrmgmt_freq_get_supported_frequencies(int cpu, opal_list_t** frequencies)
@@ -623,17 +616,11 @@ int orcm_pwrmgmt_freq_get_supported_frequencies(int cpu, opal_list_t** frequenci
         }
     }
 
-    /* loop thru all the cpus on this node */
-    OPAL_LIST_FOREACH(trk, &tracking, pwrmgmt_freq_tracker_t) {
-        if (cpu == trk->core) {
-            continue;
-        }
-       
-        *frequencies = &trk->frequencies; 
-        return ORCM_SUCCESS;
+    if (NULL == (trk = get_tracker(cpu))) {
+        return ORCM_ERR_NOT_FOUND;
     }
-    
-    return ORCM_ERR_NOT_FOUND;
+    *frequencies = &trk->frequencies; 
+    return ORCM_SUCCESS;
 }
 
 int orcm_pwrmgmt_freq_reset_system_settings(void)
@@ -641,6 +628,7 @@ int orcm_pwrmgmt_freq_reset_system_settings(void)
     pwrmgmt_freq_tracker_t *trk;
     int rc = ORCM_SUCCESS;
     int err = ORCM_SUCCESS;
+    int i;
 
    if(!orcm_pwrmgmt_freq_initialized) {
         if(ORCM_SUCCESS != orcm_pwrmgmt_freq_init()) {
@@ -649,19 +637,14 @@ int orcm_pwrmgmt_freq_reset_system_settings(void)
     }
 
     /* loop thru all the cpus on this node */
-    OPAL_LIST_FOREACH(trk, &tracking, pwrmgmt_freq_tracker_t) {
+    FOREACH_TRACKER(trk, -1, i) {
         if(ORCM_SUCCESS != (err = orcm_pwrmgmt_freq_set_governor(trk->core, trk->system_governor))) {
             rc = err;
         }
-        if(ORCM_SUCCESS != (err = orcm_pwrmgmt_freq_set_min_freq(trk->core, trk->system_min_freq))) {
-            rc = err;
-        }
-        if(ORCM_SUCCESS != (err = orcm_pwrmgmt_freq_set_max_freq(trk->core, trk->system_max_freq))) {
+        if(ORCM_SUCCESS != (err = apply_tracker(trk, trk->system_min_freq, trk->system_max_freq))) {
             rc = err;
         }
     }
  
     return rc;
 }
-
-
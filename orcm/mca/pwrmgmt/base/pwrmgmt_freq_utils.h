@@ -18,6 +18,27 @@
 
 BEGIN_C_DECLS
 
+/**
+ * One entry of a frequency plan - the limits a cpu should run at.
+ * A zero limit leaves that setting as it is.
+ */
+typedef struct {
+    int cpu;            /* the target cpu (-1 for all cpus) */
+    float min_freq;
+    float max_freq;
+} orcm_pwrmgmt_freq_plan_t;
+
+/**
+ * Actuation counters kept by orcm_pwrmgmt_freq_apply_plan
+ */
+typedef struct {
+    uint64_t applies;       /* plans applied */
+    uint64_t writes;        /* sysfs writes actually issued */
+    uint64_t last_usec;     /* time taken by the last plan */
+    uint64_t max_usec;
+    uint64_t total_usec;
+} orcm_pwrmgmt_freq_stats_t;
+
 /**
  * initialize the frequency/governor tracker
  *
@@ -87,6 +108,33 @@ int orcm_pwrmgmt_freq_set_max_freq(int cpu, float freq);
  */
 int orcm_pwrmgmt_freq_set_min_freq(int cpu, float freq);
 
+/**
+ * Apply a frequency plan
+ *
+ * Moves every cpu named in the plan to its new limits. Only settings
+ * that differ from the current ones are written, and min/max are
+ * written in whichever order keeps min below max throughout. The
+ * whole plan is checked before anything is written.
+ *
+ * @param[in] plan - array of plan entries
+ * @param[in] nentries - number of entries in the plan
+ *
+ * @retval ORTE_SUCCESS Success
+ * @retval ORCM_ERR_NOT_INITIALIZED init could not be completed
+ * @retval ORCM_ERR_NOT_FOUND an entry names an unknown cpu
+ * @retval ORCM_ERR_BAD_PARAM an entry asks for min above max
+ * @retval ORCM_ERR_NOT_SUPPORTED a requested frequency is not supported
+ * @retval ORCM_ERR_FILE_WRITE_FAILURE a control could not be written
+ */
+int orcm_pwrmgmt_freq_apply_plan(orcm_pwrmgmt_freq_plan_t *plan, int nentries);
+
+/**
+ * Get the actuation counters
+ *
+ * @param[out] stats - counters since init
+ */
+void orcm_pwrmgmt_freq_get_stats(orcm_pwrmgmt_freq_stats_t *stats);
+
 /**
  * Get the list of supported governors for a cpu
  *
@@ -156,6 +156,17 @@ error:
     return ORCM_ERROR;
 }
 
+/* pin every cpu to a single frequency */
+static int set_frequency(float freq)
+{
+    orcm_pwrmgmt_freq_plan_t plan;
+
+    plan.cpu = -1;
+    plan.min_freq = freq;
+    plan.max_freq = freq;
+    return orcm_pwrmgmt_freq_apply_plan(&plan, 1);
+}
+
 static int set_attributes(orcm_session_id_t session, opal_list_t* attr) 
 {
     opal_output_verbose(5, orcm_pwrmgmt_base_framework.framework_output,
@@ -190,10 +201,7 @@ static int set_attributes(orcm_session_id_t session, opal_list_t* attr)
     if(fabsf(freq - ORCM_PWRMGMT_MAX_FREQ) < 0.0001) {
         orcm_pwrmgmt_freq_get_supported_frequencies(0, &data);
         frequency = ((opal_value_t*)opal_list_get_first(data))->data.fval;
-        if (ORCM_SUCCESS != (rc = orcm_pwrmgmt_freq_set_max_freq(-1, frequency))) {
-            return rc;
-        }
-        if (ORCM_SUCCESS != (rc = orcm_pwrmgmt_freq_set_min_freq(-1, frequency))) {
+        if (ORCM_SUCCESS != (rc = set_frequency(frequency))) {
             return rc;
         }
         return ORCM_SUCCESS;
@@ -201,10 +209,7 @@ static int set_attributes(orcm_session_id_t session, opal_list_t* attr)
     if(fabsf(freq - ORCM_PWRMGMT_MIN_FREQ) < 0.0001) {
         orcm_pwrmgmt_freq_get_supported_frequencies(0, &data);
         frequency = ((opal_value_t*)opal_list_get_last(data))->data.fval;
-        if (ORCM_SUCCESS != (rc = orcm_pwrmgmt_freq_set_max_freq(-1, frequency))) {
-            return rc;
-        }
-        if (ORCM_SUCCESS != (rc = orcm_pwrmgmt_freq_set_min_freq(-1, frequency))) {
+        if (ORCM_SUCCESS != (rc = set_frequency(frequency))) {
             return rc;
         }
         return ORCM_SUCCESS;
@@ -237,10 +242,7 @@ static int set_attributes(orcm_session_id_t session, opal_list_t* attr)
                                     ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
                                     frequency);
 
-                if (ORCM_SUCCESS != (rc = orcm_pwrmgmt_freq_set_max_freq(-1, frequency))) {
-                    return rc;
-                }
-                if (ORCM_SUCCESS != (rc = orcm_pwrmgmt_freq_set_min_freq(-1, frequency))) {
+                if (ORCM_SUCCESS != (rc = set_frequency(frequency))) {
                     return rc;
                 }
             }
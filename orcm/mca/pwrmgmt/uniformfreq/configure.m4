@@ -0,0 +1,29 @@
+dnl -*- shell-script -*-
+dnl
+dnl Copyright (c) 2016      Intel, Inc. All rights reserved.
+dnl $COPYRIGHT$
+dnl 
+dnl Additional copyrights may follow
+dnl 
+dnl $HEADER$
+dnl
+
+# MCA_pwrmgmt_uniformfreq_CONFIG([action-if-found], [action-if-not-found])
+# -----------------------------------------------------------
+AC_DEFUN([MCA_orcm_pwrmgmt_uniformfreq_CONFIG], [
+    AC_CONFIG_FILES([orcm/mca/pwrmgmt/uniformfreq/Makefile])
+
+    AC_ARG_WITH([uniformfreq],
+                [AC_HELP_STRING([--with-uniformfreq],
+                                [Build uniformfreq support (default: yes)])])
+
+    # do not build if support not requested
+    AS_IF([test "$with_uniformfreq" != "no"],
+          [AS_IF([test "$opal_found_linux" = "yes"],
+                 [$1],
+                 [AS_IF([test ! -z "$with_uniformfreq"],
+                        [AC_MSG_WARN([Uniform frequency power capping was requested but is only supported on Linux systems])
+                         AC_MSG_ERROR([Cannot continue])])
+                  $2])],
+          [$2])
+])dnl
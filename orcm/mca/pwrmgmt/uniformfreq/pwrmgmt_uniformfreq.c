@@ -0,0 +1,764 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+#include "orcm/types.h"
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif  /* HAVE_UNISTD_H */
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif  /* HAVE_STRING_H */
+#include <stdio.h>
+#include <sys/time.h>
+#include <math.h>
+
+#include "opal_stdint.h"
+#include "opal/class/opal_hash_table.h"
+#include "opal/class/opal_list.h"
+#include "opal/dss/dss.h"
+#include "opal/mca/event/event.h"
+#include "opal/util/argv.h"
+#include "opal/util/output.h"
+
+#include "orte/util/name_fns.h"
+#include "orte/runtime/orte_globals.h"
+#include "orte/mca/errmgr/errmgr.h"
+#include "orte/mca/rml/rml.h"
+#include "orte/util/regex.h"
+
+#include "orcm/runtime/orcm_globals.h"
+#include "orcm/mca/cfgi/base/base.h"
+#include "orcm/mca/scd/base/base.h"
+#include "orcm/mca/sensor/sensor.h"
+#include "orcm/mca/pwrmgmt/base/base.h"
+#include "orcm/mca/pwrmgmt/base/pwrmgmt_freq_utils.h"
+#include "pwrmgmt_uniformfreq.h"
+#include "pwrmgmt_uniformfreq_ctl.h"
+
+/* declare the API functions */
+static int init(void);
+static void finalize(void);
+static int  alloc_notify(orcm_alloc_t* alloc);
+static void dealloc_notify(orcm_alloc_t* alloc);
+static int component_select(orcm_session_id_t session, opal_list_t* attr);
+static int set_attributes(orcm_session_id_t session, opal_list_t* attr);
+static int reset_attributes(orcm_session_id_t session, opal_list_t* attr);
+static int get_attributes(orcm_session_id_t session, opal_list_t* attr);
+
+/* instantiate the module */
+orcm_pwrmgmt_base_API_module_t orcm_pwrmgmt_uniformfreq_module = {
+    init,
+    finalize,
+    component_select,
+    alloc_notify,
+    dealloc_notify,
+    set_attributes,
+    reset_attributes,
+    get_attributes
+};
+
+static const char *component_name = "uniform_frequency";
+
+/* ladder used in test mode when the node reports no frequencies */
+static const float sim_freqs[] = {2.4, 2.2, 2.0, 1.8, 1.6, 1.4, 1.2};
+
+/* state of the allocation we are capping - a daemon only
+ * belongs to one power managed allocation at a time */
+typedef struct {
+    bool active;
+    orcm_alloc_id_t id;
+    orte_process_name_t head;
+    bool is_head;
+    int32_t budget;
+
+    /* the head keeps the latest report of every node
+     * of the allocation, indexed through node_index */
+    orte_process_name_t *nodes;
+    double *reports;
+    int nnodes;
+    opal_hash_table_t node_index;
+    bool indexed;
+    orcm_pwrmgmt_uniformfreq_ctl_t ctl;
+    struct timeval last_step;
+
+    /* every node */
+    opal_event_t timer;
+    struct timeval period;
+    float freq;
+    float fmax;
+    float fmin;
+    /* periods the outstanding sensor sample has been pending */
+    int measuring;
+} uniformfreq_state_t;
+
+static uniformfreq_state_t state;
+
+/* carries a power reading from the sensor thread to ours */
+typedef struct {
+    opal_object_t super;
+    opal_event_t ev;
+    bool sampled;
+    double power;
+} uniformfreq_reading_t;
+static OBJ_CLASS_INSTANCE(uniformfreq_reading_t,
+                          opal_object_t,
+                          NULL, NULL);
+
+static void recv_ctl(int status, orte_process_name_t* sender,
+                     opal_buffer_t *buffer,
+                     orte_rml_tag_t tag, void *cbdata);
+
+static int init(void)
+{
+    return ORCM_SUCCESS;
+}
+
+static void finalize(void)
+{
+}
+
+static bool get_int32(opal_list_t *attr, orte_attribute_key_t key, int32_t *value)
+{
+    int32_t *ptr = value;
+
+    return orte_get_attribute(attr, key, (void**)&ptr, OPAL_INT32);
+}
+
+static bool is_our_mode(opal_list_t *attr)
+{
+    int32_t mode;
+
+    if (!get_int32(attr, ORCM_PWRMGMT_POWER_MODE_KEY, &mode)) {
+        opal_output(0, "pwrmgmt:uniformfreq: no mode was specified in constraints");
+        return false;
+    }
+    return (ORCM_PWRMGMT_MODE_AUTO_UNIFORM_FREQ == mode);
+}
+
+static int component_select(orcm_session_id_t session, opal_list_t* attr)
+{
+    opal_output_verbose(5, orcm_pwrmgmt_base_framework.framework_output,
+                        "%s pwrmgmt:uniformfreq: component select called",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
+
+    int32_t budget;
+    char* name = NULL;
+    opal_list_t* data = NULL;
+    opal_value_t *kv;
+    bool governor_supported = false;
+    int rc = ORCM_ERROR;
+
+    if (!is_our_mode(attr)) {
+        //we cannot handle this request
+        return ORCM_ERROR;
+    }
+    /* there is nothing to hold the allocation to without a budget */
+    if (!get_int32(attr, ORCM_PWRMGMT_POWER_BUDGET_KEY, &budget) || 0 >= budget) {
+        opal_output_verbose(1, orcm_pwrmgmt_base_framework.framework_output,
+                            "%s pwrmgmt:uniformfreq: no power budget for this allocation",
+                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
+        return ORCM_ERROR;
+    }
+
+    if (!ORTE_PROC_IS_SCHEDULER) {
+        if (true != orte_get_attribute(attr, ORCM_PWRMGMT_SELECTED_COMPONENT_KEY, (void**)&name, OPAL_STRING)) {
+            opal_output(0, "pwrmgmt:uniformfreq: No global component has been chosen");
+            goto done;
+        }
+        if (strncmp(name, component_name, strlen(component_name))) {
+            //We can handle this mode, but we are not the selected component
+            goto done;
+        }
+    }
+
+    if (ORTE_PROC_IS_DAEMON && !mca_pwrmgmt_uniformfreq_component.test) {
+        //We require the userspace governor in order to operate
+        orcm_pwrmgmt_freq_init();
+        orcm_pwrmgmt_freq_get_supported_governors(0, &data);
+        if (NULL != data) {
+            OPAL_LIST_FOREACH(kv, data, opal_value_t) {
+                if (0 == strcmp(kv->data.string, "userspace")) {
+                    governor_supported = true;
+                    break;
+                }
+            }
+        }
+        if (false == governor_supported) {
+            opal_output(0, "pwrmgmt:uniformfreq: userspace governor is not supported");
+            goto done;
+        }
+    }
+    rc = ORCM_SUCCESS;
+
+ done:
+    if (NULL != name) {
+        free(name);
+    }
+    return rc;
+}
+
+/* the head picks up changed limits on the next control period */
+static int set_attributes(orcm_session_id_t session, opal_list_t* attr)
+{
+    opal_output_verbose(5, orcm_pwrmgmt_base_framework.framework_output,
+                        "%s pwrmgmt:uniformfreq: set attributes called",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
+
+    int32_t value;
+
+    if (!is_our_mode(attr)) {
+        opal_output(0, "pwrmgmt:uniformfreq: Got an incorrect mode for this component");
+        return ORCM_ERROR;
+    }
+    if (get_int32(attr, ORCM_PWRMGMT_POWER_BUDGET_KEY, &value) && 0 < value) {
+        state.budget = value;
+        state.ctl.budget = value;
+    }
+    if (get_int32(attr, ORCM_PWRMGMT_CAP_OVERAGE_LIMIT_KEY, &value) && 0 <= value) {
+        state.ctl.overage = value;
+    }
+    if (get_int32(attr, ORCM_PWRMGMT_CAP_UNDERAGE_LIMIT_KEY, &value) && 0 <= value) {
+        state.ctl.underage = value;
+    }
+    if (get_int32(attr, ORCM_PWRMGMT_CAP_OVERAGE_TIME_LIMIT_KEY, &value) && 0 <= value) {
+        state.ctl.overage_time = value;
+    }
+    if (get_int32(attr, ORCM_PWRMGMT_CAP_UNDERAGE_TIME_LIMIT_KEY, &value) && 0 <= value) {
+        state.ctl.underage_time = value;
+    }
+    if (get_int32(attr, ORCM_PWRMGMT_POWER_WINDOW_KEY, &value) && 0 < value) {
+        state.period.tv_sec = value / 1000;
+        state.period.tv_usec = (value % 1000) * 1000;
+    }
+    return ORCM_SUCCESS;
+}
+
+static int reset_attributes(orcm_session_id_t session, opal_list_t* attr)
+{
+    opal_output_verbose(5, orcm_pwrmgmt_base_framework.framework_output,
+                        "%s pwrmgmt:uniformfreq: reset attributes called",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
+
+    char* name;
+
+    if (!is_our_mode(attr)) {
+        opal_output(0, "pwrmgmt:uniformfreq: Got an incorrect mode for this component");
+        return ORCM_ERROR;
+    }
+    if (true != orte_get_attribute(attr, ORCM_PWRMGMT_SELECTED_COMPONENT_KEY, (void**)&name, OPAL_STRING)) {
+        //Nothing to do
+        return ORCM_SUCCESS;
+    }
+    if (strncmp(name, component_name, strlen(component_name))) {
+        //we are not the selected component
+        free(name);
+        return ORCM_ERROR;
+    }
+    orte_remove_attribute(attr, ORCM_PWRMGMT_SELECTED_COMPONENT_KEY);
+    free(name);
+
+    return ORCM_SUCCESS;
+}
+
+static int get_attributes(orcm_session_id_t session, opal_list_t* attr)
+{
+    opal_output_verbose(5, orcm_pwrmgmt_base_framework.framework_output,
+                        "%s pwrmgmt:uniformfreq: get attributes called",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
+
+    int32_t mode = ORCM_PWRMGMT_MODE_AUTO_UNIFORM_FREQ;
+
+    if (ORCM_SUCCESS != orte_set_attribute(attr, ORCM_PWRMGMT_POWER_MODE_KEY, ORTE_ATTR_GLOBAL, &mode, OPAL_INT32)) {
+        return ORCM_ERROR;
+    }
+    if (ORCM_SUCCESS != orte_set_attribute(attr, ORCM_PWRMGMT_SELECTED_COMPONENT_KEY, ORTE_ATTR_GLOBAL, &component_name, OPAL_STRING)) {
+        return ORCM_ERROR;
+    }
+    if (ORCM_SUCCESS != orte_set_attribute(attr, ORCM_PWRMGMT_POWER_BUDGET_KEY, ORTE_ATTR_GLOBAL, &state.budget, OPAL_INT32)) {
+        return ORCM_ERROR;
+    }
+    /* the frequency the loop currently runs everyone at */
+    if (ORCM_SUCCESS != orte_set_attribute(attr, ORCM_PWRMGMT_MANUAL_FREQUENCY_KEY, ORTE_ATTR_GLOBAL, &state.freq, OPAL_FLOAT)) {
+        return ORCM_ERROR;
+    }
+    return ORCM_SUCCESS;
+}
+
+/****    POWER READINGS    ****/
+
+static double simulated_power(void)
+{
+    double ratio = (0.0 < state.fmax) ? state.freq / state.fmax : 1.0;
+
+    return mca_pwrmgmt_uniformfreq_component.sim_idle_watts +
+           mca_pwrmgmt_uniformfreq_component.sim_dynamic_watts * ratio * ratio * ratio;
+}
+
+/* sum every positive float left in a sample */
+static double sum_floats(opal_buffer_t *sample, int32_t count)
+{
+    float value;
+    double sum = -1.0;
+    int32_t i, n;
+
+    for (i = 0; i < count; i++) {
+        n = 1;
+        if (OPAL_SUCCESS != opal_dss.unpack(sample, &value, &n, OPAL_FLOAT)) {
+            break;
+        }
+        if (0.0 < value) {
+            sum = (0.0 > sum) ? value : sum + value;
+        }
+    }
+    return sum;
+}
+
+/* dig the node power out of a nodepower or componentpower sample */
+static double sample_power(opal_buffer_t *sample, const char *sensor)
+{
+    struct timeval tv;
+    int32_t n, nsockets;
+    char *hostname = NULL;
+
+    n = 1;
+    if (OPAL_SUCCESS != opal_dss.unpack(sample, &hostname, &n, OPAL_STRING)) {
+        return -1.0;
+    }
+    free(hostname);
+    if (0 == strcmp(sensor, "componentpower")) {
+        n = 1;
+        if (OPAL_SUCCESS != opal_dss.unpack(sample, &nsockets, &n, OPAL_INT32)) {
+            return -1.0;
+        }
+    }
+    n = 1;
+    if (OPAL_SUCCESS != opal_dss.unpack(sample, &tv, &n, OPAL_TIMEVAL)) {
+        return -1.0;
+    }
+    if (0 == strcmp(sensor, "nodepower")) {
+        return sum_floats(sample, 1);
+    }
+    /* package and dram power of each socket */
+    return sum_floats(sample, 2 * nsockets);
+}
+
+static void reading_ready(int fd, short args, void *cbdata);
+
+/* runs in the sensor thread - parse, then hand the answer to ours */
+static void sampled(opal_buffer_t *buf, void *cbdata)
+{
+    uniformfreq_reading_t *reading;
+    opal_buffer_t *sample;
+    double node = -1.0, components = -1.0, power;
+    char *sensor;
+    int32_t n = 1;
+
+    while (OPAL_SUCCESS == opal_dss.unpack(buf, &sample, &n, OPAL_BUFFER)) {
+        n = 1;
+        sensor = NULL;
+        if (OPAL_SUCCESS == opal_dss.unpack(sample, &sensor, &n, OPAL_STRING)) {
+            if (0 == strcmp(sensor, "nodepower")) {
+                node = sample_power(sample, sensor);
+            } else if (0 == strcmp(sensor, "componentpower")) {
+                components = sample_power(sample, sensor);
+            }
+            free(sensor);
+        }
+        OBJ_RELEASE(sample);
+        n = 1;
+    }
+    /* the whole node beats the sum of its parts */
+    power = (0.0 < node) ? node : components;
+
+    reading = OBJ_NEW(uniformfreq_reading_t);
+    reading->sampled = true;
+    reading->power = power;
+
+    opal_event_set(orte_event_base, &reading->ev, -1, OPAL_EV_WRITE, reading_ready, reading);
+    opal_event_set_priority(&reading->ev, ORTE_SYS_PRI);
+    opal_event_active(&reading->ev, OPAL_EV_WRITE, 1);
+}
+
+static void measure(void)
+{
+    uniformfreq_reading_t *reading;
+
+    if (mca_pwrmgmt_uniformfreq_component.test) {
+        reading = OBJ_NEW(uniformfreq_reading_t);
+        reading->power = simulated_power();
+        reading_ready(-1, 0, reading);
+        return;
+    }
+    /* one outstanding sample at a time - a slow sensor just means
+     * the head sees an older reading, and one that never answers
+     * (no sensors running) is given up on after a few periods */
+    if (0 < state.measuring && 3 > state.measuring++) {
+        return;
+    }
+    state.measuring = 1;
+    orcm_sensor.sample("nodepower,componentpower", sampled, NULL);
+}
+
+/****    CONTROL LOOP    ****/
+
+static void record(orte_process_name_t *node, double power)
+{
+    void *idx;
+
+    if (OPAL_SUCCESS != opal_hash_table_get_value_uint32(&state.node_index, node->vpid, &idx)) {
+        return;
+    }
+    state.reports[(intptr_t)idx] = power;
+}
+
+static void apply_freq(float freq)
+{
+    orcm_pwrmgmt_freq_plan_t plan;
+
+    opal_output_verbose(2, orcm_pwrmgmt_base_framework.framework_output,
+                        "%s pwrmgmt:uniformfreq: setting frequency to %f GHz",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), freq);
+    state.freq = freq;
+    if (mca_pwrmgmt_uniformfreq_component.test) {
+        return;
+    }
+    plan.cpu = -1;
+    plan.min_freq = freq;
+    plan.max_freq = freq;
+    orcm_pwrmgmt_freq_apply_plan(&plan, 1);
+}
+
+static void send_ctl(orte_process_name_t *target, orcm_pwrmgmt_uniformfreq_cmd_t cmd, float value)
+{
+    opal_buffer_t *buf;
+    int rc;
+
+    buf = OBJ_NEW(opal_buffer_t);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(buf, &cmd, 1, ORCM_PWRMGMT_UNIFORMFREQ_CMD_T)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(buf, &state.id, 1, ORCM_ALLOC_ID_T)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(buf, &value, 1, OPAL_FLOAT))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(buf);
+        return;
+    }
+    if (ORTE_SUCCESS != (rc = orte_rml.send_buffer_nb(target, buf,
+                                                      ORCM_RML_TAG_PWRMGMT_CTL,
+                                                      orte_rml_send_callback, NULL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(buf);
+    }
+}
+
+static void control(void)
+{
+    struct timeval now;
+    double sum = 0.0, total;
+    uint32_t elapsed;
+    float freq;
+    int i, reported = 0;
+
+    gettimeofday(&now, NULL);
+    elapsed = (uint32_t)((now.tv_sec - state.last_step.tv_sec) * 1000 +
+                         (now.tv_usec - state.last_step.tv_usec) / 1000);
+    state.last_step = now;
+
+    for (i = 0; i < state.nnodes; i++) {
+        if (0.0 <= state.reports[i]) {
+            sum += state.reports[i];
+            reported++;
+            state.reports[i] = -1.0;
+        }
+    }
+    if (0 == reported) {
+        return;
+    }
+    /* every node runs the same frequency, so the ones we have not
+     * heard from this period are taken to draw what the rest do */
+    total = sum * (double)state.nnodes / (double)reported;
+
+    freq = orcm_pwrmgmt_uniformfreq_ctl_step(&state.ctl, total, elapsed);
+    opal_output_verbose(5, orcm_pwrmgmt_base_framework.framework_output,
+                        "%s pwrmgmt:uniformfreq: allocation %" PRIi64 " draws %.1f of %d watts (%d of %d nodes reporting)",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), state.id, total,
+                        (int)state.budget, reported, state.nnodes);
+    if (fabsf(freq - state.freq) < 0.0001) {
+        return;
+    }
+    for (i = 0; i < state.nnodes; i++) {
+        if (OPAL_EQUAL != orte_util_compare_name_fields(ORTE_NS_CMP_ALL,
+                                                        &state.nodes[i],
+                                                        ORTE_PROC_MY_NAME)) {
+            send_ctl(&state.nodes[i], ORCM_PWRMGMT_UNIFORMFREQ_SET_FREQ, freq);
+        }
+    }
+    apply_freq(freq);
+}
+
+static void reading_ready(int fd, short args, void *cbdata)
+{
+    uniformfreq_reading_t *reading = (uniformfreq_reading_t*)cbdata;
+
+    if (reading->sampled) {
+        state.measuring = 0;
+    }
+    if (state.active && 0.0 <= reading->power) {
+        if (state.is_head) {
+            record(ORTE_PROC_MY_NAME, reading->power);
+        } else {
+            send_ctl(&state.head, ORCM_PWRMGMT_UNIFORMFREQ_REPORT, (float)reading->power);
+        }
+    }
+    OBJ_RELEASE(reading);
+}
+
+static void tick(int fd, short args, void *cbdata)
+{
+    if (!state.active) {
+        return;
+    }
+    /* act on what was reported over the last period, then start
+     * the next one - our own reading lands in the next step */
+    if (state.is_head) {
+        control();
+    }
+    measure();
+    opal_event_evtimer_add(&state.timer, &state.period);
+}
+
+static void recv_ctl(int status, orte_process_name_t* sender,
+                     opal_buffer_t *buffer,
+                     orte_rml_tag_t tag, void *cbdata)
+{
+    orcm_pwrmgmt_uniformfreq_cmd_t cmd;
+    orcm_alloc_id_t id;
+    float value;
+    int32_t n;
+    int rc;
+
+    n = 1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &cmd, &n, ORCM_PWRMGMT_UNIFORMFREQ_CMD_T)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &id, &n, ORCM_ALLOC_ID_T)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &value, &n, OPAL_FLOAT))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+    /* stragglers from an allocation we no longer serve */
+    if (!state.active || id != state.id) {
+        return;
+    }
+    switch (cmd) {
+    case ORCM_PWRMGMT_UNIFORMFREQ_REPORT:
+        if (state.is_head) {
+            record(sender, value);
+        }
+        break;
+    case ORCM_PWRMGMT_UNIFORMFREQ_SET_FREQ:
+        apply_freq(value);
+        break;
+    default:
+        opal_output(0, "%s pwrmgmt:uniformfreq: Received an unknown command",
+                    ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
+        break;
+    }
+}
+
+/****    ALLOCATION LIFETIME    ****/
+
+static int load_ladder(float **freqs, int *nfreqs)
+{
+    opal_list_t *data = NULL;
+    opal_value_t *kv;
+    int n = 0;
+
+    if (ORCM_SUCCESS == orcm_pwrmgmt_freq_get_supported_frequencies(0, &data) &&
+        NULL != data && !opal_list_is_empty(data)) {
+        *freqs = (float*)malloc(opal_list_get_size(data) * sizeof(float));
+        if (NULL == *freqs) {
+            return ORCM_ERR_OUT_OF_RESOURCE;
+        }
+        OPAL_LIST_FOREACH(kv, data, opal_value_t) {
+            (*freqs)[n++] = kv->data.fval;
+        }
+        *nfreqs = n;
+        return ORCM_SUCCESS;
+    }
+    if (!mca_pwrmgmt_uniformfreq_component.test) {
+        return ORCM_ERR_NOT_FOUND;
+    }
+    n = sizeof(sim_freqs) / sizeof(sim_freqs[0]);
+    if (NULL == (*freqs = (float*)malloc(sizeof(sim_freqs)))) {
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    memcpy(*freqs, sim_freqs, sizeof(sim_freqs));
+    *nfreqs = n;
+    return ORCM_SUCCESS;
+}
+
+static int setup_head(orcm_alloc_t *alloc)
+{
+    char **nodelist = NULL;
+    int i, count;
+
+    orte_regex_extract_node_names(alloc->nodes, &nodelist);
+    if (0 == (count = opal_argv_count(nodelist))) {
+        opal_argv_free(nodelist);
+        return ORCM_ERR_BAD_PARAM;
+    }
+    state.nodes = (orte_process_name_t*)malloc(count * sizeof(orte_process_name_t));
+    state.reports = (double*)malloc(count * sizeof(double));
+    if (NULL == state.nodes || NULL == state.reports) {
+        opal_argv_free(nodelist);
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    OBJ_CONSTRUCT(&state.node_index, opal_hash_table_t);
+    opal_hash_table_init(&state.node_index, count);
+    state.indexed = true;
+    state.nnodes = 0;
+    for (i = 0; i < count; i++) {
+        if (ORCM_SUCCESS != orcm_cfgi_base_get_hostname_proc(nodelist[i],
+                                                             &state.nodes[state.nnodes])) {
+            opal_output(0, "%s pwrmgmt:uniformfreq: unknown node %s - its power is not counted",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), nodelist[i]);
+            continue;
+        }
+        state.reports[state.nnodes] = -1.0;
+        opal_hash_table_set_value_uint32(&state.node_index, state.nodes[state.nnodes].vpid,
+                                         (void*)(intptr_t)state.nnodes);
+        state.nnodes++;
+    }
+    opal_argv_free(nodelist);
+    gettimeofday(&state.last_step, NULL);
+    return (0 < state.nnodes) ? ORCM_SUCCESS : ORCM_ERR_NOT_FOUND;
+}
+
+static void teardown(void)
+{
+    if (!state.active) {
+        return;
+    }
+    state.active = false;
+    opal_event_evtimer_del(&state.timer);
+    orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_PWRMGMT_CTL);
+    if (state.indexed) {
+        OBJ_DESTRUCT(&state.node_index);
+        state.indexed = false;
+    }
+    if (NULL != state.nodes) {
+        free(state.nodes);
+        state.nodes = NULL;
+    }
+    if (NULL != state.reports) {
+        free(state.reports);
+        state.reports = NULL;
+    }
+    state.nnodes = 0;
+    orcm_pwrmgmt_uniformfreq_ctl_destruct(&state.ctl);
+}
+
+static int alloc_notify(orcm_alloc_t* alloc)
+{
+    opal_output_verbose(5, orcm_pwrmgmt_base_framework.framework_output,
+                        "%s pwrmgmt:uniformfreq: alloc_notify called",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
+
+    float *freqs = NULL;
+    int nfreqs = 0, rc;
+    int period;
+
+    if (!is_our_mode(&alloc->constraints)) {
+        opal_output(0, "pwrmgmt:uniformfreq: Got an incorrect mode for this component");
+        return ORCM_ERR_BAD_PARAM;
+    }
+
+    if (ORTE_PROC_IS_SCHEDULER) {
+        //We have been selected. Let's add our component string to the attributes.
+        return orte_set_attribute(&alloc->constraints, ORCM_PWRMGMT_SELECTED_COMPONENT_KEY,
+                                  ORTE_ATTR_GLOBAL, (void*)component_name, OPAL_STRING);
+    }
+    if (!ORTE_PROC_IS_DAEMON) {
+        return ORCM_SUCCESS;
+    }
+
+    teardown();
+    memset(&state, 0, sizeof(state));
+    state.id = alloc->id;
+    state.head = alloc->hnp;
+    state.is_head = (OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL,
+                                                                 &alloc->hnp,
+                                                                 ORTE_PROC_MY_NAME));
+    if (!mca_pwrmgmt_uniformfreq_component.test) {
+        orcm_pwrmgmt_freq_init();
+    }
+    if (ORCM_SUCCESS != (rc = load_ladder(&freqs, &nfreqs))) {
+        opal_output(0, "pwrmgmt:uniformfreq: no frequencies to choose from");
+        return rc;
+    }
+    rc = orcm_pwrmgmt_uniformfreq_ctl_init(&state.ctl, freqs, nfreqs, 0.0);
+    free(freqs);
+    if (ORCM_SUCCESS != rc) {
+        return rc;
+    }
+    state.fmax = state.ctl.freqs[0];
+    state.fmin = state.ctl.freqs[state.ctl.nfreqs - 1];
+
+    period = mca_pwrmgmt_uniformfreq_component.period;
+    if (0 >= period) {
+        period = 1000;
+    }
+    state.period.tv_sec = period / 1000;
+    state.period.tv_usec = (period % 1000) * 1000;
+    set_attributes(alloc->id, &alloc->constraints);
+
+    if (state.is_head && ORCM_SUCCESS != (rc = setup_head(alloc))) {
+        ORTE_ERROR_LOG(rc);
+        state.active = true;
+        teardown();
+        return rc;
+    }
+
+    orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD,
+                            ORCM_RML_TAG_PWRMGMT_CTL,
+                            ORTE_RML_PERSISTENT,
+                            recv_ctl, NULL);
+    state.active = true;
+
+    opal_output_verbose(1, orcm_pwrmgmt_base_framework.framework_output,
+                        "%s pwrmgmt:uniformfreq: capping allocation %" PRIi64 " at %d watts",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), alloc->id, (int)state.budget);
+
+    /* everyone starts at the bottom, as the controller
+     * does, and is raised from there */
+    if (!mca_pwrmgmt_uniformfreq_component.test) {
+        orcm_pwrmgmt_freq_set_governor(-1, "userspace");
+    }
+    state.freq = state.fmax;
+    apply_freq(state.fmin);
+
+    opal_event_evtimer_set(orte_event_base, &state.timer, tick, NULL);
+    opal_event_evtimer_add(&state.timer, &state.period);
+    return ORCM_SUCCESS;
+}
+
+static void dealloc_notify(orcm_alloc_t* alloc)
+{
+    opal_output_verbose(5, orcm_pwrmgmt_base_framework.framework_output,
+                        "%s pwrmgmt:uniformfreq: dealloc_notify called",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
+
+    teardown();
+    if (!mca_pwrmgmt_uniformfreq_component.test) {
+        opal_output_verbose(1, orcm_pwrmgmt_base_framework.framework_output,
+                            "%s pwrmgmt:uniformfreq: resetting governor and frequency to defaults",
+                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
+        orcm_pwrmgmt_freq_reset_system_settings();
+    }
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/**
+ * @file
+ *
+ * closed-loop uniform frequency pwrmgmt component
+ *
+ * Holds an allocation under its power budget by running every node at
+ * the same frequency and moving that frequency with the measured power.
+ * Each daemon of the allocation samples its node power every control
+ * period and reports it to the head daemon, which runs the controller
+ * and tells everyone the frequency to use next.
+ */
+#ifndef ORCM_PWRMGMT_UNIFORMFREQ_H
+#define ORCM_PWRMGMT_UNIFORMFREQ_H
+
+#include "orcm_config.h"
+
+#include "orcm/mca/pwrmgmt/pwrmgmt.h"
+
+BEGIN_C_DECLS
+
+typedef struct {
+    orcm_pwrmgmt_base_component_t super;
+    /* simulate node power rather than read the sensors, and
+     * leave the real cpu frequencies alone */
+    bool test;
+    /* control period in msec when the allocation sets no window */
+    int period;
+    /* simulated node model - idle + dynamic * (f/fmax)^3 watts */
+    int sim_idle_watts;
+    int sim_dynamic_watts;
+} orcm_pwrmgmt_uniformfreq_component_t;
+
+ORCM_MODULE_DECLSPEC extern orcm_pwrmgmt_uniformfreq_component_t mca_pwrmgmt_uniformfreq_component;
+extern orcm_pwrmgmt_base_API_module_t orcm_pwrmgmt_uniformfreq_module;
+
+/* messages exchanged on ORCM_RML_TAG_PWRMGMT_CTL */
+typedef uint8_t orcm_pwrmgmt_uniformfreq_cmd_t;
+#define ORCM_PWRMGMT_UNIFORMFREQ_CMD_T      OPAL_UINT8
+#define ORCM_PWRMGMT_UNIFORMFREQ_REPORT     1   // node -> head: watts drawn last period
+#define ORCM_PWRMGMT_UNIFORMFREQ_SET_FREQ   2   // head -> node: frequency to run at
+
+END_C_DECLS
+
+#endif
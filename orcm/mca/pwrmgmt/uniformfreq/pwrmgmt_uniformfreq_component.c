@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#include "opal/mca/base/base.h"
+#include "opal/mca/base/mca_base_var.h"
+
+#include "pwrmgmt_uniformfreq.h"
+
+/*
+ * Local functions
+ */
+
+static int orcm_pwrmgmt_uniformfreq_open(void);
+static int orcm_pwrmgmt_uniformfreq_close(void);
+static int orcm_pwrmgmt_uniformfreq_query(mca_base_module_t **module, int *priority);
+static int uniformfreq_component_register(void);
+
+orcm_pwrmgmt_uniformfreq_component_t mca_pwrmgmt_uniformfreq_component = {
+    {
+        {
+            ORCM_PWRMGMT_BASE_VERSION_1_0_0,
+            
+            .mca_component_name = "uniformfreq",
+            MCA_BASE_MAKE_VERSION(component, ORCM_MAJOR_VERSION, ORCM_MINOR_VERSION,
+                                  ORCM_RELEASE_VERSION),
+        
+            /* Component open and close functions */
+            .mca_open_component = orcm_pwrmgmt_uniformfreq_open,
+            .mca_close_component = orcm_pwrmgmt_uniformfreq_close,
+            .mca_query_component = orcm_pwrmgmt_uniformfreq_query,
+            .mca_register_component_params = uniformfreq_component_register
+        },
+        .base_data = {
+            /* The component is checkpoint ready */
+            MCA_BASE_METADATA_PARAM_CHECKPOINT
+        }
+    }
+};
+
+/**
+  * component open/close/init function
+  */
+static int orcm_pwrmgmt_uniformfreq_open(void)
+{
+    return ORCM_SUCCESS;
+}
+
+static int orcm_pwrmgmt_uniformfreq_query(mca_base_module_t **module, int *priority)
+{
+    /* always available - whether we can take an allocation
+     * is decided per session in component_select */
+    *priority = 1;
+    *module = (mca_base_module_t *)&orcm_pwrmgmt_uniformfreq_module;
+    return ORCM_SUCCESS;
+}
+
+/**
+ *  Close all subsystems.
+ */
+
+static int orcm_pwrmgmt_uniformfreq_close(void)
+{
+    return ORCM_SUCCESS;
+}
+
+static int uniformfreq_component_register(void)
+{
+    mca_base_component_t *c = &mca_pwrmgmt_uniformfreq_component.super.base_version;
+
+    mca_pwrmgmt_uniformfreq_component.test = false;
+    (void) mca_base_component_var_register (c, "test",
+                                            "Drive the control loop from a simulated node power model instead of the power sensors, without changing cpu frequencies",
+                                            MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            & mca_pwrmgmt_uniformfreq_component.test);
+
+    mca_pwrmgmt_uniformfreq_component.period = 1000;
+    (void) mca_base_component_var_register (c, "period",
+                                            "Control period in msec, used when the allocation sets no power window [default: 1000]",
+                                            MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            & mca_pwrmgmt_uniformfreq_component.period);
+
+    mca_pwrmgmt_uniformfreq_component.sim_idle_watts = 100;
+    (void) mca_base_component_var_register (c, "sim_idle_watts",
+                                            "Idle power of a simulated node in test mode [default: 100]",
+                                            MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            & mca_pwrmgmt_uniformfreq_component.sim_idle_watts);
+
+    mca_pwrmgmt_uniformfreq_component.sim_dynamic_watts = 200;
+    (void) mca_base_component_var_register (c, "sim_dynamic_watts",
+                                            "Power a simulated node adds at its top frequency in test mode [default: 200]",
+                                            MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            & mca_pwrmgmt_uniformfreq_component.sim_dynamic_watts);
+    return ORCM_SUCCESS;
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "pwrmgmt_uniformfreq_ctl.h"
+
+static int freq_cmp(const void *a, const void *b)
+{
+    float fa = *(const float*)a, fb = *(const float*)b;
+
+    /* highest first */
+    return (fa < fb) - (fa > fb);
+}
+
+int orcm_pwrmgmt_uniformfreq_ctl_init(orcm_pwrmgmt_uniformfreq_ctl_t *ctl,
+                                      const float *freqs, int nfreqs,
+                                      double budget)
+{
+    int i, n;
+
+    memset(ctl, 0, sizeof(*ctl));
+    if (NULL == freqs || 0 >= nfreqs) {
+        return ORCM_ERR_BAD_PARAM;
+    }
+    if (NULL == (ctl->freqs = (float*)malloc(nfreqs * sizeof(float)))) {
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    memcpy(ctl->freqs, freqs, nfreqs * sizeof(float));
+    qsort(ctl->freqs, nfreqs, sizeof(float), freq_cmp);
+    for (i = 1, n = 1; i < nfreqs; i++) {
+        if (ctl->freqs[i] != ctl->freqs[n - 1]) {
+            ctl->freqs[n++] = ctl->freqs[i];
+        }
+    }
+    ctl->nfreqs = n;
+    ctl->index = n - 1;
+    ctl->budget = budget;
+    ctl->last_power = -1.0;
+    ctl->last_index = ctl->index;
+    ctl->blocked = -1;
+    ctl->hold = 1;
+    return ORCM_SUCCESS;
+}
+
+void orcm_pwrmgmt_uniformfreq_ctl_destruct(orcm_pwrmgmt_uniformfreq_ctl_t *ctl)
+{
+    if (NULL != ctl->freqs) {
+        free(ctl->freqs);
+        ctl->freqs = NULL;
+    }
+    ctl->nfreqs = 0;
+}
+
+float orcm_pwrmgmt_uniformfreq_ctl_freq(orcm_pwrmgmt_uniformfreq_ctl_t *ctl)
+{
+    if (0 == ctl->nfreqs) {
+        return -1.0;
+    }
+    return ctl->freqs[ctl->index];
+}
+
+/* learn the cost of a ladder step from the move made last period */
+static void learn(orcm_pwrmgmt_uniformfreq_ctl_t *ctl, double power)
+{
+    double slope;
+
+    if (0.0 > ctl->last_power || ctl->last_index == ctl->index) {
+        return;
+    }
+    slope = fabs(power - ctl->last_power) / (double)abs(ctl->last_index - ctl->index);
+    if (0.0 == ctl->watts_per_step) {
+        ctl->watts_per_step = slope;
+    } else {
+        ctl->watts_per_step = 0.5 * ctl->watts_per_step + 0.5 * slope;
+    }
+}
+
+static void step_down(orcm_pwrmgmt_uniformfreq_ctl_t *ctl, double power)
+{
+    int steps = 1;
+
+    if (0.0 < ctl->watts_per_step) {
+        steps = (int)ceil((power - ctl->budget) / ctl->watts_per_step);
+        if (steps < 1) {
+            steps = 1;
+        }
+    }
+    ctl->index += steps;
+    if (ctl->index >= ctl->nfreqs) {
+        ctl->index = ctl->nfreqs - 1;
+    }
+}
+
+static void step_up(orcm_pwrmgmt_uniformfreq_ctl_t *ctl, double power)
+{
+    int steps = 1, target;
+
+    /* only climb as far as the learned cost says still fits - a
+     * single step is the probe that teaches us that cost */
+    if (0.0 < ctl->watts_per_step) {
+        steps = (int)floor((ctl->budget - power) / ctl->watts_per_step);
+        if (steps < 1) {
+            return;
+        }
+    }
+    target = ctl->index - steps;
+    if (target < 0) {
+        target = 0;
+    }
+    if (0 <= ctl->blocked && target <= ctl->blocked) {
+        target = ctl->blocked + 1;
+    }
+    if (target < ctl->index) {
+        ctl->index = target;
+        ctl->probing = true;
+    }
+}
+
+float orcm_pwrmgmt_uniformfreq_ctl_step(orcm_pwrmgmt_uniformfreq_ctl_t *ctl,
+                                        double power, uint32_t elapsed_ms)
+{
+    if (0 == ctl->nfreqs) {
+        return -1.0;
+    }
+    if (0.0 > power) {
+        return ctl->freqs[ctl->index];
+    }
+
+    learn(ctl, power);
+    ctl->last_power = power;
+    ctl->last_index = ctl->index;
+
+    if (0 < ctl->hold_left && 0 == --ctl->hold_left) {
+        ctl->blocked = -1;
+    }
+
+    if (power > ctl->budget + ctl->overage) {
+        ctl->under_ms = 0;
+        ctl->over_ms += elapsed_ms;
+        if (ctl->probing) {
+            /* our own step up broke the cap - back off at once and
+             * stay off that step longer each time it happens */
+            ctl->probing = false;
+            ctl->blocked = ctl->index;
+            ctl->hold = (ctl->hold < ORCM_PWRMGMT_UNIFORMFREQ_MAX_HOLD / 2) ?
+                        2 * ctl->hold : ORCM_PWRMGMT_UNIFORMFREQ_MAX_HOLD;
+            ctl->hold_left = ctl->hold;
+            ctl->over_ms = ctl->overage_time;
+        }
+        if (ctl->over_ms >= ctl->overage_time) {
+            step_down(ctl, power);
+            ctl->over_ms = 0;
+        }
+        return ctl->freqs[ctl->index];
+    }
+
+    ctl->over_ms = 0;
+    if (ctl->probing) {
+        /* the last step up held */
+        ctl->probing = false;
+        ctl->hold = 1;
+    }
+    if (ctl->budget - power > ctl->underage && 0 < ctl->index) {
+        ctl->under_ms += elapsed_ms;
+        if (ctl->under_ms >= ctl->underage_time) {
+            step_up(ctl, power);
+            ctl->under_ms = 0;
+        }
+    } else {
+        ctl->under_ms = 0;
+    }
+    return ctl->freqs[ctl->index];
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/**
+ * @file
+ *
+ * Power-cap feedback controller for the uniform frequency component.
+ *
+ * The controller knows nothing about where power readings come from
+ * or how a frequency is applied - it is handed the measured power of
+ * the whole allocation each period and answers with the step of the
+ * frequency ladder everyone should run at. That keeps it usable
+ * against a simulated power model as well as the real sensors.
+ */
+#ifndef ORCM_PWRMGMT_UNIFORMFREQ_CTL_H
+#define ORCM_PWRMGMT_UNIFORMFREQ_CTL_H
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#include <stdint.h>
+
+BEGIN_C_DECLS
+
+/* longest we keep a frequency off-limits after it broke the cap */
+#define ORCM_PWRMGMT_UNIFORMFREQ_MAX_HOLD 64
+
+typedef struct {
+    /* supported frequencies, highest first */
+    float *freqs;
+    int nfreqs;
+    /* current step on the ladder */
+    int index;
+
+    /* watts for the whole allocation */
+    double budget;
+    /* tolerated excursion above the budget before stepping down */
+    double overage;
+    /* required headroom below the budget before stepping up */
+    double underage;
+    /* msec the excursion/headroom must last before acting */
+    uint32_t overage_time;
+    uint32_t underage_time;
+    uint32_t over_ms;
+    uint32_t under_ms;
+
+    /* learned watts per ladder step - zero until two
+     * readings at different steps have been seen */
+    double watts_per_step;
+    double last_power;
+    int last_index;
+
+    /* steps at or above this one broke the cap recently
+     * and may not be probed until the hold runs out */
+    int blocked;
+    int hold;
+    int hold_left;
+    /* we moved up last period and are waiting to see the result */
+    bool probing;
+} orcm_pwrmgmt_uniformfreq_ctl_t;
+
+/**
+ * Set up a controller over the given ladder. The ladder is copied and
+ * sorted highest first; the controller starts at the lowest frequency
+ * so that the cap holds from the first period and climbs from there.
+ *
+ * @retval ORCM_SUCCESS Success
+ * @retval ORCM_ERR_BAD_PARAM empty ladder
+ * @retval ORCM_ERR_OUT_OF_RESOURCE no memory for the ladder
+ */
+int orcm_pwrmgmt_uniformfreq_ctl_init(orcm_pwrmgmt_uniformfreq_ctl_t *ctl,
+                                      const float *freqs, int nfreqs,
+                                      double budget);
+
+void orcm_pwrmgmt_uniformfreq_ctl_destruct(orcm_pwrmgmt_uniformfreq_ctl_t *ctl);
+
+/**
+ * Feed one power reading covering elapsed_ms and move along the
+ * ladder if needed. A negative reading means no data and leaves the
+ * frequency where it is.
+ *
+ * @retval the frequency to run at
+ */
+float orcm_pwrmgmt_uniformfreq_ctl_step(orcm_pwrmgmt_uniformfreq_ctl_t *ctl,
+                                        double power, uint32_t elapsed_ms);
+
+/* frequency for the current step */
+float orcm_pwrmgmt_uniformfreq_ctl_freq(orcm_pwrmgmt_uniformfreq_ctl_t *ctl);
+
+END_C_DECLS
+
+#endif
@@ -49,6 +49,10 @@ typedef struct {
     opal_list_item_t super;
     int alloc_id;
     int count_checked_in;
+    int count_ready;
+    /* submission time, for reporting the queued-to-running latency */
+    struct timeval queued;
+    bool reused;
 } orcm_alloc_tracker_t;
 OBJ_CLASS_DECLARATION(orcm_alloc_tracker_t);
 
@@ -108,6 +112,13 @@ typedef struct {
     opal_pointer_array_t topologies;
     /* track running allocations and number of nodes completed */
     opal_list_t tracking;
+    /* live telemetry relay */
+    int pubsub_max_queue;
+    char *pubsub_socket;
+    /* seconds to wait for aggregators to answer latest-value queries */
+    int recent_timeout;
+    /* hand the nodes of a completed session to the next queued one */
+    bool session_reuse;
 } orcm_scd_base_t;
 ORCM_DECLSPEC extern orcm_scd_base_t orcm_scd_base;
 
@@ -115,6 +126,17 @@ ORCM_DECLSPEC extern orcm_scd_base_t orcm_scd_base;
 ORCM_DECLSPEC int orcm_scd_base_comm_start(void);
 ORCM_DECLSPEC int orcm_scd_base_comm_stop(void);
 
+/* start/stop the live telemetry relay */
+ORCM_DECLSPEC int orcm_scd_base_pubsub_start(void);
+ORCM_DECLSPEC void orcm_scd_base_pubsub_stop(void);
+ORCM_DECLSPEC void orcm_scd_base_get_aggregators(opal_list_t *targets);
+
+/* start/stop the latest-value query fan-out */
+ORCM_DECLSPEC int orcm_scd_base_recent_start(void);
+ORCM_DECLSPEC void orcm_scd_base_recent_stop(void);
+ORCM_DECLSPEC void orcm_scd_base_recent_query(orte_process_name_t *requester,
+                                              opal_buffer_t *buffer);
+
 /* start/stop resource management service */
 ORCM_DECLSPEC int scd_base_rm_init(void);
 ORCM_DECLSPEC void scd_base_rm_finalize(void);
@@ -151,6 +173,9 @@ ORCM_DECLSPEC int orcm_scd_base_rm_add_session_state(orcm_scd_session_state_t st
                                                      orcm_scd_state_cbfunc_t cbfunc,
                                                      int priority);
 ORCM_DECLSPEC void orcm_scd_base_construct_queues(int fd, short args, void *cbdata);
+ORCM_DECLSPEC bool orcm_scd_base_reuse_session(orcm_session_t *done,
+                                               opal_list_t *pending);
+ORCM_DECLSPEC void orcm_scd_base_session_running(orcm_alloc_tracker_t *trk);
 ORCM_DECLSPEC int orcm_scd_base_get_next_session_id(void);
 ORCM_DECLSPEC int orcm_scd_base_get_cluster_power_budget(void);
 ORCM_DECLSPEC int orcm_scd_base_set_cluster_power_budget(int budget);
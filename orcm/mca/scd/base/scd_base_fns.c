@@ -13,6 +13,7 @@
 #include "orcm/types.h"
 
 #include "opal/mca/mca.h"
+#include "opal/util/argv.h"
 #include "opal/util/output.h"
 #include "opal/mca/base/base.h"
 
@@ -191,3 +192,111 @@ void orcm_scd_base_construct_queues(int fd, short args, void *cbdata)
 
     OBJ_RELEASE(c);
 }
+
+/* running totals behind the per-session latency report */
+static uint64_t num_running = 0;
+static uint64_t num_reused = 0;
+static double total_latency = 0.0;
+
+bool orcm_scd_base_reuse_session(orcm_session_t *done, opal_list_t *pending)
+{
+    orcm_session_t *next;
+    orcm_node_t *nodeptr;
+    char **nodenames = NULL;
+    int rc, i, j, num_nodes;
+    bool up;
+
+    if (!orcm_scd_base.session_reuse || NULL == done->alloc ||
+        NULL == done->alloc->nodes || opal_list_is_empty(pending)) {
+        return false;
+    }
+
+    /* only the session at the head of the queue may take the nodes
+     * over - anything else would let it overtake older requests */
+    next = (orcm_session_t*)opal_list_get_first(pending);
+    if (next->alloc->min_nodes != done->alloc->min_nodes ||
+        next->alloc->exclusive != done->alloc->exclusive) {
+        return false;
+    }
+
+    if (ORTE_SUCCESS !=
+        (rc = orte_regex_extract_node_names(done->alloc->nodes, &nodenames))) {
+        ORTE_ERROR_LOG(rc);
+        if (NULL != nodenames) {
+            opal_argv_free(nodenames);
+        }
+        return false;
+    }
+    num_nodes = opal_argv_count(nodenames);
+    if (num_nodes != next->alloc->min_nodes) {
+        opal_argv_free(nodenames);
+        return false;
+    }
+
+    /* a node may have gone down while the session ran */
+    for (i = 0; i < num_nodes; i++) {
+        up = false;
+        for (j = 0; j < orcm_scd_base.nodes.size; j++) {
+            if (NULL == (nodeptr =
+                         (orcm_node_t*)opal_pointer_array_get_item(&orcm_scd_base.nodes, j))) {
+                continue;
+            }
+            if (0 == strcmp(nodeptr->name, nodenames[i])) {
+                up = (ORCM_NODE_STATE_UP == nodeptr->state);
+                break;
+            }
+        }
+        if (!up) {
+            OPAL_OUTPUT_VERBOSE((5, orcm_scd_base_framework.framework_output,
+                                 "%s scd:base:reuse - node %s of session %d is no longer up",
+                                 ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                                 nodenames[i], done->id));
+            opal_argv_free(nodenames);
+            return false;
+        }
+    }
+    opal_argv_free(nodenames);
+
+    /* the nodes stay allocated and go to the new session as they are */
+    opal_list_remove_item(pending, &next->super);
+    if (NULL != next->alloc->nodes) {
+        free(next->alloc->nodes);
+    }
+    next->alloc->nodes = strdup(done->alloc->nodes);
+    next->reused = true;
+
+    OPAL_OUTPUT_VERBOSE((5, orcm_scd_base_framework.framework_output,
+                         "%s scd:base:reuse - session %d takes over nodes %s from session %d",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                         next->id, next->alloc->nodes, done->id));
+
+    ORCM_ACTIVATE_SCD_STATE(next, ORCM_SESSION_STATE_ALLOCD);
+    return true;
+}
+
+void orcm_scd_base_session_running(orcm_alloc_tracker_t *trk)
+{
+    struct timeval now;
+    double latency;
+
+    if (0 == trk->queued.tv_sec) {
+        return;
+    }
+    gettimeofday(&now, NULL);
+    latency = (double)(now.tv_sec - trk->queued.tv_sec) * 1000.0 +
+              (double)(now.tv_usec - trk->queued.tv_usec) / 1000.0;
+
+    num_running++;
+    if (trk->reused) {
+        num_reused++;
+    }
+    total_latency += latency;
+
+    OPAL_OUTPUT_VERBOSE((2, orcm_scd_base_framework.framework_output,
+                         "%s scd:base session %d running %.3f ms after submission%s "
+                         "(mean %.3f ms over %lu sessions, %lu on reused nodes)",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                         trk->alloc_id, latency, trk->reused ? " on reused nodes" : "",
+                         total_latency / (double)num_running,
+                         (unsigned long)num_running, (unsigned long)num_reused));
+}
@@ -24,6 +24,7 @@
 
 #include "orte/mca/errmgr/errmgr.h"
 
+#include "orcm/util/pubsub.h"
 #include "orcm/mca/scd/base/base.h"
 
 
@@ -218,6 +219,42 @@ static int orcm_scd_base_register(mca_base_register_flag_t flags)
                                  OPAL_INFO_LVL_9,
                                  MCA_BASE_VAR_SCOPE_READONLY,
                                  &orcm_scd_base.test_mode);
+
+    /* bound on records queued for each live subscriber */
+    orcm_scd_base.pubsub_max_queue = ORCM_PUBSUB_DEFAULT_MAX_QUEUE;
+    (void) mca_base_var_register("orcm", "scd", "base", "pubsub_max_queue",
+                                 "Maximum number of undelivered records held for each live subscriber before the oldest are dropped",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &orcm_scd_base.pubsub_max_queue);
+
+    /* local socket for external live subscribers */
+    orcm_scd_base.pubsub_socket = NULL;
+    (void) mca_base_var_register("orcm", "scd", "base", "pubsub_socket",
+                                 "Path of a local socket on which the scheduler accepts live subscriptions from external tools (default: none)",
+                                 MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &orcm_scd_base.pubsub_socket);
+
+    /* how long to wait on aggregators for latest-value queries */
+    orcm_scd_base.recent_timeout = 5;
+    (void) mca_base_var_register("orcm", "scd", "base", "recent_timeout",
+                                 "Seconds to wait for aggregators to answer an in-memory sensor query",
+                                 MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &orcm_scd_base.recent_timeout);
+
+    /* let a completed session's nodes go straight to the next one */
+    orcm_scd_base.session_reuse = false;
+    (void) mca_base_var_register("orcm", "scd", "base", "session_reuse",
+                                 "Hand the nodes of a completed session directly to the next queued session needing the same number of nodes, without returning them to the free pool and rescheduling",
+                                 MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                 OPAL_INFO_LVL_9,
+                                 MCA_BASE_VAR_SCOPE_READONLY,
+                                 &orcm_scd_base.session_reuse);
     return OPAL_SUCCESS;
 }
 
@@ -488,6 +525,9 @@ static void sess_con(orcm_session_t *s)
 {
     s->alloc = NULL;
     OBJ_CONSTRUCT(&s->steps, opal_list_t);
+    s->queued.tv_sec = 0;
+    s->queued.tv_usec = 0;
+    s->reused = false;
 }
 static void sess_des(orcm_session_t *s)
 {
@@ -535,6 +575,10 @@ static void trkcon(orcm_alloc_tracker_t *p)
 {
     p->alloc_id = 0;
     p->count_checked_in = 0;
+    p->count_ready = 0;
+    p->queued.tv_sec = 0;
+    p->queued.tv_usec = 0;
+    p->reused = false;
 }
 OBJ_CLASS_INSTANCE(orcm_alloc_tracker_t,
                    opal_list_item_t,
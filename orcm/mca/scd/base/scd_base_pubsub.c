@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Live telemetry relay. Clients (octl, or tools on the local socket)
+ * subscribe here; the scheduler forwards each subscription to every
+ * aggregator and relays the records they publish back to the client
+ * through a bounded per-subscriber queue.
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+#include "orcm/types.h"
+
+#include "opal/dss/dss.h"
+#include "opal/util/output.h"
+
+#include "orte/mca/errmgr/errmgr.h"
+#include "orte/mca/rml/rml.h"
+#include "orte/runtime/orte_globals.h"
+#include "orte/util/name_fns.h"
+
+#include "orcm/runtime/orcm_globals.h"
+#include "orcm/mca/cfgi/cfgi_types.h"
+#include "orcm/mca/scd/base/base.h"
+#include "orcm/util/utils.h"
+#include "orcm/util/pubsub.h"
+
+/* all of this runs in the RML thread */
+static opal_list_t subscribers;
+static orcm_pubsub_listener_t *listener = NULL;
+static bool pubsub_active = false;
+static uint32_t next_id = 0;
+
+static void pubsub_recv(int status, orte_process_name_t *sender,
+                        opal_buffer_t *buffer, orte_rml_tag_t tag,
+                        void *cbdata);
+
+static void add_aggregator(orcm_node_t *node, opal_list_t *targets)
+{
+    orte_namelist_t *nm;
+
+    if (!node->config.aggregator || ORTE_VPID_INVALID == node->daemon.vpid) {
+        return;
+    }
+    OPAL_LIST_FOREACH(nm, targets, orte_namelist_t) {
+        if (OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL,
+                                                        &nm->name, &node->daemon)) {
+            return;
+        }
+    }
+    nm = OBJ_NEW(orte_namelist_t);
+    nm->name = node->daemon;
+    opal_list_append(targets, &nm->super);
+}
+
+/* collect the daemon name of every aggregator in the system */
+void orcm_scd_base_get_aggregators(opal_list_t *targets)
+{
+    orcm_cluster_t *cluster;
+    orcm_row_t *row;
+    orcm_rack_t *rack;
+
+    OPAL_LIST_FOREACH(cluster, orcm_clusters, orcm_cluster_t) {
+        add_aggregator(&cluster->controller, targets);
+        OPAL_LIST_FOREACH(row, &cluster->rows, orcm_row_t) {
+            add_aggregator(&row->controller, targets);
+            OPAL_LIST_FOREACH(rack, &row->racks, orcm_rack_t) {
+                add_aggregator(&rack->controller, targets);
+            }
+        }
+    }
+}
+
+/* send a copy of msg to every aggregator in the system */
+static void send_to_aggregators(opal_buffer_t *msg)
+{
+    orte_namelist_t *nm;
+    opal_list_t targets;
+    opal_buffer_t *buf;
+    int rc;
+
+    OBJ_CONSTRUCT(&targets, opal_list_t);
+    orcm_scd_base_get_aggregators(&targets);
+
+    OPAL_LIST_FOREACH(nm, &targets, orte_namelist_t) {
+        buf = OBJ_NEW(opal_buffer_t);
+        opal_dss.copy_payload(buf, msg);
+        if (ORTE_SUCCESS != (rc = orte_rml.send_buffer_nb(&nm->name, buf,
+                                                          ORCM_RML_TAG_PUBSUB,
+                                                          orte_rml_send_callback, NULL))) {
+            ORTE_ERROR_LOG(rc);
+            OBJ_RELEASE(buf);
+        }
+    }
+    OPAL_LIST_DESTRUCT(&targets);
+}
+
+static void forward_subscribe(orcm_pubsub_subscriber_t *sub)
+{
+    orcm_pubsub_cmd_flag_t command = ORCM_PUBSUB_SUBSCRIBE_COMMAND;
+    opal_buffer_t msg;
+    int rc;
+
+    OBJ_CONSTRUCT(&msg, opal_buffer_t);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(&msg, &command, 1, ORCM_PUBSUB_CMD_T)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(&msg, &sub->id, 1, OPAL_UINT32)) ||
+        OPAL_SUCCESS != (rc = orcm_pubsub_filter_pack(&msg, sub->filter))) {
+        ORTE_ERROR_LOG(rc);
+    } else {
+        send_to_aggregators(&msg);
+    }
+    OBJ_DESTRUCT(&msg);
+}
+
+static void forward_unsubscribe(orcm_pubsub_subscriber_t *sub)
+{
+    orcm_pubsub_cmd_flag_t command = ORCM_PUBSUB_UNSUBSCRIBE_COMMAND;
+    opal_buffer_t msg;
+    int rc;
+
+    OBJ_CONSTRUCT(&msg, opal_buffer_t);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(&msg, &command, 1, ORCM_PUBSUB_CMD_T)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(&msg, &sub->id, 1, OPAL_UINT32))) {
+        ORTE_ERROR_LOG(rc);
+    } else {
+        send_to_aggregators(&msg);
+    }
+    OBJ_DESTRUCT(&msg);
+}
+
+static void remove_subscriber(orcm_pubsub_subscriber_t *sub)
+{
+    forward_unsubscribe(sub);
+    opal_list_remove_item(&subscribers, &sub->super);
+    OBJ_RELEASE(sub);
+}
+
+static void pubsub_lost(orcm_pubsub_subscriber_t *sub)
+{
+    OPAL_OUTPUT_VERBOSE((5, orcm_scd_base_framework.framework_output,
+                         "%s scd:base:pubsub lost subscriber %u",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), sub->id));
+    remove_subscriber(sub);
+}
+
+static void pubsub_accept(orcm_pubsub_subscriber_t *sub)
+{
+    sub->id = ++next_id;
+    opal_list_append(&subscribers, &sub->super);
+    forward_subscribe(sub);
+}
+
+static void send_ack(orte_process_name_t *peer, int status, uint32_t id,
+                     uint64_t delivered, uint64_t dropped)
+{
+    orcm_pubsub_cmd_flag_t command = ORCM_PUBSUB_ACK_COMMAND;
+    opal_buffer_t *ans;
+    int rc;
+
+    ans = OBJ_NEW(opal_buffer_t);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &command, 1, ORCM_PUBSUB_CMD_T)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(ans, &status, 1, OPAL_INT)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(ans, &id, 1, OPAL_UINT32)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(ans, &delivered, 1, OPAL_UINT64)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(ans, &dropped, 1, OPAL_UINT64))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(ans);
+        return;
+    }
+    if (ORTE_SUCCESS != (rc = orte_rml.send_buffer_nb(peer, ans, ORCM_RML_TAG_PUBSUB,
+                                                      orte_rml_send_callback, NULL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(ans);
+    }
+}
+
+static orcm_pubsub_subscriber_t* find_by_id(uint32_t id)
+{
+    orcm_pubsub_subscriber_t *sub;
+
+    OPAL_LIST_FOREACH(sub, &subscribers, orcm_pubsub_subscriber_t) {
+        if (id == sub->id) {
+            return sub;
+        }
+    }
+    return NULL;
+}
+
+static void pubsub_recv(int status, orte_process_name_t *sender,
+                        opal_buffer_t *buffer, orte_rml_tag_t tag,
+                        void *cbdata)
+{
+    orcm_pubsub_cmd_flag_t command;
+    orcm_pubsub_subscriber_t *sub;
+    orcm_pubsub_filter_t *filter;
+    opal_buffer_t *records;
+    uint64_t dropped;
+    int32_t n;
+    uint32_t id;
+    int cnt, rc;
+
+    cnt = 1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &command, &cnt, ORCM_PUBSUB_CMD_T)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &id, &cnt, OPAL_UINT32))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+
+    switch (command) {
+    case ORCM_PUBSUB_SUBSCRIBE_COMMAND:
+        /* from a client - the id it sent is ignored and we assign our own */
+        if (OPAL_SUCCESS != (rc = orcm_pubsub_filter_unpack(buffer, &filter))) {
+            ORTE_ERROR_LOG(rc);
+            send_ack(sender, rc, 0, 0, 0);
+            break;
+        }
+        sub = orcm_pubsub_subscriber_create(++next_id, sender, filter, orte_event_base,
+                                            orcm_scd_base.pubsub_max_queue, pubsub_lost);
+        opal_list_append(&subscribers, &sub->super);
+        send_ack(sender, ORCM_SUCCESS, sub->id, 0, 0);
+        forward_subscribe(sub);
+        OPAL_OUTPUT_VERBOSE((5, orcm_scd_base_framework.framework_output,
+                             "%s scd:base:pubsub subscriber %u added for %s",
+                             ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), sub->id,
+                             ORTE_NAME_PRINT(sender)));
+        break;
+
+    case ORCM_PUBSUB_UNSUBSCRIBE_COMMAND:
+        if (NULL == (sub = orcm_pubsub_subscriber_find(&subscribers, sender, id))) {
+            send_ack(sender, ORCM_ERR_NOT_FOUND, id, 0, 0);
+            break;
+        }
+        orcm_pubsub_subscriber_close(sub);
+        send_ack(sender, ORCM_SUCCESS, id, sub->delivered, sub->dropped);
+        remove_subscriber(sub);
+        break;
+
+    case ORCM_PUBSUB_PUBLISH_COMMAND:
+        /* from an aggregator - drops it reports count against the client */
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &dropped, &cnt, OPAL_UINT64)) ||
+            OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &n, &cnt, OPAL_INT32))) {
+            ORTE_ERROR_LOG(rc);
+            break;
+        }
+        if (NULL == (sub = find_by_id(id))) {
+            /* unsubscribe raced with data already in flight */
+            break;
+        }
+        sub->dropped += dropped;
+        records = OBJ_NEW(opal_buffer_t);
+        opal_dss.copy_payload(records, buffer);
+        orcm_pubsub_subscriber_enqueue(sub, records, n);
+        OBJ_RELEASE(records);
+        break;
+
+    default:
+        ORTE_ERROR_LOG(ORCM_ERR_BAD_PARAM);
+        break;
+    }
+}
+
+int orcm_scd_base_pubsub_start(void)
+{
+    if (pubsub_active) {
+        return ORCM_SUCCESS;
+    }
+
+    OBJ_CONSTRUCT(&subscribers, opal_list_t);
+    orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD, ORCM_RML_TAG_PUBSUB,
+                            ORTE_RML_PERSISTENT, pubsub_recv, NULL);
+
+    if (NULL != orcm_scd_base.pubsub_socket) {
+        listener = orcm_pubsub_listen(orcm_scd_base.pubsub_socket, orte_event_base,
+                                      orcm_scd_base.pubsub_max_queue,
+                                      pubsub_accept, pubsub_lost);
+        if (NULL == listener) {
+            opal_output(0, "%s scd:base:pubsub unable to listen on %s",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                        orcm_scd_base.pubsub_socket);
+        }
+    }
+    pubsub_active = true;
+
+    return ORCM_SUCCESS;
+}
+
+void orcm_scd_base_pubsub_stop(void)
+{
+    orcm_pubsub_subscriber_t *sub;
+
+    if (!pubsub_active) {
+        return;
+    }
+
+    orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_PUBSUB);
+    SAFE_RELEASE(listener);
+    listener = NULL;
+    while (NULL != (sub = (orcm_pubsub_subscriber_t*)opal_list_remove_first(&subscribers))) {
+        orcm_pubsub_subscriber_close(sub);
+        forward_unsubscribe(sub);
+        OBJ_RELEASE(sub);
+    }
+    OBJ_DESTRUCT(&subscribers);
+    pubsub_active = false;
+}
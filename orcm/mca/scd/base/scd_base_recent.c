@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+/*
+ * Latest-value sensor queries. Instead of going to the database, the
+ * scheduler fans the request out to every aggregator, each of which
+ * answers from its in-memory cache of recent samples, and hands the
+ * merged rows back to the requester in the usual query format.
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+#include "orcm/types.h"
+
+#include "opal/dss/dss.h"
+#include "opal/mca/event/event.h"
+#include "opal/util/output.h"
+
+#include "orte/mca/errmgr/errmgr.h"
+#include "orte/mca/rml/rml.h"
+#include "orte/runtime/orte_globals.h"
+#include "orte/util/name_fns.h"
+
+#include "orcm/runtime/orcm_globals.h"
+#include "orcm/mca/scd/base/base.h"
+#include "orcm/util/utils.h"
+
+#define RECENT_HEADER "NODE,SENSOR,DATE_TIME,VALUE,UNITS"
+
+/* one outstanding request - all of this runs in the RML thread */
+typedef struct {
+    opal_list_item_t super;
+    uint32_t id;
+    orte_process_name_t requester;
+    int outstanding;
+    /* the merged rows, kept packed as they will be sent */
+    opal_buffer_t rows;
+    uint16_t nrows;
+    bool truncated;
+    opal_event_t timer;
+    bool timer_active;
+} scd_recent_request_t;
+static void rqcon(scd_recent_request_t *p)
+{
+    p->outstanding = 0;
+    OBJ_CONSTRUCT(&p->rows, opal_buffer_t);
+    p->nrows = 0;
+    p->truncated = false;
+    p->timer_active = false;
+}
+static void rqdes(scd_recent_request_t *p)
+{
+    if (p->timer_active) {
+        opal_event_evtimer_del(&p->timer);
+    }
+    OBJ_DESTRUCT(&p->rows);
+}
+static OBJ_CLASS_INSTANCE(scd_recent_request_t,
+                          opal_list_item_t,
+                          rqcon, rqdes);
+
+static opal_list_t requests;
+static bool recent_active = false;
+static uint32_t next_id = 0;
+
+/* same layout as the database query replies */
+static void recent_respond(orte_process_name_t *requester, opal_buffer_t *rows,
+                           uint16_t nrows)
+{
+    opal_buffer_t *ans;
+    int status = 0;
+    uint16_t count;
+    char *header = RECENT_HEADER;
+    int rc;
+
+    ans = OBJ_NEW(opal_buffer_t);
+    if (NULL == rows || 0 == nrows) {
+        status = ORCM_ERR_NOT_FOUND;
+        if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &status, 1, OPAL_INT))) {
+            ORTE_ERROR_LOG(rc);
+            OBJ_RELEASE(ans);
+            return;
+        }
+    } else {
+        count = nrows + 1;
+        if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &status, 1, OPAL_INT)) ||
+            OPAL_SUCCESS != (rc = opal_dss.pack(ans, &count, 1, OPAL_UINT16)) ||
+            OPAL_SUCCESS != (rc = opal_dss.pack(ans, &header, 1, OPAL_STRING)) ||
+            OPAL_SUCCESS != (rc = opal_dss.copy_payload(ans, rows))) {
+            ORTE_ERROR_LOG(rc);
+            OBJ_RELEASE(ans);
+            return;
+        }
+    }
+    if (ORTE_SUCCESS != (rc = orte_rml.send_buffer_nb(requester, ans,
+                                                      ORCM_RML_TAG_ORCMD_FETCH,
+                                                      orte_rml_send_callback, NULL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(ans);
+    }
+}
+
+static void recent_complete(scd_recent_request_t *req)
+{
+    if (req->truncated) {
+        opal_output(0, "%s scd:base:recent truncating request %u to %d rows",
+                    ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), req->id, (int)req->nrows);
+    }
+    recent_respond(&req->requester, &req->rows, req->nrows);
+    opal_list_remove_item(&requests, &req->super);
+    OBJ_RELEASE(req);
+}
+
+/* some aggregators did not answer in time - go with what we have */
+static void recent_timeout(int fd, short args, void *cbdata)
+{
+    scd_recent_request_t *req = (scd_recent_request_t*)cbdata;
+
+    opal_output_verbose(1, orcm_scd_base_framework.framework_output,
+                        "%s scd:base:recent request %u timed out waiting for %d aggregators",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), req->id, req->outstanding);
+    req->timer_active = false;
+    recent_complete(req);
+}
+
+static void recent_recv(int status, orte_process_name_t* sender,
+                        opal_buffer_t* buffer, orte_rml_tag_t tag,
+                        void* cbdata)
+{
+    scd_recent_request_t *req;
+    uint32_t id, nrows, i;
+    int cnt = 1, rc, agg_status;
+    const char *str;
+
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &id, &cnt, OPAL_UINT32)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &agg_status, &cnt, OPAL_INT)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &nrows, &cnt, OPAL_UINT32))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+    OPAL_LIST_FOREACH(req, &requests, scd_recent_request_t) {
+        if (req->id == id) {
+            break;
+        }
+    }
+    if (&req->super == opal_list_get_end(&requests)) {
+        /* a late answer to a request that already timed out */
+        return;
+    }
+
+    /* the rows go straight from this message into the reply - the
+     * header takes one of the reply's row slots */
+    if (ORCM_SUCCESS == agg_status) {
+        for (i = 0; i < nrows; i++) {
+            if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(buffer, &str, NULL))) {
+                ORTE_ERROR_LOG(rc);
+                break;
+            }
+            if (UINT16_MAX - 1 <= req->nrows) {
+                req->truncated = true;
+                break;
+            }
+            if (OPAL_SUCCESS != (rc = opal_dss.pack(&req->rows, &str, 1, OPAL_STRING))) {
+                ORTE_ERROR_LOG(rc);
+                break;
+            }
+            req->nrows++;
+        }
+    }
+    if (0 == --req->outstanding) {
+        recent_complete(req);
+    }
+}
+
+void orcm_scd_base_recent_query(orte_process_name_t *requester, opal_buffer_t *buffer)
+{
+    scd_recent_request_t *req;
+    orte_namelist_t *nm;
+    opal_list_t targets;
+    opal_buffer_t *msg;
+    struct timeval tv;
+    int rc;
+
+    req = OBJ_NEW(scd_recent_request_t);
+    req->id = ++next_id;
+    req->requester = *requester;
+    if (!recent_active) {
+        recent_respond(requester, NULL, 0);
+        OBJ_RELEASE(req);
+        return;
+    }
+
+    /* the aggregators get the request as-is, tagged with our id */
+    OBJ_CONSTRUCT(&targets, opal_list_t);
+    orcm_scd_base_get_aggregators(&targets);
+    OPAL_LIST_FOREACH(nm, &targets, orte_namelist_t) {
+        msg = OBJ_NEW(opal_buffer_t);
+        if (OPAL_SUCCESS != (rc = opal_dss.pack(msg, &req->id, 1, OPAL_UINT32)) ||
+            OPAL_SUCCESS != (rc = opal_dss.copy_payload(msg, buffer))) {
+            ORTE_ERROR_LOG(rc);
+            OBJ_RELEASE(msg);
+            continue;
+        }
+        if (ORTE_SUCCESS != (rc = orte_rml.send_buffer_nb(&nm->name, msg,
+                                                          ORCM_RML_TAG_RECENT_SAMPLES,
+                                                          orte_rml_send_callback, NULL))) {
+            ORTE_ERROR_LOG(rc);
+            OBJ_RELEASE(msg);
+            continue;
+        }
+        req->outstanding++;
+    }
+    OPAL_LIST_DESTRUCT(&targets);
+
+    if (0 == req->outstanding) {
+        recent_respond(requester, NULL, 0);
+        OBJ_RELEASE(req);
+        return;
+    }
+
+    OPAL_OUTPUT_VERBOSE((5, orcm_scd_base_framework.framework_output,
+                         "%s scd:base:recent request %u sent to %d aggregators",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), req->id, req->outstanding));
+
+    opal_list_append(&requests, &req->super);
+    opal_event_evtimer_set(orte_event_base, &req->timer, recent_timeout, req);
+    tv.tv_sec = orcm_scd_base.recent_timeout;
+    tv.tv_usec = 0;
+    opal_event_evtimer_add(&req->timer, &tv);
+    req->timer_active = true;
+}
+
+int orcm_scd_base_recent_start(void)
+{
+    OBJ_CONSTRUCT(&requests, opal_list_t);
+    orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD, ORCM_RML_TAG_RECENT_SAMPLES,
+                            ORTE_RML_PERSISTENT, recent_recv, NULL);
+    recent_active = true;
+    return ORCM_SUCCESS;
+}
+
+void orcm_scd_base_recent_stop(void)
+{
+    if (!recent_active) {
+        return;
+    }
+    orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_RECENT_SAMPLES);
+    OPAL_LIST_DESTRUCT(&requests);
+    recent_active = false;
+}
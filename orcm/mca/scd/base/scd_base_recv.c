@@ -14,6 +14,7 @@
 
 #include "opal/dss/dss.h"
 #include "opal/mca/mca.h"
+#include "opal/util/argv.h"
 #include "opal/util/output.h"
 #include "opal/util/malloc.h"
 #include "opal/mca/base/base.h"
@@ -51,6 +52,10 @@ void orcm_scd_base_fetch_recv(int status, orte_process_name_t* sender,
                               void* cbdata);
 int build_filter_list(opal_buffer_t* buffer, opal_list_t **filter_list);
 int query_db_view(opal_list_t *filters, opal_list_t **results, const char *db_view);
+int query_db_view_aggregate(opal_list_t *filters, orcm_db_aggregate_t *aggregate,
+                            opal_list_t **results, const char *db_view);
+orcm_db_aggregate_t *build_sensor_aggregate(opal_buffer_t *buffer);
+char *aggregate_header(orcm_db_aggregate_t *aggregate);
 int assemble_response(opal_list_t *results, opal_buffer_t **response_buffer);
 char *query_header(const char *db_view);
 
@@ -72,6 +77,11 @@ int orcm_scd_base_comm_start(void)
     /* setup to to receive 'fetch' commands */
     orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD, ORCM_RML_TAG_ORCMD_FETCH, ORTE_RML_PERSISTENT,
                             orcm_scd_base_fetch_recv, NULL);
+    /* relay live telemetry subscriptions and in-memory queries */
+    if (ORCM_PROC_IS_SCHED) {
+        orcm_scd_base_pubsub_start();
+        orcm_scd_base_recent_start();
+    }
 
     recv_issued = true;
 
@@ -90,6 +100,8 @@ int orcm_scd_base_comm_stop(void)
                          ORTE_NAME_PRINT(ORTE_PROC_MY_NAME)));
 
     orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_SCD);
+    orcm_scd_base_pubsub_stop();
+    orcm_scd_base_recent_stop();
     recv_issued = false;
 
     return ORTE_SUCCESS;
@@ -163,6 +175,7 @@ static void orcm_scd_base_recv(int status, orte_process_name_t* sender,
         session->alloc = alloc;
         session->id = orcm_scd_base_get_next_session_id();
         alloc->id = session->id;
+        gettimeofday(&session->queued, NULL);
 
         if (-1 == orcm_scd_base_get_cluster_power_budget()) {
             node_power_budget = -1;
@@ -1264,7 +1277,71 @@ int build_filter_list(opal_buffer_t* buffer,opal_list_t **filter_list)
 #define SAFE_OBJ_RELEASE(x) if(NULL!=x) { OBJ_RELEASE(x); x = NULL; }
 #define TMP_STR_SIZE 1024
 
+/* the grouping and reduction requested by octl, applied to data_sensors_view */
+orcm_db_aggregate_t *build_sensor_aggregate(opal_buffer_t *buffer)
+{
+    orcm_db_aggregate_t *aggregate = NULL;
+    uint8_t function = 0;
+    uint8_t group_by = 0;
+    uint32_t interval = 0;
+    double percentile = 0.0;
+    int n = 1;
+    int rc;
+
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &function, &n, OPAL_UINT8)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &percentile, &n, OPAL_DOUBLE)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &interval, &n, OPAL_UINT32)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &group_by, &n, OPAL_UINT8))) {
+        ORTE_ERROR_LOG(rc);
+        return NULL;
+    }
+    if (ORCM_DB_AGG_PERCENTILE < function) {
+        ORTE_ERROR_LOG(ORCM_ERR_BAD_PARAM);
+        return NULL;
+    }
+
+    aggregate = OBJ_NEW(orcm_db_aggregate_t);
+    aggregate->columns = opal_argv_split("hostname,data_item,time_stamp,value_str,units", ',');
+    if (group_by & ORCM_DB_QUERY_GROUP_BY_NODE) {
+        opal_argv_append_nosize(&aggregate->group_by, "hostname");
+    }
+    if (group_by & ORCM_DB_QUERY_GROUP_BY_SENSOR) {
+        opal_argv_append_nosize(&aggregate->group_by, "data_item");
+    }
+    /* never mix readings taken in different units */
+    opal_argv_append_nosize(&aggregate->group_by, "units");
+    aggregate->time_column = strdup("time_stamp");
+    aggregate->interval = interval;
+    aggregate->value_column = strdup("value_str");
+    aggregate->function = (orcm_db_aggregate_fn_t)function;
+    aggregate->percentile = percentile;
+
+    return aggregate;
+}
+
+char *aggregate_header(orcm_db_aggregate_t *aggregate)
+{
+    static char *function_names[] = {"MIN", "MAX", "AVG", "COUNT"};
+    char *header = NULL;
+    int rc;
+
+    if (ORCM_DB_AGG_PERCENTILE == aggregate->function) {
+        rc = asprintf(&header, "NODE,SENSOR,DATE_TIME,P%g(VALUE),UNITS",
+                      aggregate->percentile * 100.0);
+    } else {
+        rc = asprintf(&header, "NODE,SENSOR,DATE_TIME,%s(VALUE),UNITS",
+                      function_names[aggregate->function]);
+    }
+    return (0 > rc) ? NULL : header;
+}
+
 int query_db_view(opal_list_t *filters, opal_list_t **results, const char *db_view)
+{
+    return query_db_view_aggregate(filters, NULL, results, db_view);
+}
+
+int query_db_view_aggregate(opal_list_t *filters, orcm_db_aggregate_t *aggregate,
+                            opal_list_t **results, const char *db_view)
 {
     int db_status = -1;
     fetch_cb_data data;
@@ -1296,7 +1373,12 @@ int query_db_view(opal_list_t *filters, opal_list_t **results, const char *db_vi
         goto db_cleanup;
     }
     data.active = true;
-    orcm_db.fetch(data.dbhandle, db_view, filters, fetch_output, fetch_callback, &data);
+    if (NULL != aggregate) {
+        orcm_db.fetch_aggregate(data.dbhandle, db_view, filters, aggregate,
+                                fetch_output, fetch_callback, &data);
+    } else {
+        orcm_db.fetch(data.dbhandle, db_view, filters, fetch_output, fetch_callback, &data);
+    }
     ORTE_WAIT_FOR_COMPLETION(data.active);
     /*Free filters list as we no longer need it*/
     SAFE_OBJ_RELEASE(filters);
@@ -1317,7 +1399,11 @@ int query_db_view(opal_list_t *filters, opal_list_t **results, const char *db_vi
         /*Create first item of results*/
         string_row = OBJ_NEW(opal_value_t);
         string_row->type = OPAL_STRING;
-        string_row->data.string = strdup(query_header(db_view));
+        if (NULL != aggregate) {
+            string_row->data.string = aggregate_header(aggregate);
+        } else {
+            string_row->data.string = strdup(query_header(db_view));
+        }
         opal_list_append(*results, &string_row->super);
         for (row_index = 0; row_index < num_rows; ++row_index){
             row = OBJ_NEW(opal_list_t);
@@ -1538,6 +1624,7 @@ void orcm_scd_base_fetch_recv(int status, orte_process_name_t* sender,
     opal_value_t *tmp_value = NULL;
     uint8_t operation = 0;
     orcm_db_filter_t *tmp_filter = NULL;
+    orcm_db_aggregate_t *aggregate = NULL;
     opal_list_t *results_list = NULL;
     uint16_t results_count;
     opal_buffer_t *response_buffer = NULL;
@@ -1715,6 +1802,42 @@ void orcm_scd_base_fetch_recv(int status, orte_process_name_t* sender,
                 OBJ_RELEASE(results_list);
             }
             break;
+        case ORCM_GET_DB_QUERY_AGGREGATE_COMMAND:
+            if (ORCM_ERROR == build_filter_list(buffer, &filter_list)){
+                OBJ_RELEASE(filter_list);
+                return;
+            }
+            /* the database reduces the rows, only one per group comes back */
+            if (NULL != (aggregate = build_sensor_aggregate(buffer))) {
+                query_db_view_aggregate(filter_list, aggregate, &results_list, "data_sensors_view");
+                OBJ_RELEASE(aggregate);
+            } else if (NULL != filter_list) {
+                OBJ_RELEASE(filter_list);
+            }
+            if (ORCM_SUCCESS != (rc = assemble_response(results_list, &response_buffer))) {
+                ORTE_ERROR_LOG(rc);
+                return;
+            }
+            if (NULL == response_buffer){
+                rc = ORCM_ERR_BAD_PARAM;
+                ORTE_ERROR_LOG(rc);
+                return;
+            }
+            if (ORTE_SUCCESS != (rc = orte_rml.send_buffer_nb(sender, response_buffer,
+                                                              ORCM_RML_TAG_ORCMD_FETCH,
+                                                              orte_rml_send_callback, cbdata))) {
+                ORTE_ERROR_LOG(rc);
+                OBJ_RELEASE(response_buffer);
+                return;
+            }
+            if(NULL != results_list){
+                OBJ_RELEASE(results_list);
+            }
+            break;
+        case ORCM_GET_RECENT_SENSOR_COMMAND:
+            /* answered from the aggregators' memory, not the database */
+            orcm_scd_base_recent_query(sender, buffer);
+            break;
         case ORCM_GET_DB_SENSOR_INVENTORY_COMMAND:
             /* Build filter list */
             n = 1;
@@ -182,6 +182,8 @@ static void scd_base_rm_active(int sd, short args, void *cbdata)
     
     trk = OBJ_NEW(orcm_alloc_tracker_t);
     trk->alloc_id = caddy->session->id;
+    trk->queued = caddy->session->queued;
+    trk->reused = caddy->session->reused;
     opal_list_append(&orcm_scd_base.tracking, &trk->super);
 
     /* node array should be indexed by node num,
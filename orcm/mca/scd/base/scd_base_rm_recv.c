@@ -315,6 +315,28 @@ static void orcm_scd_base_rm_recv(int status, orte_process_name_t* sender,
             }
         }
         opal_output(0, "scheduler: couldn't find running allocation to cancel : %ld!\n", (long)alloc->id);
+    } else if (ORCM_VM_READY_COMMAND == command) {
+        OPAL_OUTPUT_VERBOSE((5, orcm_scd_base_framework.framework_output,
+                             "%s scd:base:rm:receive got ORCM_VM_READY_COMMAND",
+                             ORTE_NAME_PRINT(ORTE_PROC_MY_NAME)));
+        cnt = 1;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &alloc,
+                                                  &cnt, ORCM_ALLOC))) {
+            ORTE_ERROR_LOG(rc);
+            return;
+        }
+
+        /* the session is running once every node has launched its part */
+        OPAL_LIST_FOREACH(trk, &orcm_scd_base.tracking, orcm_alloc_tracker_t) {
+            if (trk->alloc_id == alloc->id) {
+                trk->count_ready++;
+                if (trk->count_ready == alloc->min_nodes) {
+                    orcm_scd_base_session_running(trk);
+                }
+                break;
+            }
+        }
+        OBJ_RELEASE(alloc);
     } else if (ORCM_SET_POWER_COMMAND == command) {
         OPAL_OUTPUT_VERBOSE((5, orcm_scd_base_framework.framework_output,
                              "%s scd:base:rm:receive got ORCM_SET_POWER_COMMAND",
@@ -352,38 +352,50 @@ static void fifo_terminated(int sd, short args, void *cbdata)
     char **nodenames = NULL;
     orcm_queue_t *q;
     orcm_session_t *session;
+    bool reused = false;
 
-    /* set nodes to UNALLOC
-    */
-    if (ORTE_SUCCESS !=
-        (rc = orte_regex_extract_node_names(caddy->session->alloc->nodes,
-                                            &nodenames))) {
-        ORTE_ERROR_LOG(rc);
-        OPAL_OUTPUT_VERBOSE((5, orcm_scd_base_framework.framework_output,
-                             "%s scd:fifo:terminated - (session: %d) could not extract nodelist\n",
-                             ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
-                             caddy->session->id));
-
-        if (NULL != nodenames) {
-            opal_argv_free(nodenames);
+    /* if session reuse is enabled, the nodes may go straight to the
+     * next session in line - they then stay allocated */
+    OPAL_LIST_FOREACH(q, &orcm_scd_base.queues, orcm_queue_t) {
+        if (0 == strcmp(q->name, "default")) {
+            reused = orcm_scd_base_reuse_session(caddy->session, &q->sessions);
+            break;
         }
-
-        return;
     }
 
-    num_nodes = opal_argv_count(nodenames);
+    if (!reused) {
+        /* set nodes to UNALLOC
+        */
+        if (ORTE_SUCCESS !=
+            (rc = orte_regex_extract_node_names(caddy->session->alloc->nodes,
+                                                &nodenames))) {
+            ORTE_ERROR_LOG(rc);
+            OPAL_OUTPUT_VERBOSE((5, orcm_scd_base_framework.framework_output,
+                                 "%s scd:fifo:terminated - (session: %d) could not extract nodelist\n",
+                                 ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                                 caddy->session->id));
 
-    /* node array should be indexed by node num, 
-     * if we change to lookup by index that would be faster 
-     */
-    for (i = 0; i < num_nodes; i++) {
-        for (j = 0; j < orcm_scd_base.nodes.size; j++) {
-            if (NULL == (nodeptr =
-                         (orcm_node_t*)opal_pointer_array_get_item(&orcm_scd_base.nodes, j))) {
-                continue;
+            if (NULL != nodenames) {
+                opal_argv_free(nodenames);
             }
-            if (0 == strcmp(nodeptr->name, nodenames[i])) {
-                nodeptr->scd_state = ORCM_SCD_NODE_STATE_UNALLOC;
+
+            return;
+        }
+
+        num_nodes = opal_argv_count(nodenames);
+
+        /* node array should be indexed by node num, 
+         * if we change to lookup by index that would be faster 
+         */
+        for (i = 0; i < num_nodes; i++) {
+            for (j = 0; j < orcm_scd_base.nodes.size; j++) {
+                if (NULL == (nodeptr =
+                             (orcm_node_t*)opal_pointer_array_get_item(&orcm_scd_base.nodes, j))) {
+                    continue;
+                }
+                if (0 == strcmp(nodeptr->name, nodenames[i])) {
+                    nodeptr->scd_state = ORCM_SCD_NODE_STATE_UNALLOC;
+                }
             }
         }
     }
@@ -399,6 +411,8 @@ static void fifo_terminated(int sd, short args, void *cbdata)
         }
     }
 
+    /* even when the nodes were handed on, the queue head has moved
+     * and the sessions behind it may now fit */
     ORCM_ACTIVATE_SCD_STATE(caddy->session, ORCM_SESSION_STATE_SCHEDULE);
 
     OBJ_RELEASE(caddy);
@@ -184,6 +184,8 @@ typedef struct {
     orte_process_name_t requestor;
     orcm_alloc_t *alloc;  // master allocation for the session
     opal_list_t steps;
+    struct timeval queued;  // time the request reached the scheduler
+    bool reused;            // took over the nodes of a completed session
 } orcm_session_t;
 OBJ_CLASS_DECLARATION(orcm_session_t);
 
@@ -16,6 +16,7 @@
 
 #include "orte/mca/errmgr/errmgr.h"
 #include "orte/mca/rml/rml.h"
+#include "orte/runtime/orte_globals.h"
 
 #include "opal/dss/dss.h"
 #include "opal/mca/event/event.h"
@@ -27,19 +28,28 @@
 #include "orcm/mca/sensor/base/sensor_private.h"
 
 #include "orcm/util/utils.h"
+#include "orcm/util/fanout.h"
 
 static bool recv_issued=false;
+static bool inventory_recv_issued=false;
+/* the node repeats its inventory digest on this timer */
+static bool digest_ev_active = false;
+static opal_event_t digest_ev;
+static struct timeval digest_interval;
+static orte_process_name_t digest_tgt;
 static bool mods_active = false;
 static void take_sample(int fd, short args, void *cbdata);
 
 /* This function will eventually be called as part of an even loop when
  * dynamic inventory collection is requested */
 static void collect_inventory_info(opal_buffer_t* inventory_snapshot);
+static void resend_digest(int fd, short args, void *cbdata);
 
 void static recv_inventory(int status, orte_process_name_t* sender,
                        opal_buffer_t *buffer,
                        orte_rml_tag_t tag, void *cbdata);
 
+static int sensor_base_command(opal_buffer_t *buffer, opal_buffer_t *ans);
 static void orcm_sensor_base_recv(int status, orte_process_name_t* sender,
                                 opal_buffer_t* buffer, orte_rml_tag_t tag,
                                 void* cbdata);
@@ -57,6 +67,10 @@ static void db_open_cb(int handle, int status, opal_list_t *props,
                                     ORCM_RML_TAG_INVENTORY,
                                     ORTE_RML_PERSISTENT,
                                     recv_inventory, NULL);
+            orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD,
+                                    ORCM_RML_TAG_INVENTORY_DIGEST,
+                                    ORTE_RML_PERSISTENT,
+                                    orcm_sensor_base_inventory_recv_digest, NULL);
         }
     } else {
         opal_output(0,"DB Open failed");
@@ -97,6 +111,7 @@ void orcm_sensor_base_start(orte_jobid_t job)
 
         orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD, ORCM_RML_TAG_SENSOR,
                                 ORTE_RML_PERSISTENT, orcm_sensor_base_recv, NULL);
+        orcm_fanout_register(ORCM_RML_TAG_SENSOR, sensor_base_command);
         recv_issued = true;
     }
 
@@ -177,6 +192,13 @@ void orcm_sensor_base_start(orte_jobid_t job)
     }
 
     if(true == orcm_sensor_base.collect_inventory) {
+        if (orcm_sensor_base.inventory_digest && !inventory_recv_issued) {
+            /* the aggregator answers our digest with the parts it needs */
+            orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD, ORCM_RML_TAG_INVENTORY_REQUEST,
+                                    ORTE_RML_PERSISTENT,
+                                    orcm_sensor_base_inventory_recv_request, NULL);
+            inventory_recv_issued = true;
+        }
         inventory_snapshot = OBJ_NEW(opal_buffer_t);
 
         if (false == orcm_sensor_base.set_dynamic_inventory) { /* Collect inventory details just once when orcmd starts */
@@ -199,28 +221,15 @@ void orcm_sensor_base_start(orte_jobid_t job)
 
 void collect_inventory_info(opal_buffer_t *inventory_snapshot)
 {
-    orcm_sensor_active_module_t *i_module;
-    int32_t i,rc;
+    int32_t rc;
     orte_process_name_t *tgt;
 
     opal_output_verbose(5, orcm_sensor_base_framework.framework_output,
                         "%s sensor:base: Starting Inventory Collection",
                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
-    if (OPAL_SUCCESS != (rc = opal_dss.pack(inventory_snapshot, &orte_process_info.nodename, 1, OPAL_STRING))) {
-        ORTE_ERROR_LOG(rc);
-        return;
-    }
 
     /* call the inventory collection function of all enabled modules in priority order */
-    for (i=0; i < orcm_sensor_base.modules.size; i++) {
-        if (NULL == (i_module = (orcm_sensor_active_module_t*)opal_pointer_array_get_item(&orcm_sensor_base.modules, i))) {
-            continue;
-        }
-
-        if (NULL != i_module->module->inventory_collect) {
-            i_module->module->inventory_collect(inventory_snapshot);
-        }
-    }
+    orcm_sensor_base_inventory_collect();
 
     if (ORTE_PROC_IS_CM) {
         /* we send to our daemon */
@@ -229,6 +238,28 @@ void collect_inventory_info(opal_buffer_t *inventory_snapshot)
         tgt = ORTE_PROC_MY_HNP;
     }
 
+    if (orcm_sensor_base.inventory_digest) {
+        /* the full inventory only goes out if the aggregator asks for it */
+        OBJ_RELEASE(inventory_snapshot);
+        orcm_sensor_base_inventory_send_digest(tgt);
+        if (0 < orcm_sensor_base.inventory_digest_interval && !digest_ev_active) {
+            /* repeat it so the aggregator can ask again for
+             * anything it failed to store */
+            digest_tgt = *tgt;
+            digest_interval.tv_sec = orcm_sensor_base.inventory_digest_interval;
+            digest_interval.tv_usec = 0;
+            opal_event_evtimer_set(orte_event_base, &digest_ev, resend_digest, NULL);
+            opal_event_evtimer_add(&digest_ev, &digest_interval);
+            digest_ev_active = true;
+        }
+        return;
+    }
+
+    if (ORCM_SUCCESS != orcm_sensor_base_inventory_pack(inventory_snapshot, NULL)) {
+        OBJ_RELEASE(inventory_snapshot);
+        return;
+    }
+
     /* send Inventory data */
     if (ORCM_SUCCESS != (rc = orte_rml.send_buffer_nb(tgt, inventory_snapshot,
                                                       ORCM_RML_TAG_INVENTORY,
@@ -239,6 +270,12 @@ void collect_inventory_info(opal_buffer_t *inventory_snapshot)
 
 }
 
+static void resend_digest(int fd, short args, void *cbdata)
+{
+    orcm_sensor_base_inventory_send_digest(&digest_tgt);
+    opal_event_evtimer_add(&digest_ev, &digest_interval);
+}
+
 static void recv_inventory(int status, orte_process_name_t* sender,
                        opal_buffer_t *buffer,
                        orte_rml_tag_t tag, void *cbdata)
@@ -295,9 +332,19 @@ void orcm_sensor_base_stop(orte_jobid_t job)
                              ORTE_NAME_PRINT(ORTE_PROC_MY_NAME)));
 
        orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_SENSOR);
+       orcm_fanout_register(ORCM_RML_TAG_SENSOR, NULL);
        recv_issued = false;
     }
 
+    if (inventory_recv_issued) {
+        orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_INVENTORY_REQUEST);
+        inventory_recv_issued = false;
+    }
+    if (digest_ev_active) {
+        opal_event_evtimer_del(&digest_ev);
+        digest_ev_active = false;
+    }
+
     if (!mods_active) {
         opal_output_verbose(5, orcm_sensor_base_framework.framework_output, "sensor stop: no active mods");
         return;
@@ -347,8 +394,10 @@ static void take_sample(int fd, short args, void *cbdata)
 
     /* if anything is in the base cache, add it here - this
      * is safe to do since we are in the base event thread,
-     * and the cache can only be accessed from there */
-    if (0 < orcm_sensor_base.cache.bytes_used) {
+     * and the cache can only be accessed from there. A sample
+     * taken for a caller's cbfunc is not sent on, so leave
+     * the cache for the next one that is */
+    if (NULL == sampler->cbfunc && 0 < orcm_sensor_base.cache.bytes_used) {
         opal_buffer_t *bptr;
         bptr = &orcm_sensor_base.cache;
         opal_dss.copy_payload(&sampler->bucket, bptr);
@@ -399,7 +448,7 @@ static void take_sample(int fd, short args, void *cbdata)
     return;
 }
 
-void orcm_sensor_base_log(char *comp, opal_buffer_t *data)
+void orcm_sensor_base_log(const char *comp, opal_buffer_t *data)
 {
     int i;
     orcm_sensor_active_module_t *i_module;
@@ -459,13 +508,10 @@ void orcm_sensor_base_manually_sample(char *sensors,
     return;
 }
 
-/* process incoming messages in order of receipt */
-static void orcm_sensor_base_recv(int status, orte_process_name_t *sender,
-                                opal_buffer_t *buffer, orte_rml_tag_t tag,
-                                void *cbdata)
+/* run one sensor command and pack the answer */
+static int sensor_base_command(opal_buffer_t *buffer, opal_buffer_t *ans)
 {
     orcm_sensor_cmd_flag_t command, sub_command;
-    opal_buffer_t *ans;
     orcm_sensor_active_module_t *i_module;
     int sample_rate = 0;
     int i, rc, response, cnt;
@@ -486,7 +532,6 @@ static void orcm_sensor_base_recv(int status, orte_process_name_t *sender,
                          "%s sensor:base:receive processing msg",
                          ORTE_NAME_PRINT(ORTE_PROC_MY_NAME)));
 
-    ans = OBJ_NEW(opal_buffer_t);
     response = ORCM_SUCCESS;
 
     /* unpack the command */
@@ -575,8 +620,7 @@ static void orcm_sensor_base_recv(int status, orte_process_name_t *sender,
                 response = ORCM_SUCCESS;
                 if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &response, 1, OPAL_INT))) {
                     ORTE_ERROR_LOG(rc);
-                    OBJ_RELEASE(ans);
-                    return;
+                    return rc;
                 }
                 goto RESPONSE;
             } else {
@@ -675,8 +719,7 @@ static void orcm_sensor_base_recv(int status, orte_process_name_t *sender,
             response = ORCM_SUCCESS;
             if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &response, 1, OPAL_INT))) {
                 ORTE_ERROR_LOG(rc);
-                OBJ_RELEASE(ans);
-                return;
+                return rc;
             }
             goto RESPONSE;
             break;
@@ -743,19 +786,16 @@ static void orcm_sensor_base_recv(int status, orte_process_name_t *sender,
             }
             if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &response, 1, OPAL_INT))) {
                 ORTE_ERROR_LOG(rc);
-                OBJ_RELEASE(ans);
                 goto ERROR;
             }
 
             if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &sensor_name,
                                                     1, OPAL_STRING))) {
                 ORTE_ERROR_LOG(rc);
-                OBJ_RELEASE(ans);
                 goto ERROR;
             }
             if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &sample_rate, 1, OPAL_INT))) {
                 ORTE_ERROR_LOG(rc);
-                OBJ_RELEASE(ans);
                 goto ERROR;
             }
             goto RESPONSE;
@@ -767,7 +807,6 @@ static void orcm_sensor_base_recv(int status, orte_process_name_t *sender,
             cnt = opal_list_get_size(&orcm_sensor_base.policy);
             if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &cnt, 1, OPAL_INT))) {
                 ORTE_ERROR_LOG(rc);
-                OBJ_RELEASE(ans);
                 goto ERROR;
             }
 
@@ -777,7 +816,6 @@ static void orcm_sensor_base_recv(int status, orte_process_name_t *sender,
                 if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &plc->sensor_name,
                                                   1, OPAL_STRING))) {
                     ORTE_ERROR_LOG(rc);
-                    OBJ_RELEASE(ans);
                     goto ERROR;
                 }
 
@@ -785,7 +823,6 @@ static void orcm_sensor_base_recv(int status, orte_process_name_t *sender,
                 if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &plc->threshold,
                                                   1, OPAL_FLOAT))) {
                     ORTE_ERROR_LOG(rc);
-                    OBJ_RELEASE(ans);
                     goto ERROR;
                 }
 
@@ -793,7 +830,6 @@ static void orcm_sensor_base_recv(int status, orte_process_name_t *sender,
                 if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &plc->hi_thres,
                                                   1, OPAL_BOOL))) {
                     ORTE_ERROR_LOG(rc);
-                    OBJ_RELEASE(ans);
                     goto ERROR;
                 }
 
@@ -801,7 +837,6 @@ static void orcm_sensor_base_recv(int status, orte_process_name_t *sender,
                 if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &plc->max_count,
                                                   1, OPAL_INT))) {
                     ORTE_ERROR_LOG(rc);
-                    OBJ_RELEASE(ans);
                     goto ERROR;
                 }
 
@@ -809,7 +844,6 @@ static void orcm_sensor_base_recv(int status, orte_process_name_t *sender,
                 if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &plc->time_window,
                                                   1, OPAL_INT))) {
                     ORTE_ERROR_LOG(rc);
-                    OBJ_RELEASE(ans);
                     goto ERROR;
                 }
 
@@ -817,7 +851,6 @@ static void orcm_sensor_base_recv(int status, orte_process_name_t *sender,
                 if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &plc->severity,
                                                   1, OPAL_INT))) {
                     ORTE_ERROR_LOG(rc);
-                    OBJ_RELEASE(ans);
                     goto ERROR;
                 }
 
@@ -825,7 +858,6 @@ static void orcm_sensor_base_recv(int status, orte_process_name_t *sender,
                 if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &plc->action,
                                                   1, OPAL_STRING))) {
                     ORTE_ERROR_LOG(rc);
-                    OBJ_RELEASE(ans);
                     goto ERROR;
                 }
             }
@@ -843,11 +875,8 @@ ERROR:
 
     if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &response, 1, OPAL_INT))) {
         ORTE_ERROR_LOG(rc);
-        if(NULL != ans) {
-            OBJ_RELEASE(ans);
-        }
         SAFEFREE(error);
-        return;
+        return rc;
     }
     if (NULL == error) {
         asprintf(&error,"sensor data buffer mismatch");
@@ -855,23 +884,34 @@ ERROR:
 
     if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &error, 1, OPAL_STRING))) {
         ORTE_ERROR_LOG(rc);
-        if(NULL != ans) {
-            OBJ_RELEASE(ans);
-        }
         SAFEFREE(error);
-        return;
+        return rc;
     }
     SAFEFREE(error);
 
 RESPONSE:
+    return ORCM_SUCCESS;
+}
+
+/* process incoming messages in order of receipt */
+static void orcm_sensor_base_recv(int status, orte_process_name_t *sender,
+                                opal_buffer_t *buffer, orte_rml_tag_t tag,
+                                void *cbdata)
+{
+    opal_buffer_t *ans;
+    int rc;
+
+    ans = OBJ_NEW(opal_buffer_t);
+    if (ORCM_SUCCESS != sensor_base_command(buffer, ans)) {
+        OBJ_RELEASE(ans);
+        return;
+    }
     if (ORTE_SUCCESS !=
         (rc = orte_rml.send_buffer_nb(sender, ans,
                                       ORCM_RML_TAG_SENSOR,
                                       orte_rml_send_callback, NULL))) {
         ORTE_ERROR_LOG(rc);
-        if(NULL != ans) {
-            OBJ_RELEASE(ans);
-        }
+        OBJ_RELEASE(ans);
         return;
     }
 }
@@ -884,6 +924,11 @@ void orcm_sensor_base_collect(int fd, short args, void *cbdata)
      * copy the data to the base cache bucket
      * so it can be swept up by the next update */
     opal_dss.copy_payload(&orcm_sensor_base.cache, &x->bucket);
+    /* the heartbeat sends whatever is in the cache, so
+     * beating now gets urgent data out without waiting */
+    if (x->flush) {
+        orcm_sensor_base_manually_sample("heartbeat", NULL, NULL);
+    }
     /* release memory */
     OBJ_RELEASE(x);
 }
@@ -94,6 +94,22 @@ static int orcm_sensor_base_register(mca_base_register_flag_t flags)
                                 MCA_BASE_VAR_SCOPE_READONLY,
                                 &orcm_sensor_base.set_dynamic_inventory);
 
+    orcm_sensor_base.inventory_digest = true;
+    (void)mca_base_var_register("orcm", "sensor", "base", "inventory_digest",
+                                "Send a hash of the inventory first and only the parts the aggregator does not already have",
+                                MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                OPAL_INFO_LVL_9,
+                                MCA_BASE_VAR_SCOPE_READONLY,
+                                &orcm_sensor_base.inventory_digest);
+
+    orcm_sensor_base.inventory_digest_interval = 600;
+    (void)mca_base_var_register("orcm", "sensor", "base", "inventory_digest_interval",
+                                "Seconds between repeats of the inventory digest, so parts the aggregator failed to store are sent again (0 to send it once)",
+                                MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                OPAL_INFO_LVL_9,
+                                MCA_BASE_VAR_SCOPE_READONLY,
+                                &orcm_sensor_base.inventory_digest_interval);
+
     return ORCM_SUCCESS;
 }
 
@@ -119,6 +135,12 @@ static int orcm_sensor_base_close(void)
     }
     OBJ_DESTRUCT(&orcm_sensor_base.modules);
 
+    /* drop the cached inventory and the per-host digests */
+    orcm_sensor_base_inventory_finalize();
+
+    /* drop any file watches the components left behind */
+    orcm_sensor_base_watch_finalize();
+
     /* clear the per-component-thread collection cache */
     OBJ_DESTRUCT(&orcm_sensor_base.cache);
     
@@ -212,6 +234,7 @@ OBJ_CLASS_INSTANCE(orcm_sensor_policy_t,
 static void xcon(orcm_sensor_xfer_t *x)
 {
     OBJ_CONSTRUCT(&x->bucket, opal_buffer_t);
+    x->flush = false;
 }
 static void xdes(orcm_sensor_xfer_t *x)
 {
@@ -0,0 +1,488 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#include "opal/class/opal_hash_table.h"
+#include "opal/class/opal_list.h"
+#include "opal/dss/dss.h"
+#include "opal/util/argv.h"
+#include "opal/util/output.h"
+#include "opal/threads/mutex.h"
+
+#include "orte/mca/errmgr/errmgr.h"
+#include "orte/mca/rml/rml.h"
+#include "orte/util/name_fns.h"
+#include "orte/runtime/orte_globals.h"
+
+#include "orcm/runtime/orcm_globals.h"
+#include "orcm/mca/db/db.h"
+#include "orcm/mca/sensor/base/base.h"
+#include "orcm/mca/sensor/base/sensor_private.h"
+
+#define FNV64_OFFSET    0xcbf29ce484222325ULL
+#define FNV64_PRIME     0x100000001b3ULL
+
+/* On a node: the inventory one component contributed, as it
+ * was packed by that component, so it can be sent on request */
+typedef struct {
+    opal_list_item_t super;
+    char *component;
+    uint64_t hash;
+    opal_buffer_t data;
+} inventory_part_t;
+static void pcon(inventory_part_t *p)
+{
+    p->component = NULL;
+    p->hash = 0;
+    OBJ_CONSTRUCT(&p->data, opal_buffer_t);
+}
+static void pdes(inventory_part_t *p)
+{
+    if (NULL != p->component) {
+        free(p->component);
+    }
+    OBJ_DESTRUCT(&p->data);
+}
+static OBJ_CLASS_INSTANCE(inventory_part_t,
+                          opal_list_item_t,
+                          pcon, pdes);
+
+/* On the aggregator: what is stored for one component of a
+ * host, and what the host last said it has. The pending hash
+ * only becomes the stored one once the database has the data,
+ * so a failed write is asked for again on the next digest. */
+typedef struct {
+    opal_list_item_t super;
+    char *component;
+    uint64_t stored;
+    bool have_stored;
+    uint64_t pending;
+    bool have_pending;
+} inventory_digest_t;
+static void dcon(inventory_digest_t *p)
+{
+    p->component = NULL;
+    p->have_stored = false;
+    p->have_pending = false;
+}
+static void ddes(inventory_digest_t *p)
+{
+    if (NULL != p->component) {
+        free(p->component);
+    }
+}
+static OBJ_CLASS_INSTANCE(inventory_digest_t,
+                          opal_list_item_t,
+                          dcon, ddes);
+
+/* On the aggregator: the write of one component's inventory */
+typedef struct {
+    opal_object_t super;
+    char *hostname;
+    char *component;
+} inventory_write_t;
+static void wcon(inventory_write_t *p)
+{
+    p->hostname = NULL;
+    p->component = NULL;
+}
+static void wdes(inventory_write_t *p)
+{
+    if (NULL != p->hostname) {
+        free(p->hostname);
+    }
+    if (NULL != p->component) {
+        free(p->component);
+    }
+}
+static OBJ_CLASS_INSTANCE(inventory_write_t,
+                          opal_object_t,
+                          wcon, wdes);
+
+static bool initialized = false;
+static opal_list_t parts;          /* node: inventory_part_t */
+static opal_hash_table_t hosts;    /* aggregator: hostname -> opal_list_t of inventory_digest_t */
+static opal_mutex_t lock;          /* hosts is updated from the database callbacks too */
+
+static void init(void)
+{
+    if (initialized) {
+        return;
+    }
+    OBJ_CONSTRUCT(&parts, opal_list_t);
+    OBJ_CONSTRUCT(&hosts, opal_hash_table_t);
+    opal_hash_table_init(&hosts, 256);
+    OBJ_CONSTRUCT(&lock, opal_mutex_t);
+    initialized = true;
+}
+
+static uint64_t hash_buffer(opal_buffer_t *buf)
+{
+    uint64_t h = FNV64_OFFSET;
+    unsigned char *p = (unsigned char*)buf->base_ptr;
+    size_t i;
+
+    for (i=0; i < buf->bytes_used; i++) {
+        h ^= (uint64_t)p[i];
+        h *= FNV64_PRIME;
+    }
+    return h;
+}
+
+static bool argv_has(char **argv, const char *name)
+{
+    int i;
+
+    for (i=0; NULL != argv && NULL != argv[i]; i++) {
+        if (0 == strcmp(argv[i], name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static opal_list_t* get_host(char *hostname, bool create)
+{
+    opal_list_t *digests = NULL;
+
+    if (OPAL_SUCCESS == opal_hash_table_get_value_ptr(&hosts, hostname, strlen(hostname)+1,
+                                                      (void**)&digests)) {
+        return digests;
+    }
+    if (!create) {
+        return NULL;
+    }
+    digests = OBJ_NEW(opal_list_t);
+    opal_hash_table_set_value_ptr(&hosts, hostname, strlen(hostname)+1, digests);
+    return digests;
+}
+
+static inventory_digest_t* get_digest(opal_list_t *digests, const char *component)
+{
+    inventory_digest_t *dg;
+
+    OPAL_LIST_FOREACH(dg, digests, inventory_digest_t) {
+        if (0 == strcmp(dg->component, component)) {
+            return dg;
+        }
+    }
+    return NULL;
+}
+
+void orcm_sensor_base_inventory_collect(void)
+{
+    orcm_sensor_active_module_t *i_module;
+    inventory_part_t *part;
+    int i;
+
+    init();
+    OPAL_LIST_DESTRUCT(&parts);
+    OBJ_CONSTRUCT(&parts, opal_list_t);
+
+    /* call the inventory collection function of all enabled modules in priority order */
+    for (i=0; i < orcm_sensor_base.modules.size; i++) {
+        if (NULL == (i_module = (orcm_sensor_active_module_t*)opal_pointer_array_get_item(&orcm_sensor_base.modules, i))) {
+            continue;
+        }
+        if (NULL == i_module->module->inventory_collect) {
+            continue;
+        }
+        part = OBJ_NEW(inventory_part_t);
+        part->component = strdup(i_module->component->base_version.mca_component_name);
+        i_module->module->inventory_collect(&part->data);
+        if (0 == part->data.bytes_used) {
+            OBJ_RELEASE(part);
+            continue;
+        }
+        part->hash = hash_buffer(&part->data);
+        opal_list_append(&parts, &part->super);
+    }
+}
+
+int orcm_sensor_base_inventory_pack(opal_buffer_t *buf, char **components)
+{
+    inventory_part_t *part;
+    int rc;
+
+    init();
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(buf, &orte_process_info.nodename, 1, OPAL_STRING))) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+    OPAL_LIST_FOREACH(part, &parts, inventory_part_t) {
+        if (NULL != components && !argv_has(components, part->component)) {
+            continue;
+        }
+        if (OPAL_SUCCESS != (rc = opal_dss.copy_payload(buf, &part->data))) {
+            ORTE_ERROR_LOG(rc);
+            return rc;
+        }
+    }
+    return ORCM_SUCCESS;
+}
+
+int orcm_sensor_base_inventory_send_digest(orte_process_name_t *tgt)
+{
+    opal_buffer_t *buf;
+    inventory_part_t *part;
+    int32_t n;
+    int rc;
+
+    init();
+    buf = OBJ_NEW(opal_buffer_t);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(buf, &orte_process_info.nodename, 1, OPAL_STRING))) {
+        goto error;
+    }
+    n = (int32_t)opal_list_get_size(&parts);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(buf, &n, 1, OPAL_INT32))) {
+        goto error;
+    }
+    OPAL_LIST_FOREACH(part, &parts, inventory_part_t) {
+        if (OPAL_SUCCESS != (rc = opal_dss.pack(buf, &part->component, 1, OPAL_STRING))) {
+            goto error;
+        }
+        if (OPAL_SUCCESS != (rc = opal_dss.pack(buf, &part->hash, 1, OPAL_UINT64))) {
+            goto error;
+        }
+    }
+
+    opal_output_verbose(5, orcm_sensor_base_framework.framework_output,
+                        "%s sensor:base: sending inventory digest of %d components to %s",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), n, ORTE_NAME_PRINT(tgt));
+    if (ORCM_SUCCESS != (rc = orte_rml.send_buffer_nb(tgt, buf,
+                                                      ORCM_RML_TAG_INVENTORY_DIGEST,
+                                                      orte_rml_send_callback, NULL))) {
+        goto error;
+    }
+    return ORCM_SUCCESS;
+
+error:
+    ORTE_ERROR_LOG(rc);
+    OBJ_RELEASE(buf);
+    return rc;
+}
+
+void orcm_sensor_base_inventory_recv_digest(int status, orte_process_name_t* sender,
+                                            opal_buffer_t *buffer,
+                                            orte_rml_tag_t tag, void *cbdata)
+{
+    char *hostname = NULL, *component = NULL;
+    char **wanted = NULL;
+    opal_list_t *digests;
+    inventory_digest_t *dg;
+    opal_buffer_t *ans;
+    uint64_t hash;
+    int32_t i, n, count, nwanted;
+    int rc;
+
+    init();
+    n = 1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &hostname, &n, OPAL_STRING))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+    n = 1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &count, &n, OPAL_INT32))) {
+        ORTE_ERROR_LOG(rc);
+        free(hostname);
+        return;
+    }
+
+    opal_mutex_lock(&lock);
+    digests = get_host(hostname, true);
+    for (i=0; i < count; i++) {
+        n = 1;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &component, &n, OPAL_STRING))) {
+            ORTE_ERROR_LOG(rc);
+            opal_mutex_unlock(&lock);
+            goto cleanup;
+        }
+        n = 1;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &hash, &n, OPAL_UINT64))) {
+            ORTE_ERROR_LOG(rc);
+            free(component);
+            opal_mutex_unlock(&lock);
+            goto cleanup;
+        }
+        if (NULL == (dg = get_digest(digests, component))) {
+            dg = OBJ_NEW(inventory_digest_t);
+            dg->component = strdup(component);
+            opal_list_append(digests, &dg->super);
+        }
+        if (dg->have_stored && hash == dg->stored) {
+            dg->have_pending = false;
+        } else {
+            dg->pending = hash;
+            dg->have_pending = true;
+            opal_argv_append_nosize(&wanted, component);
+        }
+        free(component);
+    }
+    opal_mutex_unlock(&lock);
+
+    nwanted = opal_argv_count(wanted);
+    opal_output_verbose(5, orcm_sensor_base_framework.framework_output,
+                        "%s sensor:base: inventory digest from %s - %d of %d components changed",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), hostname, nwanted, count);
+    if (0 == nwanted) {
+        goto cleanup;
+    }
+
+    /* ask the node for just the components we do not have */
+    ans = OBJ_NEW(opal_buffer_t);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &nwanted, 1, OPAL_INT32))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(ans);
+        goto cleanup;
+    }
+    for (i=0; i < nwanted; i++) {
+        if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &wanted[i], 1, OPAL_STRING))) {
+            ORTE_ERROR_LOG(rc);
+            OBJ_RELEASE(ans);
+            goto cleanup;
+        }
+    }
+    if (ORCM_SUCCESS != (rc = orte_rml.send_buffer_nb(sender, ans,
+                                                      ORCM_RML_TAG_INVENTORY_REQUEST,
+                                                      orte_rml_send_callback, NULL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(ans);
+    }
+
+cleanup:
+    opal_argv_free(wanted);
+    free(hostname);
+}
+
+void orcm_sensor_base_inventory_recv_request(int status, orte_process_name_t* sender,
+                                             opal_buffer_t *buffer,
+                                             orte_rml_tag_t tag, void *cbdata)
+{
+    char *component = NULL;
+    char **wanted = NULL;
+    opal_buffer_t *ans;
+    int32_t i, n, count;
+    int rc;
+
+    n = 1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &count, &n, OPAL_INT32))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+    for (i=0; i < count; i++) {
+        n = 1;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &component, &n, OPAL_STRING))) {
+            ORTE_ERROR_LOG(rc);
+            opal_argv_free(wanted);
+            return;
+        }
+        opal_argv_append_nosize(&wanted, component);
+        free(component);
+    }
+
+    opal_output_verbose(5, orcm_sensor_base_framework.framework_output,
+                        "%s sensor:base: %s requested %d inventory components",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), ORTE_NAME_PRINT(sender), count);
+
+    ans = OBJ_NEW(opal_buffer_t);
+    if (ORCM_SUCCESS != orcm_sensor_base_inventory_pack(ans, wanted)) {
+        OBJ_RELEASE(ans);
+        opal_argv_free(wanted);
+        return;
+    }
+    opal_argv_free(wanted);
+    if (ORCM_SUCCESS != (rc = orte_rml.send_buffer_nb(sender, ans,
+                                                      ORCM_RML_TAG_INVENTORY,
+                                                      orte_rml_send_callback, NULL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(ans);
+    }
+}
+
+void orcm_sensor_base_inventory_stored(char *hostname, const char *component)
+{
+    opal_list_t *digests;
+    inventory_digest_t *dg;
+
+    if (!initialized) {
+        return;
+    }
+    opal_mutex_lock(&lock);
+    if (NULL != (digests = get_host(hostname, false)) &&
+        NULL != (dg = get_digest(digests, component)) && dg->have_pending) {
+        dg->stored = dg->pending;
+        dg->have_stored = true;
+        dg->have_pending = false;
+    }
+    opal_mutex_unlock(&lock);
+}
+
+static void inventory_write_cb(int dbhandle, int status, opal_list_t *kvs,
+                               opal_list_t *output, void *cbdata)
+{
+    inventory_write_t *wr = (inventory_write_t*)cbdata;
+
+    if (ORCM_SUCCESS == status) {
+        orcm_sensor_base_inventory_stored(wr->hostname, wr->component);
+    } else {
+        /* left pending - the host's next digest asks for it again */
+        opal_output_verbose(1, orcm_sensor_base_framework.framework_output,
+                            "%s sensor:base: storing %s inventory of %s failed: %d",
+                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), wr->component,
+                            wr->hostname, status);
+    }
+    OBJ_RELEASE(kvs);
+    OBJ_RELEASE(wr);
+}
+
+void orcm_sensor_base_inventory_store(char *hostname, const char *component,
+                                      opal_list_t *records)
+{
+    inventory_write_t *wr;
+
+    if (0 > orcm_sensor_base.dbhandle) {
+        OBJ_RELEASE(records);
+        return;
+    }
+    wr = OBJ_NEW(inventory_write_t);
+    wr->hostname = strdup(hostname);
+    wr->component = strdup(component);
+    orcm_db.store_new(orcm_sensor_base.dbhandle, ORCM_DB_INVENTORY_DATA, records, NULL,
+                      inventory_write_cb, wr);
+}
+
+void orcm_sensor_base_inventory_finalize(void)
+{
+    opal_list_t *digests;
+    void *key, *node, *next;
+    size_t keysize;
+    int rc;
+
+    if (!initialized) {
+        return;
+    }
+    OPAL_LIST_DESTRUCT(&parts);
+    rc = opal_hash_table_get_first_key_ptr(&hosts, &key, &keysize, (void**)&digests, &node);
+    while (OPAL_SUCCESS == rc) {
+        OPAL_LIST_RELEASE(digests);
+        rc = opal_hash_table_get_next_key_ptr(&hosts, &key, &keysize, (void**)&digests, node, &next);
+        node = next;
+    }
+    OBJ_DESTRUCT(&hosts);
+    OBJ_DESTRUCT(&lock);
+    initialized = false;
+}
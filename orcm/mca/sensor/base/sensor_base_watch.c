@@ -0,0 +1,427 @@
+/* -*- Mode: C; c-basic-offset:4 ; indent-tabs-mode:nil -*- */
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+#include <errno.h>
+#ifdef HAVE_SYS_INOTIFY_H
+#include <sys/inotify.h>
+#endif
+
+#include "opal/class/opal_list.h"
+#include "opal/mca/event/event.h"
+#include "opal/threads/mutex.h"
+#include "opal/util/basename.h"
+#include "opal/util/output.h"
+
+#include "orte/util/name_fns.h"
+#include "orte/runtime/orte_globals.h"
+
+#include "orcm/mca/sensor/base/base.h"
+#include "orcm/mca/sensor/base/sensor_private.h"
+
+#ifdef HAVE_SYS_INOTIFY_H
+
+/* Each event base gets one inotify descriptor, so a component's
+ * callbacks always run in the thread that drives its own events.
+ * A watched file is followed through its directory as well, so
+ * that a log which is rotated or recreated is picked up again.
+ */
+typedef struct {
+    opal_list_item_t super;
+    int id;
+    char *path;
+    char *dir;
+    char *name;
+    int events;
+    uint32_t mask;
+    int wd;
+    int dir_wd;
+    bool active;
+    orcm_sensor_base_watch_cbfunc_t cbfunc;
+    void *cbdata;
+} watch_t;
+static void wcon(watch_t *p)
+{
+    p->path = NULL;
+    p->dir = NULL;
+    p->name = NULL;
+    p->wd = -1;
+    p->dir_wd = -1;
+    p->active = true;
+}
+static void wdes(watch_t *p)
+{
+    if (NULL != p->path) {
+        free(p->path);
+    }
+    if (NULL != p->dir) {
+        free(p->dir);
+    }
+    if (NULL != p->name) {
+        free(p->name);
+    }
+}
+static OBJ_CLASS_INSTANCE(watch_t,
+                          opal_list_item_t,
+                          wcon, wdes);
+
+typedef struct {
+    opal_list_item_t super;
+    opal_event_base_t *ev_base;
+    int fd;
+    opal_event_t ev;
+    opal_list_t watches;
+} watcher_t;
+static void icon(watcher_t *p)
+{
+    p->ev_base = NULL;
+    p->fd = -1;
+    OBJ_CONSTRUCT(&p->watches, opal_list_t);
+}
+static void ides(watcher_t *p)
+{
+    if (0 <= p->fd) {
+        opal_event_del(&p->ev);
+        close(p->fd);
+    }
+    OPAL_LIST_DESTRUCT(&p->watches);
+}
+static OBJ_CLASS_INSTANCE(watcher_t,
+                          opal_list_item_t,
+                          icon, ides);
+
+/* a fired watch waiting for its callback */
+typedef struct {
+    opal_list_item_t super;
+    watch_t *watch;
+    int events;
+} fired_t;
+static void fcon(fired_t *p)
+{
+    p->watch = NULL;
+    p->events = 0;
+}
+static void fdes(fired_t *p)
+{
+    if (NULL != p->watch) {
+        OBJ_RELEASE(p->watch);
+    }
+}
+static OBJ_CLASS_INSTANCE(fired_t,
+                          opal_list_item_t,
+                          fcon, fdes);
+
+#define DIR_MASK (IN_CREATE | IN_MOVED_TO)
+#define GONE_MASK (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)
+
+static bool initialized = false;
+static opal_mutex_t lock;
+static opal_list_t watchers;
+static int next_id = 0;
+
+static void watch_handler(int fd, short args, void *cbdata);
+
+static void setup(void)
+{
+    if (initialized) {
+        return;
+    }
+    OBJ_CONSTRUCT(&lock, opal_mutex_t);
+    OBJ_CONSTRUCT(&watchers, opal_list_t);
+    initialized = true;
+}
+
+static uint32_t to_mask(int events)
+{
+    uint32_t mask = GONE_MASK;
+
+    if (events & ORCM_SENSOR_WATCH_MODIFY) {
+        mask |= IN_MODIFY;
+    }
+    if (events & ORCM_SENSOR_WATCH_ACCESS) {
+        mask |= IN_ACCESS;
+    }
+    if (events & ORCM_SENSOR_WATCH_ATTRIB) {
+        mask |= IN_ATTRIB;
+    }
+    return mask;
+}
+
+/* inotify hands back the same descriptor for the same inode, so
+ * watches on one directory share it - only drop it with the last */
+static bool wd_in_use(watcher_t *w, int wd)
+{
+    watch_t *wt;
+
+    OPAL_LIST_FOREACH(wt, &w->watches, watch_t) {
+        if (wt->wd == wd || wt->dir_wd == wd) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* the kernel keeps one mask per inode, so watches that share a
+ * descriptor add theirs to it - when one goes away, cut the mask
+ * back to what the ones left behind still ask for */
+static void drop_wd(watcher_t *w, int *wd)
+{
+    watch_t *wt, *left = NULL;
+    uint32_t mask = 0;
+    int old = *wd;
+
+    if (old < 0) {
+        return;
+    }
+    *wd = -1;
+    if (!wd_in_use(w, old)) {
+        inotify_rm_watch(w->fd, old);
+        return;
+    }
+    OPAL_LIST_FOREACH(wt, &w->watches, watch_t) {
+        if (wt->wd == old) {
+            mask |= wt->mask;
+            left = wt;
+        }
+        if (wt->dir_wd == old) {
+            mask |= DIR_MASK;
+        }
+    }
+    if (NULL != left) {
+        inotify_add_watch(w->fd, left->path, mask);
+    }
+}
+
+static watcher_t* get_watcher(opal_event_base_t *ev_base)
+{
+    watcher_t *w;
+
+    OPAL_LIST_FOREACH(w, &watchers, watcher_t) {
+        if (w->ev_base == ev_base) {
+            return w;
+        }
+    }
+    w = OBJ_NEW(watcher_t);
+    /* the handler drains the descriptor, so it must not block */
+    if (0 > (w->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC))) {
+        OBJ_RELEASE(w);
+        return NULL;
+    }
+    w->ev_base = ev_base;
+    opal_event_set(ev_base, &w->ev, w->fd,
+                   OPAL_EV_READ | OPAL_EV_PERSIST,
+                   watch_handler, w);
+    opal_event_add(&w->ev, 0);
+    opal_list_append(&watchers, &w->super);
+    return w;
+}
+
+static void watch_handler(int fd, short args, void *cbdata)
+{
+    watcher_t *w = (watcher_t*)cbdata;
+    char buf[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    struct inotify_event *ie;
+    watch_t *wt;
+    fired_t *f;
+    opal_list_t fired;
+    ssize_t len;
+    char *ptr;
+    int events;
+
+    OBJ_CONSTRUCT(&fired, opal_list_t);
+
+    opal_mutex_lock(&lock);
+    while (0 < (len = read(fd, buf, sizeof(buf)))) {
+        for (ptr = buf; ptr < buf + len; ptr += sizeof(struct inotify_event) + ie->len) {
+            ie = (struct inotify_event*)ptr;
+            OPAL_LIST_FOREACH(wt, &w->watches, watch_t) {
+                events = 0;
+                if (ie->wd == wt->wd) {
+                    if (ie->mask & IN_MODIFY) {
+                        events |= ORCM_SENSOR_WATCH_MODIFY;
+                    }
+                    if (ie->mask & IN_ACCESS) {
+                        events |= ORCM_SENSOR_WATCH_ACCESS;
+                    }
+                    if (ie->mask & IN_ATTRIB) {
+                        events |= ORCM_SENSOR_WATCH_ATTRIB;
+                    }
+                    if (ie->mask & GONE_MASK) {
+                        /* the kernel already forgot a deleted file - a
+                         * renamed one is still watched and must be let go */
+                        if (ie->mask & IN_IGNORED) {
+                            wt->wd = -1;
+                        } else {
+                            drop_wd(w, &wt->wd);
+                        }
+                        events |= ORCM_SENSOR_WATCH_GONE;
+                    }
+                } else if (ie->wd == wt->dir_wd && 0 < ie->len &&
+                           (ie->mask & DIR_MASK) &&
+                           0 == strcmp(ie->name, wt->name)) {
+                    if (0 <= wt->wd) {
+                        drop_wd(w, &wt->wd);
+                    }
+                    wt->wd = inotify_add_watch(fd, wt->path, wt->mask | IN_MASK_ADD);
+                    events |= ORCM_SENSOR_WATCH_CREATE;
+                } else if (ie->wd == wt->dir_wd && (ie->mask & IN_IGNORED)) {
+                    /* the directory itself went away */
+                    wt->dir_wd = -1;
+                }
+                if (0 == (events & (wt->events | ORCM_SENSOR_WATCH_CREATE | ORCM_SENSOR_WATCH_GONE)) ||
+                    !wt->active) {
+                    continue;
+                }
+                /* fold repeats of the same watch into one callback */
+                OPAL_LIST_FOREACH(f, &fired, fired_t) {
+                    if (f->watch == wt) {
+                        break;
+                    }
+                }
+                if (f == (fired_t*)opal_list_get_end(&fired)) {
+                    f = OBJ_NEW(fired_t);
+                    OBJ_RETAIN(wt);
+                    f->watch = wt;
+                    opal_list_append(&fired, &f->super);
+                }
+                f->events |= events;
+            }
+        }
+    }
+    opal_mutex_unlock(&lock);
+
+    /* run the callbacks without the lock so they
+     * are free to add or remove watches */
+    OPAL_LIST_FOREACH(f, &fired, fired_t) {
+        if (f->watch->active) {
+            f->watch->cbfunc(f->watch->path, f->events, f->watch->cbdata);
+        }
+    }
+    OPAL_LIST_DESTRUCT(&fired);
+}
+
+int orcm_sensor_base_watch_add(const char *path, int events,
+                               opal_event_base_t *ev_base,
+                               orcm_sensor_base_watch_cbfunc_t cbfunc,
+                               void *cbdata, int *id)
+{
+    watcher_t *w;
+    watch_t *wt;
+    int rc = ORCM_SUCCESS;
+
+    if (NULL == path || NULL == ev_base || NULL == cbfunc) {
+        return ORCM_ERR_BAD_PARAM;
+    }
+    setup();
+
+    opal_mutex_lock(&lock);
+    if (NULL == (w = get_watcher(ev_base))) {
+        rc = ORCM_ERR_NOT_SUPPORTED;
+        goto done;
+    }
+    wt = OBJ_NEW(watch_t);
+    wt->path = strdup(path);
+    wt->dir = opal_dirname(path);
+    wt->name = opal_basename(path);
+    wt->events = events;
+    wt->mask = to_mask(events);
+    wt->cbfunc = cbfunc;
+    wt->cbdata = cbdata;
+
+    /* the directory must be there even if the file is not yet */
+    if (0 > (wt->dir_wd = inotify_add_watch(w->fd, wt->dir, DIR_MASK | IN_MASK_ADD))) {
+        OBJ_RELEASE(wt);
+        rc = ORCM_ERR_NOT_FOUND;
+        goto done;
+    }
+    wt->wd = inotify_add_watch(w->fd, wt->path, wt->mask | IN_MASK_ADD);
+    wt->id = next_id++;
+    opal_list_append(&w->watches, &wt->super);
+    *id = wt->id;
+
+    opal_output_verbose(5, orcm_sensor_base_framework.framework_output,
+                        "%s sensor:base watching %s%s",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), path,
+                        (0 > wt->wd) ? " (not present yet)" : "");
+
+ done:
+    opal_mutex_unlock(&lock);
+    return rc;
+}
+
+void orcm_sensor_base_watch_remove(int id)
+{
+    watcher_t *w;
+    watch_t *wt;
+
+    if (!initialized || 0 > id) {
+        return;
+    }
+    opal_mutex_lock(&lock);
+    OPAL_LIST_FOREACH(w, &watchers, watcher_t) {
+        OPAL_LIST_FOREACH(wt, &w->watches, watch_t) {
+            if (wt->id != id) {
+                continue;
+            }
+            /* a callback may still be pending in the other thread */
+            wt->active = false;
+            opal_list_remove_item(&w->watches, &wt->super);
+            drop_wd(w, &wt->wd);
+            drop_wd(w, &wt->dir_wd);
+            OBJ_RELEASE(wt);
+            if (0 == opal_list_get_size(&w->watches)) {
+                opal_list_remove_item(&watchers, &w->super);
+                OBJ_RELEASE(w);
+            }
+            opal_mutex_unlock(&lock);
+            return;
+        }
+    }
+    opal_mutex_unlock(&lock);
+}
+
+void orcm_sensor_base_watch_finalize(void)
+{
+    if (!initialized) {
+        return;
+    }
+    OPAL_LIST_DESTRUCT(&watchers);
+    OBJ_DESTRUCT(&lock);
+    initialized = false;
+}
+
+#else
+
+int orcm_sensor_base_watch_add(const char *path, int events,
+                               opal_event_base_t *ev_base,
+                               orcm_sensor_base_watch_cbfunc_t cbfunc,
+                               void *cbdata, int *id)
+{
+    return ORCM_ERR_NOT_SUPPORTED;
+}
+
+void orcm_sensor_base_watch_remove(int id)
+{
+}
+
+void orcm_sensor_base_watch_finalize(void)
+{
+}
+
+#endif
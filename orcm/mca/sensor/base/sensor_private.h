@@ -78,6 +78,8 @@ typedef struct {
     bool collect_metrics;       /* Holds the user configured variable indicating whether sensor metric sampling is enabled or not */
     bool collect_inventory;     /* Holds the user configured variable indicating whether inventory collection is enabled or not */
     bool set_dynamic_inventory; /* Holds the user configured variable indicating whether dynamic inventory collection is enabled or not */
+    bool inventory_digest;      /* Send a digest of the inventory first and only the components the aggregator asks for */
+    int inventory_digest_interval; /* Seconds between digests, so parts the aggregator failed to store are sent again */
 } orcm_sensor_base_t;
 
 typedef struct {
@@ -93,6 +95,7 @@ typedef struct {
     opal_object_t super;
     opal_event_t ev;
     opal_buffer_t bucket;
+    bool flush;     /* send at once rather than with the next update */
 } orcm_sensor_xfer_t;
 OBJ_CLASS_DECLARATION(orcm_sensor_xfer_t);
 
@@ -110,10 +113,68 @@ OBJ_CLASS_DECLARATION(orcm_sensor_xfer_t);
         opal_event_active(&x->ev, OPAL_EV_WRITE, 1);            \
     }while(0);
 
+/* as ORCM_SENSOR_XFER, but for events that should not wait for
+ * the next scheduled update - the bucket is sent on right away */
+#define ORCM_SENSOR_XFER_NOW(b)                                 \
+    do {                                                        \
+        orcm_sensor_xfer_t *x;                                  \
+        x = OBJ_NEW(orcm_sensor_xfer_t);                        \
+        x->flush = true;                                        \
+        opal_dss.copy_payload(&x->bucket, (b));                 \
+        opal_event_set(orcm_sensor_base.ev_base, &x->ev, -1,    \
+                       OPAL_EV_WRITE,                           \
+                       orcm_sensor_base_collect, x);            \
+        opal_event_active(&x->ev, OPAL_EV_WRITE, 1);            \
+    }while(0);
+
+/****    FILE WATCHES    ****/
+/* Components that follow files register them here instead of
+ * polling them on every sample. The callback is run in the thread
+ * of the event base given when the watch was added, with the
+ * events that fired since it last ran. A file that does not exist
+ * yet, or that is removed and recreated, is picked up when it
+ * (re)appears - CREATE and GONE are always reported. The caller
+ * must keep cbdata valid until the watch is removed and its
+ * event base has stopped running.
+ */
+#define ORCM_SENSOR_WATCH_MODIFY    0x01    /* data written to the file */
+#define ORCM_SENSOR_WATCH_ACCESS    0x02    /* file read */
+#define ORCM_SENSOR_WATCH_ATTRIB    0x04    /* times or permissions changed */
+#define ORCM_SENSOR_WATCH_CREATE    0x08    /* file appeared */
+#define ORCM_SENSOR_WATCH_GONE      0x10    /* file removed or renamed away */
+
+typedef void (*orcm_sensor_base_watch_cbfunc_t)(const char *path, int events, void *cbdata);
+
+/****    INVENTORY SYNC    ****/
+/* A node hashes the inventory of each component and sends only
+ * the hashes. The aggregator remembers the hashes it has stored
+ * for every host and asks for the components whose hash differs,
+ * so a node that rejoins unchanged costs one small message and
+ * no database writes.
+ */
+ORCM_DECLSPEC void orcm_sensor_base_inventory_collect(void);
+/* pack our nodename followed by the collected inventory of the given
+ * components, or of all of them if components is NULL */
+ORCM_DECLSPEC int orcm_sensor_base_inventory_pack(opal_buffer_t *buf, char **components);
+ORCM_DECLSPEC int orcm_sensor_base_inventory_send_digest(orte_process_name_t *tgt);
+ORCM_DECLSPEC void orcm_sensor_base_inventory_recv_digest(int status, orte_process_name_t* sender,
+                                                          opal_buffer_t *buffer,
+                                                          orte_rml_tag_t tag, void *cbdata);
+ORCM_DECLSPEC void orcm_sensor_base_inventory_recv_request(int status, orte_process_name_t* sender,
+                                                           opal_buffer_t *buffer,
+                                                           orte_rml_tag_t tag, void *cbdata);
+/* the database has the inventory of this component of the host */
+ORCM_DECLSPEC void orcm_sensor_base_inventory_stored(char *hostname, const char *component);
+/* store the inventory records a component unpacked for a host - takes
+ * the records, and marks the component stored once the write succeeds */
+ORCM_DECLSPEC void orcm_sensor_base_inventory_store(char *hostname, const char *component,
+                                                    opal_list_t *records);
+ORCM_DECLSPEC void orcm_sensor_base_inventory_finalize(void);
+
 ORCM_DECLSPEC extern orcm_sensor_base_t orcm_sensor_base;
 ORCM_DECLSPEC void orcm_sensor_base_start(orte_jobid_t job);
 ORCM_DECLSPEC void orcm_sensor_base_stop(orte_jobid_t job);
-ORCM_DECLSPEC void orcm_sensor_base_log(char *comp, opal_buffer_t *data);
+ORCM_DECLSPEC void orcm_sensor_base_log(const char *comp, opal_buffer_t *data);
 /* manually sample one or more sensors */
 ORCM_DECLSPEC void orcm_sensor_base_manually_sample(char *sensors,
                                                     orcm_sensor_sample_cb_fn_t cbfunc,
@@ -121,6 +182,14 @@ ORCM_DECLSPEC void orcm_sensor_base_manually_sample(char *sensors,
 ORCM_DECLSPEC void orcm_sensor_base_collect(int fd, short args, void *cbdata);
 ORCM_DECLSPEC void orcm_sensor_base_set_sample_rate(int sample_rate);
 ORCM_DECLSPEC void orcm_sensor_base_get_sample_rate(int *sample_rate);
+/* returns ORCM_ERR_NOT_SUPPORTED where files cannot be watched, in
+ * which case the caller should fall back to sampling the file */
+ORCM_DECLSPEC int orcm_sensor_base_watch_add(const char *path, int events,
+                                             opal_event_base_t *ev_base,
+                                             orcm_sensor_base_watch_cbfunc_t cbfunc,
+                                             void *cbdata, int *id);
+ORCM_DECLSPEC void orcm_sensor_base_watch_remove(int id);
+ORCM_DECLSPEC void orcm_sensor_base_watch_finalize(void);
 
 END_C_DECLS
 #endif
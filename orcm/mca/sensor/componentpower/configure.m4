@@ -20,7 +20,9 @@ AC_DEFUN([MCA_orcm_sensor_componentpower_CONFIG], [
     # do not build if support not requested
     AS_IF([test "$with_componentpower" != "no"],
           [AS_IF([test "$opal_found_linux" = "yes"],
-                 [$1],
+                 [# perf power events are optional - powercap and msr need no headers
+                  AC_CHECK_HEADERS([linux/perf_event.h])
+                  $1],
                  [AC_MSG_WARN([only for Linux systems])
                   AC_MSG_ERROR([Cannot continue])
                   $2])
@@ -92,7 +92,6 @@ static orcm_sensor_sampler_t *componentpower_sampler = NULL;
 static orcm_sensor_componentpower_t orcm_sensor_componentpower;
 
 static void generate_test_vector(opal_buffer_t *v);
-static int load_msr_file_descriptors_for_each_socket(void);
 static void setup_cpu_information(void);
 static int read_register_value(int register_name, int socket, unsigned long long *msr);
 static int rapl_register_lock_check(void);
@@ -103,27 +102,30 @@ static int rapl_ddr_energy_register_check(void);
 
 static int init(void)
 {
-    if (ORCM_SUCCESS != geteuid()) {
-        opal_output(0, "ERROR: User has not rights to perform this operation");
-        return ORCM_ERR_PERM;
-    }
+    int rc;
 
     setup_cpu_information();
 
     detect_cpu_for_each_socket();
 
-    if (ORCM_SUCCESS != load_msr_file_descriptors_for_each_socket()) {
-        opal_output(0, "ERROR: opening msr file descriptors\n");
-        return ORCM_ERR_FILE_OPEN_FAILURE;
+    rc = orcm_sensor_componentpower_energy_open(&_rapl,
+                                                mca_sensor_componentpower_component.backend);
+    if (ORCM_SUCCESS != rc) {
+        opal_output(0, "ERROR: no access to the RAPL energy counters\n");
+        return (ORCM_ERR_BAD_PARAM == rc) ? rc : ORCM_ERR_FILE_OPEN_FAILURE;
     }
 
-    if (ORCM_SUCCESS != rapl_register_lock_check()) {
-        opal_output(0, "ERROR: RAPL is locked\n");
-        return ORCM_ERR_RESOURCE_BUSY;
-    }
+    if (ORCM_SENSOR_COMPONENTPOWER_BACKEND_MSR == _rapl.backend) {
+        if (ORCM_SUCCESS != rapl_register_lock_check()) {
+            opal_output(0, "ERROR: RAPL is locked\n");
+            orcm_sensor_componentpower_energy_close(&_rapl);
+            return ORCM_ERR_RESOURCE_BUSY;
+        }
 
-    if (ORCM_SUCCESS != energy_unit_check()) {
-        opal_output(0, "WARNING: energy unit check fails" );
+        if (ORCM_SUCCESS != energy_unit_check()) {
+            opal_output(0, "WARNING: energy unit check fails" );
+        }
+        _rapl.cpu_scale = _rapl.ddr_scale = (double)_rapl.rapl_esu;
     }
 
     gettimeofday(&(_tv.tv_curr), NULL);
@@ -135,6 +137,7 @@ static int init(void)
 
 static void finalize(void)
 {
+    orcm_sensor_componentpower_energy_close(&_rapl);
     return;
 }
 
@@ -277,33 +280,12 @@ static void setup_cpu_information(void)
     _rapl.n_sockets=n_sockets;
 }
 
-static int load_msr_file_descriptors_for_each_socket(void) {
-    int i;
-    char base_path[] = "/dev/cpu/%d/msr";
-    char path[STR_LEN];
-    for (i=0; i<_rapl.n_sockets; i++){
-        _rapl.cpu_rapl[i]=_rapl.cpu_rapl_prev[i]=0;
-        _rapl.ddr_rapl[i]=_rapl.ddr_rapl_prev[i]=0;
-        snprintf(path, sizeof(path), base_path, _rapl.cpu_idx[i]);
-        _rapl.fd_cpu[i]=open(path, O_RDWR);
-        if (_rapl.fd_cpu[i]<0){
-            _rapl.dev_msr_support=0;
-            _rapl.cpu_rapl_support=0;
-            _rapl.ddr_rapl_support=0;
-            return ORCM_ERR_FILE_OPEN_FAILURE;
-        }
-    }
-    return ORCM_SUCCESS;
-}
-
 static int read_register_value(int register_name, int socket,
     unsigned long long *msr)
 {
-    int ret;
-    int msr_size=sizeof(unsigned long long);
-    lseek(_rapl.fd_cpu[socket], register_name, 0);
-    ret=read(_rapl.fd_cpu[socket], msr, msr_size);
-    if (ret!=msr_size) {
+    ssize_t ret;
+    ret=pread(_rapl.fd_cpu[socket], msr, sizeof(unsigned long long), register_name);
+    if (ret!=(ssize_t)sizeof(unsigned long long)) {
         return ORCM_ERROR;
     }
     return ORCM_SUCCESS;
@@ -431,8 +413,8 @@ static int energy_unit_check(void)
 static void start(orte_jobid_t jobid)
 {
 
-    /* we must be root to run */
-    if (0 != geteuid()) {
+    /* nothing to sample without the energy counters */
+    if (ORCM_SENSOR_COMPONENTPOWER_BACKEND_NONE == _rapl.backend) {
         return;
     }
 
@@ -528,12 +510,6 @@ static void collect_sample(orcm_sensor_sampler_t *sampler)
 
     float power_cur;
     int i;
-    unsigned long long interval, msr, rapl_delta;
-
-     /* we must be root to run */
-    if (0 != geteuid()) {
-        return;
-    }
 
     if (mca_sensor_componentpower_component.test) {
         /* generate and send a test vector */
@@ -544,6 +520,13 @@ static void collect_sample(orcm_sensor_sampler_t *sampler)
         OBJ_DESTRUCT(&data);
         return;
     }
+
+    if (ORCM_SENSOR_COMPONENTPOWER_BACKEND_NONE == _rapl.backend) {
+        return;
+    }
+
+    /* read the counters first so the interval covers them */
+    ret = orcm_sensor_componentpower_energy_read(&_rapl);
     gettimeofday(&(_tv.tv_curr), NULL);
     if (_tv.tv_curr.tv_usec>=_tv.tv_prev.tv_usec){
         _tv.interval=(unsigned long long)(_tv.tv_curr.tv_sec-_tv.tv_prev.tv_sec)*1000000
@@ -556,64 +539,17 @@ static void collect_sample(orcm_sensor_sampler_t *sampler)
         opal_output(0, "WARNING: interval is zero\n");
         _tv.interval=1;
     }
-    interval=_tv.interval;
     _tv.tv_prev=_tv.tv_curr;
 
-    if (_rapl.cpu_rapl_support==0){
-        for (i=0; i<_rapl.n_sockets; i++){
-            _rapl.cpu_power[i]=-1.0;
-    }
+    if (ORCM_SUCCESS == ret) {
+        orcm_sensor_componentpower_energy_update(&_rapl, _tv.interval);
     } else {
-        _rapl.rapl_calls++;
-        for (i=0; i<_rapl.n_sockets; i++){
-            lseek(_rapl.fd_cpu[i], RAPL_CPU_ENERGY, 0);
-            read(_rapl.fd_cpu[i], &msr, sizeof(unsigned long long));
-            _rapl.cpu_rapl[i]=msr;
-
-            if (_rapl.cpu_rapl[i]>=_rapl.cpu_rapl_prev[i]){
-                rapl_delta=_rapl.cpu_rapl[i]-_rapl.cpu_rapl_prev[i];
-            } else {
-                rapl_delta=_rapl.cpu_rapl[i]+0x100000000-_rapl.cpu_rapl_prev[i];
-            }
-
-            if (rapl_delta==0){
-                _rapl.cpu_power[i]=-1.0;
-            } else {
-                _rapl.cpu_power[i]=((double)rapl_delta / (double)(_rapl.rapl_esu))/((double)interval/1000000.0);
-            }
-            if (_rapl.cpu_power[i]>1000.0){
-                _rapl.cpu_power[i]=-1.0;
-            }
-            _rapl.cpu_rapl_prev[i]=_rapl.cpu_rapl[i];
-        }
-    }
-
-    if (_rapl.ddr_rapl_support==0){
+        opal_output(0, "ERROR: reading energy counters through %s\n",
+                    orcm_sensor_componentpower_backend_name(_rapl.backend));
         for (i=0; i<_rapl.n_sockets; i++){
+            _rapl.cpu_power[i]=-1.0;
             _rapl.ddr_power[i]=-1.0;
         }
-    } else {
-        for (i=0; i<_rapl.n_sockets; i++){
-            lseek(_rapl.fd_cpu[i], RAPL_DDR_ENERGY, 0);
-            read(_rapl.fd_cpu[i], &msr, sizeof(unsigned long long));
-            _rapl.ddr_rapl[i]=msr;
-            if (_rapl.ddr_rapl[i]>=_rapl.ddr_rapl_prev[i]){
-                rapl_delta=_rapl.ddr_rapl[i]-_rapl.ddr_rapl_prev[i];
-            } else {
-                rapl_delta=_rapl.ddr_rapl[i]+0x100000000-_rapl.ddr_rapl_prev[i];
-            }
-
-            if (rapl_delta==0) {
-                _rapl.ddr_power[i]=-1.0;
-            } else {
-                _rapl.ddr_power[i]=((double)rapl_delta / (double)(_rapl.rapl_esu))/((double)interval/1000000.0);
-            }
-            if (_rapl.ddr_power[i]>1000.0) {
-                _rapl.ddr_power[i]=-1.0;
-            }
-            _rapl.ddr_rapl_prev[i]=_rapl.ddr_rapl[i];
-        }
-
     }
 
     /* prep to store the results */
@@ -638,7 +574,7 @@ static void collect_sample(orcm_sensor_sampler_t *sampler)
     }
 
     /* store the number of sockets */
-    nsockets = detect_num_sockets();
+    nsockets = _rapl.n_sockets;
 
     if (OPAL_SUCCESS != (ret = opal_dss.pack(&data, &nsockets, 1, OPAL_INT32))) {
 
@@ -685,10 +621,9 @@ static void collect_sample(orcm_sensor_sampler_t *sampler)
     }
 }
 
-static void componentpower_log_cleanup(char *hostname, opal_list_t *key,opal_list_t *non_compute_data,
+static void componentpower_log_cleanup(opal_list_t *key,opal_list_t *non_compute_data,
                                        orcm_analytics_value_t *analytics_vals)
 {
-    SAFEFREE(hostname);
     if ( NULL != key) {
         OBJ_RELEASE(key);
     }
@@ -705,7 +640,7 @@ static void componentpower_log_cleanup(char *hostname, opal_list_t *key,opal_lis
  */
 static void componentpower_log(opal_buffer_t *sample)
 {
-    char *hostname=NULL;
+    const char *hostname=NULL;
     char temp_str[64];
     int rc;
     int32_t n, nsockets;
@@ -722,10 +657,9 @@ static void componentpower_log(opal_buffer_t *sample)
 
 
     /* unpack the host this came from */
-    n=1;
-    if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &hostname, &n, OPAL_STRING))) {
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &hostname, NULL))) {
         ORTE_ERROR_LOG(rc);
-        componentpower_log_cleanup(hostname, key, non_compute_data, analytics_vals);
+        componentpower_log_cleanup(key, non_compute_data, analytics_vals);
         return;
     }
 
@@ -733,7 +667,7 @@ static void componentpower_log(opal_buffer_t *sample)
     n=1;
     if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &nsockets, &n, OPAL_INT32))) {
         ORTE_ERROR_LOG(rc);
-        componentpower_log_cleanup(hostname, key, non_compute_data, analytics_vals);
+        componentpower_log_cleanup(key, non_compute_data, analytics_vals);
         return;
     }
 
@@ -746,7 +680,7 @@ static void componentpower_log(opal_buffer_t *sample)
     n=1;
     if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &tv_curr, &n, OPAL_TIMEVAL))) {
         ORTE_ERROR_LOG(rc);
-        componentpower_log_cleanup(hostname, key, non_compute_data, analytics_vals);
+        componentpower_log_cleanup(key, non_compute_data, analytics_vals);
         return;
     }
 
@@ -758,7 +692,7 @@ static void componentpower_log(opal_buffer_t *sample)
     for (i=0; i<nsockets; i++){
         if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &power_cur, &n, OPAL_FLOAT))){
             ORTE_ERROR_LOG(rc);
-            componentpower_log_cleanup(hostname, key, non_compute_data, analytics_vals);
+            componentpower_log_cleanup(key, non_compute_data, analytics_vals);
             return;
         }
         cpu_power_temp[i]=power_cur;
@@ -769,7 +703,7 @@ static void componentpower_log(opal_buffer_t *sample)
     for (i=0; i<nsockets; i++){
         if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &power_cur, &n, OPAL_FLOAT))){
             ORTE_ERROR_LOG(rc);
-            componentpower_log_cleanup(hostname, key, non_compute_data, analytics_vals);
+            componentpower_log_cleanup(key, non_compute_data, analytics_vals);
             return;
         }
         ddr_power_temp[i]=power_cur;
@@ -777,13 +711,13 @@ static void componentpower_log(opal_buffer_t *sample)
 
     key = OBJ_NEW(opal_list_t);
     if (NULL == key) {
-        componentpower_log_cleanup(hostname, key, non_compute_data, analytics_vals);
+        componentpower_log_cleanup(key, non_compute_data, analytics_vals);
         return;
     }
 
     non_compute_data = OBJ_NEW(opal_list_t);
     if (NULL == non_compute_data) {
-        componentpower_log_cleanup(hostname, key, non_compute_data, analytics_vals);
+        componentpower_log_cleanup(key, non_compute_data, analytics_vals);
         return;
     }
 
@@ -791,7 +725,7 @@ static void componentpower_log(opal_buffer_t *sample)
     sensor_metric = orcm_util_load_orcm_value("ctime", &tv_curr, OPAL_TIMEVAL, NULL);
     if (NULL == sensor_metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-        componentpower_log_cleanup(hostname, key, non_compute_data, analytics_vals);
+        componentpower_log_cleanup(key, non_compute_data, analytics_vals);
         return;
     }
 
@@ -810,10 +744,10 @@ static void componentpower_log(opal_buffer_t *sample)
     opal_list_append(non_compute_data, (opal_list_item_t *)sensor_metric);
 
     /* load the hostname */
-    sensor_metric = orcm_util_load_orcm_value("hostname", hostname, OPAL_STRING, NULL);
+    sensor_metric = orcm_util_load_orcm_value("hostname", (void*)hostname, OPAL_STRING, NULL);
     if (NULL == sensor_metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-        componentpower_log_cleanup(hostname, key, non_compute_data, analytics_vals);
+        componentpower_log_cleanup(key, non_compute_data, analytics_vals);
         return;
     }
     opal_list_append(key, (opal_list_item_t *)sensor_metric);
@@ -821,7 +755,7 @@ static void componentpower_log(opal_buffer_t *sample)
     sensor_metric = orcm_util_load_orcm_value("data_group", "componentpower", OPAL_STRING, NULL);
     if (NULL == sensor_metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-        componentpower_log_cleanup(hostname, key, non_compute_data, analytics_vals);
+        componentpower_log_cleanup(key, non_compute_data, analytics_vals);
         return;
     }
     opal_list_append(key, (opal_list_item_t *)sensor_metric);
@@ -831,20 +765,20 @@ static void componentpower_log(opal_buffer_t *sample)
         if ((NULL == analytics_vals) || (NULL == analytics_vals->key) ||
              (NULL == analytics_vals->non_compute_data) ||(NULL == analytics_vals->compute_data)) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-            componentpower_log_cleanup(hostname, key, non_compute_data, analytics_vals);
+            componentpower_log_cleanup(key, non_compute_data, analytics_vals);
             return;
         }
 
         if (0 > snprintf(temp_str, sizeof(temp_str), "cpu%d_power", i)) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-            componentpower_log_cleanup(hostname, key, non_compute_data, analytics_vals);
+            componentpower_log_cleanup(key, non_compute_data, analytics_vals);
             return;
         }
 
         sensor_metric = orcm_util_load_orcm_value(temp_str, &cpu_power_temp[i], OPAL_FLOAT, "W");
         if (NULL == sensor_metric) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-            componentpower_log_cleanup(hostname, key, non_compute_data, analytics_vals);
+            componentpower_log_cleanup(key, non_compute_data, analytics_vals);
             return;
         }
         
@@ -868,19 +802,19 @@ static void componentpower_log(opal_buffer_t *sample)
         if ((NULL == analytics_vals) || (NULL == analytics_vals->key) ||
              (NULL == analytics_vals->non_compute_data) ||(NULL == analytics_vals->compute_data)) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-            componentpower_log_cleanup(hostname, key, non_compute_data, analytics_vals);
+            componentpower_log_cleanup(key, non_compute_data, analytics_vals);
             return;
         }
 
         if (0 > snprintf(temp_str, sizeof(temp_str), "ddr%d_power", i)) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-            componentpower_log_cleanup(hostname, key, non_compute_data, analytics_vals);
+            componentpower_log_cleanup(key, non_compute_data, analytics_vals);
             return;
         }
         sensor_metric = orcm_util_load_orcm_value(temp_str, &ddr_power_temp[i], OPAL_FLOAT, "W");
         if (NULL == sensor_metric) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-            componentpower_log_cleanup(hostname, key, non_compute_data, analytics_vals);
+            componentpower_log_cleanup(key, non_compute_data, analytics_vals);
             return;
         }
         
@@ -902,7 +836,7 @@ static void componentpower_log(opal_buffer_t *sample)
     }
     /* Don't release analytics_vals. It's retain(ed) and being used in the workflows at this point
      * This doesn't cause any memory leak*/
-    componentpower_log_cleanup(hostname, key, non_compute_data, NULL);
+    componentpower_log_cleanup(key, non_compute_data, NULL);
 
 }
 
@@ -1120,11 +1054,6 @@ static void componentpower_inventory_collect(opal_buffer_t *inventory_snapshot)
     }
 }
 
-static void my_inventory_log_cleanup(int dbhandle, int status, opal_list_t *kvs, opal_list_t *output, void *cbdata)
-{
-    OBJ_RELEASE(kvs);
-}
-
 static void componentpower_inventory_log(char *hostname, opal_buffer_t *inventory_snapshot)
 {
     unsigned int tot_items = 0;
@@ -1163,9 +1092,5 @@ static void componentpower_inventory_log(char *hostname, opal_buffer_t *inventor
 
         --tot_items;
     }
-    if (0 <= orcm_sensor_base.dbhandle) {
-        orcm_db.store_new(orcm_sensor_base.dbhandle, ORCM_DB_INVENTORY_DATA, records, NULL, my_inventory_log_cleanup, NULL);
-    } else {
-        my_inventory_log_cleanup(-1, -1, records, NULL, NULL);
-    }
+    orcm_sensor_base_inventory_store(hostname, "componentpower", records);
 }
@@ -23,6 +23,7 @@ typedef struct {
     bool test;
     bool use_progress_thread;
     int sample_rate;
+    char *backend;
 } orcm_sensor_componentpower_component_t;
 
 ORCM_MODULE_DECLSPEC extern orcm_sensor_componentpower_component_t mca_sensor_componentpower_component;
@@ -56,11 +57,27 @@ typedef struct _freq_data {
 #define MAX_SOCKETS 256
 #define STR_LEN 128
 
+/* where the energy counters are read from */
+typedef enum {
+    ORCM_SENSOR_COMPONENTPOWER_BACKEND_NONE = 0,
+    ORCM_SENSOR_COMPONENTPOWER_BACKEND_MSR,
+    ORCM_SENSOR_COMPONENTPOWER_BACKEND_POWERCAP,
+    ORCM_SENSOR_COMPONENTPOWER_BACKEND_PERF
+} orcm_sensor_componentpower_backend_t;
+
 typedef struct{
+    orcm_sensor_componentpower_backend_t backend;
     int n_cpus;
     int n_sockets;
     int cpu_idx[MAX_SOCKETS];
     int fd_cpu[MAX_SOCKETS];
+    int fd_ddr[MAX_SOCKETS];
+    /* counter wrap modulus per socket - zero for 64-bit counters */
+    unsigned long long cpu_range[MAX_SOCKETS];
+    unsigned long long ddr_range[MAX_SOCKETS];
+    /* counter units per joule */
+    double cpu_scale;
+    double ddr_scale;
     unsigned long long rapl_esu;
     int dev_msr_support;
     int cpu_rapl_support;
@@ -79,6 +96,13 @@ typedef struct{
     unsigned long long interval;
 }__time_val;
 
+/* energy counter access, shared by all backends */
+int orcm_sensor_componentpower_energy_open(__rapl *r, const char *backend);
+int orcm_sensor_componentpower_energy_read(__rapl *r);
+void orcm_sensor_componentpower_energy_update(__rapl *r, unsigned long long interval_us);
+void orcm_sensor_componentpower_energy_close(__rapl *r);
+const char* orcm_sensor_componentpower_backend_name(orcm_sensor_componentpower_backend_t backend);
+
 typedef struct {
     opal_event_base_t *ev_base;
     bool ev_active;
@@ -103,6 +103,14 @@ static int componentpower_component_register(void)
                                            OPAL_INFO_LVL_9,
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_sensor_componentpower_component.sample_rate);
-  
+
+    mca_sensor_componentpower_component.backend = "auto";
+    (void) mca_base_component_var_register(c, "backend",
+                                           "Where to read the RAPL energy counters from: perf, powercap, msr, or auto to take the first that works in that order [default: auto]",
+                                           MCA_BASE_VAR_TYPE_STRING, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_sensor_componentpower_component.backend);
+
     return ORCM_SUCCESS;
 }
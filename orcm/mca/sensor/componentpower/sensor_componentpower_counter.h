@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/**
+ * @file
+ *
+ * Energy counter arithmetic of the componentpower sensor
+ *
+ * Kept apart from the backends so it can be checked without the
+ * counters themselves.
+ */
+#ifndef ORCM_SENSOR_COMPONENTPOWER_COUNTER_H
+#define ORCM_SENSOR_COMPONENTPOWER_COUNTER_H
+
+/* anything above this is a counter glitch, not a reading */
+#define ORCM_SENSOR_COMPONENTPOWER_MAX_SANE_POWER  1000.0
+
+/* counts between two readings of a counter that wraps at range */
+static inline unsigned long long
+orcm_sensor_componentpower_energy_delta(unsigned long long cur,
+                                        unsigned long long prev,
+                                        unsigned long long range)
+{
+    if (cur >= prev) {
+        return cur - prev;
+    }
+    /* a zero range is a full 64-bit counter, which unsigned
+     * arithmetic wraps for us */
+    return cur + range - prev;
+}
+
+/* watts from a count delta over interval_us, or -1 if there is no
+ * reading to give */
+static inline double
+orcm_sensor_componentpower_energy_to_power(unsigned long long delta,
+                                           double units_per_joule,
+                                           unsigned long long interval_us)
+{
+    double power;
+
+    if (0 == delta || 0 == interval_us || 0.0 >= units_per_joule) {
+        return -1.0;
+    }
+    power = ((double)delta / units_per_joule) / ((double)interval_us / 1000000.0);
+    if (power > ORCM_SENSOR_COMPONENTPOWER_MAX_SANE_POWER) {
+        return -1.0;
+    }
+    return power;
+}
+
+#endif
@@ -0,0 +1,478 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#include <errno.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif  /* HAVE_UNISTD_H */
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif  /* HAVE_STRING_H */
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef HAVE_DIRENT_H
+#include <dirent.h>
+#endif  /* HAVE_DIRENT_H */
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef HAVE_LINUX_PERF_EVENT_H
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#include "opal/util/output.h"
+
+#include "orcm/mca/sensor/base/base.h"
+#include "sensor_componentpower.h"
+#include "sensor_componentpower_counter.h"
+
+#define POWERCAP_PATH   "/sys/class/powercap"
+#define POWERCAP_PREFIX "intel-rapl:"
+#define PERF_POWER_PATH "/sys/bus/event_source/devices/power"
+
+static void reset_sockets(__rapl *r)
+{
+    int i;
+
+    for (i = 0; i < MAX_SOCKETS; i++) {
+        r->fd_cpu[i] = -1;
+        r->fd_ddr[i] = -1;
+        r->cpu_range[i] = 0;
+        r->ddr_range[i] = 0;
+        r->cpu_rapl[i] = r->cpu_rapl_prev[i] = 0;
+        r->ddr_rapl[i] = r->ddr_rapl_prev[i] = 0;
+    }
+}
+
+/* read a single unsigned value from a sysfs attribute */
+static int read_attr_ull(int fd, unsigned long long *value)
+{
+    char buf[32];
+    ssize_t n;
+
+    n = pread(fd, buf, sizeof(buf) - 1, 0);
+    if (n <= 0) {
+        return ORCM_ERR_FILE_READ_FAILURE;
+    }
+    buf[n] = '\0';
+    *value = strtoull(buf, NULL, 10);
+    return ORCM_SUCCESS;
+}
+
+static int read_file(const char *path, char *buf, size_t len)
+{
+    ssize_t n;
+    int fd;
+
+    if (0 > (fd = open(path, O_RDONLY))) {
+        return ORCM_ERR_FILE_OPEN_FAILURE;
+    }
+    n = read(fd, buf, len - 1);
+    close(fd);
+    if (n <= 0) {
+        return ORCM_ERR_FILE_READ_FAILURE;
+    }
+    buf[n] = '\0';
+    /* sysfs values end in a newline */
+    if ('\n' == buf[n - 1]) {
+        buf[n - 1] = '\0';
+    }
+    return ORCM_SUCCESS;
+}
+
+/*
+ * powercap backend - every package zone "intel-rapl:N" carries its
+ * energy in microjoules, with the dram domain as one of its subzones
+ */
+static int open_zone(const char *zone, int *fd, unsigned long long *range)
+{
+    char path[PATH_MAX], buf[32];
+
+    snprintf(path, sizeof(path), "%s/%s/max_energy_range_uj", POWERCAP_PATH, zone);
+    if (ORCM_SUCCESS != read_file(path, buf, sizeof(buf))) {
+        return ORCM_ERR_FILE_READ_FAILURE;
+    }
+    /* the counter rolls over after reaching the range */
+    *range = strtoull(buf, NULL, 10) + 1;
+
+    snprintf(path, sizeof(path), "%s/%s/energy_uj", POWERCAP_PATH, zone);
+    if (0 > (*fd = open(path, O_RDONLY))) {
+        return ORCM_ERR_FILE_OPEN_FAILURE;
+    }
+    return ORCM_SUCCESS;
+}
+
+static int open_powercap(__rapl *r)
+{
+    DIR *dir;
+    struct dirent *ent;
+    char path[PATH_MAX], name[STR_LEN];
+    int socket, npkg = 0;
+
+    if (NULL == (dir = opendir(POWERCAP_PATH))) {
+        return ORCM_ERR_NOT_FOUND;
+    }
+    while (NULL != (ent = readdir(dir))) {
+        if (0 != strncmp(ent->d_name, POWERCAP_PREFIX, strlen(POWERCAP_PREFIX))) {
+            continue;
+        }
+        /* the socket comes from the zone name, not the directory,
+         * as the kernel may number the zones differently */
+        snprintf(path, sizeof(path), "%s/%s/name", POWERCAP_PATH, ent->d_name);
+        if (ORCM_SUCCESS != read_file(path, name, sizeof(name))) {
+            continue;
+        }
+        if (NULL != strchr(ent->d_name + strlen(POWERCAP_PREFIX), ':')) {
+            /* subzone - only dram is of interest, and it
+             * belongs to the package in the zone prefix */
+            if (0 != strcmp(name, "dram")) {
+                continue;
+            }
+            socket = strtol(ent->d_name + strlen(POWERCAP_PREFIX), NULL, 10);
+            snprintf(path, sizeof(path), "%s/%s%d/name",
+                     POWERCAP_PATH, POWERCAP_PREFIX, socket);
+            if (ORCM_SUCCESS != read_file(path, name, sizeof(name)) ||
+                0 != strncmp(name, "package-", strlen("package-"))) {
+                continue;
+            }
+            socket = strtol(name + strlen("package-"), NULL, 10);
+            if (0 > socket || socket >= r->n_sockets || 0 <= r->fd_ddr[socket]) {
+                continue;
+            }
+            open_zone(ent->d_name, &r->fd_ddr[socket], &r->ddr_range[socket]);
+        } else {
+            if (0 != strncmp(name, "package-", strlen("package-"))) {
+                continue;
+            }
+            socket = strtol(name + strlen("package-"), NULL, 10);
+            if (0 > socket || socket >= r->n_sockets || 0 <= r->fd_cpu[socket]) {
+                continue;
+            }
+            if (ORCM_SUCCESS == open_zone(ent->d_name, &r->fd_cpu[socket],
+                                          &r->cpu_range[socket])) {
+                npkg++;
+            }
+        }
+    }
+    closedir(dir);
+
+    if (npkg < r->n_sockets) {
+        return ORCM_ERR_NOT_FOUND;
+    }
+    r->cpu_scale = r->ddr_scale = 1000000.0;
+    r->cpu_rapl_support = 1;
+    r->ddr_rapl_support = 1;
+    for (socket = 0; socket < r->n_sockets; socket++) {
+        if (0 > r->fd_ddr[socket]) {
+            r->ddr_rapl_support = 0;
+        }
+    }
+    return ORCM_SUCCESS;
+}
+
+static int read_powercap(__rapl *r)
+{
+    int i;
+
+    for (i = 0; i < r->n_sockets; i++) {
+        if (ORCM_SUCCESS != read_attr_ull(r->fd_cpu[i], &r->cpu_rapl[i])) {
+            return ORCM_ERR_FILE_READ_FAILURE;
+        }
+        if (r->ddr_rapl_support &&
+            ORCM_SUCCESS != read_attr_ull(r->fd_ddr[i], &r->ddr_rapl[i])) {
+            return ORCM_ERR_FILE_READ_FAILURE;
+        }
+    }
+    return ORCM_SUCCESS;
+}
+
+#ifdef HAVE_LINUX_PERF_EVENT_H
+/*
+ * perf backend - the package and dram energy events of each socket
+ * are opened as one group, so a single read returns both. The kernel
+ * accumulates them into 64-bit counts, so they never wrap for us
+ */
+static int perf_event(const char *event, unsigned long long *config, double *scale)
+{
+    char path[PATH_MAX], buf[64];
+    char *p;
+
+    snprintf(path, sizeof(path), "%s/events/%s", PERF_POWER_PATH, event);
+    if (ORCM_SUCCESS != read_file(path, buf, sizeof(buf)) ||
+        NULL == (p = strstr(buf, "event="))) {
+        return ORCM_ERR_NOT_FOUND;
+    }
+    *config = strtoull(p + strlen("event="), NULL, 0);
+
+    /* the scale is in joules per count */
+    snprintf(path, sizeof(path), "%s/events/%s.scale", PERF_POWER_PATH, event);
+    if (ORCM_SUCCESS != read_file(path, buf, sizeof(buf)) ||
+        0.0 >= (*scale = strtod(buf, NULL))) {
+        return ORCM_ERR_NOT_FOUND;
+    }
+    *scale = 1.0 / *scale;
+    return ORCM_SUCCESS;
+}
+
+static int perf_open(int type, unsigned long long config, int cpu, int group_fd)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(__NR_perf_event_open, &attr, -1, cpu, group_fd, 0);
+}
+
+static int open_perf(__rapl *r)
+{
+    char path[PATH_MAX], buf[32];
+    unsigned long long pkg_config, ram_config;
+    int type, i;
+
+    snprintf(path, sizeof(path), "%s/type", PERF_POWER_PATH);
+    if (ORCM_SUCCESS != read_file(path, buf, sizeof(buf))) {
+        return ORCM_ERR_NOT_FOUND;
+    }
+    type = strtol(buf, NULL, 10);
+    if (ORCM_SUCCESS != perf_event("energy-pkg", &pkg_config, &r->cpu_scale)) {
+        return ORCM_ERR_NOT_FOUND;
+    }
+    r->ddr_rapl_support =
+        (ORCM_SUCCESS == perf_event("energy-ram", &ram_config, &r->ddr_scale));
+
+    for (i = 0; i < r->n_sockets; i++) {
+        if (0 > (r->fd_cpu[i] = perf_open(type, pkg_config, r->cpu_idx[i], -1))) {
+            return ORCM_ERR_PERM;
+        }
+        if (r->ddr_rapl_support &&
+            0 > (r->fd_ddr[i] = perf_open(type, ram_config, r->cpu_idx[i], r->fd_cpu[i]))) {
+            return ORCM_ERR_PERM;
+        }
+    }
+    r->cpu_rapl_support = 1;
+    return ORCM_SUCCESS;
+}
+
+static int read_perf(__rapl *r)
+{
+    /* nr followed by one value per event in the group */
+    uint64_t values[3];
+    ssize_t want;
+    int i;
+
+    want = (r->ddr_rapl_support ? 3 : 2) * sizeof(uint64_t);
+    for (i = 0; i < r->n_sockets; i++) {
+        if (want != read(r->fd_cpu[i], values, want)) {
+            return ORCM_ERR_FILE_READ_FAILURE;
+        }
+        r->cpu_rapl[i] = values[1];
+        if (r->ddr_rapl_support) {
+            r->ddr_rapl[i] = values[2];
+        }
+    }
+    return ORCM_SUCCESS;
+}
+#endif
+
+/*
+ * msr backend - both energy registers of a socket live in the
+ * same device file, so they share its descriptor
+ */
+static int open_msr(__rapl *r)
+{
+    char path[STR_LEN];
+    int i;
+
+    /* the register checks narrow these down afterwards */
+    r->dev_msr_support = 1;
+    r->cpu_rapl_support = 1;
+    r->ddr_rapl_support = 1;
+    for (i = 0; i < r->n_sockets; i++) {
+        snprintf(path, sizeof(path), "/dev/cpu/%d/msr", r->cpu_idx[i]);
+        if (0 > (r->fd_cpu[i] = open(path, O_RDWR))) {
+            r->dev_msr_support = 0;
+            r->cpu_rapl_support = 0;
+            r->ddr_rapl_support = 0;
+            return ORCM_ERR_FILE_OPEN_FAILURE;
+        }
+        /* the energy status registers are 32 bits wide */
+        r->cpu_range[i] = r->ddr_range[i] = 0x100000000ULL;
+    }
+    return ORCM_SUCCESS;
+}
+
+static int read_msr(__rapl *r)
+{
+    int i;
+
+    for (i = 0; i < r->n_sockets; i++) {
+        if (r->cpu_rapl_support &&
+            sizeof(r->cpu_rapl[i]) != pread(r->fd_cpu[i], &r->cpu_rapl[i],
+                                             sizeof(r->cpu_rapl[i]), RAPL_CPU_ENERGY)) {
+            return ORCM_ERR_FILE_READ_FAILURE;
+        }
+        if (r->ddr_rapl_support &&
+            sizeof(r->ddr_rapl[i]) != pread(r->fd_cpu[i], &r->ddr_rapl[i],
+                                             sizeof(r->ddr_rapl[i]), RAPL_DDR_ENERGY)) {
+            return ORCM_ERR_FILE_READ_FAILURE;
+        }
+    }
+    return ORCM_SUCCESS;
+}
+
+static int open_backend(__rapl *r, orcm_sensor_componentpower_backend_t backend)
+{
+    int rc;
+
+    reset_sockets(r);
+    switch (backend) {
+    case ORCM_SENSOR_COMPONENTPOWER_BACKEND_MSR:
+        rc = open_msr(r);
+        break;
+    case ORCM_SENSOR_COMPONENTPOWER_BACKEND_POWERCAP:
+        rc = open_powercap(r);
+        break;
+#ifdef HAVE_LINUX_PERF_EVENT_H
+    case ORCM_SENSOR_COMPONENTPOWER_BACKEND_PERF:
+        rc = open_perf(r);
+        break;
+#endif
+    default:
+        rc = ORCM_ERR_NOT_SUPPORTED;
+        break;
+    }
+    if (ORCM_SUCCESS == rc) {
+        r->backend = backend;
+    } else {
+        orcm_sensor_componentpower_energy_close(r);
+    }
+    return rc;
+}
+
+int orcm_sensor_componentpower_energy_open(__rapl *r, const char *backend)
+{
+    /* cheapest first - one read per socket beats one per zone */
+    static const orcm_sensor_componentpower_backend_t order[] = {
+        ORCM_SENSOR_COMPONENTPOWER_BACKEND_PERF,
+        ORCM_SENSOR_COMPONENTPOWER_BACKEND_POWERCAP,
+        ORCM_SENSOR_COMPONENTPOWER_BACKEND_MSR
+    };
+    size_t i;
+
+    /* close() must not find stale descriptors, whatever happens below */
+    reset_sockets(r);
+    r->backend = ORCM_SENSOR_COMPONENTPOWER_BACKEND_NONE;
+    if (NULL == backend || 0 == strcmp(backend, "auto")) {
+        for (i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+            if (ORCM_SUCCESS == open_backend(r, order[i])) {
+                break;
+            }
+        }
+    } else if (0 == strcmp(backend, "perf")) {
+        open_backend(r, ORCM_SENSOR_COMPONENTPOWER_BACKEND_PERF);
+    } else if (0 == strcmp(backend, "powercap")) {
+        open_backend(r, ORCM_SENSOR_COMPONENTPOWER_BACKEND_POWERCAP);
+    } else if (0 == strcmp(backend, "msr")) {
+        open_backend(r, ORCM_SENSOR_COMPONENTPOWER_BACKEND_MSR);
+    } else {
+        opal_output(0, "ERROR: unknown componentpower backend %s\n", backend);
+        return ORCM_ERR_BAD_PARAM;
+    }
+    if (ORCM_SENSOR_COMPONENTPOWER_BACKEND_NONE == r->backend) {
+        return ORCM_ERR_FILE_OPEN_FAILURE;
+    }
+    opal_output_verbose(2, orcm_sensor_base_framework.framework_output,
+                        "sensor componentpower: reading energy through %s",
+                        orcm_sensor_componentpower_backend_name(r->backend));
+    return ORCM_SUCCESS;
+}
+
+int orcm_sensor_componentpower_energy_read(__rapl *r)
+{
+    switch (r->backend) {
+    case ORCM_SENSOR_COMPONENTPOWER_BACKEND_MSR:
+        return read_msr(r);
+    case ORCM_SENSOR_COMPONENTPOWER_BACKEND_POWERCAP:
+        return read_powercap(r);
+#ifdef HAVE_LINUX_PERF_EVENT_H
+    case ORCM_SENSOR_COMPONENTPOWER_BACKEND_PERF:
+        return read_perf(r);
+#endif
+    default:
+        return ORCM_ERR_NOT_SUPPORTED;
+    }
+}
+
+void orcm_sensor_componentpower_energy_update(__rapl *r, unsigned long long interval_us)
+{
+    unsigned long long delta;
+    int i;
+
+    r->rapl_calls++;
+    for (i = 0; i < r->n_sockets; i++) {
+        if (r->cpu_rapl_support) {
+            delta = orcm_sensor_componentpower_energy_delta(r->cpu_rapl[i], r->cpu_rapl_prev[i],
+                                                            r->cpu_range[i]);
+            r->cpu_power[i] = orcm_sensor_componentpower_energy_to_power(delta, r->cpu_scale,
+                                                                         interval_us);
+            r->cpu_rapl_prev[i] = r->cpu_rapl[i];
+        } else {
+            r->cpu_power[i] = -1.0;
+        }
+        if (r->ddr_rapl_support) {
+            delta = orcm_sensor_componentpower_energy_delta(r->ddr_rapl[i], r->ddr_rapl_prev[i],
+                                                            r->ddr_range[i]);
+            r->ddr_power[i] = orcm_sensor_componentpower_energy_to_power(delta, r->ddr_scale,
+                                                                         interval_us);
+            r->ddr_rapl_prev[i] = r->ddr_rapl[i];
+        } else {
+            r->ddr_power[i] = -1.0;
+        }
+    }
+}
+
+void orcm_sensor_componentpower_energy_close(__rapl *r)
+{
+    int i;
+
+    for (i = 0; i < MAX_SOCKETS; i++) {
+        /* perf group members must go before their leader */
+        if (0 <= r->fd_ddr[i]) {
+            close(r->fd_ddr[i]);
+            r->fd_ddr[i] = -1;
+        }
+        if (0 <= r->fd_cpu[i]) {
+            close(r->fd_cpu[i]);
+            r->fd_cpu[i] = -1;
+        }
+    }
+    r->backend = ORCM_SENSOR_COMPONENTPOWER_BACKEND_NONE;
+}
+
+const char* orcm_sensor_componentpower_backend_name(orcm_sensor_componentpower_backend_t backend)
+{
+    switch (backend) {
+    case ORCM_SENSOR_COMPONENTPOWER_BACKEND_MSR:
+        return "msr";
+    case ORCM_SENSOR_COMPONENTPOWER_BACKEND_POWERCAP:
+        return "powercap";
+    case ORCM_SENSOR_COMPONENTPOWER_BACKEND_PERF:
+        return "perf";
+    default:
+        return "none";
+    }
+}
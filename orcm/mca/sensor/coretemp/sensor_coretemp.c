@@ -44,6 +44,7 @@
 
 #include "orcm/mca/db/db.h"
 #include "orcm/util/utils.h"
+#include "orcm/util/value_batch.h"
 #include "orcm/runtime/orcm_globals.h"
 
 #include "orcm/mca/analytics/analytics.h"
@@ -287,7 +288,7 @@ done:
     return ret;
 }
 
-static int coretemp_policy_filter(char *hostname, int core_no, float ct, time_t ts)
+static int coretemp_policy_filter(const char *hostname, int core_no, float ct, time_t ts)
 {
     orcm_sensor_policy_t *plc;
     coretemp_history_t *hst, *newhst;
@@ -877,11 +878,13 @@ static void collect_sample(orcm_sensor_sampler_t *sampler)
     OBJ_DESTRUCT(&data);
 }
 
-static void coretemp_log_cleanup(char *core_label, char *hostname, opal_list_t *key,
-                                 opal_list_t *non_compute_data, orcm_analytics_value_t *analytics_vals)
+static void coretemp_log_cleanup(orcm_value_batch_t *batch, opal_list_t *key,
+                                 opal_list_t *non_compute_data,
+                                 orcm_analytics_value_t *analytics_vals)
 {
-    SAFEFREE(core_label);
-    SAFEFREE(hostname);
+    if ( NULL != batch) {
+        OBJ_RELEASE(batch);
+    }
     if ( NULL != key) {
         OBJ_RELEASE(key);
     }
@@ -895,7 +898,7 @@ static void coretemp_log_cleanup(char *core_label, char *hostname, opal_list_t *
 
 static void coretemp_log(opal_buffer_t *sample)
 {
-    char *hostname=NULL;
+    const char *hostname=NULL;
     struct timeval sampletime;
     int rc;
     int32_t n, ncores;
@@ -904,12 +907,13 @@ static void coretemp_log(opal_buffer_t *sample)
     opal_list_t *non_compute_data = NULL;
     float fval;
     int i;
-    char *core_label = NULL;
+    const char *core_label = NULL;
     orcm_value_t *sensor_metric = NULL;
+    orcm_value_batch_t *batch = NULL;
+    opal_list_t *compute_data = NULL;
 
     /* unpack the host this came from */
-    n=1;
-    if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &hostname, &n, OPAL_STRING))) {
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &hostname, NULL))) {
         ORTE_ERROR_LOG(rc);
         return;
     }
@@ -917,7 +921,7 @@ static void coretemp_log(opal_buffer_t *sample)
     n=1;
     if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &ncores, &n, OPAL_INT32))) {
         ORTE_ERROR_LOG(rc);
-        coretemp_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+        coretemp_log_cleanup(batch, key, non_compute_data, analytics_vals);
         return;
     }
 
@@ -925,7 +929,7 @@ static void coretemp_log(opal_buffer_t *sample)
     n=1;
     if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &sampletime, &n, OPAL_TIMEVAL))) {
         ORTE_ERROR_LOG(rc);
-        coretemp_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+        coretemp_log_cleanup(batch, key, non_compute_data, analytics_vals);
         return;
     }
 
@@ -934,22 +938,30 @@ static void coretemp_log(opal_buffer_t *sample)
                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
                         (NULL == hostname) ? "NULL" : hostname, ncores);
 
-    key = OBJ_NEW(opal_list_t);
+    /* all the values of this sample share one batch, released
+     * once the last workflow step is done with them */
+    batch = OBJ_NEW(orcm_value_batch_t);
+    if (NULL == batch) {
+        ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
+        return;
+    }
+
+    key = orcm_value_batch_new_list(batch);
     if (NULL == key) {
-        coretemp_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+        coretemp_log_cleanup(batch, key, non_compute_data, analytics_vals);
         return;
     }
 
-    non_compute_data = OBJ_NEW(opal_list_t);
+    non_compute_data = orcm_value_batch_new_list(batch);
     if (NULL == non_compute_data) {
-        coretemp_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+        coretemp_log_cleanup(batch, key, non_compute_data, analytics_vals);
         return;
     }
 
-    sensor_metric = orcm_util_load_orcm_value("ctime", &sampletime, OPAL_TIMEVAL, NULL);
+    sensor_metric = orcm_value_batch_load(batch, "ctime", &sampletime, OPAL_TIMEVAL, NULL);
     if (NULL == sensor_metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-        coretemp_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+        coretemp_log_cleanup(batch, key, non_compute_data, analytics_vals);
         return;
     }
     opal_list_append(non_compute_data, (opal_list_item_t *)sensor_metric);
@@ -957,56 +969,61 @@ static void coretemp_log(opal_buffer_t *sample)
     /* load the hostname */
     if (NULL == hostname) {
         ORTE_ERROR_LOG(OPAL_ERR_BAD_PARAM);
-        coretemp_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+        coretemp_log_cleanup(batch, key, non_compute_data, analytics_vals);
         return;
     }
-    sensor_metric = orcm_util_load_orcm_value("hostname", hostname, OPAL_STRING, NULL);
+    sensor_metric = orcm_value_batch_load(batch, "hostname", (void*)hostname, OPAL_STRING, NULL);
     if (NULL == sensor_metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-        coretemp_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+        coretemp_log_cleanup(batch, key, non_compute_data, analytics_vals);
         return;
     }
     opal_list_append(key, (opal_list_item_t *)sensor_metric);
 
-    sensor_metric = orcm_util_load_orcm_value("data_group", "coretemp", OPAL_STRING, NULL);
+    sensor_metric = orcm_value_batch_load(batch, "data_group", "coretemp", OPAL_STRING, NULL);
     if (NULL == sensor_metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-        coretemp_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+        coretemp_log_cleanup(batch, key, non_compute_data, analytics_vals);
         return;
     }
     opal_list_append(key, (opal_list_item_t *)sensor_metric);
 
     for (i=0; i < ncores; i++) {
         /* xfr to storage */
-        analytics_vals = orcm_util_load_orcm_analytics_value(key, non_compute_data, NULL);
+        compute_data = orcm_value_batch_new_list(batch);
+        if (NULL == compute_data) {
+            ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
+            coretemp_log_cleanup(batch, key, non_compute_data, analytics_vals);
+            return;
+        }
+        analytics_vals = orcm_util_load_orcm_analytics_value(key, non_compute_data, compute_data);
+        OBJ_RELEASE(compute_data);
         if ((NULL == analytics_vals) || (NULL == analytics_vals->key) ||
              (NULL == analytics_vals->non_compute_data) ||(NULL == analytics_vals->compute_data)) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-            coretemp_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+            coretemp_log_cleanup(batch, key, non_compute_data, analytics_vals);
             return;
         }
 
-        n=1;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &core_label, &n, OPAL_STRING))) {
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &core_label, NULL))) {
             ORTE_ERROR_LOG(rc);
-            coretemp_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+            coretemp_log_cleanup(batch, key, non_compute_data, analytics_vals);
             return;
         }
 
         n=1;
         if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &fval, &n, OPAL_FLOAT))) {
             ORTE_ERROR_LOG(rc);
-            coretemp_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+            coretemp_log_cleanup(batch, key, non_compute_data, analytics_vals);
             return;
         }
 
-        sensor_metric = orcm_util_load_orcm_value(core_label, &fval, OPAL_FLOAT, "degrees C");
+        sensor_metric = orcm_value_batch_load(batch, core_label, &fval, OPAL_FLOAT, "degrees C");
         if (NULL == sensor_metric) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-            coretemp_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+            coretemp_log_cleanup(batch, key, non_compute_data, analytics_vals);
             return;
         }
-        SAFEFREE(core_label);
         /* check coretemp event policy */
         coretemp_policy_filter(hostname, i, fval, sampletime.tv_sec);
 
@@ -1018,7 +1035,7 @@ static void coretemp_log(opal_buffer_t *sample)
     }
     /* Don't release analytics_vals. It's retain(ed) and being used in the workflows at this point
      * This doesn't cause any memory leak*/
-    coretemp_log_cleanup(core_label, hostname, key, non_compute_data, NULL);
+    coretemp_log_cleanup(batch, key, non_compute_data, NULL);
 }
 
 static void coretemp_set_sample_rate(int sample_rate)
@@ -1222,11 +1239,6 @@ static void coretemp_inventory_collect(opal_buffer_t *inventory_snapshot)
     }
 }
 
-static void my_inventory_log_cleanup(int dbhandle, int status, opal_list_t *kvs, opal_list_t *output, void *cbdata)
-{
-    OBJ_RELEASE(kvs);
-}
-
 static void coretemp_inventory_log(char *hostname, opal_buffer_t *inventory_snapshot)
 {
     unsigned int tot_items = 0;
@@ -1265,9 +1277,5 @@ static void coretemp_inventory_log(char *hostname, opal_buffer_t *inventory_snap
 
         --tot_items;
     }
-    if (0 <= orcm_sensor_base.dbhandle) {
-        orcm_db.store_new(orcm_sensor_base.dbhandle, ORCM_DB_INVENTORY_DATA, records, NULL, my_inventory_log_cleanup, NULL);
-    } else {
-        my_inventory_log_cleanup(-1, -1, records, NULL, NULL);
-    }
+    orcm_sensor_base_inventory_store(hostname, "coretemp", records);
 }
@@ -643,6 +643,12 @@ static void dmidata_inventory_log(char *hostname, opal_buffer_t *inventory_snaps
 
             opal_output_verbose(5, orcm_sensor_base_framework.framework_output,
                 "Compared values match for : hwloc; Do nothing");
+            if (orcm_sensor_base.inventory_digest) {
+                /* the host only sends it again when our last write
+                 * of it has not been seen to succeed */
+                OBJ_RETAIN(newhost->records);
+                orcm_sensor_base_inventory_store(hostname, "dmidata", newhost->records);
+            }
             return;
         } else {
             opal_output_verbose(5, orcm_sensor_base_framework.framework_output,
@@ -683,11 +689,10 @@ static void dmidata_inventory_log(char *hostname, opal_buffer_t *inventory_snaps
     extract_pci_inventory(topo, hostname, newhost);
     extract_memory_inventory(topo, hostname, newhost);
 
-    /* Send the collected inventory details to the database for storage */
-    if (0 <= orcm_sensor_base.dbhandle) {
-        orcm_db.store_new(orcm_sensor_base.dbhandle, ORCM_DB_INVENTORY_DATA,
-                          newhost->records, NULL, NULL, NULL);
-    }
+    /* Send the collected inventory details to the database for storage -
+     * the host list keeps its own reference */
+    OBJ_RETAIN(newhost->records);
+    orcm_sensor_base_inventory_store(hostname, "dmidata", newhost->records);
 }
 
 static void generate_test_vector(opal_buffer_t *v)
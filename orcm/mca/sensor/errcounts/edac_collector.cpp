@@ -11,6 +11,8 @@
 
 extern "C" {
     #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
     #include <stdio.h>
     #include <stdlib.h>
     #include <errno.h>
@@ -24,7 +26,7 @@ extern "C" {
 using namespace std;
 
 edac_collector::edac_collector(edac_error_callback_fn_t error_cb, const char* edac_path) :
-    error_callback(error_cb), user_data_(0)
+    error_callback(error_cb), user_data_(0), topology_known_(false)
 {
     if(NULL != edac_path) {
         base_edac_path = string(edac_path);
@@ -35,37 +37,35 @@ edac_collector::edac_collector(edac_error_callback_fn_t error_cb, const char* ed
 
 edac_collector::~edac_collector()
 {
+    close_topology();
 }
 
-bool edac_collector::collect_data(edac_data_callback_fn_t cb, void* user_data)
+bool edac_collector::collect_data(edac_data_callback_fn_t cb, void* user_data, bool changed_only)
 {
     if(NULL == cb) {
         return false;
     }
     user_data_ = (unsigned long long)user_data;
-    int mc_count = get_mc_folder_count();
-    for(int mc = 0; mc < mc_count; ++mc) {
-        int csrow_count = get_csrow_folder_count(mc);
-        for(int csrow = 0; csrow < csrow_count; ++csrow) {
-            int ce_count = get_ce_count(mc, csrow);
-            int ue_count = get_ue_count(mc, csrow);
-            if(-1 == ce_count || -1 == ue_count) {
+    if(false == topology_known_) {
+        discover_topology();
+    }
+    for(vector<edac_csrow>::iterator row = topology_.begin(); row != topology_.end(); ++row) {
+        int ce_count = read_counter(row->ce);
+        int ue_count = read_counter(row->ue);
+        if(-1 == ce_count || -1 == ue_count) {
+            continue;
+        }
+        report_counter(row->ce, ce_count, changed_only, cb);
+        report_counter(row->ue, ue_count, changed_only, cb);
+
+        for(size_t channel = 0; channel < row->channels.size(); ++channel) {
+            edac_counter& ch = row->channels[channel];
+            if(ch.name.empty() && false == label_channel(*row, (int)channel, ch)) {
                 continue;
             }
-            stringstream ss;
-            ss << "CPU_SrcID#" << mc << "_Sum_DIMM#" << csrow << "_CE";
-            log_data(ss.str().c_str(), ce_count, cb);
-            ss.str("");
-            ss << "CPU_SrcID#" << mc << "_Sum_DIMM#" << csrow << "_UE";
-            log_data(ss.str().c_str(), ue_count, cb);
-
-            int channel_count = get_channel_folder_count(mc, csrow);
-            for(int channel = 0; channel < channel_count; ++channel) {
-                string label = get_channel_label(mc, csrow, channel) + "_CE";
-                ce_count = get_channel_ce_count(mc, csrow, channel);
-                if("" != label && -1 != ce_count) {
-                    log_data(label.c_str(), ce_count, cb);
-                }
+            int count = read_counter(ch);
+            if(-1 != count) {
+                report_counter(ch, count, changed_only, cb);
             }
         }
     }
@@ -124,6 +124,102 @@ bool edac_collector::have_edac() const
     return false;
 }
 
+void edac_collector::discover_topology()
+{
+    close_topology();
+    int mc_count = get_mc_folder_count();
+    for(int mc = 0; mc < mc_count; ++mc) {
+        int csrow_count = get_csrow_folder_count(mc);
+        for(int csrow = 0; csrow < csrow_count; ++csrow) {
+            edac_csrow row;
+            stringstream ss;
+            row.mc = mc;
+            row.csrow = csrow;
+            ss << "CPU_SrcID#" << mc << "_Sum_DIMM#" << csrow << "_CE";
+            make_counter(row.ce, ss.str(), get_xx_path(mc, csrow, "ce_count"));
+            ss.str("");
+            ss << "CPU_SrcID#" << mc << "_Sum_DIMM#" << csrow << "_UE";
+            make_counter(row.ue, ss.str(), get_xx_path(mc, csrow, "ue_count"));
+
+            int channel_count = get_channel_folder_count(mc, csrow);
+            row.channels.resize(channel_count);
+            for(int channel = 0; channel < channel_count; ++channel) {
+                make_counter(row.channels[channel], "", "");
+                label_channel(row, channel, row.channels[channel]);
+            }
+            topology_.push_back(row);
+        }
+    }
+    topology_known_ = true;
+}
+
+void edac_collector::close_topology()
+{
+    for(vector<edac_csrow>::iterator row = topology_.begin(); row != topology_.end(); ++row) {
+        if(-1 != row->ce.fd) {
+            close(row->ce.fd);
+        }
+        if(-1 != row->ue.fd) {
+            close(row->ue.fd);
+        }
+        for(vector<edac_counter>::iterator ch = row->channels.begin(); ch != row->channels.end(); ++ch) {
+            if(-1 != ch->fd) {
+                close(ch->fd);
+            }
+        }
+    }
+    topology_.clear();
+    topology_known_ = false;
+}
+
+void edac_collector::make_counter(edac_counter& counter, const std::string& name, const std::string& path)
+{
+    counter.name = name;
+    counter.path = path;
+    counter.fd = -1;
+    counter.last_count = -1;
+}
+
+bool edac_collector::label_channel(const edac_csrow& row, int channel, edac_counter& counter)
+{
+    // The DIMM labels may be written after we start, so an empty one is read again next sample.
+    string label = get_channel_label(row.mc, row.csrow, channel);
+    if("" == label) {
+        return false;
+    }
+    stringstream ss;
+    ss << "ch" << channel << "_ce_count";
+    make_counter(counter, label + "_CE", get_xx_path(row.mc, row.csrow, ss.str().c_str()));
+    return true;
+}
+
+int edac_collector::read_counter(edac_counter& counter)
+{
+    // Descriptors are opened on first use and kept; a failed open is retried next sample.
+    if(-1 == counter.fd) {
+        counter.fd = open(counter.path.c_str(), O_RDONLY);
+        if(-1 == counter.fd) {
+            report_error(counter.path.c_str(), errno);
+            return -1;
+        }
+    }
+    int count = read_count(counter.path, counter.fd);
+    if(-1 == count) {
+        close(counter.fd);
+        counter.fd = -1;
+    }
+    return count;
+}
+
+void edac_collector::report_counter(edac_counter& counter, int count, bool changed_only,
+                                    edac_data_callback_fn_t cb)
+{
+    if(false == changed_only || count != counter.last_count) {
+        log_data(counter.name.c_str(), count, cb);
+    }
+    counter.last_count = count;
+}
+
 int edac_collector::get_mc_folder_count() const
 {
     int count = 0;
@@ -192,25 +288,35 @@ void edac_collector::report_error(const char* pathname, int error_number) const
     }
 }
 
-int edac_collector::get_xx_count(int mc, int csrow, const char* filename) const
+std::string edac_collector::get_xx_path(int mc, int csrow, const char* filename) const
 {
     stringstream ss;
     ss << base_edac_path << "/mc" << mc << "/csrow" << csrow << "/" << filename;
-    FILE* fd = fopen(ss.str().c_str(), "r");
-    if(NULL == fd) {
-        report_error(ss.str().c_str(), errno);
+    return ss.str();
+}
+
+int edac_collector::read_count(const std::string& path, int fd) const
+{
+    char buffer[32];
+    ssize_t n = pread(fd, buffer, sizeof(buffer) - 1, 0);
+    if(-1 == n) {
+        report_error(path.c_str(), errno);
         return -1;
     }
-    char* buffer = NULL;
-    size_t buffer_size = 0;
-    if(-1 == getline(&buffer, &buffer_size, fd)) {
-        report_error(ss.str().c_str(), errno);
-        fclose(fd);
+    buffer[n] = '\0';
+    return atoi(buffer);
+}
+
+int edac_collector::get_xx_count(int mc, int csrow, const char* filename) const
+{
+    string path = get_xx_path(mc, csrow, filename);
+    int fd = open(path.c_str(), O_RDONLY);
+    if(-1 == fd) {
+        report_error(path.c_str(), errno);
         return -1;
     }
-    fclose(fd);
-    int count = atoi(buffer);
-    free(buffer);
+    int count = read_count(path, fd);
+    close(fd);
     return count;
 }
 
@@ -235,15 +341,16 @@ std::string edac_collector::get_channel_label(int mc, int csrow, int channel) co
 {
     stringstream ss;
     ss << base_edac_path << "/mc" << mc << "/csrow" << csrow << "/ch" << channel << "_dimm_label";
-    FILE* fd = fopen(ss.str().c_str(), "r");
+    string path = ss.str();
+    FILE* fd = fopen(path.c_str(), "r");
     if(NULL == fd) {
-        report_error(ss.str().c_str(), errno);
+        report_error(path.c_str(), errno);
         return string();
     }
     char* buffer = NULL;
     size_t buffer_size = 0;
     if(-1 == getline(&buffer, &buffer_size, fd)) {
-        report_error(ss.str().c_str(), errno);
+        report_error(path.c_str(), errno);
         fclose(fd);
         return string();
     }
@@ -31,6 +31,7 @@ extern "C" {
 #endif
 
 #include <string>
+#include <vector>
 
 class edac_collector
 {
@@ -38,17 +39,43 @@ class edac_collector
         edac_collector(edac_error_callback_fn_t error_cb = NULL, const char* edac_path = NULL);
         ~edac_collector();
 
-        bool collect_data(edac_data_callback_fn_t cb, void* user_data);
+        bool collect_data(edac_data_callback_fn_t cb, void* user_data, bool changed_only = false);
         bool collect_inventory(edac_inventory_callback_fn_t cb, void* user_data);
 
         bool have_edac() const;
 
     PRIVATE:
+        // One sysfs counter file kept open between samples
+        struct edac_counter {
+            std::string name;
+            std::string path;
+            int fd;
+            int last_count;
+        };
+
+        // The counters of one csrow, a channel per index; a channel without a
+        // label (an empty name) is not sampled until its label shows up
+        struct edac_csrow {
+            int mc;
+            int csrow;
+            edac_counter ce;
+            edac_counter ue;
+            std::vector<edac_counter> channels;
+        };
+
+        void discover_topology();
+        void close_topology();
+        void make_counter(edac_counter& counter, const std::string& name, const std::string& path);
+        bool label_channel(const edac_csrow& row, int channel, edac_counter& counter);
+        int read_counter(edac_counter& counter);
+        void report_counter(edac_counter& counter, int count, bool changed_only, edac_data_callback_fn_t cb);
 
         int get_mc_folder_count() const;
         int get_csrow_folder_count(int mc) const;
         int get_channel_folder_count(int mc, int csrow) const;
 
+        std::string get_xx_path(int mc, int csrow, const char* filename) const;
+        int read_count(const std::string& path, int fd) const;
         int get_xx_count(int mc, int csrow, const char* filename) const;
         int get_ue_count(int mc, int csrow) const;
         int get_ce_count(int mc, int csrow) const;
@@ -66,6 +93,8 @@ class edac_collector
         std::string base_edac_path;
         edac_error_callback_fn_t error_callback;
         unsigned long long user_data_;
+        std::vector<edac_csrow> topology_;
+        bool topology_known_;
 };
 
 #endif /* __cplusplus */
@@ -262,11 +262,6 @@ void errcounts_impl::inventory_collect(opal_buffer_t* inventory_snapshot)
     }
 }
 
-void errcounts_impl::my_inventory_log_cleanup(int dbhandle, int status, opal_list_t *kvs, opal_list_t *output, void *cbdata)
-{
-    SAFE_OBJ_RELEASE(kvs);
-}
-
 void errcounts_impl::inventory_log(char* hostname, opal_buffer_t* inventory_snapshot)
 {
     if(true == edac_missing_) {
@@ -301,11 +296,7 @@ void errcounts_impl::inventory_log(char* hostname, opal_buffer_t* inventory_snap
         }
         ON_NULL_BREAK(failed);
 
-        if (0 <= orcm_sensor_base.dbhandle) {
-            orcm_db.store_new(orcm_sensor_base.dbhandle, ORCM_DB_INVENTORY_DATA, records, NULL, my_inventory_log_cleanup, NULL);
-        } else {
-            my_inventory_log_cleanup(-1, -1, records, NULL, NULL);
-        }
+        orcm_sensor_base_inventory_store(hostname, plugin_name_.c_str(), records);
         records = NULL;
         break; // execute while() only once...
     }
@@ -443,7 +434,7 @@ void errcounts_impl::collect_sample(bool perthread /* = false*/)
     }
     data_samples_labels_.clear();
     data_samples_values_.clear();
-    collector_->collect_data(data_callback_relay, this);
+    collector_->collect_data(data_callback_relay, this, mca_sensor_errcounts_component.changed_only);
 
     opal_buffer_t buffer;
     OBJ_CONSTRUCT(&buffer, opal_buffer_t);
@@ -599,27 +590,19 @@ bool errcounts_impl::pack_inv_sample(opal_buffer_t* buffer)
 
 bool errcounts_impl::unpack_string(opal_buffer_t* buffer, std::string& str) const
 {
-    bool rv = true;
-    int32_t n = 1;
-    char* str_ptr = NULL;
+    const char* str_ptr = NULL;
+    int32_t len = 0;
     int rc;
-    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &str_ptr, &n, OPAL_STRING))) {
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(buffer, &str_ptr, &len))) {
         ORTE_ERROR_LOG(rc);
-        SAFE_FREE(str_ptr);
         return false;
     }
-    if(1 == n && NULL != str_ptr) {
-        str = str_ptr;
-        SAFE_FREE(str_ptr);
-    } else {
-        for(int32_t i = 0; i < n; ++i) {
-            SAFE_FREE(str_ptr);
-        }
+    if (NULL == str_ptr) {
         ORTE_ERROR_LOG(ORCM_ERR_UNPACK_FAILURE);
-        rv = false;
+        return false;
     }
-    SAFE_FREE(str_ptr);
-    return rv;
+    str.assign(str_ptr, len);
+    return true;
 }
 
 bool errcounts_impl::unpack_int32(opal_buffer_t* buffer, int32_t& value) const
@@ -55,7 +55,6 @@ class errcounts_impl
         static void data_callback_relay(const char* label, int error_count, void* user_data);
         static void inventory_callback_relay(const char* label, const char* name, void* user_data);
         static void perthread_errcounts_sample_relay(int fd, short args, void *cbdata);
-        static void my_inventory_log_cleanup(int dbhandle, int status, opal_list_t *kvs, opal_list_t *output, void *cbdata);
 
     PRIVATE: // In-Object Callback Methods
         void error_callback(const char* pathname, int error_number);
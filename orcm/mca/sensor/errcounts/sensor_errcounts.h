@@ -27,6 +27,7 @@ typedef struct {
     bool use_progress_thread;
     int sample_rate;
     char* edac_mc_folder;
+    bool changed_only;
 } orcm_sensor_errcounts_component_t;
 
 typedef struct {
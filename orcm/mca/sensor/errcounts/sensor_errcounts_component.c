@@ -104,5 +104,13 @@ int errcounts_component_register(void)
                                            MCA_BASE_VAR_SCOPE_READONLY,
                                            &mca_sensor_errcounts_component.edac_mc_folder);
 
+    mca_sensor_errcounts_component.changed_only = true;
+    (void) mca_base_component_var_register(c, "changed_only",
+                                           "Only report error counters that changed since the previous sample [default: true]",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_sensor_errcounts_component.changed_only);
+
     return ORCM_SUCCESS;
 }
@@ -91,6 +91,8 @@ typedef struct {
     time_t last_access;
     time_t last_mod;
     int limit;
+    int watch;      /* file watch, or -1 if the file is polled */
+    bool changed;   /* watch saw a change since the last tick */
 } file_tracker_t;
 static void ft_constructor(file_tracker_t *ft)
 {
@@ -100,9 +102,12 @@ static void ft_constructor(file_tracker_t *ft)
     ft->last_access = 0;
     ft->last_mod = 0;
     ft->limit = 0;
+    ft->watch = -1;
+    ft->changed = false;
 }
 static void ft_destructor(file_tracker_t *ft)
 {
+    orcm_sensor_base_watch_remove(ft->watch);
     if (NULL != ft->file) {
         free(ft->file);
     }
@@ -134,6 +139,73 @@ static void finalize(void)
     return;
 }
 
+/* compare a fresh stat with what was last seen, in the order the
+ * checks were requested - the first unchanged one is a stall */
+static bool file_changed(file_tracker_t *ft, struct stat *buf)
+{
+    if (ft->check_size) {
+        if (buf->st_size == ft->file_size) {
+            return false;
+        }
+        ft->file_size = buf->st_size;
+    }
+    if (ft->check_access) {
+        if (buf->st_atime == ft->last_access) {
+            return false;
+        }
+        ft->last_access = buf->st_atime;
+    }
+    if (ft->check_mod) {
+        if (buf->st_mtime == ft->last_mod) {
+            return false;
+        }
+        ft->last_mod = buf->st_mtime;
+    }
+    return true;
+}
+
+/* runs in the thread that samples the trackers, so the
+ * tick is only ever touched from one place */
+static void file_event(const char *path, int events, void *cbdata)
+{
+    file_tracker_t *ft = (file_tracker_t*)cbdata;
+    struct stat buf;
+
+    if (0 > stat(ft->file, &buf)) {
+        return;
+    }
+    if (file_changed(ft, &buf)) {
+        ft->changed = true;
+    }
+}
+
+static void watch_file(file_tracker_t *ft, opal_event_base_t *ev_base)
+{
+    struct stat buf;
+    int events = 0;
+
+    if (ft->check_size) {
+        events |= ORCM_SENSOR_WATCH_MODIFY;
+    }
+    if (ft->check_access) {
+        events |= ORCM_SENSOR_WATCH_ACCESS;
+    }
+    if (ft->check_mod) {
+        events |= ORCM_SENSOR_WATCH_MODIFY | ORCM_SENSOR_WATCH_ATTRIB;
+    }
+    if (ORCM_SUCCESS != orcm_sensor_base_watch_add(ft->file, events, ev_base,
+                                                   file_event, ft, &ft->watch)) {
+        /* sample it the old way */
+        ft->watch = -1;
+        return;
+    }
+    /* take the starting point the first sample would have */
+    if (0 == stat(ft->file, &buf)) {
+        file_changed(ft, &buf);
+        ft->changed = true;
+    }
+}
+
 static bool find_value(orte_app_context_t *app,
                        char *pattern, char **value)
 {
@@ -283,6 +355,9 @@ static void start(orte_jobid_t jobid)
         opal_event_evtimer_set(orcm_sensor_file.ev_base, &file_sampler->ev,
                                perthread_file_sample, file_sampler);
         opal_event_evtimer_add(&file_sampler->ev, &file_sampler->rate);
+        watch_file(ft, orcm_sensor_file.ev_base);
+    } else {
+        watch_file(ft, orcm_sensor_base.ev_base);
     }
     return;
 }
@@ -298,6 +373,13 @@ static void stop(orte_jobid_t jobid)
         return;
     }
 
+    /* stop the thread first - its watches point at the trackers */
+    if (orcm_sensor_file.ev_active) {
+        orcm_sensor_file.ev_active = false;
+        /* stop the thread without releasing the event base */
+        opal_progress_thread_pause("file");
+    }
+
     for (item = opal_list_get_first(&jobs);
         ((item != opal_list_get_end(&jobs)) && (NULL != item));
         item = opal_list_get_next(item)) {
@@ -307,12 +389,6 @@ static void stop(orte_jobid_t jobid)
             OBJ_RELEASE(item);
         }
     }
-
-    if (orcm_sensor_file.ev_active) {
-        orcm_sensor_file.ev_active = false;
-        /* stop the thread without releasing the event base */
-        opal_progress_thread_pause("file");
-    }
     return;
 }
 
@@ -365,6 +441,16 @@ static void collect_sample(orcm_sensor_sampler_t *sampler)
         ((item != opal_list_get_end(&jobs)) && (NULL != item));
         item = opal_list_get_next(item)) {
         ft = (file_tracker_t*)item;
+        if (0 <= ft->watch) {
+            /* the watch already looked at any change */
+            if (ft->changed) {
+                ft->tick = 0;
+                ft->changed = false;
+            } else {
+                ft->tick++;
+            }
+            goto CHECK;
+        }
         /* stat the file and get its size */
         if (0 > stat(ft->file, &buf)) {
             /* cannot stat file */
@@ -380,32 +466,10 @@ static void collect_sample(orcm_sensor_sampler_t *sampler)
                              ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
                              (unsigned long)buf.st_size, ctime(&buf.st_atime), ctime(&buf.st_mtime)));
 
-        if (ft->check_size) {
-            if (buf.st_size == ft->file_size) {
-                ft->tick++;
-                goto CHECK;
-            } else {
-                ft->tick = 0;
-                ft->file_size = buf.st_size;
-            }
-        }
-        if (ft->check_access) {
-            if (buf.st_atime == ft->last_access) {
-                ft->tick++;
-                goto CHECK;
-            } else {
-                ft->tick = 0;
-                ft->last_access = buf.st_atime;
-            }
-        }
-        if (ft->check_mod) {
-            if (buf.st_mtime == ft->last_mod) {
-                ft->tick++;
-                goto CHECK;
-            } else {
-                ft->tick = 0;
-                ft->last_mod = buf.st_mtime;
-            }
+        if (file_changed(ft, &buf)) {
+            ft->tick = 0;
+        } else {
+            ft->tick++;
         }
 
     CHECK:
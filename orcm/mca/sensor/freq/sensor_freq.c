@@ -45,6 +45,7 @@
 #include "orcm/mca/db/db.h"
 #include "orcm/runtime/orcm_globals.h"
 #include "orcm/util/utils.h"
+#include "orcm/util/value_batch.h"
 
 #include "orcm/mca/analytics/analytics.h"
 
@@ -304,7 +305,7 @@ done:
     return ret;
 }
 
-static int corefreq_policy_filter(char *hostname, int core_no, float cf, time_t ts)
+static int corefreq_policy_filter(const char *hostname, int core_no, float cf, time_t ts)
 {
     orcm_sensor_policy_t *plc;
     corefreq_history_t *hst, *newhst;
@@ -913,11 +914,12 @@ cleanup:
     OBJ_DESTRUCT(&data);
 }
 
-static void freq_log_cleanup(char *label, char *hostname, opal_list_t *key,
+static void freq_log_cleanup(orcm_value_batch_t *batch, opal_list_t *key,
                              opal_list_t *non_compute_data, orcm_analytics_value_t *analytics_vals)
 {
-    SAFEFREE(label);
-    SAFEFREE(hostname);
+    if ( NULL != batch) {
+        OBJ_RELEASE(batch);
+    }
     if ( NULL != key) {
         OBJ_RELEASE(key);
     }
@@ -931,7 +933,7 @@ static void freq_log_cleanup(char *label, char *hostname, opal_list_t *key,
 
 static void freq_log(opal_buffer_t *sample)
 {
-    char *hostname=NULL;
+    const char *hostname=NULL;
     struct timeval sampletime;
     int rc;
     int32_t n, ncores;
@@ -943,14 +945,15 @@ static void freq_log(opal_buffer_t *sample)
     float fval;
     int i;
     unsigned int pstate_count = 0, pstate_value = 0;
-    char *pstate_name = NULL;
-    char *core_label = NULL;
+    const char *pstate_name = NULL;
+    char core_label[32];
+    orcm_value_batch_t *batch = NULL;
+    opal_list_t *compute_data = NULL;
     orcm_value_t *sensor_metric = NULL;
     bool pstate_flag;
 
     /* unpack the host this came from */
-    n=1;
-    if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &hostname, &n, OPAL_STRING))) {
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &hostname, NULL))) {
         ORTE_ERROR_LOG(rc);
         return;
     }
@@ -965,7 +968,7 @@ static void freq_log(opal_buffer_t *sample)
     n=1;
     if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &sampletime, &n, OPAL_TIMEVAL))) {
         ORTE_ERROR_LOG(rc);
-        freq_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+        freq_log_cleanup(batch, key, non_compute_data, analytics_vals);
         return;
     }
 
@@ -974,25 +977,33 @@ static void freq_log(opal_buffer_t *sample)
                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
                         (NULL == hostname) ? "NULL" : hostname, ncores);
 
+    /* all the values of this sample share one batch, released
+     * once the last workflow step is done with them */
+    batch = OBJ_NEW(orcm_value_batch_t);
+    if (NULL == batch) {
+        ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
+        return;
+    }
+
     /* xfr to storage */
-    key = OBJ_NEW(opal_list_t);
+    key = orcm_value_batch_new_list(batch);
     if (NULL == key) {
-        freq_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+        freq_log_cleanup(batch, key, non_compute_data, analytics_vals);
         return;
 
     }
 
-    non_compute_data = OBJ_NEW(opal_list_t);
+    non_compute_data = orcm_value_batch_new_list(batch);
     if (NULL == non_compute_data) {
-        freq_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+        freq_log_cleanup(batch, key, non_compute_data, analytics_vals);
         return;
 
     }
 
-    sensor_metric = orcm_util_load_orcm_value("ctime", &sampletime, OPAL_TIMEVAL, NULL);
+    sensor_metric = orcm_value_batch_load(batch, "ctime", &sampletime, OPAL_TIMEVAL, NULL);
     if (NULL == sensor_metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-        freq_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+        freq_log_cleanup(batch, key, non_compute_data, analytics_vals);
         return;
     }
     opal_list_append(non_compute_data, (opal_list_item_t *)sensor_metric);
@@ -1000,54 +1011,56 @@ static void freq_log(opal_buffer_t *sample)
     /* load the hostname */
     if (NULL == hostname) {
         ORTE_ERROR_LOG(OPAL_ERR_BAD_PARAM);
-        freq_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+        freq_log_cleanup(batch, key, non_compute_data, analytics_vals);
         return;
     }
-    sensor_metric = orcm_util_load_orcm_value("hostname", hostname, OPAL_STRING, NULL);
+    sensor_metric = orcm_value_batch_load(batch, "hostname", (void*)hostname, OPAL_STRING, NULL);
     if (NULL == sensor_metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-        freq_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+        freq_log_cleanup(batch, key, non_compute_data, analytics_vals);
         return;
     }
     opal_list_append(key, (opal_list_item_t *)sensor_metric);
 
-    sensor_metric = orcm_util_load_orcm_value("data_group", "freq", OPAL_STRING, NULL);
+    sensor_metric = orcm_value_batch_load(batch, "data_group", "freq", OPAL_STRING, NULL);
     if (NULL == sensor_metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-        freq_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+        freq_log_cleanup(batch, key, non_compute_data, analytics_vals);
         return;
     }
     opal_list_append(key, (opal_list_item_t *)sensor_metric);
 
     for (i=0; i < ncores; i++) {
-        analytics_vals = orcm_util_load_orcm_analytics_value(key, non_compute_data, NULL);
+        compute_data = orcm_value_batch_new_list(batch);
+        if (NULL == compute_data) {
+            ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
+            freq_log_cleanup(batch, key, non_compute_data, analytics_vals);
+            return;
+        }
+        analytics_vals = orcm_util_load_orcm_analytics_value(key, non_compute_data, compute_data);
+        OBJ_RELEASE(compute_data);
         if ((NULL == analytics_vals) || (NULL == analytics_vals->key) ||
              (NULL == analytics_vals->non_compute_data) ||(NULL == analytics_vals->compute_data)) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-            freq_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+            freq_log_cleanup(batch, key, non_compute_data, analytics_vals);
             return;
         }
 
         n=1;
         if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &fval, &n, OPAL_FLOAT))) {
             ORTE_ERROR_LOG(rc);
-            freq_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+            freq_log_cleanup(batch, key, non_compute_data, analytics_vals);
             return;
         }
 
-        if (0 > asprintf(&core_label, "core%d", i)) {
-            ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-            freq_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
-            return;
-        }
+        snprintf(core_label, sizeof(core_label), "core%d", i);
 
-        sensor_metric = orcm_util_load_orcm_value(core_label, &fval, OPAL_FLOAT, "GHz");
+        sensor_metric = orcm_value_batch_load(batch, core_label, &fval, OPAL_FLOAT, "GHz");
         if (NULL == sensor_metric) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-            freq_log_cleanup(core_label, hostname, key, non_compute_data, analytics_vals);
+            freq_log_cleanup(batch, key, non_compute_data, analytics_vals);
             return;
         }
-        SAFEFREE(core_label);
 
         /* check corefreq event policy */
         corefreq_policy_filter(hostname, i, fval, sampletime.tv_sec);
@@ -1058,12 +1071,13 @@ static void freq_log(opal_buffer_t *sample)
     }
     /* Don't release analytics_vals. It's retain(ed) and being used in the workflows
      * at this point. This doesn't cause any memory leak*/
-    freq_log_cleanup(NULL, NULL, key, non_compute_data, NULL);
+    freq_log_cleanup(NULL, key, non_compute_data, NULL);
 
     /* unpack the pstate entry count */
     n=1;
     if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &pstate_count, &n, OPAL_UINT))) {
         ORTE_ERROR_LOG(rc);
+        freq_log_cleanup(batch, NULL, NULL, NULL);
         return;
     }
     opal_output_verbose(3, orcm_sensor_base_framework.framework_output,
@@ -1071,22 +1085,22 @@ static void freq_log(opal_buffer_t *sample)
 
     if (pstate_count > 0) {
         /* xfr to storage */
-        pstate_key = OBJ_NEW(opal_list_t);
+        pstate_key = orcm_value_batch_new_list(batch);
         if (NULL == pstate_key) {
-            freq_log_cleanup(NULL, hostname, pstate_key, pstate_non_compute_data, NULL);
+            freq_log_cleanup(batch, pstate_key, pstate_non_compute_data, NULL);
             return;
         }
 
-        pstate_non_compute_data = OBJ_NEW(opal_list_t);
+        pstate_non_compute_data = orcm_value_batch_new_list(batch);
         if (NULL == pstate_non_compute_data) {
-            freq_log_cleanup(NULL, hostname, pstate_key, pstate_non_compute_data, NULL);
+            freq_log_cleanup(batch, pstate_key, pstate_non_compute_data, NULL);
             return;
         }
 
-        sensor_metric = orcm_util_load_orcm_value("ctime", &sampletime, OPAL_TIMEVAL, NULL);
+        sensor_metric = orcm_value_batch_load(batch, "ctime", &sampletime, OPAL_TIMEVAL, NULL);
         if (NULL == sensor_metric) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-            freq_log_cleanup(NULL, hostname, pstate_key, pstate_non_compute_data, NULL);
+            freq_log_cleanup(batch, pstate_key, pstate_non_compute_data, NULL);
             return;
         }
         opal_list_append(pstate_non_compute_data, (opal_list_item_t *)sensor_metric);
@@ -1094,21 +1108,21 @@ static void freq_log(opal_buffer_t *sample)
         /* load the hostname */
         if (NULL == hostname) {
             ORTE_ERROR_LOG(OPAL_ERR_BAD_PARAM);
-            freq_log_cleanup(NULL, hostname, pstate_key, pstate_non_compute_data, NULL);
+            freq_log_cleanup(batch, pstate_key, pstate_non_compute_data, NULL);
             return;
         }
-        sensor_metric = orcm_util_load_orcm_value("hostname", hostname, OPAL_STRING, NULL);
+        sensor_metric = orcm_value_batch_load(batch, "hostname", (void*)hostname, OPAL_STRING, NULL);
         if (NULL == sensor_metric) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-            freq_log_cleanup(NULL, hostname, pstate_key, pstate_non_compute_data, NULL);
+            freq_log_cleanup(batch, pstate_key, pstate_non_compute_data, NULL);
             return;
         }
         opal_list_append(pstate_key, (opal_list_item_t *)sensor_metric);
 
-        sensor_metric = orcm_util_load_orcm_value("data_group", "pstate", OPAL_STRING, NULL);
+        sensor_metric = orcm_value_batch_load(batch, "data_group", "pstate", OPAL_STRING, NULL);
         if (NULL == sensor_metric) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-            freq_log_cleanup(NULL, hostname, pstate_key, pstate_non_compute_data, NULL);
+            freq_log_cleanup(batch, pstate_key, pstate_non_compute_data, NULL);
             return;
         }
         opal_list_append(pstate_key, (opal_list_item_t *)sensor_metric);
@@ -1117,45 +1131,52 @@ static void freq_log(opal_buffer_t *sample)
     while(pstate_count > 0)
     {
         /* unpack the pstate entry name */
-        n=1;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &pstate_name, &n, OPAL_STRING))) {
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &pstate_name, NULL))) {
             ORTE_ERROR_LOG(rc);
-            freq_log_cleanup(pstate_name, hostname, pstate_key, pstate_non_compute_data, NULL);
+            freq_log_cleanup(batch, pstate_key, pstate_non_compute_data, NULL);
             return;
         }
         /* unpack the pstate entry value */
         n=1;
         if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &pstate_value, &n, OPAL_UINT))) {
             ORTE_ERROR_LOG(rc);
-            freq_log_cleanup(pstate_name, hostname, pstate_key, pstate_non_compute_data, NULL);
+            freq_log_cleanup(batch, pstate_key, pstate_non_compute_data, NULL);
             return;
         }
         opal_output_verbose(3, orcm_sensor_base_framework.framework_output,
                             "%s : %d",pstate_name, pstate_value);
 
-        analytics_vals = orcm_util_load_orcm_analytics_value(pstate_key, pstate_non_compute_data, NULL);
+        compute_data = orcm_value_batch_new_list(batch);
+        if (NULL == compute_data) {
+            ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
+            freq_log_cleanup(batch, pstate_key, pstate_non_compute_data, NULL);
+            return;
+        }
+        analytics_vals = orcm_util_load_orcm_analytics_value(pstate_key, pstate_non_compute_data,
+                                                             compute_data);
+        OBJ_RELEASE(compute_data);
         if ((NULL == analytics_vals) || (NULL == analytics_vals->key) ||
              (NULL == analytics_vals->non_compute_data) ||(NULL == analytics_vals->compute_data) ) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-            freq_log_cleanup(pstate_name, hostname, pstate_key, pstate_non_compute_data, NULL);
+            freq_log_cleanup(batch, pstate_key, pstate_non_compute_data, NULL);
             return;
         }
 
         if (0 != strcmp(pstate_name,"no_turbo")) {
-            sensor_metric = orcm_util_load_orcm_value(pstate_name, &pstate_value,
-                                                      OPAL_UINT, NULL);
+            sensor_metric = orcm_value_batch_load(batch, pstate_name, &pstate_value,
+                                                  OPAL_UINT, NULL);
             if (NULL == sensor_metric) {
                 ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-                freq_log_cleanup(pstate_name, hostname, pstate_key, pstate_non_compute_data, analytics_vals);
+                freq_log_cleanup(batch, pstate_key, pstate_non_compute_data, analytics_vals);
                 return;
             }
         } else {
             pstate_flag = ((0 == pstate_value) ? true: false);
-            sensor_metric = orcm_util_load_orcm_value("allow_turbo", &pstate_flag,
-                                                      OPAL_BOOL, NULL);
+            sensor_metric = orcm_value_batch_load(batch, "allow_turbo", &pstate_flag,
+                                                  OPAL_BOOL, NULL);
             if (NULL == sensor_metric) {
                 ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
-                freq_log_cleanup(pstate_name, hostname, pstate_key, pstate_non_compute_data, analytics_vals);
+                freq_log_cleanup(batch, pstate_key, pstate_non_compute_data, analytics_vals);
                 return;
             }
         }
@@ -1166,7 +1187,7 @@ static void freq_log(opal_buffer_t *sample)
     }
     /* Don't release analytics_vals. It's retain(ed) and being used in the workflows at
      * this point. This doesn't cause any memory leak*/
-    freq_log_cleanup(pstate_name, hostname, pstate_key, pstate_non_compute_data, NULL);
+    freq_log_cleanup(batch, pstate_key, pstate_non_compute_data, NULL);
 }
 
 static void freq_set_sample_rate(int sample_rate)
@@ -1357,11 +1378,6 @@ static void freq_inventory_collect(opal_buffer_t *inventory_snapshot)
     }
 }
 
-static void my_inventory_log_cleanup(int dbhandle, int status, opal_list_t *kvs, opal_list_t *output, void *cbdata)
-{
-    OBJ_RELEASE(kvs);
-}
-
 static void freq_inventory_log(char *hostname, opal_buffer_t *inventory_snapshot)
 {
     unsigned int tot_items = 0;
@@ -1400,9 +1416,5 @@ static void freq_inventory_log(char *hostname, opal_buffer_t *inventory_snapshot
 
         --tot_items;
     }
-    if (0 <= orcm_sensor_base.dbhandle) {
-        orcm_db.store_new(orcm_sensor_base.dbhandle, ORCM_DB_INVENTORY_DATA, records, NULL, my_inventory_log_cleanup, NULL);
-    } else {
-        my_inventory_log_cleanup(-1, -1, records, NULL, NULL);
-    }
+    orcm_sensor_base_inventory_store(hostname, "freq", records);
 }
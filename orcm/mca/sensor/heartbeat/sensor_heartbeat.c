@@ -23,6 +23,7 @@
 #include <string.h>
 #endif  /* HAVE_STRING_H */
 #include <stdio.h>
+#include <sys/time.h>
 
 #include "opal_stdint.h"
 #include "opal/util/argv.h"
@@ -70,14 +71,148 @@ static void recv_beats(int status, orte_process_name_t* sender,
                        opal_buffer_t *buffer,
                        orte_rml_tag_t tag, void *cbdata);
 
+/* Beat state of each daemon, indexed by vpid. A daemon's deadline is
+ * missed_beats times its period past its last beat, where the period
+ * is the shortest spacing seen between its beats but never less than
+ * our own sample rate. Pending deadlines sit in a timing wheel of
+ * one-period slots so that a check only visits the slots that came
+ * due since the last one.
+ */
+#define HB_WHEEL_SLOTS  64
+#define HB_NONE         -1
+
+typedef struct {
+    bool tracked;
+    uint64_t last_beat;   /* msec, 0 until the first beat */
+    uint64_t spacing;     /* msec, 0 until the second beat */
+    uint64_t deadline;    /* msec */
+    int slot;             /* wheel slot, or HB_NONE */
+    int prev, next;       /* neighbours in the slot */
+} hb_tracker_t;
+
 /* local globals */
 static orte_job_t *daemons=NULL;
 static opal_event_t check_ev;
 static bool check_active = false;
 static struct timeval check_time;
 
+static hb_tracker_t *trackers = NULL;
+static int ntrackers = 0;
+static int ntracked = 0;
+static int wheel[HB_WHEEL_SLOTS];
+static uint64_t tick_msec = 0;
+static uint64_t wheel_tick = 0;
+
+static uint64_t now_msec(void)
+{
+    struct timeval now;
+
+    gettimeofday(&now, NULL);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_usec / 1000;
+}
+
+static void wheel_remove(int vpid)
+{
+    hb_tracker_t *t = &trackers[vpid];
+
+    if (HB_NONE == t->slot) {
+        return;
+    }
+    if (HB_NONE == t->prev) {
+        wheel[t->slot] = t->next;
+    } else {
+        trackers[t->prev].next = t->next;
+    }
+    if (HB_NONE != t->next) {
+        trackers[t->next].prev = t->prev;
+    }
+    t->slot = HB_NONE;
+    t->prev = HB_NONE;
+    t->next = HB_NONE;
+}
+
+static void wheel_insert(int vpid)
+{
+    hb_tracker_t *t = &trackers[vpid];
+    uint64_t tick;
+
+    tick = (t->deadline + tick_msec - 1) / tick_msec;
+    if (tick <= wheel_tick) {
+        /* already due - catch it on the next check */
+        tick = wheel_tick + 1;
+    }
+    t->slot = tick % HB_WHEEL_SLOTS;
+    t->prev = HB_NONE;
+    t->next = wheel[t->slot];
+    if (HB_NONE != t->next) {
+        trackers[t->next].prev = vpid;
+    }
+    wheel[t->slot] = vpid;
+}
+
+static void set_deadline(int vpid, uint64_t now)
+{
+    hb_tracker_t *t = &trackers[vpid];
+    uint64_t period = (t->spacing > tick_msec) ? t->spacing : tick_msec;
+
+    wheel_remove(vpid);
+    t->deadline = now + (uint64_t)mca_sensor_heartbeat_component.missed_beats * period;
+    wheel_insert(vpid);
+}
+
+static hb_tracker_t* track(int vpid, uint64_t now)
+{
+    hb_tracker_t *tmp;
+    int n, i;
+
+    if (vpid >= ntrackers) {
+        for (n = (0 == ntrackers) ? 64 : ntrackers; n <= vpid; n *= 2);
+        if (NULL == (tmp = (hb_tracker_t*)realloc(trackers, n * sizeof(hb_tracker_t)))) {
+            return NULL;
+        }
+        memset(tmp + ntrackers, 0, (n - ntrackers) * sizeof(hb_tracker_t));
+        for (i = ntrackers; i < n; i++) {
+            tmp[i].slot = HB_NONE;
+            tmp[i].prev = HB_NONE;
+            tmp[i].next = HB_NONE;
+        }
+        trackers = tmp;
+        ntrackers = n;
+    }
+    if (!trackers[vpid].tracked) {
+        trackers[vpid].tracked = true;
+        set_deadline(vpid, now);
+        ntracked++;
+    }
+    return &trackers[vpid];
+}
+
+/* start the clock on any daemon we have not seen yet */
+static void track_daemons(uint64_t now)
+{
+    orte_proc_t *proc;
+    int v;
+
+    /* every daemon but us is tracked - nothing new */
+    if (ntracked + 1 >= (int)daemons->num_procs) {
+        return;
+    }
+    for (v=0; v < daemons->procs->size; v++) {
+        if (NULL == (proc = (orte_proc_t*)opal_pointer_array_get_item(daemons->procs, v))) {
+            continue;
+        }
+        /* ignore myself */
+        if (proc->name.vpid == ORTE_PROC_MY_NAME->vpid) {
+            continue;
+        }
+        track(proc->name.vpid, now);
+    }
+}
+
 static int init(void)
 {
+    int i;
+
     OPAL_OUTPUT_VERBOSE((1, orcm_sensor_base_framework.framework_output,
                          "%s initializing heartbeat recvs",
                          ORTE_NAME_PRINT(ORTE_PROC_MY_NAME)));
@@ -94,6 +229,13 @@ static int init(void)
         daemons = orte_get_job_data_object(ORTE_PROC_MY_NAME->jobid);
     }
 
+    for (i=0; i < HB_WHEEL_SLOTS; i++) {
+        wheel[i] = HB_NONE;
+    }
+    if (mca_sensor_heartbeat_component.missed_beats < 1) {
+        mca_sensor_heartbeat_component.missed_beats = 1;
+    }
+
     return ORCM_SUCCESS;
 }
 
@@ -104,15 +246,29 @@ static void finalize(void)
         opal_event_del(&check_ev);
         check_active = false;
     }
+    if (NULL != trackers) {
+        free(trackers);
+        trackers = NULL;
+    }
+    ntrackers = 0;
+    ntracked = 0;
     return;
 }
 
 static void start(orte_jobid_t job)
 {
+    uint64_t now;
+
     if (!check_active && NULL != daemons) {
-        /* setup the check event */
-        check_time.tv_sec = 3 * orcm_sensor_base.sample_rate;
+        /* check once per sample period */
+        check_time.tv_sec = (0 < orcm_sensor_base.sample_rate) ? orcm_sensor_base.sample_rate : 1;
         check_time.tv_usec = 0;
+        tick_msec = (uint64_t)check_time.tv_sec * 1000;
+        now = now_msec();
+        wheel_tick = now / tick_msec;
+        track_daemons(now);
+
+        /* setup the check event */
         opal_event_evtimer_set(orte_event_base, &check_ev, check_heartbeat, &check_ev);
         opal_event_evtimer_add(&check_ev, &check_time);
         check_active = true;
@@ -173,10 +329,11 @@ static void sample(orcm_sensor_sampler_t *sampler)
  */
 static void check_heartbeat(int fd, short dummy, void *arg)
 {
-    int v;
+    int v, next, expired = 0;
     orte_proc_t *proc;
     opal_event_t *tmp = (opal_event_t*)arg;
-    int32_t beats, *bptr;
+    uint64_t now, now_tick;
+    hb_tracker_t *t;
 
     OPAL_OUTPUT_VERBOSE((3, orcm_sensor_base_framework.framework_output,
                          "%s sensor:check_heartbeat",
@@ -193,44 +350,56 @@ static void check_heartbeat(int fd, short dummy, void *arg)
         check_active = false;
         return;
     }
-    
-    for (v=0; v < daemons->procs->size; v++) {
-        if (NULL == (proc = (orte_proc_t*)opal_pointer_array_get_item(daemons->procs, v))) {
-            continue;
-        }
-        /* ignore myself */
-        if (proc->name.vpid == ORTE_PROC_MY_NAME->vpid) {
-            continue;
-        }
-        if (ORTE_PROC_STATE_RUNNING != proc->state) {
-            OPAL_OUTPUT_VERBOSE((1, orcm_sensor_base_framework.framework_output,
-                                 "%s sensor:heartbeat DAEMON %s IS NOT RUNNING",
-                                 ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
-                                 ORTE_NAME_PRINT(&proc->name)));
-            continue;
-        }
 
-        beats = 0;
-        bptr = &beats;
-        orte_get_attribute(&proc->attributes, ORTE_PROC_NBEATS, (void**)bptr, OPAL_INT32);
-        if (0 == beats) {
-            /* no heartbeat recvd in last window */
+    now = now_msec();
+    track_daemons(now);
+
+    /* if we were held up for more than a full turn, every
+     * slot is due - visit each of them once */
+    now_tick = now / tick_msec;
+    if (now_tick > wheel_tick + HB_WHEEL_SLOTS) {
+        wheel_tick = now_tick - HB_WHEEL_SLOTS;
+    }
+    while (wheel_tick < now_tick) {
+        wheel_tick++;
+        v = wheel[wheel_tick % HB_WHEEL_SLOTS];
+        wheel[wheel_tick % HB_WHEEL_SLOTS] = HB_NONE;
+        for (; HB_NONE != v; v = next) {
+            t = &trackers[v];
+            next = t->next;
+            t->slot = HB_NONE;
+            t->prev = HB_NONE;
+            t->next = HB_NONE;
+            if (now < t->deadline) {
+                /* due on a later turn of the wheel */
+                wheel_insert(v);
+                continue;
+            }
+            /* no heartbeat recvd in time - look again a full deadline from now */
+            set_deadline(v, now);
+            if (NULL == (proc = (orte_proc_t*)opal_pointer_array_get_item(daemons->procs, v))) {
+                continue;
+            }
+            if (ORTE_PROC_STATE_RUNNING != proc->state) {
+                OPAL_OUTPUT_VERBOSE((1, orcm_sensor_base_framework.framework_output,
+                                     "%s sensor:heartbeat DAEMON %s IS NOT RUNNING",
+                                     ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                                     ORTE_NAME_PRINT(&proc->name)));
+                continue;
+            }
             OPAL_OUTPUT_VERBOSE((1, orcm_sensor_base_framework.framework_output,
                                  "%s sensor:check_heartbeat FAILED for daemon %s",
                                  ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
                                  ORTE_NAME_PRINT(&proc->name)));
             ORTE_ACTIVATE_PROC_STATE(&proc->name, ORTE_PROC_STATE_HEARTBEAT_FAILED);
-        } else {
-            OPAL_OUTPUT_VERBOSE((1, orcm_sensor_base_framework.framework_output,
-                                 "%s HEARTBEAT DETECTED FOR %s: NUM BEATS %d",
-                                 ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
-                                 ORTE_NAME_PRINT(&proc->name), beats));
+            expired++;
         }
-        /* reset for next period */
-        beats = 0;
-        orte_set_attribute(&proc->attributes, ORTE_PROC_NBEATS, ORTE_ATTR_LOCAL, (void*)bptr, OPAL_INT32);
     }
 
+    OPAL_OUTPUT_VERBOSE((3, orcm_sensor_base_framework.framework_output,
+                         "%s sensor:check_heartbeat %d of %d daemons missed their deadline",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), expired, ntracked));
+
     /* reset the timer */
     opal_event_evtimer_add(tmp, &check_time);
 }
@@ -240,10 +409,11 @@ static void recv_beats(int status, orte_process_name_t* sender,
                        orte_rml_tag_t tag, void *cbdata)
 {
     orte_proc_t *proc;
-    int rc, n;
-    char *component=NULL;
-    opal_buffer_t *buf;
-    int32_t beats, *bptr;
+    int rc;
+    const char *component;
+    opal_buffer_t buf;
+    hb_tracker_t *t;
+    uint64_t now, spacing;
 
     opal_output_verbose(1, orcm_sensor_base_framework.framework_output,
                         "%s received beat from %s",
@@ -262,11 +432,18 @@ static void recv_beats(int status, orte_process_name_t* sender,
                                  "%s marked beat from %s",
                                  ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
                                  ORTE_NAME_PRINT(sender)));
-            beats = 0;
-            bptr = &beats;
-            orte_get_attribute(&proc->attributes, ORTE_PROC_NBEATS, (void**)bptr, OPAL_INT32);
-            beats++;
-            orte_set_attribute(&proc->attributes, ORTE_PROC_NBEATS, ORTE_ATTR_LOCAL, (void*)bptr, OPAL_INT32);
+            /* the clock only runs once checking has started */
+            if (check_active && NULL != (t = track(sender->vpid, now = now_msec()))) {
+                /* a daemon sampling slower than us gets a longer deadline */
+                if (0 < t->last_beat && now > t->last_beat) {
+                    spacing = now - t->last_beat;
+                    if (0 == t->spacing || spacing < t->spacing) {
+                        t->spacing = spacing;
+                    }
+                }
+                t->last_beat = now;
+                set_deadline(sender->vpid, now);
+            }
             /* if this daemon has reappeared, reset things */
             if (ORTE_PROC_STATE_HEARTBEAT_FAILED == proc->state) {
                 proc->state = ORTE_PROC_STATE_RUNNING;
@@ -274,21 +451,18 @@ static void recv_beats(int status, orte_process_name_t* sender,
         }
     }
 
-    /* unload any sampled data */
-    n=1;
-    while (OPAL_SUCCESS == (rc = opal_dss.unpack(buffer, &buf, &n, OPAL_BUFFER))) {
-        if (NULL != buf) {
-            n=1;
-            if (OPAL_SUCCESS != (rc = opal_dss.unpack(buf, &component, &n, OPAL_STRING))) {
-                ORTE_ERROR_LOG(rc);
-                break;
-            }
-            orcm_sensor_base_log(component, buf);
-            OBJ_RELEASE(buf);
-            free(component);
-            n=1;
+    /* unload any sampled data - each bucket is viewed in place in the
+     * message rather than copied out, so it is only good until the
+     * message is released when we return */
+    OBJ_CONSTRUCT(&buf, opal_buffer_t);
+    while (OPAL_SUCCESS == (rc = opal_dss.unpack_buffer_view(buffer, &buf))) {
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(&buf, &component, NULL))) {
+            ORTE_ERROR_LOG(rc);
+            break;
         }
+        orcm_sensor_base_log(component, &buf);
     }
+    OBJ_DESTRUCT(&buf);
 
     if (OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER != rc) {
         ORTE_ERROR_LOG(rc);
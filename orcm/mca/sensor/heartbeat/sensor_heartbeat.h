@@ -22,7 +22,13 @@
 
 BEGIN_C_DECLS
 
-ORCM_MODULE_DECLSPEC extern orcm_sensor_base_component_t mca_sensor_heartbeat_component;
+typedef struct {
+    orcm_sensor_base_component_t super;
+    /* a daemon is failed once it misses this many beats in a row */
+    int missed_beats;
+} orcm_sensor_heartbeat_component_t;
+
+ORCM_MODULE_DECLSPEC extern orcm_sensor_heartbeat_component_t mca_sensor_heartbeat_component;
 extern orcm_sensor_base_module_t orcm_sensor_heartbeat_module;
 
 
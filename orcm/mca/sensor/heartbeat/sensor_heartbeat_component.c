@@ -25,26 +25,29 @@
 static int orcm_sensor_heartbeat_open(void);
 static int orcm_sensor_heartbeat_close(void);
 static int orcm_sensor_heartbeat_query(mca_base_module_t **module, int *priority);
+static int heartbeat_component_register(void);
 
-orcm_sensor_base_component_t mca_sensor_heartbeat_component = {
+orcm_sensor_heartbeat_component_t mca_sensor_heartbeat_component = {
     {
-        ORCM_SENSOR_BASE_VERSION_1_0_0,
-        /* Component name and version */
-        .mca_component_name = "heartbeat",
-        MCA_BASE_MAKE_VERSION(component, ORCM_MAJOR_VERSION, ORCM_MINOR_VERSION,
-                              ORCM_RELEASE_VERSION),
-        
-        /* Component open and close functions */
-        .mca_open_component = orcm_sensor_heartbeat_open,
-        .mca_close_component = orcm_sensor_heartbeat_close,
-        .mca_query_component = orcm_sensor_heartbeat_query,
-        NULL
-    },
-    .base_data = {
-        /* The component is checkpoint ready */
-        MCA_BASE_METADATA_PARAM_CHECKPOINT
-    },
-    "heartbeat"
+        {
+            ORCM_SENSOR_BASE_VERSION_1_0_0,
+            /* Component name and version */
+            .mca_component_name = "heartbeat",
+            MCA_BASE_MAKE_VERSION(component, ORCM_MAJOR_VERSION, ORCM_MINOR_VERSION,
+                                  ORCM_RELEASE_VERSION),
+
+            /* Component open and close functions */
+            .mca_open_component = orcm_sensor_heartbeat_open,
+            .mca_close_component = orcm_sensor_heartbeat_close,
+            .mca_query_component = orcm_sensor_heartbeat_query,
+            .mca_register_component_params = heartbeat_component_register
+        },
+        .base_data = {
+            /* The component is checkpoint ready */
+            MCA_BASE_METADATA_PARAM_CHECKPOINT
+        },
+        "heartbeat"
+    }
 };
 
 
@@ -72,3 +75,18 @@ static int orcm_sensor_heartbeat_close(void)
 {
     return ORCM_SUCCESS;
 }
+
+static int heartbeat_component_register(void)
+{
+    mca_base_component_t *c = &mca_sensor_heartbeat_component.super.base_version;
+
+    mca_sensor_heartbeat_component.missed_beats = 3;
+    (void) mca_base_component_var_register(c, "missed_beats",
+                                           "Number of consecutive beats a daemon may miss before it is declared failed [default: 3]",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_sensor_heartbeat_component.missed_beats);
+
+    return ORCM_SUCCESS;
+}
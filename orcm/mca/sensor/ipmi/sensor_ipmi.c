@@ -258,17 +258,15 @@ static void ipmi_sample(orcm_sensor_sampler_t *sampler)
 
 static void ipmi_log_extract_create_string(opal_buffer_t *sample, char *dest_string, size_t dest_str_size)
 {
-    char *extract_item = NULL;
-    int n = 1;
+    const char *extract_item = NULL;
     int rc;
 
-    if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &extract_item, &n, OPAL_STRING))) {
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &extract_item, NULL))) {
         ORTE_ERROR_LOG(rc);
         return;
     }
-    strncpy(dest_string, extract_item, dest_str_size-1);
+    strncpy(dest_string, (NULL == extract_item) ? "" : extract_item, dest_str_size-1);
     dest_string[dest_str_size-1] = '\0';
-    SAFEFREE(extract_item);
 }
 
 static void ipmi_log_new_node(opal_buffer_t *sample)
@@ -443,8 +441,8 @@ static void ipmi_log_new_node(opal_buffer_t *sample)
 
 }
 
-static void ipmi_log_sample_item(opal_list_t *key, opal_list_t *non_compute_data, char *sample_key,
-                                void *sample_item, opal_data_type_t type, char *units )
+static void ipmi_log_sample_item(opal_list_t *key, opal_list_t *non_compute_data, const char *sample_key,
+                                const void *sample_item, opal_data_type_t type, const char *units )
 {
     orcm_value_t *sensor_metric = NULL;
     orcm_analytics_value_t *analytics_vals = NULL;
@@ -456,7 +454,7 @@ static void ipmi_log_sample_item(opal_list_t *key, opal_list_t *non_compute_data
         goto cleanup;
     }
 
-    sensor_metric = orcm_util_load_orcm_value(sample_key, sample_item, type, units);
+    sensor_metric = orcm_util_load_orcm_value(sample_key, (void*)sample_item, type, units);
     if (NULL == sensor_metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
         goto cleanup;
@@ -473,10 +471,10 @@ static void ipmi_log_sample_item(opal_list_t *key, opal_list_t *non_compute_data
 
 static void ipmi_log_existing_multiple_hosts(opal_buffer_t *sample, int host_count)
 {
-    char *hostname = NULL;
-    char *sample_item = NULL;
-    char *sample_name = NULL;
-    char *sample_unit = NULL;
+    const char *hostname = NULL;
+    const char *sample_item = NULL;
+    const char *sample_name = NULL;
+    const char *sample_unit = NULL;
     float float_item;
     unsigned uint_item;
     int rc;
@@ -517,15 +515,14 @@ static void ipmi_log_existing_multiple_hosts(opal_buffer_t *sample, int host_cou
         opal_list_append(non_compute_data, (opal_list_item_t *)sensor_metric);
 
         /* Unpack the node_name - 3 */
-        n=1;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &hostname, &n, OPAL_STRING))) {
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &hostname, NULL))) {
             ORTE_ERROR_LOG(rc);
             goto cleanup;
         }
         opal_output_verbose(5, orcm_sensor_base_framework.framework_output,
             "UnPacked NodeName: %s", hostname);
 
-        sensor_metric = orcm_util_load_orcm_value("hostname", hostname, OPAL_STRING, NULL);
+        sensor_metric = orcm_util_load_orcm_value("hostname", (void*)hostname, OPAL_STRING, NULL);
         if (NULL == sensor_metric) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
             goto cleanup;
@@ -541,8 +538,7 @@ static void ipmi_log_existing_multiple_hosts(opal_buffer_t *sample, int host_cou
         opal_list_append(key, (opal_list_item_t *)sensor_metric);
 
         /* BMC FW REV - 4 */
-        n=1;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &sample_item, &n, OPAL_STRING))) {
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &sample_item, NULL))) {
             ORTE_ERROR_LOG(rc);
             goto cleanup;
         }
@@ -550,11 +546,9 @@ static void ipmi_log_existing_multiple_hosts(opal_buffer_t *sample, int host_cou
             "UnPacked bmcfwrev: %s", sample_item);
 
         ipmi_log_sample_item(key, non_compute_data, "bmcfwrev", sample_item, OPAL_STRING, NULL);
-        SAFEFREE(sample_item);
 
         /* IPMI VER - 5 */
-        n=1;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &sample_item, &n, OPAL_STRING))) {
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &sample_item, NULL))) {
             ORTE_ERROR_LOG(rc);
             goto cleanup;
         }
@@ -562,11 +556,9 @@ static void ipmi_log_existing_multiple_hosts(opal_buffer_t *sample, int host_cou
             "UnPacked ipmiver: %s", sample_item);
 
         ipmi_log_sample_item(key, non_compute_data, "ipmiver", sample_item, OPAL_STRING, NULL);
-        SAFEFREE(sample_item);
 
         /* Manufacturer ID - 6 */
-        n=1;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &sample_item, &n, OPAL_STRING))) {
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &sample_item, NULL))) {
             ORTE_ERROR_LOG(rc);
             goto cleanup;
         }
@@ -574,21 +566,17 @@ static void ipmi_log_existing_multiple_hosts(opal_buffer_t *sample, int host_cou
             "UnPacked MANUF-ID: %s", sample_item);
 
         ipmi_log_sample_item(key, non_compute_data, "manufacturer_id", sample_item, OPAL_STRING, NULL);
-        SAFEFREE(sample_item);
 
         /* System Power State - 7 */
-        n=1;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &sample_item, &n, OPAL_STRING))) {
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &sample_item, NULL))) {
             ORTE_ERROR_LOG(rc);
             goto cleanup;
         }
 
         ipmi_log_sample_item(key, non_compute_data, "sys_power_state", sample_item, OPAL_STRING, NULL);
-        SAFEFREE(sample_item);
 
         /* Device Power State - 8 */
-        n=1;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &sample_item, &n, OPAL_STRING))) {
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &sample_item, NULL))) {
             ORTE_ERROR_LOG(rc);
             goto cleanup;
         }
@@ -596,7 +584,6 @@ static void ipmi_log_existing_multiple_hosts(opal_buffer_t *sample, int host_cou
             "UnPacked DEV_PSTATE: %s", sample_item);
 
         ipmi_log_sample_item(key, non_compute_data, "dev_power_state", sample_item, OPAL_STRING, NULL);
-        SAFEFREE(sample_item);
 
         /* Total BMC sensor Metrics sampled - 9 (Not necessary for db_store) */
         n=1;
@@ -609,8 +596,7 @@ static void ipmi_log_existing_multiple_hosts(opal_buffer_t *sample, int host_cou
         for(unsigned int count_metrics=0;count_metrics<uint_item;count_metrics++)
         {
             /* Metric Name */
-            n=1;
-            if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &sample_name, &n, OPAL_STRING))) {
+            if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &sample_name, NULL))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup;
             }
@@ -623,16 +609,13 @@ static void ipmi_log_existing_multiple_hosts(opal_buffer_t *sample, int host_cou
             }
 
             /* Metric Units */
-            n=1;
-            if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &sample_unit, &n, OPAL_STRING))) {
+            if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &sample_unit, NULL))) {
                 ORTE_ERROR_LOG(rc);
                 goto cleanup;
             }
             ipmi_log_sample_item(key, non_compute_data, sample_name, &float_item, OPAL_FLOAT, sample_unit);
             opal_output_verbose(5, orcm_sensor_base_framework.framework_output,
                 "UnPacked %s: %f", sample_name, float_item);
-            SAFEFREE(sample_name);
-            SAFEFREE(sample_unit);
         }
 
         /* IPMI SEL Records Storage into the opal_list_t 'vals' */
@@ -642,10 +625,9 @@ static void ipmi_log_existing_multiple_hosts(opal_buffer_t *sample, int host_cou
             return;
         }
         for(unsigned int count_metrics=0;count_metrics<uint_item;count_metrics++) {
-            char* record_string = NULL;
+            const char *record_string = NULL;
 
-            n=1;
-            if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &record_string, &n, OPAL_STRING))) {
+            if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &record_string, NULL))) {
                 ORTE_ERROR_LOG(rc);
                 return;
             }
@@ -653,7 +635,6 @@ static void ipmi_log_existing_multiple_hosts(opal_buffer_t *sample, int host_cou
         }
 
     cleanup:
-        SAFEFREE(hostname);
         if ( NULL != key) {
             OBJ_RELEASE(key);
         }
@@ -1353,13 +1334,19 @@ static void ipmi_inventory_log(char *hostname, opal_buffer_t *inventory_snapshot
             }
             opal_list_prepend(oldhost->records, &kv->super);
 
-            /* Send the collected inventory details to the database for storage */
-            if (0 <= orcm_sensor_base.dbhandle) {
-                orcm_db.store_new(orcm_sensor_base.dbhandle, ORCM_DB_INVENTORY_DATA , oldhost->records, NULL, NULL, NULL);
-            }
+            /* Send the collected inventory details to the database for storage -
+             * the host list keeps its own reference */
+            OBJ_RETAIN(oldhost->records);
+            orcm_sensor_base_inventory_store(hostname, "ipmi", oldhost->records);
         } else {
             opal_output_verbose(5, orcm_sensor_base_framework.framework_output,
                                 "ipmi compare passed");
+            if (orcm_sensor_base.inventory_digest) {
+                /* the host only sends it again when our last write
+                 * of it has not been seen to succeed */
+                OBJ_RETAIN(oldhost->records);
+                orcm_sensor_base_inventory_store(hostname, "ipmi", oldhost->records);
+            }
         }
         /* newhost structure can be destroyed after comparision with original list and update */
         OBJ_RELEASE(newhost);
@@ -1376,10 +1363,10 @@ static void ipmi_inventory_log(char *hostname, opal_buffer_t *inventory_snapshot
         }
         opal_list_prepend(newhost->records, &kv->super);
 
-        /* Send the collected inventory details to the database for storage */
-        if (0 <= orcm_sensor_base.dbhandle) {
-            orcm_db.store_new(orcm_sensor_base.dbhandle, ORCM_DB_INVENTORY_DATA , newhost->records, NULL, NULL, NULL);
-        }
+        /* Send the collected inventory details to the database for storage -
+         * the host list keeps its own reference */
+        OBJ_RETAIN(newhost->records);
+        orcm_sensor_base_inventory_store(hostname, "ipmi", newhost->records);
     }
 }
 
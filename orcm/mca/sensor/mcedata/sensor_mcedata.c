@@ -71,6 +71,8 @@ static void mcedata_bus_ic_filter(unsigned long *mce_reg, opal_list_t *vals);
 static void get_log_lines(FILE *fp);
 static void perthread_mcedata_sample(int fd, short args, void *cbdata);
 static void collect_sample(orcm_sensor_sampler_t *sampler);
+static void read_log(opal_buffer_t *bucket);
+static void log_changed(const char *path, int events, void *cbdata);
 static void mcedata_set_sample_rate(int sample_rate);
 static void mcedata_get_sample_rate(int *sample_rate);
 static void mcedata_inventory_collect(opal_buffer_t *inventory_snapshot);
@@ -121,6 +123,10 @@ static char *log_line_token[] = {
 /* Next position at which to read log file */
 static long log_file_pos;
 
+/* while the log is watched, new lines are read as they are
+ * written and the sample tick leaves the log alone */
+static int log_watch = -1;
+
 /* MCE log lines for reporting*/
 static char *log_lines[mcelog_sentinel];
 
@@ -310,6 +316,8 @@ static void finalize(void)
  */
 static void start(orte_jobid_t jobid)
 {
+    opal_event_base_t *ev_base = orcm_sensor_base.ev_base;
+
     start_log_file();
 
     /* start a separate mcedata progress thread for sampling */
@@ -321,7 +329,24 @@ static void start(orte_jobid_t jobid)
                 return;
             }
         }
+        ev_base = mca_sensor_mcedata_component.ev_base;
+    }
+
+    if (0 > log_watch &&
+        ORCM_SUCCESS == orcm_sensor_base_watch_add(mca_sensor_mcedata_component.logfile,
+                                                   ORCM_SENSOR_WATCH_MODIFY, ev_base,
+                                                   log_changed, NULL, &log_watch)) {
+        opal_output_verbose(5, orcm_sensor_base_framework.framework_output,
+                            "%s sensor mcedata : watching %s",
+                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                            mca_sensor_mcedata_component.logfile);
+        if (!mca_sensor_mcedata_component.use_progress_thread) {
+            mca_sensor_mcedata_component.sample_rate = orcm_sensor_base.sample_rate;
+        }
+        return;
+    }
 
+    if (mca_sensor_mcedata_component.use_progress_thread) {
         /* setup mcedata sampler */
         mcedata_sampler = OBJ_NEW(orcm_sensor_sampler_t);
 
@@ -345,11 +370,17 @@ static void start(orte_jobid_t jobid)
 
 static void stop(orte_jobid_t jobid)
 {
+    orcm_sensor_base_watch_remove(log_watch);
+    log_watch = -1;
+
     if (mca_sensor_mcedata_component.ev_active) {
         mca_sensor_mcedata_component.ev_active = false;
         /* stop the thread without releasing the event base */
         opal_progress_thread_pause("mcedata");
-        OBJ_RELEASE(mcedata_sampler);
+        if (NULL != mcedata_sampler) {
+            OBJ_RELEASE(mcedata_sampler);
+            mcedata_sampler = NULL;
+        }
     }
     return;
 }
@@ -1116,6 +1147,35 @@ static void mcedata_sample(orcm_sensor_sampler_t *sampler)
  */
 
 static void collect_sample(orcm_sensor_sampler_t *sampler)
+{
+    /* a watched log is read as soon as it changes */
+    if (0 > log_watch) {
+        read_log(&sampler->bucket);
+    }
+}
+
+/* the log was written to, or rotated - pick up any new machine
+ * checks straight away rather than at the next sample */
+static void log_changed(const char *path, int events, void *cbdata)
+{
+    opal_buffer_t data;
+
+    if (events & ORCM_SENSOR_WATCH_CREATE) {
+        /* a fresh log starts from the top */
+        log_file_pos = 0;
+    }
+    if (0 == (events & (ORCM_SENSOR_WATCH_MODIFY | ORCM_SENSOR_WATCH_CREATE))) {
+        return;
+    }
+    OBJ_CONSTRUCT(&data, opal_buffer_t);
+    read_log(&data);
+    if (0 < data.bytes_used) {
+        ORCM_SENSOR_XFER_NOW(&data);
+    }
+    OBJ_DESTRUCT(&data);
+}
+
+static void read_log(opal_buffer_t *bucket)
 {
     int ret;
     char *temp;
@@ -1277,7 +1337,7 @@ static void collect_sample(orcm_sensor_sampler_t *sampler)
         /* xfer the data for transmission */
         if (packed) {
             bptr = &data;
-            if (OPAL_SUCCESS != (ret = opal_dss.pack(&sampler->bucket, &bptr, 1, OPAL_BUFFER))) {
+            if (OPAL_SUCCESS != (ret = opal_dss.pack(bucket, &bptr, 1, OPAL_BUFFER))) {
                 fclose(fp);
                 ORTE_ERROR_LOG(ret);
                 OBJ_DESTRUCT(&data);
@@ -1295,7 +1355,7 @@ static void collect_sample(orcm_sensor_sampler_t *sampler)
 
 static void mcedata_log(opal_buffer_t *sample)
 {
-    char *hostname=NULL;
+    const char *hostname=NULL;
     struct timeval sampletime;
     int rc;
     int32_t n, i = 0;
@@ -1313,8 +1373,7 @@ static void mcedata_log(opal_buffer_t *sample)
     }
 
     /* unpack the host this came from */
-    n=1;
-    if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &hostname, &n, OPAL_STRING))) {
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &hostname, NULL))) {
         ORTE_ERROR_LOG(rc);
         goto cleanup;
     }
@@ -1344,7 +1403,7 @@ static void mcedata_log(opal_buffer_t *sample)
         goto cleanup;
     }
 
-    sensor_metric = orcm_util_load_orcm_value("hostname", hostname, OPAL_STRING, NULL);
+    sensor_metric = orcm_util_load_orcm_value("hostname", (void*)hostname, OPAL_STRING, NULL);
     if (NULL == sensor_metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
         goto cleanup;
@@ -1413,7 +1472,6 @@ static void mcedata_log(opal_buffer_t *sample)
     orcm_analytics.send_data(analytics_vals);
 
 cleanup:
-    SAFEFREE(hostname);
     if (NULL != analytics_vals) {
         OBJ_RELEASE(analytics_vals);
     }
@@ -1504,11 +1562,6 @@ static void mcedata_inventory_collect(opal_buffer_t *inventory_snapshot)
     }
 }
 
-static void my_inventory_log_cleanup(int dbhandle, int status, opal_list_t *kvs, opal_list_t *output, void *cbdata)
-{
-    OBJ_RELEASE(kvs);
-}
-
 static void mcedata_inventory_log(char *hostname, opal_buffer_t *inventory_snapshot)
 {
     unsigned int tot_items = 0;
@@ -1547,9 +1600,5 @@ static void mcedata_inventory_log(char *hostname, opal_buffer_t *inventory_snaps
 
         --tot_items;
     }
-    if (0 <= orcm_sensor_base.dbhandle) {
-        orcm_db.store_new(orcm_sensor_base.dbhandle, ORCM_DB_INVENTORY_DATA, records, NULL, my_inventory_log_cleanup, NULL);
-    } else {
-        my_inventory_log_cleanup(-1, -1, records, NULL, NULL);
-    }
+    orcm_sensor_base_inventory_store(hostname, "mcedata", records);
 }
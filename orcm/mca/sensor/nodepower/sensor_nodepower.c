@@ -510,7 +510,7 @@ retry_b:
  */
 static void nodepower_log(opal_buffer_t *sample)
 {
-    char *hostname=NULL;
+    const char *hostname=NULL;
     int rc;
     int32_t n;
     int sensor_not_avail=0;
@@ -523,8 +523,7 @@ static void nodepower_log(opal_buffer_t *sample)
 
 
     /* unpack the host this came from */
-    n=1;
-    if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &hostname, &n, OPAL_STRING))) {
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &hostname, NULL))) {
         ORTE_ERROR_LOG(rc);
         goto cleanup;
     }
@@ -576,7 +575,7 @@ static void nodepower_log(opal_buffer_t *sample)
     opal_list_append(analytics_vals->non_compute_data, (opal_list_item_t *)sensor_metric);
 
     /* load the hostname */
-    sensor_metric = orcm_util_load_orcm_value("hostname", hostname, OPAL_STRING, NULL);
+    sensor_metric = orcm_util_load_orcm_value("hostname", (void*)hostname, OPAL_STRING, NULL);
     if (NULL == sensor_metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
         goto cleanup;
@@ -609,7 +608,6 @@ static void nodepower_log(opal_buffer_t *sample)
     }
 
 cleanup:
-    SAFEFREE(hostname);
     if ( NULL != analytics_vals) {
         OBJ_RELEASE(analytics_vals);
     }
@@ -730,11 +728,6 @@ static void nodepower_inventory_collect(opal_buffer_t *inventory_snapshot)
     free(comp);
 }
 
-static void my_inventory_log_cleanup(int dbhandle, int status, opal_list_t *kvs, opal_list_t *output, void *cbdata)
-{
-    OBJ_RELEASE(kvs);
-}
-
 static void nodepower_inventory_log(char *hostname, opal_buffer_t *inventory_snapshot)
 {
     unsigned int tot_items = 0;
@@ -773,9 +766,5 @@ static void nodepower_inventory_log(char *hostname, opal_buffer_t *inventory_sna
 
         --tot_items;
     }
-    if (0 <= orcm_sensor_base.dbhandle) {
-        orcm_db.store_new(orcm_sensor_base.dbhandle, ORCM_DB_INVENTORY_DATA, records, NULL, my_inventory_log_cleanup, NULL);
-    } else {
-        my_inventory_log_cleanup(-1, -1, records, NULL, NULL);
-    }
+    orcm_sensor_base_inventory_store(hostname, "nodepower", records);
 }
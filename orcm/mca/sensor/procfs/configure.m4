@@ -0,0 +1,25 @@
+dnl -*- shell-script -*-
+dnl
+dnl Copyright (c) 2016      Intel, Inc. All rights reserved.
+dnl $COPYRIGHT$
+dnl 
+dnl Additional copyrights may follow
+dnl 
+dnl $HEADER$
+dnl
+
+# MCA_sensor_procfs_CONFIG([action-if-found], [action-if-not-found])
+# -----------------------------------------------------------
+AC_DEFUN([MCA_orcm_sensor_procfs_CONFIG], [
+    AC_CONFIG_FILES([orcm/mca/sensor/procfs/Makefile])
+
+    AC_ARG_WITH([procfs],
+                [AC_HELP_STRING([--with-procfs],
+                                [Build the native /proc resource sensor (default: yes on Linux)])],
+	                        [], with_procfs=yes)
+
+    # the counters are read straight from /proc, so this is Linux only
+    AS_IF([test "$with_procfs" != "no" && test "$opal_found_linux" = "yes"],
+          [$1],
+          [$2])
+])dnl
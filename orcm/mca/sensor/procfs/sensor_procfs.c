@@ -0,0 +1,1882 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+#include "orcm/types.h"
+
+#include <errno.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif  /* HAVE_UNISTD_H */
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif  /* HAVE_STRING_H */
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <math.h>
+#ifdef HAVE_TIME_H
+#include <time.h>
+#endif
+
+#include "opal_stdint.h"
+#include "opal/class/opal_list.h"
+#include "opal/class/opal_pointer_array.h"
+#include "opal/dss/dss.h"
+#include "opal/util/output.h"
+#include "opal/mca/event/event.h"
+#include "opal/runtime/opal_progress_threads.h"
+
+#include "orte/mca/errmgr/errmgr.h"
+#include "orte/runtime/orte_globals.h"
+#include "orte/util/show_help.h"
+
+#include "orcm/mca/db/db.h"
+#include "orcm/runtime/orcm_globals.h"
+#include "orcm/mca/analytics/analytics.h"
+#include "orcm/util/utils.h"
+#include "orcm/util/value_batch.h"
+
+#include "orcm/mca/sensor/base/base.h"
+#include "orcm/mca/sensor/base/sensor_private.h"
+#include "sensor_procfs.h"
+#include "sensor_procfs_parse.h"
+
+/* declare the API functions */
+static int init(void);
+static void finalize(void);
+static void start(orte_jobid_t job);
+static void stop(orte_jobid_t job);
+static void procfs_sample(orcm_sensor_sampler_t *sampler);
+static void perthread_procfs_sample(int fd, short args, void *cbdata);
+static void collect_sample(orcm_sensor_sampler_t *sampler);
+static void procfs_log(opal_buffer_t *buf);
+static void procfs_set_sample_rate(int sample_rate);
+static void procfs_get_sample_rate(int *sample_rate);
+static void procfs_inventory_collect(opal_buffer_t *inventory_snapshot);
+static void procfs_inventory_log(char *hostname, opal_buffer_t *inventory_snapshot);
+
+/* instantiate the module */
+orcm_sensor_base_module_t orcm_sensor_procfs_module = {
+    init,
+    finalize,
+    start,
+    stop,
+    procfs_sample,
+    procfs_log,
+    procfs_inventory_collect,
+    procfs_inventory_log,
+    procfs_set_sample_rate,
+    procfs_get_sample_rate
+};
+
+/* Previous counters of a block device or network interface, so
+ * rates can be computed. Entries are added as devices show up in
+ * /proc and dropped once they are gone.
+ */
+typedef struct {
+    opal_list_item_t super;
+    char *name;
+    /* only whole disks are summed, so partitions and
+     * stacked devices are not counted twice */
+    bool counted;
+    uint64_t pass;
+    uint64_t in_ops;
+    uint64_t out_ops;
+    uint64_t in_bytes;
+    uint64_t out_bytes;
+} sensor_procfs_dev_t;
+static void dev_cons(sensor_procfs_dev_t *dev)
+{
+    dev->name = NULL;
+    dev->counted = true;
+    dev->pass = 0;
+    dev->in_ops = 0;
+    dev->out_ops = 0;
+    dev->in_bytes = 0;
+    dev->out_bytes = 0;
+}
+static void dev_dest(sensor_procfs_dev_t *dev)
+{
+    if (NULL != dev->name) {
+        free(dev->name);
+    }
+}
+OBJ_CLASS_INSTANCE(sensor_procfs_dev_t,
+                   opal_list_item_t,
+                   dev_cons, dev_dest);
+
+/* Descriptors held open for each monitored process */
+typedef struct {
+    opal_list_item_t super;
+    pid_t pid;
+    int stat_fd;
+    int statm_fd;
+    uint64_t pass;
+    uint64_t cpu_ticks;
+    struct timeval last;
+} sensor_procfs_proc_t;
+static void proc_cons(sensor_procfs_proc_t *proc)
+{
+    proc->pid = 0;
+    proc->stat_fd = -1;
+    proc->statm_fd = -1;
+    proc->pass = 0;
+    proc->cpu_ticks = 0;
+    proc->last.tv_sec = 0;
+    proc->last.tv_usec = 0;
+}
+static void proc_dest(sensor_procfs_proc_t *proc)
+{
+    if (0 <= proc->stat_fd) {
+        close(proc->stat_fd);
+    }
+    if (0 <= proc->statm_fd) {
+        close(proc->statm_fd);
+    }
+}
+OBJ_CLASS_INSTANCE(sensor_procfs_proc_t,
+                   opal_list_item_t,
+                   proc_cons, proc_dest);
+
+/* The node-wide files are opened once and re-read from the start
+ * with pread on every sample
+ */
+enum {
+    PROCFS_STAT,
+    PROCFS_MEMINFO,
+    PROCFS_VMSTAT,
+    PROCFS_LOADAVG,
+    PROCFS_UPTIME,
+    PROCFS_DISKSTATS,
+    PROCFS_NETDEV,
+    PROCFS_NUM_FILES
+};
+static struct {
+    const char *path;
+    int fd;
+} procfs_files[PROCFS_NUM_FILES] = {
+    {"/proc/stat", -1},
+    {"/proc/meminfo", -1},
+    {"/proc/vmstat", -1},
+    {"/proc/loadavg", -1},
+    {"/proc/uptime", -1},
+    {"/proc/diskstats", -1},
+    {"/proc/net/dev", -1}
+};
+
+/* buffer the files are read into, grown as needed */
+static char *databuf = NULL;
+static size_t databuf_size = 0;
+#define PROCFS_DATABUF_SIZE 16384
+
+static opal_list_t disklist;
+static opal_list_t netlist;
+static opal_list_t proclist;
+static uint64_t dev_pass = 0;
+static uint64_t proc_pass = 0;
+static DIR *procdir = NULL;
+static long page_size = 4096;
+static long clk_tck = 100;
+static time_t last_sample = 0;
+static procfs_meminfo_t meminfo;
+static bool meminfo_valid = false;
+static struct cpu_data_t {
+    uint64_t user;
+    uint64_t nice;
+    uint64_t sys;
+    uint64_t idle;
+    uint64_t wait;
+    uint64_t total;
+} pcpu;
+static struct swap_data_t {
+    uint64_t page_in;
+    uint64_t page_out;
+} pswap;
+
+static opal_buffer_t test_vector;
+static orcm_sensor_sampler_t *procfs_sampler = NULL;
+static orcm_sensor_procfs_t orcm_sensor_procfs;
+
+static uint64_t metric_diff_calc(uint64_t newval, uint64_t oldval,
+                                 const char *name_for_log,
+                                 const char* value_name_for_log);
+static void generate_test_vector(opal_buffer_t *v);
+
+/* The metrics logged for each group of a sample, in the order they
+ * are packed. The keys and units are those the sigar sensor stores,
+ * so the data lands in the same place whichever of the two ran.
+ */
+typedef struct {
+    const char *key;
+    opal_data_type_t type;
+    const char *units;
+} procfs_metric_t;
+
+static const procfs_metric_t mem_metrics[] = {
+    {"mem_total", OPAL_UINT64, "Bytes"},
+    {"mem_used", OPAL_UINT64, "Bytes"},
+    {"mem_actual_used", OPAL_UINT64, "Bytes"},
+    {"mem_actual_free", OPAL_UINT64, "Bytes"}
+};
+static const procfs_metric_t swap_metrics[] = {
+    {"swap_total", OPAL_UINT64, "Bytes"},
+    {"swap_used", OPAL_UINT64, "Bytes"},
+    {"swap_page_in", OPAL_UINT64, "Bytes"},
+    {"swap_page_out", OPAL_UINT64, "Bytes"}
+};
+static const procfs_metric_t cpu_metrics[] = {
+    {"cpu_user", OPAL_FLOAT, "%"},
+    {"cpu_sys", OPAL_FLOAT, "%"},
+    {"cpu_idle", OPAL_FLOAT, "%"}
+};
+static const procfs_metric_t load_metrics[] = {
+    {"load0", OPAL_FLOAT, NULL},
+    {"load1", OPAL_FLOAT, NULL},
+    {"load2", OPAL_FLOAT, NULL}
+};
+static const procfs_metric_t disk_metrics[] = {
+    {"disk_ro_rate", OPAL_UINT64, "ops/sec"},
+    {"disk_wo_rate", OPAL_UINT64, "ops/sec"},
+    {"disk_rb_rate", OPAL_UINT64, "bytes/sec"},
+    {"disk_wb_rate", OPAL_UINT64, "bytes/sec"},
+    {"disk_ro_total", OPAL_UINT64, "ops"},
+    {"disk_wo_total", OPAL_UINT64, "ops"},
+    {"disk_rb_total", OPAL_UINT64, "bytes"},
+    {"disk_wb_total", OPAL_UINT64, "bytes"},
+    {"disk_rt_total", OPAL_UINT64, "msec"},
+    {"disk_wt_total", OPAL_UINT64, "msec"},
+    {"disk_iot_total", OPAL_UINT64, "msec"}
+};
+static const procfs_metric_t net_metrics[] = {
+    {"net_rp_rate", OPAL_UINT64, "packets/sec"},
+    {"net_wp_rate", OPAL_UINT64, "packets/sec"},
+    {"net_rb_rate", OPAL_UINT64, "bytes/sec"},
+    {"net_wb_rate", OPAL_UINT64, "bytes/sec"},
+    {"net_wb_total", OPAL_UINT64, "Mbytes"},
+    {"net_rb_total", OPAL_UINT64, "Mbytes"},
+    {"net_wp_total", OPAL_UINT64, "packets"},
+    {"net_rp_total", OPAL_UINT64, "packets"},
+    {"net_tx_errors", OPAL_UINT64, "errors"},
+    {"net_rx_errors", OPAL_UINT64, "errors"}
+};
+static const procfs_metric_t sys_metrics[] = {
+    {"uptime", OPAL_DOUBLE, "seconds"}
+};
+static const procfs_metric_t procstat_metrics[] = {
+    {"total_processes", OPAL_INT64, NULL},
+    {"sleeping_processes", OPAL_INT64, NULL},
+    {"running_processes", OPAL_INT64, NULL},
+    {"zombie_processes", OPAL_INT64, NULL},
+    {"stopped_processes", OPAL_INT64, NULL},
+    {"idle_processes", OPAL_INT64, NULL},
+    {"total_threads", OPAL_INT64, NULL}
+};
+/* packed after the opal_pstats_t of each process */
+static const procfs_metric_t proc_metrics[] = {
+    {"shared_memory", OPAL_INT64, NULL},
+    {"minor_faults", OPAL_INT64, NULL},
+    {"major_faults", OPAL_INT64, NULL},
+    {"page_faults", OPAL_INT64, NULL},
+    {"percent", OPAL_DOUBLE, NULL}
+};
+
+#define PROCFS_NUM(a) (sizeof(a) / sizeof((a)[0]))
+
+/* the node-wide groups under the "sigar" data group */
+static const struct {
+    const procfs_metric_t *metrics;
+    size_t num;
+} node_groups[] = {
+    {mem_metrics, PROCFS_NUM(mem_metrics)},
+    {swap_metrics, PROCFS_NUM(swap_metrics)},
+    {cpu_metrics, PROCFS_NUM(cpu_metrics)},
+    {load_metrics, PROCFS_NUM(load_metrics)},
+    {disk_metrics, PROCFS_NUM(disk_metrics)},
+    {net_metrics, PROCFS_NUM(net_metrics)},
+    {sys_metrics, PROCFS_NUM(sys_metrics)}
+};
+
+static int init(void)
+{
+    int i;
+
+    if (mca_sensor_procfs_component.test) {
+        /* generate test vector */
+        OBJ_CONSTRUCT(&test_vector, opal_buffer_t);
+        generate_test_vector(&test_vector);
+        return ORCM_SUCCESS;
+    }
+
+    /* setup the globals */
+    OBJ_CONSTRUCT(&disklist, opal_list_t);
+    OBJ_CONSTRUCT(&netlist, opal_list_t);
+    OBJ_CONSTRUCT(&proclist, opal_list_t);
+    memset(&pcpu, 0, sizeof(pcpu));
+    memset(&pswap, 0, sizeof(pswap));
+    if (0 < (page_size = sysconf(_SC_PAGESIZE)) &&
+        0 < (clk_tck = sysconf(_SC_CLK_TCK))) {
+        /* all set */
+    } else {
+        page_size = 4096;
+        clk_tck = 100;
+    }
+
+    if (NULL == (databuf = (char*)malloc(PROCFS_DATABUF_SIZE))) {
+        ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    databuf_size = PROCFS_DATABUF_SIZE;
+
+    /* a missing file only costs us the metrics taken from it */
+    for (i=0; i < PROCFS_NUM_FILES; i++) {
+        if (0 > (procfs_files[i].fd = open(procfs_files[i].path, O_RDONLY))) {
+            orte_show_help("help-orcm-sensor-procfs.txt", "req-file-not-found",
+                           true, orte_process_info.nodename,
+                           procfs_files[i].path);
+        }
+    }
+    if (mca_sensor_procfs_component.proc &&
+        NULL == (procdir = opendir("/proc"))) {
+        orte_show_help("help-orcm-sensor-procfs.txt", "req-file-not-found",
+                       true, orte_process_info.nodename, "/proc");
+    }
+
+    return ORCM_SUCCESS;
+}
+
+static void finalize(void)
+{
+    opal_list_item_t *item;
+    int i;
+
+    if (mca_sensor_procfs_component.test) {
+        /* destruct test vector */
+        OBJ_DESTRUCT(&test_vector);
+        return;
+    }
+
+    for (i=0; i < PROCFS_NUM_FILES; i++) {
+        if (0 <= procfs_files[i].fd) {
+            close(procfs_files[i].fd);
+            procfs_files[i].fd = -1;
+        }
+    }
+    if (NULL != procdir) {
+        closedir(procdir);
+        procdir = NULL;
+    }
+    if (NULL != databuf) {
+        free(databuf);
+        databuf = NULL;
+        databuf_size = 0;
+    }
+    while (NULL != (item = opal_list_remove_first(&disklist))) {
+        OBJ_RELEASE(item);
+    }
+    OBJ_DESTRUCT(&disklist);
+    while (NULL != (item = opal_list_remove_first(&netlist))) {
+        OBJ_RELEASE(item);
+    }
+    OBJ_DESTRUCT(&netlist);
+    while (NULL != (item = opal_list_remove_first(&proclist))) {
+        OBJ_RELEASE(item);
+    }
+    OBJ_DESTRUCT(&proclist);
+
+    return;
+}
+
+/*
+ * Start monitoring of local processes
+ */
+static void start(orte_jobid_t jobid)
+{
+    /* start a separate procfs progress thread for sampling */
+    if (mca_sensor_procfs_component.use_progress_thread) {
+        if (!orcm_sensor_procfs.ev_active) {
+            orcm_sensor_procfs.ev_active = true;
+            if (NULL == (orcm_sensor_procfs.ev_base = opal_progress_thread_init("procfs"))) {
+                orcm_sensor_procfs.ev_active = false;
+                return;
+            }
+        }
+
+        /* setup procfs sampler */
+        procfs_sampler = OBJ_NEW(orcm_sensor_sampler_t);
+
+        /* check if procfs sample rate is provided for this*/
+        if (!mca_sensor_procfs_component.sample_rate) {
+            mca_sensor_procfs_component.sample_rate = orcm_sensor_base.sample_rate;
+        }
+        procfs_sampler->rate.tv_sec = mca_sensor_procfs_component.sample_rate;
+        procfs_sampler->log_data = orcm_sensor_base.log_samples;
+        opal_event_evtimer_set(orcm_sensor_procfs.ev_base, &procfs_sampler->ev,
+                               perthread_procfs_sample, procfs_sampler);
+        opal_event_evtimer_add(&procfs_sampler->ev, &procfs_sampler->rate);
+    } else {
+        mca_sensor_procfs_component.sample_rate = orcm_sensor_base.sample_rate;
+    }
+
+    return;
+}
+
+static void stop(orte_jobid_t jobid)
+{
+    if (orcm_sensor_procfs.ev_active) {
+        orcm_sensor_procfs.ev_active = false;
+        /* stop the thread without releasing the event base */
+        opal_progress_thread_pause("procfs");
+    }
+    return;
+}
+
+/* Read one of the node-wide files from the start. Unless the whole
+ * file is wanted, whatever fits in the buffer is enough - /proc/stat
+ * is only needed for its first line.
+ */
+static char *procfs_read(int file, bool whole)
+{
+    ssize_t len;
+    char *tmp;
+
+    if (0 > procfs_files[file].fd) {
+        return NULL;
+    }
+    while (true) {
+        len = pread(procfs_files[file].fd, databuf, databuf_size - 1, 0);
+        if (0 > len) {
+            opal_output_verbose(1, orcm_sensor_base_framework.framework_output,
+                                "%s sensor:procfs read of %s failed: %s",
+                                ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                                procfs_files[file].path, strerror(errno));
+            return NULL;
+        }
+        if (!whole || (size_t)len < databuf_size - 1) {
+            break;
+        }
+        /* the file outgrew the buffer - double it and go again */
+        if (NULL == (tmp = (char*)realloc(databuf, 2 * databuf_size))) {
+            ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
+            return NULL;
+        }
+        databuf = tmp;
+        databuf_size *= 2;
+    }
+    databuf[len] = '\0';
+    return databuf;
+}
+
+static bool procfs_read_meminfo(procfs_meminfo_t *mi)
+{
+    char *cur;
+
+    if (NULL == (cur = procfs_read(PROCFS_MEMINFO, true))) {
+        return false;
+    }
+    return procfs_parse_meminfo(cur, mi);
+}
+
+/* look up - or start tracking - a device by name */
+static sensor_procfs_dev_t *procfs_find_dev(opal_list_t *list, const char *name,
+                                            size_t len, bool *fresh)
+{
+    sensor_procfs_dev_t *dev;
+
+    OPAL_LIST_FOREACH(dev, list, sensor_procfs_dev_t) {
+        if (0 == strncmp(dev->name, name, len) && '\0' == dev->name[len]) {
+            *fresh = false;
+            return dev;
+        }
+    }
+    dev = OBJ_NEW(sensor_procfs_dev_t);
+    if (NULL == dev || NULL == (dev->name = strndup(name, len))) {
+        if (NULL != dev) {
+            OBJ_RELEASE(dev);
+        }
+        return NULL;
+    }
+    opal_list_append(list, &dev->super);
+    *fresh = true;
+    return dev;
+}
+
+/* forget the devices that did not show up this pass */
+static void procfs_prune_devs(opal_list_t *list)
+{
+    sensor_procfs_dev_t *dev, *next;
+
+    OPAL_LIST_FOREACH_SAFE(dev, next, list, sensor_procfs_dev_t) {
+        if (dev_pass != dev->pass) {
+            opal_list_remove_item(list, &dev->super);
+            OBJ_RELEASE(dev);
+        }
+    }
+}
+
+static int procfs_collect_mem(opal_buffer_t *dataptr, double tdiff)
+{
+    int rc;
+    uint64_t used, kern, actual_used, actual_free;
+    bool log_group = meminfo_valid;
+
+    if (log_group) {
+        /* same accounting as sigar: buffers and page cache count as free */
+        used = meminfo.total - meminfo.free;
+        kern = meminfo.buffers + meminfo.cached;
+        actual_used = (used > kern) ? used - kern : 0;
+        actual_free = meminfo.free + kern;
+        opal_output_verbose(1, orcm_sensor_base_framework.framework_output,
+                            "mem total: %" PRIu64 " used: %" PRIu64 " actual used: %" PRIu64 " actual free: %" PRIu64 "",
+                            meminfo.total, used, actual_used, actual_free);
+    }
+
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &log_group, 1, OPAL_BOOL))) {
+        return rc;
+    }
+    if (false == log_group)
+        return ORCM_ERR_SENSOR_READ_FAIL;
+
+    /* add it to the dataptr */
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &meminfo.total, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &used, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &actual_used, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &actual_free, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    return ORCM_SUCCESS;
+}
+
+static int procfs_collect_swap(opal_buffer_t *dataptr, double tdiff)
+{
+    int rc;
+    char *cur;
+    uint64_t used, page_in = 0, page_out = 0, ui64;
+    bool log_group = meminfo_valid;
+
+    /* the paging counters live in /proc/vmstat */
+    if (log_group) {
+        if (NULL == (cur = procfs_read(PROCFS_VMSTAT, true))) {
+            log_group = false;
+        } else {
+            procfs_parse_vmstat(cur, &page_in, &page_out);
+        }
+    }
+    if (log_group) {
+        used = meminfo.swap_total - meminfo.swap_free;
+        opal_output_verbose(1, orcm_sensor_base_framework.framework_output,
+                            "swap total: %" PRIu64 " used: %" PRIu64 "page_in: %" PRIu64 " page_out: %" PRIu64 "\n",
+                            meminfo.swap_total, used, page_in, page_out);
+    }
+
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &log_group, 1, OPAL_BOOL))) {
+        return rc;
+    }
+    if (false == log_group)
+        return ORCM_ERR_SENSOR_READ_FAIL;
+    /* compute the values we actually want and add them to the dataptr */
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &meminfo.swap_total, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &used, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    ui64 = metric_diff_calc(page_in, pswap.page_in, "swap", "page in");
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &ui64, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    ui64 = metric_diff_calc(page_out, pswap.page_out, "swap", "page out");
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &ui64, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    pswap.page_in = page_in;
+    pswap.page_out = page_out;
+    return ORCM_SUCCESS;
+}
+
+static int procfs_collect_cpu(opal_buffer_t *dataptr, double tdiff)
+{
+    int rc;
+    char *cur;
+    struct cpu_data_t cpu;
+    uint64_t irq, softirq, steal;
+    double cpu_diff;
+    float tmp;
+    bool log_group = true;
+
+    /* the first line of /proc/stat sums all cpus, in ticks */
+    memset(&cpu, 0, sizeof(cpu));
+    if (NULL == (cur = procfs_read(PROCFS_STAT, false)) ||
+        !scan_tag(&cur, "cpu ", 4)) {
+        opal_output(0, "%s sensor:procfs cannot read the cpu counters",
+                    ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
+        log_group = false;
+    } else {
+        cpu.user = scan_u64(&cur);
+        cpu.nice = scan_u64(&cur);
+        cpu.sys = scan_u64(&cur);
+        cpu.idle = scan_u64(&cur);
+        cpu.wait = scan_u64(&cur);
+        irq = scan_u64(&cur);
+        softirq = scan_u64(&cur);
+        steal = scan_u64(&cur);
+        cpu.total = cpu.user + cpu.nice + cpu.sys + cpu.idle + cpu.wait +
+                    irq + softirq + steal;
+    }
+    opal_output_verbose(1, orcm_sensor_base_framework.framework_output,
+                        "cpu user: %" PRIu64 " sys: %" PRIu64 " idle: %" PRIu64 " wait: %" PRIu64 " nice: %" PRIu64 " total: %" PRIu64 "",
+                        cpu.user, cpu.sys, cpu.idle, cpu.wait, cpu.nice, cpu.total);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &log_group, 1, OPAL_BOOL))) {
+        return rc;
+    }
+    if (false == log_group)
+        return ORCM_ERR_SENSOR_READ_FAIL;
+
+    /* compute the values we actually want and add them to the dataptr */
+    cpu_diff = (double)(cpu.total - pcpu.total);
+    if (0.0 >= cpu_diff) {
+        /* no ticks went by - report zero rather than NaN */
+        cpu_diff = 1.0;
+    }
+    tmp = (float)((cpu.user - pcpu.user) * 100.0 / cpu_diff) + (float)((cpu.nice - pcpu.nice) * 100.0 / cpu_diff);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &tmp, 1, OPAL_FLOAT))) {
+        return rc;
+    }
+    tmp = ((float) (cpu.sys - pcpu.sys) * 100.0 / cpu_diff) + ((float)((cpu.wait - pcpu.wait) * 100.0 / cpu_diff));
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &tmp, 1, OPAL_FLOAT))) {
+        return rc;
+    }
+    tmp = (float) (cpu.idle - pcpu.idle) * 100.0 / cpu_diff;
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &tmp, 1, OPAL_FLOAT))) {
+        return rc;
+    }
+    /* update the values */
+    pcpu = cpu;
+
+    return ORCM_SUCCESS;
+}
+
+static int procfs_collect_load(opal_buffer_t *dataptr, double tdiff)
+{
+    int rc, i;
+    char *cur;
+    float loadavg[3] = {0.0, 0.0, 0.0};
+    bool log_group = true;
+
+    if (NULL == (cur = procfs_read(PROCFS_LOADAVG, false))) {
+        log_group = false;
+    } else {
+        for (i=0; i < 3; i++) {
+            loadavg[i] = strtof(cur, &cur);
+        }
+    }
+    opal_output_verbose(1, orcm_sensor_base_framework.framework_output,
+                        "load_avg: %e %e %e",
+                        loadavg[0], loadavg[1], loadavg[2]);
+
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &log_group, 1, OPAL_BOOL))) {
+        return rc;
+    }
+    if (false == log_group)
+        return ORCM_ERR_SENSOR_READ_FAIL;
+    /* add them to the dataptr */
+    for (i=0; i < 3; i++) {
+        if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &loadavg[i], 1, OPAL_FLOAT))) {
+            return rc;
+        }
+    }
+    return ORCM_SUCCESS;
+}
+
+/* is this a whole, physical disk rather than a partition or a
+ * device stacked on top of others (loop, dm, md, ...)? */
+static bool procfs_whole_disk(const char *name)
+{
+    char path[OPAL_PATH_MAX];
+
+    snprintf(path, sizeof(path), "/sys/block/%s/device", name);
+    return (0 == access(path, F_OK));
+}
+
+static int procfs_collect_disk(opal_buffer_t *dataptr, double tdiff)
+{
+    int rc;
+    char *cur, *name;
+    size_t len;
+    bool fresh;
+    sensor_procfs_dev_t *dev;
+    uint64_t fields[PROCFS_DISK_FIELDS];
+    uint64_t reads, writes, read_bytes, write_bytes, read_time, write_time, io_time;
+    uint64_t delta_reads = 0, delta_writes = 0, delta_read_bytes = 0, delta_write_bytes = 0;
+    uint64_t total_reads = 0, total_writes = 0, total_read_bytes = 0, total_write_bytes = 0;
+    uint64_t total_rtime = 0, total_wtime = 0, total_qtime = 0;
+    bool log_group = true;
+
+    if (NULL == (cur = procfs_read(PROCFS_DISKSTATS, true))) {
+        log_group = false;
+    } else {
+        ++dev_pass;
+        do {
+            if (!procfs_parse_diskstats(&cur, &name, &len, fields)) {
+                continue;
+            }
+            if (NULL == (dev = procfs_find_dev(&disklist, name, len, &fresh))) {
+                continue;
+            }
+            dev->pass = dev_pass;
+            if (fresh) {
+                dev->counted = procfs_whole_disk(dev->name);
+            } else if (dev->counted) {
+                delta_reads += metric_diff_calc(fields[0], dev->in_ops, dev->name, "disk reads");
+                delta_writes += metric_diff_calc(fields[4], dev->out_ops, dev->name, "disk writes");
+                delta_read_bytes += metric_diff_calc(fields[2] * 512, dev->in_bytes, dev->name, "disk read bytes");
+                delta_write_bytes += metric_diff_calc(fields[6] * 512, dev->out_bytes, dev->name, "disk write bytes");
+            }
+            dev->in_ops = fields[0];
+            dev->out_ops = fields[4];
+            dev->in_bytes = fields[2] * 512;
+            dev->out_bytes = fields[6] * 512;
+            if (!dev->counted) {
+                continue;
+            }
+            opal_output_verbose(1, orcm_sensor_base_framework.framework_output,
+                                "Disk: %s Reads: %" PRIu64 " Writes: %" PRIu64 " ReadBytes: %" PRIu64 " WriteBytes: %" PRIu64 "",
+                                dev->name, dev->in_ops, dev->out_ops, dev->in_bytes, dev->out_bytes);
+            total_reads += dev->in_ops;
+            total_writes += dev->out_ops;
+            total_read_bytes += dev->in_bytes;
+            total_write_bytes += dev->out_bytes;
+            total_rtime += fields[3];
+            total_wtime += fields[7];
+            total_qtime += fields[10];
+        } while (scan_line(&cur));
+        procfs_prune_devs(&disklist);
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &log_group, 1, OPAL_BOOL))) {
+        return rc;
+    }
+    if (false == log_group)
+        return ORCM_ERR_SENSOR_READ_FAIL;
+    opal_output_verbose(4, orcm_sensor_base_framework.framework_output,
+                        "Totals: ReadsChange: %" PRIu64 " WritesChange: %" PRIu64 " ReadBytesChange: %" PRIu64 " WriteBytesChange: %" PRIu64 "",
+                        delta_reads, delta_writes, delta_read_bytes, delta_write_bytes);
+    opal_output_verbose(4, orcm_sensor_base_framework.framework_output,
+                        "Totals: ReadTime: %" PRIu64 " WriteTime: %" PRIu64 " ioTime: %" PRIu64 "",
+                        total_rtime, total_wtime, total_qtime);
+
+    /* compute the values we actually want and add them to the dataptr */
+    reads = (uint64_t)ceil((double)delta_reads/tdiff);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &reads, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    writes = (uint64_t)ceil((double)delta_writes/tdiff);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &writes, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    read_bytes = (uint64_t)ceil((double)delta_read_bytes/tdiff);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &read_bytes, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    write_bytes = (uint64_t)ceil((double)delta_write_bytes/tdiff);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &write_bytes, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &total_reads, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &total_writes, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &total_read_bytes, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &total_write_bytes, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    read_time = total_rtime;
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &read_time, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    write_time = total_wtime;
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &write_time, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    io_time = total_qtime;
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &io_time, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    return ORCM_SUCCESS;
+}
+
+static int procfs_collect_network(opal_buffer_t *dataptr, double tdiff)
+{
+    int rc;
+    char *cur, *name;
+    size_t len;
+    bool fresh;
+    sensor_procfs_dev_t *dev;
+    uint64_t fields[PROCFS_NET_FIELDS];
+    uint64_t rxpkts, txpkts, rxbytes, txbytes;
+    uint64_t delta_rxpkts = 0, delta_txpkts = 0, delta_rxbytes = 0, delta_txbytes = 0;
+    uint64_t total_mbytes_sent = 0, total_mbytes_recv = 0, total_packets_sent = 0, total_packets_recv = 0;
+    uint64_t total_errors_sent = 0, total_errors_recv = 0;
+    bool log_group = true;
+
+    /* skip the two header lines */
+    if (NULL == (cur = procfs_read(PROCFS_NETDEV, true)) ||
+        !scan_line(&cur) || !scan_line(&cur)) {
+        log_group = false;
+    } else {
+        ++dev_pass;
+        do {
+            if (!procfs_parse_netdev(&cur, &name, &len, fields)) {
+                break;
+            }
+            if (NULL == (dev = procfs_find_dev(&netlist, name, len, &fresh))) {
+                continue;
+            }
+            dev->pass = dev_pass;
+            if (!fresh) {
+                /* an interface we have not seen before has no rate yet */
+                delta_rxbytes += metric_diff_calc(fields[0], dev->in_bytes, dev->name, "rx bytes");
+                delta_rxpkts += metric_diff_calc(fields[1], dev->in_ops, dev->name, "rx packets");
+                delta_txbytes += metric_diff_calc(fields[8], dev->out_bytes, dev->name, "tx bytes");
+                delta_txpkts += metric_diff_calc(fields[9], dev->out_ops, dev->name, "tx packets");
+            }
+            dev->in_bytes = fields[0];
+            dev->in_ops = fields[1];
+            dev->out_bytes = fields[8];
+            dev->out_ops = fields[9];
+            opal_output_verbose(1, orcm_sensor_base_framework.framework_output,
+                                "Interface: %s RecvdPackets: %" PRIu64 " RecvdBytes: %" PRIu64 " TransPackets: %" PRIu64 " TransBytes: %" PRIu64 "",
+                                dev->name, dev->in_ops, dev->in_bytes, dev->out_ops, dev->out_bytes);
+            total_mbytes_sent += fields[8];
+            total_mbytes_recv += fields[0];
+            total_packets_sent += fields[9];
+            total_packets_recv += fields[1];
+            total_errors_sent += fields[10];
+            total_errors_recv += fields[2];
+        } while (scan_line(&cur));
+        procfs_prune_devs(&netlist);
+    }
+    opal_output_verbose(4, orcm_sensor_base_framework.framework_output,
+                        "Totals: RxPkts: %" PRIu64 " TxPkts: %" PRIu64 " RxBytes: %" PRIu64 " TxBytes: %" PRIu64 "",
+                        delta_rxpkts, delta_txpkts, delta_rxbytes, delta_txbytes);
+
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &log_group, 1, OPAL_BOOL))) {
+        return rc;
+    }
+    if (false == log_group)
+        return ORCM_ERR_SENSOR_READ_FAIL;
+
+    /* compute the values we actually want and add them to the data */
+    rxpkts = (uint64_t)ceil((double)delta_rxpkts/tdiff);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &rxpkts, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    txpkts = (uint64_t)ceil((double)delta_txpkts/tdiff);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &txpkts, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    rxbytes = (uint64_t)ceil((double)delta_rxbytes/tdiff);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &rxbytes, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    txbytes = (uint64_t)ceil((double)delta_txbytes/tdiff);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &txbytes, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    total_mbytes_sent = (uint64_t)ceil((double)total_mbytes_sent/(1024*1024)); /* convert to Mbytes */
+    total_mbytes_recv = (uint64_t)ceil((double)total_mbytes_recv/(1024*1024)); /* convert to Mbytes */
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &total_mbytes_sent, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &total_mbytes_recv, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &total_packets_sent, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &total_packets_recv, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &total_errors_sent, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &total_errors_recv, 1, OPAL_UINT64))) {
+        return rc;
+    }
+    return ORCM_SUCCESS;
+}
+
+static int procfs_collect_system(opal_buffer_t *dataptr, double tdiff)
+{
+    int rc;
+    char *cur;
+    double uptime = 0.0;
+    bool log_group = true;
+
+    if (NULL == (cur = procfs_read(PROCFS_UPTIME, false))) {
+        log_group = false;
+    } else {
+        uptime = strtod(cur, NULL);
+    }
+    opal_output_verbose(1, orcm_sensor_base_framework.framework_output,
+                        "uptime: %f", uptime);
+
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &log_group, 1, OPAL_BOOL))) {
+        return rc;
+    }
+    if (false == log_group)
+        return ORCM_ERR_SENSOR_READ_FAIL;
+    /* add them to the dataptr */
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &uptime, 1, OPAL_DOUBLE))) {
+        return rc;
+    }
+    return ORCM_SUCCESS;
+}
+
+static int procfs_collect_global_procstat(opal_buffer_t *dataptr)
+{
+    int rc, fd;
+    struct dirent *entry;
+    char path[OPAL_PATH_MAX], data[1024], *cmd;
+    size_t cmdlen;
+    ssize_t len;
+    char state;
+    int64_t fields[21];
+    int64_t total = 0, sleeping = 0, running = 0, zombie = 0;
+    int64_t stopped = 0, idle = 0, threads = 0;
+    bool log_group = true;
+
+    if (NULL == procdir) {
+        log_group = false;
+    } else {
+        /* a single walk of /proc, sorting the processes by state */
+        rewinddir(procdir);
+        while (NULL != (entry = readdir(procdir))) {
+            if (entry->d_name[0] < '0' || entry->d_name[0] > '9') {
+                continue;
+            }
+            snprintf(path, sizeof(path), "%s/stat", entry->d_name);
+            if (0 > (fd = openat(dirfd(procdir), path, O_RDONLY))) {
+                /* exited while we were looking */
+                continue;
+            }
+            len = pread(fd, data, sizeof(data) - 1, 0);
+            close(fd);
+            if (0 >= len) {
+                continue;
+            }
+            data[len] = '\0';
+            if (!procfs_parse_stat(data, &cmd, &cmdlen, &state, fields, 21)) {
+                continue;
+            }
+            ++total;
+            threads += fields[20];
+            switch (state) {
+            case 'R':
+                ++running;
+                break;
+            case 'S':
+                ++sleeping;
+                break;
+            case 'T':
+            case 't':
+                ++stopped;
+                break;
+            case 'Z':
+                ++zombie;
+                break;
+            case 'D':
+            case 'I':
+                ++idle;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &log_group, 1, OPAL_BOOL))) {
+        return rc;
+    }
+    if (false == log_group)
+        return ORCM_ERR_SENSOR_READ_FAIL;
+
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &total, 1, OPAL_INT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &sleeping, 1, OPAL_INT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &running, 1, OPAL_INT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &zombie, 1, OPAL_INT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &stopped, 1, OPAL_INT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &idle, 1, OPAL_INT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &threads, 1, OPAL_INT64))) {
+        return rc;
+    }
+
+    return ORCM_SUCCESS;
+}
+
+static sensor_procfs_proc_t *procfs_open_proc(pid_t pid)
+{
+    sensor_procfs_proc_t *proc;
+    char path[64];
+
+    OPAL_LIST_FOREACH(proc, &proclist, sensor_procfs_proc_t) {
+        if (pid == proc->pid) {
+            return proc;
+        }
+    }
+    proc = OBJ_NEW(sensor_procfs_proc_t);
+    proc->pid = pid;
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    if (0 > (proc->stat_fd = open(path, O_RDONLY))) {
+        OBJ_RELEASE(proc);
+        return NULL;
+    }
+    snprintf(path, sizeof(path), "/proc/%d/statm", pid);
+    proc->statm_fd = open(path, O_RDONLY);
+    opal_list_append(&proclist, &proc->super);
+    return proc;
+}
+
+/* sample one process through its held descriptors */
+static int procfs_collect_proc(opal_buffer_t *dataptr, sensor_procfs_proc_t *proc,
+                               struct timeval *now)
+{
+    int rc;
+    char data[1024], *cmd, *cur, state;
+    size_t cmdlen;
+    ssize_t len;
+    int64_t fields[40];
+    int64_t share = 0, minor_faults, major_faults, page_faults;
+    uint64_t ticks;
+    double elapsed, percent = 0.0;
+    opal_pstats_t stats, *stptr;
+    bool log_group = true;
+
+    memset(fields, 0, sizeof(fields));
+    if (0 >= (len = pread(proc->stat_fd, data, sizeof(data) - 1, 0))) {
+        /* the process is gone */
+        return ORCM_ERR_SENSOR_READ_FAIL;
+    }
+    data[len] = '\0';
+    if (!procfs_parse_stat(data, &cmd, &cmdlen, &state, fields, 40)) {
+        return ORCM_ERR_SENSOR_READ_FAIL;
+    }
+    /* take the command out of the buffer before it is reused */
+    OBJ_CONSTRUCT(&stats, opal_pstats_t);
+    if (cmdlen >= sizeof(stats.cmd)) {
+        cmdlen = sizeof(stats.cmd) - 1;
+    }
+    memcpy(stats.cmd, cmd, cmdlen);
+    stats.cmd[cmdlen] = '\0';
+    if (0 <= proc->statm_fd && 0 < (len = pread(proc->statm_fd, data, sizeof(data) - 1, 0))) {
+        data[len] = '\0';
+        cur = data;
+        (void)scan_u64(&cur);
+        (void)scan_u64(&cur);
+        share = (int64_t)scan_u64(&cur) * page_size;
+    }
+
+    /* utime + stime, as a fraction of the wall time since last time */
+    ticks = (uint64_t)(fields[14] + fields[15]);
+    if (0 != proc->last.tv_sec) {
+        elapsed = (double)(now->tv_sec - proc->last.tv_sec) +
+                  (double)(now->tv_usec - proc->last.tv_usec) / 1000000.0;
+        if (0.0 < elapsed) {
+            percent = (double)metric_diff_calc(ticks, proc->cpu_ticks, "process", "cpu ticks") /
+                      (double)clk_tck / elapsed;
+        }
+    }
+    proc->cpu_ticks = ticks;
+    proc->last = *now;
+    minor_faults = fields[10];
+    major_faults = fields[12];
+    page_faults = minor_faults + major_faults;
+
+    stats.pid = proc->pid;
+    stats.state[0] = state;
+    stats.state[1] = '\0';
+    stats.percent_cpu = (float)(percent * 100.0);
+    stats.priority = (int32_t)fields[18];
+    stats.num_threads = (int16_t)fields[20];
+    stats.vsize = (float)fields[23];
+    stats.rss = (float)(fields[24] * page_size);
+    stats.processor = (int16_t)fields[39];
+    stats.rank = 0;
+
+    stptr = &stats;
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &log_group, 1, OPAL_BOOL)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &stptr, 1, OPAL_PSTAT))) {
+        OBJ_DESTRUCT(&stats);
+        return rc;
+    }
+    OBJ_DESTRUCT(&stats);
+
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &share, 1, OPAL_INT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &minor_faults, 1, OPAL_INT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &major_faults, 1, OPAL_INT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &page_faults, 1, OPAL_INT64))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(dataptr, &percent, 1, OPAL_DOUBLE))) {
+        return rc;
+    }
+    return ORCM_SUCCESS;
+}
+
+static int procfs_collect_procstat(opal_buffer_t *dataptr)
+{
+    int rc = ORCM_SUCCESS;
+    sensor_procfs_proc_t *proc, *next;
+    struct timeval now;
+    pid_t sample_pid;
+    int i, remaining_procs;
+    orte_proc_t *child;
+
+    if (NULL != orte_local_children) {
+        remaining_procs = orte_local_children->size+1;
+    } else {
+        remaining_procs = 1;
+    }
+
+    ++proc_pass;
+    gettimeofday(&now, NULL);
+    for (i=0; i < remaining_procs; i++) {
+        if (0 == i) {
+            sample_pid = orte_process_info.pid;
+        } else {
+            if (NULL == (child = (orte_proc_t*)opal_pointer_array_get_item(orte_local_children, i))) {
+                continue;
+            }
+            if (!ORTE_FLAG_TEST(child, ORTE_PROC_FLAG_ALIVE)) {
+                continue;
+            }
+            if (0 == child->pid) {
+                /* race condition */
+                continue;
+            }
+            sample_pid = child->pid;
+        }
+        if (NULL == (proc = procfs_open_proc(sample_pid))) {
+            continue;
+        }
+        proc->pass = proc_pass;
+        if (ORCM_ERR_SENSOR_READ_FAIL == (rc = procfs_collect_proc(dataptr, proc, &now))) {
+            /* drop the descriptors so a reused pid is reopened */
+            proc->pass = 0;
+            rc = ORCM_SUCCESS;
+        } else if (ORCM_SUCCESS != rc) {
+            break;
+        }
+    }
+
+    /* close whatever we are no longer watching */
+    OPAL_LIST_FOREACH_SAFE(proc, next, &proclist, sensor_procfs_proc_t) {
+        if (proc_pass != proc->pass) {
+            opal_list_remove_item(&proclist, &proc->super);
+            OBJ_RELEASE(proc);
+        }
+    }
+
+    return rc;
+}
+
+static int procfs_collect_proc_group(opal_buffer_t *dataptr, double tdiff)
+{
+    int rc;
+
+    if (ORCM_ERR_SENSOR_READ_FAIL == (rc = procfs_collect_global_procstat(dataptr))) {
+        ORTE_ERROR_LOG(rc);
+    } else if (ORCM_SUCCESS != rc) {
+        return rc;
+    }
+    return procfs_collect_procstat(dataptr);
+}
+
+/* the collectors, in the order sigar packs its groups */
+static const struct {
+    bool *enabled;
+    int (*collect)(opal_buffer_t *dataptr, double tdiff);
+} collectors[] = {
+    {&mca_sensor_procfs_component.mem, procfs_collect_mem},
+    {&mca_sensor_procfs_component.swap, procfs_collect_swap},
+    {&mca_sensor_procfs_component.cpu, procfs_collect_cpu},
+    {&mca_sensor_procfs_component.load, procfs_collect_load},
+    {&mca_sensor_procfs_component.disk, procfs_collect_disk},
+    {&mca_sensor_procfs_component.network, procfs_collect_network},
+    {&mca_sensor_procfs_component.sys, procfs_collect_system},
+    {&mca_sensor_procfs_component.proc, procfs_collect_proc_group}
+};
+
+static void procfs_sample(orcm_sensor_sampler_t *sampler)
+{
+    opal_output_verbose(5, orcm_sensor_base_framework.framework_output,
+                            "%s sensor procfs : procfs_sample: called",
+                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
+    if (!mca_sensor_procfs_component.use_progress_thread) {
+       collect_sample(sampler);
+    }
+
+}
+
+static void perthread_procfs_sample(int fd, short args, void *cbdata)
+{
+    orcm_sensor_sampler_t *sampler = (orcm_sensor_sampler_t*)cbdata;
+
+    opal_output_verbose(5, orcm_sensor_base_framework.framework_output,
+                            "%s sensor procfs : perthread_procfs_sample: called",
+                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
+
+    /* this has fired in the sampler thread, so we are okay to
+     * just go ahead and sample since we do NOT allow both the
+     * base thread and the component thread to both be actively
+     * calling this component */
+    collect_sample(sampler);
+    /* we now need to push the results into the base event thread
+     * so it can add the data to the base bucket */
+    ORCM_SENSOR_XFER(&sampler->bucket);
+    /* clear the bucket */
+    OBJ_DESTRUCT(&sampler->bucket);
+    OBJ_CONSTRUCT(&sampler->bucket, opal_buffer_t);
+    /* check if procfs sample rate is provided for this*/
+    if (mca_sensor_procfs_component.sample_rate != sampler->rate.tv_sec) {
+        sampler->rate.tv_sec = mca_sensor_procfs_component.sample_rate;
+    }
+    /* set ourselves to sample again */
+    opal_event_evtimer_add(&sampler->ev, &sampler->rate);
+}
+
+static void collect_sample(orcm_sensor_sampler_t *sampler)
+{
+    opal_buffer_t data, *bptr;
+    int rc;
+    size_t i;
+    time_t now;
+    double tdiff;
+    char *ctmp;
+    bool log_group=false;
+    struct timeval current_time;
+
+    if (mca_sensor_procfs_component.test) {
+        /* just send the test vector */
+        bptr = &test_vector;
+        opal_dss.pack(&sampler->bucket, &bptr, 1, OPAL_BUFFER);
+        return;
+    }
+
+    /* prep the buffer to collect the data */
+    OBJ_CONSTRUCT(&data, opal_buffer_t);
+    /* pack our name */
+    ctmp = strdup("procfs");
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(&data, &ctmp, 1, OPAL_STRING))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_DESTRUCT(&data);
+        free(ctmp);
+        return;
+    }
+    free(ctmp);
+    /* include our node name */
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(&data, &orte_process_info.nodename, 1, OPAL_STRING))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_DESTRUCT(&data);
+        return;
+    }
+
+    /* get the sample time */
+    now = time(NULL);
+    tdiff = difftime(now, last_sample);
+    if (0.0 >= tdiff) {
+        tdiff = 1.0;
+    }
+    gettimeofday(&current_time, NULL);
+
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(&data, &current_time, 1, OPAL_TIMEVAL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_DESTRUCT(&data);
+        return;
+    }
+
+    /* the memory and swap groups both come from /proc/meminfo */
+    meminfo_valid = false;
+    if (mca_sensor_procfs_component.mem || mca_sensor_procfs_component.swap) {
+        meminfo_valid = procfs_read_meminfo(&meminfo);
+    }
+
+    for (i=0; i < PROCFS_NUM(collectors); i++) {
+        if (*collectors[i].enabled) {
+            if (ORCM_ERR_SENSOR_READ_FAIL == (rc = collectors[i].collect(&data, tdiff))) {
+                ORTE_ERROR_LOG(rc);
+            } else if (ORCM_SUCCESS != rc) {
+                OBJ_DESTRUCT(&data);
+                ORTE_ERROR_LOG(rc);
+                return;
+            }
+        } else {
+            log_group = false;
+            if (OPAL_SUCCESS != (rc = opal_dss.pack(&data, &log_group, 1, OPAL_BOOL))) {
+                ORTE_ERROR_LOG(rc);
+                OBJ_DESTRUCT(&data);
+                return;
+            }
+        }
+    }
+
+    /* No More process stats to pack - So pack the final marker*/
+    log_group = false;
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(&data, &log_group, 1, OPAL_BOOL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_DESTRUCT(&data);
+        return;
+    }
+
+    /* xfer the data for transmission - need at least one prior sample before doing so */
+    if (0 < last_sample) {
+        bptr = &data;
+        if (OPAL_SUCCESS != (rc = opal_dss.pack(&sampler->bucket, &bptr, 1, OPAL_BUFFER))) {
+            ORTE_ERROR_LOG(rc);
+            OBJ_DESTRUCT(&data);
+            return;
+        }
+    }
+    OBJ_DESTRUCT(&data);
+    last_sample = now;
+}
+
+/* send one metric to analytics, keyed like the rest of its group */
+static int procfs_log_item(orcm_value_batch_t *batch, opal_list_t *key,
+                           opal_list_t *non_compute_data, const char *sample_key,
+                           void *sample_item, opal_data_type_t type, const char *units)
+{
+    orcm_value_t *sensor_metric = NULL;
+    orcm_analytics_value_t *analytics_vals = NULL;
+    opal_list_t *compute_data;
+
+    if (NULL == (compute_data = orcm_value_batch_new_list(batch))) {
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    analytics_vals = orcm_util_load_orcm_analytics_value(key, non_compute_data, compute_data);
+    OBJ_RELEASE(compute_data);
+    if ((NULL == analytics_vals) || (NULL == analytics_vals->key) ||
+         (NULL == analytics_vals->non_compute_data) ||(NULL == analytics_vals->compute_data)) {
+        if (NULL != analytics_vals) {
+            OBJ_RELEASE(analytics_vals);
+        }
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+
+    sensor_metric = orcm_value_batch_load(batch, sample_key, sample_item, type, units);
+    if (NULL == sensor_metric) {
+        OBJ_RELEASE(analytics_vals);
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+
+    opal_list_append(analytics_vals->compute_data, (opal_list_item_t *)sensor_metric);
+    orcm_analytics.send_data(analytics_vals);
+    OBJ_RELEASE(analytics_vals);
+    return ORCM_SUCCESS;
+}
+
+/* unpack the next value of a group and send it on */
+static int procfs_log_metric(opal_buffer_t *sample, orcm_value_batch_t *batch,
+                             opal_list_t *key, opal_list_t *non_compute_data,
+                             const procfs_metric_t *metric)
+{
+    union {
+        uint64_t u64;
+        int64_t i64;
+        float fval;
+        double dval;
+    } value;
+    int32_t n = 1;
+    int rc;
+
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &value, &n, metric->type))) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+    if (ORCM_SUCCESS != (rc = procfs_log_item(batch, key, non_compute_data, metric->key,
+                                              &value, metric->type, metric->units))) {
+        ORTE_ERROR_LOG(rc);
+    }
+    return rc;
+}
+
+/* the hostname/data_group key and ctime shared by a group's metrics */
+static int procfs_log_keys(orcm_value_batch_t *batch, const char *hostname,
+                           const char *data_group, struct timeval *sampletime,
+                           opal_list_t **key, opal_list_t **non_compute_data)
+{
+    orcm_value_t *sensor_metric;
+
+    if (NULL == (*key = orcm_value_batch_new_list(batch)) ||
+        NULL == (*non_compute_data = orcm_value_batch_new_list(batch))) {
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+
+    sensor_metric = orcm_value_batch_load(batch, "ctime", sampletime, OPAL_TIMEVAL, NULL);
+    if (NULL == sensor_metric) {
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    opal_list_append(*non_compute_data, (opal_list_item_t *)sensor_metric);
+
+    sensor_metric = orcm_value_batch_load(batch, "hostname", (void*)hostname, OPAL_STRING, NULL);
+    if (NULL == sensor_metric) {
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    opal_list_append(*key, (opal_list_item_t *)sensor_metric);
+
+    sensor_metric = orcm_value_batch_load(batch, "data_group", (void*)data_group, OPAL_STRING, NULL);
+    if (NULL == sensor_metric) {
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    opal_list_append(*key, (opal_list_item_t *)sensor_metric);
+    return ORCM_SUCCESS;
+}
+
+static void procfs_log_cleanup(opal_list_t **key, opal_list_t **non_compute_data)
+{
+    if (NULL != *key) {
+        OBJ_RELEASE(*key);
+        *key = NULL;
+    }
+    if (NULL != *non_compute_data) {
+        OBJ_RELEASE(*non_compute_data);
+        *non_compute_data = NULL;
+    }
+}
+
+static int procfs_log_process_lvl_stats(opal_buffer_t *sample, orcm_value_batch_t *batch,
+                                        struct timeval *sampletime, const char *hostname)
+{
+    opal_list_t *key = NULL;
+    opal_list_t *non_compute_data = NULL;
+    char state[3];
+    char primary_key[sizeof("procstat_") + OPAL_PSTAT_MAX_STRING_LEN];
+    opal_pstats_t *st = NULL;
+    bool log_group = false;
+    size_t i;
+    int n;
+    int rc;
+
+    /* Check if any process level stats are being sent */
+    n=1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &log_group, &n, OPAL_BOOL))) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+    while (log_group) {
+        n=1;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &st, &n, OPAL_PSTAT))) {
+            ORTE_ERROR_LOG(rc);
+            break;
+        }
+        snprintf(primary_key, sizeof(primary_key), "procstat_%s", st->cmd);
+        if (ORCM_SUCCESS != (rc = procfs_log_keys(batch, hostname, primary_key, sampletime,
+                                                  &key, &non_compute_data))) {
+            ORTE_ERROR_LOG(rc);
+            break;
+        }
+        snprintf(state, sizeof(state), "%s", st->state);
+
+        if (ORCM_SUCCESS != (rc = procfs_log_item(batch, key, non_compute_data, "pid", &st->pid, OPAL_PID, NULL)) ||
+            ORCM_SUCCESS != (rc = procfs_log_item(batch, key, non_compute_data, "cmd", st->cmd, OPAL_STRING, NULL)) ||
+            ORCM_SUCCESS != (rc = procfs_log_item(batch, key, non_compute_data, "state", state, OPAL_STRING, NULL)) ||
+            ORCM_SUCCESS != (rc = procfs_log_item(batch, key, non_compute_data, "percent_cpu", &st->percent_cpu, OPAL_FLOAT, NULL)) ||
+            ORCM_SUCCESS != (rc = procfs_log_item(batch, key, non_compute_data, "priority", &st->priority, OPAL_INT32, NULL)) ||
+            ORCM_SUCCESS != (rc = procfs_log_item(batch, key, non_compute_data, "num_threads", &st->num_threads, OPAL_INT16, NULL)) ||
+            ORCM_SUCCESS != (rc = procfs_log_item(batch, key, non_compute_data, "vsize", &st->vsize, OPAL_FLOAT, "Bytes")) ||
+            ORCM_SUCCESS != (rc = procfs_log_item(batch, key, non_compute_data, "rss", &st->rss, OPAL_FLOAT, "Bytes")) ||
+            ORCM_SUCCESS != (rc = procfs_log_item(batch, key, non_compute_data, "processor", &st->processor, OPAL_INT16, NULL))) {
+            ORTE_ERROR_LOG(rc);
+            break;
+        }
+        OBJ_RELEASE(st);
+        st = NULL;
+
+        for (i=0; i < PROCFS_NUM(proc_metrics); i++) {
+            if (ORCM_SUCCESS != (rc = procfs_log_metric(sample, batch, key, non_compute_data,
+                                                        &proc_metrics[i]))) {
+                break;
+            }
+        }
+        procfs_log_cleanup(&key, &non_compute_data);
+        if (ORCM_SUCCESS != rc) {
+            break;
+        }
+
+        n=1;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &log_group, &n, OPAL_BOOL))) {
+            ORTE_ERROR_LOG(rc);
+            break;
+        }
+    }
+
+    procfs_log_cleanup(&key, &non_compute_data);
+    if (NULL != st) {
+        OBJ_RELEASE(st);
+    }
+    return rc;
+}
+
+static void procfs_log(opal_buffer_t *sample)
+{
+    const char *hostname = NULL;
+    int rc;
+    int32_t n;
+    size_t grp, i;
+    bool log_group = false;
+    struct timeval sampletime;
+    orcm_value_batch_t *batch = NULL;
+    opal_list_t *key = NULL;
+    opal_list_t *non_compute_data = NULL;
+
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &hostname, NULL))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+
+    opal_output_verbose(3, orcm_sensor_base_framework.framework_output,
+                        "%s Received log from host %s",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                        (NULL == hostname) ? "NULL" : hostname);
+
+    /* sample time */
+    n=1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &sampletime, &n, OPAL_TIMEVAL))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+
+    /* every value of the sample, process entries included, comes
+     * out of one batch */
+    if (NULL == (batch = OBJ_NEW(orcm_value_batch_t))) {
+        ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
+        return;
+    }
+
+    if (ORCM_SUCCESS != (rc = procfs_log_keys(batch, hostname, "sigar", &sampletime,
+                                              &key, &non_compute_data))) {
+        ORTE_ERROR_LOG(rc);
+        goto cleanup;
+    }
+    for (grp=0; grp < PROCFS_NUM(node_groups); grp++) {
+        n=1;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &log_group, &n, OPAL_BOOL))) {
+            ORTE_ERROR_LOG(rc);
+            goto cleanup;
+        }
+        if (!log_group) {
+            continue;
+        }
+        for (i=0; i < node_groups[grp].num; i++) {
+            if (ORCM_SUCCESS != procfs_log_metric(sample, batch, key, non_compute_data,
+                                                  &node_groups[grp].metrics[i])) {
+                goto cleanup;
+            }
+        }
+    }
+    procfs_log_cleanup(&key, &non_compute_data);
+
+    /* the node-wide process counts */
+    n=1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &log_group, &n, OPAL_BOOL))) {
+        ORTE_ERROR_LOG(rc);
+        goto cleanup;
+    }
+    if (log_group) {
+        if (ORCM_SUCCESS != (rc = procfs_log_keys(batch, hostname, "procstat", &sampletime,
+                                                  &key, &non_compute_data))) {
+            ORTE_ERROR_LOG(rc);
+            goto cleanup;
+        }
+        for (i=0; i < PROCFS_NUM(procstat_metrics); i++) {
+            if (ORCM_SUCCESS != procfs_log_metric(sample, batch, key, non_compute_data,
+                                                  &procstat_metrics[i])) {
+                goto cleanup;
+            }
+        }
+        procfs_log_cleanup(&key, &non_compute_data);
+    }
+
+    procfs_log_process_lvl_stats(sample, batch, &sampletime, hostname);
+
+cleanup:
+    procfs_log_cleanup(&key, &non_compute_data);
+    OBJ_RELEASE(batch);
+}
+
+/* Helper function to calculate the metric differences */
+static uint64_t metric_diff_calc(uint64_t newval, uint64_t oldval,
+                                 const char *name_for_log,
+                                 const char *value_name_for_log)
+{
+    uint64_t diff;
+
+    if (newval < oldval) {
+        /* assume that the value was reset and we are starting over */
+        opal_output_verbose(3, orcm_sensor_base_framework.framework_output,
+                            "%s metric_diff_calc: new value %" PRIu64 " is less than old value %" PRIu64
+                            " for %s metric %s; assume the value was reset and set diff to new value.",
+                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                            newval, oldval, name_for_log, value_name_for_log);
+        diff = newval;
+    } else {
+        diff = newval - oldval;
+    }
+
+    return diff;
+}
+
+/* pack a value of the given type, counting up from the last one */
+static void pack_test_value(opal_buffer_t *v, opal_data_type_t type, uint64_t *count)
+{
+    uint64_t ui64;
+    int64_t i64;
+    float ft;
+    double d;
+
+    ++(*count);
+    switch (type) {
+    case OPAL_UINT64:
+        ui64 = *count;
+        opal_dss.pack(v, &ui64, 1, OPAL_UINT64);
+        break;
+    case OPAL_INT64:
+        i64 = (int64_t)*count;
+        opal_dss.pack(v, &i64, 1, OPAL_INT64);
+        break;
+    case OPAL_FLOAT:
+        ft = (float)*count;
+        opal_dss.pack(v, &ft, 1, OPAL_FLOAT);
+        break;
+    case OPAL_DOUBLE:
+        d = (double)*count;
+        opal_dss.pack(v, &d, 1, OPAL_DOUBLE);
+        break;
+    default:
+        break;
+    }
+}
+
+static void generate_test_vector(opal_buffer_t *v)
+{
+    char *ctmp;
+    uint64_t count = 0;
+    size_t grp, i;
+    struct timeval current_time;
+    bool log_group = true;
+
+    ctmp = strdup("procfs");
+    opal_dss.pack(v, &ctmp, 1, OPAL_STRING);
+    free(ctmp);
+    opal_dss.pack(v, &orte_process_info.nodename, 1, OPAL_STRING);
+    /* get the time so it will be unique each time */
+    gettimeofday(&current_time, NULL);
+    opal_dss.pack(v, &current_time, 1, OPAL_TIMEVAL);
+
+    /* every node group, then the process counts */
+    for (grp=0; grp < PROCFS_NUM(node_groups); grp++) {
+        opal_dss.pack(v, &log_group, 1, OPAL_BOOL);
+        for (i=0; i < node_groups[grp].num; i++) {
+            pack_test_value(v, node_groups[grp].metrics[i].type, &count);
+        }
+    }
+    opal_dss.pack(v, &log_group, 1, OPAL_BOOL);
+    for (i=0; i < PROCFS_NUM(procstat_metrics); i++) {
+        pack_test_value(v, procstat_metrics[i].type, &count);
+    }
+
+    /* no per-process entries */
+    log_group = false;
+    opal_dss.pack(v, &log_group, 1, OPAL_BOOL);
+}
+
+static void procfs_set_sample_rate(int sample_rate)
+{
+    /* set the procfs sample rate if seperate thread is enabled */
+    if (mca_sensor_procfs_component.use_progress_thread) {
+        mca_sensor_procfs_component.sample_rate = sample_rate;
+    }
+    return;
+}
+
+static void procfs_get_sample_rate(int *sample_rate)
+{
+    if (NULL != sample_rate) {
+        /* check if procfs sample rate is provided for this*/
+        *sample_rate = mca_sensor_procfs_component.sample_rate;
+    }
+    return;
+}
+
+/* inventory entries are numbered as sigar numbers them, so the two
+ * components describe their common metrics identically */
+static int procfs_inventory_pack(opal_buffer_t *inventory_snapshot,
+                                 unsigned int item, const char *name)
+{
+    char *comp = NULL;
+    int rc;
+
+    asprintf(&comp, "sensor_sigar_%u", item);
+    if (NULL == comp) {
+        ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(inventory_snapshot, &comp, 1, OPAL_STRING))) {
+        ORTE_ERROR_LOG(rc);
+        free(comp);
+        return rc;
+    }
+    free(comp);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(inventory_snapshot, &name, 1, OPAL_STRING))) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+    return ORCM_SUCCESS;
+}
+
+static void procfs_inventory_collect(opal_buffer_t *inventory_snapshot)
+{
+    static const char *pstat_names[] = {
+        "pid", "cmd", "state", "percent_cpu", "priority",
+        "num_threads", "vsize", "rss", "processor"
+    };
+    char *comp = strdup("procfs");
+    unsigned int tot_items, item = 0;
+    size_t grp, i;
+    int rc = OPAL_SUCCESS;
+
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(inventory_snapshot, &comp, 1, OPAL_STRING))) {
+        ORTE_ERROR_LOG(rc);
+        free(comp);
+        return;
+    }
+    free(comp);
+
+    /* the hostname, then every metric we log */
+    tot_items = 1 + PROCFS_NUM(procstat_metrics) + PROCFS_NUM(pstat_names) +
+                PROCFS_NUM(proc_metrics);
+    for (grp=0; grp < PROCFS_NUM(node_groups); grp++) {
+        tot_items += node_groups[grp].num;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(inventory_snapshot, &tot_items, 1, OPAL_UINT))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+
+    /* store our hostname */
+    comp = strdup("hostname");
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(inventory_snapshot, &comp, 1, OPAL_STRING))) {
+        ORTE_ERROR_LOG(rc);
+        free(comp);
+        return;
+    }
+    free(comp);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(inventory_snapshot, &orte_process_info.nodename, 1, OPAL_STRING))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+
+    for (grp=0; grp < PROCFS_NUM(node_groups); grp++) {
+        for (i=0; i < node_groups[grp].num; i++) {
+            if (ORCM_SUCCESS != procfs_inventory_pack(inventory_snapshot, ++item,
+                                                      node_groups[grp].metrics[i].key)) {
+                return;
+            }
+        }
+    }
+    for (i=0; i < PROCFS_NUM(procstat_metrics); i++) {
+        if (ORCM_SUCCESS != procfs_inventory_pack(inventory_snapshot, ++item,
+                                                  procstat_metrics[i].key)) {
+            return;
+        }
+    }
+    for (i=0; i < PROCFS_NUM(pstat_names); i++) {
+        if (ORCM_SUCCESS != procfs_inventory_pack(inventory_snapshot, ++item,
+                                                  pstat_names[i])) {
+            return;
+        }
+    }
+    for (i=0; i < PROCFS_NUM(proc_metrics); i++) {
+        if (ORCM_SUCCESS != procfs_inventory_pack(inventory_snapshot, ++item,
+                                                  proc_metrics[i].key)) {
+            return;
+        }
+    }
+}
+
+static void procfs_inventory_log(char *hostname, opal_buffer_t *inventory_snapshot)
+{
+    unsigned int tot_items = 0;
+    int n = 1;
+    opal_list_t *records = NULL;
+    int rc = OPAL_SUCCESS;
+
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(inventory_snapshot, &tot_items, &n, OPAL_UINT))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+    records = OBJ_NEW(opal_list_t);
+    while(tot_items > 0) {
+        char *inv = NULL;
+        char *inv_val = NULL;
+        orcm_value_t *mkv = NULL;
+
+        n=1;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(inventory_snapshot, &inv, &n, OPAL_STRING))) {
+            ORTE_ERROR_LOG(rc);
+            OBJ_RELEASE(records);
+            return;
+        }
+        n=1;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(inventory_snapshot, &inv_val, &n, OPAL_STRING))) {
+            ORTE_ERROR_LOG(rc);
+            free(inv);
+            OBJ_RELEASE(records);
+            return;
+        }
+
+        mkv = OBJ_NEW(orcm_value_t);
+        mkv->value.key = inv;
+        mkv->value.type = OPAL_STRING;
+        mkv->value.data.string = inv_val;
+        opal_list_append(records, (opal_list_item_t*)mkv);
+
+        --tot_items;
+    }
+    orcm_sensor_base_inventory_store(hostname, "procfs", records);
+}
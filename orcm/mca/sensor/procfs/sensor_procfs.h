@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ *
+ * $COPYRIGHT$
+ * 
+ * Additional copyrights may follow
+ * 
+ * $HEADER$
+ */
+/**
+ * @file
+ *
+ * Native /proc resource sensor
+ *
+ * Collects the node and process metrics of the sigar sensor straight
+ * from /proc, without going through libsigar. The samples are logged
+ * under the same data groups and keys as sigar's.
+ */
+#ifndef ORCM_SENSOR_PROCFS_H
+#define ORCM_SENSOR_PROCFS_H
+
+#include "orcm_config.h"
+
+#include "orcm/mca/sensor/sensor.h"
+
+BEGIN_C_DECLS
+
+typedef struct {
+    orcm_sensor_base_component_t super;
+    bool test;
+    bool mem;
+    bool swap;
+    bool cpu;
+    bool load;
+    bool disk;
+    bool network;
+    bool sys;
+    bool proc;
+    bool use_progress_thread;
+    int sample_rate;
+} orcm_sensor_procfs_component_t;
+
+typedef struct {
+    opal_event_base_t *ev_base;
+    bool ev_active;
+    int sample_rate;
+} orcm_sensor_procfs_t;
+
+ORCM_MODULE_DECLSPEC extern orcm_sensor_procfs_component_t mca_sensor_procfs_component;
+extern orcm_sensor_base_module_t orcm_sensor_procfs_module;
+
+
+END_C_DECLS
+
+#endif
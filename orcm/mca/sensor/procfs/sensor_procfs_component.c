@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#include "opal/mca/base/base.h"
+#include "opal/mca/base/mca_base_var.h"
+
+#include "orcm/mca/sensor/base/sensor_private.h"
+#include "sensor_procfs.h"
+
+/*
+ * Local functions
+ */
+
+static int orcm_sensor_procfs_open(void);
+static int orcm_sensor_procfs_close(void);
+static int orcm_sensor_procfs_query(mca_base_module_t **module, int *priority);
+static int procfs_component_register(void);
+
+orcm_sensor_procfs_component_t mca_sensor_procfs_component = {
+    {
+        {
+            ORCM_SENSOR_BASE_VERSION_1_0_0,
+            /* Component name and version */
+            .mca_component_name = "procfs",
+            MCA_BASE_MAKE_VERSION(component, ORCM_MAJOR_VERSION, ORCM_MINOR_VERSION,
+                                  ORCM_RELEASE_VERSION),
+
+            /* Component open and close functions */
+            .mca_open_component = orcm_sensor_procfs_open,
+            .mca_close_component = orcm_sensor_procfs_close,
+            .mca_query_component = orcm_sensor_procfs_query,
+            .mca_register_component_params = procfs_component_register
+        },
+        .base_data = {
+            /* The component is checkpoint ready */
+            MCA_BASE_METADATA_PARAM_CHECKPOINT
+        },
+        "procresource,noderesource"
+    }
+};
+
+/**
+  * component open/close/init function
+  */
+static int orcm_sensor_procfs_open(void)
+{
+    return ORCM_SUCCESS;
+}
+
+static int orcm_sensor_procfs_query(mca_base_module_t **module, int *priority)
+{
+    /* if we can build, then we definitely want to be used
+     * even if we aren't going to sample as we have to be
+     * present in order to log any received results
+     */
+    *priority = 160;  /* ahead of sigar, which measures the same data */
+    *module = (mca_base_module_t *)&orcm_sensor_procfs_module;
+    return ORCM_SUCCESS;
+}
+
+/**
+ *  Close all subsystems.
+ */
+
+static int orcm_sensor_procfs_close(void)
+{
+    return ORCM_SUCCESS;
+}
+
+static int procfs_component_register(void)
+{
+    mca_base_component_t *c = &mca_sensor_procfs_component.super.base_version;
+
+    mca_sensor_procfs_component.test = false;
+    (void) mca_base_component_var_register (c, "test",
+                                            "Generate and pass test vector",
+                                            MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            & mca_sensor_procfs_component.test);
+    mca_sensor_procfs_component.mem = true;
+    (void) mca_base_component_var_register (c, "mem",
+                                            "Enable collecting memory usage",
+                                            MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            & mca_sensor_procfs_component.mem);
+    mca_sensor_procfs_component.swap = true;
+    (void) mca_base_component_var_register (c, "swap",
+                                            "Enable collecting swap usage",
+                                            MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            & mca_sensor_procfs_component.swap);
+    mca_sensor_procfs_component.cpu = true;
+    (void) mca_base_component_var_register (c, "cpu",
+                                            "Enable collecting cpu usage",
+                                            MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            & mca_sensor_procfs_component.cpu);
+    mca_sensor_procfs_component.load = true;
+    (void) mca_base_component_var_register (c, "load",
+                                            "Enable collecting cpu load",
+                                            MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            & mca_sensor_procfs_component.load);
+    mca_sensor_procfs_component.disk = true;
+    (void) mca_base_component_var_register (c, "disk",
+                                            "Enable collecting disk usage",
+                                            MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            & mca_sensor_procfs_component.disk);
+    mca_sensor_procfs_component.network = true;
+    (void) mca_base_component_var_register (c, "network",
+                                            "Enable collecting network usage",
+                                            MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            & mca_sensor_procfs_component.network);
+    mca_sensor_procfs_component.sys = true;
+    (void) mca_base_component_var_register (c, "sys",
+                                            "Enable collecting system information like uptime",
+                                            MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            & mca_sensor_procfs_component.sys);
+    mca_sensor_procfs_component.proc = true;
+    (void) mca_base_component_var_register (c, "proc",
+                                            "Enable collecting process information of daemon and child processes",
+                                            MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                            OPAL_INFO_LVL_9,
+                                            MCA_BASE_VAR_SCOPE_READONLY,
+                                            & mca_sensor_procfs_component.proc);
+    mca_sensor_procfs_component.use_progress_thread = false;
+    (void) mca_base_component_var_register(c, "use_progress_thread",
+                                           "Use a dedicated progress thread for procfs sampling [default: false]",
+                                           MCA_BASE_VAR_TYPE_BOOL, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_sensor_procfs_component.use_progress_thread);
+
+    mca_sensor_procfs_component.sample_rate = 0;
+    (void) mca_base_component_var_register(c, "sample_rate",
+                                           "Sample rate in seconds",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_sensor_procfs_component.sample_rate);
+
+    return ORCM_SUCCESS;
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ *
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/**
+ * @file
+ *
+ * Parsers for the /proc text the procfs sensor reads
+ *
+ * They only touch the text they are handed, so they can be checked
+ * against canned file contents without a running system.
+ */
+#ifndef ORCM_SENSOR_PROCFS_PARSE_H
+#define ORCM_SENSOR_PROCFS_PARSE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* the /proc/meminfo values the sensor uses, in bytes */
+typedef struct {
+    uint64_t total;
+    uint64_t free;
+    uint64_t buffers;
+    uint64_t cached;
+    uint64_t swap_total;
+    uint64_t swap_free;
+} procfs_meminfo_t;
+
+/* The scanners below work on the read buffer in place: each takes a
+ * cursor, converts what is under it and leaves the cursor just past it.
+ */
+static inline void scan_blanks(char **cur)
+{
+    char *ptr = *cur;
+
+    while (' ' == *ptr || '\t' == *ptr) {
+        ptr++;
+    }
+    *cur = ptr;
+}
+
+static inline uint64_t scan_u64(char **cur)
+{
+    char *ptr;
+    uint64_t val = 0;
+
+    scan_blanks(cur);
+    for (ptr = *cur; '0' <= *ptr && *ptr <= '9'; ptr++) {
+        val = val * 10 + (uint64_t)(*ptr - '0');
+    }
+    *cur = ptr;
+    return val;
+}
+
+static inline int64_t scan_i64(char **cur)
+{
+    bool neg = false;
+
+    scan_blanks(cur);
+    if ('-' == **cur) {
+        neg = true;
+        (*cur)++;
+    }
+    return neg ? -(int64_t)scan_u64(cur) : (int64_t)scan_u64(cur);
+}
+
+/* return the next whitespace-delimited word, setting its length */
+static inline char *scan_word(char **cur, size_t *len)
+{
+    char *start, *ptr;
+
+    scan_blanks(cur);
+    start = ptr = *cur;
+    while ('\0' != *ptr && ' ' != *ptr && '\t' != *ptr && '\n' != *ptr) {
+        ptr++;
+    }
+    *len = (size_t)(ptr - start);
+    *cur = ptr;
+    return start;
+}
+
+/* step to the start of the next line - false at the end of the data */
+static inline bool scan_line(char **cur)
+{
+    char *ptr;
+
+    if (NULL == (ptr = strchr(*cur, '\n'))) {
+        return false;
+    }
+    *cur = ptr + 1;
+    return '\0' != **cur;
+}
+
+/* if the line under the cursor starts with tag, step over it */
+static inline bool scan_tag(char **cur, const char *tag, size_t len)
+{
+    if (0 != strncmp(*cur, tag, len)) {
+        return false;
+    }
+    *cur += len;
+    return true;
+}
+
+/* pick the values we use out of /proc/meminfo - false if it
+ * did not even give the total */
+static inline bool procfs_parse_meminfo(char *cur, procfs_meminfo_t *mi)
+{
+    int found = 0;
+
+    memset(mi, 0, sizeof(*mi));
+    do {
+        if (scan_tag(&cur, "MemTotal:", 9)) {
+            mi->total = scan_u64(&cur) * 1024;
+        } else if (scan_tag(&cur, "MemFree:", 8)) {
+            mi->free = scan_u64(&cur) * 1024;
+        } else if (scan_tag(&cur, "Buffers:", 8)) {
+            mi->buffers = scan_u64(&cur) * 1024;
+        } else if (scan_tag(&cur, "Cached:", 7)) {
+            mi->cached = scan_u64(&cur) * 1024;
+        } else if (scan_tag(&cur, "SwapTotal:", 10)) {
+            mi->swap_total = scan_u64(&cur) * 1024;
+        } else if (scan_tag(&cur, "SwapFree:", 9)) {
+            mi->swap_free = scan_u64(&cur) * 1024;
+        } else {
+            continue;
+        }
+        ++found;
+    } while (found < 6 && scan_line(&cur));
+
+    return (0 < mi->total);
+}
+
+/* the swap paging counters of /proc/vmstat - a counter the kernel
+ * does not report is left at zero */
+static inline void procfs_parse_vmstat(char *cur, uint64_t *page_in, uint64_t *page_out)
+{
+    int found = 0;
+
+    *page_in = 0;
+    *page_out = 0;
+    do {
+        if (scan_tag(&cur, "pswpin ", 7)) {
+            *page_in = scan_u64(&cur);
+        } else if (scan_tag(&cur, "pswpout ", 8)) {
+            *page_out = scan_u64(&cur);
+        } else {
+            continue;
+        }
+        ++found;
+    } while (found < 2 && scan_line(&cur));
+}
+
+/* One line of /proc/diskstats: major minor name, then the counters of
+ * Documentation/iostats.txt, sizes in 512-byte sectors. Counters an
+ * older kernel does not print read as zero. False if the line has no
+ * device name.
+ */
+#define PROCFS_DISK_FIELDS 11
+static inline bool procfs_parse_diskstats(char **cur, char **name, size_t *len,
+                                          uint64_t *fields)
+{
+    int i;
+
+    (void)scan_u64(cur);
+    (void)scan_u64(cur);
+    *name = scan_word(cur, len);
+    if (0 == *len) {
+        return false;
+    }
+    for (i=0; i < PROCFS_DISK_FIELDS; i++) {
+        fields[i] = scan_u64(cur);
+    }
+    return true;
+}
+
+/* One line of /proc/net/dev past its two header lines: "name:", then
+ * 8 receive and 8 transmit counters. Long names run straight into the
+ * first counter, so the name ends at the colon. False if the line has
+ * no colon.
+ */
+#define PROCFS_NET_FIELDS 16
+static inline bool procfs_parse_netdev(char **cur, char **name, size_t *len,
+                                       uint64_t *fields)
+{
+    char *colon;
+    int i;
+
+    scan_blanks(cur);
+    *name = *cur;
+    if (NULL == (colon = strchr(*cur, ':'))) {
+        return false;
+    }
+    *len = (size_t)(colon - *name);
+    *cur = colon + 1;
+    for (i=0; i < PROCFS_NET_FIELDS; i++) {
+        fields[i] = scan_u64(cur);
+    }
+    return true;
+}
+
+/* Split a /proc/<pid>/stat line into its numeric fields, indexed as
+ * in proc(5) - field 3 is the state, the command is returned apart
+ * as it may contain blanks or parentheses of its own.
+ */
+static inline bool procfs_parse_stat(char *data, char **cmd, size_t *cmdlen,
+                                     char *state, int64_t *fields, int nfields)
+{
+    char *lparen, *rparen, *cur;
+    int i;
+
+    if (NULL == (lparen = strchr(data, '(')) ||
+        NULL == (rparen = strrchr(data, ')'))) {
+        return false;
+    }
+    *cmd = lparen + 1;
+    *cmdlen = (size_t)(rparen - *cmd);
+    cur = rparen + 1;
+    scan_blanks(&cur);
+    *state = *cur++;
+    for (i=4; i < nfields; i++) {
+        fields[i] = scan_i64(&cur);
+    }
+    return true;
+}
+
+#endif
@@ -74,6 +74,7 @@ static orte_node_t *my_node;
 static orte_proc_t *my_proc;
 
 static void generate_test_vector(opal_buffer_t *v);
+static int sample_children(opal_buffer_t *buf);
 
 static int init(void)
 {
@@ -115,8 +116,7 @@ static void sample(orcm_sensor_sampler_t *sampler)
 {
     opal_pstats_t *stats;
     opal_node_stats_t *nstats;
-    int rc, i;
-    orte_proc_t *child;
+    int rc;
     opal_buffer_t buf, *bptr;
     char *comp;
     struct timeval current_time;
@@ -205,45 +205,13 @@ static void sample(orcm_sensor_sampler_t *sampler)
         return;
     }
 
-    /* loop through our children and update their stats */
-    if (NULL != orte_local_children) {
-        for (i=0; i < orte_local_children->size; i++) {
-            if (NULL == (child = (orte_proc_t*)opal_pointer_array_get_item(orte_local_children, i))) {
-                continue;
-            }
-            if (!ORTE_FLAG_TEST(child, ORTE_PROC_FLAG_ALIVE)) {
-                continue;
-            }
-            if (0 == child->pid) {
-                /* race condition */
-                continue;
-            }
-            stats = OBJ_NEW(opal_pstats_t);
-            if (ORCM_SUCCESS != opal_pstat.query(child->pid, stats, NULL)) {
-                /* may hit a race condition where the process has
-                 * terminated, so just ignore any error
-                 */
-                OBJ_RELEASE(stats);
-                continue;
-            }
-            /* the stats framework can't know nodename or rank */
-            strncpy(stats->node, orte_process_info.nodename, (OPAL_PSTAT_MAX_STRING_LEN - 1));
-            stats->rank = child->name.vpid;
-#if 0
-            /* store it */
-            if (NULL != (st = (opal_pstats_t*)opal_ring_buffer_push(&child->stats, stats))) {
-                OBJ_RELEASE(st);
-            }
-#endif
-            /* pack them */
-            if (OPAL_SUCCESS != (rc = opal_dss.pack(&buf, &stats, 1, OPAL_PSTAT))) {
-                ORTE_ERROR_LOG(rc);
-                OBJ_DESTRUCT(&buf);
-                OBJ_RELEASE(stats);
-                OBJ_RELEASE(nstats);
-                return;
-            }
-        }
+    OBJ_RELEASE(stats);
+
+    /* update and pack the stats of our children */
+    if (ORCM_SUCCESS != (rc = sample_children(&buf))) {
+        OBJ_DESTRUCT(&buf);
+        OBJ_RELEASE(nstats);
+        return;
     }
 
     /* xfer any data for transmission */
@@ -252,14 +220,10 @@ static void sample(orcm_sensor_sampler_t *sampler)
         if (OPAL_SUCCESS != (rc = opal_dss.pack(&sampler->bucket, &bptr, 1, OPAL_BUFFER))) {
             ORTE_ERROR_LOG(rc);
             OBJ_DESTRUCT(&buf);
-            OBJ_RELEASE(stats);
             OBJ_RELEASE(nstats);
             return;
         }
     }
-    if(NULL != stats) {
-        OBJ_RELEASE(stats);
-    }
     OBJ_RELEASE(nstats);
     OBJ_DESTRUCT(&buf);
 #if 0
@@ -387,7 +351,7 @@ cleanup:
 
 }
 
-static void res_log_node_stats(opal_node_stats_t *nst, char *node, struct timeval sampletime)
+static void res_log_node_stats(opal_node_stats_t *nst, const char *node, struct timeval sampletime)
 {
     orcm_value_t *sensor_metric = NULL;
     opal_list_t *key = NULL;
@@ -410,7 +374,7 @@ static void res_log_node_stats(opal_node_stats_t *nst, char *node, struct timeva
     }
     opal_list_append(non_compute_data, (opal_list_item_t *)sensor_metric);
 
-    sensor_metric = orcm_util_load_orcm_value("hostname", node, OPAL_STRING, NULL);
+    sensor_metric = orcm_util_load_orcm_value("hostname", (void*)node, OPAL_STRING, NULL);
     if (NULL == sensor_metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
         goto cleanup;
@@ -456,7 +420,7 @@ cleanup:
 
 }
 
-static void res_log_process_stats(opal_pstats_t *st, char *node, struct timeval sampletime)
+static void res_log_process_stats(opal_pstats_t *st, const char *node, struct timeval sampletime)
 {
     char *primary_key = NULL;
     orcm_value_t *sensor_metric = NULL;
@@ -481,7 +445,7 @@ static void res_log_process_stats(opal_pstats_t *st, char *node, struct timeval
     }
     opal_list_append(non_compute_data, (opal_list_item_t *)sensor_metric);
 
-    sensor_metric = orcm_util_load_orcm_value("hostname", node, OPAL_STRING, NULL);
+    sensor_metric = orcm_util_load_orcm_value("hostname", (void*)node, OPAL_STRING, NULL);
     if (NULL == sensor_metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
         goto cleanup;
@@ -536,18 +500,95 @@ cleanup:
     }
 }
 
+/* sample every live child in one batch so that the cost of a
+ * sample does not grow with the open/close of per-process files
+ */
+static int sample_children(opal_buffer_t *buf)
+{
+    orte_proc_t *child;
+    opal_pstats_t **stats;
+    orte_proc_t **kids;
+    pid_t *pids;
+    int i, nkids = 0, rc = ORCM_SUCCESS;
+
+    if (NULL == orte_local_children || 0 == orte_local_children->size) {
+        return ORCM_SUCCESS;
+    }
+
+    pids = (pid_t*)malloc(orte_local_children->size * sizeof(pid_t));
+    kids = (orte_proc_t**)malloc(orte_local_children->size * sizeof(orte_proc_t*));
+    stats = (opal_pstats_t**)malloc(orte_local_children->size * sizeof(opal_pstats_t*));
+    if (NULL == pids || NULL == kids || NULL == stats) {
+        SAFEFREE(pids);
+        SAFEFREE(kids);
+        SAFEFREE(stats);
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+
+    for (i=0; i < orte_local_children->size; i++) {
+        if (NULL == (child = (orte_proc_t*)opal_pointer_array_get_item(orte_local_children, i))) {
+            continue;
+        }
+        if (!ORTE_FLAG_TEST(child, ORTE_PROC_FLAG_ALIVE)) {
+            continue;
+        }
+        if (0 == child->pid) {
+            /* race condition */
+            continue;
+        }
+        pids[nkids] = child->pid;
+        kids[nkids] = child;
+        stats[nkids] = OBJ_NEW(opal_pstats_t);
+        nkids++;
+    }
+
+    if (0 < nkids &&
+        OPAL_ERR_NOT_SUPPORTED == opal_pstat.query_batch(pids, nkids, stats)) {
+        /* fall back to one query per child */
+        for (i=0; i < nkids; i++) {
+            if (ORCM_SUCCESS != opal_pstat.query(pids[i], stats[i], NULL)) {
+                stats[i]->pid = 0;
+            }
+        }
+    }
+
+    for (i=0; i < nkids; i++) {
+        if (0 == stats[i]->pid) {
+            /* may hit a race condition where the process has
+             * terminated, so just ignore it
+             */
+            continue;
+        }
+        /* the stats framework can't know nodename or rank */
+        strncpy(stats[i]->node, orte_process_info.nodename, (OPAL_PSTAT_MAX_STRING_LEN - 1));
+        stats[i]->rank = kids[i]->name.vpid;
+        /* pack them */
+        if (OPAL_SUCCESS != (rc = opal_dss.pack(buf, &stats[i], 1, OPAL_PSTAT))) {
+            ORTE_ERROR_LOG(rc);
+            break;
+        }
+    }
+
+    for (i=0; i < nkids; i++) {
+        OBJ_RELEASE(stats[i]);
+    }
+    free(pids);
+    free(kids);
+    free(stats);
+    return rc;
+}
+
 static void res_log(opal_buffer_t *sample)
 {
     opal_pstats_t *st=NULL;
     opal_node_stats_t *nst=NULL;
     int rc, n;
-    char *node = NULL;
+    const char *node = NULL;
     struct timeval sampletime;
 
 
     /* unpack the node name */
-    n=1;
-    if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &node, &n, OPAL_STRING))) {
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &node, NULL))) {
         ORTE_ERROR_LOG(rc);
         goto cleanup;
     }
@@ -588,7 +629,6 @@ static void res_log(opal_buffer_t *sample)
     }
 
 cleanup:
-    SAFEFREE(node);
     if (NULL != nst) {
         OBJ_RELEASE(nst);
     }
@@ -776,11 +816,6 @@ static void res_inventory_collect(opal_buffer_t *inventory_snapshot)
     }
 }
 
-static void my_inventory_log_cleanup(int dbhandle, int status, opal_list_t *kvs, opal_list_t *output, void *cbdata)
-{
-    OBJ_RELEASE(kvs);
-}
-
 static void res_inventory_log(char *hostname, opal_buffer_t *inventory_snapshot)
 {
     unsigned int tot_items = 0;
@@ -819,9 +854,5 @@ static void res_inventory_log(char *hostname, opal_buffer_t *inventory_snapshot)
 
         --tot_items;
     }
-    if (0 <= orcm_sensor_base.dbhandle) {
-        orcm_db.store_new(orcm_sensor_base.dbhandle, ORCM_DB_INVENTORY_DATA, records, NULL, my_inventory_log_cleanup, NULL);
-    } else {
-        my_inventory_log_cleanup(-1, -1, records, NULL, NULL);
-    }
+    orcm_sensor_base_inventory_store(hostname, "resusage", records);
 }
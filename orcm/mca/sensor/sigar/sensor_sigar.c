@@ -1147,7 +1147,7 @@ static void sigar_log_sample_item(opal_list_t *key, opal_list_t *non_compute_dat
 
 }
 
-static void sigar_log_process_lvl_stats(opal_buffer_t *sample, struct timeval sampletime, char *hostname)
+static void sigar_log_process_lvl_stats(opal_buffer_t *sample, struct timeval sampletime, const char *hostname)
 {
     orcm_value_t *sensor_metric = NULL;
     opal_list_t *key = NULL;
@@ -1187,7 +1187,7 @@ static void sigar_log_process_lvl_stats(opal_buffer_t *sample, struct timeval sa
         opal_list_append(non_compute_data, (opal_list_item_t *)sensor_metric);
 
 
-        sensor_metric = orcm_util_load_orcm_value("hostname", hostname, OPAL_STRING, NULL);
+        sensor_metric = orcm_util_load_orcm_value("hostname", (void*)hostname, OPAL_STRING, NULL);
         if (NULL == sensor_metric) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
             goto cleanup;
@@ -1292,7 +1292,7 @@ cleanup:
     }
 }
 
-static void sigar_log_process_stats(opal_buffer_t *sample, struct timeval sampletime, char *hostname)
+static void sigar_log_process_stats(opal_buffer_t *sample, struct timeval sampletime, const char *hostname)
 {
     orcm_value_t *sensor_metric = NULL;
     opal_list_t *key = NULL;
@@ -1329,7 +1329,7 @@ static void sigar_log_process_stats(opal_buffer_t *sample, struct timeval sample
         opal_list_append(non_compute_data, (opal_list_item_t *)sensor_metric);
 
 
-        sensor_metric = orcm_util_load_orcm_value("hostname", hostname, OPAL_STRING, NULL);
+        sensor_metric = orcm_util_load_orcm_value("hostname", (void*)hostname, OPAL_STRING, NULL);
         if (NULL == sensor_metric) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
             goto cleanup;
@@ -1405,7 +1405,7 @@ static void sigar_log_process_stats(opal_buffer_t *sample, struct timeval sample
 
 static void sigar_log(opal_buffer_t *sample)
 {
-    char *hostname = NULL;
+    const char *hostname = NULL;
     int rc;
     int32_t n;
     uint64_t uint64;
@@ -1417,8 +1417,7 @@ static void sigar_log(opal_buffer_t *sample)
     opal_list_t *key = NULL;
     opal_list_t *non_compute_data = NULL;
 
-    n=1;
-    if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &hostname, &n, OPAL_STRING))) {
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &hostname, NULL))) {
         ORTE_ERROR_LOG(rc);
         return;
     }
@@ -1453,7 +1452,7 @@ static void sigar_log(opal_buffer_t *sample)
     opal_list_append(non_compute_data, (opal_list_item_t *)sensor_metric);
 
 
-    sensor_metric = orcm_util_load_orcm_value("hostname", hostname, OPAL_STRING, NULL);
+    sensor_metric = orcm_util_load_orcm_value("hostname", (void*)hostname, OPAL_STRING, NULL);
     if (NULL == sensor_metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
         goto cleanup;
@@ -1831,7 +1830,6 @@ cleanup:
     if ( NULL != key) {
         OBJ_RELEASE(key);
     }
-    SAFEFREE(hostname);
 }
 
 /* Helper function to calculate the metric differences */
@@ -2167,11 +2165,6 @@ static void sigar_inventory_collect(opal_buffer_t *inventory_snapshot)
     }
 }
 
-static void my_inventory_log_cleanup(int dbhandle, int status, opal_list_t *kvs, opal_list_t *output, void *cbdata)
-{
-    OBJ_RELEASE(kvs);
-}
-
 static void sigar_inventory_log(char *hostname, opal_buffer_t *inventory_snapshot)
 {
     unsigned int tot_items = 0;
@@ -2210,9 +2203,5 @@ static void sigar_inventory_log(char *hostname, opal_buffer_t *inventory_snapsho
 
         --tot_items;
     }
-    if (0 <= orcm_sensor_base.dbhandle) {
-        orcm_db.store_new(orcm_sensor_base.dbhandle, ORCM_DB_INVENTORY_DATA, records, NULL, my_inventory_log_cleanup, NULL);
-    } else {
-        my_inventory_log_cleanup(-1, -1, records, NULL, NULL);
-    }
+    orcm_sensor_base_inventory_store(hostname, "sigar", records);
 }
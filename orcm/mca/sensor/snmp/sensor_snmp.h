@@ -26,6 +26,8 @@ typedef struct {
     bool use_progress_thread;
     int sample_rate;
     char* config_file;
+    int timeout;    /* msec to wait for a device before retrying */
+    int retries;
 } orcm_sensor_snmp_component_t;
 
 typedef struct {
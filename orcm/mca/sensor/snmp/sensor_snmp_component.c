@@ -102,5 +102,23 @@ int snmp_component_register(void)
                                             MCA_BASE_VAR_SCOPE_READONLY,
                                             & mca_sensor_snmp_component.config_file);
 
+    mca_sensor_snmp_component.timeout = -1;
+    (void) mca_base_component_var_register(c, "timeout",
+                                           "Milliseconds to wait for an SNMP device to answer "
+                                           "before retrying [default: net-snmp default]",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_sensor_snmp_component.timeout);
+
+    mca_sensor_snmp_component.retries = -1;
+    (void) mca_base_component_var_register(c, "retries",
+                                           "Number of times to retry an SNMP device that does "
+                                           "not answer [default: net-snmp default]",
+                                           MCA_BASE_VAR_TYPE_INT, NULL, 0, 0,
+                                           OPAL_INFO_LVL_9,
+                                           MCA_BASE_VAR_SCOPE_READONLY,
+                                           &mca_sensor_snmp_component.retries);
+
     return ORCM_SUCCESS;
 }
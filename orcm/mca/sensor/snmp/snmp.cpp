@@ -31,10 +31,10 @@ extern "C" {
     #include "orcm/mca/db/db.h"
     #include "orcm/mca/evgen/evgen_types.h"
 
-    extern orcm_value_t* orcm_util_load_orcm_value(char *key,
+    extern orcm_value_t* orcm_util_load_orcm_value(const char *key,
                                                    void *data,
                                                    opal_data_type_t type,
-                                                   char* units);
+                                                   const char* units);
 
     extern orcm_analytics_value_t*
            orcm_util_load_orcm_analytics_value(opal_list_t *key,
@@ -76,6 +76,9 @@ int snmp_impl::init(void)
         (void) load_mca_variables();
         snmpParser sp(config_file_);
         collectorObj_ = sp.parse();
+        for (vector<snmpCollector>::iterator it = collectorObj_.begin(); it != collectorObj_.end(); ++it) {
+            it->setTimeouts(mca_sensor_snmp_component.timeout, mca_sensor_snmp_component.retries);
+        }
     } catch (exception &e) {
         opal_output_verbose(1, orcm_sensor_base_framework.framework_output,
                             "ERROR: %s sensor SNMP : init: '%s'",
@@ -106,6 +109,9 @@ void snmp_impl::finalize(void)
 {
     stop(0);
     ev_destroy_thread();
+    for (vector<snmpCollector>::iterator it = collectorObj_.begin(); it != collectorObj_.end(); ++it) {
+        it->closeSession();
+    }
 }
 
 void snmp_impl::start(orte_jobid_t job)
@@ -323,9 +329,18 @@ void snmp_impl::packPluginName(opal_buffer_t* buffer) {
 
 
 void snmp_impl::collectAndPackDataSamples(opal_buffer_t *buffer) {
-    for(vector<snmpCollector>::iterator it = collectorObj_.begin(); it != collectorObj_.end(); ++it) {
+    vector<snmpCollector>::iterator it;
+
+    // get every request on the wire before waiting on any of them, so
+    // the sweep takes about as long as the slowest device to answer
+    for(it = collectorObj_.begin(); it != collectorObj_.end(); ++it) {
+        it->sendRequest();
+    }
+    snmpCollector::completeRequests(collectorObj_);
+
+    for(it = collectorObj_.begin(); it != collectorObj_.end(); ++it) {
         try {
-            vector<vardata> dataSamples = it->collectData();
+            vector<vardata> dataSamples = it->getResults();
             packDataToBuffer(dataSamples, buffer);
         } catch (exception &e) {
             opal_output_verbose(1, orcm_sensor_base_framework.framework_output,
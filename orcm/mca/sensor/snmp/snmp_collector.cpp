@@ -7,14 +7,19 @@
  * $HEADER$
  */
 
+#include <sys/select.h>
+#include <errno.h>
+
 #include "snmp_collector.h"
 using namespace std;
 
 snmpCollector::snmpCollector() {
+    initState();
     snmpCollector("","");
 }
 
 snmpCollector::snmpCollector(string host, string user) {
+    initState();
     hostname = string(host);
     username = string(user);
     response = NULL;
@@ -29,14 +34,17 @@ snmpCollector::snmpCollector(string host, string user) {
 }
 
 snmpCollector::snmpCollector(string host, string user, string pass) {
+    initState();
     snmpCollector(host, user, pass, MD5);
 }
 
 snmpCollector::snmpCollector(string host, string user, string pass, auth_type auth) {
+    initState();
     snmpCollector(host, user, pass, auth, AUTHNOPRIV);
 }
 
 snmpCollector::snmpCollector(string host, string user, string pass, auth_type auth, sec_type sec) {
+    initState();
     hostname = string(host);
     username = string(user);
     password = string(pass);
@@ -65,6 +73,15 @@ snmpCollector::snmpCollector(string host, string user, string pass, auth_type au
 snmpCollector::~snmpCollector() {
 }
 
+void snmpCollector::initState() {
+    ss = NULL;
+    state = IDLE;
+    reqid = 0;
+    latency_ms = 0.0;
+    failures = 0;
+    skip = 0;
+}
+
 void snmpCollector::dump_pdu(netsnmp_pdu *p) {
     printf("PDU I'm at: %p\n",p);
     printf("Version id: %ld\n",p->version);
@@ -127,18 +144,49 @@ void snmpCollector::setLocation(string location){
     this->location = location;
 }
 
+void snmpCollector::setTimeouts(int timeout_msec, int retries) {
+    if (0 < timeout_msec) {
+        session.timeout = (long)timeout_msec * 1000;
+    }
+    if (0 <= retries) {
+        session.retries = retries;
+    }
+}
+
+netsnmp_session *snmpCollector::openSession() {
+    if (NULL == ss) {
+        // this object may be a copy of the one that set these up
+        session.peername = const_cast<char*>(hostname.c_str());
+        if (SNMP_VERSION_3 == session.version) {
+            storeCharsAndLength(username, &session.securityName, &session.securityNameLen);
+        } else {
+            storeCharsAndLength(username, (char**) &session.community, &session.community_len);
+        }
+        ss = snmp_open(&session);
+    }
+    return ss;
+}
+
+void snmpCollector::closeSession() {
+    if (NULL != ss) {
+        snmp_close(ss);
+        ss = NULL;
+    }
+    state = IDLE;
+}
+
 vector<vardata> snmpCollector::collectData() {
-    netsnmp_session *ss = NULL;
     vector<vardata> retValue;
     int status;
 
-    if ( !(ss = snmp_open(&session)) ) {
+    if (NULL == openSession()) {
         throw invalidSession();
     }
 
     updateOIDs();
 
     status = snmp_synch_response(ss, pdu, &response);
+    pdu = NULL;
     if (status == STAT_TIMEOUT) {
         throw snmpTimeout();
     } else if (status != STAT_SUCCESS) {
@@ -148,11 +196,163 @@ vector<vardata> snmpCollector::collectData() {
         retValue = packCollectedData(response);
         snmp_free_pdu(response);
     }
-    snmp_close(ss);
 
     return retValue;
 }
 
+bool snmpCollector::sendRequest() {
+    int id;
+
+    results.clear();
+    if (0 < skip) {
+        skip--;
+        state = SKIPPED;
+        return false;
+    }
+    if (NULL == openSession()) {
+        noteFailure(SESSION_ERROR);
+        return false;
+    }
+
+    updateOIDs();
+
+    gettimeofday(&sent, NULL);
+    state = PENDING;
+    reqid = 0;
+    if (0 == (id = snmp_async_send(ss, pdu, asyncResponse, this))) {
+        snmp_free_pdu(pdu);
+        pdu = NULL;
+        noteFailure(COLLECT_ERROR);
+        return false;
+    }
+    // the library owns the request now
+    pdu = NULL;
+    if (PENDING == state) {
+        reqid = id;
+    }
+    return isPending();
+}
+
+int snmpCollector::asyncResponse(int operation, netsnmp_session *sp, int reqid,
+                                 netsnmp_pdu *response, void *magic) {
+    (void)sp;
+    if (NULL != magic) {
+        ((snmpCollector*)magic)->onResponse(operation, reqid, response);
+    }
+    return 1;
+}
+
+void snmpCollector::onResponse(int operation, int reqid, netsnmp_pdu *response) {
+    struct timeval now;
+
+    // an answer to a request we have since given up on
+    if (PENDING != state || (0 != this->reqid && reqid != this->reqid)) {
+        return;
+    }
+    if (NETSNMP_CALLBACK_OP_TIMED_OUT == operation) {
+        noteFailure(TIMED_OUT);
+        return;
+    }
+    if (NETSNMP_CALLBACK_OP_RECEIVED_MESSAGE != operation || NULL == response) {
+        noteFailure(COLLECT_ERROR);
+        return;
+    }
+
+    gettimeofday(&now, NULL);
+    latency_ms = (now.tv_sec - sent.tv_sec) * 1000.0 +
+                 (now.tv_usec - sent.tv_usec) / 1000.0;
+
+    // we are called from inside net-snmp, so nothing may be thrown from here
+    try {
+        results = packCollectedData(response);
+    } catch (packetError &e) {
+        noteFailure(PACKET_ERROR);
+        return;
+    } catch (exception &e) {
+        noteFailure(COLLECT_ERROR);
+        return;
+    }
+    results.push_back(vardata(latency_ms).setKey(hostname + " snmp_latency_ms"));
+    failures = 0;
+    state = DONE;
+}
+
+void snmpCollector::noteFailure(request_state failure) {
+    state = failure;
+    if (0 < failures) {
+        skip = (1 << (failures - 1));
+        if (SNMP_MAX_BACKOFF_SWEEPS < skip) {
+            skip = SNMP_MAX_BACKOFF_SWEEPS;
+        }
+    }
+    if (failures < 31) {
+        failures++;
+    }
+}
+
+vector<vardata> snmpCollector::getResults() {
+    switch (state) {
+        case DONE:
+            return results;
+        case SKIPPED:
+            throw snmpBackoff();
+        case TIMED_OUT:
+        case PENDING:
+            throw snmpTimeout();
+        case SESSION_ERROR:
+            throw invalidSession();
+        case PACKET_ERROR:
+            throw packetError();
+        default:
+            throw dataCollectionError();
+    }
+}
+
+void snmpCollector::completeRequests(vector<snmpCollector> &collectors) {
+    struct timeval timeout;
+    fd_set fdset;
+    int fds, block, count;
+    bool pending = true;
+
+    while (pending) {
+        pending = false;
+        for (vector<snmpCollector>::iterator it = collectors.begin(); it != collectors.end(); ++it) {
+            if (it->isPending()) {
+                pending = true;
+                break;
+            }
+        }
+        if (!pending) {
+            break;
+        }
+
+        fds = 0;
+        block = 1;
+        FD_ZERO(&fdset);
+        snmp_select_info(&fds, &fdset, &timeout, &block);
+        if (block) {
+            // net-snmp has nothing outstanding to wait for
+            break;
+        }
+        count = select(fds, &fdset, NULL, NULL, &timeout);
+        if (0 < count) {
+            snmp_read(&fdset);
+        } else if (0 == count) {
+            // fires the timeout callbacks once the retries are used up
+            snmp_timeout();
+        } else if (EINTR != errno) {
+            break;
+        }
+    }
+
+    // whatever is still outstanding is treated as timed out
+    for (vector<snmpCollector>::iterator it = collectors.begin(); it != collectors.end(); ++it) {
+        if (it->isPending()) {
+            it->noteFailure(TIMED_OUT);
+        }
+    }
+}
+
 vector<vardata> snmpCollector::packCollectedData(netsnmp_pdu *response) {
     vector<vardata> retValue;
 
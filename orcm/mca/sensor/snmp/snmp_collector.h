@@ -13,6 +13,7 @@
 #include <net-snmp/mib_api.h>
 #include "net-snmp/library/transform_oids.h"
 
+#include <sys/time.h>
 #include <iostream>
 #include <list>
 #include <map>
@@ -25,6 +26,9 @@
 #define STRING_BUFFER_SIZE 1024
 #define SUCCESS 0
 
+/* a device that keeps failing is skipped for 1, 2, 4... sweeps, up to this many */
+#define SNMP_MAX_BACKOFF_SWEEPS 16
+
 enum auth_type {MD5, SHA1};
 enum sec_type {NOAUTH, AUTHNOPRIV, AUTHPRIV};
 
@@ -43,15 +47,40 @@ class snmpCollector {
         void setOIDs(std::string strOIDs);
         void updateOIDs();
         void setLocation(std::string location);
+        void setTimeouts(int timeout_msec, int retries);
         std::vector<vardata> collectData();
 
+        /* Asynchronous collection: sendRequest() puts a request on the
+         * wire without waiting for it, completeRequests() runs until
+         * every outstanding request has been answered or has timed out,
+         * and getResults() then returns what the device sent (or throws
+         * what went wrong). The session stays open between sweeps.
+         * Copies share the session, so it is closed explicitly. */
+        bool sendRequest();
+        bool isPending() { return PENDING == state; }
+        std::vector<vardata> getResults();
+        void closeSession();
+        static void completeRequests(std::vector<snmpCollector> &collectors);
+
     private:
+        enum request_state {IDLE, PENDING, DONE, SKIPPED, TIMED_OUT,
+                            SESSION_ERROR, COLLECT_ERROR, PACKET_ERROR};
+
         struct snmp_session session;
+        netsnmp_session *ss;
         netsnmp_pdu *pdu;
         netsnmp_pdu *response;
         oid anOID[MAX_OID_LEN];
         size_t anOID_len;
 
+        request_state state;
+        int reqid;
+        struct timeval sent;
+        double latency_ms;
+        std::vector<vardata> results;
+        int failures;
+        int skip;
+
         std::string hostname, username, password, location;
         std::list<std::string> oidList;
 
@@ -62,6 +91,12 @@ class snmpCollector {
         void setAuthentication(std::string password);
         std::list<std::string> splitString(std::string input, char delimiter);
         std::vector<vardata> packCollectedData(netsnmp_pdu *response);
+        netsnmp_session *openSession();
+        void initState();
+        void noteFailure(request_state failure);
+        void onResponse(int operation, int reqid, netsnmp_pdu *response);
+        static int asyncResponse(int operation, netsnmp_session *sp, int reqid,
+                                 netsnmp_pdu *response, void *magic);
 
         static inline std::string &ltrim(std::string &s) {
             s.erase(s.begin(), find_if(s.begin(), s.end(), not1(std::ptr_fun<int, int>(isspace))));
@@ -108,4 +143,9 @@ class packetError: public runtime_error {
         packetError() : runtime_error("Error in packet") {}
 };
 
+class snmpBackoff: public runtime_error {
+    public:
+        snmpBackoff() : runtime_error("SNMP device skipped after repeated failures") {}
+};
+
 #endif /* SNMP_COLLECTOR_H */
@@ -119,10 +119,9 @@ vardata fromOpalBuffer(opal_buffer_t *buffer) {
     int32_t number;
     int rc;
 
-    // Unpack label
-    char* label;
-    number = 1;
-    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &label, &number, OPAL_STRING))) {
+    // Unpack label, borrowed from the buffer
+    const char* label;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(buffer, &label, NULL))) {
         ORTE_ERROR_LOG(rc);
         throw invalidBuffer();
     }
@@ -136,8 +135,8 @@ vardata fromOpalBuffer(opal_buffer_t *buffer) {
 
     number = 1;
     if (OPAL_STRING == localType) {
-        char* s;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &s, &number, localType))) {
+        const char* s;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(buffer, &s, NULL))) {
             ORTE_ERROR_LOG(rc);
             throw invalidBuffer();
         }
@@ -302,8 +302,8 @@ static void syslog_log(opal_buffer_t *sample)
     int rc,i,n;
     int32_t nmsg;
     char tmp_log[32];
-    char *log=NULL;
-    char *hostname=NULL;
+    const char *log=NULL;
+    const char *hostname=NULL;
     bool error = false;
     struct timeval sampletime;
     orcm_value_t *sensor_metric = NULL;
@@ -312,8 +312,7 @@ static void syslog_log(opal_buffer_t *sample)
     opal_list_t *non_compute_data = NULL;
 
     /* unpack the host this came from */
-    n=1;
-    if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &hostname, &n, OPAL_STRING))) {
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &hostname, NULL))) {
         ORTE_ERROR_LOG(rc);
         goto cleanup;
     }
@@ -355,7 +354,7 @@ static void syslog_log(opal_buffer_t *sample)
         ORTE_ERROR_LOG(OPAL_ERR_BAD_PARAM);
         goto cleanup;
     }
-    sensor_metric = orcm_util_load_orcm_value("hostname", hostname, OPAL_STRING, NULL);
+    sensor_metric = orcm_util_load_orcm_value("hostname", (void*)hostname, OPAL_STRING, NULL);
 
     if (NULL == sensor_metric) {
         ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
@@ -381,8 +380,7 @@ static void syslog_log(opal_buffer_t *sample)
             goto cleanup;
         }
 
-        n=1;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &log, &n, OPAL_STRING))) {
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &log, NULL))) {
             ORTE_ERROR_LOG(rc);
             error = true;
             goto cleanup;
@@ -398,7 +396,7 @@ static void syslog_log(opal_buffer_t *sample)
                             "%s syslog_log: %s = %s\n",tmp_log,log,
                             ORTE_NAME_PRINT(ORTE_PROC_MY_NAME));
 
-        sensor_metric = orcm_util_load_orcm_value(tmp_log, log, OPAL_STRING, "log");
+        sensor_metric = orcm_util_load_orcm_value(tmp_log, (void*)log, OPAL_STRING, "log");
         if (NULL == sensor_metric) {
             ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
             error = true;
@@ -416,8 +414,6 @@ cleanup:
             OBJ_RELEASE(analytics_vals);
         }
     }
-    SAFEFREE(hostname);
-    SAFEFREE(log);
     if ( NULL != key) {
         OBJ_RELEASE(key);
     }
@@ -142,21 +142,18 @@ static void test_sample(orcm_sensor_sampler_t *sampler)
 
 static void test_log(opal_buffer_t *sample)
 {
-    char *hostname=NULL;
-    char *sampletime;
+    const char *hostname=NULL;
+    const char *sampletime;
     int rc;
-    int32_t n;
 
     /* unpack the host this came from */
-    n=1;
-    if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &hostname, &n, OPAL_STRING))) {
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &hostname, NULL))) {
         ORTE_ERROR_LOG(rc);
         return;
     }
 
     /* sample time */
-    n=1;
-    if (OPAL_SUCCESS != (rc = opal_dss.unpack(sample, &sampletime, &n, OPAL_STRING))) {
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack_string_view(sample, &sampletime, NULL))) {
         ORTE_ERROR_LOG(rc);
         return;
     }
@@ -165,9 +162,4 @@ static void test_log(opal_buffer_t *sample)
                         "%s Received log from host %s",
                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
                         (NULL == hostname) ? "NULL" : hostname);
-
-    if (NULL != hostname) {
-        free(hostname);
-    }
-
 }
@@ -90,6 +90,7 @@
 #include "orcm/mca/pwrmgmt/base/base.h"
 #include "orcm/mca/pwrmgmt/pwrmgmt.h"
 #include "orcm/util/utils.h"
+#include "orcm/util/fanout.h"
 
 #include "orcm/mca/sst/base/base.h"
 #include "orcm/mca/sst/orcmd/sst_orcmd.h"
@@ -612,6 +613,13 @@ static int orcmd_init(void)
         goto error;
     }
 
+    /* relay fanned-out tool commands */
+    if (ORCM_SUCCESS != (ret = orcm_fanout_start())) {
+        ORTE_ERROR_LOG(ret);
+        error = "orcm_fanout_start";
+        goto error;
+    }
+
     /* setup the ANALYTICS framework */
     if (ORTE_SUCCESS != (ret = mca_base_framework_open(&orcm_analytics_base_framework, 0))) {
         ORTE_ERROR_LOG(ret);
@@ -715,6 +723,7 @@ static void orcmd_finalize(void)
 
     /* close frameworks */
     (void) mca_base_framework_close(&orcm_diag_base_framework);
+    orcm_fanout_stop();
     (void) mca_base_framework_close(&orte_filem_base_framework);
     (void) mca_base_framework_close(&orte_grpcomm_base_framework);
     (void) mca_base_framework_close(&orte_iof_base_framework);
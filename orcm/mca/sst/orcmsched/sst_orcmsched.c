@@ -83,6 +83,7 @@
 #include "orcm/mca/cfgi/base/base.h"
 #include "orcm/mca/cfgi/cfgi_types.h"
 #include "orcm/mca/db/base/base.h"
+#include "orcm/util/fanout.h"
 
 #include "orcm/mca/sst/base/base.h"
 #include "orcm/mca/sst/orcmsched/sst_orcmsched.h"
@@ -426,6 +427,13 @@ static int orcmsched_init(void)
     }
     ORCM_CONSTRUCT_QUEUES(scheduler);
 
+    /* the scheduler is the root of every tool command fan-out */
+    if (ORCM_SUCCESS != (ret = orcm_fanout_start())) {
+        ORTE_ERROR_LOG(ret);
+        error = "orcm_fanout_start";
+        goto error;
+    }
+
     return ORCM_SUCCESS;
     
  error:
@@ -447,6 +455,8 @@ static void orcmsched_finalize(void)
         opal_event_signal_del(&sigusr2_handler);
     }
     
+    orcm_fanout_stop();
+
     /* close frameworks */
     (void) mca_base_framework_close(&orcm_scd_base_framework);
     (void) mca_base_framework_close(&orte_filem_base_framework);
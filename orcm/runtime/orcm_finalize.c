@@ -24,6 +24,7 @@
 #include "orte/runtime/runtime.h"
 #include "runtime/runtime.h"
 #include "orcm/util/logical_group.h"
+#include "orcm/util/value_batch.h"
 
 int orcm_finalize(void)
 {
@@ -58,6 +59,9 @@ int orcm_finalize(void)
     /* close the sst itself */
     (void) mca_base_framework_close(&orcm_sst_base_framework);
 
+    /* nothing can be holding batch values once the frameworks are closed */
+    orcm_value_intern_finalize();
+
     /* cleanup the process info */
     orte_proc_info_finalize();
 
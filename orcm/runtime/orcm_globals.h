@@ -112,6 +112,12 @@ typedef uint8_t orcm_rm_cmd_flag_t;
 #define ORCM_GET_DB_QUERY_IDLE_COMMAND       34
 #define ORCM_GET_DB_QUERY_NODE_COMMAND       35
 #define ORCM_GET_DB_QUERY_EVENT_COMMAND      36
+#define ORCM_GET_RECENT_SENSOR_COMMAND       37
+#define ORCM_GET_DB_QUERY_AGGREGATE_COMMAND  38
+
+/* grouping of ORCM_GET_DB_QUERY_AGGREGATE_COMMAND rows besides the time bucket */
+#define ORCM_DB_QUERY_GROUP_BY_NODE      0x01
+#define ORCM_DB_QUERY_GROUP_BY_SENSOR    0x02
 
 /* define diagnostic commands */
 typedef uint8_t orcm_diag_cmd_flag_t;
@@ -131,6 +137,15 @@ typedef uint8_t orcm_sensor_cmd_flag_t;
 #define ORCM_SET_SENSOR_POLICY_COMMAND        5
 #define ORCM_GET_SENSOR_POLICY_COMMAND        6
 
+/* define live telemetry subscription commands */
+typedef uint8_t orcm_pubsub_cmd_flag_t;
+#define ORCM_PUBSUB_CMD_T OPAL_UINT8
+
+#define ORCM_PUBSUB_SUBSCRIBE_COMMAND     1
+#define ORCM_PUBSUB_UNSUBSCRIBE_COMMAND   2
+#define ORCM_PUBSUB_PUBLISH_COMMAND       3
+#define ORCM_PUBSUB_ACK_COMMAND           4
+
 /** version string of ORCM */
 ORCM_DECLSPEC extern const char openrcm_version_string[];
 
@@ -168,6 +183,17 @@ ORCM_DECLSPEC extern int orcm_debug_verbosity;
 #define ORCM_RML_TAG_SENSOR        (ORTE_RML_TAG_MAX + 11)
 /* db fetch */
 #define ORCM_RML_TAG_ORCMD_FETCH   (ORTE_RML_TAG_MAX + 12)
+/* live telemetry subscriptions */
+#define ORCM_RML_TAG_PUBSUB        (ORTE_RML_TAG_MAX + 13)
+/* in-memory recent sample queries */
+#define ORCM_RML_TAG_RECENT_SAMPLES (ORTE_RML_TAG_MAX + 14)
+/* tree fan-out of tool commands */
+#define ORCM_RML_TAG_FANOUT        (ORTE_RML_TAG_MAX + 15)
+/* allocation-wide power control loops */
+#define ORCM_RML_TAG_PWRMGMT_CTL   (ORTE_RML_TAG_MAX + 16)
+/* inventory digests, and the aggregator's requests for changed parts */
+#define ORCM_RML_TAG_INVENTORY_DIGEST  (ORTE_RML_TAG_MAX + 17)
+#define ORCM_RML_TAG_INVENTORY_REQUEST (ORTE_RML_TAG_MAX + 18)
 
 /* define event base priorities */
 #define ORCM_SCHED_PRI OPAL_EV_MSG_HI_PRI
@@ -0,0 +1,390 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#include "dss_tests.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+#define BENCH_VALUES (1 << 18)
+#define BENCH_CHUNK 64
+
+void dss_tests::SetUpTestCase()
+{
+    opal_dss_register_vars();
+    opal_init_test();
+}
+
+void dss_tests::TearDown()
+{
+    opal_dss_float_encoding = OPAL_DSS_FLOAT_BINARY;
+}
+
+TEST_F(dss_tests, double_round_trip_is_exact)
+{
+    double in[] = {M_PI, -0.0, 1e-300, -123456.789012345678, 1.0 / 3.0, HUGE_VAL};
+    double out[6];
+    int32_t n = 6;
+    opal_buffer_t *buffer = OBJ_NEW(opal_buffer_t);
+
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(buffer, in, n, OPAL_DOUBLE));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack(buffer, out, &n, OPAL_DOUBLE));
+    ASSERT_EQ(6, n);
+    EXPECT_EQ(0, memcmp(in, out, sizeof(in)));
+    OBJ_RELEASE(buffer);
+}
+
+TEST_F(dss_tests, float_round_trip_is_exact)
+{
+    float in[] = {36.6f, -40.125f, 1e-30f, 3.4e38f};
+    float out[4];
+    int32_t n = 4;
+    opal_buffer_t *buffer = OBJ_NEW(opal_buffer_t);
+
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(buffer, in, n, OPAL_FLOAT));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack(buffer, out, &n, OPAL_FLOAT));
+    ASSERT_EQ(4, n);
+    EXPECT_EQ(0, memcmp(in, out, sizeof(in)));
+    OBJ_RELEASE(buffer);
+}
+
+TEST_F(dss_tests, values_unpack_in_any_chunking)
+{
+    double in[] = {1.5, 2.5, 3.5};
+    double out;
+    int32_t n = 3;
+    opal_buffer_t *buffer = OBJ_NEW(opal_buffer_t);
+
+    /* packed as one array, unpacked one at a time */
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss_pack_buffer(buffer, in, n, OPAL_DOUBLE));
+    for (int i = 0; i < 3; i++) {
+        n = 1;
+        ASSERT_EQ(OPAL_SUCCESS, opal_dss_unpack_buffer(buffer, &out, &n, OPAL_DOUBLE));
+        EXPECT_EQ(in[i], out);
+    }
+    n = 1;
+    EXPECT_EQ(OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER,
+              opal_dss_unpack_buffer(buffer, &out, &n, OPAL_DOUBLE));
+    OBJ_RELEASE(buffer);
+}
+
+TEST_F(dss_tests, binary_wire_format_is_network_order)
+{
+    double value = 1.0;
+    float fvalue = -2.0f;
+    opal_buffer_t *buffer = OBJ_NEW(opal_buffer_t);
+    const unsigned char double_bytes[] = {0x01, 0x3f, 0xf0, 0, 0, 0, 0, 0, 0};
+    const unsigned char float_bytes[] = {0x01, 0xc0, 0, 0, 0};
+
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss_pack_buffer(buffer, &value, 1, OPAL_DOUBLE));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss_pack_buffer(buffer, &fvalue, 1, OPAL_FLOAT));
+    ASSERT_EQ(sizeof(double_bytes) + sizeof(float_bytes), buffer->bytes_used);
+    EXPECT_EQ(0, memcmp(buffer->base_ptr, double_bytes, sizeof(double_bytes)));
+    EXPECT_EQ(0, memcmp(buffer->base_ptr + sizeof(double_bytes), float_bytes, sizeof(float_bytes)));
+    OBJ_RELEASE(buffer);
+}
+
+TEST_F(dss_tests, text_encoding_still_available)
+{
+    double in = 21.123456789, out = 0.0;
+    int32_t n = 1;
+    char *str = NULL;
+    opal_buffer_t *buffer = OBJ_NEW(opal_buffer_t);
+
+    opal_dss_float_encoding = OPAL_DSS_FLOAT_TEXT;
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss_pack_buffer(buffer, &in, 1, OPAL_DOUBLE));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss_pack_buffer(buffer, &in, 1, OPAL_DOUBLE));
+
+    /* what an older peer sends and expects: a "%f" string */
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss_unpack_buffer(buffer, &str, &n, OPAL_STRING));
+    EXPECT_STREQ("21.123457", str);
+    free(str);
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss_unpack_buffer(buffer, &out, &n, OPAL_DOUBLE));
+    EXPECT_NEAR(in, out, 1e-6);
+    OBJ_RELEASE(buffer);
+}
+
+TEST_F(dss_tests, either_encoding_is_read_whatever_the_local_one)
+{
+    double in[] = {21.5, M_PI}, out[2];
+    int32_t n;
+    opal_buffer_t *buffer = OBJ_NEW(opal_buffer_t);
+
+    /* an older peer's text value followed by a binary one */
+    opal_dss_float_encoding = OPAL_DSS_FLOAT_TEXT;
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss_pack_buffer(buffer, &in[0], 1, OPAL_DOUBLE));
+    opal_dss_float_encoding = OPAL_DSS_FLOAT_BINARY;
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss_pack_buffer(buffer, &in[1], 1, OPAL_DOUBLE));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss_pack_buffer(buffer, &in[0], 1, OPAL_DOUBLE));
+    opal_dss_float_encoding = OPAL_DSS_FLOAT_TEXT;
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss_pack_buffer(buffer, &in[1], 1, OPAL_DOUBLE));
+
+    opal_dss_float_encoding = OPAL_DSS_FLOAT_BINARY;
+    n = 2;
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss_unpack_buffer(buffer, out, &n, OPAL_DOUBLE));
+    EXPECT_EQ(in[0], out[0]);
+    EXPECT_EQ(in[1], out[1]);
+
+    opal_dss_float_encoding = OPAL_DSS_FLOAT_TEXT;
+    n = 2;
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss_unpack_buffer(buffer, out, &n, OPAL_DOUBLE));
+    EXPECT_EQ(in[0], out[0]);
+    EXPECT_NEAR(in[1], out[1], 1e-6);
+    OBJ_RELEASE(buffer);
+}
+
+TEST_F(dss_tests, string_view_points_into_buffer)
+{
+    const char *in = "coretemp", *empty = NULL, *view;
+    int32_t len;
+    opal_buffer_t *buffer = OBJ_NEW(opal_buffer_t);
+
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(buffer, &in, 1, OPAL_STRING));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(buffer, &empty, 1, OPAL_STRING));
+
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack_string_view(buffer, &view, &len));
+    EXPECT_STREQ(in, view);
+    EXPECT_EQ((int32_t)strlen(in), len);
+    EXPECT_TRUE(view > buffer->base_ptr && view < buffer->base_ptr + buffer->bytes_used);
+
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack_string_view(buffer, &view, &len));
+    EXPECT_EQ(NULL, view);
+    EXPECT_EQ(0, len);
+
+    EXPECT_EQ(OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER,
+              opal_dss.unpack_string_view(buffer, &view, NULL));
+    OBJ_RELEASE(buffer);
+}
+
+TEST_F(dss_tests, string_view_needs_a_single_value)
+{
+    const char *in[] = {"a", "b"}, *view;
+    opal_buffer_t *buffer = OBJ_NEW(opal_buffer_t);
+
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(buffer, in, 2, OPAL_STRING));
+    EXPECT_EQ(OPAL_ERR_UNPACK_INADEQUATE_SPACE,
+              opal_dss.unpack_string_view(buffer, &view, NULL));
+    OBJ_RELEASE(buffer);
+}
+
+TEST_F(dss_tests, view_checks_type_in_described_buffer)
+{
+    int32_t value = 7;
+    const char *view;
+    opal_buffer_t *buffer = OBJ_NEW(opal_buffer_t);
+
+    buffer->type = OPAL_DSS_BUFFER_FULLY_DESC;
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(buffer, &value, 1, OPAL_INT32));
+    EXPECT_EQ(OPAL_ERR_PACK_MISMATCH, opal_dss.unpack_string_view(buffer, &view, NULL));
+    OBJ_RELEASE(buffer);
+
+    buffer = OBJ_NEW(opal_buffer_t);
+    buffer->type = OPAL_DSS_BUFFER_FULLY_DESC;
+    view = "described";
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(buffer, &view, 1, OPAL_STRING));
+    view = NULL;
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack_string_view(buffer, &view, NULL));
+    EXPECT_STREQ("described", view);
+    OBJ_RELEASE(buffer);
+}
+
+TEST_F(dss_tests, bytes_view_points_into_buffer)
+{
+    uint8_t bytes[] = {0, 1, 2, 0xff};
+    opal_byte_object_t in = {sizeof(bytes), bytes}, *pin = &in, view;
+    opal_buffer_t *buffer = OBJ_NEW(opal_buffer_t);
+
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(buffer, &pin, 1, OPAL_BYTE_OBJECT));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack_bytes_view(buffer, &view));
+    ASSERT_EQ((int32_t)sizeof(bytes), view.size);
+    EXPECT_EQ(0, memcmp(bytes, view.bytes, sizeof(bytes)));
+    EXPECT_TRUE((char*)view.bytes > buffer->base_ptr &&
+                (char*)view.bytes < buffer->base_ptr + buffer->bytes_used);
+    OBJ_RELEASE(buffer);
+}
+
+TEST_F(dss_tests, buffer_view_borrows_parent_memory)
+{
+    const char *name = "heartbeat", *view_name;
+    int32_t value = 42, out, n = 1;
+    opal_buffer_t *inner = OBJ_NEW(opal_buffer_t);
+    opal_buffer_t *outer = OBJ_NEW(opal_buffer_t);
+    opal_buffer_t view;
+
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(inner, &name, 1, OPAL_STRING));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(inner, &value, 1, OPAL_INT32));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(outer, &inner, 1, OPAL_BUFFER));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(outer, &inner, 1, OPAL_BUFFER));
+    OBJ_RELEASE(inner);
+
+    /* one view object serves every nested buffer in turn */
+    OBJ_CONSTRUCT(&view, opal_buffer_t);
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack_buffer_view(outer, &view));
+        EXPECT_TRUE(view.borrowed);
+        EXPECT_TRUE(view.base_ptr > outer->base_ptr &&
+                    view.base_ptr < outer->base_ptr + outer->bytes_used);
+        ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack_string_view(&view, &view_name, NULL));
+        EXPECT_STREQ(name, view_name);
+        ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack(&view, &out, &n, OPAL_INT32));
+        EXPECT_EQ(value, out);
+    }
+    EXPECT_EQ(OPAL_ERR_UNPACK_READ_PAST_END_OF_BUFFER,
+              opal_dss.unpack_buffer_view(outer, &view));
+    OBJ_DESTRUCT(&view);
+    OBJ_RELEASE(outer);
+}
+
+TEST_F(dss_tests, buffer_view_copies_before_it_changes)
+{
+    int32_t value = 5, out, n = 1, size;
+    opal_buffer_t *inner = OBJ_NEW(opal_buffer_t);
+    opal_buffer_t *outer = OBJ_NEW(opal_buffer_t);
+    opal_buffer_t *view = OBJ_NEW(opal_buffer_t);
+    char *parent_copy;
+    size_t parent_size;
+    void *payload;
+
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(inner, &value, 1, OPAL_INT32));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(outer, &inner, 1, OPAL_BUFFER));
+    OBJ_RELEASE(inner);
+    parent_size = outer->bytes_used;
+    parent_copy = (char*)malloc(parent_size);
+    memcpy(parent_copy, outer->base_ptr, parent_size);
+
+    /* packing into a view leaves the parent alone */
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack_buffer_view(outer, view));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(view, &value, 1, OPAL_INT32));
+    EXPECT_FALSE(view->borrowed);
+    EXPECT_EQ(0, memcmp(parent_copy, outer->base_ptr, parent_size));
+    for (int i = 0; i < 2; i++) {
+        ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack(view, &out, &n, OPAL_INT32));
+        EXPECT_EQ(value, out);
+    }
+    OBJ_RELEASE(view);
+
+    /* and an unloaded view hands over memory of its own */
+    outer->unpack_ptr = outer->base_ptr;
+    view = OBJ_NEW(opal_buffer_t);
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack_buffer_view(outer, view));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.unload(view, &payload, &size));
+    EXPECT_TRUE((char*)payload < outer->base_ptr ||
+                (char*)payload >= outer->base_ptr + outer->bytes_used);
+    free(payload);
+    OBJ_RELEASE(view);
+
+    free(parent_copy);
+    OBJ_RELEASE(outer);
+}
+
+static double seconds(void)
+{
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/* pack and then unpack BENCH_VALUES values in chunks the size of a
+ * typical sensor sample, and report the rate of each */
+static void bench(const char *name, opal_data_type_t type, void *values, size_t size)
+{
+    opal_buffer_t *buffer = OBJ_NEW(opal_buffer_t);
+    char *out = (char*)malloc(BENCH_CHUNK * size);
+    double start, packed, unpacked;
+    int32_t n;
+    int i;
+
+    start = seconds();
+    for (i = 0; i < BENCH_VALUES; i += BENCH_CHUNK) {
+        ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(buffer, (char*)values + i * size, BENCH_CHUNK, type));
+    }
+    packed = seconds() - start;
+
+    start = seconds();
+    for (i = 0; i < BENCH_VALUES; i += BENCH_CHUNK) {
+        n = BENCH_CHUNK;
+        ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack(buffer, out, &n, type));
+        if (OPAL_STRING == type) {
+            for (int j = 0; j < n; j++) {
+                free(((char**)out)[j]);
+            }
+        }
+    }
+    unpacked = seconds() - start;
+
+    printf("dss %-12s pack %12.0f values/s  unpack %12.0f values/s  %8.2f bytes/value\n",
+           name, BENCH_VALUES / packed, BENCH_VALUES / unpacked,
+           (double)buffer->bytes_used / BENCH_VALUES);
+    free(out);
+    OBJ_RELEASE(buffer);
+}
+
+/* the heartbeat path: one string at a time, copied out or viewed */
+static void bench_string_view(void)
+{
+    opal_buffer_t *buffer = OBJ_NEW(opal_buffer_t);
+    const char *in = "coretemp", *view;
+    char *out;
+    double start, copied, viewed;
+    int32_t n;
+    int i;
+
+    for (i = 0; i < BENCH_VALUES; i++) {
+        ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(buffer, &in, 1, OPAL_STRING));
+    }
+
+    start = seconds();
+    for (i = 0; i < BENCH_VALUES; i++) {
+        n = 1;
+        ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack(buffer, &out, &n, OPAL_STRING));
+        free(out);
+    }
+    copied = seconds() - start;
+
+    buffer->unpack_ptr = buffer->base_ptr;
+    start = seconds();
+    for (i = 0; i < BENCH_VALUES; i++) {
+        ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack_string_view(buffer, &view, NULL));
+    }
+    viewed = seconds() - start;
+
+    printf("dss %-12s unpack %12.0f values/s  view %12.0f values/s\n",
+           "string/1", BENCH_VALUES / copied, BENCH_VALUES / viewed);
+    OBJ_RELEASE(buffer);
+}
+
+TEST_F(dss_tests, benchmark)
+{
+    int32_t *i32 = (int32_t*)malloc(BENCH_VALUES * sizeof(int32_t));
+    int64_t *i64 = (int64_t*)malloc(BENCH_VALUES * sizeof(int64_t));
+    float *f = (float*)malloc(BENCH_VALUES * sizeof(float));
+    double *d = (double*)malloc(BENCH_VALUES * sizeof(double));
+    char **s = (char**)malloc(BENCH_VALUES * sizeof(char*));
+
+    for (int i = 0; i < BENCH_VALUES; i++) {
+        i32[i] = i;
+        i64[i] = (int64_t)i << 20;
+        f[i] = 20.0f + i / 1000.0f;
+        d[i] = 1000.0 + i / 7.0;
+        s[i] = (char*)"coretemp";
+    }
+
+    bench("int32", OPAL_INT32, i32, sizeof(int32_t));
+    bench("int64", OPAL_INT64, i64, sizeof(int64_t));
+    bench("string", OPAL_STRING, s, sizeof(char*));
+    bench("float", OPAL_FLOAT, f, sizeof(float));
+    bench("double", OPAL_DOUBLE, d, sizeof(double));
+    bench_string_view();
+    opal_dss_float_encoding = OPAL_DSS_FLOAT_TEXT;
+    bench("float/text", OPAL_FLOAT, f, sizeof(float));
+    bench("double/text", OPAL_DOUBLE, d, sizeof(double));
+
+    free(i32);
+    free(i64);
+    free(f);
+    free(d);
+    free(s);
+}
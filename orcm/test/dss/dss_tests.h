@@ -0,0 +1,21 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#ifndef GREI_ORCM_TEST_DSS_DSS_TESTS_H
+#define GREI_ORCM_TEST_DSS_DSS_TESTS_H
+
+#include "gtest/gtest.h"
+
+extern "C" {
+    #include "opal/runtime/opal.h"
+    #include "opal/dss/dss.h"
+    #include "opal/dss/dss_internal.h"
+};
+
+class dss_tests : public testing::Test
+{
+    protected:
+        static void SetUpTestCase();
+        virtual void TearDown();
+};
+
+#endif
@@ -0,0 +1,176 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#include "cfgi_base_tests.h"
+
+static void name_node(orcm_node_t *node, const char *name, orte_vpid_t vpid)
+{
+    node->name = strdup(name);
+    node->daemon.jobid = 0;
+    node->daemon.vpid = vpid;
+}
+
+static orcm_node_t* add_node(orcm_rack_t *rack, const char *name, orte_vpid_t vpid)
+{
+    orcm_node_t *node = OBJ_NEW(orcm_node_t);
+
+    name_node(node, name, vpid);
+    opal_list_append(&rack->nodes, &node->super);
+    return node;
+}
+
+/* one cluster with an aggregator per row and rack:
+ *   agg01 (row)  ->  agg02 (rack r1) -> c01 c02
+ *                ->  rack r2, no controller -> c03
+ */
+static void define_system(void)
+{
+    orcm_cluster_t *cluster = OBJ_NEW(orcm_cluster_t);
+    orcm_row_t *row = OBJ_NEW(orcm_row_t);
+    orcm_rack_t *rack;
+
+    opal_list_append(orcm_clusters, &cluster->super);
+    opal_list_append(&cluster->rows, &row->super);
+    name_node(&row->controller, "agg01", 1);
+
+    rack = OBJ_NEW(orcm_rack_t);
+    opal_list_append(&row->racks, &rack->super);
+    name_node(&rack->controller, "agg02", 2);
+    add_node(rack, "c01", 3);
+    add_node(rack, "c02", 4);
+
+    rack = OBJ_NEW(orcm_rack_t);
+    opal_list_append(&row->racks, &rack->super);
+    add_node(rack, "c03", 5);
+}
+
+static orcm_rack_t* get_rack(int index)
+{
+    orcm_cluster_t *cluster = (orcm_cluster_t*)opal_list_get_first(orcm_clusters);
+    orcm_row_t *row = (orcm_row_t*)opal_list_get_first(&cluster->rows);
+    orcm_rack_t *rack = (orcm_rack_t*)opal_list_get_first(&row->racks);
+
+    while (0 < index--) {
+        rack = (orcm_rack_t*)opal_list_get_next(&rack->super);
+    }
+    return rack;
+}
+
+void cfgi_base_tests::SetUpTestCase()
+{
+    opal_init_test();
+}
+
+void cfgi_base_tests::SetUp()
+{
+    orcm_clusters = OBJ_NEW(opal_list_t);
+    orcm_schedulers = OBJ_NEW(opal_list_t);
+    define_system();
+    ASSERT_EQ(ORCM_SUCCESS, orcm_cfgi_base_directory_update());
+}
+
+void cfgi_base_tests::TearDown()
+{
+    orcm_cfgi_base_directory_clear();
+    OPAL_LIST_RELEASE(orcm_clusters);
+    OPAL_LIST_RELEASE(orcm_schedulers);
+    orcm_clusters = NULL;
+    orcm_schedulers = NULL;
+}
+
+TEST_F(cfgi_base_tests, hostname_and_daemon_lookups)
+{
+    orte_process_name_t proc;
+    char *hostname = NULL;
+
+    ASSERT_EQ(ORCM_SUCCESS, orcm_cfgi_base_get_hostname_proc((char*)"c02", &proc));
+    EXPECT_EQ(0U, proc.jobid);
+    EXPECT_EQ(4U, proc.vpid);
+
+    proc.vpid = 2;
+    ASSERT_EQ(ORCM_SUCCESS, orcm_cfgi_base_get_proc_hostname(&proc, &hostname));
+    EXPECT_STREQ("agg02", hostname);
+    free(hostname);
+
+    EXPECT_EQ(ORCM_ERR_NOT_FOUND, orcm_cfgi_base_get_hostname_proc((char*)"c99", &proc));
+    proc.vpid = 99;
+    EXPECT_EQ(ORCM_ERR_NOT_FOUND, orcm_cfgi_base_get_proc_hostname(&proc, &hostname));
+}
+
+TEST_F(cfgi_base_tests, entries_record_position_and_aggregator)
+{
+    orcm_cfgi_base_dir_entry_t *entry;
+
+    entry = orcm_cfgi_base_directory_find_hostname("c01");
+    ASSERT_TRUE(NULL != entry);
+    EXPECT_EQ(0, entry->cluster_index);
+    EXPECT_EQ(0, entry->row_index);
+    EXPECT_EQ(0, entry->rack_index);
+    EXPECT_EQ(2U, entry->aggregator.vpid);
+
+    /* no rack controller - the row aggregator is the parent */
+    entry = orcm_cfgi_base_directory_find_hostname("c03");
+    ASSERT_TRUE(NULL != entry);
+    EXPECT_EQ(1, entry->rack_index);
+    EXPECT_EQ(1U, entry->aggregator.vpid);
+
+    entry = orcm_cfgi_base_directory_find_hostname("agg02");
+    ASSERT_TRUE(NULL != entry);
+    EXPECT_EQ(1U, entry->aggregator.vpid);
+    EXPECT_TRUE(entry->node == &get_rack(0)->controller);
+}
+
+TEST_F(cfgi_base_tests, update_tracks_added_and_removed_nodes)
+{
+    orcm_rack_t *rack = get_rack(1);
+    orcm_node_t *node;
+    orte_process_name_t proc;
+
+    node = (orcm_node_t*)opal_list_remove_first(&rack->nodes);
+    OBJ_RELEASE(node);
+    add_node(rack, "c04", 6);
+    ASSERT_EQ(ORCM_SUCCESS, orcm_cfgi_base_directory_update());
+
+    EXPECT_TRUE(NULL == orcm_cfgi_base_directory_find_hostname("c03"));
+    proc.jobid = 0;
+    proc.vpid = 5;
+    EXPECT_TRUE(NULL == orcm_cfgi_base_directory_find_daemon(&proc));
+    ASSERT_EQ(ORCM_SUCCESS, orcm_cfgi_base_get_hostname_proc((char*)"c04", &proc));
+    EXPECT_EQ(6U, proc.vpid);
+    ASSERT_EQ(ORCM_SUCCESS, orcm_cfgi_base_get_hostname_proc((char*)"c01", &proc));
+    EXPECT_EQ(3U, proc.vpid);
+}
+
+TEST_F(cfgi_base_tests, duplicate_hostname_resolves_to_first)
+{
+    orte_process_name_t proc;
+
+    add_node(get_rack(1), "c01", 7);
+    ASSERT_EQ(ORCM_SUCCESS, orcm_cfgi_base_directory_update());
+    ASSERT_EQ(ORCM_SUCCESS, orcm_cfgi_base_get_hostname_proc((char*)"c01", &proc));
+    EXPECT_EQ(3U, proc.vpid);
+}
+
+TEST_F(cfgi_base_tests, dependents_of_aggregators)
+{
+    orte_process_name_t root;
+    opal_list_t targets;
+
+    root.jobid = 0;
+    root.vpid = 1;
+    OBJ_CONSTRUCT(&targets, opal_list_t);
+    ASSERT_EQ(ORCM_SUCCESS, orcm_util_get_dependents(&targets, &root));
+    /* both rack controller slots plus the three nodes */
+    EXPECT_EQ(5U, opal_list_get_size(&targets));
+    OPAL_LIST_DESTRUCT(&targets);
+
+    root.vpid = 2;
+    OBJ_CONSTRUCT(&targets, opal_list_t);
+    ASSERT_EQ(ORCM_SUCCESS, orcm_util_get_dependents(&targets, &root));
+    EXPECT_EQ(2U, opal_list_get_size(&targets));
+    OPAL_LIST_DESTRUCT(&targets);
+
+    root.vpid = 3;
+    OBJ_CONSTRUCT(&targets, opal_list_t);
+    EXPECT_EQ(ORCM_ERR_NOT_FOUND, orcm_util_get_dependents(&targets, &root));
+    OPAL_LIST_DESTRUCT(&targets);
+}
@@ -0,0 +1,24 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#ifndef GREI_ORCM_TEST_MCA_CFGI_BASE_CFGI_BASE_TESTS_H
+#define GREI_ORCM_TEST_MCA_CFGI_BASE_CFGI_BASE_TESTS_H
+
+#include "gtest/gtest.h"
+
+extern "C" {
+    #include "opal/runtime/opal.h"
+    #include "orte/util/name_fns.h"
+    #include "orcm/runtime/orcm_globals.h"
+    #include "orcm/mca/cfgi/base/base.h"
+    #include "orcm/util/utils.h"
+};
+
+class cfgi_base_tests : public testing::Test
+{
+    protected:
+        static void SetUpTestCase();
+        virtual void SetUp();
+        virtual void TearDown();
+};
+
+#endif
@@ -0,0 +1,380 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#include "file30_tests.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+/* the layout cache_store writes - kept in step by hand */
+#define IMAGE_MAGIC     "ORCMCFG30"
+#define IMAGE_VERSION   2
+
+#define XML_HASH        0x1234abcdULL
+#define XML_SIZE        4096ULL
+
+static char cache_dir[] = "/tmp/file30_tests_XXXXXX";
+static std::string cache_file;
+
+static int lex(const std::string &text, std::vector<std::string> &out)
+{
+    orcm_cfgi_file30_map_t map;
+    char **items = NULL;
+    unsigned long n = 0, i;
+    int rc;
+
+    map.data = (char*)text.data();
+    map.size = text.size();
+    map.mapped = false;
+    out.clear();
+    rc = orcm_cfgi_file30_lex(&map, &items, &n);
+    if (ORCM_SUCCESS == rc) {
+        for (i = 0; i < n; i++) {
+            out.push_back(items[i]);
+        }
+        EXPECT_TRUE(NULL == items[n]);
+        opal_argv_free(items);
+    }
+    return rc;
+}
+
+static orcm_cfgi_xml_parser_t* add_item(opal_list_t *parent, const char *name,
+                                        const char *value)
+{
+    orcm_cfgi_xml_parser_t *x = OBJ_NEW(orcm_cfgi_xml_parser_t);
+
+    x->name = strdup(name);
+    if (NULL != value) {
+        opal_argv_append_nosize(&x->value, value);
+    }
+    opal_list_append(parent, &x->super);
+    return x;
+}
+
+/* what parse_config makes of a one-node cluster with a scheduler */
+static void make_config(opal_list_t *config)
+{
+    orcm_cfgi_xml_parser_t *top, *cluster, *row, *rack, *node, *sched;
+
+    top = add_item(config, "configuration", NULL);
+    cluster = add_item(&top->subvals, "cluster", "c1");
+    row = add_item(&cluster->subvals, "row", "r1");
+    rack = add_item(&row->subvals, "rack", "k1");
+    node = add_item(&rack->subvals, "node", "n01");
+    add_item(&node->subvals, "port", "55805");
+    sched = add_item(&top->subvals, "scheduler", NULL);
+    add_item(&sched->subvals, "node", "head");
+    add_item(&sched->subvals, "queues", "default");
+}
+
+static void print_config(opal_list_t *items, std::string &out)
+{
+    orcm_cfgi_xml_parser_t *x;
+    int i;
+
+    OPAL_LIST_FOREACH(x, items, orcm_cfgi_xml_parser_t) {
+        out += x->name;
+        for (i = 0; NULL != x->value && NULL != x->value[i]; i++) {
+            out += "=";
+            out += x->value[i];
+        }
+        out += "{";
+        print_config(&x->subvals, out);
+        out += "}";
+    }
+}
+
+static std::string read_image(void)
+{
+    std::string bytes;
+    char buf[512];
+    size_t got;
+    FILE *fp = fopen(cache_file.c_str(), "r");
+
+    if (NULL != fp) {
+        while (0 < (got = fread(buf, 1, sizeof(buf), fp))) {
+            bytes.append(buf, got);
+        }
+        fclose(fp);
+    }
+    return bytes;
+}
+
+static void write_image(const std::string &bytes)
+{
+    FILE *fp = fopen(cache_file.c_str(), "w");
+
+    ASSERT_TRUE(NULL != fp);
+    ASSERT_EQ(1U, fwrite(bytes.data(), bytes.size(), 1, fp));
+    fclose(fp);
+}
+
+/* write an image around a hand-packed payload, with a checksum
+ * that matches it so only the payload itself is on trial */
+static void craft_image(opal_buffer_t *payload)
+{
+    opal_buffer_t head;
+    orcm_cfgi_file30_map_t map;
+    char *pbytes = NULL, *hbytes = NULL;
+    int32_t npbytes = 0, nhbytes = 0, version = IMAGE_VERSION;
+    uint64_t size = XML_SIZE, hash = XML_HASH, sum;
+    std::string bytes(IMAGE_MAGIC, sizeof(IMAGE_MAGIC));
+
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.unload(payload, (void**)&pbytes, &npbytes));
+    map.data = pbytes;
+    map.size = npbytes;
+    map.mapped = false;
+    sum = orcm_cfgi_file30_hash(&map);
+
+    OBJ_CONSTRUCT(&head, opal_buffer_t);
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(&head, &version, 1, OPAL_INT32));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(&head, &size, 1, OPAL_UINT64));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(&head, &hash, 1, OPAL_UINT64));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(&head, &sum, 1, OPAL_UINT64));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.unload(&head, (void**)&hbytes, &nhbytes));
+    OBJ_DESTRUCT(&head);
+
+    bytes.append(hbytes, nhbytes);
+    bytes.append(pbytes, npbytes);
+    free(hbytes);
+    free(pbytes);
+    write_image(bytes);
+}
+
+static void pack_item(opal_buffer_t *buf, const char *name, int32_t nvalues,
+                      int32_t nsubvals)
+{
+    char *value = (char*)"v";
+    int32_t i;
+
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(buf, &name, 1, OPAL_STRING));
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(buf, &nvalues, 1, OPAL_INT32));
+    for (i = 0; i < nvalues && i < 4; i++) {
+        ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(buf, &value, 1, OPAL_STRING));
+    }
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.pack(buf, &nsubvals, 1, OPAL_INT32));
+}
+
+/* true if the image on disk loads for the XML it claims to come from */
+static bool image_loads(void)
+{
+    opal_list_t config;
+    int rc;
+
+    OBJ_CONSTRUCT(&config, opal_list_t);
+    rc = orcm_cfgi_file30_cache_load(XML_HASH, XML_SIZE, &config);
+    if (ORCM_SUCCESS != rc) {
+        /* a refused image leaves nothing behind */
+        EXPECT_EQ(0U, opal_list_get_size(&config));
+    }
+    OPAL_LIST_DESTRUCT(&config);
+    return (ORCM_SUCCESS == rc);
+}
+
+void file30_tests::SetUpTestCase()
+{
+    opal_init_test();
+    ASSERT_TRUE(NULL != mkdtemp(cache_dir));
+    cache_file = std::string(cache_dir) + "/orcm-site.xml.cache";
+}
+
+void file30_tests::SetUp()
+{
+    mca_cfgi_file30_component.cache_file = strdup(cache_file.c_str());
+}
+
+void file30_tests::TearDown()
+{
+    unlink(cache_file.c_str());
+    free(mca_cfgi_file30_component.cache_file);
+    mca_cfgi_file30_component.cache_file = NULL;
+}
+
+TEST_F(file30_tests, lex_tags_fields_and_directives)
+{
+    std::vector<std::string> items;
+
+    ASSERT_EQ(ORCM_SUCCESS, lex("<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"
+                                "<!-- a > inside a comment -->\n"
+                                "<configuration>\n"
+                                "  <version>3.0</version>\n"
+                                "  <name>\"two\twords here\"</name>\n"
+                                "  <port> 55805 </port>\n"
+                                "</configuration>\n", items));
+    ASSERT_EQ(11U, items.size());
+    EXPECT_EQ("configuration", items[0]);
+    EXPECT_EQ("version", items[1]);
+    EXPECT_EQ("\t3.0", items[2]);
+    EXPECT_EQ("/version", items[3]);
+    EXPECT_EQ("name", items[4]);
+    /* quoted text keeps its blanks, tabs turn into them */
+    EXPECT_EQ("\ttwo words here", items[5]);
+    EXPECT_EQ("/name", items[6]);
+    EXPECT_EQ("\t55805", items[8]);
+    EXPECT_EQ("/configuration", items[10]);
+}
+
+TEST_F(file30_tests, lex_rejects_broken_text)
+{
+    std::vector<std::string> items;
+    const std::string pad(32, ' ');
+
+    /* too short to hold a configuration */
+    EXPECT_NE(ORCM_SUCCESS, lex("<configuration/>", items));
+    /* a tag that never closes */
+    EXPECT_EQ(ORCM_ERR_BAD_PARAM, lex(pad + "<configuration><version", items));
+    /* nor does the quote */
+    EXPECT_EQ(ORCM_ERR_BAD_PARAM, lex(pad + "<name>\"open</name>", items));
+    /* a control character inside a tag */
+    EXPECT_EQ(ORCM_ERR_BAD_PARAM, lex(pad + "<confi\001guration>", items));
+    /* a comment that never ends */
+    EXPECT_EQ(ORCM_ERR_BAD_PARAM, lex(pad + "<!-- runs off >", items));
+    /* nothing but blanks and comments */
+    EXPECT_EQ(ORCM_ERR_BAD_PARAM, lex(pad + "<!-- only a comment -->", items));
+}
+
+TEST_F(file30_tests, store_then_load)
+{
+    opal_list_t config, loaded;
+    std::string expect, got;
+
+    OBJ_CONSTRUCT(&config, opal_list_t);
+    OBJ_CONSTRUCT(&loaded, opal_list_t);
+    make_config(&config);
+    orcm_cfgi_file30_cache_store(XML_HASH, XML_SIZE, &config);
+
+    ASSERT_EQ(ORCM_SUCCESS, orcm_cfgi_file30_cache_load(XML_HASH, XML_SIZE, &loaded));
+    print_config(&config, expect);
+    print_config(&loaded, got);
+    EXPECT_EQ(expect, got);
+
+    OPAL_LIST_DESTRUCT(&config);
+    OPAL_LIST_DESTRUCT(&loaded);
+}
+
+TEST_F(file30_tests, stale_for_another_xml)
+{
+    opal_list_t config;
+
+    OBJ_CONSTRUCT(&config, opal_list_t);
+    EXPECT_EQ(ORCM_ERR_NOT_FOUND, orcm_cfgi_file30_cache_load(XML_HASH, XML_SIZE, &config));
+
+    make_config(&config);
+    orcm_cfgi_file30_cache_store(XML_HASH, XML_SIZE, &config);
+    OPAL_LIST_DESTRUCT(&config);
+    OBJ_CONSTRUCT(&config, opal_list_t);
+
+    EXPECT_EQ(ORCM_ERR_NOT_FOUND, orcm_cfgi_file30_cache_load(XML_HASH + 1, XML_SIZE, &config));
+    EXPECT_EQ(ORCM_ERR_NOT_FOUND, orcm_cfgi_file30_cache_load(XML_HASH, XML_SIZE + 1, &config));
+    EXPECT_EQ(0U, opal_list_get_size(&config));
+    EXPECT_TRUE(image_loads());
+    OPAL_LIST_DESTRUCT(&config);
+}
+
+TEST_F(file30_tests, stale_when_damaged)
+{
+    opal_list_t config;
+    std::string good, bad;
+
+    OBJ_CONSTRUCT(&config, opal_list_t);
+    make_config(&config);
+    orcm_cfgi_file30_cache_store(XML_HASH, XML_SIZE, &config);
+    OPAL_LIST_DESTRUCT(&config);
+    good = read_image();
+    ASSERT_LT(32U, good.size());
+
+    /* a flipped bit anywhere in the configuration */
+    bad = good;
+    bad[bad.size() - 2] ^= 0x01;
+    write_image(bad);
+    EXPECT_FALSE(image_loads());
+
+    /* torn short */
+    write_image(good.substr(0, good.size() - 3));
+    EXPECT_FALSE(image_loads());
+
+    /* or trailing junk */
+    write_image(good + "x");
+    EXPECT_FALSE(image_loads());
+
+    /* not an image at all */
+    write_image("<configuration>");
+    EXPECT_FALSE(image_loads());
+
+    write_image(good);
+    EXPECT_TRUE(image_loads());
+}
+
+TEST_F(file30_tests, stale_on_bad_counts)
+{
+    opal_buffer_t payload;
+    int32_t n;
+    int i;
+
+    /* first prove the hand-made images match what the loader reads */
+    OBJ_CONSTRUCT(&payload, opal_buffer_t);
+    n = 1;
+    opal_dss.pack(&payload, &n, 1, OPAL_INT32);
+    pack_item(&payload, "configuration", 0, 1);
+    pack_item(&payload, "cluster", 1, 0);
+    craft_image(&payload);
+    OBJ_DESTRUCT(&payload);
+    EXPECT_TRUE(image_loads());
+
+    /* a negative or huge item count */
+    OBJ_CONSTRUCT(&payload, opal_buffer_t);
+    n = -1;
+    opal_dss.pack(&payload, &n, 1, OPAL_INT32);
+    craft_image(&payload);
+    OBJ_DESTRUCT(&payload);
+    EXPECT_FALSE(image_loads());
+
+    OBJ_CONSTRUCT(&payload, opal_buffer_t);
+    n = 0x7fffffff;
+    opal_dss.pack(&payload, &n, 1, OPAL_INT32);
+    pack_item(&payload, "configuration", 0, 0);
+    craft_image(&payload);
+    OBJ_DESTRUCT(&payload);
+    EXPECT_FALSE(image_loads());
+
+    /* a value count far past the end of the image */
+    OBJ_CONSTRUCT(&payload, opal_buffer_t);
+    n = 1;
+    opal_dss.pack(&payload, &n, 1, OPAL_INT32);
+    pack_item(&payload, "configuration", 0x10000000, 0);
+    craft_image(&payload);
+    OBJ_DESTRUCT(&payload);
+    EXPECT_FALSE(image_loads());
+
+    /* negative and huge counts of sub-items */
+    OBJ_CONSTRUCT(&payload, opal_buffer_t);
+    n = 1;
+    opal_dss.pack(&payload, &n, 1, OPAL_INT32);
+    pack_item(&payload, "configuration", 0, -5);
+    craft_image(&payload);
+    OBJ_DESTRUCT(&payload);
+    EXPECT_FALSE(image_loads());
+
+    OBJ_CONSTRUCT(&payload, opal_buffer_t);
+    n = 1;
+    opal_dss.pack(&payload, &n, 1, OPAL_INT32);
+    pack_item(&payload, "configuration", 0, 0x7fffffff);
+    pack_item(&payload, "cluster", 1, 0);
+    craft_image(&payload);
+    OBJ_DESTRUCT(&payload);
+    EXPECT_FALSE(image_loads());
+
+    /* nested far deeper than any configuration */
+    OBJ_CONSTRUCT(&payload, opal_buffer_t);
+    n = 1;
+    opal_dss.pack(&payload, &n, 1, OPAL_INT32);
+    for (i = 0; i < 64; i++) {
+        pack_item(&payload, "rack", 1, 1);
+    }
+    pack_item(&payload, "node", 1, 0);
+    craft_image(&payload);
+    OBJ_DESTRUCT(&payload);
+    EXPECT_FALSE(image_loads());
+}
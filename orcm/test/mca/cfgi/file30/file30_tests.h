@@ -0,0 +1,25 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#ifndef GREI_ORCM_TEST_MCA_CFGI_FILE30_FILE30_TESTS_H
+#define GREI_ORCM_TEST_MCA_CFGI_FILE30_FILE30_TESTS_H
+
+#include "gtest/gtest.h"
+
+extern "C" {
+    #include "opal/runtime/opal.h"
+    #include "opal/dss/dss.h"
+    #include "opal/util/argv.h"
+    #include "orcm/constants.h"
+    #include "orcm/mca/cfgi/base/base.h"
+    #include "orcm/mca/cfgi/file30/cfgi_file30.h"
+};
+
+class file30_tests : public testing::Test
+{
+    protected:
+        static void SetUpTestCase();
+        virtual void SetUp();
+        virtual void TearDown();
+};
+
+#endif
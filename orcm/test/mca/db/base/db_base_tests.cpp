@@ -0,0 +1,315 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#include "db_base_tests.h"
+#include <math.h>
+#include <string>
+
+static orcm_db_aggregate_t* sensor_aggregate(orcm_db_aggregate_fn_t function, uint32_t interval)
+{
+    orcm_db_aggregate_t *aggregate = OBJ_NEW(orcm_db_aggregate_t);
+
+    aggregate->columns = opal_argv_split("hostname,data_item,time_stamp,value_str,units", ',');
+    aggregate->group_by = opal_argv_split("hostname,data_item,units", ',');
+    aggregate->time_column = strdup("time_stamp");
+    aggregate->value_column = strdup("value_str");
+    aggregate->interval = interval;
+    aggregate->function = function;
+    return aggregate;
+}
+
+static orcm_db_filter_t* string_filter(const char *key, const char *value,
+                                       orcm_db_comparison_op_t op)
+{
+    orcm_db_filter_t *filter = OBJ_NEW(orcm_db_filter_t);
+
+    filter->value.key = strdup(key);
+    filter->value.type = OPAL_STRING;
+    filter->value.data.string = strdup(value);
+    filter->op = op;
+    return filter;
+}
+
+TEST(db_base_aggregate, hourly_average_by_host_and_metric)
+{
+    orcm_db_aggregate_t *aggregate = sensor_aggregate(ORCM_DB_AGG_AVG, 3600);
+    opal_list_t filters;
+    char *query;
+
+    OBJ_CONSTRUCT(&filters, opal_list_t);
+    opal_list_append(&filters, &string_filter("data_item", "%power%", CONTAINS)->value.super);
+    opal_list_append(&filters, &string_filter("hostname", "'c01','c02'", IN)->value.super);
+
+    query = build_aggregate_query_from_view_name_and_filters("data_sensors_view",
+                                                             &filters, aggregate);
+    ASSERT_TRUE(NULL != query);
+    std::string sql(query);
+    EXPECT_EQ(0U, sql.find("select hostname, data_item, concat(to_timestamp(floor(extract(epoch from "
+                           "cast(time_stamp as timestamp)) / 3600) * 3600) at time zone 'UTC') as time_stamp, "
+                           "concat(avg(cast(value_str as double precision))) as value_str, units "
+                           "from data_sensors_view where data_item like '%power%' and hostname in ('c01','c02') "
+                           "and value_str ~ "));
+    EXPECT_NE(std::string::npos, sql.find(" group by 1,2,3,5 order by 1,2,3,5;"));
+
+    free(query);
+    OPAL_LIST_DESTRUCT(&filters);
+    OBJ_RELEASE(aggregate);
+}
+
+TEST(db_base_aggregate, percentile_over_whole_range)
+{
+    orcm_db_aggregate_t *aggregate = sensor_aggregate(ORCM_DB_AGG_PERCENTILE, 0);
+    char *query;
+
+    aggregate->percentile = 0.95;
+    opal_argv_free(aggregate->group_by);
+    aggregate->group_by = opal_argv_split("data_item,units", ',');
+
+    query = build_aggregate_query_from_view_name_and_filters("data_sensors_view", NULL, aggregate);
+    ASSERT_TRUE(NULL != query);
+    std::string sql(query);
+    EXPECT_EQ(0U, sql.find("select cast('*' as text) as hostname, data_item, concat(min(time_stamp)) as time_stamp, "
+                           "concat(percentile_cont(0.950000) within group (order by cast(value_str as "
+                           "double precision))) as value_str, units from data_sensors_view where value_str ~ "));
+    EXPECT_NE(std::string::npos, sql.find(" group by 2,5 order by 2,5;"));
+
+    free(query);
+    OBJ_RELEASE(aggregate);
+}
+
+TEST(db_base_aggregate, count_keeps_non_numeric_rows)
+{
+    orcm_db_aggregate_t *aggregate = sensor_aggregate(ORCM_DB_AGG_COUNT, 60);
+    char *query;
+
+    opal_argv_free(aggregate->group_by);
+    aggregate->group_by = NULL;
+
+    query = build_aggregate_query_from_view_name_and_filters("data_sensors_view", NULL, aggregate);
+    ASSERT_TRUE(NULL != query);
+    EXPECT_STREQ("select cast('*' as text) as hostname, cast('*' as text) as data_item, concat(to_timestamp(floor(extract(epoch from "
+                 "cast(time_stamp as timestamp)) / 60) * 60) at time zone 'UTC') as time_stamp, "
+                 "concat(count(value_str)) as value_str, cast('*' as text) as units from data_sensors_view "
+                 "group by 3 order by 3;", query);
+
+    free(query);
+    OBJ_RELEASE(aggregate);
+}
+
+TEST(db_base_aggregate, invalid_spec)
+{
+    orcm_db_aggregate_t *aggregate = sensor_aggregate(ORCM_DB_AGG_PERCENTILE, 0);
+
+    aggregate->percentile = 1.5;
+    EXPECT_TRUE(NULL == build_aggregate_query_from_view_name_and_filters("data_sensors_view",
+                                                                         NULL, aggregate));
+    aggregate->percentile = NAN;
+    EXPECT_TRUE(NULL == build_aggregate_query_from_view_name_and_filters("data_sensors_view",
+                                                                         NULL, aggregate));
+    aggregate->percentile = 0.5;
+    EXPECT_TRUE(NULL == build_aggregate_query_from_view_name_and_filters(NULL, NULL, aggregate));
+    EXPECT_TRUE(NULL == build_aggregate_query_from_view_name_and_filters("data_sensors_view",
+                                                                         NULL, NULL));
+    OBJ_RELEASE(aggregate);
+}
+
+/* midnight of the local day holding when, plus the given wall clock */
+static std::string local_day_stamp(time_t when, const char *clock)
+{
+    char buffer[32];
+
+    strftime(buffer, sizeof(buffer), "%F ", localtime(&when));
+    return std::string(buffer) + clock;
+}
+
+TEST(db_base_rollup, select_coarsest_tier)
+{
+    orcm_db_aggregate_t *aggregate = sensor_aggregate(ORCM_DB_AGG_AVG, 3600);
+    time_t now = time(NULL);
+    const orcm_db_rollup_tier_t *tier;
+    opal_list_t filters;
+
+    orcm_db_base.rollup = true;
+    OBJ_CONSTRUCT(&filters, opal_list_t);
+    opal_list_append(&filters, &string_filter("hostname", "c01", EQ)->value.super);
+    opal_list_append(&filters, &string_filter("time_stamp",
+                                              local_day_stamp(now - 86400, "00:00:00").c_str(),
+                                              GE)->value.super);
+
+    /* hourly buckets: the day tier can't split them */
+    tier = orcm_db_base_rollup_select("data_sensors_view", &filters, aggregate, now);
+    ASSERT_TRUE(NULL != tier);
+    EXPECT_STREQ("data_sample_rollup_hour", tier->table);
+
+    aggregate->interval = 2 * 86400;
+    tier = orcm_db_base_rollup_select("data_sensors_view", &filters, aggregate, now);
+    ASSERT_TRUE(NULL != tier);
+    EXPECT_STREQ("data_sample_rollup_day", tier->table);
+
+    aggregate->interval = 900;
+    tier = orcm_db_base_rollup_select("data_sensors_view", &filters, aggregate, now);
+    ASSERT_TRUE(NULL != tier);
+    EXPECT_STREQ("data_sample_rollup_minute", tier->table);
+
+    /* sub-minute buckets need the raw samples */
+    aggregate->interval = 30;
+    EXPECT_TRUE(NULL == orcm_db_base_rollup_select("data_sensors_view", &filters, aggregate, now));
+
+    OPAL_LIST_DESTRUCT(&filters);
+    OBJ_RELEASE(aggregate);
+    orcm_db_base.rollup = false;
+}
+
+TEST(db_base_rollup, select_respects_retention)
+{
+    orcm_db_aggregate_t *aggregate = sensor_aggregate(ORCM_DB_AGG_MAX, 900);
+    time_t now = time(NULL);
+    opal_list_t filters;
+
+    orcm_db_base.rollup = true;
+
+    /* no start time, and the minute tier only keeps a week */
+    EXPECT_TRUE(NULL == orcm_db_base_rollup_select("data_sensors_view", NULL, aggregate, now));
+
+    OBJ_CONSTRUCT(&filters, opal_list_t);
+    opal_list_append(&filters, &string_filter("time_stamp",
+                                              local_day_stamp(now - 30 * 86400, "00:00:00").c_str(),
+                                              GE)->value.super);
+    EXPECT_TRUE(NULL == orcm_db_base_rollup_select("data_sensors_view", &filters, aggregate, now));
+
+    aggregate->interval = 3600;
+    EXPECT_STREQ("data_sample_rollup_hour",
+                 orcm_db_base_rollup_select("data_sensors_view", &filters, aggregate, now)->table);
+
+    OPAL_LIST_DESTRUCT(&filters);
+    OBJ_RELEASE(aggregate);
+    orcm_db_base.rollup = false;
+}
+
+TEST(db_base_rollup, select_needs_whole_periods)
+{
+    orcm_db_aggregate_t *aggregate = sensor_aggregate(ORCM_DB_AGG_AVG, 3600);
+    time_t now = time(NULL);
+    opal_list_t filters;
+    orcm_db_filter_t *start, *end;
+
+    orcm_db_base.rollup = true;
+    OBJ_CONSTRUCT(&filters, opal_list_t);
+    start = string_filter("time_stamp", local_day_stamp(now - 2 * 86400, "01:30:00").c_str(), GE);
+    end = string_filter("time_stamp", local_day_stamp(now - 86400, "00:00:00").c_str(), LT);
+    opal_list_append(&filters, &start->value.super);
+    opal_list_append(&filters, &end->value.super);
+
+    /* a start half way into an hour only lines up with minutes */
+    EXPECT_STREQ("data_sample_rollup_minute",
+                 orcm_db_base_rollup_select("data_sensors_view", &filters, aggregate, now)->table);
+
+    free(start->value.data.string);
+    start->value.data.string = strdup(local_day_stamp(now - 2 * 86400, "01:00:00").c_str());
+    EXPECT_STREQ("data_sample_rollup_hour",
+                 orcm_db_base_rollup_select("data_sensors_view", &filters, aggregate, now)->table);
+
+    /* an end inside a minute leaves a partial period */
+    free(end->value.data.string);
+    end->value.data.string = strdup(local_day_stamp(now - 86400, "00:00:30").c_str());
+    EXPECT_TRUE(NULL == orcm_db_base_rollup_select("data_sensors_view", &filters, aggregate, now));
+    free(end->value.data.string);
+    end->value.data.string = strdup(local_day_stamp(now - 86400, "00:00:00.250").c_str());
+    EXPECT_TRUE(NULL == orcm_db_base_rollup_select("data_sensors_view", &filters, aggregate, now));
+    free(end->value.data.string);
+    end->value.data.string = strdup(local_day_stamp(now - 86400, "00:00:00.000").c_str());
+    EXPECT_STREQ("data_sample_rollup_hour",
+                 orcm_db_base_rollup_select("data_sensors_view", &filters, aggregate, now)->table);
+
+    /* the tier row at a boundary covers the period after it, so the
+     * bounds must be start-inclusive and end-exclusive */
+    start->op = GT;
+    EXPECT_TRUE(NULL == orcm_db_base_rollup_select("data_sensors_view", &filters, aggregate, now));
+    start->op = GE;
+    end->op = LE;
+    EXPECT_TRUE(NULL == orcm_db_base_rollup_select("data_sensors_view", &filters, aggregate, now));
+
+    OPAL_LIST_DESTRUCT(&filters);
+    OBJ_RELEASE(aggregate);
+    orcm_db_base.rollup = false;
+}
+
+TEST(db_base_rollup, select_needs_raw_samples)
+{
+    orcm_db_aggregate_t *aggregate = sensor_aggregate(ORCM_DB_AGG_AVG, 86400);
+    time_t now = time(NULL);
+    opal_list_t filters;
+
+    /* disabled */
+    EXPECT_TRUE(NULL == orcm_db_base_rollup_select("data_sensors_view", NULL, aggregate, now));
+
+    orcm_db_base.rollup = true;
+    EXPECT_TRUE(NULL == orcm_db_base_rollup_select("syslog_view", NULL, aggregate, now));
+
+    aggregate->function = ORCM_DB_AGG_COUNT;
+    EXPECT_TRUE(NULL == orcm_db_base_rollup_select("data_sensors_view", NULL, aggregate, now));
+    aggregate->function = ORCM_DB_AGG_PERCENTILE;
+    EXPECT_TRUE(NULL == orcm_db_base_rollup_select("data_sensors_view", NULL, aggregate, now));
+
+    aggregate->function = ORCM_DB_AGG_AVG;
+    OBJ_CONSTRUCT(&filters, opal_list_t);
+    opal_list_append(&filters, &string_filter("value_str", "100", GT)->value.super);
+    EXPECT_TRUE(NULL == orcm_db_base_rollup_select("data_sensors_view", &filters, aggregate, now));
+
+    OPAL_LIST_DESTRUCT(&filters);
+    OBJ_RELEASE(aggregate);
+    orcm_db_base.rollup = false;
+}
+
+TEST(db_base_rollup, query_from_tier)
+{
+    orcm_db_aggregate_t *aggregate = sensor_aggregate(ORCM_DB_AGG_AVG, 3600);
+    opal_list_t filters;
+    char *query;
+
+    OBJ_CONSTRUCT(&filters, opal_list_t);
+    opal_list_append(&filters, &string_filter("time_stamp", "2016-05-01 00:00:00", GT)->value.super);
+
+    query = build_rollup_query_from_filters(&orcm_db_base_rollup_tiers[1], &filters, aggregate);
+    ASSERT_TRUE(NULL != query);
+    EXPECT_STREQ("select hostname, data_item, concat(to_timestamp(floor(extract(epoch from "
+                 "cast(time_stamp as timestamp)) / 3600) * 3600) at time zone 'UTC') as time_stamp, "
+                 "concat(sum(value_sum) / sum(samples)) as value_str, units "
+                 "from data_sample_rollup_hour where time_stamp > '2016-05-01 00:00:00' "
+                 "group by 1,2,3,5 order by 1,2,3,5;", query);
+    free(query);
+
+    aggregate->function = ORCM_DB_AGG_PERCENTILE;
+    EXPECT_TRUE(NULL == build_rollup_query_from_filters(&orcm_db_base_rollup_tiers[1],
+                                                        &filters, aggregate));
+
+    OPAL_LIST_DESTRUCT(&filters);
+    OBJ_RELEASE(aggregate);
+}
+
+TEST(db_base_rollup, maintenance_statements)
+{
+    char *query;
+
+    query = orcm_db_base_rollup_upsert("('c01','power_ps1','W','2016-05-01 10:00:01',250)");
+    ASSERT_TRUE(NULL != query);
+    std::string sql(query);
+    EXPECT_EQ(0U, sql.find("with samples(hostname, data_item, units, time_stamp, value) as "
+                           "(values ('c01','power_ps1','W','2016-05-01 10:00:01',250)), "
+                           "minute_rows as (insert into data_sample_rollup_minute as r "));
+    EXPECT_NE(std::string::npos, sql.find("hour_rows as (insert into data_sample_rollup_hour as r "));
+    EXPECT_NE(std::string::npos, sql.find(") insert into data_sample_rollup_day as r "));
+    EXPECT_NE(std::string::npos, sql.find("date_trunc('day', cast(time_stamp as timestamp))"));
+    free(query);
+    EXPECT_TRUE(NULL == orcm_db_base_rollup_upsert(""));
+
+    query = orcm_db_base_rollup_expire("data_sample_raw", 14);
+    EXPECT_STREQ("delete from data_sample_raw where time_stamp < "
+                 "localtimestamp - interval '14 days';", query);
+    free(query);
+    EXPECT_TRUE(NULL == orcm_db_base_rollup_expire("data_sample_rollup_day", 0));
+
+    query = orcm_db_base_rollup_table_ddl(&orcm_db_base_rollup_tiers[0]);
+    ASSERT_TRUE(NULL != query);
+    EXPECT_EQ(0U, std::string(query).find("create table if not exists data_sample_rollup_minute ("));
+    free(query);
+}
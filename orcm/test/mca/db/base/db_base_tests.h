@@ -0,0 +1,14 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#ifndef GREI_ORCM_TEST_MCA_DB_BASE_DB_BASE_TEST_H
+#define GREI_ORCM_TEST_MCA_DB_BASE_DB_BASE_TEST_H
+
+#include "gtest/gtest.h"
+
+extern "C" {
+    #include "orcm/mca/db/base/base.h"
+    #include "opal/class/opal_list.h"
+    #include "opal/util/argv.h"
+};
+
+#endif
@@ -0,0 +1,198 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#include "memtest_tests.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#define SLICE_BYTES (256 * 1024)
+
+/* what each worker saw of its slice, indexed by worker id */
+typedef struct {
+    void *mem;
+    size_t mem_len;
+    int calls;
+} seen_t;
+
+static std::vector<seen_t> seen;
+static pthread_mutex_t seen_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static int record(orcm_diag_engine_worker_t *w, void *arg)
+{
+    pthread_mutex_lock(&seen_lock);
+    seen[w->id].mem = w->mem;
+    seen[w->id].mem_len = w->mem_len;
+    seen[w->id].calls++;
+    pthread_mutex_unlock(&seen_lock);
+    w->bytes = *(uint64_t*)arg;
+    w->flops = 1;
+    return ORCM_SUCCESS;
+}
+
+static int fail(orcm_diag_engine_worker_t *w, void *arg)
+{
+    return ORCM_ERROR;
+}
+
+static int flip(orcm_diag_engine_worker_t *w, void *arg)
+{
+    w->errors = 2;
+    return ORCM_SUCCESS;
+}
+
+void memtest_tests::SetUpTestCase()
+{
+    opal_init_test();
+}
+
+void memtest_tests::TearDownTestCase()
+{
+    orcm_diag_engine_finalize();
+}
+
+void memtest_tests::SetUp()
+{
+    seen.assign(orcm_diag_engine_num_workers(), seen_t());
+}
+
+void memtest_tests::TearDown()
+{
+    seen.clear();
+}
+
+TEST_F(memtest_tests, engine_runs_every_test_on_every_worker)
+{
+    uint64_t shared = 10, alone = 3;
+    orcm_diag_engine_test_t tests[] = {
+        { "shared", record, &shared, false },
+        { "alone", record, &alone, true }
+    };
+    int n = orcm_diag_engine_num_workers(), i;
+
+    ASSERT_LT(0, n);
+    ASSERT_EQ(ORCM_SUCCESS, orcm_diag_engine_run(tests, 2, NULL));
+    EXPECT_EQ((uint64_t)n * 10, tests[0].bytes);
+    EXPECT_EQ((uint64_t)n * 3, tests[1].bytes);
+    EXPECT_EQ((uint64_t)n, tests[1].flops);
+    EXPECT_EQ(0, tests[0].errors);
+    EXPECT_EQ(0, tests[1].errors);
+    for (i = 0; i < n; i++) {
+        EXPECT_EQ(2, seen[i].calls);
+        /* no memory was asked for */
+        EXPECT_TRUE(NULL == seen[i].mem);
+    }
+
+    /* results do not carry over into the next run */
+    ASSERT_EQ(ORCM_SUCCESS, orcm_diag_engine_run(tests, 1, NULL));
+    EXPECT_EQ((uint64_t)n * 10, tests[0].bytes);
+}
+
+TEST_F(memtest_tests, engine_hands_out_disjoint_slices)
+{
+    uint64_t none = 0;
+    orcm_diag_engine_test_t test = { "slices", record, &none, true };
+    int n = orcm_diag_engine_num_workers(), i;
+    size_t page = sysconf(_SC_PAGESIZE), total = 0;
+    size_t mem = (size_t)n * SLICE_BYTES + 123;
+    std::vector<std::pair<char*, size_t> > slices;
+
+    ASSERT_EQ(ORCM_SUCCESS, orcm_diag_engine_run(&test, 1, &mem));
+    for (i = 0; i < n; i++) {
+        ASSERT_TRUE(NULL != seen[i].mem);
+        EXPECT_EQ(0U, (uintptr_t)seen[i].mem % page);
+        EXPECT_EQ(0U, seen[i].mem_len % page);
+        EXPECT_LT(0U, seen[i].mem_len);
+        slices.push_back(std::make_pair((char*)seen[i].mem, seen[i].mem_len));
+        total += seen[i].mem_len;
+    }
+    /* the size handed back is what the workers got, never more
+     * than was asked for */
+    EXPECT_EQ(total, mem);
+    EXPECT_GE((size_t)n * SLICE_BYTES + 123, mem);
+    std::sort(slices.begin(), slices.end());
+    for (i = 1; i < n; i++) {
+        EXPECT_LE(slices[i-1].first + slices[i-1].second, slices[i].first);
+    }
+}
+
+TEST_F(memtest_tests, engine_counts_failing_workers)
+{
+    orcm_diag_engine_test_t tests[] = {
+        { "fail", fail, NULL, false },
+        { "flip", flip, NULL, true }
+    };
+    int n = orcm_diag_engine_num_workers();
+
+    ASSERT_EQ(ORCM_SUCCESS, orcm_diag_engine_run(tests, 2, NULL));
+    /* a failure without errors of its own counts once per worker */
+    EXPECT_EQ(n, tests[0].errors);
+    EXPECT_EQ(2 * n, tests[1].errors);
+}
+
+TEST_F(memtest_tests, patterns_pass_on_good_memory)
+{
+    orcm_diag_engine_test_t tests[] = {
+        { "random", pattern_random, NULL, true },
+        { "walking ones", pattern_walking_ones, NULL, true },
+        { "moving inversions", pattern_moving_inversions, NULL, true }
+    };
+    int n = orcm_diag_engine_num_workers();
+    size_t mem = (size_t)n * SLICE_BYTES;
+
+    ASSERT_EQ(ORCM_SUCCESS, orcm_diag_engine_run(tests, 3, &mem));
+    ASSERT_LT(0U, mem);
+    EXPECT_EQ(0, tests[0].errors);
+    EXPECT_EQ(0, tests[1].errors);
+    EXPECT_EQ(0, tests[2].errors);
+    /* one fill and one check each, walking ones included */
+    EXPECT_EQ((uint64_t)mem * 2, tests[0].bytes);
+    EXPECT_EQ((uint64_t)mem * 2, tests[1].bytes);
+    EXPECT_EQ((uint64_t)mem * 5, tests[2].bytes);
+}
+
+TEST_F(memtest_tests, walking_ones_covers_every_bit)
+{
+    std::vector<uint64_t> buf(4 * 64 + 5);
+    orcm_diag_engine_worker_t w;
+    uint64_t bits = 0;
+    size_t i;
+
+    memset(&w, 0, sizeof(w));
+    w.mem = &buf[0];
+    w.mem_len = buf.size() * sizeof(uint64_t);
+    ASSERT_EQ(ORCM_SUCCESS, pattern_walking_ones(&w, NULL));
+    EXPECT_EQ(0, w.errors);
+    EXPECT_EQ(2 * w.mem_len, w.bytes);
+    for (i = 0; i < buf.size(); i++) {
+        /* a single bit in each word */
+        EXPECT_EQ(0U, buf[i] & (buf[i] - 1));
+        EXPECT_NE(0U, buf[i]);
+        EXPECT_NE(buf[i], buf[(i + 1) % buf.size()]);
+        if (i < 64) {
+            bits |= buf[i];
+        }
+    }
+    /* any 64 neighbouring words walk the bit across the whole word */
+    EXPECT_EQ(~0ULL, bits);
+}
+
+TEST_F(memtest_tests, moving_inversions_restores_the_pattern)
+{
+    std::vector<uint64_t> buf(1000, 0);
+    orcm_diag_engine_worker_t w;
+    size_t i;
+
+    memset(&w, 0, sizeof(w));
+    w.mem = &buf[0];
+    w.mem_len = buf.size() * sizeof(uint64_t);
+    ASSERT_EQ(ORCM_SUCCESS, pattern_moving_inversions(&w, NULL));
+    EXPECT_EQ(0, w.errors);
+    for (i = 0; i < buf.size(); i++) {
+        EXPECT_EQ(0x5555555555555555ULL, buf[i]);
+    }
+}
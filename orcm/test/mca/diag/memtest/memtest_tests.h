@@ -0,0 +1,24 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#ifndef GREI_ORCM_TEST_MCA_DIAG_MEMTEST_MEMTEST_TESTS_H
+#define GREI_ORCM_TEST_MCA_DIAG_MEMTEST_MEMTEST_TESTS_H
+
+#include "gtest/gtest.h"
+
+extern "C" {
+    #include "opal/runtime/opal.h"
+    #include "orcm/constants.h"
+    #include "orcm/mca/diag/base/base.h"
+    #include "orcm/mca/diag/memtest/diag_memtest_patterns.h"
+};
+
+class memtest_tests : public testing::Test
+{
+    protected:
+        static void SetUpTestCase();
+        static void TearDownTestCase();
+        virtual void SetUp();
+        virtual void TearDown();
+};
+
+#endif
@@ -3,6 +3,9 @@
 #include "evgen_saeg_tests.h"
 #include <stdio.h>
 #include <stdbool.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 extern orcm_db_API_module_t orcm_db;
 
@@ -389,3 +392,166 @@ TEST(evgen_saeg, generate_storage_undefined)
     }
 }
 
+
+/* the pubsub tests pack buffers, so the DSS must be up */
+static void pubsub_test_init(void)
+{
+    static bool initialized = false;
+
+    if (!initialized) {
+        opal_dss_register_vars();
+        opal_init_test();
+        initialized = true;
+    }
+}
+
+TEST(evgen_saeg, pubsub_filter_parse_match)
+{
+    orcm_pubsub_filter_t *filter = NULL;
+
+    ASSERT_EQ(ORCM_SUCCESS,
+              orcm_pubsub_filter_parse("hosts=node1,rack2* groups=coretemp kinds=samples", &filter));
+    EXPECT_TRUE(orcm_pubsub_filter_match(filter, ORCM_PUBSUB_KIND_SAMPLE, "node1", "coretemp"));
+    EXPECT_TRUE(orcm_pubsub_filter_match(filter, ORCM_PUBSUB_KIND_SAMPLE, "rack2n04", "coretemp"));
+    EXPECT_FALSE(orcm_pubsub_filter_match(filter, ORCM_PUBSUB_KIND_SAMPLE, "node2", "coretemp"));
+    EXPECT_FALSE(orcm_pubsub_filter_match(filter, ORCM_PUBSUB_KIND_SAMPLE, "node1", "freq"));
+    EXPECT_FALSE(orcm_pubsub_filter_match(filter, ORCM_PUBSUB_KIND_EVENT, "node1", "coretemp"));
+    EXPECT_TRUE(orcm_pubsub_filter_match_metric(filter, "core0"));
+    OBJ_RELEASE(filter);
+
+    EXPECT_NE(ORCM_SUCCESS, orcm_pubsub_filter_parse("nodes=node1", &filter));
+}
+
+TEST(evgen_saeg, pubsub_filter_pack_unpack)
+{
+    orcm_pubsub_filter_t *filter = OBJ_NEW(orcm_pubsub_filter_t);
+    orcm_pubsub_filter_t *copy = NULL;
+    opal_buffer_t buf;
+
+    pubsub_test_init();
+    filter->kinds = ORCM_PUBSUB_KIND_SAMPLE;
+    opal_argv_append_nosize(&filter->metrics, "core*");
+    OBJ_CONSTRUCT(&buf, opal_buffer_t);
+    ASSERT_EQ(ORCM_SUCCESS, orcm_pubsub_filter_pack(&buf, filter));
+    ASSERT_EQ(ORCM_SUCCESS, orcm_pubsub_filter_unpack(&buf, &copy));
+    EXPECT_EQ(ORCM_PUBSUB_KIND_SAMPLE, copy->kinds);
+    EXPECT_TRUE(NULL == copy->hosts);
+    EXPECT_TRUE(orcm_pubsub_filter_match_metric(copy, "core3"));
+    EXPECT_FALSE(orcm_pubsub_filter_match_metric(copy, "socket0"));
+    OBJ_DESTRUCT(&buf);
+    OBJ_RELEASE(filter);
+    OBJ_RELEASE(copy);
+}
+
+TEST(evgen_saeg, pubsub_record_metric_filter)
+{
+    orcm_pubsub_record_t *rec = OBJ_NEW(orcm_pubsub_record_t);
+    orcm_pubsub_record_t *copy = NULL;
+    orcm_pubsub_filter_t *filter = OBJ_NEW(orcm_pubsub_filter_t);
+    orcm_value_t *val;
+    opal_buffer_t buf;
+    char *csv;
+
+    pubsub_test_init();
+    rec->kind = ORCM_PUBSUB_KIND_SAMPLE;
+    rec->host = strdup("node1");
+    rec->group = strdup("coretemp");
+    rec->severity = strdup("INFO");
+    rec->timestamp = 0;
+    val = orcm_util_load_orcm_value((char*)"core0", (void*)"41.5", OPAL_STRING, (char*)"C");
+    opal_list_append(&rec->values, &val->value.super);
+    val = orcm_util_load_orcm_value((char*)"core1", (void*)"42.0", OPAL_STRING, (char*)"C");
+    opal_list_append(&rec->values, &val->value.super);
+
+    filter->kinds = ORCM_PUBSUB_KIND_ALL;
+    opal_argv_append_nosize(&filter->metrics, "core1");
+    OBJ_CONSTRUCT(&buf, opal_buffer_t);
+    ASSERT_EQ(ORCM_SUCCESS, orcm_pubsub_record_pack(&buf, rec, filter));
+    ASSERT_EQ(ORCM_SUCCESS, orcm_pubsub_record_unpack(&buf, &copy));
+    EXPECT_EQ(1, (int)opal_list_get_size(&copy->values));
+    csv = orcm_pubsub_record_to_csv(copy);
+    ASSERT_TRUE(NULL != csv);
+    EXPECT_TRUE(NULL != strstr(csv, ",node1,coretemp,INFO,core1,42.0,C\n"));
+    free(csv);
+    OBJ_DESTRUCT(&buf);
+
+    /* nothing left to report once every value is filtered out */
+    opal_argv_free(filter->metrics);
+    filter->metrics = NULL;
+    opal_argv_append_nosize(&filter->metrics, "socket0");
+    OBJ_CONSTRUCT(&buf, opal_buffer_t);
+    EXPECT_EQ(ORCM_ERR_NOT_FOUND, orcm_pubsub_record_pack(&buf, rec, filter));
+    OBJ_DESTRUCT(&buf);
+
+    OBJ_RELEASE(copy);
+    OBJ_RELEASE(filter);
+    OBJ_RELEASE(rec);
+}
+
+TEST(evgen_saeg, pubsub_record_to_csv)
+{
+    orcm_pubsub_record_t *rec = OBJ_NEW(orcm_pubsub_record_t);
+    orcm_value_t *val;
+    char *csv, *line;
+
+    rec->host = strdup("node1");
+    rec->group = strdup("coretemp");
+    rec->timestamp = 0;
+
+    /* a record without values still gets its line */
+    csv = orcm_pubsub_record_to_csv(rec);
+    ASSERT_TRUE(NULL != csv);
+    line = strchr(csv, ',');
+    ASSERT_TRUE(NULL != line);
+    EXPECT_STREQ(",node1,coretemp,,,,\n", line);
+    free(csv);
+
+    /* one line per value, each repeating the record's fields */
+    val = orcm_util_load_orcm_value((char*)"core0", (void*)"41.5", OPAL_STRING, (char*)"C");
+    opal_list_append(&rec->values, &val->value.super);
+    val = orcm_util_load_orcm_value((char*)"core1", (void*)"42.0", OPAL_STRING, NULL);
+    opal_list_append(&rec->values, &val->value.super);
+    csv = orcm_pubsub_record_to_csv(rec);
+    ASSERT_TRUE(NULL != csv);
+    line = strchr(csv, ',');
+    ASSERT_TRUE(NULL != line);
+    EXPECT_EQ(0, strncmp(",node1,coretemp,,core0,41.5,C\n", line,
+                         strlen(",node1,coretemp,,core0,41.5,C\n")));
+    line = strchr(line, '\n') + 1;
+    line = strchr(line, ',');
+    ASSERT_TRUE(NULL != line);
+    EXPECT_STREQ(",node1,coretemp,,core1,42.0,\n", line);
+    free(csv);
+
+    OBJ_RELEASE(rec);
+}
+
+TEST(evgen_saeg, pubsub_listener_drops_unsubscribed_clients)
+{
+    orcm_pubsub_listener_t *listener;
+    struct sockaddr_un addr;
+    char path[64];
+    char c;
+    int sd, i;
+
+    pubsub_test_init();
+    snprintf(path, sizeof(path), "/tmp/orcm_pubsub_test.%d", (int)getpid());
+    listener = orcm_pubsub_listen(path, opal_sync_event_base, 10, NULL, NULL);
+    ASSERT_TRUE(NULL != listener);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+    sd = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_LE(0, sd);
+    ASSERT_EQ(0, connect(sd, (struct sockaddr*)&addr, sizeof(addr)));
+    for (i = 0; i < 100 && 0 == opal_list_get_size(&listener->connecting); i++) {
+        opal_event_loop(opal_sync_event_base, OPAL_EVLOOP_NONBLOCK);
+    }
+    EXPECT_EQ(1U, opal_list_get_size(&listener->connecting));
+
+    /* the client never sent its filter - closing the listener hangs up on it */
+    OBJ_RELEASE(listener);
+    EXPECT_EQ(0, read(sd, &c, 1));
+    close(sd);
+}
@@ -11,6 +11,10 @@ extern "C" {
     #include "opal/class/opal_list.h"
     #include "opal/mca/event/external/external.h"
     #include "orcm/mca/evgen/saeg/evgen_saeg.h"
+    #include "orcm/util/pubsub.h"
+    #include "orcm/util/utils.h"
+    #include "opal/util/argv.h"
+    #include "opal/runtime/opal.h"
     #include "opal/mca/event/event.h"
 };
 
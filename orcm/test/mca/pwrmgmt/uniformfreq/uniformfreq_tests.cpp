@@ -0,0 +1,173 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#include "uniformfreq_tests.h"
+
+#include <math.h>
+
+#define PERIOD_MS 1000
+
+static const float ladder[] = {2.4, 2.3, 2.2, 2.1, 2.0, 1.9, 1.8,
+                               1.7, 1.6, 1.5, 1.4, 1.3, 1.2};
+static const int nladder = sizeof(ladder) / sizeof(ladder[0]);
+
+void ut_uniformfreq_tests::SetUp()
+{
+    nodes = 4;
+    idle_watts = 100.0;
+    dynamic_watts = 200.0;
+    load = 1.0;
+    fmax = ladder[0];
+    ASSERT_EQ(ORCM_SUCCESS,
+              orcm_pwrmgmt_uniformfreq_ctl_init(&ctl, ladder, nladder, 1000.0));
+}
+
+void ut_uniformfreq_tests::TearDown()
+{
+    orcm_pwrmgmt_uniformfreq_ctl_destruct(&ctl);
+}
+
+double ut_uniformfreq_tests::power(float freq)
+{
+    double r = freq / fmax;
+
+    return nodes * (idle_watts + load * dynamic_watts * r * r * r);
+}
+
+int ut_uniformfreq_tests::run(int periods)
+{
+    int over = 0;
+    float freq = orcm_pwrmgmt_uniformfreq_ctl_freq(&ctl);
+
+    for (int i = 0; i < periods; i++) {
+        double watts = power(freq);
+        if (watts > ctl.budget) {
+            over++;
+        }
+        freq = orcm_pwrmgmt_uniformfreq_ctl_step(&ctl, watts, PERIOD_MS);
+    }
+    return over;
+}
+
+float ut_uniformfreq_tests::best_fit()
+{
+    for (int i = 0; i < nladder; i++) {
+        if (power(ladder[i]) <= ctl.budget) {
+            return ladder[i];
+        }
+    }
+    return ladder[nladder - 1];
+}
+
+TEST(uniformfreq_ctl, empty_ladder)
+{
+    orcm_pwrmgmt_uniformfreq_ctl_t ctl;
+
+    ASSERT_EQ(ORCM_ERR_BAD_PARAM,
+              orcm_pwrmgmt_uniformfreq_ctl_init(&ctl, NULL, 0, 100.0));
+    ASSERT_EQ(-1.0, orcm_pwrmgmt_uniformfreq_ctl_step(&ctl, 10.0, PERIOD_MS));
+    orcm_pwrmgmt_uniformfreq_ctl_destruct(&ctl);
+}
+
+TEST(uniformfreq_ctl, ladder_sorted_and_deduped)
+{
+    orcm_pwrmgmt_uniformfreq_ctl_t ctl;
+    float freqs[] = {1.2, 2.4, 1.8, 2.4, 1.2};
+
+    ASSERT_EQ(ORCM_SUCCESS,
+              orcm_pwrmgmt_uniformfreq_ctl_init(&ctl, freqs, 5, 100.0));
+    ASSERT_EQ(3, ctl.nfreqs);
+    EXPECT_FLOAT_EQ(2.4, ctl.freqs[0]);
+    EXPECT_FLOAT_EQ(1.8, ctl.freqs[1]);
+    // the cap must hold from the first period, so start at the bottom
+    EXPECT_FLOAT_EQ(1.2, orcm_pwrmgmt_uniformfreq_ctl_freq(&ctl));
+    orcm_pwrmgmt_uniformfreq_ctl_destruct(&ctl);
+}
+
+TEST_F(ut_uniformfreq_tests, no_reading_keeps_frequency)
+{
+    run(20);
+    float freq = orcm_pwrmgmt_uniformfreq_ctl_freq(&ctl);
+
+    for (int i = 0; i < 5; i++) {
+        EXPECT_FLOAT_EQ(freq, orcm_pwrmgmt_uniformfreq_ctl_step(&ctl, -1.0, PERIOD_MS));
+    }
+}
+
+TEST_F(ut_uniformfreq_tests, converges_under_cap)
+{
+    float target = best_fit();
+
+    run(50);
+    // once settled the loop sits on the best fitting step and stays there
+    EXPECT_EQ(0, run(100));
+    EXPECT_FLOAT_EQ(target, orcm_pwrmgmt_uniformfreq_ctl_freq(&ctl));
+}
+
+TEST_F(ut_uniformfreq_tests, follows_load)
+{
+    run(50);
+    float before = orcm_pwrmgmt_uniformfreq_ctl_freq(&ctl);
+
+    // heavier work draws more at the same frequency
+    load = 1.3;
+    float heavy = best_fit();
+    run(50);
+    EXPECT_EQ(0, run(100));
+    EXPECT_FLOAT_EQ(heavy, orcm_pwrmgmt_uniformfreq_ctl_freq(&ctl));
+    EXPECT_LT(heavy, before);
+
+    // and lighter work leaves room to climb again
+    load = 0.6;
+    float light = best_fit();
+    run(50);
+    EXPECT_EQ(0, run(100));
+    EXPECT_FLOAT_EQ(light, orcm_pwrmgmt_uniformfreq_ctl_freq(&ctl));
+    EXPECT_GT(light, before);
+}
+
+TEST_F(ut_uniformfreq_tests, overage_time_is_honoured)
+{
+    run(50);
+    float freq = orcm_pwrmgmt_uniformfreq_ctl_freq(&ctl);
+    double watts = power(freq);
+
+    ctl.overage_time = 3 * PERIOD_MS;
+    ctl.budget = watts - 50.0;
+
+    // the excursion is tolerated until it has lasted overage_time
+    EXPECT_FLOAT_EQ(freq, orcm_pwrmgmt_uniformfreq_ctl_step(&ctl, watts, PERIOD_MS));
+    EXPECT_FLOAT_EQ(freq, orcm_pwrmgmt_uniformfreq_ctl_step(&ctl, watts, PERIOD_MS));
+    EXPECT_GT(freq, orcm_pwrmgmt_uniformfreq_ctl_step(&ctl, watts, PERIOD_MS));
+}
+
+TEST_F(ut_uniformfreq_tests, overage_allowance)
+{
+    run(50);
+    float freq = orcm_pwrmgmt_uniformfreq_ctl_freq(&ctl);
+    double watts = power(freq);
+
+    // inside budget + overage nothing moves
+    ctl.overage = 100.0;
+    ctl.budget = watts - 50.0;
+    for (int i = 0; i < 5; i++) {
+        EXPECT_FLOAT_EQ(freq, orcm_pwrmgmt_uniformfreq_ctl_step(&ctl, watts, PERIOD_MS));
+    }
+}
+
+TEST_F(ut_uniformfreq_tests, failed_probe_backs_off)
+{
+    float low = orcm_pwrmgmt_uniformfreq_ctl_freq(&ctl);
+
+    // give the probe no grace at all - a broken cap after a step up
+    // must be undone on the very next period regardless
+    ctl.overage_time = 10 * PERIOD_MS;
+
+    float up = orcm_pwrmgmt_uniformfreq_ctl_step(&ctl, 500.0, PERIOD_MS);
+    ASSERT_GT(up, low);
+    EXPECT_FLOAT_EQ(low, orcm_pwrmgmt_uniformfreq_ctl_step(&ctl, 1100.0, PERIOD_MS));
+
+    // the step that broke the cap stays off-limits for a while
+    // even though the readings now show plenty of headroom
+    ctl.watts_per_step = 0.0;
+    EXPECT_FLOAT_EQ(low, orcm_pwrmgmt_uniformfreq_ctl_step(&ctl, 500.0, PERIOD_MS));
+}
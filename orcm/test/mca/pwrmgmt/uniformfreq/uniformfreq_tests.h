@@ -0,0 +1,34 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#ifndef GREI_ORCM_TEST_MCA_PWRMGMT_UNIFORMFREQ_UNIFORMFREQ_TESTS_H
+#define GREI_ORCM_TEST_MCA_PWRMGMT_UNIFORMFREQ_UNIFORMFREQ_TESTS_H
+
+#include "gtest/gtest.h"
+
+extern "C" {
+    #include "orcm/constants.h"
+    #include "orcm/mca/pwrmgmt/uniformfreq/pwrmgmt_uniformfreq_ctl.h"
+};
+
+class ut_uniformfreq_tests: public testing::Test
+{
+    protected:
+        virtual void SetUp();
+        virtual void TearDown();
+
+        // allocation power for the simulated cluster at freq
+        double power(float freq);
+        // run the loop for n periods and return how many broke the cap
+        int run(int periods);
+        // highest step whose simulated power fits the budget
+        float best_fit();
+
+        orcm_pwrmgmt_uniformfreq_ctl_t ctl;
+        int nodes;
+        double idle_watts;
+        double dynamic_watts;
+        double load;
+        float fmax;
+};
+
+#endif
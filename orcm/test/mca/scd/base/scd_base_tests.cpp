@@ -0,0 +1,171 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#include "scd_base_tests.h"
+
+static const char *node_names[] = {"n1", "n2", "n3", "n4", NULL};
+
+void scd_base_tests::SetUpTestCase()
+{
+    orcm_node_t *node;
+
+    opal_init_test();
+    /* no state handlers - activations are dropped */
+    OBJ_CONSTRUCT(&orcm_scd_base.states, opal_list_t);
+    OBJ_CONSTRUCT(&orcm_scd_base.nodes, opal_pointer_array_t);
+    opal_pointer_array_init(&orcm_scd_base.nodes, 8, INT_MAX, 8);
+    for (int i = 0; NULL != node_names[i]; i++) {
+        node = OBJ_NEW(orcm_node_t);
+        node->name = strdup(node_names[i]);
+        opal_pointer_array_add(&orcm_scd_base.nodes, node);
+    }
+}
+
+void scd_base_tests::TearDownTestCase()
+{
+    orcm_node_t *node;
+
+    for (int i = 0; i < orcm_scd_base.nodes.size; i++) {
+        if (NULL != (node = (orcm_node_t*)opal_pointer_array_get_item(&orcm_scd_base.nodes, i))) {
+            OBJ_RELEASE(node);
+        }
+    }
+    OBJ_DESTRUCT(&orcm_scd_base.nodes);
+    OBJ_DESTRUCT(&orcm_scd_base.states);
+}
+
+void scd_base_tests::SetUp()
+{
+    orcm_scd_base.session_reuse = true;
+    for (int i = 0; NULL != node_names[i]; i++) {
+        set_node_state(node_names[i], ORCM_NODE_STATE_UP);
+    }
+    OBJ_CONSTRUCT(&pending, opal_list_t);
+}
+
+void scd_base_tests::TearDown()
+{
+    OPAL_LIST_DESTRUCT(&pending);
+    orcm_scd_base.session_reuse = false;
+}
+
+orcm_session_t* scd_base_tests::session(orcm_session_id_t id, int32_t min_nodes,
+                                        bool exclusive, const char *nodes)
+{
+    orcm_session_t *s = OBJ_NEW(orcm_session_t);
+
+    s->id = id;
+    s->alloc = OBJ_NEW(orcm_alloc_t);
+    s->alloc->min_nodes = min_nodes;
+    s->alloc->exclusive = exclusive;
+    if (NULL != nodes) {
+        s->alloc->nodes = strdup(nodes);
+    }
+    return s;
+}
+
+void scd_base_tests::set_node_state(const char *name, orcm_node_state_t state)
+{
+    orcm_node_t *node;
+
+    for (int i = 0; i < orcm_scd_base.nodes.size; i++) {
+        if (NULL != (node = (orcm_node_t*)opal_pointer_array_get_item(&orcm_scd_base.nodes, i)) &&
+            0 == strcmp(node->name, name)) {
+            node->state = state;
+        }
+    }
+}
+
+TEST_F(scd_base_tests, head_takes_over_the_nodes)
+{
+    orcm_session_t *done = session(1, 2, true, "n1,n2");
+    orcm_session_t *next = session(2, 2, true, NULL);
+    orcm_session_t *later = session(3, 2, true, NULL);
+
+    opal_list_append(&pending, &next->super);
+    opal_list_append(&pending, &later->super);
+
+    ASSERT_TRUE(orcm_scd_base_reuse_session(done, &pending));
+    EXPECT_TRUE(next->reused);
+    EXPECT_STREQ("n1,n2", next->alloc->nodes);
+    /* it left the queue, the one behind it did not */
+    EXPECT_EQ(1, (int)opal_list_get_size(&pending));
+    EXPECT_TRUE(&later->super == opal_list_get_first(&pending));
+    EXPECT_FALSE(later->reused);
+
+    OBJ_RELEASE(next);
+    OBJ_RELEASE(done);
+}
+
+TEST_F(scd_base_tests, shape_must_match)
+{
+    orcm_session_t *done = session(1, 2, true, "n1,n2");
+    orcm_session_t *next = session(2, 3, true, NULL);
+
+    opal_list_append(&pending, &next->super);
+
+    /* more nodes than are being freed */
+    EXPECT_FALSE(orcm_scd_base_reuse_session(done, &pending));
+
+    /* same count, but willing to share where the nodes were not */
+    next->alloc->min_nodes = 2;
+    next->alloc->exclusive = false;
+    EXPECT_FALSE(orcm_scd_base_reuse_session(done, &pending));
+
+    /* fewer nodes than the allocation really has */
+    next->alloc->exclusive = true;
+    OBJ_RELEASE(done);
+    done = session(1, 2, true, "n1,n2,n3");
+    EXPECT_FALSE(orcm_scd_base_reuse_session(done, &pending));
+
+    EXPECT_FALSE(next->reused);
+    EXPECT_TRUE(NULL == next->alloc->nodes);
+    EXPECT_EQ(1, (int)opal_list_get_size(&pending));
+    OBJ_RELEASE(done);
+}
+
+TEST_F(scd_base_tests, node_gone_down)
+{
+    orcm_session_t *done = session(1, 2, false, "n3,n4");
+    orcm_session_t *next = session(2, 2, false, NULL);
+
+    opal_list_append(&pending, &next->super);
+
+    set_node_state("n4", ORCM_NODE_STATE_DOWN);
+    EXPECT_FALSE(orcm_scd_base_reuse_session(done, &pending));
+    EXPECT_FALSE(next->reused);
+
+    set_node_state("n4", ORCM_NODE_STATE_UP);
+    EXPECT_TRUE(orcm_scd_base_reuse_session(done, &pending));
+
+    OBJ_RELEASE(next);
+    OBJ_RELEASE(done);
+}
+
+TEST_F(scd_base_tests, only_the_queue_head)
+{
+    orcm_session_t *done = session(1, 2, true, "n1,n2");
+    orcm_session_t *head = session(2, 4, true, NULL);
+    orcm_session_t *fits = session(3, 2, true, NULL);
+
+    opal_list_append(&pending, &head->super);
+    opal_list_append(&pending, &fits->super);
+
+    /* the second in line fits, but must not overtake the head */
+    EXPECT_FALSE(orcm_scd_base_reuse_session(done, &pending));
+    EXPECT_FALSE(fits->reused);
+    EXPECT_EQ(2, (int)opal_list_get_size(&pending));
+    OBJ_RELEASE(done);
+}
+
+TEST_F(scd_base_tests, nothing_to_hand_on)
+{
+    orcm_session_t *done = session(1, 2, true, "n1,n2");
+    orcm_session_t *next = session(2, 2, true, NULL);
+
+    EXPECT_FALSE(orcm_scd_base_reuse_session(done, &pending));
+
+    opal_list_append(&pending, &next->super);
+    orcm_scd_base.session_reuse = false;
+    EXPECT_FALSE(orcm_scd_base_reuse_session(done, &pending));
+    OBJ_RELEASE(done);
+}
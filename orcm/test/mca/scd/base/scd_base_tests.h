@@ -0,0 +1,33 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#ifndef GREI_ORCM_TEST_MCA_SCD_BASE_SCD_BASE_TESTS_H
+#define GREI_ORCM_TEST_MCA_SCD_BASE_SCD_BASE_TESTS_H
+
+#include "gtest/gtest.h"
+
+extern "C" {
+    #include "opal/runtime/opal.h"
+    #include "opal/class/opal_list.h"
+    #include "opal/class/opal_pointer_array.h"
+    #include "orcm/runtime/orcm_globals.h"
+    #include "orcm/mca/cfgi/cfgi_types.h"
+    #include "orcm/mca/scd/base/base.h"
+};
+
+class scd_base_tests: public testing::Test
+{
+    protected:
+        static void SetUpTestCase();
+        static void TearDownTestCase();
+
+        virtual void SetUp();
+        virtual void TearDown();
+
+        orcm_session_t* session(orcm_session_id_t id, int32_t min_nodes,
+                                bool exclusive, const char *nodes);
+        void set_node_state(const char *name, orcm_node_state_t state);
+
+        opal_list_t pending;
+};
+
+#endif
@@ -0,0 +1,229 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#include "sensor_base_tests.h"
+
+#include <limits.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/* what the code under test sent, in order */
+typedef struct {
+    orte_rml_tag_t tag;
+    opal_buffer_t *buf;
+} sent_t;
+
+static std::vector<sent_t> sent;
+static std::string inventory_value;
+static int db_status;
+static int db_writes;
+static char nodename[] = "node01";
+
+static orcm_sensor_base_component_t fake_component;
+static orcm_sensor_base_module_t fake_module;
+static orcm_sensor_active_module_t fake_active;
+
+static orte_rml_module_send_buffer_nb_fn_t saved_send;
+static orcm_db_base_API_store_new_fn_t saved_store;
+static char *saved_nodename;
+
+static int capture(orte_process_name_t *peer, struct opal_buffer_t *buffer,
+                   orte_rml_tag_t tag, orte_rml_buffer_callback_fn_t cbfunc,
+                   void *cbdata)
+{
+    sent_t s;
+
+    s.tag = tag;
+    s.buf = buffer;
+    sent.push_back(s);
+    return ORCM_SUCCESS;
+}
+
+static void store(int dbhandle, orcm_db_data_type_t data_type, opal_list_t *input,
+                  opal_list_t *ret, orcm_db_callback_fn_t cbfunc, void *cbdata)
+{
+    db_writes++;
+    cbfunc(dbhandle, db_status, input, ret, cbdata);
+}
+
+static void fake_collect(opal_buffer_t *inventory_snapshot)
+{
+    const char *comp = "fake";
+    const char *value = inventory_value.c_str();
+
+    opal_dss.pack(inventory_snapshot, &comp, 1, OPAL_STRING);
+    opal_dss.pack(inventory_snapshot, &value, 1, OPAL_STRING);
+}
+
+static void clear_sent(void)
+{
+    size_t i;
+
+    for (i = 0; i < sent.size(); i++) {
+        OBJ_RELEASE(sent[i].buf);
+    }
+    sent.clear();
+}
+
+/* hand the node's digest to the aggregator and return what it asked
+ * for - empty if it sent nothing back */
+static std::vector<std::string> exchange_digest(void)
+{
+    std::vector<std::string> wanted;
+    orte_process_name_t peer = {0, 0};
+    opal_buffer_t *digest;
+    char *comp;
+    int32_t count, n, i;
+
+    clear_sent();
+    EXPECT_EQ(ORCM_SUCCESS, orcm_sensor_base_inventory_send_digest(&peer));
+    if (1 != sent.size()) {
+        ADD_FAILURE() << "no digest was sent";
+        return wanted;
+    }
+    EXPECT_EQ(ORCM_RML_TAG_INVENTORY_DIGEST, sent[0].tag);
+    digest = sent[0].buf;
+    sent.clear();
+    orcm_sensor_base_inventory_recv_digest(ORCM_SUCCESS, &peer, digest,
+                                           ORCM_RML_TAG_INVENTORY_DIGEST, NULL);
+    OBJ_RELEASE(digest);
+    if (0 == sent.size()) {
+        return wanted;
+    }
+    EXPECT_EQ(1U, sent.size());
+    EXPECT_EQ(ORCM_RML_TAG_INVENTORY_REQUEST, sent[0].tag);
+    n = 1;
+    EXPECT_EQ(OPAL_SUCCESS, opal_dss.unpack(sent[0].buf, &count, &n, OPAL_INT32));
+    for (i = 0; i < count; i++) {
+        n = 1;
+        EXPECT_EQ(OPAL_SUCCESS, opal_dss.unpack(sent[0].buf, &comp, &n, OPAL_STRING));
+        wanted.push_back(comp);
+        free(comp);
+    }
+    /* rewind it for the node */
+    sent[0].buf->unpack_ptr = sent[0].buf->base_ptr;
+    return wanted;
+}
+
+/* what the aggregator does with the inventory it gets */
+static void store_inventory(void)
+{
+    opal_list_t *records = OBJ_NEW(opal_list_t);
+
+    orcm_sensor_base_inventory_store(nodename, "fake", records);
+}
+
+void sensor_base_tests::SetUpTestCase()
+{
+    opal_init_test();
+}
+
+void sensor_base_tests::SetUp()
+{
+    memset(&fake_component, 0, sizeof(fake_component));
+    strncpy(fake_component.base_version.mca_component_name, "fake",
+            sizeof(fake_component.base_version.mca_component_name) - 1);
+    memset(&fake_module, 0, sizeof(fake_module));
+    fake_module.inventory_collect = fake_collect;
+    memset(&fake_active, 0, sizeof(fake_active));
+    fake_active.component = &fake_component;
+    fake_active.module = &fake_module;
+    OBJ_CONSTRUCT(&orcm_sensor_base.modules, opal_pointer_array_t);
+    opal_pointer_array_init(&orcm_sensor_base.modules, 1, INT_MAX, 1);
+    opal_pointer_array_add(&orcm_sensor_base.modules, &fake_active);
+
+    saved_send = orte_rml.send_buffer_nb;
+    orte_rml.send_buffer_nb = capture;
+    saved_store = orcm_db.store_new;
+    orcm_db.store_new = store;
+    saved_nodename = orte_process_info.nodename;
+    orte_process_info.nodename = nodename;
+    orcm_sensor_base.dbhandle = 0;
+    db_status = ORCM_SUCCESS;
+    db_writes = 0;
+    inventory_value = "v1";
+}
+
+void sensor_base_tests::TearDown()
+{
+    clear_sent();
+    orcm_sensor_base_inventory_finalize();
+    OBJ_DESTRUCT(&orcm_sensor_base.modules);
+    orte_rml.send_buffer_nb = saved_send;
+    orcm_db.store_new = saved_store;
+    orte_process_info.nodename = saved_nodename;
+}
+
+TEST_F(sensor_base_tests, request_brings_the_inventory)
+{
+    std::vector<std::string> wanted;
+    orte_process_name_t peer = {0, 0};
+    opal_buffer_t *request;
+    char *str;
+    int32_t n;
+
+    orcm_sensor_base_inventory_collect();
+    wanted = exchange_digest();
+    ASSERT_EQ(1U, wanted.size());
+    EXPECT_EQ(std::string("fake"), wanted[0]);
+
+    /* the node answers with just that component */
+    request = sent[0].buf;
+    sent.clear();
+    orcm_sensor_base_inventory_recv_request(ORCM_SUCCESS, &peer, request,
+                                            ORCM_RML_TAG_INVENTORY_REQUEST, NULL);
+    OBJ_RELEASE(request);
+    ASSERT_EQ(1U, sent.size());
+    EXPECT_EQ(ORCM_RML_TAG_INVENTORY, sent[0].tag);
+    n = 1;
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack(sent[0].buf, &str, &n, OPAL_STRING));
+    EXPECT_EQ(std::string(nodename), str);
+    free(str);
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack(sent[0].buf, &str, &n, OPAL_STRING));
+    EXPECT_EQ(std::string("fake"), str);
+    free(str);
+    ASSERT_EQ(OPAL_SUCCESS, opal_dss.unpack(sent[0].buf, &str, &n, OPAL_STRING));
+    EXPECT_EQ(std::string("v1"), str);
+    free(str);
+}
+
+TEST_F(sensor_base_tests, stored_inventory_is_not_asked_for_again)
+{
+    orcm_sensor_base_inventory_collect();
+    ASSERT_EQ(1U, exchange_digest().size());
+    store_inventory();
+    EXPECT_EQ(1, db_writes);
+
+    /* an unchanged node costs just the digest */
+    EXPECT_EQ(0U, exchange_digest().size());
+
+    /* until its inventory changes */
+    inventory_value = "v2";
+    orcm_sensor_base_inventory_collect();
+    EXPECT_EQ(1U, exchange_digest().size());
+}
+
+TEST_F(sensor_base_tests, failed_write_is_asked_for_again)
+{
+    orcm_sensor_base_inventory_collect();
+    ASSERT_EQ(1U, exchange_digest().size());
+    db_status = ORCM_ERROR;
+    store_inventory();
+    EXPECT_EQ(1, db_writes);
+
+    /* the next digest brings it again */
+    ASSERT_EQ(1U, exchange_digest().size());
+    db_status = ORCM_SUCCESS;
+    store_inventory();
+    EXPECT_EQ(0U, exchange_digest().size());
+}
+
+TEST_F(sensor_base_tests, no_database_stores_nothing)
+{
+    orcm_sensor_base_inventory_collect();
+    ASSERT_EQ(1U, exchange_digest().size());
+    orcm_sensor_base.dbhandle = -1;
+    store_inventory();
+    EXPECT_EQ(0, db_writes);
+    EXPECT_EQ(1U, exchange_digest().size());
+}
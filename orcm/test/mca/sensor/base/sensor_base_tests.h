@@ -0,0 +1,28 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#ifndef GREI_ORCM_TEST_MCA_SENSOR_BASE_SENSOR_BASE_TESTS_H
+#define GREI_ORCM_TEST_MCA_SENSOR_BASE_SENSOR_BASE_TESTS_H
+
+#include "gtest/gtest.h"
+
+extern "C" {
+    #include "opal/runtime/opal.h"
+    #include "opal/dss/dss.h"
+    #include "orte/mca/rml/rml.h"
+    #include "orte/util/proc_info.h"
+    #include "orcm/constants.h"
+    #include "orcm/runtime/orcm_globals.h"
+    #include "orcm/mca/db/db.h"
+    #include "orcm/mca/sensor/base/base.h"
+    #include "orcm/mca/sensor/base/sensor_private.h"
+};
+
+class sensor_base_tests : public testing::Test
+{
+    protected:
+        static void SetUpTestCase();
+        virtual void SetUp();
+        virtual void TearDown();
+};
+
+#endif
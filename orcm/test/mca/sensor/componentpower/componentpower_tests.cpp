@@ -0,0 +1,56 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#include "componentpower_tests.h"
+
+TEST(componentpower, delta_without_wrap)
+{
+    EXPECT_EQ(250ULL, orcm_sensor_componentpower_energy_delta(1250, 1000, 0x100000000ULL));
+    EXPECT_EQ(0ULL, orcm_sensor_componentpower_energy_delta(1000, 1000, 0x100000000ULL));
+}
+
+TEST(componentpower, delta_across_32bit_msr_wrap)
+{
+    /* the energy status register rolled over between the readings */
+    EXPECT_EQ(0x30ULL, orcm_sensor_componentpower_energy_delta(0x10, 0xffffffe0ULL,
+                                                               0x100000000ULL));
+}
+
+TEST(componentpower, delta_across_powercap_wrap)
+{
+    /* powercap counts up to max_energy_range_uj, then restarts at zero */
+    unsigned long long range = 262143328850ULL + 1;
+
+    EXPECT_EQ(1000001ULL, orcm_sensor_componentpower_energy_delta(1000000, 262143328850ULL,
+                                                                  range));
+}
+
+TEST(componentpower, delta_across_64bit_wrap)
+{
+    EXPECT_EQ(16ULL, orcm_sensor_componentpower_energy_delta(5, 0xfffffffffffffff5ULL, 0));
+}
+
+TEST(componentpower, power_unit_conversion)
+{
+    /* 50 J of microjoule counts over half a second */
+    EXPECT_DOUBLE_EQ(100.0, orcm_sensor_componentpower_energy_to_power(50000000ULL, 1000000.0,
+                                                                       500000ULL));
+    /* msr energy status units of 2^-14 J over one second */
+    EXPECT_DOUBLE_EQ(2.0, orcm_sensor_componentpower_energy_to_power(32768ULL, 16384.0,
+                                                                     1000000ULL));
+}
+
+TEST(componentpower, power_without_a_reading)
+{
+    EXPECT_DOUBLE_EQ(-1.0, orcm_sensor_componentpower_energy_to_power(0, 1000000.0, 1000000ULL));
+    EXPECT_DOUBLE_EQ(-1.0, orcm_sensor_componentpower_energy_to_power(100, 1000000.0, 0));
+    EXPECT_DOUBLE_EQ(-1.0, orcm_sensor_componentpower_energy_to_power(100, 0.0, 1000000ULL));
+}
+
+TEST(componentpower, power_glitch_is_dropped)
+{
+    /* a backwards step read as a wrap gives an absurd delta */
+    unsigned long long delta = orcm_sensor_componentpower_energy_delta(10, 20, 0x100000000ULL);
+
+    EXPECT_DOUBLE_EQ(-1.0, orcm_sensor_componentpower_energy_to_power(delta, 16384.0,
+                                                                      1000000ULL));
+}
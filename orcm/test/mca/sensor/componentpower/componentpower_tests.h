@@ -0,0 +1,12 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#ifndef GREI_ORCM_TEST_MCA_SENSOR_COMPONENTPOWER_COMPONENTPOWER_TESTS_H
+#define GREI_ORCM_TEST_MCA_SENSOR_COMPONENTPOWER_COMPONENTPOWER_TESTS_H
+
+#include "gtest/gtest.h"
+
+extern "C" {
+    #include "orcm/mca/sensor/componentpower/sensor_componentpower_counter.h"
+};
+
+#endif
@@ -62,6 +62,8 @@ const char* ut_edac_collector_tests::plugin_name_ = "errcounts";
 const char* ut_edac_collector_tests::proc_name_ = "errcounts_tests";
 map<string,string> ut_edac_collector_tests::sysfs_;
 unsigned int ut_edac_collector_tests::fopened_ = 0;
+map<int,string> ut_edac_collector_tests::opened_;
+unsigned int ut_edac_collector_tests::open_calls_ = 0;
 int ut_edac_collector_tests::last_errno_ = 0;
 string ut_edac_collector_tests::last_error_filename_;
 void* ut_edac_collector_tests::last_user_data_ = NULL;
@@ -177,6 +179,9 @@ void ut_edac_collector_tests::TearDownTestCase()
     edac_mocking.fopen_callback = NULL;
     edac_mocking.getline_callback = NULL;
     edac_mocking.fclose_callback = NULL;
+    edac_mocking.open_callback = NULL;
+    edac_mocking.pread_callback = NULL;
+    edac_mocking.close_callback = NULL;
     edac_mocking.orte_errmgr_base_log_callback = NULL;
     edac_mocking.opal_output_verbose_callback = NULL;
     edac_mocking.orte_util_print_name_args_callback = NULL;
@@ -187,6 +192,7 @@ void ut_edac_collector_tests::TearDownTestCase()
     edac_mocking.opal_progress_thread_finalize_callback = NULL;
 
     fopened_ = false;
+    opened_.clear();
 }
 
 void ut_edac_collector_tests::ClearBuffers()
@@ -214,6 +220,9 @@ void ut_edac_collector_tests::ResetTestEnvironment()
     edac_mocking.fopen_callback = FOpen;
     edac_mocking.getline_callback = GetLine;
     edac_mocking.fclose_callback = FClose;
+    edac_mocking.open_callback = Open;
+    edac_mocking.pread_callback = PRead;
+    edac_mocking.close_callback = Close;
     edac_mocking.orte_errmgr_base_log_callback = OrteErrmgrBaseLog;
     edac_mocking.opal_output_verbose_callback = OpalOutputVerbose;
     edac_mocking.orte_util_print_name_args_callback = OrteUtilPrintNameArgs;
@@ -237,6 +246,7 @@ void ut_edac_collector_tests::ResetTestEnvironment()
 
     mca_sensor_errcounts_component.use_progress_thread = false;
     mca_sensor_errcounts_component.sample_rate = 0;
+    mca_sensor_errcounts_component.changed_only = false;
 
     for(int i = 0; i < current_analytics_values_.size(); ++i) {
         SAFE_OBJ_RELEASE(current_analytics_values_[i]);
@@ -339,6 +349,69 @@ int ut_edac_collector_tests::FClose(FILE* fd)
     }
 }
 
+// Mocked descriptors start well above anything the process really has open
+#define MOCK_FD_BASE 10000
+
+int ut_edac_collector_tests::Open(const char* path, int flags)
+{
+    if(0 != strncmp(path, "/sys/devices/system/edac", 24)) {
+        return __real_open(path, flags, 0);
+    }
+    ++open_calls_;
+    if(sysfs_.end() == sysfs_.find(path) || "__DIR__" == sysfs_[path]) {
+        errno = ENOENT;
+        return -1;
+    }
+    int fd = MOCK_FD_BASE;
+    while(opened_.end() != opened_.find(fd)) {
+        ++fd;
+    }
+    opened_[fd] = path;
+    return fd;
+}
+
+int ut_edac_collector_tests::OpenFail(const char* path, int flags)
+{
+    (void)path;
+    (void)flags;
+    ++open_calls_;
+    errno = ENOENT;
+    return -1;
+}
+
+ssize_t ut_edac_collector_tests::PRead(int fd, void* buf, size_t count, off_t offset)
+{
+    if(opened_.end() == opened_.find(fd)) {
+        return __real_pread(fd, buf, count, offset);
+    }
+    string result = sysfs_[opened_[fd]];
+    if((size_t)offset >= result.size()) {
+        return 0;
+    }
+    size_t n = min(result.size() - (size_t)offset, count);
+    memcpy(buf, result.c_str() + offset, n);
+    return (ssize_t)n;
+}
+
+ssize_t ut_edac_collector_tests::PReadFail(int fd, void* buf, size_t count, off_t offset)
+{
+    (void)fd;
+    (void)buf;
+    (void)count;
+    (void)offset;
+    errno = EBADF;
+    return -1;
+}
+
+int ut_edac_collector_tests::Close(int fd)
+{
+    if(opened_.end() == opened_.find(fd)) {
+        return __real_close(fd);
+    }
+    opened_.erase(fd);
+    return 0;
+}
+
 void ut_edac_collector_tests::OrteErrmgrBaseLog(int err, char* file, int lineno)
 {
     (void)file;
@@ -575,7 +648,7 @@ TEST_F(ut_edac_collector_tests, test_get_ce_count)
     ASSERT_EQ(2, collector.get_ce_count(0, 0));
     ASSERT_EQ(6, collector.get_ce_count(1, 0));
 
-    edac_mocking.fopen_callback = FOpenFail;
+    edac_mocking.open_callback = OpenFail;
 
     ASSERT_NE(2, collector.get_ce_count(0, 0));
     ASSERT_NE(6, collector.get_ce_count(1, 0));
@@ -590,7 +663,7 @@ TEST_F(ut_edac_collector_tests, test_get_ue_count)
     ASSERT_EQ(1, collector.get_ue_count(0, 0));
     ASSERT_EQ(2, collector.get_ue_count(1, 0));
 
-    edac_mocking.fopen_callback = FOpenFail;
+    edac_mocking.open_callback = OpenFail;
 
     ASSERT_NE(1, collector.get_ue_count(0, 0));
     ASSERT_NE(2, collector.get_ue_count(1, 0));
@@ -612,7 +685,7 @@ TEST_F(ut_edac_collector_tests, test_get_channel_ce_count)
     ASSERT_EQ(1, collector.get_channel_ce_count(1, 0, 2));
     ASSERT_EQ(2, collector.get_channel_ce_count(1, 0, 3));
 
-    edac_mocking.fopen_callback = FOpenFail;
+    edac_mocking.open_callback = OpenFail;
 
     ASSERT_NE(0, collector.get_channel_ce_count(0, 0, 0));
     ASSERT_NE(1, collector.get_channel_ce_count(0, 0, 1));
@@ -661,6 +734,7 @@ TEST_F(ut_edac_collector_tests, test_get_xx_negative)
     edac_collector collector(ErrorSink);
 
     edac_mocking.fopen_callback = FOpenFail;
+    edac_mocking.open_callback = OpenFail;
 
     ASSERT_STREQ("", collector.get_channel_label(0, 0, 0).c_str());
     ASSERT_EQ(2, last_errno_);
@@ -670,7 +744,9 @@ TEST_F(ut_edac_collector_tests, test_get_xx_negative)
     ASSERT_STREQ("/sys/devices/system/edac/mc/mc0/csrow0/ch1_ce_count", last_error_filename_.c_str());
 
     edac_mocking.fopen_callback = FOpen;
+    edac_mocking.open_callback = Open;
     edac_mocking.getline_callback = GetLineFail;
+    edac_mocking.pread_callback = PReadFail;
 
     ASSERT_STREQ("", collector.get_channel_label(0, 0, 0).c_str());
     ASSERT_EQ(9, last_errno_);
@@ -690,6 +766,9 @@ TEST_F(ut_edac_collector_tests, test_collect_data)
     edac_mocking.fopen_callback = FOpen;
     edac_mocking.getline_callback = GetLine;
     edac_mocking.fclose_callback = FClose;
+    edac_mocking.open_callback = Open;
+    edac_mocking.pread_callback = PRead;
+    edac_mocking.close_callback = Close;
 
     ASSERT_TRUE(collector.collect_data(DataSink, NULL));
     ASSERT_EQ(12, logged_data_.size());
@@ -702,14 +781,14 @@ TEST_F(ut_edac_collector_tests, test_collect_data)
         ++log_it;
     }
 
-    edac_mocking.getline_callback = GetLineFail;
+    edac_mocking.pread_callback = PReadFail;
 
     logged_data_.clear();
     ASSERT_TRUE(collector.collect_data(DataSink, NULL));
     ASSERT_EQ(0, logged_data_.size());
 
-    edac_mocking.fopen_callback = FOpenFail;
-    edac_mocking.getline_callback = GetLine;
+    edac_mocking.open_callback = OpenFail;
+    edac_mocking.pread_callback = PRead;
 
     ASSERT_TRUE(collector.collect_data(DataSink, NULL));
     ASSERT_EQ(0, logged_data_.size());
@@ -717,6 +796,78 @@ TEST_F(ut_edac_collector_tests, test_collect_data)
     ASSERT_FALSE(collector.collect_data(NULL, NULL));
 }
 
+TEST_F(ut_edac_collector_tests, test_collect_data_keeps_descriptors)
+{
+    ResetTestEnvironment();
+    open_calls_ = 0;
+
+    {
+        edac_collector collector(ErrorSink);
+
+        ASSERT_TRUE(collector.collect_data(DataSink, NULL));
+        ASSERT_EQ(12, logged_data_.size());
+        ASSERT_EQ(12, open_calls_);
+        ASSERT_EQ(12, opened_.size());
+
+        // Labels and descriptors are reused; only the counters are read again
+        edac_mocking.fopen_callback = FOpenFail;
+        edac_mocking.stat_callback = StatFail;
+        logged_data_.clear();
+        ASSERT_TRUE(collector.collect_data(DataSink, NULL));
+        ASSERT_EQ(12, logged_data_.size());
+        ASSERT_EQ(12, open_calls_);
+        ASSERT_EQ(12, opened_.size());
+    }
+    ASSERT_EQ(0, opened_.size());
+}
+
+TEST_F(ut_edac_collector_tests, test_collect_data_late_label)
+{
+    ResetTestEnvironment();
+
+    string label = "/sys/devices/system/edac/mc/mc0/csrow0/ch1_dimm_label";
+    string saved = sysfs_[label];
+    sysfs_[label] = "";
+
+    edac_collector collector(ErrorSink);
+
+    ASSERT_TRUE(collector.collect_data(DataSink, NULL));
+    ASSERT_EQ(11, logged_data_.size());
+
+    // The channel is sampled once its label is written
+    sysfs_[label] = saved;
+    logged_data_.clear();
+    ASSERT_TRUE(collector.collect_data(DataSink, NULL));
+    ASSERT_EQ(12, logged_data_.size());
+    ASSERT_EQ(1, logged_data_["TEST_MC0_CSROW0_CH1_CE"]);
+}
+
+TEST_F(ut_edac_collector_tests, test_collect_data_changed_only)
+{
+    ResetTestEnvironment();
+
+    edac_collector collector(ErrorSink);
+
+    ASSERT_TRUE(collector.collect_data(DataSink, NULL, true));
+    ASSERT_EQ(12, logged_data_.size());
+
+    logged_data_.clear();
+    ASSERT_TRUE(collector.collect_data(DataSink, NULL, true));
+    ASSERT_EQ(0, logged_data_.size());
+
+    string saved = sysfs_["/sys/devices/system/edac/mc/mc1/csrow0/ch2_ce_count"];
+    sysfs_["/sys/devices/system/edac/mc/mc1/csrow0/ch2_ce_count"] = "5";
+    ASSERT_TRUE(collector.collect_data(DataSink, NULL, true));
+    sysfs_["/sys/devices/system/edac/mc/mc1/csrow0/ch2_ce_count"] = saved;
+    ASSERT_EQ(1, logged_data_.size());
+    ASSERT_EQ(5, logged_data_["TEST_MC1_CSROW0_CH2_CE"]);
+
+    // A full report still includes unchanged counters
+    logged_data_.clear();
+    ASSERT_TRUE(collector.collect_data(DataSink, NULL));
+    ASSERT_EQ(12, logged_data_.size());
+}
+
 TEST_F(ut_edac_collector_tests, test_collect_inventory)
 {
     ResetTestEnvironment();
@@ -1157,6 +1308,27 @@ TEST_F(ut_edac_collector_tests, test_sample)
     ASSERT_NE(OPAL_SUCCESS, last_orte_error_);
 }
 
+TEST_F(ut_edac_collector_tests, test_sample_changed_only)
+{
+    ResetTestEnvironment();
+
+    mca_sensor_errcounts_component.changed_only = true;
+
+    errcounts_impl dummy;
+    dummy.init();
+
+    orcm_sensor_sampler_t sampler;
+    dummy.sample(&sampler);
+    ASSERT_EQ(12, dummy.data_samples_labels_.size());
+
+    orcm_sensor_sampler_t unchanged;
+    dummy.sample(&unchanged);
+    ASSERT_EQ(0, dummy.data_samples_labels_.size());
+
+    mca_sensor_errcounts_component.changed_only = false;
+    dummy.finalize();
+}
+
 TEST_F(ut_edac_collector_tests, test_inventory_collect)
 {
     ResetTestEnvironment();
@@ -36,6 +36,11 @@ class ut_edac_collector_tests: public testing::Test
         static ssize_t GetLine(char** line_buf, size_t* line_buff_size, FILE* fd);
         static ssize_t GetLineFail(char** line_buf, size_t* line_buff_size, FILE* fd);
         static int FClose(FILE* fd);
+        static int Open(const char* path, int flags);
+        static int OpenFail(const char* path, int flags);
+        static ssize_t PRead(int fd, void* buf, size_t count, off_t offset);
+        static ssize_t PReadFail(int fd, void* buf, size_t count, off_t offset);
+        static int Close(int fd);
         static void OrteErrmgrBaseLog(int err, char* file, int lineno);
         static void OpalOutputVerbose(int level, int output_id, const char* line);
         static char* OrteUtilPrintNameArgs(const orte_process_name_t *name);
@@ -57,6 +62,8 @@ class ut_edac_collector_tests: public testing::Test
         static const char* proc_name_;
         static std::map<std::string,std::string> sysfs_;
         static unsigned int fopened_;
+        static std::map<int,std::string> opened_;
+        static unsigned int open_calls_;
         static int last_errno_;
         static std::string last_error_filename_;
         static void* last_user_data_;
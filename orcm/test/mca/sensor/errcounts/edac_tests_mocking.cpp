@@ -17,6 +17,7 @@ edac_tests_mocking edac_mocking;
 
 extern "C" { // Mocking must use correct "C" linkages
     #include <stdarg.h>
+    #include <fcntl.h>
 
     int __wrap_stat(const char* pathname, struct stat* sb)
     {
@@ -53,6 +54,40 @@ extern "C" { // Mocking must use correct "C" linkages
         }
     }
 
+    int __wrap_open(const char* path, int flags, ...)
+    {
+        mode_t mode = 0;
+        if(0 != (flags & O_CREAT)) {
+            va_list args;
+            va_start(args, flags);
+            mode = (mode_t)va_arg(args, int);
+            va_end(args);
+        }
+        if(NULL == edac_mocking.open_callback) {
+            return __real_open(path, flags, mode);
+        } else {
+            return edac_mocking.open_callback(path, flags);
+        }
+    }
+
+    ssize_t __wrap_pread(int fd, void* buf, size_t count, off_t offset)
+    {
+        if(NULL == edac_mocking.pread_callback) {
+            return __real_pread(fd, buf, count, offset);
+        } else {
+            return edac_mocking.pread_callback(fd, buf, count, offset);
+        }
+    }
+
+    int __wrap_close(int fd)
+    {
+        if(NULL == edac_mocking.close_callback) {
+            return __real_close(fd);
+        } else {
+            return edac_mocking.close_callback(fd);
+        }
+    }
+
     void __wrap_orte_errmgr_base_log(int err, char* file, int lineno)
     {
         if(NULL == edac_mocking.orte_errmgr_base_log_callback) {
@@ -129,6 +164,7 @@ extern "C" { // Mocking must use correct "C" linkages
 
 edac_tests_mocking::edac_tests_mocking() :
     stat_callback(NULL), fopen_callback(NULL), getline_callback(NULL), fclose_callback(NULL),
+    open_callback(NULL), pread_callback(NULL), close_callback(NULL),
     orte_errmgr_base_log_callback(NULL), opal_output_verbose_callback(NULL),
     orte_util_print_name_args_callback(NULL), opal_dss_pack_callback(NULL),
     opal_dss_unpack_callback(NULL), orcm_analytics_base_send_data_callback(NULL),
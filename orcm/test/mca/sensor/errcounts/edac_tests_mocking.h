@@ -23,6 +23,9 @@ extern "C" {
     extern FILE* __real_fopen(const char* path, const char* mode);
     extern ssize_t __real_getline(char** line_buf, size_t* line_buff_size, FILE* fd);
     extern int __real_fclose(FILE* fd);
+    extern int __real_open(const char* path, int flags, ...);
+    extern ssize_t __real_pread(int fd, void* buf, size_t count, off_t offset);
+    extern int __real_close(int fd);
     extern void __real_orte_errmgr_base_log(int err, char* file, int lineno);
     extern void __real_opal_output_verbose(int level, int output_id, const char* format, ...);
     extern char* __real_orte_util_print_name_args(const orte_process_name_t* name);
@@ -40,6 +43,9 @@ typedef int (*stat_callback_fn_t)(const char* pathname, struct stat* sb);
 typedef FILE* (*fopen_callback_fn_t)(const char* path, const char* mode);
 typedef ssize_t (*getline_callback_fn_t)(char** line_buf, size_t* line_buff_size, FILE* fd);
 typedef int (*fclose_callback_fn_t)(FILE* fd);
+typedef int (*open_callback_fn_t)(const char* path, int flags);
+typedef ssize_t (*pread_callback_fn_t)(int fd, void* buf, size_t count, off_t offset);
+typedef int (*close_callback_fn_t)(int fd);
 typedef void (*orte_errmgr_base_log_callback_fn_t)(int err, char* file, int lineno);
 typedef void (*opal_output_verbose_callback_fn_t)(int level, int id, const char* line);
 typedef char* (*orte_util_print_name_args_fn_t)(const orte_process_name_t* name);
@@ -60,6 +66,9 @@ class edac_tests_mocking
         fopen_callback_fn_t fopen_callback;
         getline_callback_fn_t getline_callback;
         fclose_callback_fn_t fclose_callback;
+        open_callback_fn_t open_callback;
+        pread_callback_fn_t pread_callback;
+        close_callback_fn_t close_callback;
         orte_errmgr_base_log_callback_fn_t orte_errmgr_base_log_callback;
         opal_output_verbose_callback_fn_t opal_output_verbose_callback;
         orte_util_print_name_args_fn_t orte_util_print_name_args_callback;
@@ -0,0 +1,195 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#include "procfs_tests.h"
+
+#include <string>
+
+/* the parsers work in place, so each test hands them its own copy */
+static std::string text;
+
+static char *canned(const char *data)
+{
+    text = data;
+    return &text[0];
+}
+
+TEST(procfs, stat_command_with_blanks_and_parens)
+{
+    char *data = canned("4321 (a) b (c)) R 1 4321 4321 0 -1 4194304 150 0 2 0 700 300 "
+                        "0 0 20 0 3 0 123456 10485760 2560 18446744073709551615 1 1 "
+                        "0 0 0 0 0 0 0 0 0 0 17 5 0 0 0 0 0\n");
+    char *cmd = NULL;
+    size_t cmdlen = 0;
+    char state = '\0';
+    int64_t fields[40];
+
+    ASSERT_TRUE(procfs_parse_stat(data, &cmd, &cmdlen, &state, fields, 40));
+    EXPECT_EQ(std::string("a) b (c)"), std::string(cmd, cmdlen));
+    EXPECT_EQ('R', state);
+    EXPECT_EQ(1, fields[4]);
+    EXPECT_EQ(-1, fields[8]);
+    EXPECT_EQ(150, fields[10]);
+    EXPECT_EQ(2, fields[12]);
+    EXPECT_EQ(700, fields[14]);
+    EXPECT_EQ(300, fields[15]);
+    EXPECT_EQ(20, fields[18]);
+    EXPECT_EQ(3, fields[20]);
+    EXPECT_EQ(10485760, fields[23]);
+    EXPECT_EQ(2560, fields[24]);
+    EXPECT_EQ(17, fields[38]);
+    EXPECT_EQ(5, fields[39]);
+}
+
+TEST(procfs, stat_stops_at_requested_fields)
+{
+    char *data = canned("7 (kworker/0:1) I 2 0 0 0 -1 69238880 0 0 0 0 0 12 0 0 20 0 1 0");
+    char *cmd = NULL;
+    size_t cmdlen = 0;
+    char state = '\0';
+    int64_t fields[21];
+
+    ASSERT_TRUE(procfs_parse_stat(data, &cmd, &cmdlen, &state, fields, 21));
+    EXPECT_EQ(std::string("kworker/0:1"), std::string(cmd, cmdlen));
+    EXPECT_EQ('I', state);
+    EXPECT_EQ(2, fields[4]);
+    EXPECT_EQ(12, fields[15]);
+    EXPECT_EQ(1, fields[20]);
+}
+
+TEST(procfs, stat_without_command_is_rejected)
+{
+    char *cmd = NULL;
+    size_t cmdlen = 0;
+    char state = '\0';
+    int64_t fields[21];
+
+    EXPECT_FALSE(procfs_parse_stat(canned("4321 R 1 2 3"), &cmd, &cmdlen, &state, fields, 21));
+    EXPECT_FALSE(procfs_parse_stat(canned("4321 (cut short"), &cmd, &cmdlen, &state, fields, 21));
+}
+
+TEST(procfs, meminfo_tags)
+{
+    procfs_meminfo_t mi;
+    char *data = canned("MemTotal:       16318668 kB\n"
+                        "MemFree:         1234567 kB\n"
+                        "MemAvailable:    9876543 kB\n"
+                        "Buffers:          204800 kB\n"
+                        "Cached:          4096000 kB\n"
+                        "SwapCached:         1024 kB\n"
+                        "Active:          5000000 kB\n"
+                        "SwapTotal:       2097148 kB\n"
+                        "SwapFree:        2000000 kB\n"
+                        "Dirty:                12 kB\n");
+
+    ASSERT_TRUE(procfs_parse_meminfo(data, &mi));
+    EXPECT_EQ(16318668ULL * 1024, mi.total);
+    EXPECT_EQ(1234567ULL * 1024, mi.free);
+    EXPECT_EQ(204800ULL * 1024, mi.buffers);
+    /* SwapCached must not be taken for Cached */
+    EXPECT_EQ(4096000ULL * 1024, mi.cached);
+    EXPECT_EQ(2097148ULL * 1024, mi.swap_total);
+    EXPECT_EQ(2000000ULL * 1024, mi.swap_free);
+}
+
+TEST(procfs, meminfo_without_total_is_rejected)
+{
+    procfs_meminfo_t mi;
+
+    EXPECT_FALSE(procfs_parse_meminfo(canned("MemFree: 10 kB\nCached: 20 kB\n"), &mi));
+    EXPECT_EQ(10ULL * 1024, mi.free);
+    EXPECT_EQ(20ULL * 1024, mi.cached);
+}
+
+TEST(procfs, vmstat_tags)
+{
+    uint64_t page_in = 1, page_out = 1;
+
+    procfs_parse_vmstat(canned("nr_free_pages 12345\n"
+                               "pgpgin 100\n"
+                               "pswpin 42\n"
+                               "pswpout 7\n"
+                               "pgfault 9\n"), &page_in, &page_out);
+    EXPECT_EQ(42U, page_in);
+    EXPECT_EQ(7U, page_out);
+
+    /* a kernel without swap accounting */
+    procfs_parse_vmstat(canned("nr_free_pages 12345\npgpgin 100\n"), &page_in, &page_out);
+    EXPECT_EQ(0U, page_in);
+    EXPECT_EQ(0U, page_out);
+}
+
+TEST(procfs, diskstats_lines)
+{
+    char *cur = canned("   8       0 sda 1000 20 30000 400 500 60 70000 800 0 900 1200\n"
+                       "   8       2 sda2 3 24 5 40\n"
+                       " 259       0 nvme0n1 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15\n"
+                       "\n");
+    char *name;
+    size_t len;
+    uint64_t fields[PROCFS_DISK_FIELDS];
+
+    ASSERT_TRUE(procfs_parse_diskstats(&cur, &name, &len, fields));
+    EXPECT_EQ(std::string("sda"), std::string(name, len));
+    EXPECT_EQ(1000U, fields[0]);
+    EXPECT_EQ(30000U, fields[2]);
+    EXPECT_EQ(500U, fields[4]);
+    EXPECT_EQ(70000U, fields[6]);
+    EXPECT_EQ(1200U, fields[10]);
+
+    /* an old-style partition line only has four counters */
+    ASSERT_TRUE(scan_line(&cur));
+    ASSERT_TRUE(procfs_parse_diskstats(&cur, &name, &len, fields));
+    EXPECT_EQ(std::string("sda2"), std::string(name, len));
+    EXPECT_EQ(3U, fields[0]);
+    EXPECT_EQ(40U, fields[3]);
+    EXPECT_EQ(0U, fields[4]);
+    EXPECT_EQ(0U, fields[10]);
+
+    /* newer kernels append counters we do not use */
+    ASSERT_TRUE(scan_line(&cur));
+    ASSERT_TRUE(procfs_parse_diskstats(&cur, &name, &len, fields));
+    EXPECT_EQ(std::string("nvme0n1"), std::string(name, len));
+    EXPECT_EQ(11U, fields[10]);
+
+    ASSERT_TRUE(scan_line(&cur));
+    EXPECT_FALSE(procfs_parse_diskstats(&cur, &name, &len, fields));
+    EXPECT_FALSE(scan_line(&cur));
+}
+
+TEST(procfs, netdev_lines)
+{
+    char *cur = canned("Inter-|   Receive                                                |  Transmit\n"
+                       " face |bytes    packets errs drop fifo frame compressed multicast|"
+                       "bytes    packets errs drop fifo colls carrier compressed\n"
+                       "    lo:    1000      10    0    0    0     0          0         0"
+                       "     1000      10    0    0    0     0       0          0\n"
+                       "verylongname0:123456789 98765 1 2 0 0 0 5 87654321 54321 3 0 0 0 0 0\n"
+                       "garbage\n");
+    char *name;
+    size_t len;
+    uint64_t fields[PROCFS_NET_FIELDS];
+
+    ASSERT_TRUE(scan_line(&cur));
+    ASSERT_TRUE(scan_line(&cur));
+
+    ASSERT_TRUE(procfs_parse_netdev(&cur, &name, &len, fields));
+    EXPECT_EQ(std::string("lo"), std::string(name, len));
+    EXPECT_EQ(1000U, fields[0]);
+    EXPECT_EQ(10U, fields[1]);
+    EXPECT_EQ(1000U, fields[8]);
+    EXPECT_EQ(10U, fields[9]);
+
+    /* the name runs straight into the first counter */
+    ASSERT_TRUE(scan_line(&cur));
+    ASSERT_TRUE(procfs_parse_netdev(&cur, &name, &len, fields));
+    EXPECT_EQ(std::string("verylongname0"), std::string(name, len));
+    EXPECT_EQ(123456789U, fields[0]);
+    EXPECT_EQ(98765U, fields[1]);
+    EXPECT_EQ(1U, fields[2]);
+    EXPECT_EQ(87654321U, fields[8]);
+    EXPECT_EQ(54321U, fields[9]);
+    EXPECT_EQ(3U, fields[10]);
+
+    ASSERT_TRUE(scan_line(&cur));
+    EXPECT_FALSE(procfs_parse_netdev(&cur, &name, &len, fields));
+}
@@ -0,0 +1,12 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#ifndef GREI_ORCM_TEST_MCA_SENSOR_PROCFS_PROCFS_TESTS_H
+#define GREI_ORCM_TEST_MCA_SENSOR_PROCFS_PROCFS_TESTS_H
+
+#include "gtest/gtest.h"
+
+extern "C" {
+    #include "orcm/mca/sensor/procfs/sensor_procfs_parse.h"
+};
+
+#endif
@@ -117,6 +117,7 @@ void ut_snmp_collector_tests::TearDownTestCase()
     snmp_mocking.opal_progress_thread_finalize_callback = NULL;
     snmp_mocking.snmp_open_callback = NULL;
     snmp_mocking.snmp_synch_response_callback = NULL;
+    snmp_mocking.snmp_async_send_callback = NULL;
     snmp_mocking.snmp_free_pdu_callback = NULL;
     snmp_mocking.snmp_pdu_create_callback = NULL;
     snmp_mocking.snmp_parse_oid_callback = NULL;
@@ -152,6 +153,7 @@ void ut_snmp_collector_tests::ResetTestEnvironment()
     snmp_mocking.opal_progress_thread_finalize_callback = NULL;
     snmp_mocking.snmp_open_callback = SnmpOpen;
     snmp_mocking.snmp_synch_response_callback = SnmpSynchResponse;
+    snmp_mocking.snmp_async_send_callback = SnmpAsyncSend;
     snmp_mocking.snmp_free_pdu_callback = SnmpFreePdu;
     snmp_mocking.snmp_pdu_create_callback = SnmpPDUCreate;
     snmp_mocking.snmp_parse_oid_callback = ReadObjid;
@@ -319,6 +321,26 @@ int ut_snmp_collector_tests::SnmpSynchResponse_packeterror(netsnmp_session *sess
     return STAT_SUCCESS;
 }
 
+// Answers at once with whatever the synchronous mock would have returned
+int ut_snmp_collector_tests::SnmpAsyncSend(netsnmp_session *session,
+                                           netsnmp_pdu *pdu,
+                                           snmp_callback callback,
+                                           void *cb_data)
+{
+    netsnmp_pdu *response = NULL;
+    int status = snmp_mocking.snmp_synch_response_callback(session, pdu, &response);
+
+    if (STAT_SUCCESS == status) {
+        callback(NETSNMP_CALLBACK_OP_RECEIVED_MESSAGE, session, 1, response, cb_data);
+        SnmpFreePdu(response);
+    } else if (STAT_TIMEOUT == status) {
+        callback(NETSNMP_CALLBACK_OP_TIMED_OUT, session, 1, pdu, cb_data);
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
 void ut_snmp_collector_tests::SnmpFreePdu(netsnmp_pdu *pdu)
 {
   netsnmp_variable_list *vars = pdu->variables;
@@ -707,3 +729,34 @@ TEST_F(ut_snmp_collector_tests, test_negative_collectData)
 
     delete collector;
 }
+
+TEST_F(ut_snmp_collector_tests, test_async_collect_and_backoff)
+{
+    vector<snmpCollector> collectors;
+    vector<vardata> collectedData;
+
+    collectors.push_back(snmpCollector("192.168.1.100", "public"));
+    collectors[0].setOIDs(".1.3.6.1.2.1.1.7.0");
+
+    ASSERT_FALSE(collectors[0].sendRequest());
+    snmpCollector::completeRequests(collectors);
+    collectedData = collectors[0].getResults();
+    ASSERT_EQ(5, collectedData.size());
+    ASSERT_STREQ("192.168.1.100 snmp_latency_ms", collectedData[4].getKey().c_str());
+
+    // first failure is retried at the next sweep, the second backs off
+    snmp_mocking.snmp_synch_response_callback = SnmpSynchResponse_timeout;
+    collectors[0].sendRequest();
+    ASSERT_THROW(collectors[0].getResults(), snmpTimeout);
+    collectors[0].sendRequest();
+    ASSERT_THROW(collectors[0].getResults(), snmpTimeout);
+    collectors[0].sendRequest();
+    ASSERT_THROW(collectors[0].getResults(), snmpBackoff);
+
+    // a device that answers again is back to normal at once
+    snmp_mocking.snmp_synch_response_callback = SnmpSynchResponse;
+    collectors[0].sendRequest();
+    ASSERT_EQ(5, collectors[0].getResults().size());
+
+    collectors[0].closeSession();
+}
@@ -42,6 +42,7 @@ class ut_snmp_collector_tests: public testing::Test
         static int SnmpSynchResponse_error(netsnmp_session *session, netsnmp_pdu *pdu, netsnmp_pdu **response);
         static int SnmpSynchResponse_timeout(netsnmp_session *session, netsnmp_pdu *pdu, netsnmp_pdu **response);
         static int SnmpSynchResponse_packeterror(netsnmp_session *session, netsnmp_pdu *pdu, netsnmp_pdu **response);
+        static int SnmpAsyncSend(netsnmp_session *session, netsnmp_pdu *pdu, snmp_callback callback, void *cb_data);
         static void SnmpFreePdu(netsnmp_pdu *pdu);
         static void sample_check(opal_buffer_t *bucket);
         static struct snmp_pdu *SnmpPDUCreate(int command);
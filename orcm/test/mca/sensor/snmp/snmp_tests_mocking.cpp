@@ -36,6 +36,16 @@ extern "C" { // Mocking must use correct "C" linkages
         }
     }
 
+    int __wrap_snmp_async_send(netsnmp_session *session, netsnmp_pdu *pdu,
+                               snmp_callback callback, void *cb_data)
+    {
+        if(NULL == snmp_mocking.snmp_async_send_callback) {
+            return __real_snmp_async_send(session, pdu, callback, cb_data);
+        } else {
+            return snmp_mocking.snmp_async_send_callback(session, pdu, callback, cb_data);
+        }
+    }
+
     void __wrap_snmp_free_pdu(netsnmp_pdu *pdu)
     {
         if(NULL == snmp_mocking.snmp_free_pdu_callback) {
@@ -143,7 +153,8 @@ snmp_tests_mocking::snmp_tests_mocking() :
     orte_errmgr_base_log_callback(NULL), opal_output_verbose_callback(NULL),
     orte_util_print_name_args_callback(NULL), orcm_analytics_base_send_data_callback(NULL),
     opal_progress_thread_init_callback(NULL), opal_progress_thread_finalize_callback(NULL),
-    snmp_open_callback(NULL), snmp_synch_response_callback(NULL), snmp_free_pdu_callback(NULL),
+    snmp_open_callback(NULL), snmp_synch_response_callback(NULL), snmp_async_send_callback(NULL),
+    snmp_free_pdu_callback(NULL),
     snmp_pdu_create_callback(NULL), snmp_parse_oid_callback(NULL), snmp_add_null_var_callback(NULL),
     snprint_objid_callback(NULL)
 {
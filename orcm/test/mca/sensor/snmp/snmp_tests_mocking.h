@@ -31,6 +31,7 @@ extern "C" {
     extern int __real_opal_progress_thread_finalize(const char* name);
     extern struct snmp_session* __real_snmp_open(struct snmp_session* ss);
     extern int __real_snmp_synch_response(netsnmp_session *session, netsnmp_pdu *pdu, netsnmp_pdu **response);
+    extern int __real_snmp_async_send(netsnmp_session *session, netsnmp_pdu *pdu, snmp_callback callback, void *cb_data);
     extern void __real_snmp_free_pdu(netsnmp_pdu *pdu);
     extern struct snmp_pdu* __real_snmp_pdu_create(int command);
     extern int __real_snmp_parse_oid(const char *input, oid *objid, size_t *objidlen);
@@ -49,6 +50,7 @@ typedef opal_event_base_t* (*opal_progress_thread_init_fn_t)(const char* name);
 typedef int (*opal_progress_thread_finalize_fn_t)(const char* name);
 typedef struct snmp_session* (*snmp_open_callback_fn_t)(struct snmp_session* ss);
 typedef int (*snmp_synch_response_callback_ft_t)(netsnmp_session *session, netsnmp_pdu *pdu, netsnmp_pdu **response);
+typedef int (*snmp_async_send_callback_ft_t)(netsnmp_session *session, netsnmp_pdu *pdu, snmp_callback callback, void *cb_data);
 typedef void (*snmp_free_pdu_callback_ft_t)(netsnmp_pdu* pdu);
 typedef struct snmp_pdu* (*snmp_pdu_create_callback_ft_t)(int command);
 typedef oid* (*snmp_parse_oid_callback_ft_t)(const char *input, oid *objid, size_t *objidlen);
@@ -70,6 +72,7 @@ class snmp_tests_mocking
         opal_progress_thread_finalize_fn_t opal_progress_thread_finalize_callback;
         snmp_open_callback_fn_t snmp_open_callback;
         snmp_synch_response_callback_ft_t snmp_synch_response_callback;
+        snmp_async_send_callback_ft_t snmp_async_send_callback;
         snmp_free_pdu_callback_ft_t snmp_free_pdu_callback;
         snmp_pdu_create_callback_ft_t snmp_pdu_create_callback;
         snmp_parse_oid_callback_ft_t snmp_parse_oid_callback;
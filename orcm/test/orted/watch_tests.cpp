@@ -0,0 +1,174 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#include "watch_tests.h"
+
+void watch_tests::SetUpTestCase()
+{
+    opal_init_test();
+    orte_dt_init();
+}
+
+void watch_tests::SetUp()
+{
+    orte_watch_table_init(&table);
+}
+
+void watch_tests::TearDown()
+{
+    orte_watch_table_clear(&table);
+    OBJ_DESTRUCT(&table.records);
+    OBJ_DESTRUCT(&table.index);
+}
+
+/* stand-in for the packed state of an object */
+orte_watch_record_t* watch_tests::set(orte_watch_flag_t kind, orte_jobid_t job,
+                                      orte_vpid_t vpid, const char *node, int32_t value)
+{
+    orte_process_name_t name;
+    orte_watch_record_t *rec;
+    opal_buffer_t scratch;
+
+    name.jobid = job;
+    name.vpid = vpid;
+    rec = orte_watch_table_lookup(&table, kind, &name, (char*)node);
+    OBJ_CONSTRUCT(&scratch, opal_buffer_t);
+    EXPECT_EQ(OPAL_SUCCESS, opal_dss.pack(&scratch, &value, 1, OPAL_INT32));
+    orte_watch_table_update(&table, rec, &scratch);
+    OBJ_DESTRUCT(&scratch);
+    return rec;
+}
+
+int32_t watch_tests::pack(orte_watcher_t *w, bool snapshot)
+{
+    opal_buffer_t msg;
+    int32_t count = -1;
+
+    OBJ_CONSTRUCT(&msg, opal_buffer_t);
+    EXPECT_EQ(ORTE_SUCCESS, orte_watch_table_pack(&table, w, snapshot, &msg, &count));
+    OBJ_DESTRUCT(&msg);
+    return count;
+}
+
+TEST_F(watch_tests, matches_filters)
+{
+    orte_watcher_t *w = OBJ_NEW(orte_watcher_t);
+    orte_watch_record_t *proc = set(ORTE_WATCH_PROCS, 5, 3, "n1", 0);
+    orte_watch_record_t *job = set(ORTE_WATCH_JOBS, 5, ORTE_VPID_INVALID, NULL, 0);
+    orte_watch_record_t *node = set(ORTE_WATCH_NODES, 0, 0, "n2", 0);
+    orte_vpid_t ranks[] = {1, 3};
+
+    w->what = ORTE_WATCH_JOBS;
+    EXPECT_FALSE(orte_watch_matches(w, proc));
+    EXPECT_TRUE(orte_watch_matches(w, job));
+    EXPECT_FALSE(orte_watch_matches(w, node));
+
+    w->what = ORTE_WATCH_JOBS | ORTE_WATCH_PROCS | ORTE_WATCH_NODES;
+    EXPECT_TRUE(orte_watch_matches(w, proc));
+    EXPECT_TRUE(orte_watch_matches(w, node));
+
+    /* the job filter leaves nodes alone */
+    w->job = 6;
+    EXPECT_FALSE(orte_watch_matches(w, proc));
+    EXPECT_FALSE(orte_watch_matches(w, job));
+    EXPECT_TRUE(orte_watch_matches(w, node));
+    w->job = 5;
+    EXPECT_TRUE(orte_watch_matches(w, proc));
+
+    /* and the node filter leaves jobs alone */
+    w->node = strdup("n2");
+    EXPECT_FALSE(orte_watch_matches(w, proc));
+    EXPECT_TRUE(orte_watch_matches(w, job));
+    EXPECT_TRUE(orte_watch_matches(w, node));
+    free(w->node);
+    w->node = strdup("n1");
+    EXPECT_TRUE(orte_watch_matches(w, proc));
+    EXPECT_FALSE(orte_watch_matches(w, node));
+
+    w->nranks = 2;
+    w->ranks = (orte_vpid_t*)malloc(sizeof(ranks));
+    memcpy(w->ranks, ranks, sizeof(ranks));
+    EXPECT_TRUE(orte_watch_matches(w, proc));
+    w->ranks[1] = 2;
+    EXPECT_FALSE(orte_watch_matches(w, proc));
+
+    OBJ_RELEASE(w);
+}
+
+TEST_F(watch_tests, snapshot_then_only_changes)
+{
+    orte_watcher_t *w = OBJ_NEW(orte_watcher_t);
+    orte_watch_record_t *rec;
+
+    w->what = ORTE_WATCH_PROCS;
+    set(ORTE_WATCH_PROCS, 1, 0, "n1", 10);
+    rec = set(ORTE_WATCH_PROCS, 1, 1, "n1", 20);
+    set(ORTE_WATCH_PROCS, 1, 2, "n2", 30);
+    /* not something this watcher asked for */
+    set(ORTE_WATCH_JOBS, 1, ORTE_VPID_INVALID, NULL, 1);
+
+    EXPECT_EQ(3, pack(w, true));
+    EXPECT_EQ(table.generation, w->sent);
+    EXPECT_EQ(0, pack(w, false));
+
+    /* the same state again is not a change */
+    set(ORTE_WATCH_PROCS, 1, 1, "n1", 20);
+    EXPECT_EQ(0, pack(w, false));
+
+    set(ORTE_WATCH_PROCS, 1, 1, "n1", 21);
+    EXPECT_EQ(1, pack(w, false));
+    EXPECT_EQ(0, pack(w, false));
+
+    /* a removal goes out once as a change, and is not in a snapshot */
+    orte_watch_table_gone(&table, rec);
+    orte_watch_table_gone(&table, rec);
+    EXPECT_EQ(1, pack(w, false));
+    EXPECT_EQ(2, pack(w, true));
+
+    /* a watcher that has seen nothing gets everything changed so far */
+    OBJ_RELEASE(w);
+    w = OBJ_NEW(orte_watcher_t);
+    w->what = ORTE_WATCH_PROCS;
+    EXPECT_EQ(3, pack(w, false));
+    OBJ_RELEASE(w);
+}
+
+TEST_F(watch_tests, purge_waits_for_every_watcher)
+{
+    opal_list_t watchers;
+    orte_watcher_t *fast = OBJ_NEW(orte_watcher_t);
+    orte_watcher_t *slow = OBJ_NEW(orte_watcher_t);
+    orte_watch_record_t *rec;
+    orte_process_name_t name;
+
+    OBJ_CONSTRUCT(&watchers, opal_list_t);
+    opal_list_append(&watchers, &fast->super);
+    opal_list_append(&watchers, &slow->super);
+    fast->what = slow->what = ORTE_WATCH_PSTATS;
+
+    rec = set(ORTE_WATCH_PSTATS, 1, 0, "n1", 100);
+    set(ORTE_WATCH_PSTATS, 1, 1, "n1", 200);
+    EXPECT_EQ(2, table.npstats);
+    EXPECT_EQ(2, pack(fast, true));
+    EXPECT_EQ(2, pack(slow, true));
+
+    orte_watch_table_gone(&table, rec);
+    EXPECT_EQ(1, pack(fast, false));
+    orte_watch_table_purge(&table, &watchers);
+    name.jobid = 1;
+    name.vpid = 0;
+    /* the slow watcher has not been told yet */
+    EXPECT_TRUE(rec == orte_watch_table_find(&table, ORTE_WATCH_PSTATS, &name, NULL));
+    EXPECT_EQ(2, table.npstats);
+
+    EXPECT_EQ(1, pack(slow, false));
+    orte_watch_table_purge(&table, &watchers);
+    EXPECT_TRUE(NULL == orte_watch_table_find(&table, ORTE_WATCH_PSTATS, &name, NULL));
+    EXPECT_EQ(1, table.npstats);
+    EXPECT_EQ(1, (int)opal_list_get_size(&table.records));
+
+    /* a later change to the live record is still delivered */
+    set(ORTE_WATCH_PSTATS, 1, 1, "n1", 201);
+    EXPECT_EQ(1, pack(slow, false));
+
+    OPAL_LIST_DESTRUCT(&watchers);
+}
@@ -0,0 +1,31 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#ifndef GREI_ORCM_TEST_ORTED_WATCH_TESTS_H
+#define GREI_ORCM_TEST_ORTED_WATCH_TESTS_H
+
+#include "gtest/gtest.h"
+
+extern "C" {
+    #include "opal/runtime/opal.h"
+    #include "opal/dss/dss.h"
+    #include "orte/constants.h"
+    #include "orte/runtime/runtime_internals.h"
+    #include "orte/orted/orted_watch_table.h"
+};
+
+class watch_tests: public testing::Test
+{
+    protected:
+        static void SetUpTestCase();
+
+        virtual void SetUp();
+        virtual void TearDown();
+
+        orte_watch_record_t* set(orte_watch_flag_t kind, orte_jobid_t job, orte_vpid_t vpid,
+                                 const char *node, int32_t value);
+        int32_t pack(orte_watcher_t *w, bool snapshot);
+
+        orte_watch_table_t table;
+};
+
+#endif
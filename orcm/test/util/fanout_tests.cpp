@@ -0,0 +1,529 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#include "fanout_tests.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/* the wire layout of fanout.c - kept in step by hand */
+#define FANOUT_REQUEST 1
+#define FANOUT_REPLY   2
+
+#define TEST_JOB       1
+#define TEST_TAG       77
+#define MY_VPID        0
+#define PARENT_VPID    100
+#define SCHEDULER_VPID 50
+
+typedef struct {
+    orte_process_name_t peer;
+    opal_buffer_t *buf;
+} sent_t;
+
+typedef struct {
+    orte_vpid_t vpid;
+    int status;
+    std::string data;
+} record_t;
+
+static std::vector<sent_t> sent;
+static std::map<orte_vpid_t, orte_vpid_t> routes;
+static orte_rml_buffer_callback_fn_t recv_cb;
+/* what the scheduler answers orcm_fanout_send with */
+static std::vector<record_t> scheduler_answer;
+
+static orte_rml_module_send_buffer_nb_fn_t saved_send;
+static orte_rml_module_recv_buffer_nb_fn_t saved_recv;
+static orte_rml_module_recv_cancel_fn_t saved_cancel;
+static orte_routed_module_get_route_fn_t saved_route;
+static orte_process_name_t saved_name, saved_parent, saved_scheduler;
+static opal_event_base_t *saved_base;
+
+static orte_process_name_t name(orte_vpid_t vpid)
+{
+    orte_process_name_t n;
+
+    n.jobid = TEST_JOB;
+    n.vpid = vpid;
+    return n;
+}
+
+static void pack_record(opal_buffer_t *buf, orte_vpid_t vpid, int status,
+                        const std::string &data)
+{
+    orte_process_name_t n = name(vpid);
+    opal_buffer_t payload, *bptr = &payload;
+    const char *str = data.c_str();
+
+    OBJ_CONSTRUCT(&payload, opal_buffer_t);
+    if (!data.empty()) {
+        opal_dss.pack(&payload, &str, 1, OPAL_STRING);
+    }
+    opal_dss.pack(buf, &n, 1, ORTE_NAME);
+    opal_dss.pack(buf, &status, 1, OPAL_INT);
+    opal_dss.pack(buf, &bptr, 1, OPAL_BUFFER);
+    OBJ_DESTRUCT(&payload);
+}
+
+static std::string data_string(opal_buffer_t *data)
+{
+    std::string s;
+    char *str;
+    int32_t n = 1;
+
+    if (NULL != data && OPAL_SUCCESS == opal_dss.unpack(data, &str, &n, OPAL_STRING)) {
+        s = str;
+        free(str);
+    }
+    return s;
+}
+
+static void deliver(orte_vpid_t from, opal_buffer_t *buf)
+{
+    orte_process_name_t sender = name(from);
+
+    recv_cb(ORTE_SUCCESS, &sender, buf, ORCM_RML_TAG_FANOUT, NULL);
+}
+
+static int capture(orte_process_name_t *peer, struct opal_buffer_t *buffer,
+                   orte_rml_tag_t tag, orte_rml_buffer_callback_fn_t cbfunc,
+                   void *cbdata)
+{
+    opal_buffer_t ans;
+    uint8_t flag;
+    uint32_t id;
+    int32_t n = 1, i;
+    sent_t s;
+
+    EXPECT_EQ(ORCM_RML_TAG_FANOUT, tag);
+    if (SCHEDULER_VPID != peer->vpid) {
+        s.peer = *peer;
+        s.buf = buffer;
+        sent.push_back(s);
+        return ORTE_SUCCESS;
+    }
+
+    /* a tool's request - the scheduler answers at once */
+    opal_dss.unpack(buffer, &flag, &n, OPAL_UINT8);
+    opal_dss.unpack(buffer, &id, &n, OPAL_UINT32);
+    OBJ_RELEASE(buffer);
+    OBJ_CONSTRUCT(&ans, opal_buffer_t);
+    flag = FANOUT_REPLY;
+    n = (int32_t)scheduler_answer.size();
+    opal_dss.pack(&ans, &flag, 1, OPAL_UINT8);
+    opal_dss.pack(&ans, &id, 1, OPAL_UINT32);
+    opal_dss.pack(&ans, &n, 1, OPAL_INT32);
+    for (i = 0; i < n; i++) {
+        pack_record(&ans, scheduler_answer[i].vpid, scheduler_answer[i].status,
+                    scheduler_answer[i].data);
+    }
+    deliver(SCHEDULER_VPID, &ans);
+    OBJ_DESTRUCT(&ans);
+    return ORTE_SUCCESS;
+}
+
+static void listen(orte_process_name_t *peer, orte_rml_tag_t tag, bool persistent,
+                   orte_rml_buffer_callback_fn_t cbfunc, void *cbdata)
+{
+    recv_cb = cbfunc;
+}
+
+static void cancel(orte_process_name_t *peer, orte_rml_tag_t tag)
+{
+}
+
+static orte_process_name_t route(orte_process_name_t *target)
+{
+    std::map<orte_vpid_t, orte_vpid_t>::iterator it = routes.find(target->vpid);
+
+    return name((routes.end() == it) ? ORTE_VPID_INVALID : it->second);
+}
+
+/* echo the string of the command back */
+static int echo(opal_buffer_t *request, opal_buffer_t *reply)
+{
+    char *str;
+    int32_t n = 1;
+    int rc;
+
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(request, &str, &n, OPAL_STRING))) {
+        return rc;
+    }
+    rc = opal_dss.pack(reply, &str, 1, OPAL_STRING);
+    free(str);
+    return rc;
+}
+
+static opal_buffer_t* request(uint32_t id, int32_t timeout_ms,
+                              const std::vector<orte_vpid_t> &targets)
+{
+    opal_buffer_t *buf = OBJ_NEW(opal_buffer_t);
+    uint8_t flag = FANOUT_REQUEST;
+    orte_rml_tag_t tag = TEST_TAG;
+    int32_t n = (int32_t)targets.size();
+    const char *cmd = "hello";
+    std::vector<orte_process_name_t> names;
+    size_t i;
+
+    for (i = 0; i < targets.size(); i++) {
+        names.push_back(name(targets[i]));
+    }
+    opal_dss.pack(buf, &flag, 1, OPAL_UINT8);
+    opal_dss.pack(buf, &id, 1, OPAL_UINT32);
+    opal_dss.pack(buf, &tag, 1, ORTE_RML_TAG_T);
+    opal_dss.pack(buf, &timeout_ms, 1, OPAL_INT32);
+    opal_dss.pack(buf, &n, 1, OPAL_INT32);
+    /* the names go as one array */
+    if (0 < n) {
+        opal_dss.pack(buf, &names[0], n, ORTE_NAME);
+    }
+    opal_dss.pack(buf, &cmd, 1, OPAL_STRING);
+    return buf;
+}
+
+/* read a reply the fan-out sent, returning the id it answers */
+static uint32_t read_reply(opal_buffer_t *buf, std::vector<record_t> &records)
+{
+    orte_process_name_t n;
+    opal_buffer_t *data;
+    record_t rec;
+    uint8_t flag = 0;
+    uint32_t id = 0;
+    int32_t cnt = 1, num, i;
+
+    records.clear();
+    EXPECT_EQ(OPAL_SUCCESS, opal_dss.unpack(buf, &flag, &cnt, OPAL_UINT8));
+    EXPECT_EQ(FANOUT_REPLY, flag);
+    EXPECT_EQ(OPAL_SUCCESS, opal_dss.unpack(buf, &id, &cnt, OPAL_UINT32));
+    EXPECT_EQ(OPAL_SUCCESS, opal_dss.unpack(buf, &num, &cnt, OPAL_INT32));
+    for (i = 0; i < num; i++) {
+        EXPECT_EQ(OPAL_SUCCESS, opal_dss.unpack(buf, &n, &cnt, ORTE_NAME));
+        EXPECT_EQ(OPAL_SUCCESS, opal_dss.unpack(buf, &rec.status, &cnt, OPAL_INT));
+        EXPECT_EQ(OPAL_SUCCESS, opal_dss.unpack(buf, &data, &cnt, OPAL_BUFFER));
+        rec.vpid = n.vpid;
+        rec.data = data_string(data);
+        OBJ_RELEASE(data);
+        records.push_back(rec);
+    }
+    return id;
+}
+
+/* the targets and timeout of a request the fan-out relayed */
+static void read_request(opal_buffer_t *buf, uint32_t *id, int32_t *timeout_ms,
+                         std::vector<orte_vpid_t> &targets)
+{
+    std::vector<orte_process_name_t> names;
+    orte_rml_tag_t tag;
+    uint8_t flag = 0;
+    int32_t cnt = 1, num, i;
+
+    targets.clear();
+    EXPECT_EQ(OPAL_SUCCESS, opal_dss.unpack(buf, &flag, &cnt, OPAL_UINT8));
+    EXPECT_EQ(FANOUT_REQUEST, flag);
+    EXPECT_EQ(OPAL_SUCCESS, opal_dss.unpack(buf, id, &cnt, OPAL_UINT32));
+    EXPECT_EQ(OPAL_SUCCESS, opal_dss.unpack(buf, &tag, &cnt, ORTE_RML_TAG_T));
+    EXPECT_EQ(TEST_TAG, tag);
+    EXPECT_EQ(OPAL_SUCCESS, opal_dss.unpack(buf, timeout_ms, &cnt, OPAL_INT32));
+    EXPECT_EQ(OPAL_SUCCESS, opal_dss.unpack(buf, &num, &cnt, OPAL_INT32));
+    ASSERT_LT(0, num);
+    names.resize(num);
+    cnt = num;
+    EXPECT_EQ(OPAL_SUCCESS, opal_dss.unpack(buf, &names[0], &cnt, ORTE_NAME));
+    for (i = 0; i < num; i++) {
+        targets.push_back(names[i].vpid);
+    }
+}
+
+static void clear_sent(void)
+{
+    size_t i;
+
+    for (i = 0; i < sent.size(); i++) {
+        OBJ_RELEASE(sent[i].buf);
+    }
+    sent.clear();
+}
+
+void fanout_tests::SetUpTestCase()
+{
+    opal_init_test();
+    orte_dt_init();
+}
+
+void fanout_tests::SetUp()
+{
+    saved_send = orte_rml.send_buffer_nb;
+    saved_recv = orte_rml.recv_buffer_nb;
+    saved_cancel = orte_rml.recv_cancel;
+    saved_route = orte_routed.get_route;
+    saved_name = orte_process_info.my_name;
+    saved_parent = orte_process_info.my_parent;
+    saved_scheduler = orte_process_info.my_scheduler;
+    saved_base = orte_event_base;
+
+    orte_rml.send_buffer_nb = capture;
+    orte_rml.recv_buffer_nb = listen;
+    orte_rml.recv_cancel = cancel;
+    orte_routed.get_route = route;
+    orte_process_info.my_name = name(MY_VPID);
+    orte_process_info.my_parent = name(PARENT_VPID);
+    orte_process_info.my_scheduler = name(SCHEDULER_VPID);
+    orte_event_base = opal_sync_event_base;
+
+    routes.clear();
+    scheduler_answer.clear();
+    recv_cb = NULL;
+    orcm_fanout_start();
+    ASSERT_TRUE(NULL != recv_cb);
+    orcm_fanout_register(TEST_TAG, echo);
+}
+
+void fanout_tests::TearDown()
+{
+    orcm_fanout_stop();
+    clear_sent();
+    orte_rml.send_buffer_nb = saved_send;
+    orte_rml.recv_buffer_nb = saved_recv;
+    orte_rml.recv_cancel = saved_cancel;
+    orte_routed.get_route = saved_route;
+    orte_process_info.my_name = saved_name;
+    orte_process_info.my_parent = saved_parent;
+    orte_process_info.my_scheduler = saved_scheduler;
+    orte_event_base = saved_base;
+}
+
+TEST_F(fanout_tests, garbled_request_is_answered_empty)
+{
+    opal_buffer_t *buf = OBJ_NEW(opal_buffer_t);
+    std::vector<record_t> records;
+    uint8_t flag = FANOUT_REQUEST;
+
+    /* nothing past the flag, not even the id */
+    opal_dss.pack(buf, &flag, 1, OPAL_UINT8);
+    deliver(PARENT_VPID, buf);
+    OBJ_RELEASE(buf);
+
+    ASSERT_EQ(1U, sent.size());
+    EXPECT_EQ(PARENT_VPID, sent[0].peer.vpid);
+    EXPECT_EQ(0U, read_reply(sent[0].buf, records));
+    EXPECT_EQ(0U, records.size());
+}
+
+TEST_F(fanout_tests, local_target_runs_the_handler)
+{
+    std::vector<orte_vpid_t> targets(1, MY_VPID);
+    std::vector<record_t> records;
+    opal_buffer_t *buf;
+
+    buf = request(41, 1000, targets);
+    deliver(PARENT_VPID, buf);
+    OBJ_RELEASE(buf);
+    ASSERT_EQ(1U, sent.size());
+    EXPECT_EQ(41U, read_reply(sent[0].buf, records));
+    ASSERT_EQ(1U, records.size());
+    EXPECT_EQ((orte_vpid_t)MY_VPID, records[0].vpid);
+    EXPECT_EQ(ORCM_SUCCESS, records[0].status);
+    EXPECT_EQ(std::string("hello"), records[0].data);
+
+    /* a tag nobody registered is reported, not dropped */
+    clear_sent();
+    orcm_fanout_register(TEST_TAG, NULL);
+    buf = request(42, 1000, targets);
+    deliver(PARENT_VPID, buf);
+    OBJ_RELEASE(buf);
+    ASSERT_EQ(1U, sent.size());
+    EXPECT_EQ(42U, read_reply(sent[0].buf, records));
+    ASSERT_EQ(1U, records.size());
+    EXPECT_EQ(ORCM_ERR_NOT_SUPPORTED, records[0].status);
+}
+
+TEST_F(fanout_tests, targets_are_split_by_hop_and_merged)
+{
+    std::vector<orte_vpid_t> targets, got;
+    std::vector<record_t> records;
+    opal_buffer_t *buf, ans;
+    uint32_t id1, id3;
+    int32_t timeout_ms, n;
+    uint8_t flag = FANOUT_REPLY;
+
+    routes[1] = 1;
+    routes[2] = 1;
+    routes[3] = 3;
+    targets.push_back(1);
+    targets.push_back(3);
+    targets.push_back(2);
+    buf = request(7, 1000, targets);
+    deliver(PARENT_VPID, buf);
+    OBJ_RELEASE(buf);
+
+    /* one request per hop, with a share of our time */
+    ASSERT_EQ(2U, sent.size());
+    EXPECT_EQ(1U, sent[0].peer.vpid);
+    read_request(sent[0].buf, &id1, &timeout_ms, got);
+    EXPECT_EQ(750, timeout_ms);
+    ASSERT_EQ(2U, got.size());
+    EXPECT_EQ(1U, got[0]);
+    EXPECT_EQ(2U, got[1]);
+    EXPECT_EQ(3U, sent[1].peer.vpid);
+    read_request(sent[1].buf, &id3, &timeout_ms, got);
+    ASSERT_EQ(1U, got.size());
+    EXPECT_EQ(3U, got[0]);
+    EXPECT_EQ(id1, id3);
+    clear_sent();
+
+    /* nothing goes up until every hop has answered */
+    OBJ_CONSTRUCT(&ans, opal_buffer_t);
+    n = 2;
+    opal_dss.pack(&ans, &flag, 1, OPAL_UINT8);
+    opal_dss.pack(&ans, &id1, 1, OPAL_UINT32);
+    opal_dss.pack(&ans, &n, 1, OPAL_INT32);
+    pack_record(&ans, 1, ORCM_SUCCESS, "one");
+    pack_record(&ans, 2, ORCM_ERR_NOT_SUPPORTED, "");
+    deliver(1, &ans);
+    OBJ_DESTRUCT(&ans);
+    EXPECT_EQ(0U, sent.size());
+
+    OBJ_CONSTRUCT(&ans, opal_buffer_t);
+    n = 1;
+    opal_dss.pack(&ans, &flag, 1, OPAL_UINT8);
+    opal_dss.pack(&ans, &id3, 1, OPAL_UINT32);
+    opal_dss.pack(&ans, &n, 1, OPAL_INT32);
+    pack_record(&ans, 3, ORCM_SUCCESS, "three");
+    deliver(3, &ans);
+    OBJ_DESTRUCT(&ans);
+
+    ASSERT_EQ(1U, sent.size());
+    EXPECT_EQ(PARENT_VPID, sent[0].peer.vpid);
+    EXPECT_EQ(7U, read_reply(sent[0].buf, records));
+    ASSERT_EQ(3U, records.size());
+    EXPECT_EQ(1U, records[0].vpid);
+    EXPECT_EQ(std::string("one"), records[0].data);
+    EXPECT_EQ(2U, records[1].vpid);
+    EXPECT_EQ(ORCM_ERR_NOT_SUPPORTED, records[1].status);
+    EXPECT_EQ(3U, records[2].vpid);
+    EXPECT_EQ(std::string("three"), records[2].data);
+}
+
+TEST_F(fanout_tests, unreachable_and_silent_hops_are_reported)
+{
+    std::vector<orte_vpid_t> targets, got;
+    std::vector<record_t> records;
+    opal_buffer_t *buf, ans;
+    uint32_t id;
+    int32_t timeout_ms, n = 0;
+    uint8_t flag = FANOUT_REPLY;
+    int loops;
+
+    /* 5 has no route, 8 is only reached back through our parent */
+    routes[6] = 6;
+    routes[8] = PARENT_VPID;
+    targets.push_back(5);
+    targets.push_back(6);
+    targets.push_back(8);
+    buf = request(9, 20, targets);
+    deliver(PARENT_VPID, buf);
+    OBJ_RELEASE(buf);
+    ASSERT_EQ(1U, sent.size());
+    EXPECT_EQ(6U, sent[0].peer.vpid);
+    read_request(sent[0].buf, &id, &timeout_ms, got);
+    clear_sent();
+
+    /* 6 never answers */
+    for (loops = 0; loops < 100 && sent.empty(); loops++) {
+        opal_event_loop(orte_event_base, OPAL_EVLOOP_ONCE);
+    }
+    ASSERT_EQ(1U, sent.size());
+    EXPECT_EQ(9U, read_reply(sent[0].buf, records));
+    ASSERT_EQ(3U, records.size());
+    EXPECT_EQ(5U, records[0].vpid);
+    EXPECT_EQ(ORCM_ERR_UNREACH, records[0].status);
+    EXPECT_EQ(8U, records[1].vpid);
+    EXPECT_EQ(ORCM_ERR_UNREACH, records[1].status);
+    EXPECT_EQ(6U, records[2].vpid);
+    EXPECT_EQ(ORCM_ERR_TIMEOUT, records[2].status);
+    clear_sent();
+
+    /* its late answer finds nothing to join */
+    OBJ_CONSTRUCT(&ans, opal_buffer_t);
+    opal_dss.pack(&ans, &flag, 1, OPAL_UINT8);
+    opal_dss.pack(&ans, &id, 1, OPAL_UINT32);
+    opal_dss.pack(&ans, &n, 1, OPAL_INT32);
+    deliver(6, &ans);
+    OBJ_DESTRUCT(&ans);
+    EXPECT_EQ(0U, sent.size());
+}
+
+TEST_F(fanout_tests, send_returns_replies_in_target_order)
+{
+    orte_process_name_t targets[4];
+    opal_buffer_t payload;
+    opal_list_t replies;
+    orcm_fanout_reply_t *rep;
+    const char *cmd = "hello";
+    record_t rec;
+    int i = 0;
+
+    targets[0] = name(3);
+    targets[1] = name(1);
+    targets[2] = name(3);
+    targets[3] = name(7);
+    /* records come back in whatever order the tree merged them,
+     * one per listing of a name, plus one nobody asked for */
+    rec.vpid = 3; rec.status = ORCM_SUCCESS; rec.data = "b";
+    scheduler_answer.push_back(rec);
+    rec.vpid = 9; rec.status = ORCM_SUCCESS; rec.data = "stray";
+    scheduler_answer.push_back(rec);
+    rec.vpid = 1; rec.status = ORCM_SUCCESS; rec.data = "a";
+    scheduler_answer.push_back(rec);
+    rec.vpid = 3; rec.status = ORCM_ERR_TIMEOUT; rec.data = "dropped";
+    scheduler_answer.push_back(rec);
+
+    OBJ_CONSTRUCT(&payload, opal_buffer_t);
+    opal_dss.pack(&payload, &cmd, 1, OPAL_STRING);
+    OBJ_CONSTRUCT(&replies, opal_list_t);
+    ASSERT_EQ(ORCM_SUCCESS, orcm_fanout_send(TEST_TAG, targets, 4, &payload, 5, &replies));
+    OBJ_DESTRUCT(&payload);
+
+    ASSERT_EQ(4U, opal_list_get_size(&replies));
+    OPAL_LIST_FOREACH(rep, &replies, orcm_fanout_reply_t) {
+        EXPECT_EQ(targets[i].vpid, rep->node.vpid);
+        switch (i) {
+        case 0:
+            EXPECT_EQ(ORCM_SUCCESS, rep->status);
+            EXPECT_EQ(std::string("b"), data_string(rep->data));
+            break;
+        case 1:
+            EXPECT_EQ(ORCM_SUCCESS, rep->status);
+            EXPECT_EQ(std::string("a"), data_string(rep->data));
+            break;
+        case 2:
+            /* the data of a failed node is not passed on */
+            EXPECT_EQ(ORCM_ERR_TIMEOUT, rep->status);
+            EXPECT_TRUE(NULL == rep->data);
+            break;
+        case 3:
+            /* and a node missing from the answer is still listed */
+            EXPECT_EQ(ORCM_ERR_NOT_FOUND, rep->status);
+            break;
+        }
+        i++;
+    }
+    OPAL_LIST_DESTRUCT(&replies);
+}
+
+TEST_F(fanout_tests, send_rejects_bad_arguments)
+{
+    orte_process_name_t target = name(1);
+    opal_buffer_t payload;
+    opal_list_t replies;
+
+    OBJ_CONSTRUCT(&payload, opal_buffer_t);
+    OBJ_CONSTRUCT(&replies, opal_list_t);
+    EXPECT_EQ(ORCM_ERR_BAD_PARAM, orcm_fanout_send(TEST_TAG, NULL, 1, &payload, 5, &replies));
+    EXPECT_EQ(ORCM_ERR_BAD_PARAM, orcm_fanout_send(TEST_TAG, &target, 0, &payload, 5, &replies));
+    EXPECT_EQ(ORCM_ERR_BAD_PARAM, orcm_fanout_send(TEST_TAG, &target, 1, NULL, 5, &replies));
+    EXPECT_EQ(0U, opal_list_get_size(&replies));
+    OBJ_DESTRUCT(&payload);
+    OBJ_DESTRUCT(&replies);
+}
@@ -0,0 +1,30 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#ifndef GREI_ORCM_TEST_UTIL_FANOUT_TESTS_H
+#define GREI_ORCM_TEST_UTIL_FANOUT_TESTS_H
+
+#include "gtest/gtest.h"
+
+extern "C" {
+    #include "opal/runtime/opal.h"
+    #include "opal/dss/dss.h"
+    #include "opal/mca/event/event.h"
+    #include "orte/mca/rml/rml.h"
+    #include "orte/mca/routed/routed.h"
+    #include "orte/runtime/orte_globals.h"
+    #include "orte/runtime/runtime_internals.h"
+    #include "orte/util/proc_info.h"
+    #include "orcm/constants.h"
+    #include "orcm/runtime/orcm_globals.h"
+    #include "orcm/util/fanout.h"
+};
+
+class fanout_tests : public testing::Test
+{
+    protected:
+        static void SetUpTestCase();
+        virtual void SetUp();
+        virtual void TearDown();
+};
+
+#endif
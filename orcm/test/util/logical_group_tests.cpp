@@ -0,0 +1,144 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#include "logical_group_tests.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+static char storage_file[] = "/tmp/logical_group_tests.XXXXXX";
+
+static int count_members(const char *tag)
+{
+    orcm_logical_group_members_t *members =
+        orcm_logical_group_get_members((char*)tag, LOGICAL_GROUP.groups);
+
+    return (NULL == members) ? 0 : members->count;
+}
+
+void logical_group_tests::SetUpTestCase()
+{
+    int fd;
+
+    opal_init_test();
+    fd = mkstemp(storage_file);
+    close(fd);
+}
+
+void logical_group_tests::SetUp()
+{
+    ASSERT_EQ(ORCM_SUCCESS, orcm_logical_group_load_to_memory(storage_file));
+    ASSERT_EQ(ORCM_SUCCESS, orcm_logical_group_add((char*)"compute",
+                                                   (char*)"c[2:1-20]", LOGICAL_GROUP.groups));
+    ASSERT_EQ(ORCM_SUCCESS, orcm_logical_group_add((char*)"rack1",
+                                                   (char*)"c[2:1-10],agg01", LOGICAL_GROUP.groups));
+}
+
+void logical_group_tests::TearDown()
+{
+    orcm_logical_group_finalize();
+    unlink(storage_file);
+}
+
+TEST_F(logical_group_tests, add_ignores_repeated_members)
+{
+    EXPECT_EQ(20, count_members("compute"));
+    ASSERT_EQ(ORCM_SUCCESS, orcm_logical_group_add((char*)"compute",
+                                                   (char*)"c[2:5-25]", LOGICAL_GROUP.groups));
+    EXPECT_EQ(25, count_members("compute"));
+}
+
+TEST_F(logical_group_tests, set_operations_between_tags)
+{
+    orcm_logical_group_members_t *compute =
+        orcm_logical_group_get_members((char*)"compute", LOGICAL_GROUP.groups);
+    orcm_logical_group_members_t *rack1 =
+        orcm_logical_group_get_members((char*)"rack1", LOGICAL_GROUP.groups);
+    orcm_logical_group_members_t *both = OBJ_NEW(orcm_logical_group_members_t);
+
+    ASSERT_EQ(ORCM_SUCCESS, orcm_logical_group_members_union(both, compute));
+    ASSERT_EQ(ORCM_SUCCESS, orcm_logical_group_members_intersect(both, rack1));
+    EXPECT_EQ(10, both->count);
+    EXPECT_FALSE(orcm_logical_group_members_contain(both, (char*)"agg01"));
+
+    ASSERT_EQ(ORCM_SUCCESS, orcm_logical_group_members_union(both, rack1));
+    EXPECT_EQ(11, both->count);
+    EXPECT_TRUE(orcm_logical_group_members_contain(both, (char*)"agg01"));
+
+    ASSERT_EQ(ORCM_SUCCESS, orcm_logical_group_members_subtract(both, compute));
+    EXPECT_EQ(1, both->count);
+    EXPECT_TRUE(orcm_logical_group_members_contain(both, (char*)"agg01"));
+    EXPECT_FALSE(orcm_logical_group_members_contain(both, (char*)"c01"));
+    OBJ_RELEASE(both);
+}
+
+TEST_F(logical_group_tests, remove_members_and_empty_groups)
+{
+    EXPECT_EQ(ORCM_ERR_NODE_NOT_EXIST,
+              orcm_logical_group_remove((char*)"rack1", (char*)"c11", LOGICAL_GROUP.groups));
+    EXPECT_EQ(ORCM_ERR_GROUP_NOT_EXIST,
+              orcm_logical_group_remove((char*)"rack9", (char*)"c01", LOGICAL_GROUP.groups));
+
+    ASSERT_EQ(ORCM_SUCCESS,
+              orcm_logical_group_remove((char*)"*", (char*)"c[2:1-10]", LOGICAL_GROUP.groups));
+    EXPECT_EQ(10, count_members("compute"));
+    EXPECT_EQ(1, count_members("rack1"));
+
+    ASSERT_EQ(ORCM_SUCCESS,
+              orcm_logical_group_remove((char*)"rack1", (char*)"agg01", LOGICAL_GROUP.groups));
+    EXPECT_TRUE(NULL == orcm_logical_group_get_members((char*)"rack1", LOGICAL_GROUP.groups));
+}
+
+TEST_F(logical_group_tests, list_specific_members)
+{
+    opal_hash_table_t *o_groups;
+
+    o_groups = orcm_logical_group_list((char*)"*", (char*)"c05,agg01", LOGICAL_GROUP.groups);
+    ASSERT_TRUE(NULL != o_groups);
+    EXPECT_EQ(2U, opal_hash_table_get_size(o_groups));
+    EXPECT_EQ(1, orcm_logical_group_get_members((char*)"compute", o_groups)->count);
+    EXPECT_EQ(2, orcm_logical_group_get_members((char*)"rack1", o_groups)->count);
+    orcm_logical_group_list_release(o_groups, LOGICAL_GROUP.groups);
+
+    o_groups = orcm_logical_group_list((char*)"rack1", (char*)"*", LOGICAL_GROUP.groups);
+    ASSERT_TRUE(NULL != o_groups);
+    EXPECT_EQ(11, orcm_logical_group_get_members((char*)"rack1", o_groups)->count);
+    orcm_logical_group_list_release(o_groups, LOGICAL_GROUP.groups);
+    EXPECT_EQ(11, count_members("rack1"));
+}
+
+TEST_F(logical_group_tests, parse_expands_nested_groups_once)
+{
+    char **nodes = NULL;
+
+    ASSERT_EQ(ORCM_SUCCESS, orcm_logical_group_add((char*)"all",
+                                                   (char*)"rack1,compute,login1",
+                                                   LOGICAL_GROUP.groups));
+    ASSERT_EQ(ORCM_SUCCESS, orcm_logical_group_parse_array_string((char*)"c01,$all,$rack1",
+                                                                  &nodes));
+    /* c01-c20, agg01 and login1, with c01 first as given */
+    ASSERT_EQ(22, opal_argv_count(nodes));
+    EXPECT_STREQ("c01", nodes[0]);
+    for (int i = 0; NULL != nodes[i]; i++) {
+        EXPECT_STRNE("all", nodes[i]);
+        EXPECT_STRNE("rack1", nodes[i]);
+    }
+    opal_argv_free(nodes);
+}
+
+TEST_F(logical_group_tests, save_and_load_round_trip)
+{
+    char **nodes = NULL;
+
+    ASSERT_EQ(ORCM_SUCCESS, orcm_logical_group_add((char*)"compute", (char*)"c[4:1-2000]",
+                                                   LOGICAL_GROUP.groups));
+    ASSERT_EQ(ORCM_SUCCESS, orcm_logical_group_save_to_file(storage_file,
+                                                            LOGICAL_GROUP.groups));
+    orcm_logical_group_finalize();
+
+    ASSERT_EQ(ORCM_SUCCESS, orcm_logical_group_load_to_memory(storage_file));
+    EXPECT_EQ(2020, count_members("compute"));
+    EXPECT_EQ(11, count_members("rack1"));
+    ASSERT_EQ(ORCM_SUCCESS, orcm_logical_group_parse_array_string((char*)"$compute", &nodes));
+    EXPECT_EQ(2020, opal_argv_count(nodes));
+    opal_argv_free(nodes);
+}
@@ -0,0 +1,22 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#ifndef GREI_ORCM_TEST_UTIL_LOGICAL_GROUP_TESTS_H
+#define GREI_ORCM_TEST_UTIL_LOGICAL_GROUP_TESTS_H
+
+#include "gtest/gtest.h"
+
+extern "C" {
+    #include "opal/runtime/opal.h"
+    #include "opal/util/argv.h"
+    #include "orcm/util/logical_group.h"
+};
+
+class logical_group_tests : public testing::Test
+{
+    protected:
+        static void SetUpTestCase();
+        virtual void SetUp();
+        virtual void TearDown();
+};
+
+#endif
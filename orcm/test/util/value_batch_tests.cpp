@@ -0,0 +1,143 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#include "value_batch_tests.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/time.h>
+
+void value_batch_tests::SetUpTestCase()
+{
+    opal_init_test();
+}
+
+void value_batch_tests::TearDownTestCase()
+{
+    orcm_value_intern_finalize();
+}
+
+TEST_F(value_batch_tests, intern_returns_one_copy_per_string)
+{
+    char name[] = "core 7";
+    const char *first = orcm_value_intern(name);
+    const char *second = orcm_value_intern("core 7");
+
+    ASSERT_TRUE(NULL != first);
+    ASSERT_EQ(first, second);
+    ASSERT_NE((const char*)name, first);
+    ASSERT_NE(first, orcm_value_intern("core 8"));
+    ASSERT_TRUE(NULL == orcm_value_intern(NULL));
+}
+
+TEST_F(value_batch_tests, load_copies_data_and_shares_keys)
+{
+    orcm_value_batch_t *batch = OBJ_NEW(orcm_value_batch_t);
+    opal_list_t *list = orcm_value_batch_new_list(batch);
+    char host[] = "node01";
+    float fval = 42.5;
+    struct timeval tv = {1000, 5};
+    uint8_t raw[3] = {1, 2, 3};
+    opal_byte_object_t bo = {3, raw};
+    orcm_value_t *kv;
+
+    kv = orcm_value_batch_load(batch, "hostname", host, OPAL_STRING, NULL);
+    ASSERT_TRUE(NULL != kv);
+    opal_list_append(list, &kv->value.super);
+    host[0] = 'X';
+    ASSERT_STREQ("node01", kv->value.data.string);
+    ASSERT_EQ(orcm_value_intern("hostname"), kv->value.key);
+    ASSERT_TRUE(NULL == kv->units);
+
+    kv = orcm_value_batch_load(batch, "core0", &fval, OPAL_FLOAT, "degrees C");
+    ASSERT_TRUE(NULL != kv);
+    opal_list_append(list, &kv->value.super);
+    ASSERT_EQ(42.5, kv->value.data.fval);
+    ASSERT_EQ(orcm_value_intern("degrees C"), kv->units);
+
+    kv = orcm_value_batch_load(batch, "ctime", &tv, OPAL_TIMEVAL, NULL);
+    ASSERT_TRUE(NULL != kv);
+    opal_list_append(list, &kv->value.super);
+    ASSERT_EQ(1000, kv->value.data.tv.tv_sec);
+
+    kv = orcm_value_batch_load(batch, "raw", &bo, OPAL_BYTE_OBJECT, NULL);
+    ASSERT_TRUE(NULL != kv);
+    opal_list_append(list, &kv->value.super);
+    ASSERT_EQ(3, kv->value.data.bo.size);
+    ASSERT_NE(raw, kv->value.data.bo.bytes);
+    ASSERT_EQ(0, memcmp(raw, kv->value.data.bo.bytes, 3));
+
+    ASSERT_EQ(4, (int)opal_list_get_size(list));
+    OBJ_RELEASE(batch);
+    OBJ_RELEASE(list);
+}
+
+TEST_F(value_batch_tests, values_outlive_released_items_and_grow_past_first_block)
+{
+    orcm_value_batch_t *batch = OBJ_NEW(orcm_value_batch_t);
+    opal_list_t *list = orcm_value_batch_new_list(batch);
+    orcm_value_t *kv;
+    opal_list_item_t *item;
+    char key[32], data[64];
+    int i;
+
+    for (i = 0; i < 1000; i++) {
+        snprintf(key, sizeof(key), "metric%d", i % 50);
+        snprintf(data, sizeof(data), "value number %d", i);
+        kv = orcm_value_batch_load(batch, key, data, OPAL_STRING, "units");
+        ASSERT_TRUE(NULL != kv);
+        opal_list_append(list, &kv->value.super);
+    }
+
+    /* releasing a value off its list must not free it */
+    item = opal_list_remove_first(list);
+    OBJ_RELEASE(item);
+    kv = (orcm_value_t*)opal_list_get_first(list);
+    ASSERT_STREQ("metric1", kv->value.key);
+    ASSERT_STREQ("value number 1", kv->value.data.string);
+    kv = (orcm_value_t*)opal_list_get_last(list);
+    ASSERT_STREQ("metric49", kv->value.key);
+    ASSERT_STREQ("value number 999", kv->value.data.string);
+
+    OBJ_RELEASE(batch);
+    ASSERT_EQ(999, (int)opal_list_get_size(list));
+    OBJ_RELEASE(list);
+}
+
+TEST_F(value_batch_tests, copy_list_matches_heap_copy)
+{
+    opal_list_t src;
+    orcm_value_batch_t *batch = OBJ_NEW(orcm_value_batch_t);
+    opal_list_t *dest = orcm_value_batch_new_list(batch);
+    orcm_value_t *kv, *copy;
+    int32_t ival = -7;
+
+    OBJ_CONSTRUCT(&src, opal_list_t);
+    kv = orcm_util_load_orcm_value("hostname", (void*)"node02", OPAL_STRING, NULL);
+    opal_list_append(&src, &kv->value.super);
+    kv = orcm_util_load_orcm_value("delta", &ival, OPAL_INT32, "count");
+    opal_list_append(&src, &kv->value.super);
+
+    ASSERT_EQ(ORCM_SUCCESS, orcm_value_batch_copy_list(batch, &src, dest));
+    OBJ_RELEASE(batch);
+    ASSERT_EQ(opal_list_get_size(&src), opal_list_get_size(dest));
+
+    copy = (orcm_value_t*)opal_list_get_first(dest);
+    OPAL_LIST_FOREACH(kv, &src, orcm_value_t) {
+        ASSERT_STREQ(kv->value.key, copy->value.key);
+        ASSERT_EQ(kv->value.type, copy->value.type);
+        if (NULL == kv->units) {
+            ASSERT_TRUE(NULL == copy->units);
+        } else {
+            ASSERT_STREQ(kv->units, copy->units);
+        }
+        copy = (orcm_value_t*)opal_list_get_next(&copy->value.super);
+    }
+    copy = (orcm_value_t*)opal_list_get_first(dest);
+    ASSERT_NE(((orcm_value_t*)opal_list_get_first(&src))->value.data.string,
+              copy->value.data.string);
+    ASSERT_STREQ("node02", copy->value.data.string);
+
+    OPAL_LIST_DESTRUCT(&src);
+    ASSERT_STREQ("node02", copy->value.data.string);
+    OBJ_RELEASE(dest);
+}
@@ -0,0 +1,21 @@
+/* Copyright (c) 2016      Intel, Inc. All rights reserved.*/
+
+#ifndef GREI_ORCM_TEST_UTIL_VALUE_BATCH_TESTS_H
+#define GREI_ORCM_TEST_UTIL_VALUE_BATCH_TESTS_H
+
+#include "gtest/gtest.h"
+
+extern "C" {
+    #include "opal/runtime/opal.h"
+    #include "orcm/util/utils.h"
+    #include "orcm/util/value_batch.h"
+};
+
+class value_batch_tests : public testing::Test
+{
+    protected:
+        static void SetUpTestCase();
+        static void TearDownTestCase();
+};
+
+#endif
@@ -24,67 +24,64 @@
  ******************/
 static int orcm_octl_wf_add_parse_line(FILE *fp, int *params_array_length,
                                        opal_value_t tokenized[]);
-static void orcm_octl_analytics_process_error(opal_buffer_t *buf, orte_rml_recv_cb_t *xfer, char **list);
-static void orcm_octl_analytics_output_setup(orte_rml_recv_cb_t *xfer);
-static int orcm_octl_analytics_wf_send_buffer(orte_process_name_t *wf_agg,
-                                              opal_buffer_t *buf, orte_rml_recv_cb_t *xfer);
+typedef int (*orcm_octl_analytics_unpack_fn_t)(opal_buffer_t *data);
+static void orcm_octl_analytics_process_error(opal_buffer_t *buf, char **list);
+static int orcm_octl_analytics_wf_send_buffer(char **nodelist, opal_buffer_t *buf,
+                                              orcm_octl_analytics_unpack_fn_t unpack);
 static int orcm_octl_analytics_wf_add_parse(FILE *fp, int *step_size, int *params_array_length,
                                              opal_value_t *input_array, char ***nodelist);
 static int orcm_oct_analytics_wf_add_store(int params_array_length, opal_value_t *input_array,
                                            opal_value_t **workflow_params_array);
-static void orcm_octl_analytics_wf_add_error(opal_buffer_t *buf, orte_rml_recv_cb_t *xfer,
+static void orcm_octl_analytics_wf_add_error(opal_buffer_t *buf,
                                              opal_value_t *input_array, char **nodelist);
-static int orcm_octl_analytics_wf_add_pack_buffer(opal_buffer_t *buf, orte_rml_recv_cb_t *xfer,
+static int orcm_octl_analytics_wf_add_pack_buffer(opal_buffer_t *buf,
                                                   int step_size, int array_length,
                                                   opal_value_t **workflow_params_array);
-static int orcm_octl_analytics_wf_add_unpack_buffer(orte_rml_recv_cb_t *xfer);
+static int orcm_octl_analytics_wf_add_unpack_buffer(opal_buffer_t *data);
 static int orcm_octl_analytics_wf_remove_parse_args(char **value, int *workflow_id, char ***nodelist);
-static int orcm_octl_analytics_wf_remove_pack_buffer(opal_buffer_t *buf, int workflow_id,
-                                                     orte_rml_recv_cb_t *xfer);
-static int orcm_octl_analytics_wf_remove_unpack_buffer(orte_rml_recv_cb_t *xfer);
+static int orcm_octl_analytics_wf_remove_pack_buffer(opal_buffer_t *buf, int workflow_id);
+static int orcm_octl_analytics_wf_remove_unpack_buffer(opal_buffer_t *data);
 static int orcm_octl_analytics_wf_list_parse_args(char **value, char ***nodelist);
-static int orcm_octl_analytics_wf_list_pack_buffer(opal_buffer_t *buf, orte_rml_recv_cb_t *xfer);
-static int orcm_octl_analytics_wf_list_unpack_buffer(orte_rml_recv_cb_t *xfer);
+static int orcm_octl_analytics_wf_list_pack_buffer(opal_buffer_t *buf);
+static int orcm_octl_analytics_wf_list_unpack_buffer(opal_buffer_t *data);
 
 
 
-static void orcm_octl_analytics_process_error(opal_buffer_t *buf, orte_rml_recv_cb_t *xfer, char **list)
+static void orcm_octl_analytics_process_error(opal_buffer_t *buf, char **list)
 {
     if (NULL != buf) {
         OBJ_RELEASE(buf);
     }
-    if (NULL != xfer) {
-        OBJ_RELEASE(xfer);
-    }
 
     free (list);
-
-    orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_ANALYTICS);
 }
 
-static void orcm_octl_analytics_output_setup(orte_rml_recv_cb_t *xfer)
+/* send the command to every node at once and print each node's answer */
+static int orcm_octl_analytics_wf_send_buffer(char **nodelist, opal_buffer_t *buf,
+                                              orcm_octl_analytics_unpack_fn_t unpack)
 {
-    /* setup to receive the result */
-    xfer->active = true;
-    orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD,
-                            ORCM_RML_TAG_ANALYTICS,
-                            ORTE_RML_NON_PERSISTENT,
-                            orte_rml_recv_callback, xfer);
-
-}
-
-static int orcm_octl_analytics_wf_send_buffer(orte_process_name_t *wf_agg,
-                                              opal_buffer_t *buf, orte_rml_recv_cb_t *xfer)
-{
-    int rc;
-
-    /* send it to the aggregator */
-    if (ORTE_SUCCESS != (rc = orte_rml.send_buffer_nb(wf_agg, buf,
-                                                      ORCM_RML_TAG_ANALYTICS,
-                                                      orte_rml_send_callback, NULL))) {
-        return ORCM_ERROR;
+    opal_list_t replies;
+    orcm_fanout_reply_t *rep;
+    int rc, failed;
+
+    OBJ_CONSTRUCT(&replies, opal_list_t);
+    if (ORCM_SUCCESS != (rc = orcm_octl_fanout(ORCM_RML_TAG_ANALYTICS, nodelist,
+                                               buf, &replies))) {
+        OPAL_LIST_DESTRUCT(&replies);
+        return rc;
     }
-    return ORCM_SUCCESS;
+    failed = orcm_octl_fanout_report(&replies);
+    OPAL_LIST_FOREACH(rep, &replies, orcm_fanout_reply_t) {
+        if (ORCM_SUCCESS != rep->status) {
+            continue;
+        }
+        fprintf(stdout, "\nNode: %s", rep->hostname);
+        if (ORCM_SUCCESS != unpack(rep->data)) {
+            failed++;
+        }
+    }
+    OPAL_LIST_DESTRUCT(&replies);
+    return (0 < failed) ? ORCM_ERROR : ORCM_SUCCESS;
 }
 
 static int orcm_octl_analytics_wf_add_parse(FILE *fp, int *step_size, int *params_array_length,
@@ -169,14 +166,14 @@ static int orcm_oct_analytics_wf_add_store(int params_array_length, opal_value_t
 
 }
 
-static void orcm_octl_analytics_wf_add_error(opal_buffer_t *buf, orte_rml_recv_cb_t *xfer,
+static void orcm_octl_analytics_wf_add_error(opal_buffer_t *buf,
                                              opal_value_t *input_array, char **nodelist)
 {
     free (input_array);
-    orcm_octl_analytics_process_error(buf, xfer, nodelist);
+    orcm_octl_analytics_process_error(buf, nodelist);
 }
 
-static int orcm_octl_analytics_wf_add_pack_buffer(opal_buffer_t *buf, orte_rml_recv_cb_t *xfer,
+static int orcm_octl_analytics_wf_add_pack_buffer(opal_buffer_t *buf,
                                                   int step_size, int array_length,
                                                   opal_value_t **workflow_params_array)
 {
@@ -203,14 +200,14 @@ static int orcm_octl_analytics_wf_add_pack_buffer(opal_buffer_t *buf, orte_rml_r
     return rc;
 }
 
-static int orcm_octl_analytics_wf_add_unpack_buffer(orte_rml_recv_cb_t *xfer)
+static int orcm_octl_analytics_wf_add_unpack_buffer(opal_buffer_t *data)
 {
     int n;
     int rc;
     int workflow_id;
 
     n=1;
-    if (ORCM_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &workflow_id, &n, OPAL_INT))) {
+    if (ORCM_SUCCESS != (rc = opal_dss.unpack(data, &workflow_id, &n, OPAL_INT))) {
         return ORCM_ERROR;
     }
     fprintf(stdout, "\nWorkflow created with id: %i\n", workflow_id);
@@ -221,16 +218,13 @@ static int orcm_octl_analytics_wf_add_unpack_buffer(orte_rml_recv_cb_t *xfer)
 
 int orcm_octl_analytics_workflow_add(char *file)
 {
-    orte_rml_recv_cb_t *xfer = NULL;
     opal_buffer_t *buf = NULL;
     int rc;
     int params_array_length = 0;
     int step_size = 0;
-    int node_index;
     FILE *fp;
     opal_value_t *oflow_input_file_array = NULL;
     opal_value_t *workflow_params_array[OFLOW_MAX_ARRAY_SIZE] ;
-    orte_process_name_t wf_agg;
     char **nodelist = NULL;
 
 
@@ -276,52 +270,14 @@ int orcm_octl_analytics_workflow_add(char *file)
         return ORCM_ERR_OUT_OF_RESOURCE;
     }
 
-    for (node_index = 0; node_index < opal_argv_count(nodelist); node_index++) {
-
-        xfer = OBJ_NEW(orte_rml_recv_cb_t);
-        if (NULL == xfer) {
-            free (oflow_input_file_array);
-            free (nodelist);
-            OBJ_RELEASE(buf);
-            return ORCM_ERR_OUT_OF_RESOURCE;
-        }
-
-        orcm_octl_analytics_output_setup(xfer);
-
-        OBJ_RETAIN(buf);
-
-        if (ORCM_SUCCESS != (rc = orcm_cfgi_base_get_hostname_proc(nodelist[node_index],
-                                                                   &wf_agg))) {
-            orcm_octl_analytics_wf_add_error(buf, xfer,oflow_input_file_array, nodelist);
-            return rc;
-        }
-
-        rc = orcm_octl_analytics_wf_add_pack_buffer(buf, xfer, step_size, params_array_length,
+    rc = orcm_octl_analytics_wf_add_pack_buffer(buf, step_size, params_array_length,
                                                 workflow_params_array);
-        if (ORCM_SUCCESS != rc) {
-            orcm_octl_analytics_wf_add_error(buf, xfer,oflow_input_file_array, nodelist);
-            return rc;
-        }
-
-
-        rc = orcm_octl_analytics_wf_send_buffer(&wf_agg, buf, xfer);
-        if (ORCM_SUCCESS != rc) {
-            orcm_octl_analytics_wf_add_error(buf, xfer,oflow_input_file_array, nodelist);
-            return rc;
-        }
-
-        /* unpack workflow id */
-        ORTE_WAIT_FOR_COMPLETION(xfer->active);
-
-        rc = orcm_octl_analytics_wf_add_unpack_buffer(xfer);
-        if (ORCM_SUCCESS != rc) {
-            orcm_octl_analytics_wf_add_error(buf, xfer,oflow_input_file_array, nodelist);
-            return rc;
-        }
-        OBJ_RELEASE(xfer);
+    if (ORCM_SUCCESS == rc) {
+        rc = orcm_octl_analytics_wf_send_buffer(nodelist, buf,
+                                                orcm_octl_analytics_wf_add_unpack_buffer);
     }
-    orcm_octl_analytics_wf_add_error(buf, NULL, oflow_input_file_array, nodelist);
-    return ORCM_SUCCESS;
+    orcm_octl_analytics_wf_add_error(buf, oflow_input_file_array, nodelist);
+    return rc;
 
 }
 
@@ -357,8 +313,7 @@ static int orcm_octl_analytics_wf_remove_parse_args(char **value, int *workflow_
 
 }
 
-static int orcm_octl_analytics_wf_remove_pack_buffer(opal_buffer_t *buf, int workflow_id,
-                                                     orte_rml_recv_cb_t *xfer)
+static int orcm_octl_analytics_wf_remove_pack_buffer(opal_buffer_t *buf, int workflow_id)
 {
     orcm_analytics_cmd_flag_t command;
     int rc;
@@ -375,7 +330,7 @@ static int orcm_octl_analytics_wf_remove_pack_buffer(opal_buffer_t *buf, int wor
     return ORCM_SUCCESS;
 }
 
-static int orcm_octl_analytics_wf_remove_unpack_buffer(orte_rml_recv_cb_t *xfer)
+static int orcm_octl_analytics_wf_remove_unpack_buffer(opal_buffer_t *data)
 {
     int n;
     int rc;
@@ -383,7 +338,7 @@ static int orcm_octl_analytics_wf_remove_unpack_buffer(orte_rml_recv_cb_t *xfer)
 
     n=1;
 
-    if (ORCM_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &workflow_id, &n, OPAL_INT))) {
+    if (ORCM_SUCCESS != (rc = opal_dss.unpack(data, &workflow_id, &n, OPAL_INT))) {
         return ORCM_ERROR;
     }
     if (ORCM_ERROR != workflow_id) {
@@ -399,11 +354,8 @@ static int orcm_octl_analytics_wf_remove_unpack_buffer(orte_rml_recv_cb_t *xfer)
 int orcm_octl_analytics_workflow_remove(char **value)
 {
     int workflow_id;
-    orte_rml_recv_cb_t *xfer = NULL;
     opal_buffer_t *buf;
-    orte_process_name_t wf_agg;
     char **nodelist=NULL;
-    int node_index;
     int rc;
 
     rc = orcm_octl_analytics_wf_remove_parse_args(value, &workflow_id, &nodelist);
@@ -419,48 +371,13 @@ int orcm_octl_analytics_workflow_remove(char **value)
         return ORCM_ERR_OUT_OF_RESOURCE;
     }
 
-    for (node_index = 0; node_index < opal_argv_count(nodelist); node_index++) {
-
-        xfer = OBJ_NEW(orte_rml_recv_cb_t);
-        if (NULL == xfer) {
-            free (nodelist);
-            OBJ_RELEASE(buf);
-            return ORCM_ERR_OUT_OF_RESOURCE;
-        }
-        orcm_octl_analytics_output_setup(xfer);
-
-        OBJ_RETAIN(buf);
-
-        if (ORCM_SUCCESS != (rc = orcm_cfgi_base_get_hostname_proc(nodelist[node_index],
-                                                                   &wf_agg))) {
-            orcm_octl_analytics_process_error(buf, xfer, nodelist);
-            return rc;
-        }
-
-        rc = orcm_octl_analytics_wf_remove_pack_buffer(buf, workflow_id, xfer);
-        if (ORCM_SUCCESS != rc) {
-            orcm_octl_analytics_process_error(buf, xfer, nodelist);
-            return rc;
-        }
-
-        rc = orcm_octl_analytics_wf_send_buffer(&wf_agg, buf, xfer);
-        if (ORCM_SUCCESS != rc) {
-            orcm_octl_analytics_process_error(buf, xfer, nodelist);
-            return rc;
-        }
-
-        ORTE_WAIT_FOR_COMPLETION(xfer->active);
-
-        rc = orcm_octl_analytics_wf_remove_unpack_buffer(xfer);
-        if (ORCM_SUCCESS != rc) {
-            orcm_octl_analytics_process_error(buf, xfer, nodelist);
-            return rc;
-        }
-
-        OBJ_RELEASE(xfer);
+    rc = orcm_octl_analytics_wf_remove_pack_buffer(buf, workflow_id);
+    if (ORCM_SUCCESS == rc) {
+        rc = orcm_octl_analytics_wf_send_buffer(nodelist, buf,
+                                                orcm_octl_analytics_wf_remove_unpack_buffer);
     }
-    orcm_octl_analytics_process_error(buf, NULL, nodelist);
-    return ORCM_SUCCESS;
+    orcm_octl_analytics_process_error(buf, nodelist);
+    return rc;
 
 }
 
@@ -487,7 +404,7 @@ static int orcm_octl_analytics_wf_list_parse_args(char **value, char ***nodelist
     return ORCM_SUCCESS;
 }
 
-static int orcm_octl_analytics_wf_list_pack_buffer(opal_buffer_t *buf, orte_rml_recv_cb_t *xfer)
+static int orcm_octl_analytics_wf_list_pack_buffer(opal_buffer_t *buf)
 {
     int rc;
     orcm_analytics_cmd_flag_t command;
@@ -501,7 +418,7 @@ static int orcm_octl_analytics_wf_list_pack_buffer(opal_buffer_t *buf, orte_rml_
     return ORCM_SUCCESS;
 }
 
-static int orcm_octl_analytics_wf_list_unpack_buffer(orte_rml_recv_cb_t *xfer)
+static int orcm_octl_analytics_wf_list_unpack_buffer(opal_buffer_t *data)
 {
     int cnt;
     int n;
@@ -511,7 +428,7 @@ static int orcm_octl_analytics_wf_list_unpack_buffer(orte_rml_recv_cb_t *xfer)
 
     n=1;
 
-    if (ORCM_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &cnt, &n, OPAL_INT))) {
+    if (ORCM_SUCCESS != (rc = opal_dss.unpack(data, &cnt, &n, OPAL_INT))) {
         return ORCM_ERROR;
     }
 
@@ -520,7 +437,7 @@ static int orcm_octl_analytics_wf_list_unpack_buffer(orte_rml_recv_cb_t *xfer)
         if (NULL == workflow_ids) {
             return ORCM_ERR_OUT_OF_RESOURCE;
         }
-        if (ORCM_SUCCESS != (rc = opal_dss.unpack(&xfer->data, workflow_ids, &cnt, OPAL_INT))) {
+        if (ORCM_SUCCESS != (rc = opal_dss.unpack(data, workflow_ids, &cnt, OPAL_INT))) {
             free(workflow_ids);
             return ORCM_ERROR;
         }
@@ -538,11 +455,8 @@ static int orcm_octl_analytics_wf_list_unpack_buffer(orte_rml_recv_cb_t *xfer)
 
 int orcm_octl_analytics_workflow_list(char **value)
 {
-    orte_rml_recv_cb_t *xfer = NULL;
     opal_buffer_t *buf;
-    orte_process_name_t wf_agg;
     char **nodelist=NULL;
-    int node_index;
     int rc;
 
     rc = orcm_octl_analytics_wf_list_parse_args(value, &nodelist);
@@ -557,48 +471,13 @@ int orcm_octl_analytics_workflow_list(char **value)
         return ORCM_ERR_OUT_OF_RESOURCE;
     }
 
-    for (node_index = 0; node_index < opal_argv_count(nodelist); node_index++) {
-
-        xfer = OBJ_NEW(orte_rml_recv_cb_t);
-        if (NULL == xfer) {
-            free (nodelist);
-            OBJ_RELEASE(buf);
-            return ORCM_ERR_OUT_OF_RESOURCE;
-        }
-        orcm_octl_analytics_output_setup(xfer);
-
-        OBJ_RETAIN(buf);
-
-        if (ORCM_SUCCESS != (rc = orcm_cfgi_base_get_hostname_proc(nodelist[node_index],
-                                                                   &wf_agg))) {
-            orcm_octl_analytics_process_error(buf, xfer, nodelist);
-            return rc;
-        }
-
-        rc = orcm_octl_analytics_wf_list_pack_buffer(buf, xfer);
-        if (ORCM_SUCCESS != rc) {
-            orcm_octl_analytics_process_error(buf, xfer, nodelist);
-            return rc;
-        }
-
-        rc = orcm_octl_analytics_wf_send_buffer(&wf_agg, buf, xfer);
-        if (ORCM_SUCCESS != rc) {
-            orcm_octl_analytics_process_error(buf, xfer, nodelist);
-            return rc;
-        }
-
-        ORTE_WAIT_FOR_COMPLETION(xfer->active);
-
-        rc = orcm_octl_analytics_wf_list_unpack_buffer(xfer);
-        if (ORCM_SUCCESS != rc) {
-            orcm_octl_analytics_process_error(buf, xfer, nodelist);
-            return rc;
-        }
-
-        OBJ_RELEASE(xfer);
+    rc = orcm_octl_analytics_wf_list_pack_buffer(buf);
+    if (ORCM_SUCCESS == rc) {
+        rc = orcm_octl_analytics_wf_send_buffer(nodelist, buf,
+                                                orcm_octl_analytics_wf_list_unpack_buffer);
     }
-    orcm_octl_analytics_process_error(buf, NULL, nodelist);
-    return ORCM_SUCCESS;
+    orcm_octl_analytics_process_error(buf, nodelist);
+    return rc;
 }
 
 /* get key/value from line */
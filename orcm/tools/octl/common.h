@@ -40,6 +40,7 @@
 
 #include "orcm/runtime/runtime.h"
 #include "orcm/mca/cfgi/base/base.h"
+#include "orcm/util/fanout.h"
 #include "orcm/version.h"
 
 BEGIN_C_DECLS
@@ -80,6 +81,15 @@ int orcm_octl_query_log(int cmd, char **argv);
 int orcm_octl_query_idle(int cmd, char **argv);
 int orcm_octl_query_node(int cmd, char **argv);
 int orcm_octl_query_event(int cmd, char **argv);
+int orcm_octl_query_recent(int cmd, char **argv);
+int orcm_octl_query_aggregate(int cmd, char **argv);
+int orcm_octl_subscribe(int kind, char **argv);
+/* send one command to every node in the list through the routing tree,
+ * replies get one orcm_fanout_reply_t per node in nodelist order */
+int orcm_octl_fanout(orte_rml_tag_t tag, char **nodelist,
+                     opal_buffer_t *buf, opal_list_t *replies);
+/* list the nodes that could not run the command, returns how many */
+int orcm_octl_fanout_report(opal_list_t *replies);
 
 END_C_DECLS
 
@@ -15,11 +15,11 @@ int orcm_octl_diag_cpu(char **argv)
     orcm_diag_cmd_flag_t command = ORCM_DIAG_START_COMMAND;
     char *comp;
     opal_buffer_t *buf = NULL;
-    int rc = ORCM_SUCCESS, cnt, i, result;
+    int rc = ORCM_SUCCESS, cnt, result, failed;
     bool want_result = false;
     int numopts = 0;
-    orte_process_name_t tgt;
-    orte_rml_recv_cb_t *xfer = NULL;
+    opal_list_t replies;
+    orcm_fanout_reply_t *rep;
     char **nodelist = NULL;
 
     if (3 != opal_argv_count(argv)) {
@@ -62,57 +62,40 @@ cpu <node-list>\"\n");
     /* pack options */
     /* -- */
 
-    /* setup to receive the result */
-    xfer = OBJ_NEW(orte_rml_recv_cb_t);
-    for (i = 0; i < opal_argv_count(nodelist); i++) {
-        OBJ_RETAIN(buf);
-        OBJ_RETAIN(xfer);
-
-        xfer->active = true;
-        orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD,
-                                ORCM_RML_TAG_DIAG,
-                                ORTE_RML_NON_PERSISTENT,
-                                orte_rml_recv_callback, xfer);
-
-        fprintf(stdout, "\nORCM Executing Diag:cpu on Node:%s\n", nodelist[i]);
-        if (ORCM_SUCCESS != (rc = orcm_cfgi_base_get_hostname_proc(nodelist[i],
-                                                                   &tgt))) {
-            goto finish;
-        }
+    /* one request for the whole nodelist */
+    OBJ_CONSTRUCT(&replies, opal_list_t);
+    fprintf(stdout, "\nORCM Executing Diag:cpu on %d nodes\n",
+            opal_argv_count(nodelist));
+    if (ORCM_SUCCESS != (rc = orcm_octl_fanout(ORCM_RML_TAG_DIAG, nodelist,
+                                               buf, &replies))) {
+        OPAL_LIST_DESTRUCT(&replies);
+        goto finish;
+    }
 
-        /* send command to node daemon */
-        if (ORTE_SUCCESS !=
-            (rc = orte_rml.send_buffer_nb(&tgt, buf,
-                                          ORCM_RML_TAG_DIAG,
-                                          orte_rml_send_callback, NULL))) {
-            goto finish;
+    failed = orcm_octl_fanout_report(&replies);
+    fprintf(stdout, "\n");
+    OPAL_LIST_FOREACH(rep, &replies, orcm_fanout_reply_t) {
+        if (ORCM_SUCCESS != rep->status) {
+            continue;
         }
-
-        /* wait for status message */
-        ORTE_WAIT_FOR_COMPLETION(xfer->active);
-
-        if (want_result) {
-            /* unpack results */
+        cnt=1;
+        if (OPAL_SUCCESS == opal_dss.unpack(rep->data, &result,
+                                            &cnt, OPAL_INT) &&
+            ORCM_SUCCESS == result) {
+            fprintf(stdout, "%-20s Success\n", rep->hostname);
         } else {
-            cnt=1;
-            if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &result,
-                                                      &cnt, OPAL_INT))) {
-                goto finish;
-            }
-            if (ORCM_SUCCESS == result) {
-                fprintf(stdout, "\nSuccess\n");
-            } else {
-                fprintf(stdout, "\nFailure\n");
-            }
+            fprintf(stdout, "%-20s Failure\n", rep->hostname);
+            failed++;
         }
     }
-    goto finish;
+    OPAL_LIST_DESTRUCT(&replies);
+    if (0 < failed) {
+        rc = ORCM_ERROR;
+    }
 
 finish:
     if(buf) OBJ_RELEASE(buf);
-    if(xfer) OBJ_RELEASE(xfer);
     if(nodelist) opal_argv_free(nodelist);
-    orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_DIAG);
     return rc;
 }
 
@@ -121,11 +104,11 @@ int orcm_octl_diag_eth(char **argv)
     orcm_diag_cmd_flag_t command = ORCM_DIAG_START_COMMAND;
     char *comp;
     opal_buffer_t *buf = NULL;
-    int rc = ORCM_SUCCESS, cnt, i, result;
+    int rc = ORCM_SUCCESS, cnt, result, failed;
     bool want_result = false;
     int numopts = 0;
-    orte_process_name_t tgt;
-    orte_rml_recv_cb_t *xfer = NULL;
+    opal_list_t replies;
+    orcm_fanout_reply_t *rep;
     char **nodelist = NULL;
 
     if (3 != opal_argv_count(argv)) {
@@ -167,62 +150,40 @@ int orcm_octl_diag_eth(char **argv)
     /* pack options */
     /* -- */
 
-    /* setup to receive the result */
-    xfer = OBJ_NEW(orte_rml_recv_cb_t);
-    for (i = 0; i < opal_argv_count(nodelist); i++) {
-        OBJ_RETAIN(buf);
-        OBJ_RETAIN(xfer);
-
-        xfer->active = true;
-        orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD,
-                                ORCM_RML_TAG_DIAG,
-                                ORTE_RML_NON_PERSISTENT,
-                                orte_rml_recv_callback, xfer);
-
-        fprintf(stdout, "\nORCM Executing Diag:eth on Node:%s\n", nodelist[i]);
-        if (ORCM_SUCCESS != (rc = orcm_cfgi_base_get_hostname_proc(nodelist[i],
-                                                                   &tgt))) {
-            goto finish;
-        }
+    /* one request for the whole nodelist */
+    OBJ_CONSTRUCT(&replies, opal_list_t);
+    fprintf(stdout, "\nORCM Executing Diag:eth on %d nodes\n",
+            opal_argv_count(nodelist));
+    if (ORCM_SUCCESS != (rc = orcm_octl_fanout(ORCM_RML_TAG_DIAG, nodelist,
+                                               buf, &replies))) {
+        OPAL_LIST_DESTRUCT(&replies);
+        goto finish;
+    }
 
-        /* send command to node daemon */
-        if (ORTE_SUCCESS !=
-            (rc = orte_rml.send_buffer_nb(&tgt, buf,
-                                          ORCM_RML_TAG_DIAG,
-                                          orte_rml_send_callback, NULL))) {
-            goto finish;
+    failed = orcm_octl_fanout_report(&replies);
+    fprintf(stdout, "\n");
+    OPAL_LIST_FOREACH(rep, &replies, orcm_fanout_reply_t) {
+        if (ORCM_SUCCESS != rep->status) {
+            continue;
         }
-
-        /* wait for status message */
-        ORTE_WAIT_FOR_COMPLETION(xfer->active);
-
-        if (want_result) {
-            /* unpack results */
+        cnt=1;
+        if (OPAL_SUCCESS == opal_dss.unpack(rep->data, &result,
+                                            &cnt, OPAL_INT) &&
+            ORCM_SUCCESS == result) {
+            fprintf(stdout, "%-20s Success\n", rep->hostname);
         } else {
-            cnt=1;
-            if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &result,
-                                                      &cnt, OPAL_INT))) {
-                goto finish;
-            }
-            if (ORCM_SUCCESS == result) {
-                fprintf(stdout, "\nSuccess\n");
-            } else {
-                fprintf(stdout, "\nFailure\n");
-            }
+            fprintf(stdout, "%-20s Failure\n", rep->hostname);
+            failed++;
         }
     }
-
-    /* get the refcount correct */
-    OBJ_RELEASE(buf);
-
-    opal_argv_free(nodelist);
-    return ORCM_SUCCESS;
+    OPAL_LIST_DESTRUCT(&replies);
+    if (0 < failed) {
+        rc = ORCM_ERROR;
+    }
 
 finish:
     if(buf) OBJ_RELEASE(buf);
-    if(xfer) OBJ_RELEASE(xfer);
     if(nodelist) opal_argv_free(nodelist);
-    orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_DIAG);
     return rc;
 }
 
@@ -231,11 +192,11 @@ int orcm_octl_diag_mem(char **argv)
     orcm_diag_cmd_flag_t command = ORCM_DIAG_START_COMMAND;
     char *comp;
     opal_buffer_t *buf = NULL;
-    int rc = ORCM_SUCCESS, cnt, i, result;
+    int rc = ORCM_SUCCESS, cnt, result, failed;
     bool want_result = false;
     int numopts = 0;
-    orte_process_name_t tgt;
-    orte_rml_recv_cb_t *xfer = NULL;
+    opal_list_t replies;
+    orcm_fanout_reply_t *rep;
     char **nodelist = NULL;
 
     if (3 != opal_argv_count(argv)) {
@@ -277,56 +238,39 @@ int orcm_octl_diag_mem(char **argv)
     /* pack options */
     /* -- */
 
-    /* setup to receive the result */
-    xfer = OBJ_NEW(orte_rml_recv_cb_t);
-    for (i = 0; i < opal_argv_count(nodelist); i++) {
-        OBJ_RETAIN(buf);
-        OBJ_RETAIN(xfer);
-
-        xfer->active = true;
-        orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD,
-                                ORCM_RML_TAG_DIAG,
-                                ORTE_RML_NON_PERSISTENT,
-                                orte_rml_recv_callback, xfer);
-
-        fprintf(stdout, "\nORCM Executing Diag:mem on Node:%s\n", nodelist[i]);
-        if (ORCM_SUCCESS != (rc = orcm_cfgi_base_get_hostname_proc(nodelist[i],
-                                                                   &tgt))) {
-            goto finish;
-        }
+    /* one request for the whole nodelist */
+    OBJ_CONSTRUCT(&replies, opal_list_t);
+    fprintf(stdout, "\nORCM Executing Diag:mem on %d nodes\n",
+            opal_argv_count(nodelist));
+    if (ORCM_SUCCESS != (rc = orcm_octl_fanout(ORCM_RML_TAG_DIAG, nodelist,
+                                               buf, &replies))) {
+        OPAL_LIST_DESTRUCT(&replies);
+        goto finish;
+    }
 
-        /* send command to node daemon */
-        if (ORTE_SUCCESS !=
-            (rc = orte_rml.send_buffer_nb(&tgt, buf,
-                                          ORCM_RML_TAG_DIAG,
-                                          orte_rml_send_callback, NULL))) {
-            goto finish;
+    failed = orcm_octl_fanout_report(&replies);
+    fprintf(stdout, "\n");
+    OPAL_LIST_FOREACH(rep, &replies, orcm_fanout_reply_t) {
+        if (ORCM_SUCCESS != rep->status) {
+            continue;
         }
-
-        /* wait for status message */
-        ORTE_WAIT_FOR_COMPLETION(xfer->active);
-
-        if (want_result) {
-            /* unpack results */
+        cnt=1;
+        if (OPAL_SUCCESS == opal_dss.unpack(rep->data, &result,
+                                            &cnt, OPAL_INT) &&
+            ORCM_SUCCESS == result) {
+            fprintf(stdout, "%-20s Success\n", rep->hostname);
         } else {
-            cnt=1;
-            if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &result,
-                                                      &cnt, OPAL_INT))) {
-                goto finish;
-            }
-            if (ORCM_SUCCESS == result) {
-                fprintf(stdout, "\nSuccess\n");
-            } else {
-                fprintf(stdout, "\nFailure\n");
-            }
+            fprintf(stdout, "%-20s Failure\n", rep->hostname);
+            failed++;
         }
     }
-    goto finish;
+    OPAL_LIST_DESTRUCT(&replies);
+    if (0 < failed) {
+        rc = ORCM_ERROR;
+    }
 
 finish:
     if(buf) OBJ_RELEASE(buf);
-    if(xfer) OBJ_RELEASE(xfer);
     if(nodelist) opal_argv_free(nodelist);
-    orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_DIAG);
     return rc;
 }
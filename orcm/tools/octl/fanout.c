@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2016      Intel, Inc.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orcm/tools/octl/common.h"
+
+int orcm_octl_fanout(orte_rml_tag_t tag, char **nodelist,
+                     opal_buffer_t *buf, opal_list_t *replies)
+{
+    orte_process_name_t *targets;
+    bool *resolved;
+    opal_list_t sent;
+    orcm_fanout_reply_t *rep;
+    int32_t num_targets = 0;
+    int i, count, rc = ORCM_SUCCESS;
+
+    count = opal_argv_count(nodelist);
+    if (0 == count) {
+        return ORCM_ERR_BAD_PARAM;
+    }
+    targets = (orte_process_name_t*)malloc(count * sizeof(orte_process_name_t));
+    resolved = (bool*)malloc(count * sizeof(bool));
+    if (NULL == targets || NULL == resolved) {
+        free(targets);
+        free(resolved);
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    for (i = 0; i < count; i++) {
+        resolved[i] = (ORCM_SUCCESS ==
+                       orcm_cfgi_base_get_hostname_proc(nodelist[i], &targets[num_targets]));
+        if (resolved[i]) {
+            num_targets++;
+        }
+    }
+
+    OBJ_CONSTRUCT(&sent, opal_list_t);
+    if (0 < num_targets) {
+        rc = orcm_fanout_send(tag, targets, num_targets, buf,
+                              ORCM_FANOUT_DEFAULT_TIMEOUT, &sent);
+    }
+    if (ORCM_SUCCESS == rc) {
+        /* the answers come back in the order sent - slot the
+         * nodes we could not name back in between them */
+        for (i = 0; i < count; i++) {
+            if (resolved[i]) {
+                rep = (orcm_fanout_reply_t*)opal_list_remove_first(&sent);
+            } else {
+                rep = OBJ_NEW(orcm_fanout_reply_t);
+                rep->status = ORCM_ERR_NOT_FOUND;
+            }
+            rep->hostname = strdup(nodelist[i]);
+            opal_list_append(replies, &rep->super);
+        }
+    }
+    OPAL_LIST_DESTRUCT(&sent);
+    free(targets);
+    free(resolved);
+    return rc;
+}
+
+int orcm_octl_fanout_report(opal_list_t *replies)
+{
+    orcm_fanout_reply_t *rep;
+    const char *reason;
+    int failed = 0;
+
+    OPAL_LIST_FOREACH(rep, replies, orcm_fanout_reply_t) {
+        if (ORCM_SUCCESS == rep->status) {
+            continue;
+        }
+        if (0 == failed++) {
+            printf("\nNode                 Failure\n");
+            printf("------------------------------------------------------------------------------\n");
+        }
+        switch (rep->status) {
+        case ORCM_ERR_NOT_FOUND:
+            reason = "unknown node";
+            break;
+        case ORCM_ERR_UNREACH:
+            reason = "no route to node";
+            break;
+        case ORCM_ERR_TIMEOUT:
+            reason = "no answer before the timeout";
+            break;
+        case ORCM_ERR_NOT_SUPPORTED:
+            reason = "service not running on node";
+            break;
+        default:
+            reason = ORTE_ERROR_NAME(rep->status);
+            break;
+        }
+        printf("%-20s %s\n", rep->hostname, reason);
+    }
+    if (0 < failed) {
+        printf("\n%d of %d nodes could not run the command\n",
+               failed, (int)opal_list_get_size(replies));
+    }
+    return failed;
+}
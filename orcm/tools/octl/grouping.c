@@ -82,7 +82,7 @@ static int orcm_octl_logical_group_print_list(opal_hash_table_t *groups)
 {
     char *key = NULL;
     size_t key_size = 0;
-    opal_list_t *value = NULL;
+    orcm_logical_group_members_t *value = NULL;
     opal_list_t *new_value = NULL;
     void *in_member = NULL;
     void *o_member = NULL;
@@ -131,9 +131,6 @@ int orcm_octl_logical_group_list(int argc, char **argv)
     erri = orcm_octl_logical_group_print_list(o_groups);
 
 cleanup:
-    if (o_groups != LOGICAL_GROUP.groups && NULL != o_groups) {
-        opal_hash_table_remove_all(o_groups);
-        OBJ_RELEASE(o_groups);
-    }
+    orcm_logical_group_list_release(o_groups, LOGICAL_GROUP.groups);
     return erri;
 }
@@ -10,6 +10,7 @@
 #include "orcm/tools/octl/common.h"
 #include "orcm/tools/octl/octl.h"
 #include "orcm/util/logical_group.h"
+#include "orcm/util/pubsub.h"
 
 /***
 Remove 'implicit' warnings...
@@ -667,6 +668,31 @@ static int run_cmd(char *cmd)
         case 43://event
             rc = orcm_octl_query_event(ORCM_GET_DB_QUERY_EVENT_COMMAND,cmdlist);
             break;
+        case 45://recent
+            rc = orcm_octl_query_recent(ORCM_GET_RECENT_SENSOR_COMMAND,cmdlist);
+            break;
+        case 46://aggregate
+            rc = orcm_octl_query_aggregate(ORCM_GET_DB_QUERY_AGGREGATE_COMMAND,cmdlist);
+            break;
+        default:
+            rc = ORCM_ERROR;
+            break;
+        }
+        break;
+    case 44: //Subscribe
+        rc = octl_command_to_int(cmdlist[1]);
+        if (-1 == rc) {
+            rc = ORCM_ERROR;
+            break;
+        }
+        switch(rc)
+        {
+        case 30://sensor
+            rc = orcm_octl_subscribe(ORCM_PUBSUB_KIND_SAMPLE,cmdlist);
+            break;
+        case 43://event
+            rc = orcm_octl_subscribe(ORCM_PUBSUB_KIND_EVENT,cmdlist);
+            break;
         default:
             rc = ORCM_ERROR;
             break;
@@ -192,6 +192,13 @@ static orcm_cli_init_t cli_init[] = {
     { { "query", NULL}, "node", 0, 1, "query ras information of the given nodes" },
     { { "query", "node", NULL}, "status", 0, 1, "query status of given nodes" },
     { { "query", NULL}, "event", 0, 1, "query events from database" },
+    { { "query", NULL}, "recent", 0, 3, "query the latest sensor values held in aggregator memory" },
+    { { "query", NULL}, "aggregate", 0, 9, "query sensor values reduced per node/sensor/time bucket by the database" },
+
+    /****** Subscribe commands ******/
+    { { NULL}, "subscribe", 0, 0, "Stream live data as it is collected" },
+    { { "subscribe", NULL}, "sensor", 0, 4, "stream sensor samples of the given nodes for a number of seconds" },
+    { { "subscribe", NULL}, "event", 0, 2, "stream RAS events of the given nodes for a number of seconds" },
 
 
     /* quit command */
@@ -250,6 +257,9 @@ const char *orcm_octl_commands[] = { "resource",          //0
                                      "idle",              //41
                                      "node",              //42
                                      "event",             //43
+                                     "subscribe",         //44
+                                     "recent",            //45
+                                     "aggregate",         //46
                                      "\0" };
 
 END_C_DECLS
@@ -18,6 +18,8 @@
 #define DEFAULT_IDLE_TIME "10"
 
 int query_db(int cmd, opal_list_t *filterlist, opal_list_t** results);
+int query_fetch(opal_buffer_t *buffer, opal_list_t** results);
+int query_pack_filters(opal_buffer_t *buffer, int cmd, opal_list_t *filterlist);
 int get_nodes_from_args(char **argv, char ***node_list);
 opal_list_t *create_query_sensor_filter(int argc, char **argv);
 opal_list_t *create_query_idle_filter(int argc, char **argv);
@@ -48,44 +50,64 @@ double stopwatch(void)
 
 int query_db(int cmd, opal_list_t *filterlist, opal_list_t** results)
 {
-    int n = 1;
+    int rc = -1;
+    opal_buffer_t *buffer = NULL;
+
+    if (NULL == filterlist || NULL == results){
+        return ORCM_ERR_BAD_PARAM;
+    }
+    buffer = OBJ_NEW(opal_buffer_t);
+    if (ORCM_SUCCESS != (rc = query_pack_filters(buffer, cmd, filterlist))) {
+        OBJ_RELEASE(buffer);
+        return rc;
+    }
+    return query_fetch(buffer, results);
+}
+
+/* command followed by the filters, as build_filter_list() expects them */
+int query_pack_filters(opal_buffer_t *buffer, int cmd, opal_list_t *filterlist)
+{
     int rc = -1;
     orcm_rm_cmd_flag_t command = (orcm_rm_cmd_flag_t)cmd;
     orcm_db_filter_t *tmp_filter = NULL;
-    opal_buffer_t *buffer = OBJ_NEW(opal_buffer_t);
-    orte_rml_recv_cb_t *xfer = NULL;
     uint16_t filterlist_count = 0;
-    uint16_t results_count = 0;
-    int returned_status = 0;
 
-    if (NULL == filterlist || NULL == results){
-        rc = ORCM_ERR_BAD_PARAM;
-        goto query_db_cleanup;
-    }
     filterlist_count = (uint16_t)opal_list_get_size(filterlist);
     if (OPAL_SUCCESS != (rc = opal_dss.pack(buffer, &command, 1, ORCM_RM_CMD_T))) {
         ORTE_ERROR_LOG(rc);
-        goto query_db_cleanup;
-                        }
+        return rc;
+    }
     if (OPAL_SUCCESS != (rc = opal_dss.pack(buffer, &filterlist_count, 1, OPAL_UINT16))) {
         ORTE_ERROR_LOG(rc);
-        goto query_db_cleanup;
+        return rc;
     }
     OPAL_LIST_FOREACH(tmp_filter, filterlist, orcm_db_filter_t) {
         uint8_t operation = (uint8_t)tmp_filter->op;
         if (OPAL_SUCCESS != (rc = opal_dss.pack(buffer, &tmp_filter->value.key, 1, OPAL_STRING))) {
             ORTE_ERROR_LOG(rc);
-            goto query_db_cleanup;
+            return rc;
         }
         if (OPAL_SUCCESS != (rc = opal_dss.pack(buffer, &operation, 1, OPAL_UINT8))) {
             ORTE_ERROR_LOG(rc);
-            goto query_db_cleanup;
+            return rc;
         }
         if (OPAL_SUCCESS != (rc = opal_dss.pack(buffer, &tmp_filter->value.data.string, 1, OPAL_STRING))) {
             ORTE_ERROR_LOG(rc);
-            goto query_db_cleanup;
+            return rc;
         }
     }
+    return ORCM_SUCCESS;
+}
+
+/* send a packed query to the scheduler and collect the rows it returns */
+int query_fetch(opal_buffer_t *buffer, opal_list_t** results)
+{
+    int n = 1;
+    int rc = -1;
+    orte_rml_recv_cb_t *xfer = NULL;
+    uint16_t results_count = 0;
+    int returned_status = 0;
+
     xfer = OBJ_NEW(orte_rml_recv_cb_t);
     xfer->active = true;
     orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD, ORCM_RML_TAG_ORCMD_FETCH, ORTE_RML_NON_PERSISTENT,
@@ -95,17 +117,18 @@ int query_db(int cmd, opal_list_t *filterlist, opal_list_t** results)
                                                       ORCM_RML_TAG_ORCMD_FETCH,
                                                       orte_rml_send_callback, xfer))) {
         ORTE_ERROR_LOG(rc);
-        goto query_db_cleanup;
+        OBJ_RELEASE(buffer);
+        goto query_fetch_cleanup;
     }
     /* wait for status message */
     ORTE_WAIT_FOR_COMPLETION(xfer->active);
 
     if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &returned_status, &n, OPAL_INT))) {
-        goto query_db_cleanup;
+        goto query_fetch_cleanup;
     }
     if(0 == returned_status) {
         if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &results_count, &n, OPAL_UINT16))) {
-            goto query_db_cleanup;
+            goto query_fetch_cleanup;
         }
         (*results) = OBJ_NEW(opal_list_t);
         for(uint16_t i = 0; i < results_count; ++i) {
@@ -113,7 +136,7 @@ int query_db(int cmd, opal_list_t *filterlist, opal_list_t** results)
             opal_value_t *tmp_value = NULL;
             n = 1;
             if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &tmp_str, &n, OPAL_STRING))) {
-                goto query_db_cleanup;
+                goto query_fetch_cleanup;
             }
             tmp_value = OBJ_NEW(opal_value_t);
             tmp_value->type = OPAL_STRING;
@@ -125,7 +148,7 @@ int query_db(int cmd, opal_list_t *filterlist, opal_list_t** results)
         rc = ORCM_SUCCESS;
         *results = NULL;
     }
-query_db_cleanup:
+query_fetch_cleanup:
     SAFE_RELEASE(xfer);
     return rc;
 }
@@ -839,3 +862,217 @@ orcm_octl_query_event_exit:
     opal_argv_free(argv_node_list);
     return rc;
 }
+
+/* query recent <sensor-name> [minutes] <nodelist>
+ * answered by the aggregators from memory rather than the database */
+int orcm_octl_query_recent(int cmd, char **argv)
+{
+    int rc = ORCM_SUCCESS;
+    int argc = opal_argv_count(argv);
+    orcm_rm_cmd_flag_t command = (orcm_rm_cmd_flag_t)cmd;
+    uint16_t rows_retrieved = 0;
+    char **argv_node_list = NULL;
+    char *sensor = NULL;
+    int32_t seconds = 0;
+    int32_t num_nodes = 0;
+    double start_time = 0.0;
+    double stop_time = 0.0;
+    opal_buffer_t *buffer = NULL;
+    opal_list_t *returned_list = NULL;
+    opal_value_t *line = NULL;
+
+    if (ORCM_GET_RECENT_SENSOR_COMMAND != cmd || (4 != argc && 5 != argc)) {
+        show_query_error_message("octl:query:recent");
+        return ORCM_ERR_BAD_PARAM;
+    }
+    if (5 == argc) {
+        seconds = (int32_t)strtol(argv[3], NULL, 10) * 60;
+        if (0 >= seconds) {
+            show_query_error_message("octl:query:recent");
+            return ORCM_ERR_BAD_PARAM;
+        }
+    }
+    if (ORCM_SUCCESS != get_nodes_from_args(argv, &argv_node_list)){
+        rc = ORCM_ERR_BAD_PARAM;
+        goto orcm_octl_query_recent_cleanup;
+    }
+    /* a wildcard anywhere in the node list means every node */
+    for (int i = 0; NULL != argv_node_list[i]; ++i) {
+        if (NULL != strchr(argv_node_list[i], '*')) {
+            opal_argv_free(argv_node_list);
+            argv_node_list = NULL;
+            break;
+        }
+    }
+    num_nodes = opal_argv_count(argv_node_list);
+    sensor = argv[2];
+
+    buffer = OBJ_NEW(opal_buffer_t);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(buffer, &command, 1, ORCM_RM_CMD_T)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(buffer, &sensor, 1, OPAL_STRING)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(buffer, &seconds, 1, OPAL_INT32)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(buffer, &num_nodes, 1, OPAL_INT32))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(buffer);
+        goto orcm_octl_query_recent_cleanup;
+    }
+    for (int i = 0; i < num_nodes; ++i) {
+        if (OPAL_SUCCESS != (rc = opal_dss.pack(buffer, &argv_node_list[i], 1, OPAL_STRING))) {
+            ORTE_ERROR_LOG(rc);
+            OBJ_RELEASE(buffer);
+            goto orcm_octl_query_recent_cleanup;
+        }
+    }
+
+    start_time = stopwatch();
+    rc = query_fetch(buffer, &returned_list);
+    stop_time = stopwatch();
+    if(rc != ORCM_SUCCESS) {
+        fprintf(stdout, "\nNo results found!\n");
+    } else if(NULL != returned_list) {
+        rows_retrieved = (uint16_t)opal_list_get_size(returned_list);
+        /* Actual number includes the header so we remove it*/
+        rows_retrieved--;
+        printf("\n");
+        OPAL_LIST_FOREACH(line, returned_list, opal_value_t) {
+            printf("%s\n", line->data.string);
+        }
+        OBJ_RELEASE(returned_list);
+        printf("\n%u rows were found (%0.3f seconds)\n", rows_retrieved, stop_time-start_time);
+    }
+
+orcm_octl_query_recent_cleanup:
+    opal_argv_free(argv_node_list);
+    return rc;
+}
+
+static int parse_aggregate_function(char *arg, uint8_t *function, double *percentile)
+{
+    char *end = NULL;
+
+    if (0 == strcasecmp(arg, "min")) {
+        *function = ORCM_DB_AGG_MIN;
+    } else if (0 == strcasecmp(arg, "max")) {
+        *function = ORCM_DB_AGG_MAX;
+    } else if (0 == strcasecmp(arg, "avg")) {
+        *function = ORCM_DB_AGG_AVG;
+    } else if (0 == strcasecmp(arg, "count")) {
+        *function = ORCM_DB_AGG_COUNT;
+    } else if ('p' == arg[0] || 'P' == arg[0]) {
+        /* pNN is the NNth percentile */
+        *function = ORCM_DB_AGG_PERCENTILE;
+        *percentile = strtod(&arg[1], &end) / 100.0;
+        if (end == &arg[1] || '\0' != *end || 0.0 > *percentile || 1.0 < *percentile) {
+            return ORCM_ERR_BAD_PARAM;
+        }
+    } else {
+        return ORCM_ERR_BAD_PARAM;
+    }
+    return ORCM_SUCCESS;
+}
+
+static int parse_aggregate_grouping(char *arg, uint8_t *group_by)
+{
+    char **groups = NULL;
+    int rc = ORCM_SUCCESS;
+
+    *group_by = 0;
+    if (0 == strcasecmp(arg, "none")) {
+        return ORCM_SUCCESS;
+    }
+    groups = opal_argv_split(arg, ',');
+    for (int i = 0; NULL != groups && NULL != groups[i]; ++i) {
+        if (0 == strcasecmp(groups[i], "node")) {
+            *group_by |= ORCM_DB_QUERY_GROUP_BY_NODE;
+        } else if (0 == strcasecmp(groups[i], "sensor")) {
+            *group_by |= ORCM_DB_QUERY_GROUP_BY_SENSOR;
+        } else {
+            rc = ORCM_ERR_BAD_PARAM;
+        }
+    }
+    opal_argv_free(groups);
+    return rc;
+}
+
+/* query aggregate <function> <bucket-minutes> <grouping> <sensor-name>
+ *                 <start-date> <start-time> <end-date> <end-time> <nodelist>
+ * the database groups the samples, so only one row per group is returned */
+int orcm_octl_query_aggregate(int cmd, char **argv)
+{
+    int rc = ORCM_SUCCESS;
+    int argc = opal_argv_count(argv);
+    uint16_t rows_retrieved = 0;
+    char **argv_node_list = NULL;
+    uint8_t function = 0;
+    uint8_t group_by = 0;
+    uint32_t interval = 0;
+    long minutes = 0;
+    double percentile = 0.0;
+    double start_time = 0.0;
+    double stop_time = 0.0;
+    char *end = NULL;
+    opal_buffer_t *buffer = NULL;
+    opal_list_t *filter_list = NULL;
+    opal_list_t *returned_list = NULL;
+    opal_value_t *line = NULL;
+    orcm_db_filter_t *nodes_item = NULL;
+
+    if (ORCM_GET_DB_QUERY_AGGREGATE_COMMAND != cmd || 11 != argc) {
+        show_query_error_message("octl:query:aggregate");
+        return ORCM_ERR_BAD_PARAM;
+    }
+    minutes = strtol(argv[3], &end, 10);
+    if (ORCM_SUCCESS != parse_aggregate_function(argv[2], &function, &percentile) ||
+        '\0' != *end || 0 > minutes || UINT32_MAX / 60 < (unsigned long)minutes ||
+        ORCM_SUCCESS != parse_aggregate_grouping(argv[4], &group_by)) {
+        show_query_error_message("octl:query:aggregate");
+        return ORCM_ERR_BAD_PARAM;
+    }
+    interval = (uint32_t)minutes * 60;
+
+    if (ORCM_SUCCESS != get_nodes_from_args(argv, &argv_node_list)){
+        rc = ORCM_ERR_BAD_PARAM;
+        goto orcm_octl_query_aggregate_cleanup;
+    }
+    /* the remaining arguments are those of "query sensor" */
+    if (NULL == (filter_list = create_query_sensor_filter(8, &argv[3]))) {
+        rc = ORCM_ERR_BAD_PARAM;
+        goto orcm_octl_query_aggregate_cleanup;
+    }
+    if (NULL != (nodes_item = build_node_item(argv_node_list))){
+        opal_list_append(filter_list, &nodes_item->value.super);
+    }
+
+    buffer = OBJ_NEW(opal_buffer_t);
+    if (ORCM_SUCCESS != (rc = query_pack_filters(buffer, cmd, filter_list)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(buffer, &function, 1, OPAL_UINT8)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(buffer, &percentile, 1, OPAL_DOUBLE)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(buffer, &interval, 1, OPAL_UINT32)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(buffer, &group_by, 1, OPAL_UINT8))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(buffer);
+        goto orcm_octl_query_aggregate_cleanup;
+    }
+
+    start_time = stopwatch();
+    rc = query_fetch(buffer, &returned_list);
+    stop_time = stopwatch();
+    if(rc != ORCM_SUCCESS) {
+        fprintf(stdout, "\nNo results found!\n");
+    } else if(NULL != returned_list) {
+        rows_retrieved = (uint16_t)opal_list_get_size(returned_list);
+        /* Actual number includes the header so we remove it*/
+        rows_retrieved--;
+        printf("\n");
+        OPAL_LIST_FOREACH(line, returned_list, opal_value_t) {
+            printf("%s\n", line->data.string);
+        }
+        OBJ_RELEASE(returned_list);
+        printf("\n%u rows were found (%0.3f seconds)\n", rows_retrieved, stop_time-start_time);
+    }
+
+orcm_octl_query_aggregate_cleanup:
+    SAFE_RELEASE(filter_list);
+    opal_argv_free(argv_node_list);
+    return rc;
+}
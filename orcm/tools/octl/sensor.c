@@ -29,8 +29,8 @@ int orcm_octl_sensor_policy_get(int cmd, char **argv)
     int rc = ORCM_SUCCESS;
     int cnt, i;
     int num = 0;
-    orte_process_name_t tgt;
-    orte_rml_recv_cb_t *xfer = NULL;
+    opal_list_t replies;
+    orcm_fanout_reply_t *rep;
     char **nodelist = NULL;
     char *sensor_name = NULL;
     char *sev = NULL;
@@ -51,6 +51,7 @@ int orcm_octl_sensor_policy_get(int cmd, char **argv)
                        true, error, ORTE_ERROR_NAME(rc), rc);
         return rc;
     }
+    OBJ_CONSTRUCT(&replies, opal_list_t);
 
     /* setup the receiver nodelist */
     orcm_logical_group_parse_array_string(argv[3], &nodelist);
@@ -81,55 +82,35 @@ int orcm_octl_sensor_policy_get(int cmd, char **argv)
         goto done;
     }
 
-    /* Loop through the nodelist to set sensor policy */
-    xfer = OBJ_NEW(orte_rml_recv_cb_t);
-    for (i = 0; i < opal_argv_count(nodelist); i++) {
-        OBJ_RETAIN(buf);
-        OBJ_RETAIN(xfer);
-
-        xfer->active = true;
-        orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD,
-                            ORCM_RML_TAG_SENSOR,
-                            ORTE_RML_NON_PERSISTENT,
-                            orte_rml_recv_callback, xfer);
-
-        printf("\nORCM getting sensor policy from Node:%s\n", nodelist[i]);
-        if (ORCM_SUCCESS != (rc = orcm_cfgi_base_get_hostname_proc(nodelist[i],
-                                                                   &tgt))) {
-            error = "incorrect node name";
-            goto done;
-        }
+    /* one request for the whole nodelist */
+    if (ORCM_SUCCESS != (rc = orcm_octl_fanout(ORCM_RML_TAG_SENSOR, nodelist,
+                                               buf, &replies))) {
+        error = "scheduler contact failed";
+        goto done;
+    }
 
-        /* send command to node daemon */
-        if (ORTE_SUCCESS !=
-            (rc = orte_rml.send_buffer_nb(&tgt, buf,
-                                          ORCM_RML_TAG_SENSOR,
-                                          orte_rml_send_callback, NULL))) {
-            error = "daemon contact failed";
-            goto done;
+    OPAL_LIST_FOREACH(rep, &replies, orcm_fanout_reply_t) {
+        if (ORCM_SUCCESS != rep->status) {
+            continue;
         }
-
-        /* wait for status message */
-        ORTE_WAIT_FOR_COMPLETION(xfer->active);
+        printf("\nORCM sensor policy on Node:%s\n", rep->hostname);
 
         cnt=1;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &num,
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(rep->data, &num,
                                                   &cnt, OPAL_INT))) {
             error = UNPACKERR;
             goto done;
         }
 
         if ( 0 == num ) {
-            rc = ORCM_SUCCESS;
             printf("\nThere is no active policy!\n");
-            goto done;
         } else {
              printf("\nSensor      Threshold        Hi/Lo    Max_Count/Time_Window    Severity      Action\n");
              printf("-----------------------------------------------------------------------------------\n");
             for (i = 0; i < num; i++) {
                 /* unpack sensor name */
                 cnt = 1;
-                if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &sensor_name,
+                if (OPAL_SUCCESS != (rc = opal_dss.unpack(rep->data, &sensor_name,
                                                   &cnt, OPAL_STRING))) {
                     error = UNPACKERR;
                     goto done;
@@ -137,7 +118,7 @@ int orcm_octl_sensor_policy_get(int cmd, char **argv)
 
                 /* unpack threshold */
                 cnt = 1;
-                if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &threshold,
+                if (OPAL_SUCCESS != (rc = opal_dss.unpack(rep->data, &threshold,
                                                   &cnt, OPAL_FLOAT))) {
                     error = UNPACKERR;
                     goto done;
@@ -145,7 +126,7 @@ int orcm_octl_sensor_policy_get(int cmd, char **argv)
 
                 /* unpack threshold type */
                 cnt = 1;
-                if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &hi_thres,
+                if (OPAL_SUCCESS != (rc = opal_dss.unpack(rep->data, &hi_thres,
                                                   &cnt, OPAL_BOOL))) {
                     error = UNPACKERR;
                     goto done;
@@ -153,7 +134,7 @@ int orcm_octl_sensor_policy_get(int cmd, char **argv)
 
                 /* unpack max count */
                 cnt = 1;
-                if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &max_count,
+                if (OPAL_SUCCESS != (rc = opal_dss.unpack(rep->data, &max_count,
                                                   &cnt, OPAL_INT))) {
                     error = UNPACKERR;
                     goto done;
@@ -161,7 +142,7 @@ int orcm_octl_sensor_policy_get(int cmd, char **argv)
 
                 /* unpack time window */
                 cnt = 1;
-                if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &time_window,
+                if (OPAL_SUCCESS != (rc = opal_dss.unpack(rep->data, &time_window,
                                                   &cnt, OPAL_INT))) {
                     error = UNPACKERR;
                     goto done;
@@ -169,7 +150,7 @@ int orcm_octl_sensor_policy_get(int cmd, char **argv)
 
                 /* unpack severity */
                 cnt = 1;
-                if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &severity,
+                if (OPAL_SUCCESS != (rc = opal_dss.unpack(rep->data, &severity,
                                                   &cnt, OPAL_INT))) {
                     error = UNPACKERR;
                     goto done;
@@ -177,7 +158,7 @@ int orcm_octl_sensor_policy_get(int cmd, char **argv)
 
                 /* unpack action */
                 cnt = 1;
-                if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &action,
+                if (OPAL_SUCCESS != (rc = opal_dss.unpack(rep->data, &action,
                                                   &cnt, OPAL_STRING))) {
                     error = UNPACKERR;
                     goto done;
@@ -231,17 +212,21 @@ int orcm_octl_sensor_policy_get(int cmd, char **argv)
                 }
                 SAFEFREE(threstype);
                 SAFEFREE(sev);
+                SAFEFREE(sensor_name);
+                SAFEFREE(action);
             }
         }
     }
+    if (0 < orcm_octl_fanout_report(&replies)) {
+        error = "command failed on some nodes";
+        rc = ORCM_ERROR;
+    }
 
 done:
     if (buf) {
         OBJ_RELEASE(buf);
     }
-    if (xfer) {
-        OBJ_RELEASE(xfer);
-    }
+    OPAL_LIST_DESTRUCT(&replies);
     if (nodelist) {
         opal_argv_free(nodelist);
     }
@@ -250,8 +235,6 @@ done:
     SAFEFREE(action);
     SAFEFREE(sensor_name);
 
-    orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_SENSOR);
-
     if (ORCM_SUCCESS != rc) {
         orte_show_help("help-octl.txt",
                        TAG, true, error, ORTE_ERROR_NAME(rc), rc);
@@ -261,15 +244,41 @@ done:
 }
 
 
+/* print what one node made of a set command */
+static int print_set_result(orcm_fanout_reply_t *rep)
+{
+    int result, cnt, rc;
+    char *error = NULL;
+
+    cnt = 1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(rep->data, &result,
+                                              &cnt, OPAL_INT))) {
+        printf("%-20s %s\n", rep->hostname, UNPACKERR);
+        return rc;
+    }
+    if (ORCM_SUCCESS == result) {
+        printf("%-20s Success\n", rep->hostname);
+        return ORCM_SUCCESS;
+    }
+    cnt = 1;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(rep->data, &error,
+                                              &cnt, OPAL_STRING))) {
+        printf("%-20s %s\n", rep->hostname, UNPACKERR);
+        return rc;
+    }
+    printf("%-20s %s\n", rep->hostname, error);
+    free(error);
+    return result;
+}
+
 int orcm_octl_sensor_policy_set(int cmd, char **argv)
 {
     orcm_sensor_cmd_flag_t command;
     opal_buffer_t *buf = NULL;
-    int cnt, i;
     int rc = ORCM_SUCCESS;
-    int result = ORCM_SUCCESS;
-    orte_process_name_t tgt;
-    orte_rml_recv_cb_t *xfer = NULL;
+    int failed;
+    opal_list_t replies;
+    orcm_fanout_reply_t *rep;
     char **nodelist = NULL;
     float threshold;
     bool hi_thres;
@@ -285,6 +294,7 @@ int orcm_octl_sensor_policy_set(int cmd, char **argv)
                        true, error, ORTE_ERROR_NAME(rc), rc);
         return rc;
     }
+    OBJ_CONSTRUCT(&replies, opal_list_t);
 
     /* setup the receiver nodelist */
     orcm_logical_group_parse_array_string(argv[3], &nodelist);
@@ -409,67 +419,34 @@ int orcm_octl_sensor_policy_set(int cmd, char **argv)
         goto done;
     }
 
-    /* Loop through the nodelist to set sensor policy */
-    xfer = OBJ_NEW(orte_rml_recv_cb_t);
-    for (i = 0; i < opal_argv_count(nodelist); i++) {
-        OBJ_RETAIN(buf);
-        OBJ_RETAIN(xfer);
-
-        xfer->active = true;
-        orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD,
-                            ORCM_RML_TAG_SENSOR,
-                            ORTE_RML_NON_PERSISTENT,
-                            orte_rml_recv_callback, xfer);
-
-        printf("\nORCM setting sensor policy on Node:%s\n", nodelist[i]);
-        if (ORCM_SUCCESS != (rc = orcm_cfgi_base_get_hostname_proc(nodelist[i],
-                                                                   &tgt))) {
-            error = "incorrect node name";
-            goto done;
-        }
-
-        /* send command to node daemon */
-        if (ORTE_SUCCESS !=
-            (rc = orte_rml.send_buffer_nb(&tgt, buf,
-                                          ORCM_RML_TAG_SENSOR,
-                                          orte_rml_send_callback, NULL))) {
-            error = "daemon contact failed";
-            goto done;
-        }
-
-        /* wait for status message */
-        ORTE_WAIT_FOR_COMPLETION(xfer->active);
+    /* one request for the whole nodelist */
+    if (ORCM_SUCCESS != (rc = orcm_octl_fanout(ORCM_RML_TAG_SENSOR, nodelist,
+                                               buf, &replies))) {
+        error = "scheduler contact failed";
+        goto done;
+    }
 
-        cnt=1;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &result,
-                                                  &cnt, OPAL_INT))) {
-            error = UNPACKERR;
-            goto done;
-        }
-        if (ORCM_SUCCESS == result) {
-            printf("\nSuccess\n");
-        } else {
-            if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &error,
-                                                 &cnt, OPAL_STRING))) {
-                error = UNPACKERR;
-                goto done;
-            }
-            rc = result;
-            goto done;
+    failed = orcm_octl_fanout_report(&replies);
+    printf("\n");
+    OPAL_LIST_FOREACH(rep, &replies, orcm_fanout_reply_t) {
+        if (ORCM_SUCCESS == rep->status &&
+            ORCM_SUCCESS != print_set_result(rep)) {
+            failed++;
         }
     }
+    if (0 < failed) {
+        error = "command failed on some nodes";
+        rc = ORCM_ERROR;
+    }
 
 done:
     if (buf) {
         OBJ_RELEASE(buf);
     }
-    if (xfer) {
-        OBJ_RELEASE(xfer);
-    }
+    OPAL_LIST_DESTRUCT(&replies);
     if (nodelist) {
         opal_argv_free(nodelist);
     }
-    orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_SENSOR);
     if (ORCM_SUCCESS != rc) {
         orte_show_help("help-octl.txt",
                        TAG,
@@ -483,11 +460,10 @@ int orcm_octl_sensor_sample_rate_set(int cmd, char **argv)
     orcm_sensor_cmd_flag_t command;
     int sample_rate = 0;
     opal_buffer_t *buf = NULL;
-    int cnt, i;
     int rc = ORCM_SUCCESS;
-    int result = ORCM_SUCCESS;
-    orte_process_name_t tgt;
-    orte_rml_recv_cb_t *xfer = NULL;
+    int failed;
+    opal_list_t replies;
+    orcm_fanout_reply_t *rep;
     char **nodelist = NULL;
     char *error = NULL;
 
@@ -499,6 +475,7 @@ int orcm_octl_sensor_sample_rate_set(int cmd, char **argv)
                        true, error, ORTE_ERROR_NAME(rc), rc);
         return rc;
     }
+    OBJ_CONSTRUCT(&replies, opal_list_t);
 
     if (isdigit(argv[4][strlen(argv[4]) - 1])) {
         sample_rate = (int)strtol(argv[4], NULL, 10);
@@ -547,67 +524,34 @@ int orcm_octl_sensor_sample_rate_set(int cmd, char **argv)
         goto done;
     }
 
-    xfer = OBJ_NEW(orte_rml_recv_cb_t);
-    /* Loop through the nodelist and set the sample rate */
-    for (i = 0; i < opal_argv_count(nodelist); i++) {
-        OBJ_RETAIN(buf);
-        OBJ_RETAIN(xfer);
-        /* setup to receive the rc */
-        xfer->active = true;
-        orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD,
-                                ORCM_RML_TAG_SENSOR,
-                                ORTE_RML_NON_PERSISTENT,
-                                orte_rml_recv_callback, xfer);
-
-        printf("\nORCM setting sensor:%s sample-rate on node:%s\n", argv[3], nodelist[i]);
-        if (ORCM_SUCCESS != (rc = orcm_cfgi_base_get_hostname_proc(nodelist[i],
-                                                                   &tgt))) {
-            error = "incorrect node name";
-            goto done;
-        }
+    /* one request for the whole nodelist */
+    if (ORCM_SUCCESS != (rc = orcm_octl_fanout(ORCM_RML_TAG_SENSOR, nodelist,
+                                               buf, &replies))) {
+        error = "scheduler contact failed";
+        goto done;
+    }
 
-        /* send command to node daemon */
-        if (ORTE_SUCCESS !=
-            (rc = orte_rml.send_buffer_nb(&tgt, buf,
-                                          ORCM_RML_TAG_SENSOR,
-                                          orte_rml_send_callback, NULL))) {
-            error = "daemon contact failed";
-            goto done;
+    failed = orcm_octl_fanout_report(&replies);
+    printf("\n");
+    OPAL_LIST_FOREACH(rep, &replies, orcm_fanout_reply_t) {
+        if (ORCM_SUCCESS == rep->status &&
+            ORCM_SUCCESS != print_set_result(rep)) {
+            failed++;
         }
-
-        /* wait for status message */
-        ORTE_WAIT_FOR_COMPLETION(xfer->active);
-
-        cnt=1;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &result,
-                                                  &cnt, OPAL_INT))) {
-            error = UNPACKERR;
-            goto done;
-         }
-         if (ORCM_SUCCESS == result) {
-             printf("\nSuccess\n");
-         } else {
-             if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &error,
-                                                  &cnt, OPAL_STRING))) {
-                 error = UNPACKERR;
-                 goto done;
-             }
-             rc = result;
-             goto done;
-         }
+    }
+    if (0 < failed) {
+        error = "command failed on some nodes";
+        rc = ORCM_ERROR;
     }
 
 done:
     if(buf) {
        OBJ_RELEASE(buf);
     }
-    if(xfer) {
-       OBJ_RELEASE(xfer);
-    }
+    OPAL_LIST_DESTRUCT(&replies);
     if(nodelist) {
        opal_argv_free(nodelist);
     }
-    orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_SENSOR);
     if (ORCM_SUCCESS != rc) {
         orte_show_help("help-octl.txt",
                        TAG, true, error, ORTE_ERROR_NAME(rc), rc);
@@ -621,11 +565,12 @@ int orcm_octl_sensor_sample_rate_get(int cmd, char **argv)
     opal_buffer_t *buf = NULL;
     int rc = ORCM_SUCCESS;
     int result = ORCM_SUCCESS;
-    int cnt, i;
-    orte_process_name_t tgt;
-    orte_rml_recv_cb_t *xfer = NULL;
+    int cnt, failed;
+    opal_list_t replies;
+    orcm_fanout_reply_t *rep;
     char **nodelist = NULL;
     char *sensor_name = NULL;
+    char *reason = NULL;
     int sample_rate = 0;
     char *error = NULL;
 
@@ -637,6 +582,7 @@ int orcm_octl_sensor_sample_rate_get(int cmd, char **argv)
                        true, error, ORTE_ERROR_NAME(rc), rc);
        return rc;
     }
+    OBJ_CONSTRUCT(&replies, opal_list_t);
 
     /* setup the receiver nodelist */
     orcm_logical_group_parse_array_string(argv[4], &nodelist);
@@ -674,40 +620,22 @@ int orcm_octl_sensor_sample_rate_get(int cmd, char **argv)
         goto done;
     }
 
-    /* Loop through the nodelist to get sensor sample-rate */
-    xfer = OBJ_NEW(orte_rml_recv_cb_t);
-    for (i = 0; i < opal_argv_count(nodelist); i++) {
-        OBJ_RETAIN(buf);
-        OBJ_RETAIN(xfer);
-
-        xfer->active = true;
-        orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD,
-                            ORCM_RML_TAG_SENSOR,
-                            ORTE_RML_NON_PERSISTENT,
-                            orte_rml_recv_callback, xfer);
-
-        printf("\nORCM getting sensor %s sample-rate  from node:%s\n",
-                argv[3], nodelist[i]);
-        if (ORCM_SUCCESS != (rc = orcm_cfgi_base_get_hostname_proc(nodelist[i],
-                                                                   &tgt))) {
-            error = "incorrect node name";
-            goto done;
-        }
+    /* one request for the whole nodelist */
+    if (ORCM_SUCCESS != (rc = orcm_octl_fanout(ORCM_RML_TAG_SENSOR, nodelist,
+                                               buf, &replies))) {
+        error = "scheduler contact failed";
+        goto done;
+    }
 
-        /* send command to node daemon */
-        if (ORTE_SUCCESS !=
-            (rc = orte_rml.send_buffer_nb(&tgt, buf,
-                                          ORCM_RML_TAG_SENSOR,
-                                          orte_rml_send_callback, NULL))) {
-            error = "daemon contact failed";
-            goto done;
+    failed = orcm_octl_fanout_report(&replies);
+    printf("\nNode                 Sensor     sample-rate\n");
+    printf("------------------------------------------------------------------------------\n");
+    OPAL_LIST_FOREACH(rep, &replies, orcm_fanout_reply_t) {
+        if (ORCM_SUCCESS != rep->status) {
+            continue;
         }
-
-        /* wait for status message */
-        ORTE_WAIT_FOR_COMPLETION(xfer->active);
-
         cnt=1;
-        if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &result,
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(rep->data, &result,
                                                   &cnt, OPAL_INT))) {
             error = UNPACKERR;
             goto done;
@@ -715,48 +643,49 @@ int orcm_octl_sensor_sample_rate_get(int cmd, char **argv)
 
         if ( 0 != result ) {
             cnt=1;
-            if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &error,
+            if (OPAL_SUCCESS != (rc = opal_dss.unpack(rep->data, &reason,
                                                        &cnt, OPAL_STRING))) {
                 error = UNPACKERR;
                 goto done;
             }
-            rc = result;
+            printf("%-20s %s\n", rep->hostname, reason);
+            SAFEFREE(reason);
+            failed++;
+            continue;
+        }
+        /* unpack sensor name */
+        cnt = 1;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(rep->data, &sensor_name,
+                                          &cnt, OPAL_STRING))) {
+            error = UNPACKERR;
             goto done;
-        } else {
-             printf("\nSensor     sample-rate\n");
-             printf("------------------------------------------------------------------------------\n");
-            /* unpack sensor name */
-            cnt = 1;
-            if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data, &sensor_name,
-                                              &cnt, OPAL_STRING))) {
-                error = UNPACKERR;
-                goto done;
-            }
-
-            /* unpack sample rate */
-            cnt = 1;
-            if (OPAL_SUCCESS != (rc = opal_dss.unpack(&xfer->data,
-                                                      &sample_rate,
-                                                      &cnt, OPAL_INT))) {
-                error = UNPACKERR;
-                goto done;
-            }
+        }
 
-            printf("%s            %d\n", sensor_name, sample_rate);
+        /* unpack sample rate */
+        cnt = 1;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(rep->data,
+                                                  &sample_rate,
+                                                  &cnt, OPAL_INT))) {
+            error = UNPACKERR;
+            goto done;
         }
+
+        printf("%-20s %-10s %d\n", rep->hostname, sensor_name, sample_rate);
+        SAFEFREE(sensor_name);
+    }
+    if (0 < failed) {
+        error = "command failed on some nodes";
+        rc = ORCM_ERROR;
     }
 
 done:
     if(buf) {
        OBJ_RELEASE(buf);
     }
-    if(xfer) {
-       OBJ_RELEASE(xfer);
-    }
+    OPAL_LIST_DESTRUCT(&replies);
     if(nodelist) {
        opal_argv_free(nodelist);
     }
-    orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_SENSOR);
 
     if (ORCM_SUCCESS != rc) {
         orte_show_help("help-octl.txt",
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2016      Intel, Inc.  All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orcm/tools/octl/common.h"
+#include "orcm/util/logical_group.h"
+#include "orcm/util/pubsub.h"
+
+/* defined in query.c */
+double stopwatch(void);
+
+/* state shared with the RML callback */
+typedef struct {
+    volatile bool active;
+    int status;
+    uint32_t id;
+    uint64_t received;
+    uint64_t dropped;
+    uint64_t delivered_by_scheduler;
+    uint64_t dropped_by_scheduler;
+} octl_subscription_t;
+
+static octl_subscription_t subscription;
+
+static void subscribe_print_records(opal_buffer_t *buffer)
+{
+    orcm_pubsub_record_t *rec;
+    uint64_t dropped;
+    uint32_t id;
+    int32_t n, i;
+    int cnt = 1;
+    char *csv;
+
+    if (OPAL_SUCCESS != opal_dss.unpack(buffer, &id, &cnt, OPAL_UINT32) ||
+        OPAL_SUCCESS != opal_dss.unpack(buffer, &dropped, &cnt, OPAL_UINT64) ||
+        OPAL_SUCCESS != opal_dss.unpack(buffer, &n, &cnt, OPAL_INT32)) {
+        return;
+    }
+    if (id != subscription.id) {
+        return;
+    }
+    if (0 < dropped) {
+        subscription.dropped += dropped;
+        printf("# %lu records dropped\n", (unsigned long)dropped);
+    }
+    for (i = 0; i < n; i++) {
+        if (ORCM_SUCCESS != orcm_pubsub_record_unpack(buffer, &rec)) {
+            break;
+        }
+        if (NULL != (csv = orcm_pubsub_record_to_csv(rec))) {
+            printf("%s", csv);
+            free(csv);
+        }
+        subscription.received++;
+        OBJ_RELEASE(rec);
+    }
+    fflush(stdout);
+}
+
+static void subscribe_recv(int status, orte_process_name_t* sender,
+                           opal_buffer_t *buffer,
+                           orte_rml_tag_t tag, void *cbdata)
+{
+    orcm_pubsub_cmd_flag_t command;
+    int cnt = 1;
+
+    if (OPAL_SUCCESS != opal_dss.unpack(buffer, &command, &cnt, ORCM_PUBSUB_CMD_T)) {
+        return;
+    }
+
+    if (ORCM_PUBSUB_PUBLISH_COMMAND == command) {
+        subscribe_print_records(buffer);
+    } else if (ORCM_PUBSUB_ACK_COMMAND == command) {
+        if (OPAL_SUCCESS != opal_dss.unpack(buffer, &subscription.status, &cnt, OPAL_INT) ||
+            OPAL_SUCCESS != opal_dss.unpack(buffer, &subscription.id, &cnt, OPAL_UINT32) ||
+            OPAL_SUCCESS != opal_dss.unpack(buffer, &subscription.delivered_by_scheduler,
+                                            &cnt, OPAL_UINT64) ||
+            OPAL_SUCCESS != opal_dss.unpack(buffer, &subscription.dropped_by_scheduler,
+                                            &cnt, OPAL_UINT64)) {
+            subscription.status = ORCM_ERR_UNPACK_FAILURE;
+        }
+        subscription.active = false;
+    }
+}
+
+static int subscribe_send(orcm_pubsub_cmd_flag_t command, orcm_pubsub_filter_t *filter)
+{
+    opal_buffer_t *buffer;
+    int rc;
+
+    buffer = OBJ_NEW(opal_buffer_t);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(buffer, &command, 1, ORCM_PUBSUB_CMD_T)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(buffer, &subscription.id, 1, OPAL_UINT32)) ||
+        (NULL != filter && OPAL_SUCCESS != (rc = orcm_pubsub_filter_pack(buffer, filter)))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(buffer);
+        return rc;
+    }
+
+    subscription.active = true;
+    if (ORTE_SUCCESS != (rc = orte_rml.send_buffer_nb(ORTE_PROC_MY_SCHEDULER, buffer,
+                                                      ORCM_RML_TAG_PUBSUB,
+                                                      orte_rml_send_callback, NULL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(buffer);
+        subscription.active = false;
+        return rc;
+    }
+    /* wait for the scheduler to acknowledge */
+    ORTE_WAIT_FOR_COMPLETION(subscription.active);
+
+    return subscription.status;
+}
+
+static void show_subscribe_error_message(int kind)
+{
+    orte_show_help("help-octl.txt",
+                   (ORCM_PUBSUB_KIND_SAMPLE == kind) ? "octl:subscribe:sensor" :
+                                                       "octl:subscribe:event",
+                   true, "Incorrect arguments");
+}
+
+static char** subscribe_parse_list(char *arg)
+{
+    if (NULL == arg || 0 == strcmp(arg, "*")) {
+        return NULL;
+    }
+    return opal_argv_split(arg, ',');
+}
+
+/* subscribe sensor <data-groups|*> <metrics|*> <seconds> <nodes>
+ * subscribe event <seconds> <nodes> */
+int orcm_octl_subscribe(int kind, char **argv)
+{
+    orcm_pubsub_filter_t *filter = NULL;
+    char **nodes = NULL;
+    int argc = opal_argv_count(argv);
+    int expected = (ORCM_PUBSUB_KIND_SAMPLE == kind) ? 6 : 4;
+    double stop_time;
+    long seconds;
+    int rc;
+
+    if (expected != argc) {
+        show_subscribe_error_message(kind);
+        return ORCM_ERR_BAD_PARAM;
+    }
+
+    seconds = strtol(argv[argc - 2], NULL, 10);
+    if (0 >= seconds) {
+        show_subscribe_error_message(kind);
+        return ORCM_ERR_BAD_PARAM;
+    }
+
+    filter = OBJ_NEW(orcm_pubsub_filter_t);
+    filter->kinds = (uint8_t)kind;
+    if (0 != strcmp(argv[argc - 1], "*")) {
+        rc = orcm_logical_group_parse_array_string(argv[argc - 1], &nodes);
+        if (ORCM_SUCCESS != rc || 0 == opal_argv_count(nodes)) {
+            fprintf(stderr, "\nERROR: unable to extract nodelist or an empty list was specified\n");
+            opal_argv_free(nodes);
+            OBJ_RELEASE(filter);
+            return ORCM_ERR_BAD_PARAM;
+        }
+        filter->hosts = nodes;
+    }
+    if (ORCM_PUBSUB_KIND_SAMPLE == kind) {
+        filter->groups = subscribe_parse_list(argv[2]);
+        filter->metrics = subscribe_parse_list(argv[3]);
+    }
+
+    memset(&subscription, 0, sizeof(subscription));
+    orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD, ORCM_RML_TAG_PUBSUB,
+                            ORTE_RML_PERSISTENT, subscribe_recv, NULL);
+
+    if (ORCM_SUCCESS != (rc = subscribe_send(ORCM_PUBSUB_SUBSCRIBE_COMMAND, filter))) {
+        fprintf(stderr, "\nERROR: subscription was refused\n");
+        goto cleanup;
+    }
+
+    printf("\n%s\n", ORCM_PUBSUB_CSV_HEADER);
+    stop_time = stopwatch() + (double)seconds;
+    while (stopwatch() < stop_time) {
+        struct timespec tp = {0, 100000000};
+        nanosleep(&tp, NULL);
+    }
+
+    if (ORCM_SUCCESS == (rc = subscribe_send(ORCM_PUBSUB_UNSUBSCRIBE_COMMAND, NULL))) {
+        printf("\n%lu records received, %lu dropped (%lu relayed by the scheduler, %lu dropped there)\n",
+               (unsigned long)subscription.received, (unsigned long)subscription.dropped,
+               (unsigned long)subscription.delivered_by_scheduler,
+               (unsigned long)subscription.dropped_by_scheduler);
+    }
+
+cleanup:
+    orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_PUBSUB);
+    OBJ_RELEASE(filter);
+    return rc;
+}
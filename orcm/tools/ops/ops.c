@@ -33,6 +33,8 @@
 
 #include <stdio.h>
 #include <errno.h>
+#include <signal.h>
+#include <time.h>
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
 #endif  /* HAVE_UNISTD_H */
@@ -57,10 +59,12 @@
 
 #include "opal/util/basename.h"
 #include "opal/util/cmd_line.h"
+#include "opal/dss/dss.h"
 #include "opal/util/output.h"
 #include "opal/util/opal_environ.h"
 #include "opal/util/show_help.h"
 #include "opal/mca/base/base.h"
+#include "opal/mca/event/event.h"
 #include "opal/runtime/opal.h"
 #if OPAL_ENABLE_FT_CR == 1
 #include "opal/runtime/opal_cr.h"
@@ -74,6 +78,7 @@
 #include "orte/util/proc_info.h"
 #include "orte/mca/errmgr/errmgr.h"
 #include "orte/util/comm/comm.h"
+#include "orte/mca/rml/rml.h"
 #include "orte/mca/ras/ras_types.h"
 
 
@@ -145,6 +150,8 @@ static char *pretty_node_state(orte_node_state_t state);
 
 static int parseable_print(orte_ps_mpirun_info_t *hnpinfo);
 
+static int watch_changes(void);
+
 /*****************************************
  * Global Vars for Command line Arguments
  *****************************************/
@@ -157,6 +164,7 @@ typedef struct {
     bool daemons;
     int  output;
     pid_t pid;
+    int watch;
 } orte_ps_globals_t;
 
 orte_ps_globals_t orte_ps_globals;
@@ -204,6 +212,12 @@ opal_cmd_line_init_t cmd_line_opts[] = {
       &orte_ps_globals.nodes, OPAL_CMD_LINE_TYPE_INT,
       "Display Node Information" },
 
+    { NULL,
+      'w', NULL, "watch", 
+      1,
+      &orte_ps_globals.watch, OPAL_CMD_LINE_TYPE_INT,
+      "After the initial display, report changes every N seconds until interrupted" },
+
     /* End of list */
     { NULL,
       '\0', NULL, NULL, 
@@ -242,6 +256,11 @@ main(int argc, char *argv[])
                 exit_status = ret;
             }
         }
+        if (0 < orte_ps_globals.watch) {
+            if (ORTE_SUCCESS != (ret = watch_changes())) {
+                exit_status = ret;
+            }
+        }
     } else {
         /* this could be due to a stale session directory - if so,
          * just skip this entry, but don't abort
@@ -270,7 +289,8 @@ static int parse_args(int argc, char *argv[]) {
                               false,                    /* nodes */
                               false,                    /* daemons */
                               -1,                       /* output */
-                              0};                       /* pid */
+                              0,                        /* pid */
+                              0};                       /* watch */
 
     orte_ps_globals = tmp;
 
@@ -887,3 +907,211 @@ static int parseable_print(orte_ps_mpirun_info_t *hnpinfo)
 
     return ORTE_SUCCESS;
 }
+
+/*
+ * Watch mode - rather than re-querying everything, subscribe at the HNP
+ * and print each job, node or proc as it changes
+ */
+static bool watching = false;
+static opal_event_t term_handler;
+static opal_event_t int_handler;
+
+static void stop_watching(int fd, short flags, void *arg)
+{
+    watching = false;
+}
+
+static bool show_job(orte_jobid_t jobid)
+{
+    orte_jobid_t mask=0x0000ffff;
+
+    /* the daemons' job is only of interest when asked for */
+    return (0 != (mask & jobid) || orte_ps_globals.daemons);
+}
+
+static void recv_changes(int status, orte_process_name_t* sender,
+                         opal_buffer_t *buffer, orte_rml_tag_t tag,
+                         void* cbdata)
+{
+    int32_t n;
+    bool snapshot;
+    orte_watch_flag_t flag;
+    orte_jobid_t jobid;
+    orte_process_name_t proc;
+    orte_job_state_t jstate;
+    orte_proc_state_t pstate;
+    orte_node_state_t nstate;
+    orte_vpid_t num_procs, num_terminated;
+    orte_std_cntr_t slots_inuse;
+    orte_exit_code_t exit_code;
+    pid_t pid;
+    char *name, *node_state;
+    char stamp[32];
+    time_t now;
+    int ret;
+
+    n = 1;
+    if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &snapshot, &n, OPAL_BOOL))) {
+        ORTE_ERROR_LOG(ret);
+        return;
+    }
+    /* the initial picture was already displayed above */
+    if (snapshot) {
+        return;
+    }
+
+    now = time(NULL);
+    strftime(stamp, sizeof(stamp), "%H:%M:%S", localtime(&now));
+
+    n = 1;
+    while (ORTE_SUCCESS == opal_dss.unpack(buffer, &flag, &n, ORTE_WATCH_FLAG_T)) {
+        n = 1;
+        switch (flag & ~ORTE_WATCH_GONE) {
+        case ORTE_WATCH_JOBS:
+            if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &jobid, &n, ORTE_JOBID))) {
+                goto error;
+            }
+            if (flag & ORTE_WATCH_GONE) {
+                if (show_job(jobid)) {
+                    printf("%s JOB %s gone\n", stamp, ORTE_JOBID_PRINT(jobid));
+                }
+                break;
+            }
+            n = 1;
+            if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &jstate, &n, ORTE_JOB_STATE))) {
+                goto error;
+            }
+            n = 1;
+            if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &num_procs, &n, ORTE_VPID))) {
+                goto error;
+            }
+            n = 1;
+            if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &num_terminated, &n, ORTE_VPID))) {
+                goto error;
+            }
+            if (show_job(jobid)) {
+                printf("%s JOB %s state %s procs %u terminated %u\n", stamp,
+                       ORTE_JOBID_PRINT(jobid), orte_job_state_to_str(jstate),
+                       (unsigned int)num_procs, (unsigned int)num_terminated);
+            }
+            break;
+
+        case ORTE_WATCH_NODES:
+            if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &name, &n, OPAL_STRING))) {
+                goto error;
+            }
+            if (flag & ORTE_WATCH_GONE) {
+                printf("%s NODE %s gone\n", stamp, name);
+                SAFEFREE(name);
+                break;
+            }
+            n = 1;
+            if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &nstate, &n, ORTE_NODE_STATE))) {
+                SAFEFREE(name);
+                goto error;
+            }
+            n = 1;
+            if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &num_procs, &n, ORTE_VPID))) {
+                SAFEFREE(name);
+                goto error;
+            }
+            n = 1;
+            if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &slots_inuse, &n, ORTE_STD_CNTR))) {
+                SAFEFREE(name);
+                goto error;
+            }
+            node_state = pretty_node_state(nstate);
+            printf("%s NODE %s state %s procs %u slots in use %d\n", stamp, name,
+                   node_state, (unsigned int)num_procs, (int)slots_inuse);
+            SAFEFREE(node_state);
+            SAFEFREE(name);
+            break;
+
+        case ORTE_WATCH_PROCS:
+            if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &proc, &n, ORTE_NAME))) {
+                goto error;
+            }
+            if (flag & ORTE_WATCH_GONE) {
+                if (show_job(proc.jobid)) {
+                    printf("%s PROC %s gone\n", stamp, ORTE_NAME_PRINT(&proc));
+                }
+                break;
+            }
+            n = 1;
+            if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &pstate, &n, ORTE_PROC_STATE))) {
+                goto error;
+            }
+            n = 1;
+            if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &pid, &n, OPAL_PID))) {
+                goto error;
+            }
+            n = 1;
+            if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &name, &n, OPAL_STRING))) {
+                goto error;
+            }
+            n = 1;
+            if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &exit_code, &n, ORTE_EXIT_CODE))) {
+                SAFEFREE(name);
+                goto error;
+            }
+            if (show_job(proc.jobid)) {
+                printf("%s PROC %s node %s pid %d state %s exit code %d\n", stamp,
+                       ORTE_NAME_PRINT(&proc), (NULL == name) ? "-" : name,
+                       (int)pid, orte_proc_state_to_str(pstate), (int)exit_code);
+            }
+            SAFEFREE(name);
+            break;
+
+        default:
+            /* cannot tell how to skip a record we did not ask for */
+            ret = ORTE_ERR_BAD_PARAM;
+            goto error;
+        }
+        n = 1;
+    }
+    fflush(stdout);
+    return;
+
+ error:
+    ORTE_ERROR_LOG(ret);
+}
+
+static int watch_changes(void)
+{
+    orte_watch_flag_t what = ORTE_WATCH_JOBS | ORTE_WATCH_PROCS;
+    int ret;
+
+    if (orte_ps_globals.nodes) {
+        what |= ORTE_WATCH_NODES;
+    }
+
+    opal_event_signal_set(orte_event_base, &term_handler, SIGTERM,
+                          stop_watching, NULL);
+    opal_event_signal_add(&term_handler, NULL);
+    opal_event_signal_set(orte_event_base, &int_handler, SIGINT,
+                          stop_watching, NULL);
+    opal_event_signal_add(&int_handler, NULL);
+
+    orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD, ORTE_RML_TAG_WATCH,
+                            ORTE_RML_PERSISTENT, recv_changes, NULL);
+
+    if (ORTE_SUCCESS != (ret = orte_util_comm_watch(ORTE_PROC_MY_HNP, what,
+                                                    orte_ps_globals.watch,
+                                                    orte_ps_globals.jobid,
+                                                    NULL, 0, NULL))) {
+        ORTE_ERROR_LOG(ret);
+        goto cleanup;
+    }
+
+    watching = true;
+    while (watching) {
+        opal_event_loop(orte_event_base, OPAL_EVLOOP_ONCE);
+    }
+    orte_util_comm_unwatch(ORTE_PROC_MY_HNP);
+
+ cleanup:
+    orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORTE_RML_TAG_WATCH);
+    opal_event_signal_del(&term_handler);
+    opal_event_signal_del(&int_handler);
+    return ret;
+}
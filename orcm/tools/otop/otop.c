@@ -37,6 +37,7 @@
 #include <errno.h>
 #include <signal.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include "opal/util/cmd_line.h"
 #include "opal/util/argv.h"
@@ -55,6 +56,7 @@
 #include "orte/util/hnp_contact.h"
 #include "orte/util/name_fns.h"
 #include "orte/util/show_help.h"
+#include "orte/util/comm/comm.h"
 #include "orte/util/proc_info.h"
 #include "orte/runtime/orte_wait.h"
 #include "orte/mca/rml/base/rml_contact.h"
@@ -82,6 +84,11 @@ static bool timestamp;
 static char *logfile;
 static bool bynode;
 static opal_list_t recvd_stats;
+/* latest sample per rank when the daemons stream changes to us */
+static opal_list_t watched;
+static bool watching = false;
+static int32_t nwatch_ranks = 0;
+static orte_vpid_t *watch_ranks = NULL;
 static char *sample_time;
 static bool need_header = true;
 static int num_lines=0;
@@ -170,6 +177,11 @@ static void recv_stats(int status, orte_process_name_t* sender,
                        opal_buffer_t *buffer, orte_rml_tag_t tag,
                        void* cbdata);
 
+static void recv_watch(int status, orte_process_name_t* sender,
+                       opal_buffer_t *buffer, orte_rml_tag_t tag,
+                       void* cbdata);
+static void print_watched(int fd, short dummy, void *arg);
+
 static void pretty_print(void);
 static void print_headers(void);
 
@@ -272,6 +284,7 @@ main(int argc, char *argv[])
     
    /* setup the list for recvd stats */
     OBJ_CONSTRUCT(&recvd_stats, opal_list_t);
+    OBJ_CONSTRUCT(&watched, opal_list_t);
     
     /** setup callbacks for abort signals - from this point
      * forward, we need to abort in a manner that allows us
@@ -494,6 +507,7 @@ main(int argc, char *argv[])
             vint = strtol(r1[i], NULL, 10);
             if (-1 == vint) {
                 proc.vpid = ORTE_VPID_WILDCARD;
+                nwatch_ranks = 0;
                 if (ORTE_SUCCESS != (ret = opal_dss.pack(&cmdbuf, &proc, 1, ORTE_NAME))) {
                     ORTE_ERROR_LOG(ret);
                     goto cleanup;
@@ -504,11 +518,15 @@ main(int argc, char *argv[])
             vstart = strtol(r2[0], NULL, 10);
             vend = vstart + 1;
         }
+        if (vstart < vend) {
+            watch_ranks = (orte_vpid_t*)realloc(watch_ranks, (nwatch_ranks + vend - vstart) * sizeof(orte_vpid_t));
+        }
         for (proc.vpid = vstart; proc.vpid < vend; proc.vpid++) {
             if (ORTE_SUCCESS != (ret = opal_dss.pack(&cmdbuf, &proc, 1, ORTE_NAME))) {
                 ORTE_ERROR_LOG(ret);
                 goto cleanup;
             }
+            watch_ranks[nwatch_ranks++] = proc.vpid;
         }
         opal_argv_free(r2);
     }
@@ -517,7 +535,23 @@ SEND:
     if (NULL != r1) {
         opal_argv_free(r1);
     }
-    send_cmd(0, 0, NULL);
+    if (0 < update_rate) {
+        /* rather than polling every daemon each period, subscribe
+         * and let the daemons push only what changed
+         */
+        orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD, ORTE_RML_TAG_WATCH,
+                                ORTE_RML_PERSISTENT, recv_watch, NULL);
+        if (ORTE_SUCCESS != (ret = orte_util_comm_watch(&target_hnp->name, ORTE_WATCH_PSTATS,
+                                                        update_rate, proc.jobid, NULL,
+                                                        nwatch_ranks, watch_ranks))) {
+            ORTE_ERROR_LOG(ret);
+            goto cleanup;
+        }
+        watching = true;
+        ORTE_TIMER_EVENT(update_rate, 0, print_watched, ORTE_SYS_PRI);
+    } else {
+        send_cmd(0, 0, NULL);
+    }
 
     /* now wait until the termination event fires */
     while (orte_event_base_active) {
@@ -528,10 +562,21 @@ SEND:
      * Cleanup
      ***************/
 cleanup:
+    if (watching) {
+        orte_util_comm_unwatch(&target_hnp->name);
+    }
     /* Remove the TERM and INT signal handlers */
     opal_event_signal_del(&term_handler);
     opal_event_signal_del(&int_handler);
 
+    while (NULL != (item  = opal_list_remove_first(&watched))) {
+        OBJ_RELEASE(item);
+    }
+    OBJ_DESTRUCT(&watched);
+    if (NULL != watch_ranks) {
+        free(watch_ranks);
+    }
+
     while (NULL != (item  = opal_list_remove_first(&recvd_stats))) {
         OBJ_RELEASE(item);
     }
@@ -548,7 +593,15 @@ cleanup:
 static void abort_exit_callback(int fd, short ign, void *arg)
 {
     opal_list_item_t *item;
-    
+
+    /* tell the daemons to stop pushing updates to us, as the
+     * normal cleanup path would
+     */
+    if (watching) {
+        orte_util_comm_unwatch(&target_hnp->name);
+        watching = false;
+    }
+
     /* Remove the TERM and INT signal handlers */
     opal_event_signal_del(&term_handler);
     OBJ_DESTRUCT(&term_handler);
@@ -567,6 +620,97 @@ static void abort_exit_callback(int fd, short ign, void *arg)
     orte_quit(0,0,NULL);
 }
 
+/* widen the output fields to fit this sample */
+static void set_fields(opal_pstats_t *stats)
+{
+    int tmp;
+    char *ctmp;
+    
+    tmp = strlen(stats->node);
+    if (nodefield < tmp) {
+        nodefield = tmp;
+    }
+    
+    asprintf(&ctmp, "%d", stats->rank);
+    tmp = strlen(ctmp);
+    free(ctmp);
+    if (rankfield < tmp) {
+        rankfield = tmp;
+    }
+    
+    asprintf(&ctmp, "%lu", (unsigned long)stats->pid);
+    tmp = strlen(ctmp);
+    free(ctmp);
+    if (pidfield < tmp) {
+        pidfield = tmp;
+    }
+    
+    tmp = strlen(stats->cmd);
+    if (cmdfield < tmp) {
+        cmdfield = tmp;
+    }
+    
+    if (0 <= stats->priority) {
+        pri_found = true;
+        asprintf(&ctmp, "%d", stats->priority);
+        tmp = strlen(ctmp);
+        free(ctmp);
+        if (prifield < tmp) {
+            prifield = tmp;
+        }
+    }
+    
+    if (0 <= stats->num_threads) {
+        thr_found = true;
+        asprintf(&ctmp, "%d", stats->num_threads);
+        tmp = strlen(ctmp);
+        free(ctmp);
+        if (thrfield < tmp) {
+            thrfield = tmp;
+        }
+    }
+    
+    if (0 < stats->vsize) {
+        vsize_found = true;
+        asprintf(&ctmp, "%8.2f", stats->vsize);
+        tmp = strlen(ctmp);
+        free(ctmp);
+        if (vsizefield < tmp) {
+            vsizefield = tmp;
+        }
+    }
+    
+    if (0 < stats->rss) {
+        rss_found = true;
+        asprintf(&ctmp, "%8.2f", stats->rss);
+        tmp = strlen(ctmp);
+        free(ctmp);
+        if (rssfield < tmp) {
+            rssfield = tmp;
+        }
+    }
+    
+    if (0 < stats->peak_vsize) {
+        pkv_found = true;
+        asprintf(&ctmp, "%8.2f", stats->peak_vsize);
+        tmp = strlen(ctmp);
+        free(ctmp);
+        if (pkvfield < tmp) {
+            pkvfield = tmp;
+        }
+    }
+    
+    if (0 <= stats->processor) {
+        p_found = true;
+        asprintf(&ctmp, "%d", stats->processor);
+        tmp = strlen(ctmp);
+        free(ctmp);
+        if (pfield < tmp) {
+            pfield = tmp;
+        }
+    }
+}
+
 static void recv_stats(int status, orte_process_name_t* sender,
                        opal_buffer_t *buffer, orte_rml_tag_t tag,
                        void* cbdata)
@@ -601,92 +745,7 @@ static void recv_stats(int status, orte_process_name_t* sender,
         }
         /* if field sizes are not yet set, do so now */
         if (!fields_set) {
-            int tmp;
-            char *ctmp;
-            
-            tmp = strlen(stats->node);
-            if (nodefield < tmp) {
-                nodefield = tmp;
-            }
-            
-            asprintf(&ctmp, "%d", stats->rank);
-            tmp = strlen(ctmp);
-            free(ctmp);
-            if (rankfield < tmp) {
-                rankfield = tmp;
-            }
-            
-            asprintf(&ctmp, "%lu", (unsigned long)stats->pid);
-            tmp = strlen(ctmp);
-            free(ctmp);
-            if (pidfield < tmp) {
-                pidfield = tmp;
-            }
-            
-            tmp = strlen(stats->cmd);
-            if (cmdfield < tmp) {
-                cmdfield = tmp;
-            }
-            
-            if (0 <= stats->priority) {
-                pri_found = true;
-                asprintf(&ctmp, "%d", stats->priority);
-                tmp = strlen(ctmp);
-                free(ctmp);
-                if (prifield < tmp) {
-                    prifield = tmp;
-                }
-            }
-            
-            if (0 <= stats->num_threads) {
-                thr_found = true;
-                asprintf(&ctmp, "%d", stats->num_threads);
-                tmp = strlen(ctmp);
-                free(ctmp);
-                if (thrfield < tmp) {
-                    thrfield = tmp;
-                }
-            }
-            
-            if (0 < stats->vsize) {
-                vsize_found = true;
-                asprintf(&ctmp, "%8.2f", stats->vsize);
-                tmp = strlen(ctmp);
-                free(ctmp);
-                if (vsizefield < tmp) {
-                    vsizefield = tmp;
-                }
-            }
-            
-            if (0 < stats->rss) {
-                rss_found = true;
-                asprintf(&ctmp, "%8.2f", stats->rss);
-                tmp = strlen(ctmp);
-                free(ctmp);
-                if (rssfield < tmp) {
-                    rssfield = tmp;
-                }
-            }
-            
-            if (0 < stats->peak_vsize) {
-                pkv_found = true;
-                asprintf(&ctmp, "%8.2f", stats->peak_vsize);
-                tmp = strlen(ctmp);
-                free(ctmp);
-                if (pkvfield < tmp) {
-                    pkvfield = tmp;
-                }
-            }
-            
-            if (0 <= stats->processor) {
-                p_found = true;
-                asprintf(&ctmp, "%d", stats->processor);
-                tmp = strlen(ctmp);
-                free(ctmp);
-                if (pfield < tmp) {
-                    pfield = tmp;
-                }
-            }
+            set_fields(stats);
         }
         /* add it to the list */
         opal_list_append(&recvd_stats, &stats->super);
@@ -716,6 +775,86 @@ static void recv_stats(int status, orte_process_name_t* sender,
                             ORTE_RML_NON_PERSISTENT, recv_stats, NULL);
 }
 
+static void recv_watch(int status, orte_process_name_t* sender,
+                       opal_buffer_t *buffer, orte_rml_tag_t tag,
+                       void* cbdata)
+{
+    int32_t n;
+    bool snapshot;
+    orte_watch_flag_t flag;
+    opal_pstats_t *stats, *prev;
+    orte_process_name_t proc;
+    int ret;
+
+    n = 1;
+    if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &snapshot, &n, OPAL_BOOL))) {
+        ORTE_ERROR_LOG(ret);
+        return;
+    }
+    n = 1;
+    while (ORTE_SUCCESS == opal_dss.unpack(buffer, &flag, &n, ORTE_WATCH_FLAG_T)) {
+        if (ORTE_WATCH_PSTATS != (flag & ~ORTE_WATCH_GONE)) {
+            /* we only asked for resource usage */
+            ORTE_ERROR_LOG(ORTE_ERR_BAD_PARAM);
+            return;
+        }
+        n = 1;
+        if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &proc, &n, ORTE_NAME))) {
+            ORTE_ERROR_LOG(ret);
+            return;
+        }
+        /* the new sample replaces whatever we held for this rank */
+        OPAL_LIST_FOREACH(prev, &watched, opal_pstats_t) {
+            if (prev->rank == (int32_t)proc.vpid) {
+                opal_list_remove_item(&watched, &prev->super);
+                OBJ_RELEASE(prev);
+                break;
+            }
+        }
+        if (!(flag & ORTE_WATCH_GONE)) {
+            n = 1;
+            if (ORTE_SUCCESS != (ret = opal_dss.unpack(buffer, &stats, &n, OPAL_PSTAT))) {
+                ORTE_ERROR_LOG(ret);
+                return;
+            }
+            opal_list_append(&watched, &stats->super);
+        }
+        n = 1;
+    }
+}
+
+static void print_watched(int fd, short dummy, void *arg)
+{
+    orte_timer_t *tm = (orte_timer_t*)arg;
+    opal_pstats_t *stats, *copy;
+    time_t mytime;
+    char *cptr;
+
+    OBJ_RELEASE(tm);
+
+    /* pretty_print consumes what it prints, so hand it copies */
+    OPAL_LIST_FOREACH(stats, &watched, opal_pstats_t) {
+        copy = NULL;
+        if (OPAL_SUCCESS != opal_dss.copy((void**)&copy, stats, OPAL_PSTAT)) {
+            continue;
+        }
+        if (!fields_set) {
+            set_fields(copy);
+        }
+        opal_list_append(&recvd_stats, &copy->super);
+    }
+    if (0 < opal_list_get_size(&recvd_stats)) {
+        time(&mytime);
+        cptr = ctime(&mytime);
+        cptr[strlen(cptr)-1] = '\0';  /* remove trailing newline */
+        sample_time = strdup(cptr);
+        fields_set = true;
+        pretty_print();
+    }
+
+    ORTE_TIMER_EVENT(update_rate, 0, print_watched, ORTE_SYS_PRI);
+}
+
 /* static values needed for printing */
 static int lennode = 0;
 static int lenrank = 0;
@@ -0,0 +1,694 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/class/opal_hash_table.h"
+#include "opal/dss/dss.h"
+#include "opal/mca/event/event.h"
+#include "opal/util/output.h"
+
+#include "orte/mca/errmgr/errmgr.h"
+#include "orte/mca/rml/rml.h"
+#include "orte/mca/routed/routed.h"
+#include "orte/runtime/orte_globals.h"
+#include "orte/runtime/orte_wait.h"
+#include "orte/util/name_fns.h"
+#include "orte/util/proc_info.h"
+
+#include "orcm/runtime/orcm_globals.h"
+#include "orcm/util/fanout.h"
+
+/* both directions travel on ORCM_RML_TAG_FANOUT */
+#define FANOUT_REQUEST 1
+#define FANOUT_REPLY   2
+
+/* each hop hands its children this fraction of the time it was given
+ * so that a slow subtree is reported as such rather than taking its
+ * parent's whole answer down with it */
+#define FANOUT_CHILD_SHARE(ms) ((ms) - (ms) / 4)
+
+typedef struct {
+    opal_list_item_t super;
+    orte_rml_tag_t tag;
+    orcm_fanout_local_fn_t fn;
+} fanout_handler_t;
+static OBJ_CLASS_INSTANCE(fanout_handler_t,
+                          opal_list_item_t,
+                          NULL, NULL);
+
+/* the targets reached through one next hop */
+typedef struct {
+    opal_list_item_t super;
+    orte_process_name_t hop;
+    orte_process_name_t *targets;
+    int32_t num_targets;
+    bool done;
+} fanout_branch_t;
+static void brcon(fanout_branch_t *p)
+{
+    p->targets = NULL;
+    p->num_targets = 0;
+    p->done = false;
+}
+static void brdes(fanout_branch_t *p)
+{
+    if (NULL != p->targets) {
+        free(p->targets);
+    }
+}
+static OBJ_CLASS_INSTANCE(fanout_branch_t,
+                          opal_list_item_t,
+                          brcon, brdes);
+
+/* one request being relayed - all of this runs in the RML thread */
+typedef struct {
+    opal_list_item_t super;
+    uint32_t id;
+    /* who asked, and the id they know the request by */
+    orte_process_name_t parent;
+    uint32_t parent_id;
+    opal_list_t branches;
+    int outstanding;
+    /* merged per-target records, kept packed as they will be sent */
+    opal_buffer_t records;
+    int32_t num_records;
+    opal_event_t timer;
+    bool timer_active;
+} fanout_request_t;
+static void rqcon(fanout_request_t *p)
+{
+    p->id = 0;
+    /* answered with even if the request cannot be unpacked */
+    p->parent_id = 0;
+    OBJ_CONSTRUCT(&p->branches, opal_list_t);
+    p->outstanding = 0;
+    OBJ_CONSTRUCT(&p->records, opal_buffer_t);
+    p->num_records = 0;
+    p->timer_active = false;
+}
+static void rqdes(fanout_request_t *p)
+{
+    if (p->timer_active) {
+        opal_event_evtimer_del(&p->timer);
+    }
+    OPAL_LIST_DESTRUCT(&p->branches);
+    OBJ_DESTRUCT(&p->records);
+}
+static OBJ_CLASS_INSTANCE(fanout_request_t,
+                          opal_list_item_t,
+                          rqcon, rqdes);
+
+static void rpcon(orcm_fanout_reply_t *p)
+{
+    p->hostname = NULL;
+    p->status = ORCM_SUCCESS;
+    p->data = NULL;
+}
+static void rpdes(orcm_fanout_reply_t *p)
+{
+    if (NULL != p->hostname) {
+        free(p->hostname);
+    }
+    if (NULL != p->data) {
+        OBJ_RELEASE(p->data);
+    }
+}
+OBJ_CLASS_INSTANCE(orcm_fanout_reply_t,
+                   opal_list_item_t,
+                   rpcon, rpdes);
+
+static opal_list_t handlers;
+static bool handlers_init = false;
+static opal_list_t requests;
+static bool fanout_active = false;
+static uint32_t next_id = 0;
+
+static int add_record(fanout_request_t *req, orte_process_name_t *node,
+                      int status, opal_buffer_t *data)
+{
+    opal_buffer_t empty;
+    opal_buffer_t *bptr;
+    int rc;
+
+    OBJ_CONSTRUCT(&empty, opal_buffer_t);
+    bptr = (NULL == data) ? &empty : data;
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(&req->records, node, 1, ORTE_NAME)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(&req->records, &status, 1, OPAL_INT)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(&req->records, &bptr, 1, OPAL_BUFFER))) {
+        ORTE_ERROR_LOG(rc);
+    } else {
+        req->num_records++;
+    }
+    OBJ_DESTRUCT(&empty);
+    return rc;
+}
+
+static void run_local(fanout_request_t *req, orte_rml_tag_t tag,
+                      opal_buffer_t *payload)
+{
+    fanout_handler_t *h;
+    opal_buffer_t request, *reply;
+    int status = ORCM_ERR_NOT_SUPPORTED;
+
+    if (handlers_init) {
+        OPAL_LIST_FOREACH(h, &handlers, fanout_handler_t) {
+            if (h->tag != tag) {
+                continue;
+            }
+            /* the handler consumes its copy, the payload may
+             * still be needed for the other branches */
+            OBJ_CONSTRUCT(&request, opal_buffer_t);
+            reply = OBJ_NEW(opal_buffer_t);
+            if (OPAL_SUCCESS == (status = opal_dss.copy_payload(&request, payload))) {
+                status = h->fn(&request, reply);
+            }
+            OBJ_DESTRUCT(&request);
+            if (ORCM_SUCCESS == status) {
+                add_record(req, ORTE_PROC_MY_NAME, status, reply);
+            }
+            OBJ_RELEASE(reply);
+            break;
+        }
+    }
+    if (ORCM_SUCCESS != status) {
+        add_record(req, ORTE_PROC_MY_NAME, status, NULL);
+    }
+}
+
+static void fanout_respond(fanout_request_t *req)
+{
+    opal_buffer_t *ans;
+    uint8_t flag = FANOUT_REPLY;
+    int rc;
+
+    ans = OBJ_NEW(opal_buffer_t);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(ans, &flag, 1, OPAL_UINT8)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(ans, &req->parent_id, 1, OPAL_UINT32)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(ans, &req->num_records, 1, OPAL_INT32)) ||
+        OPAL_SUCCESS != (rc = opal_dss.copy_payload(ans, &req->records))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(ans);
+    } else if (ORTE_SUCCESS != (rc = orte_rml.send_buffer_nb(&req->parent, ans,
+                                                             ORCM_RML_TAG_FANOUT,
+                                                             orte_rml_send_callback,
+                                                             NULL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(ans);
+    }
+    opal_list_remove_item(&requests, &req->super);
+    OBJ_RELEASE(req);
+}
+
+/* account for every target below a hop that has not answered */
+static void fanout_timeout(int fd, short args, void *cbdata)
+{
+    fanout_request_t *req = (fanout_request_t*)cbdata;
+    fanout_branch_t *br;
+    int32_t i;
+
+    req->timer_active = false;
+    OPAL_LIST_FOREACH(br, &req->branches, fanout_branch_t) {
+        if (br->done) {
+            continue;
+        }
+        opal_output_verbose(1, orcm_debug_output,
+                            "%s fanout request %u: no answer from %s for %d nodes",
+                            ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), req->id,
+                            ORTE_NAME_PRINT(&br->hop), (int)br->num_targets);
+        for (i = 0; i < br->num_targets; i++) {
+            add_record(req, &br->targets[i], ORCM_ERR_TIMEOUT, NULL);
+        }
+        br->done = true;
+    }
+    fanout_respond(req);
+}
+
+/* requests only ever travel down the tree */
+static bool is_unreachable(orte_process_name_t *hop, orte_process_name_t *sender)
+{
+    if (ORTE_VPID_INVALID == hop->vpid ||
+        OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL, hop, ORTE_PROC_MY_NAME) ||
+        OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL, hop, sender)) {
+        return true;
+    }
+    if (!ORTE_PROC_IS_SCHEDULER &&
+        OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL, hop, ORTE_PROC_MY_PARENT)) {
+        return true;
+    }
+    return false;
+}
+
+static fanout_branch_t* get_branch(fanout_request_t *req, orte_process_name_t *hop,
+                                   int32_t max_targets)
+{
+    fanout_branch_t *br;
+
+    OPAL_LIST_FOREACH(br, &req->branches, fanout_branch_t) {
+        if (OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL, &br->hop, hop)) {
+            return br;
+        }
+    }
+    br = OBJ_NEW(fanout_branch_t);
+    br->hop = *hop;
+    br->targets = (orte_process_name_t*)malloc(max_targets * sizeof(orte_process_name_t));
+    if (NULL == br->targets) {
+        OBJ_RELEASE(br);
+        return NULL;
+    }
+    opal_list_append(&req->branches, &br->super);
+    return br;
+}
+
+static int pack_request(opal_buffer_t *msg, uint32_t id, orte_rml_tag_t tag,
+                        int32_t timeout_ms, orte_process_name_t *targets,
+                        int32_t num_targets, opal_buffer_t *payload)
+{
+    uint8_t flag = FANOUT_REQUEST;
+    int rc;
+
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(msg, &flag, 1, OPAL_UINT8)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(msg, &id, 1, OPAL_UINT32)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(msg, &tag, 1, ORTE_RML_TAG_T)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(msg, &timeout_ms, 1, OPAL_INT32)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(msg, &num_targets, 1, OPAL_INT32))) {
+        return rc;
+    }
+    if (0 < num_targets &&
+        OPAL_SUCCESS != (rc = opal_dss.pack(msg, targets, num_targets, ORTE_NAME))) {
+        return rc;
+    }
+    return opal_dss.copy_payload(msg, payload);
+}
+
+static void fanout_request(orte_process_name_t *sender, opal_buffer_t *buffer)
+{
+    fanout_request_t *req;
+    fanout_branch_t *br;
+    orte_process_name_t *targets = NULL, hop;
+    orte_rml_tag_t tag;
+    int32_t timeout_ms, num_targets, i;
+    opal_buffer_t payload, *msg;
+    struct timeval tv;
+    int cnt = 1, rc;
+
+    req = OBJ_NEW(fanout_request_t);
+    req->id = ++next_id;
+    req->parent = *sender;
+    opal_list_append(&requests, &req->super);
+
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &req->parent_id, &cnt, OPAL_UINT32)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &tag, &cnt, ORTE_RML_TAG_T)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &timeout_ms, &cnt, OPAL_INT32)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &num_targets, &cnt, OPAL_INT32))) {
+        ORTE_ERROR_LOG(rc);
+        fanout_respond(req);
+        return;
+    }
+    if (0 < num_targets) {
+        targets = (orte_process_name_t*)malloc(num_targets * sizeof(orte_process_name_t));
+        if (NULL == targets) {
+            ORTE_ERROR_LOG(ORCM_ERR_OUT_OF_RESOURCE);
+            fanout_respond(req);
+            return;
+        }
+        cnt = num_targets;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, targets, &cnt, ORTE_NAME)) ||
+            cnt != num_targets) {
+            ORTE_ERROR_LOG((OPAL_SUCCESS != rc) ? rc : ORCM_ERR_UNPACK_FAILURE);
+            free(targets);
+            fanout_respond(req);
+            return;
+        }
+    }
+    /* whatever is left is the command itself */
+    OBJ_CONSTRUCT(&payload, opal_buffer_t);
+    opal_dss.copy_payload(&payload, buffer);
+
+    /* sort the targets by the hop they are reached through */
+    for (i = 0; i < num_targets; i++) {
+        if (OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL, &targets[i],
+                                                        ORTE_PROC_MY_NAME)) {
+            run_local(req, tag, &payload);
+            continue;
+        }
+        hop = orte_routed.get_route(&targets[i]);
+        if (is_unreachable(&hop, sender)) {
+            add_record(req, &targets[i], ORCM_ERR_UNREACH, NULL);
+            continue;
+        }
+        if (NULL == (br = get_branch(req, &hop, num_targets))) {
+            add_record(req, &targets[i], ORCM_ERR_OUT_OF_RESOURCE, NULL);
+            continue;
+        }
+        br->targets[br->num_targets++] = targets[i];
+    }
+    if (NULL != targets) {
+        free(targets);
+    }
+
+    OPAL_LIST_FOREACH(br, &req->branches, fanout_branch_t) {
+        msg = OBJ_NEW(opal_buffer_t);
+        if (ORCM_SUCCESS != (rc = pack_request(msg, req->id, tag,
+                                               FANOUT_CHILD_SHARE(timeout_ms),
+                                               br->targets, br->num_targets,
+                                               &payload)) ||
+            ORTE_SUCCESS != (rc = orte_rml.send_buffer_nb(&br->hop, msg,
+                                                          ORCM_RML_TAG_FANOUT,
+                                                          orte_rml_send_callback,
+                                                          NULL))) {
+            ORTE_ERROR_LOG(rc);
+            OBJ_RELEASE(msg);
+            for (i = 0; i < br->num_targets; i++) {
+                add_record(req, &br->targets[i], ORCM_ERR_UNREACH, NULL);
+            }
+            br->done = true;
+            continue;
+        }
+        req->outstanding++;
+    }
+    OBJ_DESTRUCT(&payload);
+
+    if (0 == req->outstanding) {
+        fanout_respond(req);
+        return;
+    }
+
+    OPAL_OUTPUT_VERBOSE((5, orcm_debug_output,
+                         "%s fanout request %u for tag %u relayed to %d hops",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), req->id,
+                         (unsigned int)tag, req->outstanding));
+
+    opal_event_evtimer_set(orte_event_base, &req->timer, fanout_timeout, req);
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms % 1000) * 1000;
+    opal_event_evtimer_add(&req->timer, &tv);
+    req->timer_active = true;
+}
+
+static void fanout_reply(orte_process_name_t *sender, opal_buffer_t *buffer)
+{
+    fanout_request_t *req;
+    fanout_branch_t *br;
+    uint32_t id;
+    int32_t num_records;
+    int cnt = 1, rc;
+
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &id, &cnt, OPAL_UINT32)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &num_records, &cnt, OPAL_INT32))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+    OPAL_LIST_FOREACH(req, &requests, fanout_request_t) {
+        if (req->id == id) {
+            break;
+        }
+    }
+    if (&req->super == opal_list_get_end(&requests)) {
+        /* a late answer to a request that already timed out */
+        return;
+    }
+    OPAL_LIST_FOREACH(br, &req->branches, fanout_branch_t) {
+        if (!br->done &&
+            OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL, &br->hop, sender)) {
+            break;
+        }
+    }
+    if (&br->super == opal_list_get_end(&req->branches)) {
+        return;
+    }
+
+    /* the child's records are already in the layout we send up */
+    if (OPAL_SUCCESS != (rc = opal_dss.copy_payload(&req->records, buffer))) {
+        ORTE_ERROR_LOG(rc);
+    } else {
+        req->num_records += num_records;
+    }
+    br->done = true;
+    if (0 == --req->outstanding) {
+        fanout_respond(req);
+    }
+}
+
+static void fanout_recv(int status, orte_process_name_t* sender,
+                        opal_buffer_t* buffer, orte_rml_tag_t tag,
+                        void* cbdata)
+{
+    uint8_t flag;
+    int cnt = 1, rc;
+
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &flag, &cnt, OPAL_UINT8))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+    if (FANOUT_REQUEST == flag) {
+        fanout_request(sender, buffer);
+    } else if (FANOUT_REPLY == flag) {
+        fanout_reply(sender, buffer);
+    }
+}
+
+int orcm_fanout_start(void)
+{
+    if (fanout_active) {
+        return ORCM_SUCCESS;
+    }
+    OBJ_CONSTRUCT(&requests, opal_list_t);
+    orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD, ORCM_RML_TAG_FANOUT,
+                            ORTE_RML_PERSISTENT, fanout_recv, NULL);
+    fanout_active = true;
+    return ORCM_SUCCESS;
+}
+
+void orcm_fanout_stop(void)
+{
+    if (fanout_active) {
+        orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_FANOUT);
+        OPAL_LIST_DESTRUCT(&requests);
+        fanout_active = false;
+    }
+    if (handlers_init) {
+        OPAL_LIST_DESTRUCT(&handlers);
+        handlers_init = false;
+    }
+}
+
+int orcm_fanout_register(orte_rml_tag_t tag, orcm_fanout_local_fn_t fn)
+{
+    fanout_handler_t *h;
+
+    if (!handlers_init) {
+        OBJ_CONSTRUCT(&handlers, opal_list_t);
+        handlers_init = true;
+    }
+    OPAL_LIST_FOREACH(h, &handlers, fanout_handler_t) {
+        if (h->tag == tag) {
+            if (NULL == fn) {
+                opal_list_remove_item(&handlers, &h->super);
+                OBJ_RELEASE(h);
+            } else {
+                h->fn = fn;
+            }
+            return ORCM_SUCCESS;
+        }
+    }
+    if (NULL != fn) {
+        h = OBJ_NEW(fanout_handler_t);
+        h->tag = tag;
+        h->fn = fn;
+        opal_list_append(&handlers, &h->super);
+    }
+    return ORCM_SUCCESS;
+}
+
+/* a tool has at most one request out at a time - it lives here so
+ * that an answer arriving after we gave up finds nothing to write to */
+static struct {
+    volatile bool active;
+    uint32_t id;
+    int status;
+    opal_buffer_t data;
+    opal_event_t timer;
+} waiting;
+
+/* both of these run in the progress thread */
+static void send_timeout(int fd, short args, void *cbdata)
+{
+    if (!waiting.active) {
+        return;
+    }
+    waiting.status = ORCM_ERR_TIMEOUT;
+    waiting.active = false;
+}
+
+static void send_recv(int status, orte_process_name_t* sender,
+                      opal_buffer_t* buffer, orte_rml_tag_t tag,
+                      void* cbdata)
+{
+    uint8_t flag;
+    uint32_t id;
+    int cnt = 1, rc;
+
+    if (!waiting.active) {
+        return;
+    }
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &flag, &cnt, OPAL_UINT8)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buffer, &id, &cnt, OPAL_UINT32))) {
+        ORTE_ERROR_LOG(rc);
+        return;
+    }
+    /* ignore the leftovers of an earlier request that timed out */
+    if (FANOUT_REPLY != flag || id != waiting.id) {
+        return;
+    }
+    opal_event_evtimer_del(&waiting.timer);
+    waiting.status = opal_dss.copy_payload(&waiting.data, buffer);
+    waiting.active = false;
+}
+
+static uint64_t name_key(orte_process_name_t *name)
+{
+    return ((uint64_t)name->jobid << 32) | (uint64_t)name->vpid;
+}
+
+int orcm_fanout_send(orte_rml_tag_t tag, orte_process_name_t *targets,
+                     int32_t num_targets, opal_buffer_t *payload,
+                     int timeout, opal_list_t *replies)
+{
+    opal_buffer_t *msg;
+    opal_hash_table_t positions;
+    orcm_fanout_reply_t *rep, **slots;
+    int32_t *next;
+    int32_t num_records, i, j;
+    struct timeval tv;
+    void *ptr;
+    int cnt = 1, rc;
+
+    if (NULL == targets || 0 >= num_targets || NULL == payload || NULL == replies) {
+        return ORCM_ERR_BAD_PARAM;
+    }
+    if (0 >= timeout) {
+        timeout = ORCM_FANOUT_DEFAULT_TIMEOUT;
+    }
+
+    /* the scheduler gets the same share of our time as any other hop
+     * gives its children, so its partial answer beats our own timer */
+    msg = OBJ_NEW(opal_buffer_t);
+    if (ORCM_SUCCESS != (rc = pack_request(msg, ++next_id, tag,
+                                           FANOUT_CHILD_SHARE(timeout * 1000),
+                                           targets, num_targets, payload))) {
+        OBJ_RELEASE(msg);
+        return rc;
+    }
+
+    OBJ_CONSTRUCT(&waiting.data, opal_buffer_t);
+    waiting.id = next_id;
+    waiting.status = ORCM_SUCCESS;
+    waiting.active = true;
+    orte_rml.recv_buffer_nb(ORTE_NAME_WILDCARD, ORCM_RML_TAG_FANOUT,
+                            ORTE_RML_PERSISTENT, send_recv, NULL);
+    /* arm the timer first - the answer may beat us back from the send */
+    opal_event_evtimer_set(orte_event_base, &waiting.timer, send_timeout, NULL);
+    tv.tv_sec = timeout;
+    tv.tv_usec = 0;
+    opal_event_evtimer_add(&waiting.timer, &tv);
+    if (ORTE_SUCCESS != (rc = orte_rml.send_buffer_nb(ORTE_PROC_MY_SCHEDULER, msg,
+                                                      ORCM_RML_TAG_FANOUT,
+                                                      orte_rml_send_callback, NULL))) {
+        waiting.active = false;
+        opal_event_evtimer_del(&waiting.timer);
+        OBJ_RELEASE(msg);
+        orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_FANOUT);
+        OBJ_DESTRUCT(&waiting.data);
+        return rc;
+    }
+    ORTE_WAIT_FOR_COMPLETION(waiting.active);
+    orte_rml.recv_cancel(ORTE_NAME_WILDCARD, ORCM_RML_TAG_FANOUT);
+
+    if (ORCM_SUCCESS != (rc = waiting.status) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(&waiting.data, &num_records, &cnt, OPAL_INT32))) {
+        OBJ_DESTRUCT(&waiting.data);
+        return rc;
+    }
+
+    /* index the targets by name so each record drops straight into
+     * its slot. A name listed more than once links to its next
+     * position, and each record fills the first free one */
+    slots = (orcm_fanout_reply_t**)calloc(num_targets, sizeof(orcm_fanout_reply_t*));
+    next = (int32_t*)malloc(num_targets * sizeof(int32_t));
+    if (NULL == slots || NULL == next) {
+        free(slots);
+        free(next);
+        OBJ_DESTRUCT(&waiting.data);
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    OBJ_CONSTRUCT(&positions, opal_hash_table_t);
+    opal_hash_table_init(&positions, num_targets);
+    for (i = num_targets - 1; 0 <= i; i--) {
+        next[i] = -1;
+        if (OPAL_SUCCESS == opal_hash_table_get_value_uint64(&positions,
+                                                             name_key(&targets[i]), &ptr)) {
+            next[i] = (int32_t)((intptr_t)ptr - 1);
+        }
+        opal_hash_table_set_value_uint64(&positions, name_key(&targets[i]),
+                                         (void*)(intptr_t)(i + 1));
+    }
+
+    for (i = 0; i < num_records; i++) {
+        rep = OBJ_NEW(orcm_fanout_reply_t);
+        cnt = 1;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(&waiting.data, &rep->node, &cnt, ORTE_NAME)) ||
+            OPAL_SUCCESS != (rc = opal_dss.unpack(&waiting.data, &rep->status, &cnt, OPAL_INT)) ||
+            OPAL_SUCCESS != (rc = opal_dss.unpack(&waiting.data, &rep->data, &cnt, OPAL_BUFFER))) {
+            OBJ_RELEASE(rep);
+            break;
+        }
+        if (ORCM_SUCCESS != rep->status && NULL != rep->data) {
+            OBJ_RELEASE(rep->data);
+            rep->data = NULL;
+        }
+        j = -1;
+        if (OPAL_SUCCESS == opal_hash_table_get_value_uint64(&positions,
+                                                             name_key(&rep->node), &ptr)) {
+            j = (int32_t)((intptr_t)ptr - 1);
+            while (0 <= j && NULL != slots[j]) {
+                j = next[j];
+            }
+        }
+        if (0 > j) {
+            /* nobody asked for this one */
+            OBJ_RELEASE(rep);
+            continue;
+        }
+        slots[j] = rep;
+    }
+    OBJ_DESTRUCT(&positions);
+    OBJ_DESTRUCT(&waiting.data);
+
+    /* hand the results back in the order the caller gave */
+    for (i = 0; i < num_targets; i++) {
+        if (ORCM_SUCCESS == rc) {
+            if (NULL == (rep = slots[i])) {
+                rep = OBJ_NEW(orcm_fanout_reply_t);
+                rep->node = targets[i];
+                rep->status = ORCM_ERR_NOT_FOUND;
+            }
+            opal_list_append(replies, &rep->super);
+        } else if (NULL != slots[i]) {
+            OBJ_RELEASE(slots[i]);
+        }
+    }
+    free(slots);
+    free(next);
+    return rc;
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/** @file:
+ *
+ * Tree-based command fan-out with reply gather.
+ *
+ * A tool hands one request - a list of target daemons, the RML tag of
+ * the service to run and the command payload - to the scheduler. The
+ * scheduler and every aggregator below it split the target list by the
+ * next hop toward each target (as given by the routed module), forward
+ * one request per hop and, once every hop has answered or the timeout
+ * expires, return a single merged reply to their own parent. The
+ * targeted daemon runs the command through the handler its framework
+ * registered for the tag and answers with exactly what it would have
+ * sent back on that tag.
+ *
+ * Every target gets exactly one record in the merged reply, so nodes
+ * that could not be reached, were not listed in the routing tree or did
+ * not answer in time are reported with a status instead of being
+ * silently dropped.
+ */
+
+#ifndef ORCM_UTIL_FANOUT_H
+#define ORCM_UTIL_FANOUT_H
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#include "opal/class/opal_list.h"
+#include "opal/dss/dss_types.h"
+
+#include "orte/types.h"
+#include "orte/mca/rml/rml_types.h"
+
+BEGIN_C_DECLS
+
+/* default time, in seconds, the whole tree is given to answer */
+#define ORCM_FANOUT_DEFAULT_TIMEOUT 30
+
+/* run a command locally: unpack it from request and pack the answer
+ * into reply. A non-success return is reported as the node's status
+ * and the reply is discarded */
+typedef int (*orcm_fanout_local_fn_t)(opal_buffer_t *request,
+                                      opal_buffer_t *reply);
+
+/* the outcome for one target */
+typedef struct {
+    opal_list_item_t super;
+    orte_process_name_t node;
+    /* filled in by the caller - the fan-out only knows names */
+    char *hostname;
+    /* ORCM_SUCCESS if the command ran, otherwise why it did not */
+    int status;
+    /* the handler's answer, NULL unless status is ORCM_SUCCESS */
+    opal_buffer_t *data;
+} orcm_fanout_reply_t;
+ORCM_DECLSPEC OBJ_CLASS_DECLARATION(orcm_fanout_reply_t);
+
+/* daemons and the scheduler: relay requests and gather replies */
+ORCM_DECLSPEC int orcm_fanout_start(void);
+ORCM_DECLSPEC void orcm_fanout_stop(void);
+
+/* make the handler for a tag available to fanned-out requests.
+ * Passing NULL removes it */
+ORCM_DECLSPEC int orcm_fanout_register(orte_rml_tag_t tag,
+                                       orcm_fanout_local_fn_t fn);
+
+/* tools: send the payload to every target through the scheduler and
+ * block until the merged reply is back, or return ORCM_ERR_TIMEOUT if
+ * it is not back within timeout seconds. On success, replies holds one
+ * orcm_fanout_reply_t per target in the order given */
+ORCM_DECLSPEC int orcm_fanout_send(orte_rml_tag_t tag,
+                                   orte_process_name_t *targets,
+                                   int32_t num_targets,
+                                   opal_buffer_t *payload,
+                                   int timeout,
+                                   opal_list_t *replies);
+
+END_C_DECLS
+
+#endif /* ORCM_UTIL_FANOUT_H */
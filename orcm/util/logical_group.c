@@ -6,67 +6,85 @@
  *
  * $HEADER$
  */
+#include <limits.h>
+
 #include "orcm/util/logical_group.h"
 #include "orcm/constants.h"
 #include "orte/util/regex.h"
 #include "opal/mca/installdirs/installdirs.h"
 
+/* an ordered array of member ids */
+typedef struct {
+    int *ids;
+    int count;
+    int size;
+} orcm_logical_group_ids_t;
+
 /* Initialization the logical grouping */
 static int orcm_logical_group_init(char *config_file);
 
-/* whether the member to be added is already exist */
-static bool member_exist(opal_list_t *group_members, char *new_member);
+/* intern a member name, returning its id */
+static int orcm_logical_group_intern(char *member, int *o_id);
+
+/* the id of an interned member name */
+static bool orcm_logical_group_member_id(char *member, int *o_id);
+
+/* the set of the members named in an array of strings */
+static orcm_logical_group_members_t *orcm_logical_group_members_from_array(char **members);
 
 /* internal function to add members to a group */
 static int orcm_logical_group_add_internal(char *tag, char **new_members,
-                                           opal_list_t *group_members,
+                                           orcm_logical_group_members_t *group_members,
                                            opal_hash_table_t *io_groups);
 
 /* check if all the members do exist in a group */
-static int orcm_logical_group_all_members_exist_one_tag(opal_list_t *value, char **members);
+static int orcm_logical_group_all_members_exist_one_tag(orcm_logical_group_members_t *value,
+                                                        orcm_logical_group_members_t *members);
 
 /* check if all the members do exist in all groups */
 static int orcm_logical_group_all_members_exist_all_tags(opal_hash_table_t *groups,
-                                                         char **members);
+                                                         orcm_logical_group_members_t *members);
 
-/* remove members of a group in the hash table */
-static int orcm_logical_group_hash_table_remove_members(char *tag,
-                                                        opal_list_t *value,
-                                                        char **members,
-                                                        opal_hash_table_t *io_groups);
+/* release the members of all groups and empty the hash table */
+static void orcm_logical_group_release_all(opal_hash_table_t *io_groups);
 
 /* remove members of all groups */
-static int orcm_logical_group_remove_all_tags(char **members, int do_all_member,
+static int orcm_logical_group_remove_all_tags(orcm_logical_group_members_t *members,
+                                              int do_all_member,
                                               opal_hash_table_t *io_groups);
 
 /* remove members of a group */
-static int orcm_logical_group_remove_a_tag(char *tag, char **members, int do_all_member,
-                                           opal_hash_table_t *io_groups);
+static int orcm_logical_group_remove_a_tag(char *tag, orcm_logical_group_members_t *members,
+                                           int do_all_member, opal_hash_table_t *io_groups);
 
 /* internal function to remove members from groups */
 static int orcm_logical_group_remove_internal(char *tag, int do_all_tag,
-                                              char **members, int do_all_member,
+                                              orcm_logical_group_members_t *members,
+                                              int do_all_member,
                                               opal_hash_table_t *io_groups);
 
-/* find the specified members in the list of members */
-static opal_list_t *orcm_logical_group_list_specific_members(opal_list_t *value,
-                                                             char **members);
+/* find the specified members in the members of a group */
+static orcm_logical_group_members_t *
+orcm_logical_group_list_specific_members(orcm_logical_group_members_t *value,
+                                         orcm_logical_group_members_t *members);
 
 /* append a list of members to the member list that is an opal list */
 static int orcm_logical_group_list_append(char *memberlist, opal_list_t *members_list);
 
 /* list the members of all tags */
-static opal_hash_table_t* orcm_logical_group_list_all_tags(char **members, int do_all_member,
+static opal_hash_table_t* orcm_logical_group_list_all_tags(orcm_logical_group_members_t *members,
+                                                           int do_all_member,
                                                            opal_hash_table_t *groups);
 
 /* list the members of a tag */
-static opal_hash_table_t *orcm_logical_group_list_a_tag(char *tag, char **members,
+static opal_hash_table_t *orcm_logical_group_list_a_tag(char *tag,
+                                                        orcm_logical_group_members_t *members,
                                                         int do_all_member,
                                                         opal_hash_table_t *groups);
 
 /* internal function to list members of groups */
 static opal_hash_table_t *orcm_logical_group_list_internal(char *tag, int do_all_tag,
-                                                           char **members,
+                                                           orcm_logical_group_members_t *members,
                                                            int do_all_member,
                                                            opal_hash_table_t *groups);
 /* open the storage file with a specific mode */
@@ -104,19 +122,22 @@ static int orcm_logical_group_parsing(char *line_buf, opal_hash_table_t *io_grou
 /* pass the storage file */
 static int orcm_logical_group_parse_from_file(opal_hash_table_t *io_groups);
 
-/* combining multiple list item of members into one */
-static opal_list_t *orcm_logical_group_do_convertion(opal_list_t *members_list,
+/* combining multiple members into comma separated lists */
+static opal_list_t *orcm_logical_group_do_convertion(orcm_logical_group_members_t *members,
                                                      char *memberlist,
                                                      unsigned int reserved_size);
 
-/* concatenate multiple list item of members into one */
-static int orcm_logical_group_save_to_file_concat(char *tag, opal_list_t *members_list);
+/* concatenate multiple members into lines of the storage file */
+static int orcm_logical_group_save_to_file_concat(char *tag,
+                                                  orcm_logical_group_members_t *members);
 
 /* internal function to save the in-memory content to a storage file */
 static int orcm_logical_group_save_to_file_internal(opal_hash_table_t *groups);
 
-/* dereference a group name to an array of members */
-static int orcm_logical_group_tag_to_members_nested(char ***tag_array, char ***o_array_string);
+/* dereference group names to the ids of their members */
+static int orcm_logical_group_tag_to_members_nested(orcm_logical_group_ids_t *tags,
+                                                    orcm_logical_group_members_t *seen,
+                                                    orcm_logical_group_ids_t *o_ids);
 
 /* calculate the memory size of all the members in an array of string */
 static unsigned int orcm_logical_group_argv_addup_size(char **argv, int *count);
@@ -134,11 +155,256 @@ void logical_group_member_destruct(orcm_logical_group_member_t *member_item)
 OBJ_CLASS_INSTANCE(orcm_logical_group_member_t, opal_list_item_t,
                    logical_group_member_construct, logical_group_member_destruct);
 
-orcm_logical_group_t LOGICAL_GROUP = {NULL, NULL};
+static void logical_group_members_construct(orcm_logical_group_members_t *members)
+{
+    members->bits = NULL;
+    members->nwords = 0;
+    members->count = 0;
+}
+
+static void logical_group_members_destruct(orcm_logical_group_members_t *members)
+{
+    SAFEFREE(members->bits);
+}
+
+OBJ_CLASS_INSTANCE(orcm_logical_group_members_t, opal_object_t,
+                   logical_group_members_construct, logical_group_members_destruct);
+
+orcm_logical_group_t LOGICAL_GROUP = {NULL, NULL, NULL, NULL};
 char *current_tag = NULL;
 
 file_with_lock_t logical_group_file_lock = {NULL, -1, {F_RDLCK, SEEK_SET, 0, 0, 0}};
 
+#define MEMBER_WORD(id) ((id) / 64)
+#define MEMBER_BIT(id)  (((uint64_t)1) << ((id) % 64))
+
+static int members_reserve(orcm_logical_group_members_t *members, int nwords)
+{
+    uint64_t *bits = NULL;
+    int size = 0;
+
+    if (nwords <= members->nwords) {
+        return ORCM_SUCCESS;
+    }
+
+    /* grow geometrically so that adding ids in order stays linear */
+    size = (0 == members->nwords) ? 1 : members->nwords;
+    while (size < nwords) {
+        size *= 2;
+    }
+    if (NULL == (bits = (uint64_t*)realloc(members->bits, size * sizeof(uint64_t)))) {
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    memset(bits + members->nwords, 0, (size - members->nwords) * sizeof(uint64_t));
+    members->bits = bits;
+    members->nwords = size;
+
+    return ORCM_SUCCESS;
+}
+
+static int members_count_word(uint64_t word)
+{
+    int count = 0;
+
+    for (; 0 != word; count++) {
+        word &= word - 1;
+    }
+
+    return count;
+}
+
+static void members_recount(orcm_logical_group_members_t *members)
+{
+    int index = 0;
+
+    members->count = 0;
+    for (index = 0; index < members->nwords; index++) {
+        members->count += members_count_word(members->bits[index]);
+    }
+}
+
+static bool members_has(orcm_logical_group_members_t *members, int id)
+{
+    return (MEMBER_WORD(id) < members->nwords &&
+            0 != (members->bits[MEMBER_WORD(id)] & MEMBER_BIT(id)));
+}
+
+static int members_add(orcm_logical_group_members_t *members, int id)
+{
+    int erri = members_reserve(members, MEMBER_WORD(id) + 1);
+    if (ORCM_SUCCESS != erri) {
+        return erri;
+    }
+    if (0 == (members->bits[MEMBER_WORD(id)] & MEMBER_BIT(id))) {
+        members->bits[MEMBER_WORD(id)] |= MEMBER_BIT(id);
+        members->count++;
+    }
+
+    return ORCM_SUCCESS;
+}
+
+/* the first member id at or after id, or -1 if there is none */
+static int members_next(orcm_logical_group_members_t *members, int id)
+{
+    int index = MEMBER_WORD(id);
+    uint64_t word = 0;
+
+    if (index >= members->nwords) {
+        return -1;
+    }
+    /* drop the bits below id in its own word */
+    word = members->bits[index] & ~(MEMBER_BIT(id) - 1);
+    while (0 == word) {
+        if (++index >= members->nwords) {
+            return -1;
+        }
+        word = members->bits[index];
+    }
+    for (id = index * 64; 0 == (word & 1); id++) {
+        word >>= 1;
+    }
+
+    return id;
+}
+
+static orcm_logical_group_members_t *members_copy(orcm_logical_group_members_t *members)
+{
+    orcm_logical_group_members_t *copy = OBJ_NEW(orcm_logical_group_members_t);
+    if (NULL == copy) {
+        return NULL;
+    }
+    if (ORCM_SUCCESS != members_reserve(copy, members->nwords)) {
+        OBJ_RELEASE(copy);
+        return NULL;
+    }
+    if (0 < members->nwords) {
+        memcpy(copy->bits, members->bits, members->nwords * sizeof(uint64_t));
+    }
+    copy->count = members->count;
+
+    return copy;
+}
+
+static int ids_append(orcm_logical_group_ids_t *io_ids, int id)
+{
+    int *ids = NULL;
+    int size = 0;
+
+    if (io_ids->count == io_ids->size) {
+        size = (0 == io_ids->size) ? HASH_SIZE : 2 * io_ids->size;
+        if (NULL == (ids = (int*)realloc(io_ids->ids, size * sizeof(int)))) {
+            return ORCM_ERR_OUT_OF_RESOURCE;
+        }
+        io_ids->ids = ids;
+        io_ids->size = size;
+    }
+    io_ids->ids[io_ids->count++] = id;
+
+    return ORCM_SUCCESS;
+}
+
+static int orcm_logical_group_intern_init(void)
+{
+    if (NULL != LOGICAL_GROUP.member_ids) {
+        return ORCM_SUCCESS;
+    }
+
+    if (NULL == (LOGICAL_GROUP.member_ids = OBJ_NEW(opal_hash_table_t))) {
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    opal_hash_table_init(LOGICAL_GROUP.member_ids, HASH_SIZE);
+
+    if (NULL == (LOGICAL_GROUP.member_names = OBJ_NEW(opal_pointer_array_t))) {
+        OBJ_RELEASE(LOGICAL_GROUP.member_ids);
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    opal_pointer_array_init(LOGICAL_GROUP.member_names, HASH_SIZE, INT_MAX, HASH_SIZE);
+
+    return ORCM_SUCCESS;
+}
+
+static void orcm_logical_group_intern_finalize(void)
+{
+    int index = 0;
+
+    if (NULL == LOGICAL_GROUP.member_ids) {
+        return;
+    }
+
+    for (index = 0; index < opal_pointer_array_get_size(LOGICAL_GROUP.member_names); index++) {
+        free(opal_pointer_array_get_item(LOGICAL_GROUP.member_names, index));
+    }
+    OBJ_RELEASE(LOGICAL_GROUP.member_names);
+    opal_hash_table_remove_all(LOGICAL_GROUP.member_ids);
+    OBJ_RELEASE(LOGICAL_GROUP.member_ids);
+    LOGICAL_GROUP.member_names = NULL;
+    LOGICAL_GROUP.member_ids = NULL;
+}
+
+static bool orcm_logical_group_member_id(char *member, int *o_id)
+{
+    void *value = NULL;
+
+    if (NULL == LOGICAL_GROUP.member_ids ||
+        OPAL_SUCCESS != opal_hash_table_get_value_ptr(LOGICAL_GROUP.member_ids, member,
+                                                      strlen(member) + 1, &value)) {
+        return false;
+    }
+    *o_id = (int)(uintptr_t)value;
+
+    return true;
+}
+
+static char *orcm_logical_group_member_name(int id)
+{
+    return (char*)opal_pointer_array_get_item(LOGICAL_GROUP.member_names, id);
+}
+
+static int orcm_logical_group_intern(char *member, int *o_id)
+{
+    int erri = ORCM_SUCCESS;
+    char *name = NULL;
+
+    if (orcm_logical_group_member_id(member, o_id)) {
+        return ORCM_SUCCESS;
+    }
+    if (ORCM_SUCCESS != (erri = orcm_logical_group_intern_init())) {
+        return erri;
+    }
+
+    if (NULL == (name = strdup(member))) {
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    if (0 > (*o_id = opal_pointer_array_add(LOGICAL_GROUP.member_names, name))) {
+        free(name);
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+
+    return opal_hash_table_set_value_ptr(LOGICAL_GROUP.member_ids, name, strlen(name) + 1,
+                                         (void*)(uintptr_t)(*o_id));
+}
+
+static orcm_logical_group_members_t *orcm_logical_group_members_from_array(char **members)
+{
+    int index = -1;
+    int id = -1;
+    int count = opal_argv_count(members);
+    orcm_logical_group_members_t *set = OBJ_NEW(orcm_logical_group_members_t);
+
+    if (NULL == set) {
+        return NULL;
+    }
+    for (index = 0; index < count; index++) {
+        if (ORCM_SUCCESS != orcm_logical_group_intern(members[index], &id) ||
+            ORCM_SUCCESS != members_add(set, id)) {
+            OBJ_RELEASE(set);
+            return NULL;
+        }
+    }
+
+    return set;
+}
+
 static int orcm_logical_group_init(char *config_file)
 {
     int erri = ORCM_SUCCESS;
@@ -160,6 +426,10 @@ static int orcm_logical_group_init(char *config_file)
         return erri;
     }
 
+    if (ORCM_SUCCESS != (erri = orcm_logical_group_intern_init())) {
+        return erri;
+    }
+
     logical_group_file_lock.file_lock.l_pid = getpid();
 
     return erri;
@@ -168,9 +438,10 @@ static int orcm_logical_group_init(char *config_file)
 int orcm_logical_group_finalize()
 {
     if (NULL != LOGICAL_GROUP.groups) {
-        opal_hash_table_remove_all(LOGICAL_GROUP.groups);
+        orcm_logical_group_release_all(LOGICAL_GROUP.groups);
         OBJ_RELEASE(LOGICAL_GROUP.groups);
     }
+    orcm_logical_group_intern_finalize();
 
     SAFEFREE(LOGICAL_GROUP.storage_filename);
     SAFEFREE(current_tag);
@@ -179,12 +450,12 @@ int orcm_logical_group_finalize()
 }
 
 static int orcm_logical_group_hash_table_get(opal_hash_table_t *groups, char *tag,
-                                             opal_list_t **o_group_members)
+                                             orcm_logical_group_members_t **o_group_members)
 {
     int erri = opal_hash_table_get_value_ptr(groups, tag, strlen(tag) + 1,
                                              (void**)o_group_members);
     if (OPAL_ERR_NOT_FOUND == erri || NULL == *o_group_members) {
-        *o_group_members = OBJ_NEW(opal_list_t);
+        *o_group_members = OBJ_NEW(orcm_logical_group_members_t);
         if (NULL == *o_group_members) {
             return ORCM_ERR_OUT_OF_RESOURCE;
         }
@@ -193,24 +464,6 @@ static int orcm_logical_group_hash_table_get(opal_hash_table_t *groups, char *ta
     return ORCM_SUCCESS;
 }
 
-static bool member_exist(opal_list_t *group_members, char *new_member)
-{
-    bool exist = false;
-    orcm_logical_group_member_t *member_item = NULL;
-
-    OPAL_LIST_FOREACH(member_item, group_members, orcm_logical_group_member_t) {
-        if (NULL == member_item) {
-            break;
-        }
-        if (0 == strncmp(member_item->member, new_member, strlen(member_item->member) + 1)) {
-            exist = true;
-            break;
-        }
-    }
-
-    return exist;
-}
-
 static int orcm_logical_group_list_append(char *member, opal_list_t *member_list)
 {
     int erri = ORCM_SUCCESS;
@@ -230,19 +483,20 @@ static int orcm_logical_group_list_append(char *member, opal_list_t *member_list
 }
 
 static int orcm_logical_group_add_internal(char *tag, char **new_members,
-                                           opal_list_t *group_members,
+                                           orcm_logical_group_members_t *group_members,
                                            opal_hash_table_t *io_groups)
 {
     int index = -1;
+    int id = -1;
     int erri = ORCM_SUCCESS;
     int count = opal_argv_count(new_members);
 
     for (index = 0; index < count; index++) {
-        if (false == member_exist(group_members, new_members[index])) {
-            erri = orcm_logical_group_list_append(new_members[index], group_members);
-            if (ORCM_SUCCESS != erri) {
-                break;
-            }
+        if (ORCM_SUCCESS != (erri = orcm_logical_group_intern(new_members[index], &id))) {
+            break;
+        }
+        if (ORCM_SUCCESS != (erri = members_add(group_members, id))) {
+            break;
         }
     }
 
@@ -257,7 +511,7 @@ int orcm_logical_group_add(char *tag, char *regex, opal_hash_table_t *io_groups)
 {
     int erri = ORCM_SUCCESS;
     char **new_members = NULL;
-    opal_list_t *group_members = NULL;
+    orcm_logical_group_members_t *group_members = NULL;
 
     if (NULL == io_groups) {
         erri = ORCM_ERR_BAD_PARAM;
@@ -277,7 +531,8 @@ int orcm_logical_group_add(char *tag, char *regex, opal_hash_table_t *io_groups)
 
 cleanup:
     opal_argv_free(new_members);
-    if (ORCM_SUCCESS != erri && NULL != group_members) {
+    if (ORCM_SUCCESS != erri && NULL != group_members &&
+        group_members != orcm_logical_group_get_members(tag, io_groups)) {
         OBJ_RELEASE(group_members);
     }
     return erri;
@@ -294,14 +549,15 @@ static bool is_do_all_wildcard(char *text)
     return answer;
 }
 
-static int orcm_logical_group_all_members_exist_one_tag(opal_list_t *value, char **members)
+static int orcm_logical_group_all_members_exist_one_tag(orcm_logical_group_members_t *value,
+                                                        orcm_logical_group_members_t *members)
 {
     int index = -1;
-    bool exist = false;
-    int count = opal_argv_count(members);
+    uint64_t value_word = 0;
 
-    for (index = 0; index < count; index++) {
-        if (false == (exist = member_exist(value, members[index]))) {
+    for (index = 0; index < members->nwords; index++) {
+        value_word = (index < value->nwords) ? value->bits[index] : 0;
+        if (0 != (members->bits[index] & ~value_word)) {
             return ORCM_ERR_NODE_NOT_EXIST;
         }
     }
@@ -310,12 +566,12 @@ static int orcm_logical_group_all_members_exist_one_tag(opal_list_t *value, char
 }
 
 static int orcm_logical_group_all_members_exist_all_tags(opal_hash_table_t *groups,
-                                                         char **members)
+                                                         orcm_logical_group_members_t *members)
 {
     int erri = ORCM_SUCCESS;
     char *key = NULL;
     size_t key_size = 0;
-    opal_list_t *value = NULL;
+    orcm_logical_group_members_t *value = NULL;
     void *in_member = NULL;
     void *out_member = NULL;
 
@@ -332,45 +588,42 @@ static int orcm_logical_group_all_members_exist_all_tags(opal_hash_table_t *grou
     return erri;
 }
 
-static int orcm_logical_group_hash_table_remove_members(char *tag,
-                                                        opal_list_t *value,
-                                                        char **members,
-                                                        opal_hash_table_t *io_groups)
+static void orcm_logical_group_release_all(opal_hash_table_t *io_groups)
 {
-    int index = -1;
-    orcm_logical_group_member_t *member_item = NULL;
-    orcm_logical_group_member_t *next_member_item = NULL;
-    int count = opal_argv_count(members);
+    char *key = NULL;
+    size_t key_size = 0;
+    orcm_logical_group_members_t *value = NULL;
+    void *in_member = NULL;
+    void *out_member = NULL;
 
-    for (index = 0; index < count; index++) {
-        OPAL_LIST_FOREACH_SAFE(member_item, next_member_item, value, orcm_logical_group_member_t) {
-            if (0 == strncmp(members[index], member_item->member, strlen(members[index]) + 1)) {
-                opal_list_remove_item(value, &member_item->super);
-                OBJ_RELEASE(member_item);
-                break;
+    while (OPAL_SUCCESS == opal_hash_table_get_next_key_ptr(io_groups, (void**)&key,
+                                         &key_size, (void**)&value, in_member, &out_member)) {
+            if (NULL != value) {
+                OBJ_RELEASE(value);
             }
-        }
-    }
-
-    if (opal_list_is_empty(value)) {
-        return opal_hash_table_remove_value_ptr(io_groups, tag, strlen(tag) + 1);
+            in_member = out_member;
+            out_member = NULL;
     }
-
-    return opal_hash_table_set_value_ptr(io_groups, tag, strlen(tag) + 1, value);
+    opal_hash_table_remove_all(io_groups);
 }
 
-static int orcm_logical_group_remove_all_tags(char **members, int do_all_member,
+static int orcm_logical_group_remove_all_tags(orcm_logical_group_members_t *members,
+                                              int do_all_member,
                                               opal_hash_table_t *io_groups)
 {
     int erri = ORCM_SUCCESS;
+    int index = 0;
+    int count = 0;
     char *key = NULL;
     size_t key_size = 0;
-    opal_list_t *value = NULL;
+    char **emptied = NULL;
+    orcm_logical_group_members_t *value = NULL;
     void *in_member = NULL;
     void *out_member = NULL;
 
     if (do_all_member) {
-        return opal_hash_table_remove_all(io_groups);
+        orcm_logical_group_release_all(io_groups);
+        return ORCM_SUCCESS;
     }
 
     if (ORCM_SUCCESS !=
@@ -380,32 +633,52 @@ static int orcm_logical_group_remove_all_tags(char **members, int do_all_member,
 
     while (OPAL_SUCCESS == opal_hash_table_get_next_key_ptr(io_groups, (void**)&key,
                                          &key_size, (void**)&value, in_member, &out_member)) {
-            erri = orcm_logical_group_hash_table_remove_members(key, value, members, io_groups);
-            if (ORCM_SUCCESS != erri) {
-                return erri;
+            orcm_logical_group_members_subtract(value, members);
+            if (0 == value->count) {
+                /* the table can't be changed while walking it */
+                if (OPAL_SUCCESS != (erri = opal_argv_append_nosize(&emptied, key))) {
+                    break;
+                }
             }
             in_member = out_member;
             out_member = NULL;
     }
 
+    count = opal_argv_count(emptied);
+    for (index = 0; index < count; index++) {
+        if (OPAL_SUCCESS == opal_hash_table_get_value_ptr(io_groups, emptied[index],
+                                                          strlen(emptied[index]) + 1,
+                                                          (void**)&value)) {
+            opal_hash_table_remove_value_ptr(io_groups, emptied[index],
+                                             strlen(emptied[index]) + 1);
+            OBJ_RELEASE(value);
+        }
+    }
+    opal_argv_free(emptied);
+
     return erri;
 }
 
-static int orcm_logical_group_remove_a_tag(char *tag, char **members, int do_all_member,
-                                           opal_hash_table_t *io_groups)
+static int orcm_logical_group_remove_a_tag(char *tag, orcm_logical_group_members_t *members,
+                                           int do_all_member, opal_hash_table_t *io_groups)
 {
     int erri = ORCM_SUCCESS;
-    opal_list_t *value = NULL;
+    orcm_logical_group_members_t *value = NULL;
 
     if (OPAL_SUCCESS == (erri = opal_hash_table_get_value_ptr(io_groups, tag,
                                                       strlen(tag) + 1, (void**)&value))) {
-        if (do_all_member) {
-            return opal_hash_table_remove_value_ptr(io_groups, tag, strlen(tag) + 1);
+        if (!do_all_member) {
+            if (ORCM_SUCCESS !=
+                (erri = orcm_logical_group_all_members_exist_one_tag(value, members))) {
+                return erri;
+            }
+            orcm_logical_group_members_subtract(value, members);
         }
-        if (ORCM_SUCCESS != (erri = orcm_logical_group_all_members_exist_one_tag(value, members))) {
-            return erri;
+        if (do_all_member || 0 == value->count) {
+            erri = opal_hash_table_remove_value_ptr(io_groups, tag, strlen(tag) + 1);
+            OBJ_RELEASE(value);
         }
-        return orcm_logical_group_hash_table_remove_members(tag, value, members, io_groups);
+        return erri;
     }
 
     if (OPAL_ERR_NOT_FOUND == erri) {
@@ -416,7 +689,8 @@ static int orcm_logical_group_remove_a_tag(char *tag, char **members, int do_all
 }
 
 static int
-orcm_logical_group_remove_internal(char *tag, int do_all_tag, char **members,
+orcm_logical_group_remove_internal(char *tag, int do_all_tag,
+                                   orcm_logical_group_members_t *members,
                                    int do_all_member, opal_hash_table_t *io_groups)
 {
     if (do_all_tag) {
@@ -432,6 +706,7 @@ int orcm_logical_group_remove(char *tag, char *regex, opal_hash_table_t *io_grou
     int do_all_tag = 0;
     int do_all_member = 0;
     char **members = NULL;
+    orcm_logical_group_members_t *members_set = NULL;
 
     if (NULL == io_groups) {
         return ORCM_ERR_BAD_PARAM;
@@ -447,43 +722,38 @@ int orcm_logical_group_remove(char *tag, char *regex, opal_hash_table_t *io_grou
         if (ORTE_SUCCESS != erri) {
             goto cleanup;
         }
+        if (NULL == (members_set = orcm_logical_group_members_from_array(members))) {
+            erri = ORCM_ERR_OUT_OF_RESOURCE;
+            goto cleanup;
+        }
     }
 
-    erri = orcm_logical_group_remove_internal(tag, do_all_tag, members, do_all_member, io_groups);
+    erri = orcm_logical_group_remove_internal(tag, do_all_tag, members_set,
+                                              do_all_member, io_groups);
 
 cleanup:
     opal_argv_free(members);
+    if (NULL != members_set) {
+        OBJ_RELEASE(members_set);
+    }
 
     return erri;
 }
 
-static opal_list_t *
-orcm_logical_group_list_specific_members(opal_list_t *value, char **members)
+static orcm_logical_group_members_t *
+orcm_logical_group_list_specific_members(orcm_logical_group_members_t *value,
+                                         orcm_logical_group_members_t *members)
 {
-    int index = -1;
-    orcm_logical_group_member_t *member_item = NULL;
-    opal_list_t *new_value = NULL;
-    int count = opal_argv_count(members);
+    orcm_logical_group_members_t *new_value = NULL;
 
-    if (0 == count) {
+    if (0 == members->count) {
         return NULL;
     }
 
-    new_value = OBJ_NEW(opal_list_t);
+    new_value = members_copy(members);
     if (NULL != new_value) {
-        for (index = 0; index < count; index++) {
-            OPAL_LIST_FOREACH(member_item, value, orcm_logical_group_member_t) {
-                if (NULL == member_item) {
-                    return NULL;
-                }
-                if (0 == strncmp(members[index], member_item->member, strlen(members[index]) + 1)) {
-                    orcm_logical_group_list_append(member_item->member, new_value);
-                    break;
-                }
-            }
-        }
-
-        if (opal_list_is_empty(new_value)) {
+        orcm_logical_group_members_intersect(new_value, value);
+        if (0 == new_value->count) {
             OBJ_RELEASE(new_value);
         }
     }
@@ -492,13 +762,14 @@ orcm_logical_group_list_specific_members(opal_list_t *value, char **members)
 }
 
 static opal_hash_table_t*
-orcm_logical_group_list_all_tags(char **members, int do_all_member, opal_hash_table_t *groups)
+orcm_logical_group_list_all_tags(orcm_logical_group_members_t *members, int do_all_member,
+                                 opal_hash_table_t *groups)
 {
     opal_hash_table_t *o_groups = NULL;
     char *key = NULL;
     size_t key_size = 0;
-    opal_list_t *value = NULL;
-    opal_list_t *new_value = NULL;
+    orcm_logical_group_members_t *value = NULL;
+    orcm_logical_group_members_t *new_value = NULL;
     void *in_member = NULL;
     void *o_member = NULL;
 
@@ -524,13 +795,14 @@ orcm_logical_group_list_all_tags(char **members, int do_all_member, opal_hash_ta
     return o_groups;
 }
 
-static opal_hash_table_t *orcm_logical_group_list_a_tag(char *tag, char **members,
+static opal_hash_table_t *orcm_logical_group_list_a_tag(char *tag,
+                                                        orcm_logical_group_members_t *members,
                                                         int do_all_member,
                                                         opal_hash_table_t *groups)
 {
     opal_hash_table_t *o_groups = NULL;
-    opal_list_t *value = NULL;
-    opal_list_t *new_value = NULL;
+    orcm_logical_group_members_t *value = NULL;
+    orcm_logical_group_members_t *new_value = NULL;
 
     if (OPAL_SUCCESS == opal_hash_table_get_value_ptr(groups, tag,
                                                       strlen(tag) + 1, (void**)&value)) {
@@ -538,6 +810,7 @@ static opal_hash_table_t *orcm_logical_group_list_a_tag(char *tag, char **member
         if (NULL != o_groups) {
             opal_hash_table_init(o_groups, HASH_SIZE);
             if (do_all_member) {
+                OBJ_RETAIN(value);
                 opal_hash_table_set_value_ptr(o_groups, tag, strlen(tag) + 1, value);
             } else {
                 new_value = orcm_logical_group_list_specific_members(value, members);
@@ -552,7 +825,8 @@ static opal_hash_table_t *orcm_logical_group_list_a_tag(char *tag, char **member
 }
 
 static opal_hash_table_t *
-orcm_logical_group_list_internal(char *tag, int do_all_tag, char **members,
+orcm_logical_group_list_internal(char *tag, int do_all_tag,
+                                 orcm_logical_group_members_t *members,
                                  int do_all_member, opal_hash_table_t *groups)
 {
     if (do_all_tag) {
@@ -568,6 +842,7 @@ opal_hash_table_t *orcm_logical_group_list(char *tag, char *regex,
     int do_all_tag = 0;
     int do_all_member = 0;
     char **members = NULL;
+    orcm_logical_group_members_t *members_set = NULL;
     opal_hash_table_t *o_groups = NULL;
 
     if (NULL == groups) {
@@ -579,16 +854,137 @@ opal_hash_table_t *orcm_logical_group_list(char *tag, char *regex,
         if (ORTE_SUCCESS != orte_regex_extract_node_names(regex, &members)) {
             goto cleanup;
         }
+        if (NULL == (members_set = orcm_logical_group_members_from_array(members))) {
+            goto cleanup;
+        }
     }
 
     o_groups = orcm_logical_group_list_internal(tag, do_all_tag,
-                                                members, do_all_member, groups);
+                                                members_set, do_all_member, groups);
 
 cleanup:
     opal_argv_free(members);
+    if (NULL != members_set) {
+        OBJ_RELEASE(members_set);
+    }
     return o_groups;
 }
 
+void orcm_logical_group_list_release(opal_hash_table_t *o_groups, opal_hash_table_t *groups)
+{
+    if (NULL == o_groups || o_groups == groups) {
+        return;
+    }
+
+    orcm_logical_group_release_all(o_groups);
+    OBJ_RELEASE(o_groups);
+}
+
+orcm_logical_group_members_t *orcm_logical_group_get_members(char *tag,
+                                                             opal_hash_table_t *groups)
+{
+    orcm_logical_group_members_t *value = NULL;
+
+    if (NULL == tag || NULL == groups ||
+        OPAL_SUCCESS != opal_hash_table_get_value_ptr(groups, tag, strlen(tag) + 1,
+                                                      (void**)&value)) {
+        return NULL;
+    }
+
+    return value;
+}
+
+bool orcm_logical_group_members_contain(orcm_logical_group_members_t *members, char *member)
+{
+    int id = -1;
+
+    if (NULL == members || NULL == member) {
+        return false;
+    }
+
+    return orcm_logical_group_member_id(member, &id) && members_has(members, id);
+}
+
+int orcm_logical_group_members_union(orcm_logical_group_members_t *io_members,
+                                     orcm_logical_group_members_t *members)
+{
+    int erri = ORCM_SUCCESS;
+    int index = 0;
+
+    if (NULL == io_members || NULL == members) {
+        return ORCM_ERR_BAD_PARAM;
+    }
+    if (ORCM_SUCCESS != (erri = members_reserve(io_members, members->nwords))) {
+        return erri;
+    }
+
+    for (index = 0; index < members->nwords; index++) {
+        io_members->bits[index] |= members->bits[index];
+    }
+    members_recount(io_members);
+
+    return ORCM_SUCCESS;
+}
+
+int orcm_logical_group_members_intersect(orcm_logical_group_members_t *io_members,
+                                         orcm_logical_group_members_t *members)
+{
+    int index = 0;
+
+    if (NULL == io_members || NULL == members) {
+        return ORCM_ERR_BAD_PARAM;
+    }
+
+    for (index = 0; index < io_members->nwords; index++) {
+        io_members->bits[index] &= (index < members->nwords) ? members->bits[index] : 0;
+    }
+    members_recount(io_members);
+
+    return ORCM_SUCCESS;
+}
+
+int orcm_logical_group_members_subtract(orcm_logical_group_members_t *io_members,
+                                        orcm_logical_group_members_t *members)
+{
+    int index = 0;
+
+    if (NULL == io_members || NULL == members) {
+        return ORCM_ERR_BAD_PARAM;
+    }
+
+    for (index = 0; index < io_members->nwords && index < members->nwords; index++) {
+        io_members->bits[index] &= ~members->bits[index];
+    }
+    members_recount(io_members);
+
+    return ORCM_SUCCESS;
+}
+
+int orcm_logical_group_members_to_array_string(orcm_logical_group_members_t *members,
+                                               char ***o_array_string)
+{
+    int index = 0;
+    int id = -1;
+    char **array_string = NULL;
+
+    if (NULL == members || NULL == o_array_string) {
+        return ORCM_ERR_BAD_PARAM;
+    }
+
+    if (NULL == (array_string = (char**)calloc(members->count + 1, sizeof(char*)))) {
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    for (id = members_next(members, 0); 0 <= id; id = members_next(members, id + 1)) {
+        if (NULL == (array_string[index++] = strdup(orcm_logical_group_member_name(id)))) {
+            opal_argv_free(array_string);
+            return ORCM_ERR_OUT_OF_RESOURCE;
+        }
+    }
+    *o_array_string = array_string;
+
+    return ORCM_SUCCESS;
+}
+
 static int orcm_logical_group_is_comment(char *line)
 {
     if (NULL == line || '\0' == line[0] || '\n' == line[0] ||
@@ -821,37 +1217,46 @@ static int orcm_logical_group_load_from_file(char *storage_filename,
     return erri;
 }
 
-static opal_list_t *orcm_logical_group_do_convertion(opal_list_t *members_list,
+static opal_list_t *orcm_logical_group_do_convertion(orcm_logical_group_members_t *members,
                                                      char *memberlist,
                                                      unsigned int reserved_size)
 {
-    orcm_logical_group_member_t *member_item = NULL;
-    unsigned int current_size = 0;
-    int index = 0;
-    int count = opal_list_get_size(members_list);
+    char *member = NULL;
+    size_t current_size = 0;
+    size_t member_size = 0;
+    int id = -1;
     opal_list_t *new_members_list = OBJ_NEW(opal_list_t);
     if (NULL == new_members_list) {
         return NULL;
     }
 
-    OPAL_LIST_FOREACH(member_item, members_list, orcm_logical_group_member_t) {
-        index++;
-        current_size = strlen(memberlist);
-        if (reserved_size < current_size + strlen(member_item->member) + 1) {
+    for (id = members_next(members, 0); 0 <= id; id = members_next(members, id + 1)) {
+        member = orcm_logical_group_member_name(id);
+        member_size = strlen(member);
+        /* room for the comma and the terminating '\0' */
+        if (0 < current_size && reserved_size < current_size + member_size + 2) {
             if (ORCM_SUCCESS != orcm_logical_group_list_append(memberlist, new_members_list)) {
                 goto clean;
             }
-            memset(memberlist, '\0', strlen(memberlist));
-        }
-        if (0 < strlen(memberlist)) {
-            strncat(memberlist, ",", sizeof(char));
+            current_size = 0;
         }
-        strncat(memberlist, member_item->member, strlen(member_item->member));
-
-        if (index == count && 0 < strlen(memberlist)) {
-            if (ORCM_SUCCESS != orcm_logical_group_list_append(memberlist, new_members_list)) {
+        if (reserved_size < member_size + 1) {
+            /* too long to share a line with anything */
+            if (ORCM_SUCCESS != orcm_logical_group_list_append(member, new_members_list)) {
                 goto clean;
             }
+            continue;
+        }
+        if (0 < current_size) {
+            memberlist[current_size++] = ',';
+        }
+        memcpy(memberlist + current_size, member, member_size + 1);
+        current_size += member_size;
+    }
+
+    if (0 < current_size) {
+        if (ORCM_SUCCESS != orcm_logical_group_list_append(memberlist, new_members_list)) {
+            goto clean;
         }
     }
 
@@ -862,13 +1267,13 @@ clean:
     return NULL;
 }
 
-opal_list_t *orcm_logical_group_convert_members_list(opal_list_t *members_list,
+opal_list_t *orcm_logical_group_convert_members_list(orcm_logical_group_members_t *members,
                                                      unsigned int max_size)
 {
     char *memberlist = NULL;
     opal_list_t *o_members_list = NULL;
 
-    if (NULL == members_list || opal_list_is_empty(members_list) || 0 >= max_size) {
+    if (NULL == members || 0 == members->count || 0 >= max_size) {
         return NULL;
     }
 
@@ -877,16 +1282,17 @@ opal_list_t *orcm_logical_group_convert_members_list(opal_list_t *members_list,
         return NULL;
     }
 
-    o_members_list = orcm_logical_group_do_convertion(members_list, memberlist, max_size);
+    o_members_list = orcm_logical_group_do_convertion(members, memberlist, max_size);
     SAFEFREE(memberlist);
     return o_members_list;
 }
 
-static int orcm_logical_group_save_to_file_concat(char *tag, opal_list_t *members_list)
+static int orcm_logical_group_save_to_file_concat(char *tag,
+                                                  orcm_logical_group_members_t *members)
 {
     int erri = ORCM_SUCCESS;
     orcm_logical_group_member_t *regex = NULL;
-    opal_list_t *new_members_list = orcm_logical_group_convert_members_list(members_list,
+    opal_list_t *new_members_list = orcm_logical_group_convert_members_list(members,
                                                 MAX_LINE_LENGTH - strlen("member list="));
 
     if (NULL == tag || NULL == new_members_list) {
@@ -922,7 +1328,7 @@ static int orcm_logical_group_save_to_file_internal(opal_hash_table_t *groups)
     int ret = 0;
     char *key = NULL;
     size_t key_size = 0;
-    opal_list_t *value = NULL;
+    orcm_logical_group_members_t *value = NULL;
     void *in_member = NULL;
     void *out_member = NULL;
 
@@ -979,49 +1385,50 @@ int orcm_logical_group_save_to_file(char *storage_filename, opal_hash_table_t *g
     return erri;
 }
 
-static int orcm_logical_group_tag_to_members_nested(char ***tag_array, char ***o_array_string)
+static int orcm_logical_group_tag_to_members_nested(orcm_logical_group_ids_t *tags,
+                                                    orcm_logical_group_members_t *seen,
+                                                    orcm_logical_group_ids_t *o_ids)
 {
-    int count = -1;
+    int index = 0;
+    int id = -1;
     int erri = ORCM_SUCCESS;
-    orcm_logical_group_member_t *tag_member = NULL;
-    char *tag = NULL;
-    opal_list_t *value = NULL;
-    opal_list_t *nested_value = NULL;
-
-    count = opal_argv_count(*tag_array);
-    while (0 < count) {
-        tag = (*tag_array)[0];
-        if (ORCM_SUCCESS == (opal_hash_table_get_value_ptr(LOGICAL_GROUP.groups,
-                             (void*)tag, strlen(tag) + 1, (void**)&value))) {
-            if (NULL != value) {
-                OPAL_LIST_FOREACH(tag_member, value, orcm_logical_group_member_t) {
-                    if (NULL == tag_member) {
-                        break;
-                    }
-                    if (ORCM_SUCCESS == (opal_hash_table_get_value_ptr(LOGICAL_GROUP.groups,
-                        (void*)tag_member->member, strlen(tag_member->member) + 1,
-                        (void**)&nested_value))) {
-                        erri = opal_argv_append_unique_nosize(tag_array,
-                                                              tag_member->member, false);
-                        if (OPAL_SUCCESS != erri) {
-                            return erri;
-                        }
-                        count++;
-                    } else {
-                        erri = opal_argv_append_unique_nosize(o_array_string,
-                                                              tag_member->member, false);
-                        if (OPAL_SUCCESS != erri) {
-                            return erri;
-                        }
-                    }
+    char *member = NULL;
+    orcm_logical_group_members_t *value = NULL;
+    orcm_logical_group_members_t *expanded = OBJ_NEW(orcm_logical_group_members_t);
+
+    if (NULL == expanded) {
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+
+    /* nested groups are queued behind the others, and each group is expanded once */
+    for (index = 0; index < tags->count && ORCM_SUCCESS == erri; index++) {
+        if (members_has(expanded, tags->ids[index])) {
+            continue;
+        }
+        if (ORCM_SUCCESS != (erri = members_add(expanded, tags->ids[index]))) {
+            break;
+        }
+        value = orcm_logical_group_get_members(orcm_logical_group_member_name(tags->ids[index]),
+                                               LOGICAL_GROUP.groups);
+        if (NULL == value) {
+            continue;
+        }
+        for (id = members_next(value, 0); 0 <= id; id = members_next(value, id + 1)) {
+            member = orcm_logical_group_member_name(id);
+            if (NULL != orcm_logical_group_get_members(member, LOGICAL_GROUP.groups)) {
+                erri = ids_append(tags, id);
+            } else if (!members_has(seen, id)) {
+                if (ORCM_SUCCESS == (erri = members_add(seen, id))) {
+                    erri = ids_append(o_ids, id);
                 }
             }
-        }
-        if (OPAL_SUCCESS != (erri = opal_argv_delete(&count, tag_array, 0, 1))) {
-            return erri;
+            if (ORCM_SUCCESS != erri) {
+                break;
+            }
         }
     }
 
+    OBJ_RELEASE(expanded);
     return erri;
 }
 
@@ -1030,9 +1437,14 @@ int orcm_logical_group_parse_array_string(char *regex, char ***o_array_string)
     int erri = ORCM_SUCCESS;
     int size = 0;
     int index = 0;
+    int count = 0;
+    int id = -1;
     char *o_regex = NULL;
     char **regex_array = NULL;
-    char **tag_array = NULL;
+    char **array_string = NULL;
+    orcm_logical_group_ids_t tags = {NULL, 0, 0};
+    orcm_logical_group_ids_t ids = {NULL, 0, 0};
+    orcm_logical_group_members_t *seen = NULL;
 
     orcm_logical_group_trim_string(regex, &o_regex);
     if (NULL == o_regex || '\0' == *o_regex) {
@@ -1042,29 +1454,73 @@ int orcm_logical_group_parse_array_string(char *regex, char ***o_array_string)
     if (ORCM_SUCCESS != (erri = (orte_regex_extract_node_names(o_regex, &regex_array)))) {
         goto cleanup;
     }
+    if (NULL == (seen = OBJ_NEW(orcm_logical_group_members_t))) {
+        erri = ORCM_ERR_OUT_OF_RESOURCE;
+        goto cleanup;
+    }
+
+    /* items already in the output are not repeated */
+    count = opal_argv_count(*o_array_string);
+    for (index = 0; index < count; index++) {
+        if (ORCM_SUCCESS != (erri = orcm_logical_group_intern((*o_array_string)[index], &id)) ||
+            ORCM_SUCCESS != (erri = members_add(seen, id))) {
+            goto cleanup;
+        }
+    }
+
     size = opal_argv_count(regex_array);
     for (index = 0; index < size; index++) {
         o_regex = regex_array[index];
         if ('$' == *(regex_array[index])) {
             o_regex++;
-            erri = opal_argv_append_unique_nosize(&tag_array, o_regex, false);
-            if (OPAL_SUCCESS != erri) {
+            if (ORCM_SUCCESS != (erri = orcm_logical_group_intern(o_regex, &id)) ||
+                ORCM_SUCCESS != (erri = ids_append(&tags, id))) {
                 goto cleanup;
             }
         } else {
-            erri = opal_argv_append_unique_nosize(o_array_string, o_regex, false);
-            if (OPAL_SUCCESS != erri) {
+            if (ORCM_SUCCESS != (erri = orcm_logical_group_intern(o_regex, &id))) {
+                goto cleanup;
+            }
+            if (!members_has(seen, id)) {
+                if (ORCM_SUCCESS != (erri = members_add(seen, id)) ||
+                    ORCM_SUCCESS != (erri = ids_append(&ids, id))) {
+                    goto cleanup;
+                }
+            }
+        }
+    }
+    if (ORCM_SUCCESS != (erri = orcm_logical_group_tag_to_members_nested(&tags, seen, &ids))) {
+        goto cleanup;
+    }
+
+    if (0 < ids.count) {
+        array_string = (char**)realloc(*o_array_string,
+                                       (count + ids.count + 1) * sizeof(char*));
+        if (NULL == array_string) {
+            erri = ORCM_ERR_OUT_OF_RESOURCE;
+            goto cleanup;
+        }
+        *o_array_string = array_string;
+        for (index = 0; index < ids.count; index++) {
+            array_string[count + index + 1] = NULL;
+            array_string[count + index] = strdup(orcm_logical_group_member_name(ids.ids[index]));
+            if (NULL == array_string[count + index]) {
+                erri = ORCM_ERR_OUT_OF_RESOURCE;
                 goto cleanup;
             }
         }
     }
-    erri = orcm_logical_group_tag_to_members_nested(&tag_array, o_array_string);
 
 cleanup:
     opal_argv_free(regex_array);
-    opal_argv_free(tag_array);
+    SAFEFREE(tags.ids);
+    SAFEFREE(ids.ids);
+    if (NULL != seen) {
+        OBJ_RELEASE(seen);
+    }
     if (ORCM_SUCCESS != erri) {
         opal_argv_free(*o_array_string);
+        *o_array_string = NULL;
     }
     return erri;
 }
@@ -1088,6 +1544,8 @@ static int orcm_logical_group_arraystring_to_string(char **array_string, char **
     int erri = ORCM_SUCCESS;
     int index = 0;
     int count = 0;
+    size_t offset = 0;
+    size_t length = 0;
 
     if (0 == (size = orcm_logical_group_argv_addup_size(array_string, &count))) {
         return ORCM_ERR_BAD_PARAM;
@@ -1098,9 +1556,11 @@ static int orcm_logical_group_arraystring_to_string(char **array_string, char **
     }
 
     for (; index < count; index++) {
-        strncat(*string, array_string[index], strlen(array_string[index]));
+        length = strlen(array_string[index]);
+        memcpy(*string + offset, array_string[index], length);
+        offset += length;
         if (index != (count - 1)) {
-            strncat(*string, ",", sizeof(char));
+            (*string)[offset++] = ',';
         }
     }
 
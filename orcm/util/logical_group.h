@@ -13,6 +13,7 @@
 
 #include "opal/class/opal_list.h"
 #include "opal/class/opal_hash_table.h"
+#include "opal/class/opal_pointer_array.h"
 #include "orcm/util/utils.h"
 #include <fcntl.h>
 
@@ -30,13 +31,31 @@ typedef struct {
 void logical_group_member_construct(orcm_logical_group_member_t *member_item);
 void logical_group_member_destruct(orcm_logical_group_member_t *member_item);
 
+/* structure definition of the members of a group: every member name is
+ * interned to a small integer id, and bit <id> is set when that member
+ * belongs to the group */
+typedef struct {
+    opal_object_t super;
+    uint64_t *bits;
+    int nwords;
+    int count;
+} orcm_logical_group_members_t;
+
+ORCM_DECLSPEC OBJ_CLASS_DECLARATION(orcm_logical_group_members_t);
+
 /* structure definition of the logical grouping */
 typedef struct {
-    /* In-memory hash table: the key is the group name (tag), and the value is the list
-     * of orcm_logical_group_member_t.
+    /* In-memory hash table: the key is the group name (tag), and the value is the
+     * orcm_logical_group_members_t of the group.
      */
     opal_hash_table_t *groups;
 
+    /* Interned member names: the key is the name, and the value is its id */
+    opal_hash_table_t *member_ids;
+
+    /* Interned member names indexed by id */
+    opal_pointer_array_t *member_names;
+
     /* Persistent storage file name */
     char *storage_filename;
 } orcm_logical_group_t;
@@ -110,12 +129,43 @@ int orcm_logical_group_remove(char *tag, char *regex, opal_hash_table_t *io_grou
 /* list members from a group stored in hash table */
 opal_hash_table_t *orcm_logical_group_list(char *tag, char *regex, opal_hash_table_t *groups);
 
+/* release a hash table returned by orcm_logical_group_list */
+void orcm_logical_group_list_release(opal_hash_table_t *o_groups, opal_hash_table_t *groups);
+
 /* save the content of an in-memory hash table to the storage file */
 int orcm_logical_group_save_to_file(char *storage_filename, opal_hash_table_t *groups);
 
-opal_list_t *orcm_logical_group_convert_members_list(opal_list_t *members_list,
+/* split the members of a group into comma separated lists of at most max_size
+ * characters each, returned as a list of orcm_logical_group_member_t */
+opal_list_t *orcm_logical_group_convert_members_list(orcm_logical_group_members_t *members,
                                                      unsigned int max_size);
 
+/* Set operations on the members of groups */
+
+/* the members of a group stored in hash table, or NULL if there is no such group */
+ORCM_DECLSPEC orcm_logical_group_members_t *
+orcm_logical_group_get_members(char *tag, opal_hash_table_t *groups);
+
+/* whether a node is a member */
+ORCM_DECLSPEC bool orcm_logical_group_members_contain(orcm_logical_group_members_t *members,
+                                                      char *member);
+
+/* io_members becomes the union of io_members and members */
+ORCM_DECLSPEC int orcm_logical_group_members_union(orcm_logical_group_members_t *io_members,
+                                                   orcm_logical_group_members_t *members);
+
+/* io_members becomes the intersection of io_members and members */
+ORCM_DECLSPEC int orcm_logical_group_members_intersect(orcm_logical_group_members_t *io_members,
+                                                       orcm_logical_group_members_t *members);
+
+/* io_members loses every node in members */
+ORCM_DECLSPEC int orcm_logical_group_members_subtract(orcm_logical_group_members_t *io_members,
+                                                      orcm_logical_group_members_t *members);
+
+/* the names of the members as an array of strings */
+ORCM_DECLSPEC int orcm_logical_group_members_to_array_string(orcm_logical_group_members_t *members,
+                                                             char ***o_array_string);
+
 END_C_DECLS
 
 #endif
@@ -0,0 +1,1085 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "opal/dss/dss.h"
+#include "opal/util/argv.h"
+#include "opal/util/output.h"
+
+#include "orte/mca/errmgr/errmgr.h"
+#include "orte/mca/rml/rml.h"
+#include "orte/runtime/orte_globals.h"
+#include "orte/util/name_fns.h"
+
+#include "orcm/runtime/orcm_globals.h"
+#include "orcm/util/utils.h"
+#include "orcm/util/pubsub.h"
+
+/* longest subscription line accepted from a socket client */
+#define PUBSUB_MAX_FILTER_LINE 4096
+#define PUBSUB_READ_CHUNK      256
+/* seconds a socket client has to send that line */
+#define PUBSUB_SUBSCRIBE_TIMEOUT 30
+
+/* used to move completions back onto the subscriber's event base */
+typedef struct {
+    opal_object_t super;
+    opal_event_t ev;
+    orcm_pubsub_subscriber_t *sub;
+    int status;
+} pubsub_caddy_t;
+static OBJ_CLASS_INSTANCE(pubsub_caddy_t,
+                          opal_object_t,
+                          NULL, NULL);
+
+static void pubsub_flush(orcm_pubsub_subscriber_t *sub);
+static void pubsub_lost(orcm_pubsub_subscriber_t *sub);
+static void pubsub_socket_write(int sd, short args, void *cbdata);
+
+/****    FILTERS    ****/
+static int pack_argv(opal_buffer_t *buf, char **argv)
+{
+    int32_t n = opal_argv_count(argv);
+    int rc;
+
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(buf, &n, 1, OPAL_INT32))) {
+        return rc;
+    }
+    if (0 < n) {
+        rc = opal_dss.pack(buf, argv, n, OPAL_STRING);
+    }
+    return rc;
+}
+
+static int unpack_argv(opal_buffer_t *buf, char ***argv)
+{
+    int32_t n, i;
+    int cnt = 1;
+    char *str;
+    int rc;
+
+    *argv = NULL;
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buf, &n, &cnt, OPAL_INT32))) {
+        return rc;
+    }
+    for (i = 0; i < n; i++) {
+        cnt = 1;
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(buf, &str, &cnt, OPAL_STRING))) {
+            opal_argv_free(*argv);
+            *argv = NULL;
+            return rc;
+        }
+        opal_argv_append_nosize(argv, str);
+        free(str);
+    }
+    return ORCM_SUCCESS;
+}
+
+int orcm_pubsub_filter_pack(opal_buffer_t *buf, orcm_pubsub_filter_t *filter)
+{
+    int rc;
+
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(buf, &filter->kinds, 1, OPAL_UINT8))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = pack_argv(buf, filter->hosts))) {
+        return rc;
+    }
+    if (OPAL_SUCCESS != (rc = pack_argv(buf, filter->groups))) {
+        return rc;
+    }
+    return pack_argv(buf, filter->metrics);
+}
+
+int orcm_pubsub_filter_unpack(opal_buffer_t *buf, orcm_pubsub_filter_t **filter)
+{
+    orcm_pubsub_filter_t *f;
+    int cnt = 1;
+    int rc;
+
+    f = OBJ_NEW(orcm_pubsub_filter_t);
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buf, &f->kinds, &cnt, OPAL_UINT8)) ||
+        OPAL_SUCCESS != (rc = unpack_argv(buf, &f->hosts)) ||
+        OPAL_SUCCESS != (rc = unpack_argv(buf, &f->groups)) ||
+        OPAL_SUCCESS != (rc = unpack_argv(buf, &f->metrics))) {
+        OBJ_RELEASE(f);
+        return rc;
+    }
+    *filter = f;
+    return ORCM_SUCCESS;
+}
+
+/* a list of "*" (or nothing at all) means anything */
+static char** parse_list(const char *value)
+{
+    if (NULL == value || '\0' == *value || 0 == strcmp(value, "*")) {
+        return NULL;
+    }
+    return opal_argv_split(value, ',');
+}
+
+static int parse_kinds(const char *value, uint8_t *kinds)
+{
+    char **items;
+    int i;
+
+    *kinds = 0;
+    if (NULL == (items = parse_list(value))) {
+        *kinds = ORCM_PUBSUB_KIND_ALL;
+        return ORCM_SUCCESS;
+    }
+    for (i = 0; NULL != items[i]; i++) {
+        if (0 == strcmp(items[i], "samples") || 0 == strcmp(items[i], "sample")) {
+            *kinds |= ORCM_PUBSUB_KIND_SAMPLE;
+        } else if (0 == strcmp(items[i], "events") || 0 == strcmp(items[i], "event")) {
+            *kinds |= ORCM_PUBSUB_KIND_EVENT;
+        } else if (0 == strcmp(items[i], "all")) {
+            *kinds |= ORCM_PUBSUB_KIND_ALL;
+        } else {
+            opal_argv_free(items);
+            return ORCM_ERR_BAD_PARAM;
+        }
+    }
+    opal_argv_free(items);
+    return ORCM_SUCCESS;
+}
+
+int orcm_pubsub_filter_parse(const char *spec, orcm_pubsub_filter_t **filter)
+{
+    orcm_pubsub_filter_t *f;
+    char **tokens;
+    char *value;
+    int i, rc = ORCM_SUCCESS;
+
+    if (NULL == spec || NULL == filter) {
+        return ORCM_ERR_BAD_PARAM;
+    }
+
+    f = OBJ_NEW(orcm_pubsub_filter_t);
+    tokens = opal_argv_split(spec, ' ');
+    for (i = 0; NULL != tokens && NULL != tokens[i]; i++) {
+        /* tolerate CRLF line endings from tools */
+        tokens[i][strcspn(tokens[i], "\r\n")] = '\0';
+        if ('\0' == tokens[i][0]) {
+            continue;
+        }
+        if (NULL == (value = strchr(tokens[i], '='))) {
+            rc = ORCM_ERR_BAD_PARAM;
+            break;
+        }
+        *value++ = '\0';
+        if (0 == strcmp(tokens[i], "hosts")) {
+            opal_argv_free(f->hosts);
+            f->hosts = parse_list(value);
+        } else if (0 == strcmp(tokens[i], "groups")) {
+            opal_argv_free(f->groups);
+            f->groups = parse_list(value);
+        } else if (0 == strcmp(tokens[i], "metrics")) {
+            opal_argv_free(f->metrics);
+            f->metrics = parse_list(value);
+        } else if (0 == strcmp(tokens[i], "kinds")) {
+            if (ORCM_SUCCESS != (rc = parse_kinds(value, &f->kinds))) {
+                break;
+            }
+        } else {
+            rc = ORCM_ERR_BAD_PARAM;
+            break;
+        }
+    }
+    opal_argv_free(tokens);
+
+    if (ORCM_SUCCESS != rc || 0 == f->kinds) {
+        OBJ_RELEASE(f);
+        return ORCM_ERR_BAD_PARAM;
+    }
+    *filter = f;
+    return ORCM_SUCCESS;
+}
+
+/* exact match, or prefix match when the entry ends in '*' */
+static bool argv_match(char **argv, const char *str)
+{
+    size_t len;
+    int i;
+
+    if (NULL == argv) {
+        return true;
+    }
+    if (NULL == str) {
+        return false;
+    }
+    for (i = 0; NULL != argv[i]; i++) {
+        len = strlen(argv[i]);
+        if (0 < len && '*' == argv[i][len - 1]) {
+            if (0 == strncmp(argv[i], str, len - 1)) {
+                return true;
+            }
+        } else if (0 == strcmp(argv[i], str)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool orcm_pubsub_filter_match(orcm_pubsub_filter_t *filter, uint8_t kind,
+                              const char *host, const char *group)
+{
+    if (0 == (filter->kinds & kind)) {
+        return false;
+    }
+    return argv_match(filter->hosts, host) && argv_match(filter->groups, group);
+}
+
+bool orcm_pubsub_filter_match_metric(orcm_pubsub_filter_t *filter, const char *key)
+{
+    return argv_match(filter->metrics, key);
+}
+
+/****    RECORDS    ****/
+char* orcm_pubsub_value_to_string(opal_value_t *value)
+{
+    char *str = NULL;
+    int rc = 0;
+
+    switch (value->type) {
+    case OPAL_STRING:
+        str = strdup(NULL == value->data.string ? "" : value->data.string);
+        break;
+    case OPAL_BOOL:
+        str = strdup(value->data.flag ? "true" : "false");
+        break;
+    case OPAL_FLOAT:
+        rc = asprintf(&str, "%f", value->data.fval);
+        break;
+    case OPAL_DOUBLE:
+        rc = asprintf(&str, "%f", value->data.dval);
+        break;
+    case OPAL_INT:
+        rc = asprintf(&str, "%d", value->data.integer);
+        break;
+    case OPAL_INT8:
+        rc = asprintf(&str, "%d", (int)value->data.int8);
+        break;
+    case OPAL_INT16:
+        rc = asprintf(&str, "%d", (int)value->data.int16);
+        break;
+    case OPAL_INT32:
+        rc = asprintf(&str, "%" PRIi32, value->data.int32);
+        break;
+    case OPAL_INT64:
+        rc = asprintf(&str, "%" PRIi64, value->data.int64);
+        break;
+    case OPAL_UINT:
+        rc = asprintf(&str, "%u", value->data.uint);
+        break;
+    case OPAL_UINT8:
+        rc = asprintf(&str, "%u", (unsigned int)value->data.uint8);
+        break;
+    case OPAL_UINT16:
+        rc = asprintf(&str, "%u", (unsigned int)value->data.uint16);
+        break;
+    case OPAL_UINT32:
+        rc = asprintf(&str, "%" PRIu32, value->data.uint32);
+        break;
+    case OPAL_UINT64:
+        rc = asprintf(&str, "%" PRIu64, value->data.uint64);
+        break;
+    case OPAL_SIZE:
+        rc = asprintf(&str, "%lu", (unsigned long)value->data.size);
+        break;
+    case OPAL_PID:
+        rc = asprintf(&str, "%lu", (unsigned long)value->data.pid);
+        break;
+    case OPAL_TIMEVAL:
+        rc = asprintf(&str, "%ld.%06ld", (long)value->data.tv.tv_sec,
+                      (long)value->data.tv.tv_usec);
+        break;
+    default:
+        str = strdup("");
+        break;
+    }
+    if (0 > rc) {
+        return NULL;
+    }
+    return str;
+}
+
+int orcm_pubsub_record_pack(opal_buffer_t *buf, orcm_pubsub_record_t *rec,
+                            orcm_pubsub_filter_t *filter)
+{
+    orcm_value_t *val;
+    int32_t n = 0;
+    int64_t ts = (int64_t)rec->timestamp;
+    bool filtered;
+    int rc;
+
+    /* metric filters only apply to samples - an event is
+     * always delivered whole */
+    filtered = (NULL != filter && NULL != filter->metrics &&
+                ORCM_PUBSUB_KIND_SAMPLE == rec->kind);
+    OPAL_LIST_FOREACH(val, &rec->values, orcm_value_t) {
+        if (!filtered || orcm_pubsub_filter_match_metric(filter, val->value.key)) {
+            n++;
+        }
+    }
+    if (0 == n && ORCM_PUBSUB_KIND_SAMPLE == rec->kind) {
+        return ORCM_ERR_NOT_FOUND;
+    }
+
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(buf, &rec->kind, 1, OPAL_UINT8)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(buf, &rec->host, 1, OPAL_STRING)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(buf, &rec->group, 1, OPAL_STRING)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(buf, &ts, 1, OPAL_INT64)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(buf, &rec->severity, 1, OPAL_STRING)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(buf, &n, 1, OPAL_INT32))) {
+        return rc;
+    }
+    OPAL_LIST_FOREACH(val, &rec->values, orcm_value_t) {
+        if (filtered && !orcm_pubsub_filter_match_metric(filter, val->value.key)) {
+            continue;
+        }
+        if (OPAL_SUCCESS != (rc = opal_dss.pack(buf, &val->value.key, 1, OPAL_STRING)) ||
+            OPAL_SUCCESS != (rc = opal_dss.pack(buf, &val->value.data.string, 1, OPAL_STRING)) ||
+            OPAL_SUCCESS != (rc = opal_dss.pack(buf, &val->units, 1, OPAL_STRING))) {
+            return rc;
+        }
+    }
+    return ORCM_SUCCESS;
+}
+
+int orcm_pubsub_record_unpack(opal_buffer_t *buf, orcm_pubsub_record_t **rec)
+{
+    orcm_pubsub_record_t *r;
+    orcm_value_t *val;
+    int32_t n, i;
+    int64_t ts;
+    int cnt = 1;
+    int rc;
+
+    r = OBJ_NEW(orcm_pubsub_record_t);
+    if (OPAL_SUCCESS != (rc = opal_dss.unpack(buf, &r->kind, &cnt, OPAL_UINT8)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buf, &r->host, &cnt, OPAL_STRING)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buf, &r->group, &cnt, OPAL_STRING)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buf, &ts, &cnt, OPAL_INT64)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buf, &r->severity, &cnt, OPAL_STRING)) ||
+        OPAL_SUCCESS != (rc = opal_dss.unpack(buf, &n, &cnt, OPAL_INT32))) {
+        OBJ_RELEASE(r);
+        return rc;
+    }
+    r->timestamp = (time_t)ts;
+    for (i = 0; i < n; i++) {
+        val = OBJ_NEW(orcm_value_t);
+        val->value.type = OPAL_STRING;
+        opal_list_append(&r->values, &val->value.super);
+        if (OPAL_SUCCESS != (rc = opal_dss.unpack(buf, &val->value.key, &cnt, OPAL_STRING)) ||
+            OPAL_SUCCESS != (rc = opal_dss.unpack(buf, &val->value.data.string, &cnt, OPAL_STRING)) ||
+            OPAL_SUCCESS != (rc = opal_dss.unpack(buf, &val->units, &cnt, OPAL_STRING))) {
+            OBJ_RELEASE(r);
+            return rc;
+        }
+    }
+    *rec = r;
+    return ORCM_SUCCESS;
+}
+
+#define PUBSUB_STR(s) (NULL == (s) ? "" : (s))
+
+char* orcm_pubsub_record_to_csv(orcm_pubsub_record_t *rec)
+{
+    orcm_value_t *val;
+    char tbuf[32];
+    struct tm tm;
+    char *csv, *ptr;
+    size_t plen, size;
+    int n;
+
+    tbuf[0] = '\0';
+    if (NULL != localtime_r(&rec->timestamp, &tm)) {
+        strftime(tbuf, sizeof(tbuf), "%Y-%m-%d %H:%M:%S", &tm);
+    }
+
+    /* every line starts with the same four fields - size the whole
+     * record up front, write them once and copy them for each value */
+    plen = strlen(tbuf) + strlen(PUBSUB_STR(rec->host)) + strlen(PUBSUB_STR(rec->group)) +
+           strlen(PUBSUB_STR(rec->severity)) + 4;
+    size = plen + 4;
+    OPAL_LIST_FOREACH(val, &rec->values, orcm_value_t) {
+        size += plen + strlen(PUBSUB_STR(val->value.key)) +
+                strlen(PUBSUB_STR(val->value.data.string)) +
+                strlen(PUBSUB_STR(val->units)) + 3;
+    }
+    if (NULL == (csv = (char*)malloc(size))) {
+        return NULL;
+    }
+    n = snprintf(csv, size, "%s,%s,%s,%s,", tbuf, PUBSUB_STR(rec->host),
+                 PUBSUB_STR(rec->group), PUBSUB_STR(rec->severity));
+    if (0 > n || (size_t)n != plen) {
+        free(csv);
+        return NULL;
+    }
+    if (0 == opal_list_get_size(&rec->values)) {
+        strcpy(csv + plen, ",,\n");
+        return csv;
+    }
+
+    ptr = csv;
+    OPAL_LIST_FOREACH(val, &rec->values, orcm_value_t) {
+        if (ptr != csv) {
+            memcpy(ptr, csv, plen);
+        }
+        ptr += plen;
+        ptr += sprintf(ptr, "%s,%s,%s\n", PUBSUB_STR(val->value.key),
+                       PUBSUB_STR(val->value.data.string), PUBSUB_STR(val->units));
+    }
+    return csv;
+}
+
+/****    SUBSCRIBERS    ****/
+orcm_pubsub_subscriber_t* orcm_pubsub_subscriber_create(uint32_t id,
+                                                        orte_process_name_t *peer,
+                                                        orcm_pubsub_filter_t *filter,
+                                                        opal_event_base_t *evbase,
+                                                        int32_t max_pending,
+                                                        orcm_pubsub_subscriber_fn_t lost_fn)
+{
+    orcm_pubsub_subscriber_t *sub;
+
+    sub = OBJ_NEW(orcm_pubsub_subscriber_t);
+    sub->id = id;
+    if (NULL != peer) {
+        sub->peer = *peer;
+    }
+    /* we take ownership of the filter */
+    sub->filter = filter;
+    sub->evbase = evbase;
+    if (0 < max_pending) {
+        sub->max_pending = max_pending;
+    }
+    sub->lost_fn = lost_fn;
+    return sub;
+}
+
+orcm_pubsub_subscriber_t* orcm_pubsub_subscriber_find(opal_list_t *subscribers,
+                                                      orte_process_name_t *peer,
+                                                      uint32_t id)
+{
+    orcm_pubsub_subscriber_t *sub;
+
+    OPAL_LIST_FOREACH(sub, subscribers, orcm_pubsub_subscriber_t) {
+        if (id == sub->id &&
+            OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL, &sub->peer, peer)) {
+            return sub;
+        }
+    }
+    return NULL;
+}
+
+void orcm_pubsub_subscriber_enqueue(orcm_pubsub_subscriber_t *sub,
+                                    opal_buffer_t *records, int32_t num_records)
+{
+    orcm_pubsub_batch_t *batch;
+
+    if (sub->lost || NULL == records || 0 >= num_records) {
+        return;
+    }
+
+    /* live data is only useful while it is fresh - if the sink
+     * can't keep up, make room by discarding the oldest records */
+    while (0 < sub->num_pending && sub->max_pending < sub->num_pending + num_records) {
+        batch = (orcm_pubsub_batch_t*)opal_list_remove_first(&sub->pending);
+        sub->num_pending -= batch->num_records;
+        sub->dropped += batch->num_records;
+        OBJ_RELEASE(batch);
+    }
+
+    batch = OBJ_NEW(orcm_pubsub_batch_t);
+    OBJ_RETAIN(records);
+    batch->records = records;
+    batch->num_records = num_records;
+    opal_list_append(&sub->pending, &batch->super);
+    sub->num_pending += num_records;
+
+    pubsub_flush(sub);
+}
+
+static void pubsub_stop_socket(orcm_pubsub_subscriber_t *sub)
+{
+    if (sub->tev_active) {
+        opal_event_del(&sub->tev);
+        sub->tev_active = false;
+    }
+    if (sub->rev_active) {
+        opal_event_del(&sub->rev);
+        sub->rev_active = false;
+    }
+    if (sub->wev_active) {
+        opal_event_del(&sub->wev);
+        sub->wev_active = false;
+    }
+    if (0 <= sub->sd) {
+        close(sub->sd);
+        sub->sd = -1;
+    }
+}
+
+static void pubsub_shutdown(orcm_pubsub_subscriber_t *sub)
+{
+    sub->lost = true;
+    OPAL_LIST_DESTRUCT(&sub->pending);
+    OBJ_CONSTRUCT(&sub->pending, opal_list_t);
+    sub->num_pending = 0;
+    pubsub_stop_socket(sub);
+}
+
+void orcm_pubsub_subscriber_close(orcm_pubsub_subscriber_t *sub)
+{
+    pubsub_shutdown(sub);
+    /* the owner is dropping this subscriber itself, so a loss
+     * notification still in flight must not hand it back */
+    sub->accept_fn = NULL;
+    sub->lost_fn = NULL;
+}
+
+static void pubsub_lost_complete(int fd, short args, void *cbdata)
+{
+    pubsub_caddy_t *caddy = (pubsub_caddy_t*)cbdata;
+    orcm_pubsub_subscriber_t *sub = caddy->sub;
+
+    if (NULL == sub->filter) {
+        /* a socket client that never subscribed - the listener is the
+         * only owner, unless it already let go of it when closing */
+        if (NULL != sub->listener) {
+            opal_list_remove_item(&sub->listener->connecting, &sub->super);
+            sub->listener = NULL;
+            OBJ_RELEASE(sub);
+        }
+    } else if (NULL != sub->lost_fn) {
+        sub->lost_fn(sub);
+    }
+    OBJ_RELEASE(sub);
+    OBJ_RELEASE(caddy);
+}
+
+/* the sink went away - shut it down now, but let the owner
+ * know from a fresh event so it never has a subscriber pulled
+ * out from under it while walking its list */
+static void pubsub_lost(orcm_pubsub_subscriber_t *sub)
+{
+    pubsub_caddy_t *caddy;
+
+    if (sub->lost) {
+        return;
+    }
+    pubsub_shutdown(sub);
+
+    caddy = OBJ_NEW(pubsub_caddy_t);
+    OBJ_RETAIN(sub);
+    caddy->sub = sub;
+    opal_event_set(sub->evbase, &caddy->ev, -1, OPAL_EV_WRITE,
+                   pubsub_lost_complete, caddy);
+    opal_event_active(&caddy->ev, OPAL_EV_WRITE, 1);
+}
+
+static void pubsub_sent_complete(int fd, short args, void *cbdata)
+{
+    pubsub_caddy_t *caddy = (pubsub_caddy_t*)cbdata;
+    orcm_pubsub_subscriber_t *sub = caddy->sub;
+
+    sub->inflight = false;
+    if (ORTE_SUCCESS != caddy->status) {
+        pubsub_lost(sub);
+    } else {
+        pubsub_flush(sub);
+    }
+    OBJ_RELEASE(sub);
+    OBJ_RELEASE(caddy);
+}
+
+/* runs in the RML thread - move back to the subscriber's event base */
+static void pubsub_sent(int status, orte_process_name_t *peer,
+                        opal_buffer_t *buffer, orte_rml_tag_t tag,
+                        void *cbdata)
+{
+    orcm_pubsub_subscriber_t *sub = (orcm_pubsub_subscriber_t*)cbdata;
+    pubsub_caddy_t *caddy;
+
+    OBJ_RELEASE(buffer);
+
+    caddy = OBJ_NEW(pubsub_caddy_t);
+    caddy->sub = sub;
+    caddy->status = status;
+    opal_event_set(sub->evbase, &caddy->ev, -1, OPAL_EV_WRITE,
+                   pubsub_sent_complete, caddy);
+    opal_event_active(&caddy->ev, OPAL_EV_WRITE, 1);
+}
+
+/* send everything queued as a single message - under load the
+ * records coalesce while the previous message is in flight */
+static void pubsub_flush_rml(orcm_pubsub_subscriber_t *sub)
+{
+    orcm_pubsub_cmd_flag_t command = ORCM_PUBSUB_PUBLISH_COMMAND;
+    orcm_pubsub_batch_t *batch;
+    opal_buffer_t *msg;
+    uint64_t dropped = sub->dropped - sub->dropped_reported;
+    int32_t n = sub->num_pending;
+    int rc;
+
+    msg = OBJ_NEW(opal_buffer_t);
+    if (OPAL_SUCCESS != (rc = opal_dss.pack(msg, &command, 1, ORCM_PUBSUB_CMD_T)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(msg, &sub->id, 1, OPAL_UINT32)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(msg, &dropped, 1, OPAL_UINT64)) ||
+        OPAL_SUCCESS != (rc = opal_dss.pack(msg, &n, 1, OPAL_INT32))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(msg);
+        return;
+    }
+    while (NULL != (batch = (orcm_pubsub_batch_t*)opal_list_remove_first(&sub->pending))) {
+        opal_dss.copy_payload(msg, batch->records);
+        OBJ_RELEASE(batch);
+    }
+    sub->num_pending = 0;
+    sub->dropped_reported = sub->dropped;
+    sub->delivered += n;
+    sub->inflight = true;
+
+    OBJ_RETAIN(sub);
+    if (ORTE_SUCCESS != (rc = orte_rml.send_buffer_nb(&sub->peer, msg,
+                                                      ORCM_RML_TAG_PUBSUB,
+                                                      pubsub_sent, sub))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(msg);
+        sub->inflight = false;
+        pubsub_lost(sub);
+        OBJ_RELEASE(sub);
+    }
+}
+
+static int pubsub_append_output(orcm_pubsub_subscriber_t *sub, const char *str)
+{
+    size_t len = strlen(str);
+    char *tmp;
+
+    if (NULL == (tmp = realloc(sub->outbuf, sub->outlen + len + 1))) {
+        return ORCM_ERR_OUT_OF_RESOURCE;
+    }
+    sub->outbuf = tmp;
+    memcpy(sub->outbuf + sub->outlen, str, len + 1);
+    sub->outlen += len;
+    return ORCM_SUCCESS;
+}
+
+/* render everything queued as CSV and start writing it */
+static void pubsub_flush_socket(orcm_pubsub_subscriber_t *sub)
+{
+    orcm_pubsub_batch_t *batch;
+    orcm_pubsub_record_t *rec;
+    opal_buffer_t tmp;
+    char *line = NULL;
+    int32_t i;
+
+    if (sub->dropped > sub->dropped_reported) {
+        if (0 <= asprintf(&line, "#dropped,%" PRIu64 "\n",
+                          sub->dropped - sub->dropped_reported)) {
+            pubsub_append_output(sub, line);
+            SAFEFREE(line);
+        }
+        sub->dropped_reported = sub->dropped;
+    }
+
+    while (NULL != (batch = (orcm_pubsub_batch_t*)opal_list_remove_first(&sub->pending))) {
+        /* the packed records may be shared, so unpack from a copy */
+        OBJ_CONSTRUCT(&tmp, opal_buffer_t);
+        opal_dss.copy_payload(&tmp, batch->records);
+        for (i = 0; i < batch->num_records; i++) {
+            if (ORCM_SUCCESS != orcm_pubsub_record_unpack(&tmp, &rec)) {
+                break;
+            }
+            if (NULL != (line = orcm_pubsub_record_to_csv(rec))) {
+                pubsub_append_output(sub, line);
+                SAFEFREE(line);
+            }
+            OBJ_RELEASE(rec);
+        }
+        OBJ_DESTRUCT(&tmp);
+        sub->num_pending -= batch->num_records;
+        sub->delivered += batch->num_records;
+        OBJ_RELEASE(batch);
+    }
+
+    if (0 < sub->outlen) {
+        sub->inflight = true;
+        pubsub_socket_write(sub->sd, OPAL_EV_WRITE, sub);
+    }
+}
+
+static void pubsub_flush(orcm_pubsub_subscriber_t *sub)
+{
+    if (sub->lost || sub->inflight || 0 == sub->num_pending) {
+        return;
+    }
+    if (0 <= sub->sd) {
+        pubsub_flush_socket(sub);
+    } else {
+        pubsub_flush_rml(sub);
+    }
+}
+
+static void pubsub_socket_write(int sd, short args, void *cbdata)
+{
+    orcm_pubsub_subscriber_t *sub = (orcm_pubsub_subscriber_t*)cbdata;
+    ssize_t rc;
+
+    while (sub->outoff < sub->outlen) {
+        rc = send(sub->sd, sub->outbuf + sub->outoff,
+                  sub->outlen - sub->outoff, MSG_NOSIGNAL);
+        if (0 > rc) {
+            if (EINTR == errno) {
+                continue;
+            }
+            if (EAGAIN == errno || EWOULDBLOCK == errno) {
+                /* wait until the client drains its socket */
+                if (!sub->wev_active) {
+                    opal_event_add(&sub->wev, 0);
+                    sub->wev_active = true;
+                }
+                return;
+            }
+            pubsub_lost(sub);
+            return;
+        }
+        sub->outoff += rc;
+    }
+
+    SAFEFREE(sub->outbuf);
+    sub->outlen = 0;
+    sub->outoff = 0;
+    if (sub->wev_active) {
+        opal_event_del(&sub->wev);
+        sub->wev_active = false;
+    }
+    sub->inflight = false;
+    pubsub_flush(sub);
+}
+
+/* the client sends a single filter line, after which anything
+ * it sends is ignored - we only watch for it closing */
+static void pubsub_socket_read(int sd, short args, void *cbdata)
+{
+    orcm_pubsub_subscriber_t *sub = (orcm_pubsub_subscriber_t*)cbdata;
+    orcm_pubsub_filter_t *filter;
+    char chunk[PUBSUB_READ_CHUNK];
+    char *eol, *tmp;
+    ssize_t rc;
+
+    rc = read(sub->sd, chunk, sizeof(chunk));
+    if (0 > rc && (EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno)) {
+        return;
+    }
+    if (0 >= rc) {
+        pubsub_lost(sub);
+        return;
+    }
+    if (NULL != sub->filter) {
+        return;
+    }
+
+    if (PUBSUB_MAX_FILTER_LINE < sub->inlen + rc ||
+        NULL == (tmp = realloc(sub->inbuf, sub->inlen + rc + 1))) {
+        pubsub_lost(sub);
+        return;
+    }
+    sub->inbuf = tmp;
+    memcpy(sub->inbuf + sub->inlen, chunk, rc);
+    sub->inlen += rc;
+    sub->inbuf[sub->inlen] = '\0';
+    if (NULL == (eol = strchr(sub->inbuf, '\n'))) {
+        return;
+    }
+    *eol = '\0';
+
+    if (ORCM_SUCCESS != orcm_pubsub_filter_parse(sub->inbuf, &filter)) {
+        pubsub_append_output(sub, "#error,bad subscription\n");
+        (void)send(sub->sd, sub->outbuf, sub->outlen, MSG_NOSIGNAL);
+        pubsub_lost(sub);
+        return;
+    }
+    SAFEFREE(sub->inbuf);
+    sub->inlen = 0;
+    sub->filter = filter;
+    if (sub->tev_active) {
+        opal_event_del(&sub->tev);
+        sub->tev_active = false;
+    }
+
+    /* hand it to the owner - from here on the owner's list holds it */
+    if (NULL != sub->listener) {
+        opal_list_remove_item(&sub->listener->connecting, &sub->super);
+        sub->listener = NULL;
+    }
+    pubsub_append_output(sub, ORCM_PUBSUB_CSV_HEADER "\n");
+    sub->inflight = true;
+    if (NULL != sub->accept_fn) {
+        sub->accept_fn(sub);
+    }
+    pubsub_socket_write(sub->sd, OPAL_EV_WRITE, sub);
+}
+
+static int pubsub_set_nonblocking(int sd)
+{
+    int flags;
+
+    if (0 > (flags = fcntl(sd, F_GETFL, 0)) ||
+        0 > fcntl(sd, F_SETFL, flags | O_NONBLOCK) ||
+        0 > fcntl(sd, F_SETFD, FD_CLOEXEC)) {
+        return ORCM_ERROR;
+    }
+    return ORCM_SUCCESS;
+}
+
+/****    LISTENERS    ****/
+static void pubsub_subscribe_timeout(int sd, short args, void *cbdata)
+{
+    orcm_pubsub_subscriber_t *sub = (orcm_pubsub_subscriber_t*)cbdata;
+
+    sub->tev_active = false;
+    pubsub_lost(sub);
+}
+
+static void pubsub_accept(int sd, short args, void *cbdata)
+{
+    orcm_pubsub_listener_t *listener = (orcm_pubsub_listener_t*)cbdata;
+    orcm_pubsub_subscriber_t *sub;
+    struct timeval tv = {PUBSUB_SUBSCRIBE_TIMEOUT, 0};
+    int csd;
+
+    if (0 > (csd = accept(listener->sd, NULL, NULL))) {
+        return;
+    }
+    if (ORCM_SUCCESS != pubsub_set_nonblocking(csd)) {
+        close(csd);
+        return;
+    }
+
+    sub = orcm_pubsub_subscriber_create(0, NULL, NULL, listener->evbase,
+                                        listener->max_pending, listener->lost_fn);
+    sub->sd = csd;
+    sub->accept_fn = listener->accept_fn;
+    opal_event_set(listener->evbase, &sub->rev, csd, OPAL_EV_READ | OPAL_EV_PERSIST,
+                   pubsub_socket_read, sub);
+    opal_event_set(listener->evbase, &sub->wev, csd, OPAL_EV_WRITE | OPAL_EV_PERSIST,
+                   pubsub_socket_write, sub);
+    opal_event_add(&sub->rev, 0);
+    sub->rev_active = true;
+    opal_event_evtimer_set(listener->evbase, &sub->tev, pubsub_subscribe_timeout, sub);
+    opal_event_evtimer_add(&sub->tev, &tv);
+    sub->tev_active = true;
+    sub->listener = listener;
+    opal_list_append(&listener->connecting, &sub->super);
+}
+
+orcm_pubsub_listener_t* orcm_pubsub_listen(const char *path,
+                                           opal_event_base_t *evbase,
+                                           int32_t max_pending,
+                                           orcm_pubsub_subscriber_fn_t accept_fn,
+                                           orcm_pubsub_subscriber_fn_t lost_fn)
+{
+    orcm_pubsub_listener_t *listener;
+    struct sockaddr_un addr;
+    struct stat st;
+
+    if (NULL == path || NULL == evbase || sizeof(addr.sun_path) <= strlen(path)) {
+        ORTE_ERROR_LOG(ORCM_ERR_BAD_PARAM);
+        return NULL;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+    /* clean up a socket left behind by a previous run, but
+     * never remove anything that isn't a socket */
+    if (0 == stat(path, &st)) {
+        if (!S_ISSOCK(st.st_mode)) {
+            opal_output(0, "%s pubsub: %s exists and is not a socket",
+                        ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), path);
+            return NULL;
+        }
+        unlink(path);
+    }
+
+    listener = OBJ_NEW(orcm_pubsub_listener_t);
+    if (0 > (listener->sd = socket(AF_UNIX, SOCK_STREAM, 0))) {
+        OBJ_RELEASE(listener);
+        return NULL;
+    }
+    if (0 > bind(listener->sd, (struct sockaddr*)&addr, sizeof(addr))) {
+        opal_output(0, "%s pubsub: cannot bind %s: %s",
+                    ORTE_NAME_PRINT(ORTE_PROC_MY_NAME), path, strerror(errno));
+        OBJ_RELEASE(listener);
+        return NULL;
+    }
+    listener->path = strdup(path);
+    if (0 > listen(listener->sd, SOMAXCONN) ||
+        ORCM_SUCCESS != pubsub_set_nonblocking(listener->sd)) {
+        OBJ_RELEASE(listener);
+        return NULL;
+    }
+
+    listener->evbase = evbase;
+    listener->max_pending = max_pending;
+    listener->accept_fn = accept_fn;
+    listener->lost_fn = lost_fn;
+    opal_event_set(evbase, &listener->ev, listener->sd, OPAL_EV_READ | OPAL_EV_PERSIST,
+                   pubsub_accept, listener);
+    opal_event_add(&listener->ev, 0);
+    listener->ev_active = true;
+
+    return listener;
+}
+
+/****    CLASS INSTANTIATIONS    ****/
+static void filter_con(orcm_pubsub_filter_t *p)
+{
+    p->kinds = ORCM_PUBSUB_KIND_ALL;
+    p->hosts = NULL;
+    p->groups = NULL;
+    p->metrics = NULL;
+}
+static void filter_des(orcm_pubsub_filter_t *p)
+{
+    opal_argv_free(p->hosts);
+    opal_argv_free(p->groups);
+    opal_argv_free(p->metrics);
+}
+OBJ_CLASS_INSTANCE(orcm_pubsub_filter_t,
+                   opal_object_t,
+                   filter_con, filter_des);
+
+static void record_con(orcm_pubsub_record_t *p)
+{
+    p->kind = ORCM_PUBSUB_KIND_SAMPLE;
+    p->host = NULL;
+    p->group = NULL;
+    p->timestamp = 0;
+    p->severity = NULL;
+    OBJ_CONSTRUCT(&p->values, opal_list_t);
+}
+static void record_des(orcm_pubsub_record_t *p)
+{
+    SAFEFREE(p->host);
+    SAFEFREE(p->group);
+    SAFEFREE(p->severity);
+    OPAL_LIST_DESTRUCT(&p->values);
+}
+OBJ_CLASS_INSTANCE(orcm_pubsub_record_t,
+                   opal_object_t,
+                   record_con, record_des);
+
+static void batch_con(orcm_pubsub_batch_t *p)
+{
+    p->records = NULL;
+    p->num_records = 0;
+}
+static void batch_des(orcm_pubsub_batch_t *p)
+{
+    SAFE_RELEASE(p->records);
+}
+OBJ_CLASS_INSTANCE(orcm_pubsub_batch_t,
+                   opal_list_item_t,
+                   batch_con, batch_des);
+
+static void sub_con(orcm_pubsub_subscriber_t *p)
+{
+    p->id = 0;
+    p->filter = NULL;
+    p->peer = *ORTE_NAME_INVALID;
+    p->sd = -1;
+    p->evbase = NULL;
+    p->rev_active = false;
+    p->wev_active = false;
+    p->inbuf = NULL;
+    p->inlen = 0;
+    p->listener = NULL;
+    p->tev_active = false;
+    p->outbuf = NULL;
+    p->outlen = 0;
+    p->outoff = 0;
+    OBJ_CONSTRUCT(&p->pending, opal_list_t);
+    p->num_pending = 0;
+    p->max_pending = ORCM_PUBSUB_DEFAULT_MAX_QUEUE;
+    p->inflight = false;
+    p->lost = false;
+    p->delivered = 0;
+    p->dropped = 0;
+    p->dropped_reported = 0;
+    p->accept_fn = NULL;
+    p->lost_fn = NULL;
+}
+static void sub_des(orcm_pubsub_subscriber_t *p)
+{
+    pubsub_stop_socket(p);
+    SAFEFREE(p->inbuf);
+    SAFEFREE(p->outbuf);
+    OPAL_LIST_DESTRUCT(&p->pending);
+    SAFE_RELEASE(p->filter);
+}
+OBJ_CLASS_INSTANCE(orcm_pubsub_subscriber_t,
+                   opal_list_item_t,
+                   sub_con, sub_des);
+
+static void listener_con(orcm_pubsub_listener_t *p)
+{
+    p->path = NULL;
+    p->sd = -1;
+    p->evbase = NULL;
+    p->ev_active = false;
+    p->max_pending = ORCM_PUBSUB_DEFAULT_MAX_QUEUE;
+    OBJ_CONSTRUCT(&p->connecting, opal_list_t);
+    p->accept_fn = NULL;
+    p->lost_fn = NULL;
+}
+static void listener_des(orcm_pubsub_listener_t *p)
+{
+    orcm_pubsub_subscriber_t *sub;
+
+    if (p->ev_active) {
+        opal_event_del(&p->ev);
+    }
+    while (NULL != (sub = (orcm_pubsub_subscriber_t*)opal_list_remove_first(&p->connecting))) {
+        sub->listener = NULL;
+        orcm_pubsub_subscriber_close(sub);
+        OBJ_RELEASE(sub);
+    }
+    OBJ_DESTRUCT(&p->connecting);
+    if (0 <= p->sd) {
+        close(p->sd);
+    }
+    if (NULL != p->path) {
+        unlink(p->path);
+        free(p->path);
+    }
+}
+OBJ_CLASS_INSTANCE(orcm_pubsub_listener_t,
+                   opal_object_t,
+                   listener_con, listener_des);
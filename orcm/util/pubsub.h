@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/** @file:
+ *
+ * Common support for the live telemetry subscription service.
+ *
+ * Aggregators and the scheduler both hold a list of subscribers. A
+ * subscriber is described by a filter (hosts, data groups, metrics and
+ * record kinds) plus a sink - either an RML peer (octl, or the scheduler
+ * relaying on behalf of its own clients) or a local unix-domain socket
+ * (external tools). Matching records are packed once, queued on each
+ * matching subscriber and pushed out as soon as the sink is free. Each
+ * subscriber has a bounded queue: when a slow sink falls behind, the
+ * oldest undelivered records are discarded and counted so the client
+ * can see how much it missed.
+ *
+ * None of the functions here lock - the caller must only touch a given
+ * subscriber from the event base it was created with.
+ */
+
+#ifndef ORCM_UTIL_PUBSUB_H
+#define ORCM_UTIL_PUBSUB_H
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#include <time.h>
+
+#include "opal/class/opal_list.h"
+#include "opal/dss/dss_types.h"
+#include "opal/mca/event/event.h"
+
+#include "orte/types.h"
+
+BEGIN_C_DECLS
+
+/* kinds of records a subscriber can ask for */
+#define ORCM_PUBSUB_KIND_SAMPLE   0x01
+#define ORCM_PUBSUB_KIND_EVENT    0x02
+#define ORCM_PUBSUB_KIND_ALL      (ORCM_PUBSUB_KIND_SAMPLE | ORCM_PUBSUB_KIND_EVENT)
+
+/* default bound on undelivered records held for one subscriber */
+#define ORCM_PUBSUB_DEFAULT_MAX_QUEUE 1024
+
+/* header line matching orcm_pubsub_record_to_csv() */
+#define ORCM_PUBSUB_CSV_HEADER "time,hostname,data_group,severity,key,value,units"
+
+/* what a subscriber wants to see - a NULL array matches anything */
+typedef struct {
+    opal_object_t super;
+    uint8_t kinds;
+    char **hosts;
+    char **groups;
+    char **metrics;
+} orcm_pubsub_filter_t;
+ORCM_DECLSPEC OBJ_CLASS_DECLARATION(orcm_pubsub_filter_t);
+
+/* one published record - a sensor sample or a RAS event with its
+ * values already rendered as strings (OPAL_STRING orcm_value_t) */
+typedef struct {
+    opal_object_t super;
+    uint8_t kind;
+    char *host;
+    char *group;
+    time_t timestamp;
+    char *severity;
+    opal_list_t values;
+} orcm_pubsub_record_t;
+ORCM_DECLSPEC OBJ_CLASS_DECLARATION(orcm_pubsub_record_t);
+
+/* a packed run of records waiting for delivery - the buffer
+ * may be shared (retained) by several subscribers */
+typedef struct {
+    opal_list_item_t super;
+    opal_buffer_t *records;
+    int32_t num_records;
+} orcm_pubsub_batch_t;
+ORCM_DECLSPEC OBJ_CLASS_DECLARATION(orcm_pubsub_batch_t);
+
+struct orcm_pubsub_subscriber;
+struct orcm_pubsub_listener;
+typedef void (*orcm_pubsub_subscriber_fn_t)(struct orcm_pubsub_subscriber *sub);
+
+typedef struct orcm_pubsub_subscriber {
+    opal_list_item_t super;
+    /* id, unique for a given peer */
+    uint32_t id;
+    orcm_pubsub_filter_t *filter;
+    /* where records go - either an RML peer or a socket */
+    orte_process_name_t peer;
+    int sd;
+    opal_event_base_t *evbase;
+    /* socket state */
+    opal_event_t rev;
+    opal_event_t wev;
+    bool rev_active;
+    bool wev_active;
+    char *inbuf;
+    size_t inlen;
+    /* a socket client still owes its filter to this listener,
+     * and is dropped when the timer fires first */
+    struct orcm_pubsub_listener *listener;
+    opal_event_t tev;
+    bool tev_active;
+    char *outbuf;
+    size_t outlen;
+    size_t outoff;
+    /* bounded queue of undelivered records */
+    opal_list_t pending;
+    int32_t num_pending;
+    int32_t max_pending;
+    bool inflight;
+    bool lost;
+    /* statistics */
+    uint64_t delivered;
+    uint64_t dropped;
+    uint64_t dropped_reported;
+    /* socket clients are handed to accept_fn once their filter
+     * arrives; lost_fn is called once when the sink goes away */
+    orcm_pubsub_subscriber_fn_t accept_fn;
+    orcm_pubsub_subscriber_fn_t lost_fn;
+} orcm_pubsub_subscriber_t;
+ORCM_DECLSPEC OBJ_CLASS_DECLARATION(orcm_pubsub_subscriber_t);
+
+/* local socket listener for external tools */
+typedef struct orcm_pubsub_listener {
+    opal_object_t super;
+    char *path;
+    int sd;
+    opal_event_base_t *evbase;
+    opal_event_t ev;
+    bool ev_active;
+    int32_t max_pending;
+    /* clients that have connected but not yet subscribed */
+    opal_list_t connecting;
+    /* called when a connected client has sent its filter */
+    orcm_pubsub_subscriber_fn_t accept_fn;
+    orcm_pubsub_subscriber_fn_t lost_fn;
+} orcm_pubsub_listener_t;
+ORCM_DECLSPEC OBJ_CLASS_DECLARATION(orcm_pubsub_listener_t);
+
+/* filters */
+ORCM_DECLSPEC int orcm_pubsub_filter_pack(opal_buffer_t *buf,
+                                          orcm_pubsub_filter_t *filter);
+ORCM_DECLSPEC int orcm_pubsub_filter_unpack(opal_buffer_t *buf,
+                                            orcm_pubsub_filter_t **filter);
+/* parse "hosts=a,b groups=coretemp metrics=core0 kinds=samples,events" */
+ORCM_DECLSPEC int orcm_pubsub_filter_parse(const char *spec,
+                                           orcm_pubsub_filter_t **filter);
+ORCM_DECLSPEC bool orcm_pubsub_filter_match(orcm_pubsub_filter_t *filter,
+                                            uint8_t kind, const char *host,
+                                            const char *group);
+ORCM_DECLSPEC bool orcm_pubsub_filter_match_metric(orcm_pubsub_filter_t *filter,
+                                                   const char *key);
+
+/* records */
+ORCM_DECLSPEC char* orcm_pubsub_value_to_string(opal_value_t *value);
+/* pack the record, keeping only the values that pass the metric
+ * filter (if any). Returns ORCM_ERR_NOT_FOUND if a sample has no
+ * value left to report */
+ORCM_DECLSPEC int orcm_pubsub_record_pack(opal_buffer_t *buf,
+                                          orcm_pubsub_record_t *rec,
+                                          orcm_pubsub_filter_t *filter);
+ORCM_DECLSPEC int orcm_pubsub_record_unpack(opal_buffer_t *buf,
+                                            orcm_pubsub_record_t **rec);
+/* one line per value, newline terminated */
+ORCM_DECLSPEC char* orcm_pubsub_record_to_csv(orcm_pubsub_record_t *rec);
+
+/* subscribers */
+ORCM_DECLSPEC orcm_pubsub_subscriber_t* orcm_pubsub_subscriber_create(uint32_t id,
+                                                 orte_process_name_t *peer,
+                                                 orcm_pubsub_filter_t *filter,
+                                                 opal_event_base_t *evbase,
+                                                 int32_t max_pending,
+                                                 orcm_pubsub_subscriber_fn_t lost_fn);
+/* queue a packed run of records and push it out if the sink is idle */
+ORCM_DECLSPEC void orcm_pubsub_subscriber_enqueue(orcm_pubsub_subscriber_t *sub,
+                                                  opal_buffer_t *records,
+                                                  int32_t num_records);
+/* stop delivery and close any socket - pending records are discarded */
+ORCM_DECLSPEC void orcm_pubsub_subscriber_close(orcm_pubsub_subscriber_t *sub);
+ORCM_DECLSPEC orcm_pubsub_subscriber_t* orcm_pubsub_subscriber_find(opal_list_t *subscribers,
+                                                 orte_process_name_t *peer,
+                                                 uint32_t id);
+
+/* listeners */
+ORCM_DECLSPEC orcm_pubsub_listener_t* orcm_pubsub_listen(const char *path,
+                                            opal_event_base_t *evbase,
+                                            int32_t max_pending,
+                                            orcm_pubsub_subscriber_fn_t accept_fn,
+                                            orcm_pubsub_subscriber_fn_t lost_fn);
+
+END_C_DECLS
+
+#endif /* ORCM_UTIL_PUBSUB_H */
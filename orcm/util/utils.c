@@ -44,6 +44,7 @@
 #include "orte/runtime/orte_globals.h"
 
 #include "orcm/runtime/orcm_globals.h"
+#include "orcm/mca/cfgi/base/base.h"
 #include "orcm/util/utils.h"
 
 #define ORCM_MAX_LINE_LENGTH  512
@@ -84,78 +85,63 @@ void orcm_util_construct_uri(opal_buffer_t *buf, orcm_node_t *node)
     free(uri);
 }
 
+static void add_dependent(opal_list_t *targets, orcm_node_t *node)
+{
+    orte_namelist_t *nm;
+
+    nm = OBJ_NEW(orte_namelist_t);
+    nm->name.jobid = node->daemon.jobid;
+    nm->name.vpid = node->daemon.vpid;
+    opal_list_append(targets, &nm->super);
+}
+
+static void add_rack_dependents(opal_list_t *targets, orcm_rack_t *rack)
+{
+    orcm_node_t *node;
+
+    OPAL_LIST_FOREACH(node, &rack->nodes, orcm_node_t) {
+        add_dependent(targets, node);
+    }
+}
+
+static void add_row_dependents(opal_list_t *targets, orcm_row_t *row)
+{
+    orcm_rack_t *rack;
+
+    OPAL_LIST_FOREACH(rack, &row->racks, orcm_rack_t) {
+        add_dependent(targets, &rack->controller);
+        add_rack_dependents(targets, rack);
+    }
+}
+
 int orcm_util_get_dependents(opal_list_t *targets,
                              orte_process_name_t *root)
 {
-    orcm_cluster_t *cluster;
+    orcm_cfgi_base_dir_entry_t *entry;
     orcm_row_t *row;
-    orcm_rack_t *rack;
-    orcm_node_t *node;
-    orte_namelist_t *nm;
 
-    /* cycle thru the clusters until we find the controller
-     * that matches the given name - dependents include
-     * everything below it
+    /* find the controller that matches the given
+     * name - dependents include everything below it
      */
-    OPAL_LIST_FOREACH(cluster, orcm_clusters, orcm_cluster_t) {
-        node = &cluster->controller;
-        if (OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL, &node->daemon, root)) {
-            OPAL_LIST_FOREACH(row, &cluster->rows, orcm_row_t) {
-                node = &row->controller;
-                nm = OBJ_NEW(orte_namelist_t);
-                nm->name.jobid = node->daemon.jobid;
-                nm->name.vpid = node->daemon.vpid;
-                opal_list_append(targets, &nm->super);
-                OPAL_LIST_FOREACH(rack, &row->racks, orcm_rack_t) {
-                    node = &rack->controller;
-                    nm = OBJ_NEW(orte_namelist_t);
-                    nm->name.jobid = node->daemon.jobid;
-                    nm->name.vpid = node->daemon.vpid;
-                    opal_list_append(targets, &nm->super);
-                    OPAL_LIST_FOREACH(node, &rack->nodes, orcm_node_t) {
-                        nm = OBJ_NEW(orte_namelist_t);
-                        nm->name.jobid = node->daemon.jobid;
-                        nm->name.vpid = node->daemon.vpid;
-                        opal_list_append(targets, &nm->super);
-                    }
-                }
-            }
-            return ORCM_SUCCESS;
-        }
-
-        OPAL_LIST_FOREACH(row, &cluster->rows, orcm_row_t) {
-            node = &row->controller;
-            if (OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL, &node->daemon, root)) {
-                OPAL_LIST_FOREACH(rack, &row->racks, orcm_rack_t) {
-                    node = &rack->controller;
-                    nm = OBJ_NEW(orte_namelist_t);
-                    nm->name.jobid = node->daemon.jobid;
-                    nm->name.vpid = node->daemon.vpid;
-                    opal_list_append(targets, &nm->super);
-                    OPAL_LIST_FOREACH(node, &rack->nodes, orcm_node_t) {
-                        nm = OBJ_NEW(orte_namelist_t);
-                        nm->name.jobid = node->daemon.jobid;
-                        nm->name.vpid = node->daemon.vpid;
-                        opal_list_append(targets, &nm->super);
-                    }
-                }
-                return ORCM_SUCCESS;
-            }
-
-            OPAL_LIST_FOREACH(rack, &row->racks, orcm_rack_t) {
-                node = &rack->controller;
-                if (OPAL_EQUAL == orte_util_compare_name_fields(ORTE_NS_CMP_ALL, &node->daemon, root)) {
-                    OPAL_LIST_FOREACH(node, &rack->nodes, orcm_node_t) {
-                        nm = OBJ_NEW(orte_namelist_t);
-                        nm->name.jobid = node->daemon.jobid;
-                        nm->name.vpid = node->daemon.vpid;
-                        opal_list_append(targets, &nm->super);
-                    }
-                    return ORCM_SUCCESS;
-                }
-            }
+    if (NULL == (entry = orcm_cfgi_base_directory_find_daemon(root))) {
+        return ORCM_ERR_NOT_FOUND;
+    }
+    if (entry->node == &entry->cluster->controller) {
+        OPAL_LIST_FOREACH(row, &entry->cluster->rows, orcm_row_t) {
+            add_dependent(targets, &row->controller);
+            add_row_dependents(targets, row);
         }
+        return ORCM_SUCCESS;
+    }
+    if (NULL != entry->row && entry->node == &entry->row->controller) {
+        add_row_dependents(targets, entry->row);
+        return ORCM_SUCCESS;
+    }
+    if (NULL != entry->rack && entry->node == &entry->rack->controller) {
+        add_rack_dependents(targets, entry->rack);
+        return ORCM_SUCCESS;
     }
+    /* compute nodes have no dependents */
     return ORCM_ERR_NOT_FOUND;
 }
 
@@ -348,7 +334,7 @@ orcm_value_t* orcm_util_copy_orcm_value(orcm_value_t* src)
     return dest;
 }
 
-orcm_value_t* orcm_util_load_orcm_value(char *key, void *data, opal_data_type_t type, char *units)
+orcm_value_t* orcm_util_load_orcm_value(const char *key, void *data, opal_data_type_t type, const char *units)
 {
     int rc = -1;
     orcm_value_t *kv = OBJ_NEW(orcm_value_t);
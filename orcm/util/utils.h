@@ -44,8 +44,8 @@ ORCM_DECLSPEC void orcm_util_print_xml(orcm_cfgi_xml_parser_t *x,
 ORCM_DECLSPEC opal_value_t* orcm_util_load_opal_value(char *key, void *data,
                                                       opal_data_type_t type);
 
-ORCM_DECLSPEC orcm_value_t* orcm_util_load_orcm_value(char *key, void *data,
-                                               opal_data_type_t type, char *units);
+ORCM_DECLSPEC orcm_value_t* orcm_util_load_orcm_value(const char *key, void *data,
+                                               opal_data_type_t type, const char *units);
 
 ORCM_DECLSPEC opal_value_t* orcm_util_copy_opal_value(opal_value_t* src);
 ORCM_DECLSPEC orcm_value_t* orcm_util_copy_orcm_value(orcm_value_t* src);
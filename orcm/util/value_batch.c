@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#include <string.h>
+#include <pthread.h>
+
+#include "opal/class/opal_hash_table.h"
+#include "opal/dss/dss.h"
+
+#include "orcm/util/value_batch.h"
+
+/* every allocation from a batch is rounded up to this */
+#define BATCH_ALIGN(n) (((n) + 7) & ~((size_t)7))
+
+/* size of the blocks added once the built-in one is full */
+#define BATCH_BLOCK (4 * ORCM_VALUE_BATCH_FIRST_BLOCK)
+
+struct orcm_value_batch_block_t {
+    struct orcm_value_batch_block_t *next;
+    uint64_t data[];
+};
+
+/* interned strings: the key is the string, the value our copy of it */
+static pthread_mutex_t intern_lock = PTHREAD_MUTEX_INITIALIZER;
+static opal_hash_table_t *interned = NULL;
+
+static void batch_con(orcm_value_batch_t *p)
+{
+    p->blocks = NULL;
+    p->next = (char*)p->first;
+    p->avail = sizeof(p->first);
+}
+static void batch_des(orcm_value_batch_t *p)
+{
+    struct orcm_value_batch_block_t *blk;
+
+    /* the values themselves hold nothing of their own - their
+     * strings live in the blocks and their keys are interned */
+    while (NULL != (blk = p->blocks)) {
+        p->blocks = blk->next;
+        free(blk);
+    }
+}
+OBJ_CLASS_INSTANCE(orcm_value_batch_t,
+                   opal_object_t,
+                   batch_con, batch_des);
+
+static void vlist_con(orcm_value_list_t *p)
+{
+    p->batch = NULL;
+}
+static void vlist_des(orcm_value_list_t *p)
+{
+    opal_list_item_t *item;
+
+    /* unlink the values while the batch is still around */
+    while (NULL != (item = opal_list_remove_first(&p->super))) {
+        OBJ_RELEASE(item);
+    }
+    if (NULL != p->batch) {
+        OBJ_RELEASE(p->batch);
+    }
+}
+OBJ_CLASS_INSTANCE(orcm_value_list_t,
+                   opal_list_t,
+                   vlist_con, vlist_des);
+
+const char *orcm_value_intern(const char *str)
+{
+    char *copy = NULL;
+    size_t len;
+
+    if (NULL == str) {
+        return NULL;
+    }
+    len = strlen(str);
+
+    pthread_mutex_lock(&intern_lock);
+    if (NULL == interned) {
+        interned = OBJ_NEW(opal_hash_table_t);
+        if (NULL == interned) {
+            goto done;
+        }
+        opal_hash_table_init(interned, 256);
+    }
+    if (OPAL_SUCCESS == opal_hash_table_get_value_ptr(interned, str, len,
+                                                      (void**)&copy)) {
+        goto done;
+    }
+    if (NULL == (copy = strdup(str))) {
+        goto done;
+    }
+    if (OPAL_SUCCESS != opal_hash_table_set_value_ptr(interned, str, len, copy)) {
+        free(copy);
+        copy = NULL;
+    }
+
+done:
+    pthread_mutex_unlock(&intern_lock);
+    return copy;
+}
+
+void orcm_value_intern_finalize(void)
+{
+    void *key, *copy, *node;
+    size_t len;
+    int rc;
+
+    pthread_mutex_lock(&intern_lock);
+    if (NULL != interned) {
+        rc = opal_hash_table_get_first_key_ptr(interned, &key, &len, &copy, &node);
+        while (OPAL_SUCCESS == rc) {
+            free(copy);
+            rc = opal_hash_table_get_next_key_ptr(interned, &key, &len, &copy,
+                                                  node, &node);
+        }
+        OBJ_RELEASE(interned);
+        interned = NULL;
+    }
+    pthread_mutex_unlock(&intern_lock);
+}
+
+static void *batch_alloc(orcm_value_batch_t *batch, size_t size)
+{
+    struct orcm_value_batch_block_t *blk;
+    size_t bsize;
+    void *ptr;
+
+    size = BATCH_ALIGN(size);
+    if (size > batch->avail) {
+        bsize = (size > BATCH_BLOCK) ? size : BATCH_BLOCK;
+        blk = (struct orcm_value_batch_block_t*)malloc(sizeof(*blk) + bsize);
+        if (NULL == blk) {
+            return NULL;
+        }
+        blk->next = batch->blocks;
+        batch->blocks = blk;
+        batch->next = (char*)blk->data;
+        batch->avail = bsize;
+    }
+    ptr = batch->next;
+    batch->next += size;
+    batch->avail -= size;
+    return ptr;
+}
+
+/* a value owned by the batch, with its key and units set */
+static orcm_value_t *batch_value(orcm_value_batch_t *batch, const char *key,
+                                 const char *units)
+{
+    orcm_value_t *kv;
+
+    if (NULL == (kv = (orcm_value_t*)batch_alloc(batch, sizeof(orcm_value_t)))) {
+        return NULL;
+    }
+    OBJ_CONSTRUCT(kv, orcm_value_t);
+    /* the batch's own reference - whoever releases the value
+     * from a list only drops theirs */
+    OBJ_RETAIN(kv);
+    if (NULL != key && NULL == (kv->value.key = (char*)orcm_value_intern(key))) {
+        return NULL;
+    }
+    if (NULL != units && NULL == (kv->units = (char*)orcm_value_intern(units))) {
+        return NULL;
+    }
+    return kv;
+}
+
+static int batch_load_data(orcm_value_batch_t *batch, opal_value_t *kv)
+{
+    char *str;
+    uint8_t *bytes;
+    size_t len;
+
+    if (OPAL_STRING == kv->type && NULL != kv->data.string) {
+        len = strlen(kv->data.string) + 1;
+        if (NULL == (str = (char*)batch_alloc(batch, len))) {
+            return ORCM_ERR_OUT_OF_RESOURCE;
+        }
+        memcpy(str, kv->data.string, len);
+        kv->data.string = str;
+    } else if (OPAL_BYTE_OBJECT == kv->type) {
+        if (NULL == kv->data.bo.bytes || 0 >= kv->data.bo.size) {
+            kv->data.bo.bytes = NULL;
+            kv->data.bo.size = 0;
+        } else {
+            if (NULL == (bytes = (uint8_t*)batch_alloc(batch, kv->data.bo.size))) {
+                return ORCM_ERR_OUT_OF_RESOURCE;
+            }
+            memcpy(bytes, kv->data.bo.bytes, kv->data.bo.size);
+            kv->data.bo.bytes = bytes;
+        }
+    }
+    return ORCM_SUCCESS;
+}
+
+opal_list_t *orcm_value_batch_new_list(orcm_value_batch_t *batch)
+{
+    orcm_value_list_t *list;
+
+    if (NULL == batch || NULL == (list = OBJ_NEW(orcm_value_list_t))) {
+        return NULL;
+    }
+    OBJ_RETAIN(batch);
+    list->batch = batch;
+    return &list->super;
+}
+
+orcm_value_t *orcm_value_batch_load(orcm_value_batch_t *batch, const char *key,
+                                    void *data, opal_data_type_t type,
+                                    const char *units)
+{
+    orcm_value_t *kv;
+
+    if (NULL == batch || NULL == (kv = batch_value(batch, key, units))) {
+        return NULL;
+    }
+
+    kv->value.type = type;
+    switch (type) {
+    case OPAL_STRING:
+        kv->value.data.string = (char*)data;
+        break;
+    case OPAL_BYTE_OBJECT:
+        if (NULL != data) {
+            kv->value.data.bo = *(opal_byte_object_t*)data;
+        }
+        break;
+    default:
+        if (OPAL_SUCCESS != opal_value_load(&kv->value, data, type)) {
+            return NULL;
+        }
+        return kv;
+    }
+    if (ORCM_SUCCESS != batch_load_data(batch, &kv->value)) {
+        return NULL;
+    }
+    return kv;
+}
+
+int orcm_value_batch_copy_list(orcm_value_batch_t *batch,
+                               opal_list_t *src, opal_list_t *dest)
+{
+    orcm_value_t *item, *kv;
+    int rc;
+
+    if (NULL == batch || NULL == src || NULL == dest) {
+        return ORCM_ERROR;
+    }
+
+    OPAL_LIST_FOREACH(item, src, orcm_value_t) {
+        if (NULL == (kv = batch_value(batch, item->value.key, item->units))) {
+            return ORCM_ERR_OUT_OF_RESOURCE;
+        }
+        kv->value.type = item->value.type;
+        kv->value.data = item->value.data;
+        if (ORCM_SUCCESS != (rc = batch_load_data(batch, &kv->value))) {
+            return rc;
+        }
+        opal_list_append(dest, &kv->value.super);
+    }
+    return ORCM_SUCCESS;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/** @file:
+ *
+ * Batched storage for the orcm_value_t's of one message.
+ *
+ * A sensor log, an analytics step or a RAS event typically builds a
+ * few dozen values that all live and die together. A value batch
+ * carves those values, and any string or byte data they carry, out of
+ * a handful of large blocks that are freed at once when the last
+ * reference to the batch goes away. Keys and units are interned, so
+ * they are shared by every batch in the process and never copied.
+ *
+ * The values are ordinary orcm_value_t's and may be put on any
+ * opal_list_t and read by any consumer. The batch holds a reference
+ * on each of them, so releasing a list only unlinks them; the memory
+ * stays valid for as long as the batch does. Whoever puts batch values
+ * on a list must therefore keep the batch alive for the life of that
+ * list - the simplest way being a list from orcm_value_batch_new_list(),
+ * which holds its own reference on the batch. Batch values must not be
+ * modified in place (their key and units are shared).
+ */
+
+#ifndef ORCM_UTIL_VALUE_BATCH_H
+#define ORCM_UTIL_VALUE_BATCH_H
+
+#include "orcm_config.h"
+#include "orcm/constants.h"
+
+#include "opal/class/opal_list.h"
+#include "opal/dss/dss_types.h"
+
+#include "orcm/runtime/orcm_globals.h"
+
+BEGIN_C_DECLS
+
+/* space built into the batch object itself - enough for a typical
+ * sensor sample, so most batches cost a single allocation */
+#define ORCM_VALUE_BATCH_FIRST_BLOCK 4096
+
+struct orcm_value_batch_block_t;
+
+typedef struct {
+    opal_object_t super;
+    /* blocks added once the first one filled up, newest first */
+    struct orcm_value_batch_block_t *blocks;
+    /* unused space left in the current block */
+    char *next;
+    size_t avail;
+    uint64_t first[ORCM_VALUE_BATCH_FIRST_BLOCK / sizeof(uint64_t)];
+} orcm_value_batch_t;
+ORCM_DECLSPEC OBJ_CLASS_DECLARATION(orcm_value_batch_t);
+
+/* a list that keeps a batch alive until the list itself is released */
+typedef struct {
+    opal_list_t super;
+    orcm_value_batch_t *batch;
+} orcm_value_list_t;
+ORCM_DECLSPEC OBJ_CLASS_DECLARATION(orcm_value_list_t);
+
+/* return the process-wide copy of a string, creating it on first
+ * use - the result is valid until orcm_value_intern_finalize() */
+ORCM_DECLSPEC const char *orcm_value_intern(const char *str);
+ORCM_DECLSPEC void orcm_value_intern_finalize(void);
+
+/* create an empty list holding a reference on the batch */
+ORCM_DECLSPEC opal_list_t *orcm_value_batch_new_list(orcm_value_batch_t *batch);
+
+/* the batch equivalent of orcm_util_load_orcm_value() - the value is
+ * not on any list yet */
+ORCM_DECLSPEC orcm_value_t *orcm_value_batch_load(orcm_value_batch_t *batch,
+                                                  const char *key, void *data,
+                                                  opal_data_type_t type,
+                                                  const char *units);
+
+/* copy a list of orcm_value_t into the batch, appending the copies
+ * to dest */
+ORCM_DECLSPEC int orcm_value_batch_copy_list(orcm_value_batch_t *batch,
+                                             opal_list_t *src, opal_list_t *dest);
+
+END_C_DECLS
+
+#endif
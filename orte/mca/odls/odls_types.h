@@ -77,6 +77,24 @@ typedef uint8_t orte_daemon_cmd_flag_t;
 /* new daemon collective id */
 #define ORTE_DAEMON_NEW_COLL_ID             (orte_daemon_cmd_flag_t) 29
 
+/* subscribe to / cancel streamed state updates */
+#define ORTE_DAEMON_WATCH_CMD               (orte_daemon_cmd_flag_t) 30
+#define ORTE_DAEMON_UNWATCH_CMD             (orte_daemon_cmd_flag_t) 31
+
+/* kinds of record carried in a watch update - a subscription
+ * ORs together the kinds it wants, while each record in an
+ * update carries exactly one kind, plus the GONE bit when the
+ * object no longer exists
+ */
+typedef uint8_t orte_watch_flag_t;
+#define ORTE_WATCH_FLAG_T   OPAL_UINT8
+
+#define ORTE_WATCH_JOBS     0x01
+#define ORTE_WATCH_NODES    0x02
+#define ORTE_WATCH_PROCS    0x04
+#define ORTE_WATCH_PSTATS   0x08
+#define ORTE_WATCH_GONE     0x80
+
 
 /*
  * Struct written up the pipe from the child to the parent.
@@ -159,6 +159,10 @@ BEGIN_C_DECLS
 #define ORTE_RML_TAG_MSG_ACK                56
 #define ORTE_RML_TAG_CLOSE_CHANNEL_REQ      57
 #define ORTE_RML_TAG_CLOSE_CHANNEL_ACCEPT   58
+
+/* streamed state updates for tools */
+#define ORTE_RML_TAG_WATCH                  59
+
 #define ORTE_RML_TAG_MAX                   100
 
 
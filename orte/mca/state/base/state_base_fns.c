@@ -23,6 +23,7 @@
 #include "orte/mca/plm/plm.h"
 #include "orte/mca/routed/routed.h"
 #include "orte/util/session_dir.h"
+#include "orte/orted/orted.h"
 
 #include "orte/mca/state/base/base.h"
 #include "orte/mca/state/base/state_private.h"
@@ -34,6 +35,11 @@ void orte_state_base_activate_job_state(orte_job_t *jdata,
     orte_state_t *s;
     orte_state_caddy_t *caddy;
 
+    /* let any watching tools know to look at it again */
+    if (NULL != jdata) {
+        orte_daemon_watch_job_changed(jdata->jobid);
+    }
+
     for (itm = opal_list_get_first(&orte_job_states);
          itm != opal_list_get_end(&orte_job_states);
          itm = opal_list_get_next(itm)) {
@@ -221,6 +227,8 @@ void orte_state_base_activate_proc_state(orte_process_name_t *proc,
     orte_state_t *s;
     orte_state_caddy_t *caddy;
 
+    orte_daemon_watch_proc_changed(proc);
+
     for (itm = opal_list_get_first(&orte_proc_states);
          itm != opal_list_get_end(&orte_proc_states);
          itm = opal_list_get_next(itm)) {
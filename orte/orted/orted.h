@@ -44,6 +44,16 @@ ORTE_DECLSPEC int orte_daemon_process_commands(orte_process_name_t* sender,
                                                opal_buffer_t *buffer,
                                                orte_rml_tag_t tag);
 
+/* streamed state updates for tools */
+ORTE_DECLSPEC int orte_daemon_watch(orte_process_name_t *sender,
+                                    opal_buffer_t *buffer);
+ORTE_DECLSPEC int orte_daemon_unwatch(orte_process_name_t *sender,
+                                      opal_buffer_t *buffer);
+/* called by the state machine so that watched job, proc and node
+ * state is only re-read when it may have changed */
+ORTE_DECLSPEC void orte_daemon_watch_job_changed(orte_jobid_t job);
+ORTE_DECLSPEC void orte_daemon_watch_proc_changed(orte_process_name_t *proc);
+
 END_C_DECLS
 
 /* Local function */
@@ -1137,6 +1137,19 @@ void orte_daemon_recv(int status, orte_process_name_t* sender,
         }
         break;
 
+        /****     WATCH COMMANDS     ****/
+    case ORTE_DAEMON_WATCH_CMD:
+        if (ORTE_SUCCESS != (ret = orte_daemon_watch(sender, buffer))) {
+            ORTE_ERROR_LOG(ret);
+        }
+        break;
+
+    case ORTE_DAEMON_UNWATCH_CMD:
+        if (ORTE_SUCCESS != (ret = orte_daemon_unwatch(sender, buffer))) {
+            ORTE_ERROR_LOG(ret);
+        }
+        break;
+
     default:
         ORTE_ERROR_LOG(ORTE_ERR_BAD_PARAM);
     }
@@ -1200,6 +1213,10 @@ static char *get_orted_comm_cmd_str(int command)
         return strdup("ORTE_DAEMON_ABORT_PROCS_CALLED");
     case ORTE_DAEMON_NEW_COLL_ID:
         return strdup("ORTE_DAEMON_NEW_COLL_ID");
+    case ORTE_DAEMON_WATCH_CMD:
+        return strdup("ORTE_DAEMON_WATCH_CMD");
+    case ORTE_DAEMON_UNWATCH_CMD:
+        return strdup("ORTE_DAEMON_UNWATCH_CMD");
 
     default:
         return strdup("Unknown Command!");
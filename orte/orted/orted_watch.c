@@ -0,0 +1,742 @@
+/*
+ * Copyright (c) 2014      Intel, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orte_config.h"
+#include "orte/constants.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "opal/class/opal_hash_table.h"
+#include "opal/class/opal_list.h"
+#include "opal/mca/event/event.h"
+#include "opal/mca/pstat/pstat.h"
+#include "opal/util/output.h"
+#include "opal/dss/dss.h"
+
+#include "orte/util/proc_info.h"
+#include "orte/util/name_fns.h"
+#include "orte/util/attr.h"
+
+#include "orte/mca/errmgr/errmgr.h"
+#include "orte/mca/odls/odls_types.h"
+#include "orte/mca/rmaps/rmaps_types.h"
+#include "orte/mca/rml/rml.h"
+#include "orte/mca/rml/rml_types.h"
+
+#include "orte/runtime/orte_globals.h"
+
+#include "orte/orted/orted.h"
+#include "orte/orted/orted_watch_table.h"
+
+/*
+ * Tools that monitor a running system subscribe here rather than
+ * re-issuing a full query every refresh. Each process keeps a single
+ * table of the records it can report - job, node and proc state on
+ * the HNP, resource usage of its own children everywhere - and stamps
+ * each record with the generation at which it last changed. The table
+ * is refreshed once per tick however many tools are watching, and is
+ * kept ordered by generation so that serving a watcher only touches
+ * the records that changed since its previous update.
+ *
+ * On the HNP the job and node tables are only walked in full when a
+ * kind is first watched. After that the state machine reports every
+ * job and proc state change here, and a tick re-reads just those jobs
+ * and procs and the nodes they sit on.
+ *
+ * Resource usage is collected and diffed by the daemons themselves:
+ * the HNP relays the subscription and each daemon sends the changes
+ * for its own children addressed to the tool. The messages are still
+ * routed through the HNP, as is everything bound for another job
+ * family, but the HNP only forwards them.
+ */
+
+/* a job, proc or node the state machine reported as changed */
+typedef struct {
+    opal_list_item_t super;
+    orte_watch_flag_t kind;
+    /* jobid for jobs, full name for procs, pool index in the vpid for nodes */
+    orte_process_name_t name;
+    /* pass during which it was last reported */
+    uint64_t pass;
+} orte_watch_dirty_t;
+OBJ_CLASS_INSTANCE(orte_watch_dirty_t,
+                   opal_list_item_t,
+                   NULL, NULL);
+
+static bool initialized = false;
+static opal_list_t watchers;
+static orte_watch_table_t table;
+/* HNP kinds kept current from reported changes */
+static orte_watch_flag_t tracked = 0;
+static opal_list_t dirty;
+static opal_hash_table_t dirty_index;
+static opal_event_t tick_ev;
+static bool tick_active = false;
+
+static void tick_cb(int fd, short args, void *cbdata);
+
+static void watch_init(void)
+{
+    if (initialized) {
+        return;
+    }
+    OBJ_CONSTRUCT(&watchers, opal_list_t);
+    orte_watch_table_init(&table);
+    OBJ_CONSTRUCT(&dirty, opal_list_t);
+    OBJ_CONSTRUCT(&dirty_index, opal_hash_table_t);
+    opal_hash_table_init(&dirty_index, 256);
+    opal_event_evtimer_set(orte_event_base, &tick_ev, tick_cb, NULL);
+    opal_event_set_priority(&tick_ev, ORTE_SYS_PRI);
+    initialized = true;
+}
+
+/* the kinds of record this process is able to report */
+static orte_watch_flag_t supplied(void)
+{
+    if (ORTE_PROC_IS_HNP) {
+        return ORTE_WATCH_JOBS | ORTE_WATCH_NODES | ORTE_WATCH_PROCS | ORTE_WATCH_PSTATS;
+    }
+    return ORTE_WATCH_PSTATS;
+}
+
+static void update_job(orte_job_t *jdata)
+{
+    orte_process_name_t name;
+    opal_buffer_t scratch;
+    int rc;
+
+    OBJ_CONSTRUCT(&scratch, opal_buffer_t);
+    if (ORTE_SUCCESS != (rc = opal_dss.pack(&scratch, &jdata->jobid, 1, ORTE_JOBID)) ||
+        ORTE_SUCCESS != (rc = opal_dss.pack(&scratch, &jdata->state, 1, ORTE_JOB_STATE)) ||
+        ORTE_SUCCESS != (rc = opal_dss.pack(&scratch, &jdata->num_procs, 1, ORTE_VPID)) ||
+        ORTE_SUCCESS != (rc = opal_dss.pack(&scratch, &jdata->num_terminated, 1, ORTE_VPID))) {
+        ORTE_ERROR_LOG(rc);
+    } else {
+        name.jobid = jdata->jobid;
+        name.vpid = ORTE_VPID_INVALID;
+        orte_watch_table_update(&table, orte_watch_table_lookup(&table, ORTE_WATCH_JOBS,
+                                                                &name, NULL), &scratch);
+    }
+    OBJ_DESTRUCT(&scratch);
+}
+
+static void update_proc(orte_proc_t *proc)
+{
+    opal_buffer_t scratch;
+    char *host;
+    int rc;
+
+    host = (NULL == proc->node) ? NULL : proc->node->name;
+    OBJ_CONSTRUCT(&scratch, opal_buffer_t);
+    if (ORTE_SUCCESS != (rc = opal_dss.pack(&scratch, &proc->name, 1, ORTE_NAME)) ||
+        ORTE_SUCCESS != (rc = opal_dss.pack(&scratch, &proc->state, 1, ORTE_PROC_STATE)) ||
+        ORTE_SUCCESS != (rc = opal_dss.pack(&scratch, &proc->pid, 1, OPAL_PID)) ||
+        ORTE_SUCCESS != (rc = opal_dss.pack(&scratch, &host, 1, OPAL_STRING)) ||
+        ORTE_SUCCESS != (rc = opal_dss.pack(&scratch, &proc->exit_code, 1, ORTE_EXIT_CODE))) {
+        ORTE_ERROR_LOG(rc);
+    } else {
+        orte_watch_table_update(&table, orte_watch_table_lookup(&table, ORTE_WATCH_PROCS,
+                                                                &proc->name, host), &scratch);
+    }
+    OBJ_DESTRUCT(&scratch);
+}
+
+static void update_node(orte_node_t *node)
+{
+    opal_buffer_t scratch;
+    int rc;
+
+    OBJ_CONSTRUCT(&scratch, opal_buffer_t);
+    if (ORTE_SUCCESS != (rc = opal_dss.pack(&scratch, &node->name, 1, OPAL_STRING)) ||
+        ORTE_SUCCESS != (rc = opal_dss.pack(&scratch, &node->state, 1, ORTE_NODE_STATE)) ||
+        ORTE_SUCCESS != (rc = opal_dss.pack(&scratch, &node->num_procs, 1, ORTE_VPID)) ||
+        ORTE_SUCCESS != (rc = opal_dss.pack(&scratch, &node->slots_inuse, 1, ORTE_STD_CNTR))) {
+        ORTE_ERROR_LOG(rc);
+    } else {
+        orte_watch_table_update(&table, orte_watch_table_lookup(&table, ORTE_WATCH_NODES,
+                                                                NULL, node->name), &scratch);
+    }
+    OBJ_DESTRUCT(&scratch);
+}
+
+/* full walks, used when a kind is first watched */
+static void refresh_jobs(orte_watch_flag_t kinds)
+{
+    orte_job_t *jdata;
+    orte_proc_t *proc;
+    int i, j;
+
+    for (j=0; j < orte_job_data->size; j++) {
+        if (NULL == (jdata = (orte_job_t*)opal_pointer_array_get_item(orte_job_data, j))) {
+            continue;
+        }
+        if (kinds & ORTE_WATCH_JOBS) {
+            update_job(jdata);
+        }
+        if (!(kinds & ORTE_WATCH_PROCS)) {
+            continue;
+        }
+        for (i=0; i < jdata->procs->size; i++) {
+            if (NULL != (proc = (orte_proc_t*)opal_pointer_array_get_item(jdata->procs, i))) {
+                update_proc(proc);
+            }
+        }
+    }
+}
+
+static void refresh_nodes(void)
+{
+    orte_node_t *node;
+    int i;
+
+    for (i=0; i < orte_node_pool->size; i++) {
+        if (NULL != (node = (orte_node_t*)opal_pointer_array_get_item(orte_node_pool, i)) &&
+            NULL != node->name) {
+            update_node(node);
+        }
+    }
+}
+
+static void mark_dirty(orte_watch_flag_t kind, orte_jobid_t jobid, orte_vpid_t vpid)
+{
+    orte_watch_dirty_t *d;
+    char key[1 + sizeof(orte_process_name_t)];
+    orte_process_name_t name;
+    void *ptr;
+
+    name.jobid = jobid;
+    name.vpid = vpid;
+    key[0] = (char)kind;
+    memcpy(key + 1, &name, sizeof(name));
+    if (OPAL_SUCCESS == opal_hash_table_get_value_ptr(&dirty_index, key, sizeof(key), &ptr)) {
+        ((orte_watch_dirty_t*)ptr)->pass = table.pass;
+        return;
+    }
+    d = OBJ_NEW(orte_watch_dirty_t);
+    d->kind = kind;
+    d->name = name;
+    d->pass = table.pass;
+    opal_hash_table_set_value_ptr(&dirty_index, key, sizeof(key), d);
+    opal_list_append(&dirty, &d->super);
+}
+
+static void drop_dirty(orte_watch_dirty_t *d)
+{
+    char key[1 + sizeof(orte_process_name_t)];
+
+    key[0] = (char)d->kind;
+    memcpy(key + 1, &d->name, sizeof(d->name));
+    opal_hash_table_remove_value_ptr(&dirty_index, key, sizeof(key));
+    opal_list_remove_item(&dirty, &d->super);
+    OBJ_RELEASE(d);
+}
+
+/* re-read what the state machine reported since the last passes. A
+ * state is activated before its callback applies it, so each report
+ * is looked at on two passes to be sure the change has landed */
+static void refresh_changed(orte_watch_flag_t kinds)
+{
+    orte_watch_dirty_t *d, *dnext;
+    orte_watch_record_t *rec, *rnext;
+    orte_job_t *jdata;
+    orte_proc_t *proc;
+    orte_node_t *node;
+
+    OPAL_LIST_FOREACH_SAFE(d, dnext, &dirty, orte_watch_dirty_t) {
+        switch (d->kind) {
+        case ORTE_WATCH_JOBS:
+            if (!(kinds & (ORTE_WATCH_JOBS | ORTE_WATCH_PROCS))) {
+                continue;
+            }
+            if (NULL == (jdata = orte_get_job_data_object(d->name.jobid))) {
+                /* the job has been cleaned up along with its procs */
+                OPAL_LIST_FOREACH_SAFE(rec, rnext, &table.records, orte_watch_record_t) {
+                    if ((ORTE_WATCH_JOBS == rec->kind || ORTE_WATCH_PROCS == rec->kind) &&
+                        rec->name.jobid == d->name.jobid) {
+                        orte_watch_table_gone(&table, rec);
+                    }
+                }
+                drop_dirty(d);
+                continue;
+            }
+            if (kinds & ORTE_WATCH_JOBS) {
+                update_job(jdata);
+            }
+            /* keep an eye on a finished job until it is removed */
+            if (ORTE_JOB_STATE_UNTERMINATED < jdata->state) {
+                d->pass = table.pass;
+            }
+            break;
+        case ORTE_WATCH_PROCS:
+            if (!(kinds & ORTE_WATCH_PROCS)) {
+                continue;
+            }
+            if (NULL != (proc = orte_get_proc_object(&d->name))) {
+                update_proc(proc);
+            } else if (NULL != (rec = orte_watch_table_find(&table, ORTE_WATCH_PROCS,
+                                                             &d->name, NULL))) {
+                orte_watch_table_gone(&table, rec);
+            }
+            break;
+        default:
+            if (!(kinds & ORTE_WATCH_NODES)) {
+                continue;
+            }
+            if (NULL != (node = (orte_node_t*)opal_pointer_array_get_item(orte_node_pool,
+                                                                        d->name.vpid)) &&
+                NULL != node->name) {
+                update_node(node);
+            }
+            break;
+        }
+        if (d->pass + 1 < table.pass) {
+            drop_dirty(d);
+        }
+    }
+}
+
+void orte_daemon_watch_job_changed(orte_jobid_t job)
+{
+    orte_job_t *jdata;
+    orte_node_t *node;
+    int i;
+
+    if (!initialized || 0 == tracked) {
+        return;
+    }
+    if (tracked & (ORTE_WATCH_JOBS | ORTE_WATCH_PROCS)) {
+        mark_dirty(ORTE_WATCH_JOBS, job, ORTE_VPID_INVALID);
+    }
+    /* mapping and teardown change the load on the job's nodes */
+    if ((tracked & ORTE_WATCH_NODES) &&
+        NULL != (jdata = orte_get_job_data_object(job)) && NULL != jdata->map) {
+        for (i=0; i < jdata->map->nodes->size; i++) {
+            if (NULL != (node = (orte_node_t*)opal_pointer_array_get_item(jdata->map->nodes, i))) {
+                mark_dirty(ORTE_WATCH_NODES, ORTE_JOBID_INVALID, node->index);
+            }
+        }
+    }
+}
+
+void orte_daemon_watch_proc_changed(orte_process_name_t *name)
+{
+    orte_proc_t *proc;
+
+    if (!initialized || 0 == tracked || NULL == name) {
+        return;
+    }
+    if (tracked & ORTE_WATCH_PROCS) {
+        mark_dirty(ORTE_WATCH_PROCS, name->jobid, name->vpid);
+    }
+    /* a daemon's state decides that of its node */
+    if ((tracked & ORTE_WATCH_NODES) &&
+        NULL != (proc = orte_get_proc_object(name)) && NULL != proc->node) {
+        mark_dirty(ORTE_WATCH_NODES, ORTE_JOBID_INVALID, proc->node->index);
+    }
+}
+
+static void refresh_pstats(void)
+{
+    orte_proc_t *child;
+    opal_pstats_t stats, *statsptr;
+    opal_buffer_t scratch;
+    int i, j, rc;
+
+    for (i=0; i < orte_local_children->size; i++) {
+        if (NULL == (child = (orte_proc_t*)opal_pointer_array_get_item(orte_local_children, i)) ||
+            !ORTE_FLAG_TEST(child, ORTE_PROC_FLAG_ALIVE)) {
+            continue;
+        }
+        OBJ_CONSTRUCT(&stats, opal_pstats_t);
+        /* record node up to first '.' */
+        for (j=0; j < (int)strlen(orte_process_info.nodename) &&
+             j < OPAL_PSTAT_MAX_STRING_LEN-1 &&
+             orte_process_info.nodename[j] != '.'; j++) {
+            stats.node[j] = orte_process_info.nodename[j];
+        }
+        stats.rank = child->name.vpid;
+        if (ORTE_SUCCESS != opal_pstat.query(child->pid, &stats, NULL)) {
+            /* the child may have just exited - it will be
+             * reported as gone if it stays unreadable
+             */
+            OBJ_DESTRUCT(&stats);
+            continue;
+        }
+        /* the sample time differs on every query - leave it out
+         * so that an idle child compares as unchanged
+         */
+        stats.sample_time.tv_sec = 0;
+        stats.sample_time.tv_usec = 0;
+        statsptr = &stats;
+        OBJ_CONSTRUCT(&scratch, opal_buffer_t);
+        if (ORTE_SUCCESS != (rc = opal_dss.pack(&scratch, &child->name, 1, ORTE_NAME)) ||
+            ORTE_SUCCESS != (rc = opal_dss.pack(&scratch, &statsptr, 1, OPAL_PSTAT))) {
+            ORTE_ERROR_LOG(rc);
+        } else {
+            orte_watch_table_update(&table,
+                                    orte_watch_table_lookup(&table, ORTE_WATCH_PSTATS, &child->name,
+                                                            orte_process_info.nodename),
+                                    &scratch);
+        }
+        OBJ_DESTRUCT(&scratch);
+        OBJ_DESTRUCT(&stats);
+    }
+}
+
+/* bring the table up to date for the given kinds - anything of
+ * those kinds that was not found in this pass no longer exists
+ */
+static void refresh(orte_watch_flag_t kinds)
+{
+    orte_watch_record_t *rec, *next;
+    orte_watch_flag_t walk;
+
+    kinds &= supplied();
+    if (0 == kinds) {
+        return;
+    }
+    ++table.pass;
+
+    /* job, proc and node state is only walked in full the first time
+     * it is watched - from then on the reported changes say what to
+     * look at */
+    walk = kinds & ~tracked;
+    refresh_changed(kinds & tracked);
+    if (ORTE_PROC_IS_HNP) {
+        tracked |= kinds & (ORTE_WATCH_JOBS | ORTE_WATCH_NODES | ORTE_WATCH_PROCS);
+    }
+    if (walk & (ORTE_WATCH_JOBS | ORTE_WATCH_PROCS)) {
+        refresh_jobs(walk);
+    }
+    if (walk & ORTE_WATCH_NODES) {
+        refresh_nodes();
+    }
+
+    /* our own children are few enough to check every time - any that
+     * could not be read this pass have gone */
+    if (kinds & ORTE_WATCH_PSTATS) {
+        refresh_pstats();
+        if (0 < table.npstats) {
+            OPAL_LIST_FOREACH_SAFE(rec, next, &table.records, orte_watch_record_t) {
+                if (ORTE_WATCH_PSTATS == rec->kind && table.pass != rec->seen) {
+                    orte_watch_table_gone(&table, rec);
+                }
+            }
+        }
+    }
+}
+
+static void remove_watchers(orte_process_name_t *requestor);
+
+static void watch_send_cb(int status, orte_process_name_t *peer,
+                          opal_buffer_t* buffer, orte_rml_tag_t tag,
+                          void* cbdata)
+{
+    OBJ_RELEASE(buffer);
+    if (ORTE_SUCCESS != status) {
+        /* the tool has gone away without cancelling */
+        OPAL_OUTPUT_VERBOSE((1, orte_debug_output,
+                             "%s orted:watch dropping unreachable watcher %s",
+                             ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                             ORTE_NAME_PRINT(peer)));
+        remove_watchers(peer);
+    }
+}
+
+/* push either everything the watcher can see or, once it has
+ * that, only the records that changed since its last update
+ */
+static void send_update(orte_watcher_t *w, bool snapshot)
+{
+    opal_buffer_t *msg;
+    int32_t count;
+    int rc;
+
+    msg = OBJ_NEW(opal_buffer_t);
+    if (ORTE_SUCCESS != orte_watch_table_pack(&table, w, snapshot, msg, &count)) {
+        OBJ_RELEASE(msg);
+        return;
+    }
+
+    /* nothing changed - nothing to say */
+    if (0 == count && !snapshot) {
+        OBJ_RELEASE(msg);
+        return;
+    }
+    if (0 > (rc = orte_rml.send_buffer_nb(&w->requestor, msg, ORTE_RML_TAG_WATCH,
+                                          watch_send_cb, NULL))) {
+        ORTE_ERROR_LOG(rc);
+        OBJ_RELEASE(msg);
+    }
+}
+
+static void release_all(void)
+{
+    opal_list_item_t *item;
+
+    if (tick_active) {
+        opal_event_evtimer_del(&tick_ev);
+        tick_active = false;
+    }
+    orte_watch_table_clear(&table);
+    /* start from a full walk if anyone watches again */
+    while (NULL != (item = opal_list_remove_first(&dirty))) {
+        OBJ_RELEASE(item);
+    }
+    opal_hash_table_remove_all(&dirty_index);
+    tracked = 0;
+}
+
+static void start_tick(void)
+{
+    struct timeval tv;
+
+    if (tick_active) {
+        return;
+    }
+    tv.tv_sec = 1;
+    tv.tv_usec = 0;
+    opal_event_evtimer_add(&tick_ev, &tv);
+    tick_active = true;
+}
+
+static void tick_cb(int fd, short args, void *cbdata)
+{
+    orte_watcher_t *w, *next;
+    orte_watch_flag_t due = 0;
+    time_t now;
+
+    tick_active = false;
+    now = time(NULL);
+
+    OPAL_LIST_FOREACH(w, &watchers, orte_watcher_t) {
+        if (w->next <= now) {
+            due |= w->what;
+        }
+    }
+    if (0 != due) {
+        /* one refresh serves every watcher that is due */
+        refresh(due);
+        OPAL_LIST_FOREACH_SAFE(w, next, &watchers, orte_watcher_t) {
+            if (w->next <= now) {
+                w->next = now + w->rate;
+                send_update(w, false);
+            }
+        }
+        orte_watch_table_purge(&table, &watchers);
+    }
+
+    if (0 < opal_list_get_size(&watchers)) {
+        start_tick();
+    } else {
+        release_all();
+    }
+}
+
+static int relay(orte_watcher_t *w, orte_daemon_cmd_flag_t command)
+{
+    opal_buffer_t *msg;
+    orte_process_name_t daemon;
+    orte_watch_flag_t what = ORTE_WATCH_PSTATS;
+    orte_vpid_t first, last;
+    int rc;
+
+    if (ORTE_VPID_INVALID == w->relayed) {
+        return ORTE_SUCCESS;
+    }
+    if (ORTE_VPID_WILDCARD == w->relayed) {
+        first = 1;
+        last = orte_process_info.num_procs;
+    } else {
+        first = w->relayed;
+        last = first + 1;
+    }
+
+    daemon.jobid = ORTE_PROC_MY_NAME->jobid;
+    for (daemon.vpid = first; daemon.vpid < last; daemon.vpid++) {
+        msg = OBJ_NEW(opal_buffer_t);
+        if (ORTE_SUCCESS != (rc = opal_dss.pack(msg, &command, 1, ORTE_DAEMON_CMD))) {
+            goto error;
+        }
+        if (ORTE_DAEMON_WATCH_CMD == command) {
+            if (ORTE_SUCCESS != (rc = opal_dss.pack(msg, &what, 1, ORTE_WATCH_FLAG_T)) ||
+                ORTE_SUCCESS != (rc = opal_dss.pack(msg, &w->rate, 1, OPAL_INT32)) ||
+                ORTE_SUCCESS != (rc = opal_dss.pack(msg, &w->job, 1, ORTE_JOBID)) ||
+                ORTE_SUCCESS != (rc = opal_dss.pack(msg, &w->node, 1, OPAL_STRING)) ||
+                ORTE_SUCCESS != (rc = opal_dss.pack(msg, &w->nranks, 1, OPAL_INT32))) {
+                goto error;
+            }
+            if (0 < w->nranks &&
+                ORTE_SUCCESS != (rc = opal_dss.pack(msg, w->ranks, w->nranks, ORTE_VPID))) {
+                goto error;
+            }
+        }
+        /* the daemon needs to know who to answer */
+        if (ORTE_SUCCESS != (rc = opal_dss.pack(msg, &w->requestor, 1, ORTE_NAME))) {
+            goto error;
+        }
+        if (0 > (rc = orte_rml.send_buffer_nb(&daemon, msg, ORTE_RML_TAG_DAEMON,
+                                              orte_rml_send_callback, NULL))) {
+            goto error;
+        }
+    }
+    return ORTE_SUCCESS;
+
+ error:
+    ORTE_ERROR_LOG(rc);
+    OBJ_RELEASE(msg);
+    return rc;
+}
+
+/* work out which daemons host what this watcher wants */
+static orte_vpid_t relay_target(orte_watcher_t *w)
+{
+    orte_node_t *node;
+    int i;
+
+    if (!(w->what & ORTE_WATCH_PSTATS) || orte_process_info.num_procs < 2) {
+        return ORTE_VPID_INVALID;
+    }
+    if (NULL == w->node) {
+        return ORTE_VPID_WILDCARD;
+    }
+    for (i=0; i < orte_node_pool->size; i++) {
+        if (NULL == (node = (orte_node_t*)opal_pointer_array_get_item(orte_node_pool, i)) ||
+            NULL == node->name || 0 != strcmp(node->name, w->node)) {
+            continue;
+        }
+        if (NULL == node->daemon || ORTE_PROC_MY_NAME->vpid == node->daemon->name.vpid) {
+            break;
+        }
+        return node->daemon->name.vpid;
+    }
+    return ORTE_VPID_INVALID;
+}
+
+static void remove_watchers(orte_process_name_t *requestor)
+{
+    orte_watcher_t *w, *next;
+
+    OPAL_LIST_FOREACH_SAFE(w, next, &watchers, orte_watcher_t) {
+        if (OPAL_EQUAL != orte_util_compare_name_fields(ORTE_NS_CMP_ALL, &w->requestor, requestor)) {
+            continue;
+        }
+        if (ORTE_PROC_IS_HNP) {
+            relay(w, ORTE_DAEMON_UNWATCH_CMD);
+        }
+        opal_list_remove_item(&watchers, &w->super);
+        OBJ_RELEASE(w);
+    }
+    if (0 == opal_list_get_size(&watchers)) {
+        release_all();
+    }
+}
+
+int orte_daemon_watch(orte_process_name_t *sender, opal_buffer_t *buffer)
+{
+    orte_watcher_t *w;
+    orte_std_cntr_t n;
+    int rc;
+
+    watch_init();
+
+    w = OBJ_NEW(orte_watcher_t);
+    n = 1;
+    if (ORTE_SUCCESS != (rc = opal_dss.unpack(buffer, &w->what, &n, ORTE_WATCH_FLAG_T))) {
+        goto error;
+    }
+    n = 1;
+    if (ORTE_SUCCESS != (rc = opal_dss.unpack(buffer, &w->rate, &n, OPAL_INT32))) {
+        goto error;
+    }
+    n = 1;
+    if (ORTE_SUCCESS != (rc = opal_dss.unpack(buffer, &w->job, &n, ORTE_JOBID))) {
+        goto error;
+    }
+    n = 1;
+    if (ORTE_SUCCESS != (rc = opal_dss.unpack(buffer, &w->node, &n, OPAL_STRING))) {
+        goto error;
+    }
+    n = 1;
+    if (ORTE_SUCCESS != (rc = opal_dss.unpack(buffer, &w->nranks, &n, OPAL_INT32))) {
+        goto error;
+    }
+    if (0 < w->nranks) {
+        w->ranks = (orte_vpid_t*)malloc(w->nranks * sizeof(orte_vpid_t));
+        n = w->nranks;
+        if (ORTE_SUCCESS != (rc = opal_dss.unpack(buffer, w->ranks, &n, ORTE_VPID))) {
+            goto error;
+        }
+    }
+    if (w->rate < 1) {
+        w->rate = 1;
+    }
+
+    if (ORTE_PROC_IS_HNP) {
+        w->requestor = *sender;
+        /* the jobid provided has the job family of the requestor */
+        if (ORTE_JOBID_WILDCARD != w->job) {
+            w->job = ORTE_CONSTRUCT_LOCAL_JOBID(ORTE_PROC_MY_NAME->jobid, w->job);
+        }
+        w->relayed = relay_target(w);
+        if (ORTE_SUCCESS != (rc = relay(w, ORTE_DAEMON_WATCH_CMD))) {
+            OBJ_RELEASE(w);
+            return rc;
+        }
+    } else {
+        /* relayed by the HNP on behalf of the tool */
+        n = 1;
+        if (ORTE_SUCCESS != (rc = opal_dss.unpack(buffer, &w->requestor, &n, ORTE_NAME))) {
+            goto error;
+        }
+    }
+
+    OPAL_OUTPUT_VERBOSE((1, orte_debug_output,
+                         "%s orted:watch adding watcher %s for 0x%x every %d sec",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                         ORTE_NAME_PRINT(&w->requestor),
+                         (unsigned int)w->what, (int)w->rate));
+
+    /* start the watcher off with the current picture */
+    opal_list_append(&watchers, &w->super);
+    refresh(w->what);
+    w->next = time(NULL) + w->rate;
+    send_update(w, true);
+    orte_watch_table_purge(&table, &watchers);
+    start_tick();
+    return ORTE_SUCCESS;
+
+ error:
+    ORTE_ERROR_LOG(rc);
+    OBJ_RELEASE(w);
+    return rc;
+}
+
+int orte_daemon_unwatch(orte_process_name_t *sender, opal_buffer_t *buffer)
+{
+    orte_process_name_t requestor;
+    orte_std_cntr_t n;
+    int rc;
+
+    watch_init();
+
+    if (ORTE_PROC_IS_HNP) {
+        requestor = *sender;
+    } else {
+        n = 1;
+        if (ORTE_SUCCESS != (rc = opal_dss.unpack(buffer, &requestor, &n, ORTE_NAME))) {
+            ORTE_ERROR_LOG(rc);
+            return rc;
+        }
+    }
+    remove_watchers(&requestor);
+    return ORTE_SUCCESS;
+}
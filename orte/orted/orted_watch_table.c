@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+
+#include "orte_config.h"
+#include "orte/constants.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "opal/dss/dss.h"
+
+#include "orte/mca/errmgr/errmgr.h"
+
+#include "orte/orted/orted_watch_table.h"
+
+static void wcon(orte_watcher_t *p)
+{
+    p->what = 0;
+    p->rate = 1;
+    p->job = ORTE_JOBID_WILDCARD;
+    p->node = NULL;
+    p->nranks = 0;
+    p->ranks = NULL;
+    p->relayed = ORTE_VPID_INVALID;
+    p->sent = 0;
+    p->next = 0;
+}
+static void wdes(orte_watcher_t *p)
+{
+    if (NULL != p->node) {
+        free(p->node);
+    }
+    if (NULL != p->ranks) {
+        free(p->ranks);
+    }
+}
+OBJ_CLASS_INSTANCE(orte_watcher_t,
+                   opal_list_item_t,
+                   wcon, wdes);
+
+static void rcon(orte_watch_record_t *p)
+{
+    p->kind = 0;
+    p->name.jobid = ORTE_JOBID_INVALID;
+    p->name.vpid = ORTE_VPID_INVALID;
+    p->node = NULL;
+    OBJ_CONSTRUCT(&p->data, opal_buffer_t);
+    p->gen = 0;
+    p->seen = 0;
+    p->gone = false;
+    p->key = NULL;
+    p->keylen = 0;
+}
+static void rdes(orte_watch_record_t *p)
+{
+    if (NULL != p->node) {
+        free(p->node);
+    }
+    OBJ_DESTRUCT(&p->data);
+    if (NULL != p->key) {
+        free(p->key);
+    }
+}
+OBJ_CLASS_INSTANCE(orte_watch_record_t,
+                   opal_list_item_t,
+                   rcon, rdes);
+
+void orte_watch_table_init(orte_watch_table_t *t)
+{
+    OBJ_CONSTRUCT(&t->records, opal_list_t);
+    OBJ_CONSTRUCT(&t->index, opal_hash_table_t);
+    opal_hash_table_init(&t->index, 256);
+    t->generation = 0;
+    t->pass = 0;
+    t->npstats = 0;
+}
+
+void orte_watch_table_clear(orte_watch_table_t *t)
+{
+    opal_list_item_t *item;
+
+    while (NULL != (item = opal_list_remove_first(&t->records))) {
+        OBJ_RELEASE(item);
+    }
+    opal_hash_table_remove_all(&t->index);
+    t->npstats = 0;
+}
+
+static char* record_key(orte_watch_flag_t kind, orte_process_name_t *name,
+                        char *node, size_t *keylen)
+{
+    char *key;
+
+    if (ORTE_WATCH_NODES == kind) {
+        *keylen = 1 + strlen(node);
+        key = (char*)malloc(*keylen);
+        memcpy(key + 1, node, *keylen - 1);
+    } else {
+        *keylen = 1 + sizeof(orte_process_name_t);
+        key = (char*)malloc(*keylen);
+        memcpy(key + 1, name, sizeof(orte_process_name_t));
+    }
+    key[0] = (char)kind;
+    return key;
+}
+
+orte_watch_record_t* orte_watch_table_find(orte_watch_table_t *t,
+                                           orte_watch_flag_t kind,
+                                           orte_process_name_t *name,
+                                           char *node)
+{
+    char *key;
+    size_t keylen;
+    void *ptr;
+    int rc;
+
+    key = record_key(kind, name, node, &keylen);
+    rc = opal_hash_table_get_value_ptr(&t->index, key, keylen, &ptr);
+    free(key);
+    return (OPAL_SUCCESS == rc) ? (orte_watch_record_t*)ptr : NULL;
+}
+
+orte_watch_record_t* orte_watch_table_lookup(orte_watch_table_t *t,
+                                             orte_watch_flag_t kind,
+                                             orte_process_name_t *name,
+                                             char *node)
+{
+    orte_watch_record_t *rec;
+    char *key;
+    size_t keylen;
+    void *ptr;
+
+    key = record_key(kind, name, node, &keylen);
+    if (OPAL_SUCCESS == opal_hash_table_get_value_ptr(&t->index, key, keylen, &ptr)) {
+        free(key);
+        rec = (orte_watch_record_t*)ptr;
+        /* procs may move between nodes on restart */
+        if (ORTE_WATCH_NODES != kind && NULL != node &&
+            (NULL == rec->node || 0 != strcmp(rec->node, node))) {
+            if (NULL != rec->node) {
+                free(rec->node);
+            }
+            rec->node = strdup(node);
+        }
+        return rec;
+    }
+
+    rec = OBJ_NEW(orte_watch_record_t);
+    rec->kind = kind;
+    if (NULL != name) {
+        rec->name = *name;
+    }
+    if (NULL != node) {
+        rec->node = strdup(node);
+    }
+    rec->key = key;
+    rec->keylen = keylen;
+    opal_hash_table_set_value_ptr(&t->index, key, keylen, rec);
+    opal_list_append(&t->records, &rec->super);
+    if (ORTE_WATCH_PSTATS == kind) {
+        t->npstats++;
+    }
+    return rec;
+}
+
+void orte_watch_table_update(orte_watch_table_t *t, orte_watch_record_t *rec,
+                             opal_buffer_t *scratch)
+{
+    rec->seen = t->pass;
+    if (!rec->gone && rec->data.bytes_used == scratch->bytes_used &&
+        0 == memcmp(rec->data.base_ptr, scratch->base_ptr, scratch->bytes_used)) {
+        return;
+    }
+    OBJ_DESTRUCT(&rec->data);
+    OBJ_CONSTRUCT(&rec->data, opal_buffer_t);
+    opal_dss.copy_payload(&rec->data, scratch);
+    rec->gone = false;
+    rec->gen = ++t->generation;
+    opal_list_remove_item(&t->records, &rec->super);
+    opal_list_append(&t->records, &rec->super);
+}
+
+void orte_watch_table_gone(orte_watch_table_t *t, orte_watch_record_t *rec)
+{
+    if (rec->gone) {
+        return;
+    }
+    rec->gone = true;
+    rec->gen = ++t->generation;
+    opal_list_remove_item(&t->records, &rec->super);
+    opal_list_append(&t->records, &rec->super);
+}
+
+bool orte_watch_matches(orte_watcher_t *w, orte_watch_record_t *rec)
+{
+    int32_t i;
+
+    if (!(w->what & rec->kind)) {
+        return false;
+    }
+    if (ORTE_WATCH_NODES == rec->kind) {
+        return (NULL == w->node || 0 == strcmp(w->node, rec->node));
+    }
+    if (ORTE_JOBID_WILDCARD != w->job && w->job != rec->name.jobid) {
+        return false;
+    }
+    if (ORTE_WATCH_JOBS == rec->kind) {
+        return true;
+    }
+    if (NULL != w->node && (NULL == rec->node || 0 != strcmp(w->node, rec->node))) {
+        return false;
+    }
+    if (0 == w->nranks) {
+        return true;
+    }
+    for (i=0; i < w->nranks; i++) {
+        if (w->ranks[i] == rec->name.vpid) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int pack_record(opal_buffer_t *msg, orte_watch_record_t *rec)
+{
+    orte_watch_flag_t flag;
+    int rc;
+
+    flag = rec->kind;
+    if (!rec->gone) {
+        if (ORTE_SUCCESS != (rc = opal_dss.pack(msg, &flag, 1, ORTE_WATCH_FLAG_T))) {
+            ORTE_ERROR_LOG(rc);
+            return rc;
+        }
+        return opal_dss.copy_payload(msg, &rec->data);
+    }
+
+    /* a removed object is identified by its key alone */
+    flag |= ORTE_WATCH_GONE;
+    if (ORTE_SUCCESS != (rc = opal_dss.pack(msg, &flag, 1, ORTE_WATCH_FLAG_T))) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+    switch (rec->kind) {
+    case ORTE_WATCH_JOBS:
+        rc = opal_dss.pack(msg, &rec->name.jobid, 1, ORTE_JOBID);
+        break;
+    case ORTE_WATCH_NODES:
+        rc = opal_dss.pack(msg, &rec->node, 1, OPAL_STRING);
+        break;
+    default:
+        rc = opal_dss.pack(msg, &rec->name, 1, ORTE_NAME);
+        break;
+    }
+    if (ORTE_SUCCESS != rc) {
+        ORTE_ERROR_LOG(rc);
+    }
+    return rc;
+}
+
+int orte_watch_table_pack(orte_watch_table_t *t, orte_watcher_t *w,
+                          bool snapshot, opal_buffer_t *msg, int32_t *count)
+{
+    orte_watch_record_t *rec;
+    int rc;
+
+    *count = 0;
+    if (ORTE_SUCCESS != (rc = opal_dss.pack(msg, &snapshot, 1, OPAL_BOOL))) {
+        ORTE_ERROR_LOG(rc);
+        return rc;
+    }
+    if (snapshot) {
+        OPAL_LIST_FOREACH(rec, &t->records, orte_watch_record_t) {
+            if (!rec->gone && orte_watch_matches(w, rec)) {
+                if (ORTE_SUCCESS != (rc = pack_record(msg, rec))) {
+                    return rc;
+                }
+                (*count)++;
+            }
+        }
+    } else {
+        OPAL_LIST_FOREACH_REV(rec, &t->records, orte_watch_record_t) {
+            if (rec->gen <= w->sent) {
+                break;
+            }
+            if (orte_watch_matches(w, rec)) {
+                if (ORTE_SUCCESS != (rc = pack_record(msg, rec))) {
+                    return rc;
+                }
+                (*count)++;
+            }
+        }
+    }
+    w->sent = t->generation;
+    return ORTE_SUCCESS;
+}
+
+void orte_watch_table_purge(orte_watch_table_t *t, opal_list_t *watchers)
+{
+    orte_watcher_t *w;
+    orte_watch_record_t *rec, *next;
+    uint64_t oldest = t->generation;
+
+    OPAL_LIST_FOREACH(w, watchers, orte_watcher_t) {
+        if (w->sent < oldest) {
+            oldest = w->sent;
+        }
+    }
+    OPAL_LIST_FOREACH_SAFE(rec, next, &t->records, orte_watch_record_t) {
+        if (oldest < rec->gen) {
+            break;
+        }
+        if (rec->gone) {
+            if (ORTE_WATCH_PSTATS == rec->kind) {
+                t->npstats--;
+            }
+            opal_list_remove_item(&t->records, &rec->super);
+            opal_hash_table_remove_value_ptr(&t->index, rec->key, rec->keylen);
+            OBJ_RELEASE(rec);
+        }
+    }
+}
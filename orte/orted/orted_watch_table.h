@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2016      Intel, Inc. All rights reserved.
+ * $COPYRIGHT$
+ *
+ * Additional copyrights may follow
+ *
+ * $HEADER$
+ */
+/**
+ * @file
+ *
+ * The record table behind the tool watch service
+ *
+ * Each record is stamped with the generation at which it last changed
+ * and the table is kept ordered by generation, so a watcher is served
+ * by walking back from the tail to the last generation it was sent.
+ * Nothing here touches the runtime's job, node or proc data.
+ */
+#ifndef ORTED_WATCH_TABLE_H
+#define ORTED_WATCH_TABLE_H
+
+#include "orte_config.h"
+
+#include <time.h>
+
+#include "opal/class/opal_hash_table.h"
+#include "opal/class/opal_list.h"
+#include "opal/dss/dss_types.h"
+
+#include "orte/types.h"
+#include "orte/mca/odls/odls_types.h"
+
+BEGIN_C_DECLS
+
+typedef struct {
+    opal_list_item_t super;
+    /* tool receiving the updates */
+    orte_process_name_t requestor;
+    orte_watch_flag_t what;
+    int32_t rate;
+    /* filters */
+    orte_jobid_t job;
+    char *node;
+    int32_t nranks;
+    orte_vpid_t *ranks;
+    /* daemon(s) the subscription was relayed to */
+    orte_vpid_t relayed;
+    /* last generation sent and time the next update is due */
+    uint64_t sent;
+    time_t next;
+} orte_watcher_t;
+ORTE_DECLSPEC OBJ_CLASS_DECLARATION(orte_watcher_t);
+
+typedef struct {
+    opal_list_item_t super;
+    orte_watch_flag_t kind;
+    /* jobid for jobs, full name for procs */
+    orte_process_name_t name;
+    /* node name for nodes, host for procs */
+    char *node;
+    /* the record as last packed */
+    opal_buffer_t data;
+    uint64_t gen;
+    uint64_t seen;
+    bool gone;
+    void *key;
+    size_t keylen;
+} orte_watch_record_t;
+ORTE_DECLSPEC OBJ_CLASS_DECLARATION(orte_watch_record_t);
+
+typedef struct {
+    /* ordered by generation, oldest change first */
+    opal_list_t records;
+    opal_hash_table_t index;
+    uint64_t generation;
+    /* refresh pass, to tell which records were seen in it */
+    uint64_t pass;
+    int32_t npstats;
+} orte_watch_table_t;
+
+ORTE_DECLSPEC void orte_watch_table_init(orte_watch_table_t *t);
+ORTE_DECLSPEC void orte_watch_table_clear(orte_watch_table_t *t);
+
+/* the record for an object, if there is one */
+ORTE_DECLSPEC orte_watch_record_t* orte_watch_table_find(orte_watch_table_t *t,
+                                                         orte_watch_flag_t kind,
+                                                         orte_process_name_t *name,
+                                                         char *node);
+/* as above, adding an empty record if there is none */
+ORTE_DECLSPEC orte_watch_record_t* orte_watch_table_lookup(orte_watch_table_t *t,
+                                                           orte_watch_flag_t kind,
+                                                           orte_process_name_t *name,
+                                                           char *node);
+
+/* compare a freshly packed record against what we last saw and,
+ * if it differs, stamp it and move it to the tail */
+ORTE_DECLSPEC void orte_watch_table_update(orte_watch_table_t *t,
+                                           orte_watch_record_t *rec,
+                                           opal_buffer_t *scratch);
+ORTE_DECLSPEC void orte_watch_table_gone(orte_watch_table_t *t,
+                                         orte_watch_record_t *rec);
+
+ORTE_DECLSPEC bool orte_watch_matches(orte_watcher_t *w, orte_watch_record_t *rec);
+
+/* Pack for the watcher either everything it can see or only the
+ * records that changed since its last update, and move it up to the
+ * current generation. Sets count to the number of records packed. */
+ORTE_DECLSPEC int orte_watch_table_pack(orte_watch_table_t *t, orte_watcher_t *w,
+                                        bool snapshot, opal_buffer_t *msg,
+                                        int32_t *count);
+
+/* drop tombstones that every watcher has already been told about */
+ORTE_DECLSPEC void orte_watch_table_purge(orte_watch_table_t *t, opal_list_t *watchers);
+
+END_C_DECLS
+
+#endif /* ORTED_WATCH_TABLE_H */
@@ -75,6 +75,10 @@ static void send_cbfunc(int status, orte_process_name_t* sender,
         opal_event_free(quicktime);
 	quicktime = NULL;
     }
+    /* a send that could not be delivered is an error */
+    if (ORTE_SUCCESS != status) {
+        error_exit = status;
+    }
     /* declare the work done */
     timer_fired = true;
     /* release the message */
@@ -799,3 +803,88 @@ CLEANUP:
     return rc;
 }
 
+
+static int send_watch_cmd(const orte_process_name_t *hnp, opal_buffer_t *cmd)
+{
+    int ret;
+    struct timeval tv;
+
+    /* define a max time to wait for send to complete */
+    timer_fired = false;
+    error_exit = ORTE_SUCCESS;
+    quicktime = opal_event_alloc();
+    tv.tv_sec = 0;
+    tv.tv_usec = 100000;
+    opal_event_evtimer_set(orte_event_base, quicktime, quicktime_cb, NULL);
+    opal_event_set_priority(quicktime, ORTE_ERROR_PRI);
+    opal_event_evtimer_add(quicktime, &tv);
+
+    /* do the send */
+    if (0 > (ret = orte_rml.send_buffer_nb((orte_process_name_t*)hnp, cmd, ORTE_RML_TAG_DAEMON, send_cbfunc, NULL))) {
+        ORTE_ERROR_LOG(ret);
+        opal_event_free(quicktime);
+        quicktime = NULL;
+        OBJ_RELEASE(cmd);
+        return ret;
+    }
+
+    while (!timer_fired) {
+        opal_progress();
+    }
+
+    if (ORTE_SUCCESS != error_exit) {
+        return error_exit;
+    }
+    return ORTE_SUCCESS;
+}
+
+int orte_util_comm_watch(const orte_process_name_t *hnp,
+                         orte_watch_flag_t what, int32_t rate,
+                         orte_jobid_t job, char *node,
+                         int32_t nranks, orte_vpid_t *ranks)
+{
+    int ret;
+    opal_buffer_t *cmd;
+    orte_daemon_cmd_flag_t command = ORTE_DAEMON_WATCH_CMD;
+
+    OPAL_OUTPUT_VERBOSE((5, orte_debug_output,
+                         "%s util_comm_watch: subscribing to HNP %s",
+                         ORTE_NAME_PRINT(ORTE_PROC_MY_NAME),
+                         ORTE_NAME_PRINT(hnp)));
+
+    cmd = OBJ_NEW(opal_buffer_t);
+    if (ORTE_SUCCESS != (ret = opal_dss.pack(cmd, &command, 1, ORTE_DAEMON_CMD)) ||
+        ORTE_SUCCESS != (ret = opal_dss.pack(cmd, &what, 1, ORTE_WATCH_FLAG_T)) ||
+        ORTE_SUCCESS != (ret = opal_dss.pack(cmd, &rate, 1, OPAL_INT32)) ||
+        ORTE_SUCCESS != (ret = opal_dss.pack(cmd, &job, 1, ORTE_JOBID)) ||
+        ORTE_SUCCESS != (ret = opal_dss.pack(cmd, &node, 1, OPAL_STRING)) ||
+        ORTE_SUCCESS != (ret = opal_dss.pack(cmd, &nranks, 1, OPAL_INT32))) {
+        ORTE_ERROR_LOG(ret);
+        OBJ_RELEASE(cmd);
+        return ret;
+    }
+    if (0 < nranks &&
+        ORTE_SUCCESS != (ret = opal_dss.pack(cmd, ranks, nranks, ORTE_VPID))) {
+        ORTE_ERROR_LOG(ret);
+        OBJ_RELEASE(cmd);
+        return ret;
+    }
+
+    return send_watch_cmd(hnp, cmd);
+}
+
+int orte_util_comm_unwatch(const orte_process_name_t *hnp)
+{
+    int ret;
+    opal_buffer_t *cmd;
+    orte_daemon_cmd_flag_t command = ORTE_DAEMON_UNWATCH_CMD;
+
+    cmd = OBJ_NEW(opal_buffer_t);
+    if (ORTE_SUCCESS != (ret = opal_dss.pack(cmd, &command, 1, ORTE_DAEMON_CMD))) {
+        ORTE_ERROR_LOG(ret);
+        OBJ_RELEASE(cmd);
+        return ret;
+    }
+
+    return send_watch_cmd(hnp, cmd);
+}
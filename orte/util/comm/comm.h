@@ -31,6 +31,7 @@
 #include "orte/types.h"
 
 #include "orte/runtime/orte_globals.h"
+#include "orte/mca/odls/odls_types.h"
 
 BEGIN_C_DECLS
 
@@ -60,5 +61,18 @@ ORTE_DECLSPEC int orte_util_comm_terminate_job(const orte_process_name_t *hnp, o
 
 ORTE_DECLSPEC int orte_util_comm_halt_vm(const orte_process_name_t *hnp);
 
+/* subscribe to streamed updates of the given kinds of record
+ * (ORTE_WATCH_* from odls_types.h), pushed every rate seconds
+ * on ORTE_RML_TAG_WATCH. Each update starts with a bool that is
+ * true for the initial snapshot, followed by (flag, record) pairs.
+ * A NULL node, wildcard job or zero nranks leave that filter open
+ */
+ORTE_DECLSPEC int orte_util_comm_watch(const orte_process_name_t *hnp,
+                                       orte_watch_flag_t what, int32_t rate,
+                                       orte_jobid_t job, char *node,
+                                       int32_t nranks, orte_vpid_t *ranks);
+
+ORTE_DECLSPEC int orte_util_comm_unwatch(const orte_process_name_t *hnp);
+
 END_C_DECLS
 #endif